@@ -0,0 +1,80 @@
+/**
+ * @file allocation_tracker.cpp
+ * @brief Replacement global allocation operators for the benchmarks
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "allocation_tracker.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Heap statistics maintained by the replacement operators below.
+static std::atomic<size_t> g_allocation_count{0};
+static std::atomic<size_t> g_allocated_bytes{0};
+static std::atomic<size_t> g_live_bytes{0};
+static std::atomic<size_t> g_peak_bytes{0};
+
+// NOTE: Each block is prefixed with its size so that frees can be subtracted
+// from the live byte count without relying on malloc_usable_size.
+static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+// NOTE: Keep the replacement operators out of line; once inlined into the
+// benchmark registration code GCC reports a spurious new/free mismatch.
+#if defined(__GNUC__)
+#define CZC_BENCH_NOINLINE __attribute__((noinline))
+#else
+#define CZC_BENCH_NOINLINE
+#endif
+
+CZC_BENCH_NOINLINE void *operator new(std::size_t size) {
+  auto *block = static_cast<unsigned char *>(std::malloc(size + HEADER_SIZE));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t *>(block) = size;
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  size_t live = g_live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  size_t peak = g_peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !g_peak_bytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+  return block + HEADER_SIZE;
+}
+
+CZC_BENCH_NOINLINE void operator delete(void *ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto *block = static_cast<unsigned char *>(ptr) - HEADER_SIZE;
+  g_live_bytes.fetch_sub(*reinterpret_cast<std::size_t *>(block),
+                         std::memory_order_relaxed);
+  std::free(block);
+}
+
+CZC_BENCH_NOINLINE void operator delete(void *ptr, std::size_t) noexcept {
+  operator delete(ptr);
+}
+
+AllocationTotals allocation_totals() {
+  AllocationTotals totals;
+  totals.count = g_allocation_count.load(std::memory_order_relaxed);
+  totals.bytes = g_allocated_bytes.load(std::memory_order_relaxed);
+  return totals;
+}
+
+size_t live_heap_bytes() {
+  return g_live_bytes.load(std::memory_order_relaxed);
+}
+
+size_t peak_heap_bytes() {
+  return g_peak_bytes.load(std::memory_order_relaxed);
+}
+
+void reset_peak_heap_bytes() {
+  g_peak_bytes.store(g_live_bytes.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
+}
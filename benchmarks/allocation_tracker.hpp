@@ -0,0 +1,75 @@
+/**
+ * @file allocation_tracker.hpp
+ * @brief Heap allocation counters shared by every benchmark executable
+ * @details `allocation_tracker.cpp` replaces the global `operator new` and
+ *          `operator delete` and keeps process-wide allocation statistics.
+ *          Benchmarks create an `AllocationCounters` right before their timed
+ *          loop; it reports the allocations and bytes allocated per iteration
+ *          as the user counters `allocs` and `alloc_bytes`, so allocation
+ *          regressions show up next to the timings.
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_BENCHMARKS_ALLOCATION_TRACKER_HPP
+#define CZC_BENCHMARKS_ALLOCATION_TRACKER_HPP
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+// Cumulative allocation statistics since process start.
+struct AllocationTotals {
+  size_t count = 0;
+  size_t bytes = 0;
+};
+
+// Allocations made so far by every thread of the process.
+AllocationTotals allocation_totals();
+
+// Bytes currently allocated and not yet freed.
+size_t live_heap_bytes();
+
+// Highest live byte count since the last call to `reset_peak_heap_bytes`.
+size_t peak_heap_bytes();
+
+// Restart the high-water mark from the current live byte count.
+void reset_peak_heap_bytes();
+
+// Reports allocations per iteration for the enclosing benchmark function.
+// NOTE: The counts are process-wide, so allocations made by worker threads on
+// behalf of the benchmark are included. Use pause/resume around setup work
+// that the benchmark excludes with PauseTiming/ResumeTiming.
+class AllocationCounters {
+public:
+  explicit AllocationCounters(benchmark::State &state)
+      : state(state), start(allocation_totals()) {}
+
+  ~AllocationCounters() {
+    AllocationTotals end = allocation_totals();
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(end.count - start.count - excluded.count),
+        benchmark::Counter::kAvgIterations);
+    state.counters["alloc_bytes"] = benchmark::Counter(
+        static_cast<double>(end.bytes - start.bytes - excluded.bytes),
+        benchmark::Counter::kAvgIterations);
+  }
+
+  void pause() { paused_at = allocation_totals(); }
+
+  void resume() {
+    AllocationTotals now = allocation_totals();
+    excluded.count += now.count - paused_at.count;
+    excluded.bytes += now.bytes - paused_at.bytes;
+  }
+
+  AllocationCounters(const AllocationCounters &) = delete;
+  AllocationCounters &operator=(const AllocationCounters &) = delete;
+
+private:
+  benchmark::State &state;
+  AllocationTotals start;
+  AllocationTotals excluded;
+  AllocationTotals paused_at;
+};
+
+#endif // CZC_BENCHMARKS_ALLOCATION_TRACKER_HPP
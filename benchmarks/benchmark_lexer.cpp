@@ -5,9 +5,24 @@
  * @date 2025-11-11
  */
 
+#include "czc/diagnostics/diagnostic.hpp"
 #include "czc/lexer/lexer.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+#include "czc/utils/source_buffer.hpp"
+#include "czc/utils/source_tracker.hpp"
+#include "czc/utils/string_interner.hpp"
+#include "czc/utils/thread_pool.hpp"
+
+#include "allocation_tracker.hpp"
+
 #include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
 #include <sstream>
+#include <string_view>
+#include <vector>
 
 using namespace czc::lexer;
 
@@ -23,6 +38,7 @@ std::string generate_source(size_t num_lines) {
 // Benchmark: Small file (100 lines)
 static void BM_Lexer_SmallFile(benchmark::State &state) {
   std::string source = generate_source(100);
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -35,6 +51,7 @@ BENCHMARK(BM_Lexer_SmallFile);
 // Benchmark: Medium file (1000 lines)
 static void BM_Lexer_MediumFile(benchmark::State &state) {
   std::string source = generate_source(1000);
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -47,6 +64,7 @@ BENCHMARK(BM_Lexer_MediumFile);
 // Benchmark: Large file (10000 lines)
 static void BM_Lexer_LargeFile(benchmark::State &state) {
   std::string source = generate_source(10000);
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -56,6 +74,107 @@ static void BM_Lexer_LargeFile(benchmark::State &state) {
 }
 BENCHMARK(BM_Lexer_LargeFile);
 
+// Benchmark: Large file (10000 lines), zero-copy span mode
+static void BM_Lexer_LargeFile_Spans(benchmark::State &state) {
+  std::string source = generate_source(10000);
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    auto spans = lexer.tokenize_spans();
+    benchmark::DoNotOptimize(spans);
+  }
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_Lexer_LargeFile_Spans);
+
+// Benchmark: Large file (10000 lines), one keystroke re-lexed incrementally.
+// Each iteration types one character in the middle of the file and deletes it
+// again; compare against BM_Lexer_LargeFile for the full re-tokenize cost.
+static void BM_Lexer_LargeFile_Relex(benchmark::State &state) {
+  std::string source = generate_source(10000);
+  size_t offset = source.size() / 2;
+  offset = source.find(' ', offset);
+  std::string edited = source;
+  edited.insert(offset, "x");
+
+  auto tokens = Lexer(source).tokenize();
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer insert_lexer(edited);
+    insert_lexer.relex(tokens, {offset, 0, "x"});
+    Lexer delete_lexer(source);
+    delete_lexer.relex(tokens, {offset, 1, ""});
+    benchmark::DoNotOptimize(tokens);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_Lexer_LargeFile_Relex);
+
+// Benchmark: Parallel chunked lexing of a multi-megabyte file, scaling the
+// number of worker threads (1 thread is the serial baseline)
+static void BM_Lexer_Parallel(benchmark::State &state) {
+  std::string source = generate_source(200000);
+  czc::utils::ThreadPool pool(static_cast<size_t>(state.range(0)));
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    auto tokens = lexer.tokenize_parallel(pool);
+    benchmark::DoNotOptimize(tokens);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Lexer_Parallel)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Benchmark: Deeply indented code with long identifiers and line comments,
+// the workload targeted by the bulk scanning kernels
+static void BM_Lexer_IndentedComments(benchmark::State &state) {
+  std::ostringstream oss;
+  for (int i = 0; i < 10000; ++i) {
+    oss << "                // update the accumulated running total for "
+           "entry "
+        << i << "\n"
+        << "                let accumulated_running_total_" << i
+        << " = previous_accumulated_value + current_entry_value;\n";
+  }
+  std::string source = oss.str();
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    auto spans = lexer.tokenize_spans();
+    benchmark::DoNotOptimize(spans);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Lexer_IndentedComments);
+
+// Benchmark: Operator-dense input, exercising the character-class dispatch
+// and the two-character operator table
+static void BM_Lexer_OperatorDense(benchmark::State &state) {
+  std::ostringstream oss;
+  for (int i = 0; i < 2000; ++i) {
+    oss << "a+=b-=c->d*=(e/f)%g==h!=i<=j>=k&&l||m..n;[o,p]{q:r}!~s<t>u|v&w.x\n";
+  }
+  std::string source = oss.str();
+  size_t token_count = Lexer(source).tokenize_spans().size();
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    auto spans = lexer.tokenize_spans();
+    benchmark::DoNotOptimize(spans);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(token_count));
+}
+BENCHMARK(BM_Lexer_OperatorDense);
+
 // Benchmark: String processing
 static void BM_Lexer_Strings(benchmark::State &state) {
   std::ostringstream oss;
@@ -65,6 +184,7 @@ static void BM_Lexer_Strings(benchmark::State &state) {
   }
   std::string source = oss.str();
 
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -73,6 +193,29 @@ static void BM_Lexer_Strings(benchmark::State &state) {
 }
 BENCHMARK(BM_Lexer_Strings);
 
+// Benchmark: String-heavy file in zero-copy span mode. Arg 0 uses plain
+// strings only, Arg 1 gives every fourth string an escape sequence.
+static void BM_Lexer_Strings_Spans(benchmark::State &state) {
+  bool escapes = state.range(0) != 0;
+  std::ostringstream oss;
+  for (int i = 0; i < 10000; ++i) {
+    oss << "let s" << i << " = \"This is a test string number " << i;
+    if (escapes && i % 4 == 0) {
+      oss << "\\n\\t\\u{4E2D}";
+    }
+    oss << "\";\n";
+  }
+  std::string source = oss.str();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    auto spans = lexer.tokenize_spans();
+    benchmark::DoNotOptimize(spans);
+  }
+}
+BENCHMARK(BM_Lexer_Strings_Spans)->Arg(0)->Arg(1);
+
 // Benchmark: Number processing
 static void BM_Lexer_Numbers(benchmark::State &state) {
   std::ostringstream oss;
@@ -81,6 +224,7 @@ static void BM_Lexer_Numbers(benchmark::State &state) {
   }
   std::string source = oss.str();
 
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -98,6 +242,7 @@ static void BM_Lexer_UTF8(benchmark::State &state) {
   }
   std::string source = oss.str();
 
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -106,4 +251,268 @@ static void BM_Lexer_UTF8(benchmark::State &state) {
 }
 BENCHMARK(BM_Lexer_UTF8);
 
+// Benchmark: CJK-heavy identifiers and string literals (bulk UTF-8 validation)
+static void BM_Lexer_CJKHeavy(benchmark::State &state) {
+  std::ostringstream oss;
+  for (int i = 0; i < 2000; ++i) {
+    oss << "let 用户名称列表_" << i << " = \"这是一个包含大量中文字符的字符串，"
+        << "用于测试词法分析器的性能\";\n";
+  }
+  std::string source = oss.str();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+    benchmark::DoNotOptimize(tokens);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Lexer_CJKHeavy);
+
+// Benchmark: Token preprocessing of a large file (10000 lines) without
+// scientific literals, copying the stream (arg 0) or rewriting it in place
+// (arg 1)
+static void BM_Preprocessor_LargeFile(benchmark::State &state) {
+  bool in_place = state.range(0) != 0;
+  std::string source = generate_source(10000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    czc::token_preprocessor::TokenPreprocessor preprocessor;
+    if (in_place) {
+      preprocessor.process_in_place(tokens, "<bench>", source);
+      benchmark::DoNotOptimize(tokens.data());
+    } else {
+      auto processed = preprocessor.process(tokens, "<bench>", source);
+      benchmark::DoNotOptimize(processed);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tokens.size()));
+}
+BENCHMARK(BM_Preprocessor_LargeFile)->Arg(0)->Arg(1);
+
+// Benchmark: Classify the scientific literals of a numeric data file
+// (10000 values such as 1.5e3)
+static void BM_Preprocessor_ScientificLiterals(benchmark::State &state) {
+  std::ostringstream oss;
+  for (int i = 0; i < 10000; ++i) {
+    oss << (i % 97) << '.' << (i % 1000) << "e" << (i % 25) << ",\n";
+  }
+  std::string source = oss.str();
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    czc::token_preprocessor::TokenPreprocessor preprocessor;
+    size_t integers = 0;
+    for (const auto &token : tokens) {
+      if (token.token_type == TokenType::ScientificExponent) {
+        integers += preprocessor.classify_scientific_token(
+                        token, "<bench>", source) == TokenType::Integer;
+      }
+    }
+    benchmark::DoNotOptimize(integers);
+  }
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_Preprocessor_ScientificLiterals);
+
+// Benchmark: Lex and preprocess a numeric data file (10000 scientific
+// literals) as two passes (arg 0) or in one fused pass (arg 1)
+static void BM_Lexer_PreprocessNumbers(benchmark::State &state) {
+  bool fused = state.range(0) != 0;
+  std::ostringstream oss;
+  for (int i = 0; i < 10000; ++i) {
+    oss << "let v" << i << " = " << (i % 97) << '.' << (i % 1000) << "e"
+        << (i % 15) << ";\n";
+  }
+  std::string source = oss.str();
+  std::string filename = "<bench>";
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    czc::token_preprocessor::TokenPreprocessor preprocessor;
+    Lexer lexer(source, filename);
+    if (fused) {
+      czc::token_preprocessor::ScientificTokenClassifier classifier(
+          preprocessor, filename, source);
+      lexer.set_scientific_classifier(&classifier);
+      auto tokens = lexer.tokenize();
+      benchmark::DoNotOptimize(tokens);
+    } else {
+      auto tokens = preprocessor.process(lexer.tokenize(), filename, source);
+      benchmark::DoNotOptimize(tokens);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Lexer_PreprocessNumbers)->Arg(0)->Arg(1);
+
+// Benchmark: Large file (10000 lines) with identifiers interned while lexing
+static void BM_Lexer_LargeFile_Interned(benchmark::State &state) {
+  std::string source = generate_source(10000);
+  czc::utils::StringInterner interner;
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    lexer.set_interner(&interner);
+    auto tokens = lexer.tokenize();
+    benchmark::DoNotOptimize(tokens);
+  }
+  state.SetItemsProcessed(state.iterations() * 10000);
+}
+BENCHMARK(BM_Lexer_LargeFile_Interned);
+
+// Benchmark: Count the uses of one name among 10000 lines of identifiers,
+// comparing token text (arg 0) or interned symbols (arg 1)
+static void BM_Lexer_NameCompare(benchmark::State &state) {
+  bool use_symbols = state.range(0) != 0;
+  std::ostringstream oss;
+  for (size_t i = 0; i < 10000; ++i) {
+    oss << "let accumulated_value_" << (i % 64) << " = accumulated_value_"
+        << ((i * 7) % 64) << ";\n";
+  }
+  std::string source = oss.str();
+  czc::utils::StringInterner interner;
+  Lexer lexer(source);
+  lexer.set_interner(&interner);
+  auto tokens = lexer.tokenize();
+  std::string target = "accumulated_value_42";
+  czc::utils::Symbol target_symbol = interner.intern(target).get_symbol();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    size_t count = 0;
+    for (const auto &token : tokens) {
+      if (use_symbols) {
+        count += token.symbol == target_symbol;
+      } else {
+        count += token.token_type == TokenType::Identifier &&
+                 token.value == target;
+      }
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tokens.size()));
+}
+BENCHMARK(BM_Lexer_NameCompare)->Arg(0)->Arg(1);
+
+// Benchmark: Open a 100000-line file and set up a Lexer on it, reading through
+// ifstream/stringstream copies (arg 0) or borrowing a SourceBuffer (arg 1)
+static void BM_Lexer_OpenLargeFile(benchmark::State &state) {
+  bool use_buffer = state.range(0) != 0;
+  std::string source = generate_source(100000);
+  std::string path =
+      (std::filesystem::temp_directory_path() / "czc_bench_open_large.zero")
+          .string();
+  {
+    std::ofstream output(path, std::ios::binary);
+    output << source;
+  }
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    if (use_buffer) {
+      auto buffer = czc::utils::SourceBuffer::open(path);
+      Lexer lexer(*buffer, path);
+      benchmark::DoNotOptimize(lexer.next_token());
+    } else {
+      std::ifstream input(path);
+      std::stringstream content;
+      content << input.rdbuf();
+      std::string text = content.str();
+      Lexer lexer(text, path);
+      benchmark::DoNotOptimize(lexer.next_token());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_Lexer_OpenLargeFile)->Arg(0)->Arg(1);
+
+// Benchmark: Report the lexer errors of a 100000-error file to a
+// DiagnosticEngine, building a Diagnostic with a copied source line per error
+// (arg 0) or recording compact entries rendered only when printed (arg 1)
+static void BM_Diagnostics_ReportErrors(benchmark::State &state) {
+  bool compact = state.range(0) != 0;
+  std::ostringstream oss;
+  for (size_t i = 0; i < 100000; ++i) {
+    oss << "let x" << i << " = 0x;\n";
+  }
+  Lexer lexer(oss.str(), "errors.zero");
+  (void)lexer.tokenize();
+  const auto &errors = lexer.get_errors().get_errors();
+  const auto &tracker = lexer.get_source_tracker();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    czc::diagnostics::DiagnosticEngine engine;
+    if (compact) {
+      engine.set_source(&tracker);
+      engine.report_errors(errors);
+    } else {
+      for (const auto &error : errors) {
+        auto diag = std::make_shared<czc::diagnostics::Diagnostic>(
+            czc::diagnostics::DiagnosticLevel::Error, error.code,
+            error.location, error.args);
+        diag->set_source_line(tracker.get_source_line(error.location.line));
+        engine.report(diag);
+      }
+    }
+    benchmark::DoNotOptimize(engine.get_error_count());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(errors.size()));
+}
+BENCHMARK(BM_Diagnostics_ReportErrors)->Arg(0)->Arg(1);
+
+// Benchmark: Resolve 100000 sorted error offsets in a CJK-heavy file to line,
+// byte column, character column and line text, one lookup at a time with
+// byte-wise character counting (arg 0) or in one resolve_offsets merge walk
+// (arg 1)
+static void BM_SourceTracker_ResolveOffsets(benchmark::State &state) {
+  bool bulk = state.range(0) != 0;
+  std::ostringstream oss;
+  for (size_t i = 0; i < 100000; ++i) {
+    oss << "let 变量" << i << " = \"数值\"; // 注释\n";
+  }
+  std::string source = oss.str();
+  czc::utils::SourceTracker tracker(source, "errors.zero");
+  std::vector<size_t> offsets;
+  for (size_t offset = 0; offset < source.size(); offset += 37) {
+    offsets.push_back(offset);
+  }
+
+  std::vector<czc::utils::ResolvedOffset> resolved;
+  for (auto _ : state) {
+    if (bulk) {
+      tracker.resolve_offsets(offsets, resolved);
+    } else {
+      resolved.clear();
+      for (size_t offset : offsets) {
+        auto lc = tracker.offset_to_line_column(offset);
+        std::string_view line = tracker.get_source_line_view(lc.line);
+        size_t chars = 0;
+        for (size_t i = 0; i + 1 < lc.column; ++i) {
+          chars += (static_cast<unsigned char>(line[i]) & 0xC0) != 0x80;
+        }
+        resolved.push_back({lc.line, lc.column, chars + 1, line});
+      }
+    }
+    benchmark::DoNotOptimize(resolved.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(offsets.size()));
+}
+BENCHMARK(BM_SourceTracker_ResolveOffsets)->Arg(0)->Arg(1);
+
 BENCHMARK_MAIN();
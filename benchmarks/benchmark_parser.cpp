@@ -5,10 +5,33 @@
  * @date 2025-11-11
  */
 
+#include "czc/ast/ast_builder.hpp"
+#include "czc/ast/ast_context.hpp"
+#include "czc/ast/ast_visitor.hpp"
+#include "czc/ast/ast_walker.hpp"
+#include "czc/ast/constant_folder.hpp"
+#include "czc/cst/comment_table.hpp"
+#include "czc/cst/cst_diff.hpp"
+#include "czc/cst/flat_cst.hpp"
+#include "czc/cst/green_tree.hpp"
+#include "czc/formatter/formatter.hpp"
+#include "czc/index/symbol_index.hpp"
 #include "czc/lexer/lexer.hpp"
+#include "czc/lexer/stream_lexer.hpp"
+#include "czc/lexer/token_source.hpp"
+#include "czc/parser/incremental_parser.hpp"
+#include "czc/parser/lazy_parser.hpp"
 #include "czc/parser/parser.hpp"
+#include "czc/parser/stream_parser.hpp"
+#include "czc/token_preprocessor/preprocessed_token_source.hpp"
+#include "czc/utils/thread_pool.hpp"
+
+#include "allocation_tracker.hpp"
+
 #include <benchmark/benchmark.h>
+#include <memory>
 #include <sstream>
+#include <string_view>
 
 using namespace czc::lexer;
 using namespace czc::parser;
@@ -30,6 +53,7 @@ std::string generate_function_source(size_t num_functions) {
 static void BM_Parser_SmallProgram(benchmark::State &state) {
   std::string source = generate_function_source(10);
 
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -45,6 +69,7 @@ BENCHMARK(BM_Parser_SmallProgram);
 static void BM_Parser_MediumProgram(benchmark::State &state) {
   std::string source = generate_function_source(100);
 
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -56,6 +81,250 @@ static void BM_Parser_MediumProgram(benchmark::State &state) {
 }
 BENCHMARK(BM_Parser_MediumProgram);
 
+// Benchmark: Parse pre-lexed tokens with long identifiers and report heap
+// allocations per token. Tokens are lexed once outside the timed loop, so the
+// counter covers only parsing: CST nodes plus any token copies.
+static void BM_Parser_AllocationsPerToken(benchmark::State &state) {
+  std::ostringstream oss;
+  for (int i = 0; i < 100; ++i) {
+    oss << "fn compute_long_function_name_" << i
+        << "(first_parameter_name: Integer) -> Integer {\n";
+    oss << "  let intermediate_value_name = first_parameter_name * 2 + 1;\n";
+    oss << "  return intermediate_value_name;\n";
+    oss << "}\n\n";
+  }
+  std::string source = oss.str();
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  size_t allocations = 0;
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    size_t before = allocation_totals().count;
+    Parser parser(tokens);
+    auto ast = parser.parse();
+    allocations += allocation_totals().count - before;
+    benchmark::DoNotOptimize(ast);
+  }
+  state.counters["allocs_per_token"] = benchmark::Counter(
+      static_cast<double>(allocations) /
+      static_cast<double>(state.iterations() * tokens.size()));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tokens.size()));
+}
+BENCHMARK(BM_Parser_AllocationsPerToken);
+
+// Benchmark: Parse pre-lexed tokens and drop the CST, with the tree on the
+// heap (arg 0) or in a per-parse arena (arg 1). Teardown is inside the timed
+// loop, so the arena case also measures freeing the tree all at once.
+static void BM_Parser_ParseAndDrop(benchmark::State &state) {
+  bool use_arena = state.range(0) != 0;
+  std::string source = generate_function_source(100);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  size_t allocations = 0;
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    size_t before = allocation_totals().count;
+    {
+      Parser parser(tokens);
+      parser.set_arena_enabled(use_arena);
+      auto cst = parser.parse();
+      benchmark::DoNotOptimize(cst);
+    }
+    allocations += allocation_totals().count - before;
+  }
+  state.counters["allocs_per_token"] = benchmark::Counter(
+      static_cast<double>(allocations) /
+      static_cast<double>(state.iterations() * tokens.size()));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tokens.size()));
+}
+BENCHMARK(BM_Parser_ParseAndDrop)->Arg(0)->Arg(1);
+
+// Sum token lengths over a pointer-based CST in pre-order.
+static size_t walk_tree(const czc::cst::CSTNode *node) {
+  size_t total = node->get_token() ? node->get_token()->length : 0;
+  for (const auto &child : node->get_children()) {
+    total += walk_tree(child.get());
+  }
+  return total;
+}
+
+// Benchmark: Pre-order walk of a parsed CST (2000 functions), through the
+// pointer tree (arg 0) or a flat CST converted from it (arg 1)
+static void BM_CST_PreorderWalk(benchmark::State &state) {
+  bool use_flat = state.range(0) != 0;
+  std::string source = generate_function_source(2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  auto flat = czc::cst::FlatCST::from_tree(tree.get());
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    size_t total = 0;
+    if (use_flat) {
+      const auto &flat_tokens = flat.get_tokens();
+      for (const auto &node : flat.get_nodes()) {
+        if (node.token_index != czc::cst::FlatCST::NO_TOKEN) {
+          total += flat_tokens[node.token_index].length;
+        }
+      }
+    } else {
+      total = walk_tree(tree.get());
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(flat.size()));
+}
+BENCHMARK(BM_CST_PreorderWalk)->Arg(0)->Arg(1);
+
+// Recursively compares two CSTs node by node, the way a review tool would
+// without structural hashes; returns the number of differing nodes.
+static size_t count_differences(const czc::cst::CSTNode *a,
+                                const czc::cst::CSTNode *b) {
+  if (a->get_type() != b->get_type() ||
+      a->get_children().size() != b->get_children().size() ||
+      a->get_token().has_value() != b->get_token().has_value() ||
+      (a->get_token() && a->get_token()->value != b->get_token()->value)) {
+    return 1;
+  }
+  size_t total = 0;
+  for (size_t i = 0; i < a->get_children().size(); ++i) {
+    total += count_differences(a->get_children()[i].get(),
+                               b->get_children()[i].get());
+  }
+  return total;
+}
+
+// Benchmark: Compare two revisions of a large program (2000 functions, one
+// identifier renamed in the middle) by a full recursive walk (arg 0) or by
+// cst_diff over structural hashes computed while parsing (arg 1)
+static void BM_CST_Diff(benchmark::State &state) {
+  bool use_hash = state.range(0) != 0;
+  std::string source = generate_function_source(2000);
+  std::string edited = source;
+  edited.replace(edited.find("func1000()") + 4, 4, "gunc");
+  auto parse_hashed = [](const std::string &text) {
+    Parser parser(Lexer(text).tokenize());
+    parser.set_structural_hash_enabled(true);
+    return parser.parse();
+  };
+  auto old_tree = parse_hashed(source);
+  auto new_tree = parse_hashed(edited);
+
+  size_t differences = 0;
+  for (auto _ : state) {
+    if (use_hash) {
+      differences = czc::cst::cst_diff(old_tree.get(), new_tree.get()).size();
+    } else {
+      differences = count_differences(old_tree.get(), new_tree.get());
+    }
+    benchmark::DoNotOptimize(differences);
+  }
+  state.counters["differences"] = static_cast<double>(differences);
+}
+BENCHMARK(BM_CST_Diff)->Arg(0)->Arg(1);
+
+// Benchmark: Convert an edited CST (2000 functions, one character inserted
+// near the top) into a green tree whose cache already holds the original
+// version; every function after the edit is shared with the original
+static void BM_CST_GreenTree_Edit(benchmark::State &state) {
+  std::string source = generate_function_source(2000);
+  std::string edited = source;
+  edited.insert(source.find("let y") + 4, "z");
+  auto tree = Parser(Lexer(source).tokenize()).parse();
+  auto edited_tree = Parser(Lexer(edited).tokenize()).parse();
+
+  czc::cst::GreenCache cache;
+  (void)cache.from_tree(tree.get(), source);
+  size_t distinct = cache.size();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.from_tree(edited_tree.get(), edited));
+  }
+  state.counters["new_nodes"] = static_cast<double>(cache.size() - distinct);
+  state.counters["nodes"] = static_cast<double>(distinct);
+}
+BENCHMARK(BM_CST_GreenTree_Edit);
+
+// Benchmark: Parse medium program (100 functions), pulling tokens on demand
+static void BM_Parser_MediumProgram_Streaming(benchmark::State &state) {
+  std::string source = generate_function_source(100);
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Parser parser(
+        std::make_unique<czc::token_preprocessor::PreprocessedTokenSource>(
+            source));
+    auto ast = parser.parse();
+    benchmark::DoNotOptimize(ast);
+  }
+  state.SetItemsProcessed(state.iterations() * 100);
+}
+BENCHMARK(BM_Parser_MediumProgram_Streaming);
+
+// Benchmark: Parse medium program from compact 16-byte token spans
+static void BM_Parser_MediumProgram_Spans(benchmark::State &state) {
+  std::string source = generate_function_source(100);
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    Parser parser(std::make_unique<SpanTokenSource>(lexer.tokenize_spans()));
+    auto ast = parser.parse();
+    benchmark::DoNotOptimize(ast);
+  }
+  state.SetItemsProcessed(state.iterations() * 100);
+}
+BENCHMARK(BM_Parser_MediumProgram_Spans);
+
+// Counts top-level declarations and drops them as soon as they are parsed.
+class DroppingDeclarationSink : public czc::parser::DeclarationSink {
+public:
+  size_t declarations = 0;
+
+  void begin_program(const czc::utils::SourceLocation &) override {}
+  void add_declaration(std::unique_ptr<czc::cst::CSTNode>) override {
+    ++declarations;
+  }
+};
+
+// Benchmark: Lex and parse a large program (2000 functions) that arrives in
+// pieces of arg bytes through StreamLexer/StreamParser, against lexing and
+// parsing the whole buffer at once (arg 0)
+static void BM_Parser_StreamUpload(benchmark::State &state) {
+  size_t piece = static_cast<size_t>(state.range(0));
+  std::string source = generate_function_source(2000);
+
+  for (auto _ : state) {
+    DroppingDeclarationSink sink;
+    if (piece == 0) {
+      Lexer lexer(source);
+      Parser parser(lexer.tokenize());
+      parser.parse(sink);
+    } else {
+      StreamLexer lexer;
+      StreamParser parser(sink);
+      for (size_t i = 0; i < source.size(); i += piece) {
+        lexer.feed(std::string_view(source).substr(i, piece));
+        parser.push(lexer.take_tokens());
+      }
+      lexer.finish();
+      parser.push(lexer.take_tokens());
+    }
+    benchmark::DoNotOptimize(sink.declarations);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Parser_StreamUpload)->Arg(0)->Arg(64)->Arg(4096);
+
 // Benchmark: Parse expressions
 static void BM_Parser_Expressions(benchmark::State &state) {
   std::ostringstream oss;
@@ -64,6 +333,7 @@ static void BM_Parser_Expressions(benchmark::State &state) {
   }
   std::string source = oss.str();
 
+  AllocationCounters heap(state);
   for (auto _ : state) {
     Lexer lexer(source);
     auto tokens = lexer.tokenize();
@@ -74,4 +344,868 @@ static void BM_Parser_Expressions(benchmark::State &state) {
 }
 BENCHMARK(BM_Parser_Expressions);
 
+// Benchmark: Parse pre-lexed long generated arithmetic expressions that mix
+// every binary precedence level
+static void BM_Parser_LongArithmetic(benchmark::State &state) {
+  static const char *const operators[] = {"+", "*", "-", "/", "<",
+                                          "==", "&&", "||", "%"};
+  std::ostringstream oss;
+  for (int line = 0; line < 20; ++line) {
+    oss << "let value" << line << " = x0";
+    for (int i = 1; i < 500; ++i) {
+      oss << ' ' << operators[(line + i) % 9] << " x" << i;
+    }
+    oss << ";\n";
+  }
+  std::string source = oss.str();
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Parser parser(tokens);
+    auto ast = parser.parse();
+    benchmark::DoNotOptimize(ast);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tokens.size()));
+}
+BENCHMARK(BM_Parser_LongArithmetic);
+
+// Benchmark: Parse pre-lexed tokens of a large program (5000 functions),
+// serially (arg 0) or split across a thread pool by top-level declaration
+// (arg = worker count)
+static void BM_Parser_LargeProgram_Parallel(benchmark::State &state) {
+  size_t workers = static_cast<size_t>(state.range(0));
+  std::string source = generate_function_source(5000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  czc::utils::ThreadPool pool(workers == 0 ? 1 : workers);
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Parser parser(tokens);
+    auto ast = workers == 0 ? parser.parse() : parser.parse_parallel(pool);
+    benchmark::DoNotOptimize(ast);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tokens.size()));
+}
+BENCHMARK(BM_Parser_LargeProgram_Parallel)
+    ->Arg(0)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+// Benchmark: Re-lex and incrementally re-parse a large program (5000
+// functions) after a one-character edit in the middle, alternating insert and
+// delete so the tree returns to its original shape every iteration
+static void BM_Parser_LargeProgram_Reparse(benchmark::State &state) {
+  std::string source = generate_function_source(5000);
+  size_t offset = source.find("let y", source.size() / 2) + 4;
+  std::string edited = source;
+  edited.insert(offset, "z");
+
+  auto tokens = Lexer(source).tokenize();
+  IncrementalParser parser;
+  parser.parse(tokens);
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    RelexRange inserted = Lexer(edited).relex(tokens, {offset, 0, "z"});
+    benchmark::DoNotOptimize(parser.reparse(tokens, inserted));
+    RelexRange deleted = Lexer(source).relex(tokens, {offset, 1, ""});
+    benchmark::DoNotOptimize(parser.reparse(tokens, deleted));
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_Parser_LargeProgram_Reparse);
+
+// Benchmark: List the function names of a large program (5000 functions),
+// either from a full parse (arg 0) or with function bodies deferred (arg 1)
+static void BM_Parser_LargeProgram_Outline(benchmark::State &state) {
+  std::string source = generate_function_source(5000);
+  auto tokens = Lexer(source).tokenize();
+  const bool lazy = state.range(0) != 0;
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    size_t names = 0;
+    auto count_names = [&names](const czc::cst::CSTNode *program) {
+      for (const auto &item : program->get_children()) {
+        names += item->get_type() == czc::cst::CSTNodeType::FnDeclaration;
+      }
+    };
+    if (lazy) {
+      LazyParser parser(tokens);
+      count_names(parser.parse());
+    } else {
+      Parser parser(tokens);
+      count_names(parser.parse().get());
+    }
+    benchmark::DoNotOptimize(names);
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_Parser_LargeProgram_Outline)->Arg(0)->Arg(1);
+
+// Benchmark: Extract the symbol index entries of a large program (5000
+// functions) with the token-level skim, without building a CST
+static void BM_Index_ExtractSymbols(benchmark::State &state) {
+  std::string source = generate_function_source(5000);
+  auto tokens = Lexer(source).tokenize();
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    auto symbols = czc::index::extract_symbols(tokens, source);
+    benchmark::DoNotOptimize(symbols.data());
+  }
+  state.SetBytesProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_Index_ExtractSymbols);
+
+// Benchmark: Parse pre-lexed functions whose bodies are full of broken
+// statements, so every block hits the cascading-error cap and recovers by
+// jumping to its closing brace
+static void BM_Parser_BrokenBlocks(benchmark::State &state) {
+  std::ostringstream oss;
+  for (int fn = 0; fn < 200; ++fn) {
+    oss << "fn broken" << fn << "() {\n";
+    for (int stmt = 0; stmt < 200; ++stmt) {
+      oss << "  let = (" << stmt << " + ;\n";
+    }
+    oss << "}\n";
+  }
+  std::string source = oss.str();
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Parser parser(tokens);
+    auto ast = parser.parse();
+    benchmark::DoNotOptimize(ast);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tokens.size()));
+}
+BENCHMARK(BM_Parser_BrokenBlocks);
+
+// Count the nodes reachable from an AST expression through its getters.
+static size_t walk_ast(const czc::ast::Expression *expr) {
+  using namespace czc::ast;
+  if (expr == nullptr) {
+    return 0;
+  }
+  switch (expr->get_kind()) {
+  case ASTNodeKind::BinaryOp: {
+    auto *binary = static_cast<const BinaryOpExpr *>(expr);
+    return 1 + walk_ast(binary->get_left()) + walk_ast(binary->get_right());
+  }
+  case ASTNodeKind::UnaryOp:
+    return 1 + walk_ast(static_cast<const UnaryOpExpr *>(expr)->get_operand());
+  case ASTNodeKind::ParenExpr:
+    return 1 +
+           walk_ast(static_cast<const ParenExpr *>(expr)->get_expression());
+  default:
+    return 1;
+  }
+}
+
+static size_t walk_ast(const czc::ast::Statement *stmt) {
+  using namespace czc::ast;
+  if (stmt == nullptr) {
+    return 0;
+  }
+  switch (stmt->get_kind()) {
+  case ASTNodeKind::BlockStmt: {
+    size_t total = 1;
+    for (const auto *child :
+         static_cast<const BlockStmt *>(stmt)->get_statements()) {
+      total += walk_ast(child);
+    }
+    return total;
+  }
+  case ASTNodeKind::ExprStmt:
+    return 1 + walk_ast(static_cast<const ExprStmt *>(stmt)->get_expression());
+  case ASTNodeKind::ReturnStmt:
+    return 1 + walk_ast(static_cast<const ReturnStmt *>(stmt)->get_value());
+  default:
+    return 1;
+  }
+}
+
+static size_t walk_ast(const czc::ast::Program *program) {
+  using namespace czc::ast;
+  size_t total = 1;
+  for (const auto *decl : program->get_declarations()) {
+    total += 1;
+    if (decl->get_kind() == ASTNodeKind::FunctionDecl) {
+      total += walk_ast(static_cast<const FunctionDecl *>(decl)->get_body());
+    } else if (decl->get_kind() == ASTNodeKind::VarDecl) {
+      total +=
+          walk_ast(static_cast<const VarDecl *>(decl)->get_initializer());
+    }
+  }
+  return total;
+}
+
+// Benchmark: Build an AST from a parsed CST (2000 functions) into a fresh
+// ASTContext per iteration
+static void BM_AST_Build(benchmark::State &state) {
+  std::string source = generate_function_source(2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+
+  size_t nodes = 0;
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    czc::ast::ASTContext context;
+    czc::ast::ASTBuilder builder(context);
+    auto *program = builder.build(tree.get());
+    benchmark::DoNotOptimize(program);
+    nodes = context.get_node_count();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nodes));
+}
+BENCHMARK(BM_AST_Build);
+
+// Benchmark: Walk a built AST (2000 functions) through its getters
+static void BM_AST_Walk(benchmark::State &state) {
+  std::string source = generate_function_source(2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  czc::ast::ASTContext context;
+  czc::ast::ASTBuilder builder(context);
+  auto *program = builder.build(tree.get());
+
+  size_t nodes = 0;
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    nodes = walk_ast(program);
+    benchmark::DoNotOptimize(nodes);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nodes));
+}
+BENCHMARK(BM_AST_Walk);
+
+// Benchmark: Parse and build an AST (2000 functions), through a full CST
+// (arg 0) or directly from the parser, one declaration at a time (arg 1)
+static void BM_AST_ParseAndBuild(benchmark::State &state) {
+  bool direct = state.range(0) != 0;
+  std::string source = generate_function_source(2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    czc::ast::ASTContext context;
+    czc::ast::ASTBuilder builder(context);
+    Parser parser(tokens);
+    czc::ast::Program *program = nullptr;
+    if (direct) {
+      program = builder.build(parser);
+    } else {
+      auto tree = parser.parse();
+      program = builder.build(tree.get());
+    }
+    benchmark::DoNotOptimize(program);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(tokens.size()));
+}
+BENCHMARK(BM_AST_ParseAndBuild)->Arg(0)->Arg(1);
+
+// Benchmark: Lex, parse and build an AST for a number-heavy data table
+// (5000 rows); literal values are decoded once, in the lexer
+static void BM_AST_NumericTable(benchmark::State &state) {
+  std::ostringstream oss;
+  for (int i = 0; i < 5000; ++i) {
+    oss << "let row" << i << " = " << (i * 7919 + 1234567) << " + "
+        << (i % 97) * 0.125 << " * 0x" << std::hex << (i * 31) << std::dec
+        << " - " << (i * 104729) << ";\n";
+  }
+  std::string source = oss.str();
+  size_t literals = 0;
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+    Parser parser(tokens);
+    czc::ast::ASTContext context;
+    czc::ast::ASTBuilder builder(context);
+    auto *program = builder.build(parser);
+    benchmark::DoNotOptimize(program);
+    literals = program->get_declarations().size() * 4;
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(literals));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_AST_NumericTable);
+
+// Counts every visited node through the virtual ASTVisitor interface.
+class CountingVisitor : public czc::ast::ASTBaseVisitor {
+public:
+  size_t count = 0;
+
+  void visit_program(czc::ast::Program *) override {
+    ++count;
+  }
+  void visit_function_decl(czc::ast::FunctionDecl *) override {
+    ++count;
+  }
+  void visit_parameter(czc::ast::Parameter *) override {
+    ++count;
+  }
+  void visit_block_stmt(czc::ast::BlockStmt *) override {
+    ++count;
+  }
+  void visit_var_decl(czc::ast::VarDecl *) override {
+    ++count;
+  }
+  void visit_return_stmt(czc::ast::ReturnStmt *) override {
+    ++count;
+  }
+  void visit_expr_stmt(czc::ast::ExprStmt *) override {
+    ++count;
+  }
+  void visit_binary_op(czc::ast::BinaryOpExpr *) override {
+    ++count;
+  }
+  void visit_unary_op(czc::ast::UnaryOpExpr *) override {
+    ++count;
+  }
+  void visit_identifier(czc::ast::Identifier *) override {
+    ++count;
+  }
+  void visit_integer_literal(czc::ast::IntegerLiteral *) override {
+    ++count;
+  }
+  void visit_call_expr(czc::ast::CallExpr *) override {
+    ++count;
+  }
+};
+
+// Counts the same nodes through the statically dispatched ASTWalker.
+class CountingWalker : public czc::ast::ASTWalker<CountingWalker> {
+public:
+  size_t count = 0;
+
+  bool enter_program(czc::ast::Program *) {
+    ++count;
+    return true;
+  }
+  bool enter_function_decl(czc::ast::FunctionDecl *) {
+    ++count;
+    return true;
+  }
+  bool enter_parameter(czc::ast::Parameter *) {
+    ++count;
+    return true;
+  }
+  bool enter_block_stmt(czc::ast::BlockStmt *) {
+    ++count;
+    return true;
+  }
+  bool enter_var_decl(czc::ast::VarDecl *) {
+    ++count;
+    return true;
+  }
+  bool enter_return_stmt(czc::ast::ReturnStmt *) {
+    ++count;
+    return true;
+  }
+  bool enter_expr_stmt(czc::ast::ExprStmt *) {
+    ++count;
+    return true;
+  }
+  bool enter_binary_op(czc::ast::BinaryOpExpr *) {
+    ++count;
+    return true;
+  }
+  bool enter_unary_op(czc::ast::UnaryOpExpr *) {
+    ++count;
+    return true;
+  }
+  bool enter_identifier(czc::ast::Identifier *) {
+    ++count;
+    return true;
+  }
+  bool enter_integer_literal(czc::ast::IntegerLiteral *) {
+    ++count;
+    return true;
+  }
+  bool enter_call_expr(czc::ast::CallExpr *) {
+    ++count;
+    return true;
+  }
+};
+
+// Benchmark: Count the nodes of a built AST (2000 functions) with a virtual
+// visitor driven by ast::walk (arg 0) or with a CRTP ASTWalker (arg 1)
+static void BM_AST_Visit(benchmark::State &state) {
+  bool crtp = state.range(0) != 0;
+  std::string source = generate_function_source(2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  czc::ast::ASTContext context;
+  czc::ast::ASTBuilder builder(context);
+  auto *program = builder.build(tree.get());
+
+  size_t nodes = 0;
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    if (crtp) {
+      CountingWalker walker;
+      walker.walk(program);
+      nodes = walker.count;
+    } else {
+      CountingVisitor visitor;
+      czc::ast::walk(program, visitor);
+      nodes = visitor.count;
+    }
+    benchmark::DoNotOptimize(nodes);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nodes));
+}
+BENCHMARK(BM_AST_Visit)->Arg(0)->Arg(1);
+
+// Sums the right operands of integer-literal additions found by a tree walk.
+class LiteralAddWalker : public czc::ast::ASTWalker<LiteralAddWalker> {
+public:
+  int64_t sum = 0;
+
+  bool enter_binary_op(czc::ast::BinaryOpExpr *node) {
+    const auto *right = node->get_right();
+    if (right->get_kind() == czc::ast::ASTNodeKind::IntegerLiteral) {
+      sum += static_cast<const czc::ast::IntegerLiteral *>(right)->get_value();
+    }
+    return true;
+  }
+};
+
+// Benchmark: Visit every BinaryOpExpr of a built AST (10000 arithmetic
+// declarations), by walking the tree (arg 0) or by sweeping the context's
+// BinaryOpExpr pool (arg 1)
+static void BM_AST_SweepBinaryOps(benchmark::State &state) {
+  bool sweep = state.range(0) != 0;
+  std::ostringstream oss;
+  for (int i = 0; i < 10000; ++i) {
+    oss << "let v" << i << " = a + " << i << " * 2 - (b + 3);\n";
+  }
+  std::string source = oss.str();
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  czc::ast::ASTContext context;
+  czc::ast::ASTBuilder builder(context);
+  auto *program = builder.build(tree.get());
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    if (sweep) {
+      context.for_each_node<czc::ast::BinaryOpExpr>(
+          [&sum](const czc::ast::BinaryOpExpr &node) {
+            const auto *right = node.get_right();
+            if (right->get_kind() == czc::ast::ASTNodeKind::IntegerLiteral) {
+              sum += static_cast<const czc::ast::IntegerLiteral *>(right)
+                         ->get_value();
+            }
+          });
+    } else {
+      LiteralAddWalker walker;
+      walker.walk(program);
+      sum = walker.sum;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(
+      state.iterations() *
+      static_cast<int64_t>(context.get_node_count<czc::ast::BinaryOpExpr>()));
+}
+BENCHMARK(BM_AST_SweepBinaryOps)->Arg(0)->Arg(1);
+
+// Generates declarations initialized with constant arithmetic, the shape of
+// generated config files.
+static std::string generate_constant_config(int num_declarations) {
+  std::ostringstream oss;
+  for (int i = 0; i < num_declarations; ++i) {
+    oss << "let c" << i << " = ((" << i << " + 4) * (16 - 2) + -(3 * " << i
+        << ")) * (2 + 3 * (1 + 1)) - " << i << ";\n";
+  }
+  return oss.str();
+}
+
+// Evaluates an integer expression tree made of literals and arithmetic.
+static int64_t evaluate(const czc::ast::Expression *expr) {
+  using namespace czc::ast;
+  switch (expr->get_kind()) {
+  case ASTNodeKind::IntegerLiteral:
+    return static_cast<const IntegerLiteral *>(expr)->get_value();
+  case ASTNodeKind::ParenExpr:
+    return evaluate(static_cast<const ParenExpr *>(expr)->get_expression());
+  case ASTNodeKind::UnaryOp:
+    return -evaluate(static_cast<const UnaryOpExpr *>(expr)->get_operand());
+  case ASTNodeKind::BinaryOp: {
+    const auto *binary = static_cast<const BinaryOpExpr *>(expr);
+    int64_t left = evaluate(binary->get_left());
+    int64_t right = evaluate(binary->get_right());
+    switch (binary->get_operator()) {
+    case BinaryOperator::Add:
+      return left + right;
+    case BinaryOperator::Sub:
+      return left - right;
+    default:
+      return left * right;
+    }
+  }
+  default:
+    return 0;
+  }
+}
+
+// Benchmark: Evaluate the initializers of a generated config (2000 constant
+// arithmetic declarations) on the tree as built (arg 0) or after a one-time
+// ConstantFolder pass (arg 1)
+static void BM_AST_EvaluateConstants(benchmark::State &state) {
+  bool fold = state.range(0) != 0;
+  std::string source = generate_constant_config(2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  czc::ast::ASTContext context;
+  czc::ast::ASTBuilder builder(context);
+  auto *program = builder.build(tree.get());
+  if (fold) {
+    czc::ast::ConstantFolder(context).run(program);
+  }
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (const auto *decl : program->get_declarations()) {
+      sum += evaluate(
+          static_cast<const czc::ast::VarDecl *>(decl)->get_initializer());
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(
+      state.iterations() *
+      static_cast<int64_t>(program->get_declarations().size()));
+}
+BENCHMARK(BM_AST_EvaluateConstants)->Arg(0)->Arg(1);
+
+// Benchmark: Run the ConstantFolder pass over a freshly built AST of 2000
+// constant arithmetic declarations
+static void BM_AST_ConstantFold(benchmark::State &state) {
+  std::string source = generate_constant_config(2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto context = std::make_unique<czc::ast::ASTContext>();
+    czc::ast::ASTBuilder builder(*context);
+    auto *program = builder.build(tree.get());
+    state.ResumeTiming();
+
+    czc::ast::ConstantFolder folder(*context);
+    folder.run(program);
+    benchmark::DoNotOptimize(folder.get_stats());
+
+    state.PauseTiming();
+    context.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * 2000);
+}
+BENCHMARK(BM_AST_ConstantFold);
+
+// Benchmark: Build an AST from a parsed CST (10000 constant arithmetic
+// declarations) serially (arg 0) or split across a thread pool by top-level
+// declaration (arg = worker count)
+static void BM_AST_BuildParallel(benchmark::State &state) {
+  size_t workers = static_cast<size_t>(state.range(0));
+  std::string source = generate_constant_config(10000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  czc::utils::ThreadPool pool(workers == 0 ? 1 : workers);
+
+  size_t nodes = 0;
+  for (auto _ : state) {
+    czc::ast::ASTContext context;
+    czc::ast::ASTBuilder builder(context);
+    auto *program = workers == 0 ? builder.build(tree.get())
+                                 : builder.build_parallel(tree.get(), pool);
+    benchmark::DoNotOptimize(program);
+    nodes = context.get_node_count();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nodes));
+}
+BENCHMARK(BM_AST_BuildParallel)->Arg(0)->Arg(2)->Arg(4)->UseRealTime();
+
+// Output sink that only counts bytes, so the benchmark measures formatting.
+class CountingSink : public czc::formatter::OutputSink {
+public:
+  size_t bytes = 0;
+
+  void write(std::string_view text) override {
+    bytes += text.size();
+  }
+};
+
+// Benchmark: Format a parsed CST (2000 functions) into a returned string
+// (arg 0) or through the reusable buffer into an output sink (arg 1)
+static void BM_Formatter_LargeProgram(benchmark::State &state) {
+  bool to_sink = state.range(0) != 0;
+  std::string source = generate_function_source(2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  czc::formatter::Formatter formatter;
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    if (to_sink) {
+      CountingSink sink;
+      formatter.format_to(tree.get(), sink);
+      benchmark::DoNotOptimize(sink.bytes);
+    } else {
+      std::string formatted = formatter.format(tree.get());
+      benchmark::DoNotOptimize(formatted.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Formatter_LargeProgram)->Arg(0)->Arg(1);
+
+// Benchmark: Format 2000 functions whose statements overflow 80 columns, with
+// auto-wrapping disabled (arg 0) or at max_line_length 80 (arg 1)
+static void BM_Formatter_WrapLongLines(benchmark::State &state) {
+  std::ostringstream oss;
+  for (int i = 0; i < 2000; ++i) {
+    oss << "fn wide" << i << "(first, second) {\n"
+        << "  let total = compute(first, second, helper(first, second), "
+           "another_argument_name, [1000, 2000, 3000, 4000]);\n"
+        << "  return first_operand + second_operand * third_operand + "
+           "fourth_operand - fifth_operand;\n"
+        << "}\n";
+  }
+  std::string source = oss.str();
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+
+  czc::formatter::FormatOptions options;
+  options.max_line_length = state.range(0) != 0 ? 80 : 0;
+  czc::formatter::Formatter formatter(options);
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    std::string formatted = formatter.format(tree.get());
+    benchmark::DoNotOptimize(formatted.data());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Formatter_WrapLongLines)->Arg(0)->Arg(1);
+
+// Benchmark: Reformat one statement in the middle of a file with N functions
+// through format_range; the cost should not grow with N
+static void BM_Formatter_FormatRange(benchmark::State &state) {
+  std::string source =
+      generate_function_source(static_cast<size_t>(state.range(0)));
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  czc::formatter::Formatter formatter;
+  size_t offset = source.find("return", source.size() / 2);
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    auto edits = formatter.format_range(tree.get(), source, offset, offset);
+    benchmark::DoNotOptimize(edits.data());
+  }
+}
+BENCHMARK(BM_Formatter_FormatRange)->Arg(100)->Arg(2000)->Arg(20000);
+
+// Benchmark: Check 2000 functions with is_formatted when the whole file is
+// already formatted (arg 0) or the first declaration differs (arg 1)
+static void BM_Formatter_IsFormatted(benchmark::State &state) {
+  std::string raw = generate_function_source(2000);
+  Lexer raw_lexer(raw);
+  auto raw_tokens = raw_lexer.tokenize();
+  Parser raw_parser(raw_tokens);
+  auto raw_tree = raw_parser.parse();
+  czc::formatter::Formatter formatter;
+  std::string formatted = formatter.format(raw_tree.get());
+
+  const std::string &source = state.range(0) != 0 ? raw : formatted;
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    bool same = formatter.is_formatted(tree.get(), source);
+    benchmark::DoNotOptimize(same);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Formatter_IsFormatted)->Arg(0)->Arg(1);
+
+// Shapes of generated source shared by the formatter and AST corpora.
+enum CorpusKind : int64_t {
+  // `size` plain functions (file size)
+  CORPUS_FUNCTIONS = 0,
+  // 100 functions whose bodies nest `size` if/else statements deep
+  CORPUS_NESTED = 1,
+  // `size` functions with a comment before every declaration and statement
+  CORPUS_COMMENTS = 2,
+  // 100 calls that each pass `size` arguments
+  CORPUS_LONG_ARGS = 3
+};
+
+static std::string generate_corpus(int64_t kind, int64_t size) {
+  std::ostringstream oss;
+  switch (kind) {
+  case CORPUS_NESTED:
+    for (int i = 0; i < 100; ++i) {
+      oss << "fn nested" << i << "(x) {\n";
+      for (int64_t d = 0; d < size; ++d) {
+        oss << "if (x > " << d << ") {\n";
+      }
+      oss << "let y = x + 1;\n";
+      for (int64_t d = 0; d < size; ++d) {
+        oss << "} else {\nlet z = " << d << ";\n}\n";
+      }
+      oss << "return x;\n}\n";
+    }
+    break;
+  case CORPUS_COMMENTS:
+    for (int64_t i = 0; i < size; ++i) {
+      oss << "// Function " << i << " computes a running total.\n"
+          << "// It is documented by a second comment line.\n"
+          << "fn commented" << i << "(a, b) {\n"
+          << "  // Sum the inputs.\n"
+          << "  let sum = a + b; // trailing comment\n"
+          << "  // Return the sum.\n"
+          << "  return sum;\n"
+          << "}\n\n";
+    }
+    break;
+  case CORPUS_LONG_ARGS:
+    for (int i = 0; i < 100; ++i) {
+      oss << "let call" << i << " = combine(";
+      for (int64_t a = 0; a < size; ++a) {
+        oss << (a == 0 ? "" : ", ") << "argument_" << a;
+      }
+      oss << ");\n";
+    }
+    break;
+  default:
+    return generate_function_source(static_cast<size_t>(size));
+  }
+  return oss.str();
+}
+
+// Register every corpus shape with a range of sizes.
+static void corpus_args(benchmark::internal::Benchmark *bench) {
+  bench->ArgNames({"kind", "size"});
+  for (int64_t size : {10, 100, 1000, 10000}) {
+    bench->Args({CORPUS_FUNCTIONS, size});
+  }
+  for (int64_t depth : {4, 16, 64}) {
+    bench->Args({CORPUS_NESTED, depth});
+  }
+  bench->Args({CORPUS_COMMENTS, 2000});
+  for (int64_t count : {8, 64, 512}) {
+    bench->Args({CORPUS_LONG_ARGS, count});
+  }
+}
+
+// Benchmark: Format generated corpora of varying file size, nesting depth,
+// comment density and argument list length (see corpus_args)
+static void BM_Formatter_Format(benchmark::State &state) {
+  std::string source = generate_corpus(state.range(0), state.range(1));
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+  czc::formatter::Formatter formatter;
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    std::string formatted = formatter.format(tree.get());
+    benchmark::DoNotOptimize(formatted.data());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_Formatter_Format)->Apply(corpus_args);
+
+// Benchmark: Pre-order walk of the comment-heavy corpus parsed with comments
+// as Comment nodes (arg 0) or kept in a CommentTable (arg 1)
+static void BM_CST_CommentTableWalk(benchmark::State &state) {
+  bool use_table = state.range(0) != 0;
+  std::string source = generate_corpus(CORPUS_COMMENTS, 2000);
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  czc::cst::CommentTable table;
+  Parser parser(tokens);
+  if (use_table) {
+    parser.set_comment_table(&table);
+  }
+  auto tree = parser.parse();
+
+  for (auto _ : state) {
+    size_t total = walk_tree(tree.get());
+    benchmark::DoNotOptimize(total);
+  }
+  state.counters["nodes"] =
+      static_cast<double>(czc::cst::FlatCST::from_tree(tree.get()).size());
+}
+BENCHMARK(BM_CST_CommentTableWalk)->Arg(0)->Arg(1);
+
+// Benchmark: Build an AST into a fresh ASTContext over the same corpora as
+// BM_Formatter_Format
+static void BM_AST_BuildCorpus(benchmark::State &state) {
+  std::string source = generate_corpus(state.range(0), state.range(1));
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto tree = parser.parse();
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    czc::ast::ASTContext context;
+    czc::ast::ASTBuilder builder(context);
+    auto *program = builder.build(tree.get());
+    benchmark::DoNotOptimize(program);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_AST_BuildCorpus)->Apply(corpus_args);
+
 BENCHMARK_MAIN();
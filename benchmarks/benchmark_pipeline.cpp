@@ -0,0 +1,399 @@
+/**
+ * @file benchmark_pipeline.cpp
+ * @brief End-to-end pipeline benchmarks over the checked-in corpus
+ * @details Every stage (lex, preprocess, parse, AST build, format) is timed
+ *          on its own over the programs in `benchmarks/corpus`, repeated the
+ *          given number of times, and reports bytes/sec, tokens/sec, heap
+ *          allocations and bytes per iteration, the stage's heap high-water
+ *          mark and the process peak RSS.
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/ast/ast_builder.hpp"
+#include "czc/ast/ast_context.hpp"
+#include "czc/diagnostics/diagnostic.hpp"
+#include "czc/diagnostics/diagnostic_sink.hpp"
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/session/session.hpp"
+#include "czc/token_preprocessor/preprocessed_token_source.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+
+#include "allocation_tracker.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+using namespace czc::lexer;
+using namespace czc::parser;
+
+#ifndef CZC_BENCH_CORPUS_DIR
+#define CZC_BENCH_CORPUS_DIR "benchmarks/corpus"
+#endif
+
+// Load every corpus program as a separate file, sorted by name.
+static std::vector<std::string> load_corpus_files() {
+  std::vector<std::filesystem::path> paths;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(CZC_BENCH_CORPUS_DIR)) {
+    if (entry.path().extension() == ".zero") {
+      paths.push_back(entry.path());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  std::vector<std::string> files;
+  for (const auto &path : paths) {
+    std::ifstream input(path, std::ios::binary);
+    files.emplace_back(std::istreambuf_iterator<char>(input),
+                       std::istreambuf_iterator<char>());
+  }
+  return files;
+}
+
+// Concatenate every corpus program, sorted by name, `copies` times.
+static std::string load_corpus(size_t copies) {
+  std::string corpus;
+  for (const auto &file : load_corpus_files()) {
+    corpus += file;
+    corpus += '\n';
+  }
+  std::string result;
+  result.reserve(corpus.size() * copies);
+  for (size_t i = 0; i < copies; ++i) {
+    result += corpus;
+  }
+  return result;
+}
+
+// Peak resident set size of the process in KiB (0 where unsupported).
+static double peak_rss_kib() {
+#if !defined(_WIN32)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#else
+    return static_cast<double>(usage.ru_maxrss);
+#endif
+  }
+#endif
+  return 0.0;
+}
+
+// Heap usage of one stage across all iterations.
+struct StageStats {
+  size_t allocations = 0;
+  size_t allocated_bytes = 0;
+  size_t peak_bytes = 0;
+
+  // Run one timed execution of the stage while recording its heap usage.
+  template <typename Fn> void run(Fn &&stage) {
+    AllocationTotals before = allocation_totals();
+    size_t live = live_heap_bytes();
+    reset_peak_heap_bytes();
+    stage();
+    AllocationTotals after = allocation_totals();
+    allocations += after.count - before.count;
+    allocated_bytes += after.bytes - before.bytes;
+    peak_bytes = std::max(peak_bytes, peak_heap_bytes() - live);
+  }
+
+  void report(benchmark::State &state, size_t bytes, size_t tokens) const {
+    auto iterations = static_cast<int64_t>(state.iterations());
+    state.SetBytesProcessed(iterations * static_cast<int64_t>(bytes));
+    state.counters["tokens"] = benchmark::Counter(
+        static_cast<double>(tokens) * static_cast<double>(iterations),
+        benchmark::Counter::kIsRate);
+    state.counters["allocs"] =
+        benchmark::Counter(static_cast<double>(allocations),
+                           benchmark::Counter::kAvgIterations);
+    state.counters["alloc_bytes"] =
+        benchmark::Counter(static_cast<double>(allocated_bytes),
+                           benchmark::Counter::kAvgIterations);
+    state.counters["peak_heap_kib"] =
+        benchmark::Counter(static_cast<double>(peak_bytes) / 1024.0);
+    state.counters["peak_rss_kib"] = benchmark::Counter(peak_rss_kib());
+  }
+};
+
+// Benchmark: Lex the corpus, repeated arg times
+static void BM_Pipeline_Lex(benchmark::State &state) {
+  std::string source = load_corpus(static_cast<size_t>(state.range(0)));
+  StageStats stats;
+  size_t tokens = 0;
+  for (auto _ : state) {
+    stats.run([&]() {
+      Lexer lexer(source, "corpus.zero");
+      auto result = lexer.tokenize();
+      tokens = result.size();
+      benchmark::DoNotOptimize(result.data());
+    });
+  }
+  stats.report(state, source.size(), tokens);
+}
+BENCHMARK(BM_Pipeline_Lex)->Arg(1)->Arg(32);
+
+// Benchmark: Run the token preprocessor over the lexed corpus in place
+static void BM_Pipeline_Preprocess(benchmark::State &state) {
+  std::string source = load_corpus(static_cast<size_t>(state.range(0)));
+  Lexer lexer(source, "corpus.zero");
+  auto lexed = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  StageStats stats;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto tokens = lexed;
+    state.ResumeTiming();
+    stats.run([&]() {
+      preprocessor.process_in_place(tokens, "corpus.zero", source);
+      benchmark::DoNotOptimize(tokens.data());
+    });
+  }
+  stats.report(state, source.size(), lexed.size());
+}
+BENCHMARK(BM_Pipeline_Preprocess)->Arg(1)->Arg(32);
+
+// Benchmark: Parse the preprocessed corpus into a CST
+static void BM_Pipeline_Parse(benchmark::State &state) {
+  std::string source = load_corpus(static_cast<size_t>(state.range(0)));
+  Lexer lexer(source, "corpus.zero");
+  auto tokens = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "corpus.zero", source);
+  StageStats stats;
+  for (auto _ : state) {
+    stats.run([&]() {
+      Parser parser(tokens, "corpus.zero");
+      auto cst = parser.parse();
+      benchmark::DoNotOptimize(cst);
+    });
+  }
+  stats.report(state, source.size(), tokens.size());
+}
+BENCHMARK(BM_Pipeline_Parse)->Arg(1)->Arg(32);
+
+// Benchmark: Build an AST from the corpus CST into a fresh ASTContext
+static void BM_Pipeline_BuildAST(benchmark::State &state) {
+  std::string source = load_corpus(static_cast<size_t>(state.range(0)));
+  Lexer lexer(source, "corpus.zero");
+  auto tokens = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "corpus.zero", source);
+  Parser parser(tokens, "corpus.zero");
+  auto cst = parser.parse();
+  StageStats stats;
+  for (auto _ : state) {
+    stats.run([&]() {
+      czc::ast::ASTContext context;
+      czc::ast::ASTBuilder builder(context);
+      auto *program = builder.build(cst.get());
+      benchmark::DoNotOptimize(program);
+    });
+  }
+  stats.report(state, source.size(), tokens.size());
+}
+BENCHMARK(BM_Pipeline_BuildAST)->Arg(1)->Arg(32);
+
+// Benchmark: Format the corpus CST back to text
+static void BM_Pipeline_Format(benchmark::State &state) {
+  std::string source = load_corpus(static_cast<size_t>(state.range(0)));
+  Lexer lexer(source, "corpus.zero");
+  auto tokens = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "corpus.zero", source);
+  Parser parser(tokens, "corpus.zero");
+  auto cst = parser.parse();
+  czc::formatter::Formatter formatter;
+  StageStats stats;
+  for (auto _ : state) {
+    stats.run([&]() {
+      std::string formatted = formatter.format(cst.get());
+      benchmark::DoNotOptimize(formatted.data());
+    });
+  }
+  stats.report(state, source.size(), tokens.size());
+}
+BENCHMARK(BM_Pipeline_Format)->Arg(1)->Arg(32);
+
+// Benchmark: Format the corpus CST with a fresh declaration memo per run;
+// with 32 copies every declaration after the first copy is a duplicate
+static void BM_Pipeline_Format_Memo(benchmark::State &state) {
+  std::string source = load_corpus(static_cast<size_t>(state.range(0)));
+  Lexer lexer(source, "corpus.zero");
+  auto tokens = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "corpus.zero", source);
+  Parser parser(tokens, "corpus.zero");
+  auto cst = parser.parse();
+  czc::formatter::Formatter formatter;
+  StageStats stats;
+  for (auto _ : state) {
+    stats.run([&]() {
+      czc::formatter::FormatMemo memo;
+      formatter.set_memo(&memo, source);
+      std::string formatted = formatter.format(cst.get());
+      formatter.set_memo(nullptr, {});
+      benchmark::DoNotOptimize(formatted.data());
+    });
+  }
+  stats.report(state, source.size(), tokens.size());
+}
+BENCHMARK(BM_Pipeline_Format_Memo)->Arg(1)->Arg(32);
+
+// Benchmark: Run every stage back to back, as `czc-cli fmt` does per file
+static void BM_Pipeline_EndToEnd(benchmark::State &state) {
+  std::string source = load_corpus(static_cast<size_t>(state.range(0)));
+  StageStats stats;
+  size_t token_count = 0;
+  for (auto _ : state) {
+    stats.run([&]() {
+      Lexer lexer(source, "corpus.zero");
+      auto tokens = lexer.tokenize();
+      czc::token_preprocessor::TokenPreprocessor preprocessor;
+      preprocessor.process_in_place(tokens, "corpus.zero", source);
+      Parser parser(tokens, "corpus.zero");
+      auto cst = parser.parse();
+      czc::ast::ASTContext context;
+      czc::ast::ASTBuilder builder(context);
+      benchmark::DoNotOptimize(builder.build(cst.get()));
+      czc::formatter::Formatter formatter;
+      std::string formatted = formatter.format(cst.get());
+      benchmark::DoNotOptimize(formatted.data());
+      token_count = tokens.size();
+    });
+  }
+  stats.report(state, source.size(), token_count);
+}
+BENCHMARK(BM_Pipeline_EndToEnd)->Arg(1)->Arg(32);
+
+// Benchmark: Format each corpus program as its own file the way a
+// `czc-cli fmt` worker does, with a fresh diagnostic engine and formatter
+// per file (arg 0) or one pair reused across files (arg 1)
+static void BM_Pipeline_PerFile(benchmark::State &state) {
+  std::vector<std::string> files = load_corpus_files();
+  bool reuse = state.range(0) != 0;
+  std::optional<czc::diagnostics::DiagnosticEngine> shared_diagnostics;
+  std::optional<czc::formatter::Formatter> shared_formatter;
+  StageStats stats;
+  size_t bytes = 0;
+  for (const auto &file : files) {
+    bytes += file.size();
+  }
+  for (auto _ : state) {
+    stats.run([&]() {
+      for (const auto &file : files) {
+        std::optional<czc::diagnostics::DiagnosticEngine> fresh_diagnostics;
+        std::optional<czc::formatter::Formatter> fresh_formatter;
+        auto &diagnostics = reuse ? shared_diagnostics : fresh_diagnostics;
+        auto &formatter = reuse ? shared_formatter : fresh_formatter;
+        if (diagnostics) {
+          diagnostics->clear();
+        } else {
+          diagnostics.emplace();
+        }
+        if (!formatter) {
+          formatter.emplace();
+        }
+
+        auto source = std::make_unique<
+            czc::token_preprocessor::PreprocessedTokenSource>(file,
+                                                              "file.zero");
+        source->set_error_reporter(&*diagnostics);
+        Parser parser(std::move(source), "file.zero");
+        parser.set_error_reporter(&*diagnostics);
+        parser.set_arena_enabled(true);
+        auto cst = parser.parse();
+        formatter->get_error_collector().set_reporter(&*diagnostics);
+        std::string formatted = formatter->format(cst.get());
+        benchmark::DoNotOptimize(formatted.data());
+      }
+    });
+  }
+  stats.report(state, bytes, 0);
+}
+BENCHMARK(BM_Pipeline_PerFile)->Arg(0)->Arg(1);
+
+// Benchmark: Format the same per-file corpus through one `Session`, which
+// keeps its diagnostic engines, formatters and thread pool across runs;
+// arg is the worker count
+static void BM_Session_FormatBatch(benchmark::State &state) {
+  std::vector<std::string> files = load_corpus_files();
+  std::vector<czc::session::SourceInput> inputs;
+  size_t bytes = 0;
+  for (const auto &file : files) {
+    inputs.push_back({"file.zero", file});
+    bytes += file.size();
+  }
+  czc::session::SessionOptions options;
+  options.jobs = static_cast<size_t>(state.range(0));
+  options.share_format_memo = false;
+  czc::session::Session session(options);
+  StageStats stats;
+  for (auto _ : state) {
+    stats.run([&]() {
+      auto results = session.run(inputs);
+      benchmark::DoNotOptimize(results.data());
+    });
+  }
+  stats.report(state, bytes, 0);
+}
+BENCHMARK(BM_Session_FormatBatch)->Arg(1)->Arg(4)->UseRealTime();
+
+// Benchmark: Report diagnostics from several threads into one engine behind
+// a mutex, the way a shared `DiagnosticEngine` would have to be guarded
+static void BM_Pipeline_Diagnostics_Locked(benchmark::State &state) {
+  static std::unique_ptr<czc::diagnostics::DiagnosticEngine> engine;
+  static std::mutex mutex;
+  if (state.thread_index() == 0) {
+    engine = std::make_unique<czc::diagnostics::DiagnosticEngine>();
+  }
+  czc::utils::SourceLocation location("bench.zero", 1, 1);
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> lock(mutex);
+    engine->report(czc::diagnostics::DiagnosticLevel::Error,
+                   czc::diagnostics::DiagnosticCode::P0003_ExpectedSemicolon,
+                   location, {";"});
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    engine.reset();
+  }
+}
+BENCHMARK(BM_Pipeline_Diagnostics_Locked)->ThreadRange(1, 8)->UseRealTime();
+
+// Benchmark: Report the same diagnostics into a `DiagnosticSink`, which
+// appends to per-thread buffers without locking
+static void BM_Pipeline_Diagnostics_Sink(benchmark::State &state) {
+  static std::unique_ptr<czc::diagnostics::DiagnosticSink> sink;
+  if (state.thread_index() == 0) {
+    sink = std::make_unique<czc::diagnostics::DiagnosticSink>();
+  }
+  czc::utils::SourceLocation location("bench.zero", 1, 1);
+  for (auto _ : state) {
+    sink->report(czc::diagnostics::DiagnosticLevel::Error,
+                 czc::diagnostics::DiagnosticCode::P0003_ExpectedSemicolon,
+                 location, {";"});
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    sink.reset();
+  }
+}
+BENCHMARK(BM_Pipeline_Diagnostics_Sink)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
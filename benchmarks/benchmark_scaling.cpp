@@ -0,0 +1,180 @@
+/**
+ * @file benchmark_scaling.cpp
+ * @brief Large-file scalability and memory benchmarks
+ * @details Lexing, parsing and formatting are each run over the checked-in
+ *          corpus repeated up to a target size, from 1 KiB upwards in steps
+ *          of 4x. Besides bytes/sec every benchmark reports the stage's heap
+ *          high-water mark per source byte (`heap_per_byte`), so a stage
+ *          whose memory grows faster than its input shows a rising ratio
+ *          across sizes, and the process peak RSS.
+ *
+ *          The largest size defaults to 64 MiB; set `CZC_BENCH_MAX_BYTES`
+ *          (e.g. `1073741824`) to extend the sweep towards 1 GiB.
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+
+#include "allocation_tracker.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+using namespace czc::lexer;
+using namespace czc::parser;
+
+#ifndef CZC_BENCH_CORPUS_DIR
+#define CZC_BENCH_CORPUS_DIR "benchmarks/corpus"
+#endif
+
+static constexpr int64_t MIN_SCALE_BYTES = int64_t{1} << 10;
+static constexpr int64_t DEFAULT_MAX_SCALE_BYTES = int64_t{1} << 26;
+
+// Repeat the corpus programs, sorted by name, until at least `bytes` long.
+static std::string scaled_corpus(size_t bytes) {
+  std::vector<std::filesystem::path> files;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(CZC_BENCH_CORPUS_DIR)) {
+    if (entry.path().extension() == ".zero") {
+      files.push_back(entry.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::string corpus;
+  for (const auto &file : files) {
+    std::ifstream input(file, std::ios::binary);
+    corpus.append(std::istreambuf_iterator<char>(input),
+                  std::istreambuf_iterator<char>());
+    corpus += '\n';
+  }
+  std::string result;
+  if (corpus.empty()) {
+    return result;
+  }
+  result.reserve(bytes + corpus.size());
+  while (result.size() < bytes) {
+    result += corpus;
+  }
+  return result;
+}
+
+// Peak resident set size of the process in KiB (0 where unsupported).
+static double peak_rss_kib() {
+#if !defined(_WIN32)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#else
+    return static_cast<double>(usage.ru_maxrss);
+#endif
+  }
+#endif
+  return 0.0;
+}
+
+// Register the size sweep, capped by CZC_BENCH_MAX_BYTES when set.
+static void scale_sizes(benchmark::internal::Benchmark *bench) {
+  int64_t max_bytes = DEFAULT_MAX_SCALE_BYTES;
+  if (const char *env = std::getenv("CZC_BENCH_MAX_BYTES")) {
+    max_bytes = std::max<int64_t>(std::atoll(env), MIN_SCALE_BYTES);
+  }
+  bench->ArgName("bytes");
+  for (int64_t bytes = MIN_SCALE_BYTES; bytes <= max_bytes; bytes *= 4) {
+    bench->Arg(bytes);
+  }
+  bench->Unit(benchmark::kMillisecond);
+}
+
+// Heap high-water mark of the timed stage, relative to the live heap before.
+struct ScalingStats {
+  size_t peak_bytes = 0;
+
+  template <typename Fn> void run(Fn &&stage) {
+    size_t live = live_heap_bytes();
+    reset_peak_heap_bytes();
+    stage();
+    peak_bytes = std::max(peak_bytes, peak_heap_bytes() - live);
+  }
+
+  void report(benchmark::State &state, size_t bytes) const {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(bytes));
+    state.counters["heap_per_byte"] = benchmark::Counter(
+        static_cast<double>(peak_bytes) / static_cast<double>(bytes));
+    state.counters["peak_rss_kib"] = benchmark::Counter(peak_rss_kib());
+  }
+};
+
+// Benchmark: Lex the scaled corpus
+static void BM_Scaling_Lex(benchmark::State &state) {
+  std::string source = scaled_corpus(static_cast<size_t>(state.range(0)));
+  ScalingStats stats;
+  for (auto _ : state) {
+    stats.run([&]() {
+      Lexer lexer(source, "scaled.zero");
+      auto tokens = lexer.tokenize();
+      benchmark::DoNotOptimize(tokens.data());
+    });
+  }
+  stats.report(state, source.size());
+}
+BENCHMARK(BM_Scaling_Lex)->Apply(scale_sizes);
+
+// Benchmark: Parse the preprocessed scaled corpus into a CST
+static void BM_Scaling_Parse(benchmark::State &state) {
+  std::string source = scaled_corpus(static_cast<size_t>(state.range(0)));
+  Lexer lexer(source, "scaled.zero");
+  auto tokens = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "scaled.zero", source);
+  ScalingStats stats;
+  for (auto _ : state) {
+    stats.run([&]() {
+      Parser parser(tokens, "scaled.zero");
+      auto cst = parser.parse();
+      benchmark::DoNotOptimize(cst);
+    });
+  }
+  stats.report(state, source.size());
+}
+BENCHMARK(BM_Scaling_Parse)->Apply(scale_sizes);
+
+// Benchmark: Format the scaled corpus CST back to text
+static void BM_Scaling_Format(benchmark::State &state) {
+  std::string source = scaled_corpus(static_cast<size_t>(state.range(0)));
+  Lexer lexer(source, "scaled.zero");
+  auto tokens = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "scaled.zero", source);
+  Parser parser(tokens, "scaled.zero");
+  auto cst = parser.parse();
+  czc::formatter::Formatter formatter;
+  ScalingStats stats;
+  for (auto _ : state) {
+    stats.run([&]() {
+      std::string formatted = formatter.format(cst.get());
+      benchmark::DoNotOptimize(formatted.data());
+    });
+  }
+  stats.report(state, source.size());
+}
+BENCHMARK(BM_Scaling_Format)->Apply(scale_sizes);
+
+BENCHMARK_MAIN();
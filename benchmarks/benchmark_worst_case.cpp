@@ -0,0 +1,87 @@
+/**
+ * @file benchmark_worst_case.cpp
+ * @brief Regression benchmarks over known slow inputs
+ * @details Each file in `benchmarks/slow_inputs` is a pathological input
+ *          (deep nesting, long error-recovery runs, escape-heavy strings,
+ *          long digit runs, long operator chains), either hand-written or
+ *          found by `fuzz/fuzz_worst_case`. Every file is run through the
+ *          whole pipeline as its own benchmark, indexed by the sorted file
+ *          name, so a change that makes one of them super-linear again shows
+ *          up in `make benchmark-check`.
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+
+#include "allocation_tracker.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace czc::lexer;
+using namespace czc::parser;
+
+#ifndef CZC_BENCH_SLOW_INPUT_DIR
+#define CZC_BENCH_SLOW_INPUT_DIR "benchmarks/slow_inputs"
+#endif
+
+// The slow inputs, sorted by name.
+static const std::vector<std::filesystem::path> &slow_inputs() {
+  static const std::vector<std::filesystem::path> files = []() {
+    std::vector<std::filesystem::path> result;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(
+             CZC_BENCH_SLOW_INPUT_DIR, error)) {
+      if (entry.path().extension() == ".zero") {
+        result.push_back(entry.path());
+      }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }();
+  return files;
+}
+
+// Register one benchmark argument per slow input.
+static void slow_input_args(benchmark::internal::Benchmark *bench) {
+  bench->ArgName("input");
+  for (size_t i = 0; i < slow_inputs().size(); ++i) {
+    bench->Arg(static_cast<int64_t>(i));
+  }
+}
+
+// Benchmark: Lex, preprocess, parse and format one slow input
+static void BM_WorstCase_Pipeline(benchmark::State &state) {
+  const auto &path = slow_inputs()[static_cast<size_t>(state.range(0))];
+  state.SetLabel(path.filename().string());
+  std::ifstream input(path, std::ios::binary);
+  std::string source((std::istreambuf_iterator<char>(input)),
+                     std::istreambuf_iterator<char>());
+
+  AllocationCounters heap(state);
+  for (auto _ : state) {
+    Lexer lexer(source, "slow.zero");
+    auto tokens = lexer.tokenize();
+    czc::token_preprocessor::TokenPreprocessor preprocessor;
+    preprocessor.process_in_place(tokens, "slow.zero", source);
+    Parser parser(tokens, "slow.zero");
+    auto cst = parser.parse();
+    czc::formatter::Formatter formatter;
+    std::string formatted = formatter.format(cst.get());
+    benchmark::DoNotOptimize(formatted.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(source.size()));
+}
+BENCHMARK(BM_WorstCase_Pipeline)->Apply(slow_input_args);
+
+BENCHMARK_MAIN();
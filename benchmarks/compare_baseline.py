@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Compare Google Benchmark JSON results against a stored baseline.
+
+Every benchmark is expected to have been run with repetitions
+(--benchmark_repetitions=N), so that each side has N samples. A benchmark
+counts as a regression when its median time (or the chosen counter, e.g.
+INSTRUCTIONS collected with --benchmark_perf_counters) grew by more than
+the threshold AND a two-sided Mann-Whitney U test says the two sample sets differ at the
+given significance level. The script exits with status 1 if any benchmark
+regressed, so it can gate a build.
+
+Usage:
+    compare_baseline.py BASELINE_DIR CURRENT_DIR [--threshold 0.05]
+                        [--alpha 0.05] [--metric cpu_time]
+
+Both directories hold one <suite>.json file per benchmark executable, as
+written by `make benchmark-baseline` and `make benchmark-check`.
+"""
+import argparse
+import json
+import math
+import os
+import sys
+
+# Multipliers that convert a Google Benchmark time_unit to nanoseconds.
+TIME_UNITS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+# Metrics reported in time_unit; anything else (a user or hardware counter
+# such as INSTRUCTIONS or allocs) is compared as is.
+TIME_METRICS = ('cpu_time', 'real_time')
+
+# Minimum samples per side before the U test is meaningful.
+MIN_SAMPLES = 3
+
+
+def load_samples(path, metric):
+    """Return {benchmark name: [sample, ...]} for one JSON result file.
+
+    Times are converted to nanoseconds; benchmarks without the metric are
+    left out.
+    """
+    with open(path, 'r') as f:
+        data = json.load(f)
+
+    samples = {}
+    for bench in data.get('benchmarks', []):
+        # Skip the mean/median/stddev aggregates; keep individual repetitions.
+        if bench.get('run_type', 'iteration') != 'iteration':
+            continue
+        if bench.get('error_occurred'):
+            continue
+        name = bench.get('run_name', bench['name'])
+        if metric not in bench:
+            continue
+        scale = 1.0
+        if metric in TIME_METRICS:
+            scale = TIME_UNITS.get(bench.get('time_unit', 'ns'), 1.0)
+        samples.setdefault(name, []).append(float(bench[metric]) * scale)
+    return samples
+
+
+def median(values):
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+    if len(ordered) % 2:
+        return ordered[middle]
+    return (ordered[middle - 1] + ordered[middle]) / 2.0
+
+
+def relative_change(base, current):
+    """Relative change of the medians; a counter growing from zero is +inf."""
+    base_median = median(base)
+    current_median = median(current)
+    if base_median == 0:
+        return 0.0 if current_median == 0 else math.inf
+    return current_median / base_median - 1.0
+
+
+def mann_whitney_p(first, second):
+    """Two-sided p-value of the Mann-Whitney U test (normal approximation).
+
+    Ties get their average rank, and the variance is corrected for them.
+    """
+    n1 = len(first)
+    n2 = len(second)
+    n = n1 + n2
+    pooled = sorted([(value, 0) for value in first] +
+                    [(value, 1) for value in second])
+
+    rank_sum = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        average_rank = (i + j) / 2.0 + 1.0
+        for k in range(i, j + 1):
+            if pooled[k][1] == 0:
+                rank_sum += average_rank
+        ties = j - i + 1
+        tie_term += ties ** 3 - ties
+        i = j + 1
+
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    # Continuity correction towards the mean.
+    delta = abs(u - mean) - 0.5
+    if delta <= 0:
+        return 1.0
+    z = delta / math.sqrt(variance)
+    return math.erfc(z / math.sqrt(2.0))
+
+
+def compare_suite(baseline, current, args):
+    """Print one line per benchmark and return the number of regressions."""
+    regressions = 0
+    for name in sorted(current):
+        if name not in baseline:
+            print('  {:<60} new benchmark, no baseline'.format(name))
+            continue
+        base = baseline[name]
+        cur = current[name]
+        change = relative_change(base, cur)
+        if len(base) < MIN_SAMPLES or len(cur) < MIN_SAMPLES:
+            print('  {:<60} {:+7.1%}  (too few repetitions for a U test)'
+                  .format(name, change))
+            continue
+        p_value = mann_whitney_p(base, cur)
+        regressed = change > args.threshold and p_value < args.alpha
+        improved = change < -args.threshold and p_value < args.alpha
+        verdict = 'REGRESSION' if regressed else (
+            'improved' if improved else 'ok')
+        print('  {:<60} {:+7.1%}  p={:.4f}  {}'.format(
+            name, change, p_value, verdict))
+        if regressed:
+            regressions += 1
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Fail when benchmarks regress against a baseline.')
+    parser.add_argument('baseline', help='directory with baseline JSON files')
+    parser.add_argument('current', help='directory with current JSON files')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='relative median slowdown that fails '
+                             '(default: 0.05)')
+    parser.add_argument('--alpha', type=float, default=0.05,
+                        help='significance level of the U test '
+                             '(default: 0.05)')
+    parser.add_argument('--metric', default='cpu_time',
+                        help='cpu_time, real_time or a counter name such as '
+                             'INSTRUCTIONS (default: cpu_time)')
+    args = parser.parse_args()
+
+    suites = sorted(f for f in os.listdir(args.current) if f.endswith('.json'))
+    if not suites:
+        print('No benchmark results in {}'.format(args.current))
+        return 2
+
+    regressions = 0
+    for suite in suites:
+        baseline_path = os.path.join(args.baseline, suite)
+        if not os.path.exists(baseline_path):
+            print('{}: no baseline, skipped'.format(suite))
+            continue
+        print('{}:'.format(suite))
+        regressions += compare_suite(
+            load_samples(baseline_path, args.metric),
+            load_samples(os.path.join(args.current, suite), args.metric),
+            args)
+
+    if regressions:
+        print('{} benchmark(s) regressed by more than {:.0%} (alpha={})'
+              .format(regressions, args.threshold, args.alpha))
+        return 1
+    print('No significant regressions.')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -5,40 +5,259 @@
  * @date 2025-11-11
  */
 
+#include "czc/cst/cst_cache.hpp"
 #include "czc/diagnostics/diagnostic.hpp"
+#include "czc/formatter/format_cache.hpp"
+#include "czc/formatter/format_memo.hpp"
 #include "czc/formatter/formatter.hpp"
+#include "czc/index/symbol_index.hpp"
 #include "czc/lexer/lexer.hpp"
 #include "czc/parser/parser.hpp"
+#include "czc/server/server.hpp"
+#include "czc/stats/corpus_stats.hpp"
+#include "czc/token_preprocessor/preprocessed_token_source.hpp"
 #include "czc/token_preprocessor/token_preprocessor.hpp"
+#include "czc/utils/atomic_file.hpp"
+#include "czc/utils/bounded_queue.hpp"
 #include "czc/utils/color.hpp"
 #include "czc/utils/file_collector.hpp"
+#include "czc/utils/mem_report.hpp"
+#include "czc/utils/source_buffer.hpp"
+#include "czc/utils/source_manager.hpp"
 #include "czc/utils/source_tracker.hpp"
+#include "czc/utils/thread_pool.hpp"
+#include "czc/utils/time_report.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace czc::diagnostics;
 using namespace czc::formatter;
 using namespace czc::lexer;
 using namespace czc::parser;
+using namespace czc::server;
+using namespace czc::stats;
 using namespace czc::token_preprocessor;
 using namespace czc::utils;
 
 // 版本信息
 const std::string VERSION = "0.1.0";
+
+#if CZC_ENABLE_TIME_REPORT
+// NOTE: 替换全局的 `operator new`，为 `--time-report` 统计堆分配次数；
+//       统计关闭时只多一次原子读取。替换函数不能内联，否则 GCC 会对
+//       内联后的调用点误报 new/free 不匹配。
+//       单个对象与数组、抛出异常与 nothrow 的形式须全部替换，否则标准库
+//       （如 `std::stable_sort` 的临时缓冲区）用默认的 new 分配、却由这里
+//       的 delete 释放。代码中没有超过默认对齐的类型，对齐形式无需替换。
+#if defined(__GNUC__)
+#define CZC_CLI_NOINLINE __attribute__((noinline))
+#else
+#define CZC_CLI_NOINLINE
+#endif
+
+namespace {
+
+CZC_CLI_NOINLINE void* counted_malloc(std::size_t size) noexcept {
+  TimeReport::note_allocation();
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+CZC_CLI_NOINLINE void* counted_new(std::size_t size) {
+  if (void* ptr = counted_malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+} // namespace
+
+CZC_CLI_NOINLINE void* operator new(std::size_t size) {
+  return counted_new(size);
+}
+
+CZC_CLI_NOINLINE void* operator new[](std::size_t size) {
+  return counted_new(size);
+}
+
+CZC_CLI_NOINLINE void* operator new(std::size_t size,
+                                    const std::nothrow_t&) noexcept {
+  return counted_malloc(size);
+}
+
+CZC_CLI_NOINLINE void* operator new[](std::size_t size,
+                                      const std::nothrow_t&) noexcept {
+  return counted_malloc(size);
+}
+
+CZC_CLI_NOINLINE void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+CZC_CLI_NOINLINE void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+CZC_CLI_NOINLINE void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+CZC_CLI_NOINLINE void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+CZC_CLI_NOINLINE void operator delete(void* ptr,
+                                      const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+CZC_CLI_NOINLINE void operator delete[](void* ptr,
+                                        const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+#endif
+
+/**
+ * @brief `--time-report` 与 `--mem-report` 的输出形式。
+ */
+enum class ReportFormat { None, Table, Json };
+
+// 命令结束后打印的耗时报告形式。
+ReportFormat time_report_format = ReportFormat::None;
+
+// 命令结束后打印的内存报告形式。
+ReportFormat mem_report_format = ReportFormat::None;
+
+// `--trace-out` 指定的追踪文件路径，为空表示不追踪。
+std::string trace_out_path;
+
+// `--cache-dir` 指定的 CST 缓存，为空表示不使用。
+std::unique_ptr<czc::cst::CSTCache> cst_cache;
+
+// `--max-errors` 指定的每个文件的错误上限，为 0 表示不限制。
+size_t max_errors = 0;
+
+// `--fail-fast`：每个文件在第一个错误处停止，批量处理在第一个失败的文件后
+// 不再开始新的文件。
+bool fail_fast = false;
+
+/**
+ * @brief 每个文件的诊断引擎最多接受的错误数。
+ */
+size_t error_limit() {
+  if (fail_fast) {
+    return 1;
+  }
+  return max_errors != 0 ? max_errors : std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief 命令结束时按需把耗时报告打印到标准错误，并写出追踪文件。
+ * @param[in] exit_code 命令的退出码。
+ * @return 原样返回 `exit_code`；追踪文件无法写入时返回 1。
+ */
+int finish_command(int exit_code) {
+  if (!trace_out_path.empty()) {
+    std::ofstream trace(trace_out_path, std::ios::binary);
+    if (trace) {
+      TimeReport::write_trace(trace);
+    }
+    if (!trace) {
+      std::cerr << Color::Red << "Error:" << Color::Reset
+                << " Cannot write trace file '" << trace_out_path << "'"
+                << std::endl;
+      exit_code = 1;
+    }
+  }
+  if (time_report_format == ReportFormat::Json) {
+    std::cerr << TimeReport::to_json().dump() << std::endl;
+  } else if (time_report_format == ReportFormat::Table) {
+    std::cerr << "\nTime report:\n";
+    TimeReport::print_table(std::cerr);
+  }
+  if (mem_report_format == ReportFormat::Json) {
+    std::cerr << MemReport::to_json().dump() << std::endl;
+  } else if (mem_report_format == ReportFormat::Table) {
+    std::cerr << "\nMemory report:\n";
+    MemReport::print_table(std::cerr);
+  }
+  return exit_code;
+}
+
+/**
+ * @brief 打开 `--mem-report` 时记录一个文件的各数据结构的内存占用。
+ * @details 在所有结构仍然存活时调用；`tokens` 与 `cst` 可以为空，
+ *          流式解析时 Token 不会物化为序列，只存在于 CST 中。
+ */
+void record_memory(const SourceBuffer& source, const SourceTracker& tracker,
+                   const std::vector<Token>* tokens,
+                   const czc::cst::CSTNode* cst,
+                   const DiagnosticEngine& diagnostics) {
+  if (!MemReport::is_enabled()) {
+    return;
+  }
+  MemReport::add(MemCategory::Source, 1, source.size());
+
+  const std::vector<size_t>& lines = tracker.get_line_offsets();
+  MemReport::add(MemCategory::LineIndex, lines.size(),
+                 lines.capacity() * sizeof(size_t),
+                 (lines.capacity() - lines.size()) * sizeof(size_t));
+
+  if (tokens != nullptr) {
+    size_t text_bytes = 0;
+    for (const Token& token : *tokens) {
+      text_bytes += get_heap_bytes(token);
+    }
+    MemReport::add(MemCategory::Tokens, tokens->size(),
+                   tokens->capacity() * sizeof(Token),
+                   (tokens->capacity() - tokens->size()) * sizeof(Token));
+    MemReport::add(MemCategory::TokenText, tokens->size(), text_bytes);
+  }
+
+  if (cst != nullptr) {
+    auto stats = czc::cst::measure_memory(cst);
+    constexpr size_t CHILD_SIZE = sizeof(std::unique_ptr<czc::cst::CSTNode>);
+    MemReport::add(MemCategory::CSTNodes, stats.node_count, stats.node_bytes);
+    MemReport::add(
+        MemCategory::CSTChildren, stats.children_size,
+        stats.children_capacity * CHILD_SIZE,
+        (stats.children_capacity - stats.children_size) * CHILD_SIZE);
+    MemReport::add(MemCategory::CSTTokenText, stats.node_count,
+                   stats.token_text_bytes);
+  }
+
+  MemReport::add(MemCategory::Diagnostics, diagnostics.size(),
+                 diagnostics.get_memory_bytes());
+}
+
+// 当前线程的标准输出与标准错误。并行处理文件时指向该文件自己的缓冲区，
+// 处理完后再按输入顺序打印。
+thread_local std::ostream* current_out = &std::cout;
+thread_local std::ostream* current_err = &std::cerr;
+
 /**
  * @brief 打印错误消息（红色）。
  * @param[in] message 错误消息内容。
  */
 inline void print_error(const std::string& message) {
-  std::cerr << Color::Red << "Error:" << Color::Reset << " " << message
-            << std::endl;
+  *current_err << Color::Red << "Error:" << Color::Reset << " " << message
+               << std::endl;
 }
 
 /**
@@ -46,7 +265,7 @@ inline void print_error(const std::string& message) {
  * @param[in] message 成功消息内容。
  */
 inline void print_success(const std::string& message) {
-  std::cout << Color::Green << message << Color::Reset << std::endl;
+  *current_out << Color::Green << message << Color::Reset << std::endl;
 }
 
 /**
@@ -54,8 +273,8 @@ inline void print_success(const std::string& message) {
  * @param[in] message 警告消息内容。
  */
 inline void print_warning(const std::string& message) {
-  std::cout << Color::Yellow << "Warning:" << Color::Reset << " " << message
-            << std::endl;
+  *current_out << Color::Yellow << "Warning:" << Color::Reset << " "
+               << message << std::endl;
 }
 
 /**
@@ -63,7 +282,7 @@ inline void print_warning(const std::string& message) {
  * @param[in] message 信息消息内容。
  */
 inline void print_info(const std::string& message) {
-  std::cout << Color::Cyan << message << Color::Reset << std::endl;
+  *current_out << Color::Cyan << message << Color::Reset << std::endl;
 }
 
 /**
@@ -71,7 +290,7 @@ inline void print_info(const std::string& message) {
  * @param[in] text 要加粗的文本。
  */
 inline void print_bold(const std::string& text) {
-  std::cout << Color::Bold << text << Color::Reset;
+  *current_out << Color::Bold << text << Color::Reset;
 }
 
 /**
@@ -80,7 +299,7 @@ inline void print_bold(const std::string& text) {
  * @param[in] color 颜色代码。
  */
 inline void print_colored(const std::string& text, const std::string& color) {
-  std::cout << color << text << Color::Reset;
+  *current_out << color << text << Color::Reset;
 }
 
 /**
@@ -88,7 +307,9 @@ inline void print_colored(const std::string& text, const std::string& color) {
  * @param[in] title 标题文本。
  */
 inline void print_error_stage(const std::string& title) {
-  std::cerr << "\n" << Color::Red << title << Color::Reset << "\n" << std::endl;
+  *current_err << "\n"
+               << Color::Red << title << Color::Reset << "\n"
+               << std::endl;
 }
 
 /**
@@ -111,6 +332,51 @@ void print_usage(const std::string& program_name) {
   std::cout << "                            Available: en_US, zh_CN, ne_KO"
             << std::endl;
   std::cout << "  ";
+  print_colored("--jobs", Color::Green);
+  std::cout << ", ";
+  print_colored("-j", Color::Green);
+  std::cout << " <n>          Process up to <n> files in parallel "
+               "(default: CPU count)"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--file-index", Color::Green);
+  std::cout << " <file>       Cache directory listings used to expand "
+               "wildcards"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--no-ignore", Color::Green);
+  std::cout << "               Do not skip files excluded by .gitignore"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--time-report", Color::Green);
+  std::cout << "[=json]      Print per-phase times and counters to stderr"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--trace-out", Color::Green);
+  std::cout << " <file>        Write a Chrome trace (per file, phase and "
+               "thread)"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--mem-report", Color::Green);
+  std::cout << "[=json]       Print memory held by tokens, CST and "
+               "diagnostics to stderr"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--cache-dir", Color::Green);
+  std::cout << " <dir>         Reuse parsed trees of unchanged files (parse, "
+               "fmt)"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--max-errors", Color::Green);
+  std::cout << " <n>          Stop analyzing a file after <n> errors "
+               "(default: 0, no limit)"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--fail-fast", Color::Green);
+  std::cout << "               Stop at the first error and skip the "
+               "remaining files"
+            << std::endl;
+  std::cout << "  ";
   print_colored("--help", Color::Green);
   std::cout << ", ";
   print_colored("-h", Color::Green);
@@ -151,6 +417,27 @@ void print_usage(const std::string& program_name) {
   std::cout << "                            Use --in-place to modify files "
                "directly"
             << std::endl;
+  std::cout << "  ";
+  print_colored("index", Color::Yellow);
+  std::cout << " <input_file>...     Update the symbol index of top-level "
+               "declarations"
+            << std::endl;
+  std::cout << "                            Only changed files are scanned "
+               "again"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("stats", Color::Yellow);
+  std::cout << " <input_file>...     Print token and CST statistics as JSON"
+            << std::endl;
+  std::cout << "                            For tuning capacity estimates "
+               "and benchmark corpora"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("daemon", Color::Yellow);
+  std::cout << " [--socket <path>]  Serve JSON-RPC requests (one per line)"
+            << std::endl;
+  std::cout << "                            over stdio, or over a Unix socket"
+            << std::endl;
 
   std::cout << "\n";
   print_bold("Format Options:");
@@ -168,6 +455,32 @@ void print_usage(const std::string& program_name) {
   print_colored("--use-tabs", Color::Green);
   std::cout << "               Use tabs for indentation instead of spaces"
             << std::endl;
+  std::cout << "  ";
+  print_colored("--check", Color::Green);
+  std::cout << "                  Only check that files are formatted; "
+               "writes nothing"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--cache", Color::Green);
+  std::cout << " <file>           Skip files recorded as formatted in <file>"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--fsync", Color::Green);
+  std::cout << "                  Flush written files to disk before replacing"
+            << std::endl;
+
+  std::cout << "\n";
+  print_bold("Index Options:");
+  std::cout << std::endl;
+  std::cout << "  ";
+  print_colored("--index", Color::Green);
+  std::cout << " <file>           Index file to update or query "
+               "(default: .czc-index)"
+            << std::endl;
+  std::cout << "  ";
+  print_colored("--query", Color::Green);
+  std::cout << " <name>           Print the symbols named <name>"
+            << std::endl;
 
   std::cout << "\n";
   print_bold("Examples:");
@@ -182,166 +495,300 @@ void print_usage(const std::string& program_name) {
   std::cout << "  " << program_name << " tokenize file1.zero file2.zero"
             << std::endl;
   std::cout << "  " << program_name << " fmt test_*.zero" << std::endl;
+  std::cout << "  " << program_name << " -j 8 parse src/*.zero" << std::endl;
+  std::cout << "  " << program_name
+            << " fmt --check --cache .czc-cache src/*.zero" << std::endl;
+  std::cout << "  " << program_name << " index src/*.zero && " << program_name
+            << " index --query main" << std::endl;
+  std::cout << "  " << program_name << " stats src/*.zero > stats.json"
+            << std::endl;
 }
 
 /**
- * @brief 对单个文件执行格式化并输出结果。
- * @details
- *   此函数执行完整的格式化流程：
- *   1. **文件读取与验证**: 确保文件存在且可读。
- *   2. **词法分析**: 将源码转换为 Token 序列。
- *   3. **Token 预处理**: 处理科学计数法等特殊 Token。
- *   4. **语法分析**: 构建 CST。
- *   5. **代码格式化**: 使用 Formatter 格式化 CST。
- *   6. **结果输出**: 将格式化后的代码写入文件或输出到控制台。
- *
+ * @brief 校验并打开一个输入文件，失败时打印原因。
+ * @details 较大的文件以内存映射的方式读取，Lexer 与 SourceTracker 直接借用
+ *          这块内存，整个流程不再复制源码。
  * @param[in] input_path 输入文件的路径。
- * @param[in] locale     用于诊断消息的语言环境代码。
- * @param[in] options    格式化选项。
- * @param[in] in_place   是否就地修改文件（默认为 false）。
- * @return 如果格式化成功返回 `true`，否则返回 `false`。
+ * @return 成功时返回源码缓冲区，否则返回空。
  */
-bool format_file(const std::string& input_path, const std::string& locale,
-                 const FormatOptions& options, bool in_place = false) {
-  // --- 1. 文件校验和读取 ---
+std::optional<SourceBuffer> open_source_file(const std::string& input_path) {
   if (input_path.empty()) {
     print_error("Input file path is empty");
-    return false;
+    return std::nullopt;
   }
   if (!std::filesystem::exists(input_path)) {
     print_error("File '" + input_path + "' does not exist");
-    return false;
+    return std::nullopt;
   }
   if (!std::filesystem::is_regular_file(input_path)) {
     print_error("'" + input_path + "' is not a regular file");
-    return false;
+    return std::nullopt;
   }
-
-  std::ifstream input_file(input_path);
-  if (!input_file.is_open()) {
+  std::optional<SourceBuffer> source = SourceBuffer::open(input_path);
+  if (!source) {
     print_error("Cannot open file '" + input_path + "'");
-    return false;
   }
+  return source;
+}
 
-  std::stringstream buffer;
-  buffer << input_file.rdbuf();
-  std::string content = buffer.str();
-  input_file.close();
-
-  std::cout << "Formatting file: " << input_path << std::endl;
-
-  DiagnosticEngine diagnostics(locale);
-  SourceTracker source_tracker(content, input_path);
-
-  // --- 2. 词法分析 ---
-  Lexer lexer(content, input_path);
-  auto tokens = lexer.tokenize();
+/**
+ * @brief 处理完一个文件的结果，以及留给写出阶段的输出。
+ * @details 默认构造的值表示处理失败。
+ */
+struct FileWork {
+  // 处理是否成功；失败时不执行 `write`
+  bool success = false;
+  // 写入输出文件并打印结果，成功时返回 `true`；为空表示没有要写入的文件。
+  // NOTE: 执行前文件的源码缓冲区已经释放，`write` 不能再引用其内容。
+  std::function<bool()> write;
+};
+
+// 处理一个已读入的文件：路径与源码 -> 结果。
+using FileProcessor =
+    std::function<FileWork(const std::string&, const SourceBuffer&)>;
 
-  // --- 3. 报告词法分析错误 ---
-  if (lexer.get_errors().has_errors()) {
-    for (const auto& error : lexer.get_errors().get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
+/**
+ * @brief 一个线程依次处理各文件时复用的对象。
+ * @details
+ *   诊断引擎的记录池与已加载的消息、格式化器的缓冲区都在文件之间保留，
+ *   这些预热的分配每个线程只发生一次；CST 的内存块则由 `Arena` 的线程
+ *   块缓存复用。每个线程各有一份，不需要任何同步。
+ */
+struct WorkerContext {
+  std::optional<DiagnosticEngine> diagnostics;
+  std::optional<Formatter> formatter;
+
+  /**
+   * @brief 获取一个清空了的诊断引擎。
+   */
+  DiagnosticEngine& get_diagnostics(const std::string& locale) {
+    if (!diagnostics) {
+      diagnostics.emplace(locale);
+    } else {
+      diagnostics->clear();
+      diagnostics->set_locale(locale);
     }
+    // NOTE: 各阶段都写入这个引擎，达到上限后由它通知各阶段提前停止。
+    diagnostics->set_error_limit(error_limit());
+    return *diagnostics;
   }
 
-  if (diagnostics.has_errors()) {
-    print_error_stage("Errors found during lexical analysis:");
-    diagnostics.print_all(true);
-    return false;
+  /**
+   * @brief 获取一个使用 `options` 的格式化器。
+   */
+  Formatter& get_formatter(const FormatOptions& options) {
+    if (!formatter || formatter->get_options() != options) {
+      formatter.emplace(options);
+    }
+    return *formatter;
   }
+};
 
-  // --- 4. Token 预处理 ---
-  TokenPreprocessor preprocessor;
-  auto processed_tokens = preprocessor.process(tokens, input_path, content);
+thread_local WorkerContext worker_context;
 
-  // --- 5. 报告 Token 预处理错误 ---
-  if (preprocessor.get_errors().has_errors()) {
-    for (const auto& error : preprocessor.get_errors().get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
+/**
+ * @brief 对一个文件执行词法分析、Token 预处理与语法分析，并报告各阶段的错误。
+ * @details
+ *   设置了 `--cache-dir` 时先按内容查找缓存的 CST，命中则跳过全部三个阶段；
+ *   未命中且没有任何错误时，把解析结果写入缓存供下次使用。
+ *
+ *   各阶段的错误在返回前就已打印。成功返回后 `diagnostics` 不再引用任何
+ *   行索引，调用方若还要报告错误，需要自行设置。
+ * @param[in] source      源码缓冲区。
+ * @param[in] input_path  输入文件的路径。
+ * @param[in] diagnostics 收集各阶段错误的诊断引擎。
+ * @return 成功时返回 CST；任一阶段出错时返回空。
+ */
+std::unique_ptr<czc::cst::CSTNode> parse_source(const SourceBuffer& source,
+                                                const std::string& input_path,
+                                                DiagnosticEngine& diagnostics) {
+  if (cst_cache != nullptr) {
+    FileId file_id = SourceManager::instance().add_file(input_path);
+    if (auto cached = cst_cache->load(source.view(), file_id)) {
+      return cached;
     }
   }
 
-  if (diagnostics.has_errors()) {
-    print_error_stage("Errors found during token preprocessing:");
-    diagnostics.print_all(true);
-    return false;
+  // NOTE: 三个阶段通过拉取式的 PreprocessedTokenSource 串联：Parser 每需要
+  //       一个 Token，就驱动 Lexer 产生一个并内联完成科学计数法预处理，
+  //       整个过程不会物化完整的 Token 序列。各阶段的错误仍按原先的顺序报告。
+  // NOTE: 各阶段的错误收集器都直接写入同一个 `diagnostics`，错误在产生时
+  //       就记录为紧凑的诊断，不再先存为各阶段的错误对象、再逐条转换。
+  //       各阶段的收集器仍各自计数，用于按阶段决定是否中止。
+  auto token_source =
+      std::make_unique<PreprocessedTokenSource>(source, input_path);
+  token_source->set_error_reporter(&diagnostics);
+  const PreprocessedTokenSource& stream = *token_source;
+  // 诊断直接复用 Lexer 在分析过程中建立的行索引，无需再次扫描源码。
+  const SourceTracker& source_tracker = stream.get_source_tracker();
+  diagnostics.set_source(&source_tracker);
+  Parser parser(std::move(token_source), input_path);
+  parser.set_error_reporter(&diagnostics);
+  // CST 随调用方的处理结束而整体丢弃，直接在 Arena 中分配。
+  parser.set_arena_enabled(true);
+  auto cst = parser.parse();
+  record_memory(source, source_tracker, nullptr, cst.get(), diagnostics);
+
+  // --- 报告词法分析错误 ---
+  if (stream.get_lexer_errors().has_errors()) {
+    print_error_stage("Errors found during lexical analysis:");
+    diagnostics.print_all(*current_err, true, "L");
+    return nullptr;
   }
 
-  // --- 6. 语法分析 ---
-  Parser parser(processed_tokens, input_path);
-  auto cst = parser.parse();
+  // --- 报告 Token 预处理错误 ---
+  if (stream.get_preprocessor_errors().has_errors()) {
+    print_error_stage("Errors found during token preprocessing:");
+    diagnostics.print_all(*current_err, true, "T");
+    return nullptr;
+  }
 
-  // --- 7. 报告语法分析错误 ---
+  // --- 报告语法分析错误 ---
   if (parser.has_errors()) {
-    for (const auto& error : parser.get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
-    }
+    print_error_stage("Errors found during parsing:");
+    diagnostics.print_all(*current_err, true, "PS");
+    return nullptr;
   }
 
-  if (diagnostics.has_errors()) {
-    print_error_stage("Errors found during parsing:");
-    diagnostics.print_all(true);
-    return false;
+  diagnostics.set_source(nullptr);
+  if (cst_cache != nullptr && !cst_cache->store(source.view(), cst.get())) {
+    print_warning("Cannot write cache entry for '" + input_path + "'");
   }
+  return cst;
+}
 
-  // --- 8. 格式化 ---
-  Formatter formatter(options);
-  std::string formatted_code = formatter.format(cst.get());
+/**
+ * @brief fmt 命令的运行方式。
+ */
+struct FmtMode {
+  // 是否就地修改文件
+  bool in_place = false;
+  // 只检查文件是否已经格式化，不写入任何文件
+  bool check = false;
+  // 已格式化内容的缓存，为空时不使用
+  FormatCache* cache = nullptr;
+  // 各文件共用的顶层声明格式化结果，为空时不使用
+  FormatMemo* memo = nullptr;
+  // 写入的文件在重命名前是否先刷到磁盘
+  bool sync = false;
+};
 
-  // --- 9. 报告格式化错误 ---
-  if (formatter.get_error_collector().has_errors()) {
-    for (const auto& error : formatter.get_error_collector().get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
+/**
+ * @brief 对单个文件执行格式化并输出结果。
+ * @details
+ *   此函数执行完整的格式化流程：
+ *   1. **词法分析**: 将源码转换为 Token 序列。
+ *   2. **Token 预处理**: 处理科学计数法等特殊 Token。
+ *   3. **语法分析**: 构建 CST。
+ *   4. **代码格式化**: 使用 Formatter 格式化 CST。
+ *   5. **结果输出**: 返回的 `FileWork::write` 把格式化后的代码写入文件。
+ *
+ *   内容命中缓存的文件已知是格式化后的样子，直接跳过第 1 至 4 步；
+ *   `--cache-dir` 中存有解析结果的文件跳过第 1 至 3 步。
+ *   检查模式下只比较格式化结果与原文，发现差异即停止，不写入任何文件。
+ *
+ * @param[in] input_path 输入文件的路径。
+ * @param[in] source     输入文件的内容（见 `open_source_file`）。
+ * @param[in] locale     用于诊断消息的语言环境代码。
+ * @param[in] options    格式化选项。
+ * @param[in] mode       运行方式（就地修改、检查模式与缓存）。
+ * @return 格式化成功（检查模式下为文件已格式化）时 `success` 为 `true`。
+ */
+FileWork format_file(const std::string& input_path, const SourceBuffer& source,
+                     const std::string& locale, const FormatOptions& options,
+                     const FmtMode& mode) {
+  std::string_view content = source.view();
+
+  *current_out << (mode.check ? "Checking file: " : "Formatting file: ")
+               << input_path << std::endl;
+
+  // --- 缓存命中：内容已经是格式化后的样子 ---
+  if (mode.cache != nullptr && mode.cache->contains(content)) {
+    if (mode.check || mode.in_place) {
+      print_success("Already formatted (cached)");
+      return {true, nullptr};
     }
+    std::string output_path = input_path + ".formatted";
+    return {true, [output_path, code = std::string(content), &mode]() {
+              if (!write_file_atomic(output_path, code, mode.sync)) {
+                print_error("Cannot create output file '" + output_path + "'");
+                return false;
+              }
+              print_success("Already formatted (cached)");
+              return true;
+            }};
   }
 
-  if (diagnostics.has_errors()) {
-    print_error_stage("Errors found during formatting:");
-    diagnostics.print_all(true);
-    return false;
-  }
+  DiagnosticEngine& diagnostics = worker_context.get_diagnostics(locale);
 
-  // --- 10. 输出结果 ---
-  std::string output_path;
-  if (in_place) {
-    output_path = input_path;
+  // --- 1. 词法分析、Token 预处理与语法分析（命中 `--cache-dir` 时跳过） ---
+  auto cst = parse_source(source, input_path, diagnostics);
+  if (!cst) {
+    return {};
+  }
+  // 格式化阶段的诊断引用的行索引按需建立，只在报告错误时扫描源码。
+  SourceTracker source_tracker(source, input_path);
+  diagnostics.set_source(&source_tracker);
+
+  // --- 2. 格式化 ---
+  Formatter& formatter = worker_context.get_formatter(options);
+  formatter.get_error_collector().set_reporter(&diagnostics);
+  formatter.set_memo(mode.memo, content);
+  std::string formatted_code;
+  bool already_formatted = false;
+  if (mode.check) {
+    already_formatted = formatter.is_formatted(cst.get(), content);
   } else {
-    output_path = input_path + ".formatted";
+    formatted_code = formatter.format(cst.get());
+    already_formatted = formatted_code == content;
   }
 
-  std::ofstream output_file(output_path, std::ios::binary);
-  if (!output_file.is_open()) {
-    print_error("Cannot create output file '" + output_path + "'");
-    return false;
+  // --- 3. 报告格式化错误 ---
+  if (formatter.get_error_collector().has_errors()) {
+    print_error_stage("Errors found during formatting:");
+    diagnostics.print_all(*current_err, true);
+    return {};
   }
 
-  output_file << formatted_code;
-  output_file.close();
+  if (already_formatted && mode.cache != nullptr) {
+    mode.cache->insert(content);
+  }
+  if (mode.check) {
+    if (!already_formatted) {
+      print_error("'" + input_path + "' is not formatted");
+      return {};
+    }
+    print_success("Already formatted");
+    return {true, nullptr};
+  }
 
-  if (in_place) {
-    print_success("Successfully formatted in-place");
-  } else {
-    print_success("Successfully formatted");
-    std::cout << "Output saved to: " << output_path << std::endl;
+  // --- 4. 输出结果 ---
+  // NOTE: 就地修改时，已经格式化的文件不再重写。
+  if (mode.in_place && already_formatted) {
+    print_success("Already formatted");
+    return {true, nullptr};
   }
 
-  return true;
+  // NOTE: 先整体写入临时文件再重命名，中途失败或被中断时原文件保持完整。
+  //       写出时源码已经释放，Windows 上也能替换原先映射着的文件。
+  std::string output_path =
+      mode.in_place ? input_path : input_path + ".formatted";
+  return {true, [output_path, code = std::move(formatted_code), &mode]() {
+            if (!write_file_atomic(output_path, code, mode.sync)) {
+              print_error("Cannot create output file '" + output_path + "'");
+              return false;
+            }
+            if (mode.cache != nullptr) {
+              mode.cache->insert(code);
+            }
+            if (mode.in_place) {
+              print_success("Successfully formatted in-place");
+            } else {
+              print_success("Successfully formatted");
+              *current_out << "Output saved to: " << output_path << std::endl;
+            }
+            return true;
+          }};
 }
 
 /**
@@ -394,248 +841,526 @@ static std::string escape_for_output(const std::string& s) {
  * @brief 对单个文件执行完整的词法分析前端流水线。
  * @details
  *   此函数封装了从读取文件到生成最终 Token 列表的完整流程，包括：
- *   1.  **文件读取与验证**: 确保文件存在且可读。
- *   2.  **词法分析**: 调用 `Lexer` 将源码转换为原始 Token 序列。
- *   3.  **错误处理**: 收集并报告词法分析阶段的错误。
- *   4.  **Token 预处理**: 调用 `TokenPreprocessor`
- * 对科学计数法等进行类型推断和转换。
- *   5.  **错误处理**: 收集并报告预处理阶段的错误。
- *   6.  **结果输出**: 将处理完成的 Token 序列写入 `.tokens` 文件。
+ *   1.  **词法分析与 Token 预处理**: 调用 `Lexer` 将源码转换为 Token 序列，
+ *       科学计数法字面量在扫描时即交给 `TokenPreprocessor` 完成类型推断。
+ *   2.  **错误处理**: 收集并报告词法分析阶段的错误。
+ *   3.  **错误处理**: 收集并报告预处理阶段的错误。
+ *   4.  **结果输出**: 把 Token 序列渲染为文本，由返回的 `FileWork::write`
+ *       写入 `.tokens` 文件。
  *   任何阶段的失败都会导致整个流程中止并返回 `false`。
  *
  * @param[in] input_path 输入文件的路径（第一个参数是文件路径）。
- * @param[in] locale     用于诊断消息的语言环境代码（第二个参数是语言环境）。
+ * @param[in] source     输入文件的内容（见 `open_source_file`）。
+ * @param[in] locale     用于诊断消息的语言环境代码（最后一个参数是语言环境）。
  *
  * @warning 参数顺序很重要：先文件路径，后语言环境。不要混淆这两个参数。
  *
- * @return 如果所有阶段都成功，返回 `true`，否则返回 `false`。
+ * @return 所有阶段都成功时 `success` 为 `true`。
  */
-bool tokenize_file(const std::string& input_path, const std::string& locale) {
-  // --- 1. 文件校验和读取 ---
-  if (input_path.empty()) {
-    print_error("Input file path is empty");
-    return false;
-  }
-  if (!std::filesystem::exists(input_path)) {
-    print_error("File '" + input_path + "' does not exist");
-    return false;
-  }
-  if (!std::filesystem::is_regular_file(input_path)) {
-    print_error("'" + input_path + "' is not a regular file");
-    return false;
-  }
-
-  std::ifstream input_file(input_path);
-  if (!input_file.is_open()) {
-    print_error("Cannot open file '" + input_path + "'");
-    return false;
-  }
-
-  std::stringstream buffer;
-  buffer << input_file.rdbuf();
-  std::string content = buffer.str();
-  input_file.close();
+FileWork tokenize_file(const std::string& input_path,
+                       const SourceBuffer& source, const std::string& locale) {
+  std::string_view content = source.view();
 
-  std::cout << "Tokenizing file: " << input_path << std::endl;
+  *current_out << "Tokenizing file: " << input_path << std::endl;
 
-  DiagnosticEngine diagnostics(locale);
-  SourceTracker source_tracker(content, input_path);
+  DiagnosticEngine& diagnostics = worker_context.get_diagnostics(locale);
 
-  // --- 2. 词法分析 ---
-  Lexer lexer(content, input_path);
-  auto tokens = lexer.tokenize();
-
-  // --- 3. 报告词法分析错误 ---
+  // --- 1. 词法分析与 Token 预处理 ---
+  // NOTE: 分类器让 Lexer 在 `read_number()` 中直接完成科学计数法的类型推断，
+  //       省去对整个 Token 序列的第二趟遍历。两个阶段的错误都直接写入
+  //       `diagnostics`，各自的收集器只计数，仍然与词法错误分开报告。
+  TokenPreprocessor preprocessor;
+  ScientificTokenClassifier classifier(preprocessor, input_path, content);
+  preprocessor.set_error_reporter(&diagnostics);
+  Lexer lexer(source, input_path);
+  lexer.set_scientific_classifier(&classifier);
+  lexer.set_error_reporter(&diagnostics);
+  auto processed_tokens = lexer.tokenize();
+  // 诊断直接复用 Lexer 在分析过程中建立的行索引，无需再次扫描源码。
+  const SourceTracker& source_tracker = lexer.get_source_tracker();
+  diagnostics.set_source(&source_tracker);
+  record_memory(source, source_tracker, &processed_tokens, nullptr,
+                diagnostics);
+
+  // --- 2. 报告词法分析错误 ---
+  // NOTE: 词法分析器本身只报告错误信息，但不知道如何显示它们。
+  //       错误已由 `DiagnosticEngine` 记录为紧凑的诊断，这里只打印属于
+  //       词法分析（L 前缀）的部分，源码行与本地化的消息文本此时才生成。
+  //       这种分层设计使得错误收集和错误报告的逻辑相互分离。
   if (lexer.get_errors().has_errors()) {
-    // NOTE:
-    // 词法分析器本身只收集错误信息（`LexerError`），但不知道如何显示它们。
-    //       这里的代码负责将每个 `LexerError` 转换为一个通用的 `Diagnostic`
-    //       对象， 并使用 `SourceTracker` 提取错误所在行的源码上下文，
-    //       最后将这个完整的诊断对象交给 `DiagnosticEngine`
-    //       进行统一处理和报告。
-    //       这种分层设计使得错误收集和错误报告的逻辑相互分离。
-    for (const auto& error : lexer.get_errors().get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
-    }
-  }
-
-  if (diagnostics.has_errors()) {
     print_error_stage("Errors found during lexical analysis:");
-    diagnostics.print_all(true);
-    return false;
+    diagnostics.print_all(*current_err, true, "L");
+    return {};
   }
 
-  // --- 4. Token 预处理 ---
-  TokenPreprocessor preprocessor;
-  auto processed_tokens = preprocessor.process(tokens, input_path, content);
-
-  // --- 5. 报告 Token 预处理错误 ---
+  // --- 3. 报告 Token 预处理错误 ---
   if (preprocessor.get_errors().has_errors()) {
-    for (const auto& error : preprocessor.get_errors().get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
-    }
-  }
-
-  if (diagnostics.has_errors()) {
     print_error_stage("Errors found during token preprocessing:");
-    diagnostics.print_all(true);
-    return false;
-  }
-
-  // --- 6. 将结果写入输出文件 ---
-  std::string output_path = input_path + ".tokens";
-  std::ofstream output_file(output_path, std::ios::binary);
-  if (!output_file.is_open()) {
-    print_error("Cannot create output file '" + output_path + "'");
-    return false;
+    diagnostics.print_all(*current_err, true, "T");
+    return {};
   }
 
-  output_file << "# Tokenization Result\n";
-  output_file << "# Source: " << input_path << "\n";
-  output_file << "# Total tokens: " << processed_tokens.size() << "\n";
-  output_file << "# Format: Index\tLine:Column\tType\tValue\n\n";
+  // --- 4. 将结果写入输出文件 ---
+  std::ostringstream output;
+  output << "# Tokenization Result\n";
+  output << "# Source: " << input_path << "\n";
+  output << "# Total tokens: " << processed_tokens.size() << "\n";
+  output << "# Format: Index\tLine:Column\tType\tValue\n\n";
 
   for (size_t i = 0; i < processed_tokens.size(); i++) {
-    output_file << i << "\t" << processed_tokens[i].line << ":"
-                << processed_tokens[i].column << "\t"
-                << token_type_to_string(processed_tokens[i].token_type) << "\t"
-                << "\"" << escape_for_output(processed_tokens[i].value)
-                << "\"\n";
+    output << i << "\t" << processed_tokens[i].line << ":"
+           << processed_tokens[i].column << "\t"
+           << token_type_to_string(processed_tokens[i].token_type) << "\t"
+           << "\"" << escape_for_output(processed_tokens[i].value) << "\"\n";
   }
 
-  output_file.close();
-
-  print_success("Successfully tokenized " +
-                std::to_string(processed_tokens.size()) + " tokens");
-  std::cout << "Output saved to: " << output_path << std::endl;
-
-  return true;
+  std::string output_path = input_path + ".tokens";
+  return {true, [output_path, text = output.str(),
+                 count = processed_tokens.size()]() {
+            std::ofstream output_file(output_path, std::ios::binary);
+            if (!output_file.is_open()) {
+              print_error("Cannot create output file '" + output_path + "'");
+              return false;
+            }
+            output_file << text;
+            output_file.close();
+
+            print_success("Successfully tokenized " + std::to_string(count) +
+                          " tokens");
+            *current_out << "Output saved to: " << output_path << std::endl;
+            return true;
+          }};
 }
 
 /**
  * @brief 对单个文件执行完整的解析流程并报告错误。
  * @details
  *   此函数执行完整的编译前端流程：
- *   1. **文件读取与验证**: 确保文件存在且可读。
- *   2. **词法分析**: 将源码转换为 Token 序列。
- *   3. **Token 预处理**: 处理科学计数法等特殊 Token。
- *   4. **语法分析**: 构建 CST 并检查语法错误。
- *   5. **错误报告**: 统一报告所有阶段的错误。
+ *   1. **词法分析**: 将源码转换为 Token 序列。
+ *   2. **Token 预处理**: 处理科学计数法等特殊 Token。
+ *   3. **语法分析**: 构建 CST 并检查语法错误。
+ *   4. **错误报告**: 统一报告所有阶段的错误。
  *
  *   与 tokenize_file 不同，此函数不生成任何输出文件，
  *   只进行解析并报告发现的所有错误。
  *
  * @param[in] input_path 输入文件的路径。
+ * @param[in] source     输入文件的内容（见 `open_source_file`）。
  * @param[in] locale     用于诊断消息的语言环境代码。
- * @return 如果没有错误返回 `true`，否则返回 `false`。
+ * @return 没有错误时 `success` 为 `true`。
  */
-bool parse_file(const std::string& input_path, const std::string& locale) {
-  // --- 1. 文件校验和读取 ---
-  if (input_path.empty()) {
-    print_error("Input file path is empty");
-    return false;
-  }
-  if (!std::filesystem::exists(input_path)) {
-    print_error("File '" + input_path + "' does not exist");
-    return false;
-  }
-  if (!std::filesystem::is_regular_file(input_path)) {
-    print_error("'" + input_path + "' is not a regular file");
-    return false;
-  }
+FileWork parse_file(const std::string& input_path, const SourceBuffer& source,
+                    const std::string& locale) {
+  *current_out << "Parsing file: " << input_path << std::endl;
 
-  std::ifstream input_file(input_path);
-  if (!input_file.is_open()) {
-    print_error("Cannot open file '" + input_path + "'");
-    return false;
+  DiagnosticEngine& diagnostics = worker_context.get_diagnostics(locale);
+
+  // --- 1. 词法分析、Token 预处理与语法分析（命中 `--cache-dir` 时跳过） ---
+  if (!parse_source(source, input_path, diagnostics)) {
+    return {};
   }
 
-  std::stringstream buffer;
-  buffer << input_file.rdbuf();
-  std::string content = buffer.str();
-  input_file.close();
+  // --- 2. 成功 ---
+  print_success("Successfully parsed with no errors");
+  return {true, nullptr};
+}
 
-  std::cout << "Parsing file: " << input_path << std::endl;
+/**
+ * @brief 对一批文件执行同一个处理函数，并打印总结信息。
+ * @details
+ *   多于一个文件时按流水线处理，相邻阶段之间由有界队列连接：
+ *   1. **读取**：一个线程依次打开并预读文件（见 `SourceBuffer::prefetch`），
+ *      网络文件系统上读取的等待都由它承担；
+ *   2. **处理**：`jobs` 个线程对读入的文件执行 `process`，随后释放源码；
+ *   3. **写出**：一个线程依次执行各文件的 `FileWork::write`。
+ *   读写因此与分析重叠进行，队列的容量限制了读入而尚未处理的文件数。
+ *
+ *   文件按大小从大到小读取，耗时最长的文件最先开始，避免最后只剩一个大
+ *   文件在跑。每个文件在各阶段的输出都写入它自己的缓冲区，主线程再按输入
+ *   顺序依次打印，因此输出与串行执行一致。
+ *
+ *   `--fail-fast` 时，第一个文件失败后不再开始新的文件：已在处理中的文件
+ *   照常完成，其余的文件跳过，在总结中单独计数。
+ * @param[in] files   要处理的文件列表。
+ * @param[in] jobs    并行处理的文件数。
+ * @param[in] process 处理单个已读入文件的函数。
+ * @return 程序退出码 (0 表示全部成功, 1 表示存在失败)。
+ */
+int run_batch(const std::vector<std::string>& files, size_t jobs,
+              const FileProcessor& process) {
+  size_t total_files = files.size();
+  size_t success_count = 0;
+  size_t failed_count = 0;
+  size_t skipped_count = 0;
+  // `--fail-fast` 时，是否已有文件失败
+  std::atomic<bool> stop{false};
+
+  // 单个文件的处理结果与缓冲的输出。
+  struct FileResult {
+    std::ostringstream out;
+    std::ostringstream err;
+    bool success = false;
+    // `--fail-fast` 时因之前的文件失败而没有处理
+    bool skipped = false;
+    // 最后一个阶段完成时兑现；阶段中抛出的异常经由它交给主线程
+    std::promise<void> done;
+  };
+  // 在阶段之间传递的文件：读取阶段之后带有源码，处理阶段之后带有写出工作。
+  struct Job {
+    size_t index = 0;
+    std::optional<SourceBuffer> source;
+    FileWork work;
+  };
+  // 把当前线程的输出指向一个文件的缓冲区，离开作用域时恢复。
+  struct RedirectOutput {
+    explicit RedirectOutput(FileResult& result) {
+      current_out = &result.out;
+      current_err = &result.err;
+    }
+    ~RedirectOutput() {
+      current_out = &std::cout;
+      current_err = &std::cerr;
+    }
+  };
+
+  jobs = std::max<size_t>(1, std::min(jobs, total_files));
+  std::vector<FileResult> results;
+  std::vector<std::future<void>> pending;
+  // NOTE: 每个阶段最多积压两倍于处理线程数的文件，足以掩盖读写的延迟，
+  //       同时读入而尚未处理的源码所占的内存有上限。
+  BoundedQueue<Job> loaded(jobs * 2);
+  BoundedQueue<Job> processed(jobs * 2);
+  // 在某个阶段结束一个文件：成功完成或把异常交给主线程。
+  auto finish = [&results, &stop](size_t i, std::exception_ptr error) {
+    if (fail_fast && (error || !results[i].success)) {
+      stop.store(true, std::memory_order_relaxed);
+    }
+    if (error) {
+      results[i].done.set_exception(error);
+    } else {
+      results[i].done.set_value();
+    }
+  };
+  // `--fail-fast` 时跳过尚未开始的文件。
+  auto skip = [&](size_t i) {
+    if (!stop.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    results[i].skipped = true;
+    results[i].done.set_value();
+    return true;
+  };
+  // NOTE: 线程池最后声明、最先析构，各阶段的线程退出后队列才销毁。
+  std::unique_ptr<ThreadPool> pool;
+  if (total_files > 1) {
+    results = std::vector<FileResult>(total_files);
+    pending.resize(total_files);
+    // 读取与写出各占一个线程，其余线程处理文件。
+    pool = std::make_unique<ThreadPool>(jobs + 2);
+
+    std::vector<std::pair<uintmax_t, size_t>> by_size;
+    for (size_t i = 0; i < total_files; i++) {
+      std::error_code ec;
+      uintmax_t size = std::filesystem::file_size(files[i], ec);
+      by_size.emplace_back(ec ? 0 : size, i);
+    }
+    std::stable_sort(by_size.begin(), by_size.end(),
+                     [](const auto& a, const auto& b) {
+                       return a.first > b.first;
+                     });
+    for (size_t i = 0; i < total_files; i++) {
+      pending[i] = results[i].done.get_future();
+    }
 
-  DiagnosticEngine diagnostics(locale);
-  SourceTracker source_tracker(content, input_path);
+    // --- 1. 读取 ---
+    pool->submit([&, by_size = std::move(by_size)]() {
+      for (const auto& [size, i] : by_size) {
+        if (skip(i)) {
+          continue;
+        }
+        Job job;
+        job.index = i;
+        try {
+          RedirectOutput redirect(results[i]);
+          ScopedTraceSpan span("read", "file", files[i]);
+          job.source = open_source_file(files[i]);
+          if (job.source) {
+            job.source->prefetch();
+          }
+        } catch (...) {
+          finish(i, std::current_exception());
+          continue;
+        }
+        if (!job.source) {
+          finish(i, nullptr);
+          continue;
+        }
+        loaded.push(std::move(job));
+      }
+      loaded.close();
+    });
+
+    // --- 2. 处理 ---
+    auto workers = std::make_shared<std::atomic<size_t>>(jobs);
+    for (size_t worker = 0; worker < jobs; worker++) {
+      pool->submit([&, workers]() {
+        while (std::optional<Job> job = loaded.pop()) {
+          size_t i = job->index;
+          if (skip(i)) {
+            continue;
+          }
+          try {
+            RedirectOutput redirect(results[i]);
+            ScopedTraceSpan span("file", "file", files[i]);
+            job->work = process(files[i], *job->source);
+            results[i].success = job->work.success;
+          } catch (...) {
+            finish(i, std::current_exception());
+            continue;
+          }
+          // 写出阶段不再需要源码，尽早释放映射与内存。
+          job->source.reset();
+          if (job->work.success && job->work.write) {
+            processed.push(std::move(*job));
+          } else {
+            finish(i, nullptr);
+          }
+        }
+        // 最后一个处理线程退出时，写出阶段不会再有新的文件。
+        if (workers->fetch_sub(1) == 1) {
+          processed.close();
+        }
+      });
+    }
 
-  // --- 2. 词法分析 ---
-  Lexer lexer(content, input_path);
-  auto tokens = lexer.tokenize();
+    // --- 3. 写出 ---
+    pool->submit([&]() {
+      while (std::optional<Job> job = processed.pop()) {
+        size_t i = job->index;
+        try {
+          RedirectOutput redirect(results[i]);
+          ScopedTraceSpan span("write", "file", files[i]);
+          results[i].success = job->work.write();
+        } catch (...) {
+          finish(i, std::current_exception());
+          continue;
+        }
+        finish(i, nullptr);
+      }
+    });
+  }
 
-  // --- 3. 报告词法分析错误 ---
-  if (lexer.get_errors().has_errors()) {
-    for (const auto& error : lexer.get_errors().get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
+  for (size_t i = 0; i < total_files; i++) {
+    if (pool) {
+      pending[i].get();
+      if (results[i].skipped) {
+        skipped_count++;
+        continue;
+      }
+    } else if (fail_fast && failed_count > 0) {
+      skipped_count++;
+      continue;
+    }
+    if (total_files > 1) {
+      std::cout << "[" << (i + 1) << "/" << total_files << "] ";
+    }
+    bool success = false;
+    if (pool) {
+      std::cout << results[i].out.str() << std::flush;
+      std::cerr << results[i].err.str() << std::flush;
+      success = results[i].success;
+    } else {
+      ScopedTraceSpan span("file", "file", files[i]);
+      if (std::optional<SourceBuffer> source = open_source_file(files[i])) {
+        FileWork work = process(files[i], *source);
+        source.reset();
+        success = work.success && (!work.write || work.write());
+      }
+    }
+    if (success) {
+      success_count++;
+    } else {
+      failed_count++;
+    }
+    if (i < total_files - 1) {
+      std::cout << std::endl;
     }
   }
 
-  if (diagnostics.has_errors()) {
-    print_error_stage("Errors found during lexical analysis:");
-    diagnostics.print_all(true);
-    return false;
+  // --- 打印总结信息 ---
+  if (total_files > 1) {
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "Summary: " << success_count << " succeeded, "
+              << failed_count << " failed";
+    if (skipped_count > 0) {
+      std::cout << ", " << skipped_count << " skipped";
+    }
+    std::cout << std::endl;
+    std::cout << "========================================" << std::endl;
   }
 
-  // --- 4. Token 预处理 ---
-  TokenPreprocessor preprocessor;
-  auto processed_tokens = preprocessor.process(tokens, input_path, content);
+  return (failed_count == 0) ? 0 : 1;
+}
 
-  // --- 5. 报告 Token 预处理错误 ---
-  if (preprocessor.get_errors().has_errors()) {
-    for (const auto& error : preprocessor.get_errors().get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
+/**
+ * @brief 更新符号索引，并按需查询其中的符号。
+ * @param[in] files      要索引的文件；为空时只查询已有的索引。
+ * @param[in] index_path 索引文件路径。
+ * @param[in] query      要查询的名字；为空时不查询。
+ * @param[in] jobs       并行扫描的文件数。
+ * @return 程序退出码：更新失败或查询没有结果时为 1。
+ */
+int index_command(const std::vector<std::string>& files,
+                  const std::string& index_path, const std::string& query,
+                  size_t jobs) {
+  czc::index::SymbolIndex index(VERSION);
+  bool loaded = index.load(index_path);
+
+  if (!files.empty()) {
+    std::unique_ptr<ThreadPool> pool;
+    if (jobs > 1) {
+      pool = std::make_unique<ThreadPool>(std::min(jobs, files.size()));
+    }
+    czc::index::IndexUpdateStats stats = index.update(files, pool.get());
+    if (!index.save(index_path)) {
+      print_error("Cannot write index file '" + index_path + "'");
+      return 1;
+    }
+    std::cout << "Indexed " << index.get_files().size() << " files ("
+              << stats.scanned_files << " scanned, " << stats.reused_files
+              << " unchanged, " << stats.removed_files << " removed), "
+              << index.symbol_count() << " symbols" << std::endl;
+    if (stats.failed_files > 0) {
+      print_warning(std::to_string(stats.failed_files) +
+                    " files could not be read");
     }
+  } else if (!loaded) {
+    print_error("Cannot read index file '" + index_path + "'");
+    return 1;
   }
 
-  if (diagnostics.has_errors()) {
-    print_error_stage("Errors found during token preprocessing:");
-    diagnostics.print_all(true);
-    return false;
+  if (query.empty()) {
+    return 0;
   }
-
-  // --- 6. 语法分析 ---
-  Parser parser(processed_tokens);
-  auto cst = parser.parse();
-
-  // --- 7. 报告语法分析错误 ---
-  if (parser.has_errors()) {
-    for (const auto& error : parser.get_errors()) {
-      auto diag = std::make_shared<Diagnostic>(
-          DiagnosticLevel::Error, error.code, error.location, error.args);
-      diag->set_source_line(
-          source_tracker.get_source_line(error.location.line));
-      diagnostics.report(diag);
+  auto matches = index.find(query);
+  for (const auto& match : matches) {
+    const auto& symbol = *match.symbol;
+    std::cout << *match.file << ":" << symbol.line << ":" << symbol.column
+              << ": " << czc::index::symbol_kind_to_string(symbol.kind) << " ";
+    if (match.parent != nullptr) {
+      std::cout << match.parent->name << ".";
     }
+    std::cout << symbol.name;
+    if (!symbol.detail.empty()) {
+      std::cout << (symbol.kind == czc::index::SymbolKind::Function ? ""
+                                                                    : ": ")
+                << symbol.detail;
+    }
+    std::cout << std::endl;
+  }
+  return matches.empty() ? 1 : 0;
+}
+
+/**
+ * @brief 统计一个文件的 Token 流与 CST，累计到 `stats` 中。
+ * @details 与 `tokenize` 相同地物化 Token 序列，再从中解析 CST。任一阶段
+ *          出错时打印诊断并返回 `false`，该文件不参与统计。
+ * @param[in]     input_path 输入文件的路径。
+ * @param[in]     locale     用于诊断消息的语言环境代码。
+ * @param[in,out] stats      累计统计的对象。
+ * @return 文件成功统计时返回 `true`。
+ */
+bool stats_file(const std::string& input_path, const std::string& locale,
+                CorpusStats& stats) {
+  std::optional<SourceBuffer> source = open_source_file(input_path);
+  if (!source) {
+    return false;
   }
+  std::string_view content = source->view();
+  DiagnosticEngine& diagnostics = worker_context.get_diagnostics(locale);
 
+  TokenPreprocessor preprocessor;
+  ScientificTokenClassifier classifier(preprocessor, input_path, content);
+  preprocessor.set_error_reporter(&diagnostics);
+  Lexer lexer(*source, input_path);
+  lexer.set_scientific_classifier(&classifier);
+  lexer.set_error_reporter(&diagnostics);
+  std::vector<Token> tokens = lexer.tokenize();
+  diagnostics.set_source(&lexer.get_source_tracker());
+
+  std::unique_ptr<czc::cst::CSTNode> cst;
+  if (!diagnostics.has_errors()) {
+    Parser parser(tokens, input_path);
+    parser.set_error_reporter(&diagnostics);
+    parser.set_arena_enabled(true);
+    cst = parser.parse();
+  }
   if (diagnostics.has_errors()) {
-    print_error_stage("Errors found during parsing:");
-    diagnostics.print_all(true);
+    print_error("Errors found in '" + input_path + "':");
+    diagnostics.print_all(*current_err, true);
     return false;
   }
 
-  // --- 8. 成功 ---
-  print_success("Successfully parsed with no errors");
+  const auto& root = static_cast<const czc::cst::CSTArenaRoot&>(*cst);
+  stats.add_file(content.size(), tokens, cst.get(),
+                 root.get_arena().get_bytes_used());
   return true;
 }
 
+/**
+ * @brief 统计一批文件的 Token 流与 CST，以 JSON 写到标准输出。
+ * @details
+ *   每个线程循环领取下一个文件，累计到自己的 `CorpusStats` 中，全部结束后
+ *   再按线程合并，统计过程不需要同步。各文件的诊断先写入自己的缓冲区，
+ *   最后按输入顺序打印到标准错误，标准输出只有 JSON。
+ * @param[in] files  要统计的文件。
+ * @param[in] jobs   并行处理的文件数。
+ * @param[in] locale 用于诊断消息的语言环境代码。
+ * @return 程序退出码：存在无法统计的文件时为 1。
+ */
+int stats_command(const std::vector<std::string>& files, size_t jobs,
+                  const std::string& locale) {
+  jobs = std::max<size_t>(1, std::min(jobs, files.size()));
+  std::vector<CorpusStats> partial(jobs);
+  std::vector<std::string> errors(files.size());
+  std::atomic<size_t> next{0};
+  auto work = [&](CorpusStats& stats) {
+    for (size_t i = next++; i < files.size(); i = next++) {
+      std::ostringstream err;
+      current_err = &err;
+      ScopedTraceSpan span("file", "file", files[i]);
+      if (!stats_file(files[i], locale, stats)) {
+        stats.add_failed_file();
+      }
+      current_err = &std::cerr;
+      errors[i] = err.str();
+    }
+  };
+
+  if (jobs == 1) {
+    work(partial.front());
+  } else {
+    ThreadPool pool(jobs);
+    std::vector<std::future<void>> tasks;
+    for (CorpusStats& stats : partial) {
+      tasks.push_back(pool.submit([&work, &stats]() { work(stats); }));
+    }
+    for (auto& task : tasks) {
+      task.get();
+    }
+  }
+
+  CorpusStats total;
+  for (const CorpusStats& stats : partial) {
+    total.merge(stats);
+  }
+  for (const std::string& error : errors) {
+    std::cerr << error;
+  }
+  std::cout << total.to_json().dump() << std::endl;
+  return total.get_failed_files() == 0 ? 0 : 1;
+}
+
 /**
  * @brief 程序主入口。
  * @param[in] argc 命令行参数数量。
@@ -653,6 +1378,8 @@ int main(int argc, char* argv[]) {
 
   // --- 解析全局选项 (如 --locale, --help, --version) ---
   std::string locale = "en_US"; // Default locale
+  size_t jobs = ThreadPool::default_thread_count();
+  CollectOptions collect_options;
   size_t arg_offset = 1;
 
   // NOTE: 这是一个简单的手动命令行参数解析循环。它首先处理所有以 `-`
@@ -677,6 +1404,96 @@ int main(int argc, char* argv[]) {
       }
       locale = args[arg_offset + 1];
       arg_offset += 2;
+    } else if (option == "--jobs" || option == "-j") {
+      if (arg_offset + 1 >= args.size()) {
+        print_error(option + " requires an argument");
+        print_usage(args[0]);
+        return 1;
+      }
+      try {
+        jobs = std::stoul(args[arg_offset + 1]);
+      } catch (...) {
+        jobs = 0;
+      }
+      if (jobs == 0) {
+        print_error("Invalid job count: " + args[arg_offset + 1]);
+        return 1;
+      }
+      arg_offset += 2;
+    } else if (option == "--file-index") {
+      if (arg_offset + 1 >= args.size()) {
+        print_error("--file-index requires an argument");
+        print_usage(args[0]);
+        return 1;
+      }
+      collect_options.index_path = args[arg_offset + 1];
+      arg_offset += 2;
+    } else if (option == "--no-ignore") {
+      collect_options.use_gitignore = false;
+      arg_offset += 1;
+    } else if (option == "--time-report" || option == "--time-report=json" ||
+               option == "--time-report=table") {
+#if CZC_ENABLE_TIME_REPORT
+      time_report_format = option == "--time-report=json"
+                               ? ReportFormat::Json
+                               : ReportFormat::Table;
+      TimeReport::set_enabled(true);
+#else
+      print_warning("This build was compiled without time reports "
+                    "(CZC_TIME_REPORT=OFF)");
+#endif
+      arg_offset += 1;
+    } else if (option == "--mem-report" || option == "--mem-report=json" ||
+               option == "--mem-report=table") {
+      mem_report_format = option == "--mem-report=json" ? ReportFormat::Json
+                                                        : ReportFormat::Table;
+      MemReport::set_enabled(true);
+      arg_offset += 1;
+    } else if (option == "--trace-out") {
+      if (arg_offset + 1 >= args.size()) {
+        print_error("--trace-out requires an argument");
+        print_usage(args[0]);
+        return 1;
+      }
+#if CZC_ENABLE_TIME_REPORT
+      trace_out_path = args[arg_offset + 1];
+      TimeReport::set_tracing(true);
+#else
+      print_warning("This build was compiled without tracing "
+                    "(CZC_TIME_REPORT=OFF)");
+#endif
+      arg_offset += 2;
+    } else if (option == "--cache-dir") {
+      if (arg_offset + 1 >= args.size()) {
+        print_error("--cache-dir requires an argument");
+        print_usage(args[0]);
+        return 1;
+      }
+      const std::string& directory = args[arg_offset + 1];
+      std::error_code error;
+      std::filesystem::create_directories(directory, error);
+      if (!std::filesystem::is_directory(directory, error)) {
+        print_error("Cannot create cache directory '" + directory + "'");
+        return 1;
+      }
+      cst_cache = std::make_unique<czc::cst::CSTCache>(directory, VERSION);
+      arg_offset += 2;
+    } else if (option == "--max-errors") {
+      if (arg_offset + 1 >= args.size()) {
+        print_error("--max-errors requires an argument");
+        print_usage(args[0]);
+        return 1;
+      }
+      try {
+        max_errors = std::stoul(args[arg_offset + 1]);
+      } catch (...) {
+        print_error("Invalid error limit: " + args[arg_offset + 1]);
+        return 1;
+      }
+      arg_offset += 2;
+    } else if (option == "--fail-fast") {
+      fail_fast = true;
+      arg_offset += 1;
     } else if (option == "--in-place" || option == "-i") {
       // --in-place is a fmt-specific option, will be parsed in fmt command
       print_error(
@@ -702,6 +1519,8 @@ int main(int argc, char* argv[]) {
     }
   }
 
+  collect_options.jobs = jobs;
+
   // --- 解析命令和文件参数 ---
   if (arg_offset >= args.size()) {
     print_error("Missing command");
@@ -724,40 +1543,19 @@ int main(int argc, char* argv[]) {
     }
 
     // 使用 FileCollector 将通配符模式扩展为具体的文件列表。
-    auto files_to_process = FileCollector::collect_files(patterns);
+    auto files_to_process =
+        FileCollector::collect_files(patterns, collect_options);
     if (files_to_process.empty()) {
       print_error("No files found to process");
       return 1;
     }
 
     // --- 批量处理文件 ---
-    size_t total_files = files_to_process.size();
-    size_t success_count = 0;
-    size_t failed_count = 0;
-
-    for (size_t i = 0; i < files_to_process.size(); i++) {
-      if (total_files > 1) {
-        std::cout << "[" << (i + 1) << "/" << total_files << "] ";
-      }
-      if (tokenize_file(files_to_process[i], locale)) {
-        success_count++;
-      } else {
-        failed_count++;
-      }
-      if (i < files_to_process.size() - 1) {
-        std::cout << std::endl;
-      }
-    }
-
-    // --- 打印总结信息 ---
-    if (total_files > 1) {
-      std::cout << "\n========================================" << std::endl;
-      std::cout << "Summary: " << success_count << " succeeded, "
-                << failed_count << " failed" << std::endl;
-      std::cout << "========================================" << std::endl;
-    }
-
-    return (failed_count == 0) ? 0 : 1;
+    return finish_command(
+        run_batch(files_to_process, jobs,
+                  [&](const std::string& file, const SourceBuffer& source) {
+                    return tokenize_file(file, source, locale);
+                  }));
   } else if (command == "parse") {
     if (arg_offset + 1 >= args.size()) {
       print_error("Missing input file argument");
@@ -772,40 +1570,19 @@ int main(int argc, char* argv[]) {
     }
 
     // 使用 FileCollector 将通配符模式扩展为具体的文件列表。
-    auto files_to_process = FileCollector::collect_files(patterns);
+    auto files_to_process =
+        FileCollector::collect_files(patterns, collect_options);
     if (files_to_process.empty()) {
       print_error("No files found to process");
       return 1;
     }
 
     // --- 批量处理文件 ---
-    size_t total_files = files_to_process.size();
-    size_t success_count = 0;
-    size_t failed_count = 0;
-
-    for (size_t i = 0; i < files_to_process.size(); i++) {
-      if (total_files > 1) {
-        std::cout << "[" << (i + 1) << "/" << total_files << "] ";
-      }
-      if (parse_file(files_to_process[i], locale)) {
-        success_count++;
-      } else {
-        failed_count++;
-      }
-      if (i < files_to_process.size() - 1) {
-        std::cout << std::endl;
-      }
-    }
-
-    // --- 打印总结信息 ---
-    if (total_files > 1) {
-      std::cout << "\n========================================" << std::endl;
-      std::cout << "Summary: " << success_count << " succeeded, "
-                << failed_count << " failed" << std::endl;
-      std::cout << "========================================" << std::endl;
-    }
-
-    return (failed_count == 0) ? 0 : 1;
+    return finish_command(
+        run_batch(files_to_process, jobs,
+                  [&](const std::string& file, const SourceBuffer& source) {
+                    return parse_file(file, source, locale);
+                  }));
   } else if (command == "fmt") {
     if (arg_offset + 1 >= args.size()) {
       print_error("Missing input file argument");
@@ -818,6 +1595,9 @@ int main(int argc, char* argv[]) {
     bool fmt_in_place = false;
     size_t fmt_indent_width = 4;
     bool fmt_use_tabs = false;
+    bool fmt_check = false;
+    bool fmt_sync = false;
+    std::string fmt_cache_path;
 
     // 收集所有文件模式参数（跳过格式选项）。
     std::vector<std::string> patterns;
@@ -846,6 +1626,20 @@ int main(int argc, char* argv[]) {
       } else if (args[i] == "--use-tabs") {
         fmt_use_tabs = true;
         continue;
+      } else if (args[i] == "--check") {
+        fmt_check = true;
+        continue;
+      } else if (args[i] == "--fsync") {
+        fmt_sync = true;
+        continue;
+      } else if (args[i] == "--cache") {
+        if (i + 1 >= args.size()) {
+          print_error("--cache requires an argument");
+          return 1;
+        }
+        fmt_cache_path = args[i + 1];
+        i++; // 跳过值
+        continue;
       }
       patterns.push_back(args[i]);
     }
@@ -857,7 +1651,8 @@ int main(int argc, char* argv[]) {
     }
 
     // 使用 FileCollector 将通配符模式扩展为具体的文件列表。
-    auto files_to_process = FileCollector::collect_files(patterns);
+    auto files_to_process =
+        FileCollector::collect_files(patterns, collect_options);
     if (files_to_process.empty()) {
       print_error("No files found to process");
       return 1;
@@ -869,38 +1664,121 @@ int main(int argc, char* argv[]) {
     format_options.indent_style =
         fmt_use_tabs ? IndentStyle::TABS : IndentStyle::SPACES;
 
+    if (fmt_check && fmt_in_place) {
+      print_error("Options '--check' and '--in-place' cannot be combined");
+      return 1;
+    }
+
+    // 缓存与格式化选项、版本号绑定，二者变化时旧缓存自动作废。
+    FormatCache cache(format_options, VERSION);
+    if (!fmt_cache_path.empty()) {
+      cache.load(fmt_cache_path);
+    }
+    FmtMode mode;
+    mode.in_place = fmt_in_place;
+    mode.check = fmt_check;
+    mode.sync = fmt_sync;
+    mode.cache = fmt_cache_path.empty() ? nullptr : &cache;
+    // NOTE: 多个文件之间才可能有重复的声明，只有一个文件时不必记录。
+    FormatMemo memo;
+    mode.memo = files_to_process.size() > 1 ? &memo : nullptr;
+
     // --- 批量处理文件 ---
-    size_t total_files = files_to_process.size();
-    size_t success_count = 0;
-    size_t failed_count = 0;
+    int exit_code =
+        run_batch(files_to_process, jobs,
+                  [&](const std::string& file, const SourceBuffer& source) {
+                    return format_file(file, source, locale, format_options,
+                                       mode);
+                  });
+
+    if (mode.cache != nullptr && !cache.save(fmt_cache_path)) {
+      print_warning("Cannot write cache file '" + fmt_cache_path + "'");
+    }
 
-    for (size_t i = 0; i < files_to_process.size(); i++) {
-      if (total_files > 1) {
-        std::cout << "[" << (i + 1) << "/" << total_files << "] ";
-      }
-      if (format_file(files_to_process[i], locale, format_options,
-                      fmt_in_place)) {
-        success_count++;
-      } else {
-        failed_count++;
+    return finish_command(exit_code);
+  } else if (command == "index") {
+    std::string index_path = ".czc-index";
+    std::string query;
+    std::vector<std::string> patterns;
+    for (size_t i = arg_offset + 1; i < args.size(); i++) {
+      if (args[i] == "--index" || args[i] == "--query") {
+        if (i + 1 >= args.size()) {
+          print_error(args[i] + " requires an argument");
+          return 1;
+        }
+        if (args[i] == "--index") {
+          index_path = args[i + 1];
+        } else {
+          query = args[i + 1];
+        }
+        i++; // 跳过值
+        continue;
       }
-      if (i < files_to_process.size() - 1) {
-        std::cout << std::endl;
+      patterns.push_back(args[i]);
+    }
+    if (patterns.empty() && query.empty()) {
+      print_error("Missing input file argument");
+      print_usage(args[0]);
+      return 1;
+    }
+
+    std::vector<std::string> files_to_process;
+    if (!patterns.empty()) {
+      files_to_process =
+          FileCollector::collect_files(patterns, collect_options);
+      if (files_to_process.empty()) {
+        print_error("No files found to process");
+        return 1;
       }
     }
+    return finish_command(
+        index_command(files_to_process, index_path, query, jobs));
+  } else if (command == "stats") {
+    if (arg_offset + 1 >= args.size()) {
+      print_error("Missing input file argument");
+      print_usage(args[0]);
+      return 1;
+    }
 
-    // --- 打印总结信息 ---
-    if (total_files > 1) {
-      std::cout << "\n========================================" << std::endl;
-      std::cout << "Summary: " << success_count << " succeeded, "
-                << failed_count << " failed" << std::endl;
-      std::cout << "========================================" << std::endl;
+    std::vector<std::string> patterns;
+    for (size_t i = arg_offset + 1; i < args.size(); i++) {
+      patterns.push_back(args[i]);
+    }
+    auto files_to_process =
+        FileCollector::collect_files(patterns, collect_options);
+    if (files_to_process.empty()) {
+      print_error("No files found to process");
+      return 1;
+    }
+    return finish_command(stats_command(files_to_process, jobs, locale));
+  } else if (command == "daemon") {
+    std::string socket_path;
+    for (size_t i = arg_offset + 1; i < args.size(); i++) {
+      if (args[i] == "--socket" && i + 1 < args.size()) {
+        socket_path = args[++i];
+      } else {
+        print_error("Unknown daemon option '" + args[i] + "'");
+        return 1;
+      }
     }
 
-    return (failed_count == 0) ? 0 : 1;
+    // NOTE: 常驻进程在请求之间保留诊断消息、驻留表与每个文件的 CST，
+    //       客户端每次调用只需付出一次往返的代价。
+    ServerOptions server_options;
+    server_options.locale = locale;
+    Server server(server_options);
+    if (socket_path.empty()) {
+      server.serve(std::cin, std::cout);
+      return 0;
+    }
+    if (!server.serve_unix_socket(socket_path)) {
+      print_error("Cannot listen on socket '" + socket_path + "'");
+      return 1;
+    }
+    return 0;
   }
 
   print_error("Unknown command '" + command + "'");
   print_usage(args[0]);
   return 1;
-}
\ No newline at end of file
+}
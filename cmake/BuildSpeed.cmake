@@ -0,0 +1,76 @@
+# Options that cut the cold build time of the czc library and the tests.
+#
+# Options (all off by default, so ordinary builds are unchanged):
+#   CZC_UNITY_BUILD         Compile the czc sources as unity (jumbo)
+#                           translation units of CZC_UNITY_BATCH_SIZE files,
+#                           so the shared headers are parsed once per batch.
+#   CZC_UNITY_BATCH_SIZE    Sources per unity translation unit. Larger batches
+#                           parse fewer headers but leave fewer jobs for -j.
+#   CZC_PRECOMPILED_HEADERS Precompile the standard headers used by most
+#                           sources for czc, and <gtest/gtest.h> plus those
+#                           headers once for all the gtest executables.
+#                           Project headers stay out of the PCH: editing one
+#                           must not rebuild every translation unit.
+#
+# Both need CMake 3.16 or later and are ignored (with a warning) otherwise.
+#
+# Usage:
+#   include(cmake/BuildSpeed.cmake)
+#   czc_apply_build_speedups(czc)
+#   czc_share_precompiled_headers(first_target other_targets...)
+
+option(CZC_UNITY_BUILD "Build the czc library as unity translation units" OFF)
+set(CZC_UNITY_BATCH_SIZE 8 CACHE STRING "Sources per unity translation unit")
+option(CZC_PRECOMPILED_HEADERS
+    "Precompile common headers for czc and the tests" OFF)
+
+if((CZC_UNITY_BUILD OR CZC_PRECOMPILED_HEADERS)
+    AND CMAKE_VERSION VERSION_LESS 3.16)
+    message(WARNING
+        "CZC_UNITY_BUILD / CZC_PRECOMPILED_HEADERS need CMake 3.16; ignored")
+    set(CZC_UNITY_BUILD OFF)
+    set(CZC_PRECOMPILED_HEADERS OFF)
+endif()
+
+# Standard headers included by most czc sources (see `#include <...>` counts).
+set(CZC_PCH_HEADERS
+    <algorithm>
+    <cstddef>
+    <cstdint>
+    <functional>
+    <limits>
+    <memory>
+    <optional>
+    <string>
+    <string_view>
+    <unordered_map>
+    <utility>
+    <vector>
+)
+
+# Apply the unity build and the standard-header PCH to each target.
+function(czc_apply_build_speedups)
+    foreach(target IN LISTS ARGN)
+        if(CZC_UNITY_BUILD)
+            set_target_properties(${target} PROPERTIES
+                UNITY_BUILD ON
+                UNITY_BUILD_BATCH_SIZE ${CZC_UNITY_BATCH_SIZE})
+        endif()
+        if(CZC_PRECOMPILED_HEADERS)
+            target_precompile_headers(${target} PRIVATE ${CZC_PCH_HEADERS})
+        endif()
+    endforeach()
+endfunction()
+
+# Precompile <gtest/gtest.h> and the standard headers once on `first` and
+# reuse that PCH for the remaining targets, which must be built with the same
+# flags (e.g. all the gtest executables in tests/).
+function(czc_share_precompiled_headers first)
+    if(NOT CZC_PRECOMPILED_HEADERS)
+        return()
+    endif()
+    target_precompile_headers(${first} PRIVATE <gtest/gtest.h> ${CZC_PCH_HEADERS})
+    foreach(target IN LISTS ARGN)
+        target_precompile_headers(${target} REUSE_FROM ${first})
+    endforeach()
+endfunction()
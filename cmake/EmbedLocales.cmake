@@ -0,0 +1,126 @@
+# Generates a C++ source file holding every locales/<locale>/diagnostics.toml
+# catalog as constant-initialized tables, so I18nMessages can load messages
+# without touching the filesystem.
+#
+# Usage:
+#   cmake -DLOCALE_DIR=<dir> -DOUTPUT=<file.cpp> -DEMBED=<ON|OFF>
+#         -P EmbedLocales.cmake
+#
+# Only the subset of TOML used by the catalogs is accepted: `[CODE]` headers,
+# `message` / `help` / `source` keys with single-line basic strings, comments
+# and blank lines. Basic-string escapes are a subset of C++ escapes, so the
+# values are copied into C++ string literals verbatim.
+
+cmake_minimum_required(VERSION 3.15)
+
+if(NOT LOCALE_DIR OR NOT OUTPUT)
+    message(FATAL_ERROR "EmbedLocales.cmake needs LOCALE_DIR and OUTPUT")
+endif()
+
+set(locale_names "")
+set(body "")
+
+if(EMBED)
+    file(GLOB locale_files RELATIVE "${LOCALE_DIR}"
+        "${LOCALE_DIR}/*/diagnostics.toml")
+    list(SORT locale_files)
+endif()
+
+foreach(relative IN LISTS locale_files)
+    get_filename_component(locale "${relative}" DIRECTORY)
+    string(MAKE_C_IDENTIFIER "${locale}" locale_id)
+    set(path "${LOCALE_DIR}/${relative}")
+
+    # CMake lists split on ';' and group on '[' / ']', so protect them before
+    # splitting the file into lines.
+    file(READ "${path}" content)
+    string(REPLACE "\r" "" content "${content}")
+    string(REPLACE ";" "@CZC_SEMI@" content "${content}")
+    string(REPLACE "[" "@CZC_LB@" content "${content}")
+    string(REPLACE "]" "@CZC_RB@" content "${content}")
+    string(REPLACE "\n" ";" lines "${content}")
+
+    set(entries "")
+    set(code "")
+    set(line_number 0)
+    foreach(line IN LISTS lines)
+        math(EXPR line_number "${line_number} + 1")
+        if(line MATCHES "^[ \t]*(#.*)?$")
+            continue()
+        endif()
+        if(line MATCHES "^@CZC_LB@([A-Z][0-9][0-9][0-9][0-9])@CZC_RB@[ \t]*(#.*)?$")
+            if(NOT code STREQUAL "")
+                string(APPEND entries "    {\"${code}\", \"${field_message}\", \"${field_help}\", \"${field_source}\"},\n")
+            endif()
+            set(code "${CMAKE_MATCH_1}")
+            set(field_message "")
+            set(field_help "")
+            set(field_source "")
+            continue()
+        endif()
+        if(NOT code STREQUAL "" AND line MATCHES
+                "^(message|help|source)[ \t]*=[ \t]*\"(([^\"\\\\]|\\\\.)*)\"[ \t]*(#.*)?$")
+            set(key "${CMAKE_MATCH_1}")
+            set(value "${CMAKE_MATCH_2}")
+            string(REPLACE "\\\\" "" unescaped "${value}")
+            if(unescaped MATCHES "\\\\[^btnfr\"uU]")
+                message(FATAL_ERROR
+                    "${path}:${line_number}: unsupported escape sequence")
+            endif()
+            string(REPLACE "@CZC_SEMI@" ";" value "${value}")
+            string(REPLACE "@CZC_LB@" "[" value "${value}")
+            string(REPLACE "@CZC_RB@" "]" value "${value}")
+            # Keep "??" sequences from ever being read as trigraphs.
+            string(REPLACE "??" "?\\?" value "${value}")
+            set(field_${key} "${value}")
+            continue()
+        endif()
+        message(FATAL_ERROR
+            "${path}:${line_number}: unsupported syntax for an embedded locale")
+    endforeach()
+    if(NOT code STREQUAL "")
+        string(APPEND entries "    {\"${code}\", \"${field_message}\", \"${field_help}\", \"${field_source}\"},\n")
+    endif()
+
+    string(APPEND body "const EmbeddedMessage ${locale_id}_messages[] = {\n${entries}};\n\n")
+    string(APPEND locale_names "    {\"${locale}\", ${locale_id}_messages,\n     sizeof(${locale_id}_messages) / sizeof(EmbeddedMessage)},\n")
+endforeach()
+
+if(locale_names STREQUAL "")
+    set(table "const EmbeddedLocale* const locales = nullptr;\nconstexpr size_t locale_count = 0;\n")
+else()
+    set(table "const EmbeddedLocale locales[] = {\n${locale_names}};\nconstexpr size_t locale_count = sizeof(locales) / sizeof(EmbeddedLocale);\n")
+endif()
+
+set(generated "// Generated by cmake/EmbedLocales.cmake from locales/*/diagnostics.toml.
+// Do not edit.
+
+#include \"czc/diagnostics/embedded_locales.hpp\"
+
+namespace czc::diagnostics {
+
+namespace {
+
+${body}${table}
+} // namespace
+
+const EmbeddedLocale* find_embedded_locale(std::string_view name) noexcept {
+  for (size_t i = 0; i < locale_count; ++i) {
+    if (name == locales[i].name) {
+      return &locales[i];
+    }
+  }
+  return nullptr;
+}
+
+} // namespace czc::diagnostics
+")
+
+# Only touch the output when it changes, so unrelated rebuilds stay no-ops.
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+    if(previous STREQUAL generated)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${generated}")
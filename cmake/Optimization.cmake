@@ -0,0 +1,115 @@
+# Performance build configurations for the czc library and CLI.
+#
+# Options (all off by default, so ordinary builds are unchanged):
+#   CZC_ENABLE_LTO        Link-time optimization through CMake's
+#                         INTERPROCEDURAL_OPTIMIZATION, which means ThinLTO
+#                         (-flto=thin) on Clang and -flto=auto on GCC, plus
+#                         the matching llvm-ar / gcc-ar for the static library.
+#   CZC_PGO               OFF, GENERATE or USE. GENERATE instruments the
+#                         build and writes profiles into CZC_PGO_PROFILE_DIR
+#                         whenever an instrumented binary runs; USE rebuilds
+#                         with those profiles. `make pgo` runs the whole
+#                         workflow, training on benchmark_pipeline.
+#   CZC_PGO_PROFILE_DIR   Where profiles are written and read. With GCC the
+#                         profiles are keyed by object path, so GENERATE and
+#                         USE must be configured in the same build directory.
+#   CZC_MARCH             Value for -march (e.g. native, x86-64-v3). Without
+#                         it the x86-64 scan kernels still pick AVX2 at run
+#                         time; with an AVX2-capable -march they are selected
+#                         at compile time instead.
+#
+# Usage (after the czc and czc-cli targets are defined):
+#   include(cmake/Optimization.cmake)
+#   czc_apply_optimizations(czc czc-cli)
+
+option(CZC_ENABLE_LTO "Build czc and czc-cli with (Thin)LTO" OFF)
+set(CZC_PGO "OFF" CACHE STRING "Profile-guided optimization: OFF, GENERATE or USE")
+set_property(CACHE CZC_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(CZC_PGO_PROFILE_DIR "${PROJECT_BINARY_DIR}/pgo-profiles" CACHE PATH
+    "Directory holding the PGO profiles")
+set(CZC_MARCH "" CACHE STRING "Target architecture passed to -march (empty: compiler default)")
+
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    set(CZC_COMPILER_IS_CLANG ON)
+else()
+    set(CZC_COMPILER_IS_CLANG OFF)
+endif()
+
+if(CZC_ENABLE_LTO)
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT CZC_IPO_SUPPORTED OUTPUT CZC_IPO_ERROR LANGUAGES CXX)
+    if(NOT CZC_IPO_SUPPORTED)
+        message(WARNING "CZC_ENABLE_LTO: LTO is not supported: ${CZC_IPO_ERROR}")
+    endif()
+endif()
+
+if(NOT CZC_PGO STREQUAL "OFF")
+    if(MSVC)
+        message(FATAL_ERROR "CZC_PGO is only supported with GCC and Clang")
+    elseif(NOT CZC_PGO MATCHES "^(GENERATE|USE)$")
+        message(FATAL_ERROR "CZC_PGO must be OFF, GENERATE or USE (got '${CZC_PGO}')")
+    endif()
+    set(CZC_PGO_PROFDATA "${CZC_PGO_PROFILE_DIR}/czc.profdata")
+    if(CZC_PGO STREQUAL "USE")
+        if(CZC_COMPILER_IS_CLANG AND NOT EXISTS "${CZC_PGO_PROFDATA}")
+            message(FATAL_ERROR
+                "CZC_PGO=USE: ${CZC_PGO_PROFDATA} not found; merge the .profraw "
+                "files with llvm-profdata first (see `make pgo`)")
+        elseif(NOT EXISTS "${CZC_PGO_PROFILE_DIR}")
+            message(FATAL_ERROR
+                "CZC_PGO=USE: ${CZC_PGO_PROFILE_DIR} not found; run a "
+                "CZC_PGO=GENERATE build first (see `make pgo`)")
+        endif()
+    endif()
+endif()
+
+# Apply the configured optimizations to each target.
+function(czc_apply_optimizations)
+    foreach(target IN LISTS ARGN)
+        if(CZC_ENABLE_LTO AND CZC_IPO_SUPPORTED)
+            set_property(TARGET ${target} PROPERTY
+                INTERPROCEDURAL_OPTIMIZATION TRUE)
+        endif()
+
+        # Every executable linking an instrumented target needs the profiling
+        # runtime, so the GENERATE link flags are PUBLIC (tests and
+        # benchmarks inherit them).
+        if(CZC_PGO STREQUAL "GENERATE")
+            if(CZC_COMPILER_IS_CLANG)
+                set(flag "-fprofile-instr-generate=${CZC_PGO_PROFILE_DIR}/czc-%p.profraw")
+            else()
+                set(flag "-fprofile-generate=${CZC_PGO_PROFILE_DIR}"
+                    -fprofile-update=atomic)
+            endif()
+            target_compile_options(${target} PRIVATE ${flag})
+            target_link_options(${target} PUBLIC ${flag})
+        elseif(CZC_PGO STREQUAL "USE")
+            if(CZC_COMPILER_IS_CLANG)
+                target_compile_options(${target} PRIVATE
+                    "-fprofile-instr-use=${CZC_PGO_PROFDATA}"
+                    -Wno-profile-instr-unprofiled
+                    -Wno-profile-instr-out-of-date)
+            else()
+                # Training covers only part of the code: functions it never
+                # ran are still optimized normally (-fprofile-partial-training),
+                # and -fprofile-correction absorbs counter races from
+                # multi-threaded training runs.
+                target_compile_options(${target} PRIVATE
+                    "-fprofile-use=${CZC_PGO_PROFILE_DIR}"
+                    -fprofile-correction -Wno-missing-profile)
+                if(CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL 10)
+                    target_compile_options(${target} PRIVATE
+                        -fprofile-partial-training)
+                endif()
+            endif()
+        endif()
+
+        if(CZC_MARCH)
+            if(MSVC)
+                message(WARNING "CZC_MARCH is ignored with MSVC; use /arch instead")
+            else()
+                target_compile_options(${target} PRIVATE "-march=${CZC_MARCH}")
+            endif()
+        endif()
+    endforeach()
+endfunction()
@@ -9,10 +9,11 @@
 #ifndef CZC_AST_BUILDER_HPP
 #define CZC_AST_BUILDER_HPP
 
+#include "czc/ast/ast_context.hpp"
 #include "czc/ast/ast_node.hpp"
 #include "czc/cst/cst_node.hpp"
+#include "czc/parser/parser.hpp"
 
-#include <memory>
 #include <string>
 
 namespace czc::ast {
@@ -27,140 +28,188 @@ namespace czc::ast {
  *   2. 解析字面量值
  *   3. 建立语义连接
  *   4. 保留源码位置信息（用于错误报告）
+ *
+ *   生成的节点全部由构造时传入的 `ASTContext` 持有。
  */
 class ASTBuilder {
 public:
-  ASTBuilder() = default;
+  /**
+   * @brief 构造函数
+   * @param context 持有生成节点的上下文，必须比生成的 AST 活得更久
+   */
+  explicit ASTBuilder(ASTContext& context) noexcept : context(context) {}
 
   /**
    * @brief 从 CST 构建 AST
    * @param cst_root CST 根节点
-   * @return AST 根节点（Program）
+   * @return AST 根节点（Program），由上下文持有
+   */
+  Program* build(const cst::CSTNode* cst_root);
+
+  /**
+   * @brief 驱动 Parser 直接构建 AST，不保留完整的 CST
+   * @details
+   *   通过 `parser::Parser::parse(DeclarationSink&)` 逐个接收顶层声明，
+   *   转换后立即丢弃其 CST，峰值内存只需容纳一个声明的 CST。
+   *   结果与先 `parser.parse()` 再 `build()` 相同；解析错误仍从 Parser 获取。
+   * @param parser 尚未开始解析的 Parser
+   * @return AST 根节点（Program），由上下文持有
+   */
+  Program* build(parser::Parser& parser);
+
+  // `build_parallel` 默认的最小分块大小（顶层声明数）。
+  static constexpr size_t DEFAULT_PARALLEL_CHUNK_DECLARATIONS = 64;
+
+  /**
+   * @brief 按顶层声明切分 CST，在线程池上并行构建 AST
+   * @details
+   *   各顶层声明的子树互不依赖：Program 的子节点被均分为连续的若干块，
+   *   每块由一个任务在自己的 `ASTContext`（与本上下文共享驻留表，各有一个
+   *   Arena）中转换，任务之间没有同步。全部完成后，各块的上下文由本上下文
+   *   接管（见 `ASTContext::adopt`），声明按原顺序挂到同一个 Program 下，
+   *   结果与 `build(cst_root)` 相同。
+   *
+   *   声明数不足两块或线程池只有一个线程时退化为串行的 `build`。
+   *   不能在同一线程池的任务中调用，否则可能因等待自身而死锁。
+   * @param cst_root CST 根节点
+   * @param pool 执行转换任务的线程池
+   * @param min_chunk_declarations 每块至少包含的顶层声明数
+   * @return AST 根节点（Program），由上下文持有
    */
-  std::shared_ptr<Program> build(const cst::CSTNode* cst_root);
+  Program* build_parallel(
+      const cst::CSTNode* cst_root, utils::ThreadPool& pool,
+      size_t min_chunk_declarations = DEFAULT_PARALLEL_CHUNK_DECLARATIONS);
 
 private:
+  // 把 Parser 交出的顶层声明逐个转换并挂到 Program 下的接收器。
+  class StreamingSink;
+
+  // 持有生成节点的上下文。
+  ASTContext& context;
+
   // === CST -> AST 转换方法 ===
 
   /**
    * @brief 转换 Program 节点
    */
-  std::shared_ptr<Program> build_program(const cst::CSTNode* cst_node);
+  Program* build_program(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换 Declaration 节点
    */
-  std::shared_ptr<Declaration> build_declaration(const cst::CSTNode* cst_node);
+  Declaration* build_declaration(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换 Statement 节点
    */
-  std::shared_ptr<Statement> build_statement(const cst::CSTNode* cst_node);
+  Statement* build_statement(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换 Expression 节点
    */
-  std::shared_ptr<Expression> build_expression(const cst::CSTNode* cst_node);
+  Expression* build_expression(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换 Type 节点
    */
-  std::shared_ptr<Type> build_type(const cst::CSTNode* cst_node);
+  Type* build_type(const cst::CSTNode* cst_node);
 
   // === 具体节点转换方法 ===
 
   /**
    * @brief 转换变量声明
    */
-  std::shared_ptr<Declaration>
-  build_var_declaration(const cst::CSTNode* cst_node);
+  Declaration* build_var_declaration(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换函数声明
    */
-  std::shared_ptr<Declaration>
-  build_function_declaration(const cst::CSTNode* cst_node);
+  Declaration* build_function_declaration(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换结构体声明
    */
-  std::shared_ptr<Declaration>
-  build_struct_declaration(const cst::CSTNode* cst_node);
+  Declaration* build_struct_declaration(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换 Block 语句
    */
-  std::shared_ptr<Statement>
-  build_block_statement(const cst::CSTNode* cst_node);
+  Statement* build_block_statement(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换 Expression 语句
    */
-  std::shared_ptr<Statement> build_expr_statement(const cst::CSTNode* cst_node);
+  Statement* build_expr_statement(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换 Return 语句
    */
-  std::shared_ptr<Statement>
-  build_return_statement(const cst::CSTNode* cst_node);
+  Statement* build_return_statement(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换 If 语句
    */
-  std::shared_ptr<Statement> build_if_statement(const cst::CSTNode* cst_node);
+  Statement* build_if_statement(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换二元运算表达式
    */
-  std::shared_ptr<Expression> build_binary_expr(const cst::CSTNode* cst_node);
+  Expression* build_binary_expr(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换一元运算表达式
    */
-  std::shared_ptr<Expression> build_unary_expr(const cst::CSTNode* cst_node);
+  Expression* build_unary_expr(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换字面量表达式
    */
-  std::shared_ptr<Expression> build_literal(const cst::CSTNode* cst_node);
+  Expression* build_literal(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换标识符
    */
-  std::shared_ptr<Expression> build_identifier(const cst::CSTNode* cst_node);
+  Expression* build_identifier(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换括号表达式
    */
-  std::shared_ptr<Expression> build_paren_expr(const cst::CSTNode* cst_node);
+  Expression* build_paren_expr(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换函数调用表达式
    */
-  std::shared_ptr<Expression> build_call_expr(const cst::CSTNode* cst_node);
+  Expression* build_call_expr(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换索引访问表达式
    */
-  std::shared_ptr<Expression> build_index_expr(const cst::CSTNode* cst_node);
+  Expression* build_index_expr(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换成员访问表达式
    */
-  std::shared_ptr<Expression> build_member_expr(const cst::CSTNode* cst_node);
+  Expression* build_member_expr(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换函数参数
    */
-  std::shared_ptr<Parameter> build_parameter(const cst::CSTNode* cst_node);
+  Parameter* build_parameter(const cst::CSTNode* cst_node);
 
   /**
    * @brief 转换结构体字段
    */
-  std::shared_ptr<StructField> build_struct_field(const cst::CSTNode* cst_node);
+  StructField* build_struct_field(const cst::CSTNode* cst_node);
 
   // === 辅助方法 ===
 
+  /**
+   * @brief 驻留 Token 的文本
+   * @details Token 已带有同一驻留表的句柄（见 `lexer::Lexer::set_interner`）
+   *          时直接复用，不再重新哈希
+   */
+  utils::InternedString intern_token(const lexer::Token& token);
+
   /**
    * @brief 从 CST Token 解析二元运算符
    */
@@ -172,19 +221,16 @@ private:
   UnaryOperator parse_unary_operator(const std::string& op_str);
 
   /**
-   * @brief 解析整数字面量
-   */
-  int64_t parse_integer_literal(const std::string& literal_str);
-
-  /**
-   * @brief 解析浮点数字面量
+   * @brief 获取整数字面量的值
+   * @details 优先使用 Lexer 已解码的值，Token 不带解码值时才解析文本。
    */
-  double parse_float_literal(const std::string& literal_str);
+  int64_t parse_integer_literal(const lexer::Token& token);
 
   /**
-   * @brief 解析字符串字面量（处理转义）
+   * @brief 获取浮点数字面量的值
+   * @details 优先使用 Lexer 已解码的值，Token 不带解码值时才解析文本。
    */
-  std::string parse_string_literal(const std::string& literal_str);
+  double parse_float_literal(const lexer::Token& token);
 };
 
 } // namespace czc::ast
@@ -0,0 +1,289 @@
+/**
+ * @file ast_context.hpp
+ * @brief 定义了持有全部 AST 节点的 `ASTContext`。
+ * @details
+ *   AST 节点统一通过 `ASTContext::create` 在同一个 `utils::Arena` 中分配，
+ *   节点之间以裸指针相连。整棵树的生命周期与 `ASTContext` 相同：
+ *   上下文析构时析构所有节点，再一次性释放 Arena 的内存块。
+ *
+ *   同一类型的节点放在该类型专属的节点池中：节点池由若干块连续的数组
+ *   （slab）组成，每块都从 Arena 中整块分配。只关心某一种节点的分析
+ *   （例如对所有 `BinaryOpExpr` 做常量折叠）可以用 `for_each_node`
+ *   顺序扫过这些数组，而不必遍历整棵树、在各种节点之间来回跳转。
+ *
+ *   并行构建时每个任务在自己的上下文（各有一个 Arena）中创建节点，
+ *   完成后由 `adopt` 交给最终的上下文，任务之间不需要任何同步。
+ *   节点中的名字与字符串字面量驻留在上下文所用的 `utils::StringInterner` 中。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_AST_CONTEXT_HPP
+#define CZC_AST_CONTEXT_HPP
+
+#include "czc/ast/ast_node.hpp"
+#include "czc/utils/arena.hpp"
+#include "czc/utils/string_interner.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace czc::ast {
+
+namespace detail {
+
+// 下一个尚未分配的节点池编号。
+inline std::atomic<size_t> next_node_pool_id{0};
+
+/**
+ * @brief 获取节点类型 `T` 的节点池编号。
+ * @details 编号在第一次使用 `T` 时分配，从 0 开始连续增长，因此可以直接
+ *          作为下标，在各个上下文中都相同。
+ */
+template <typename T> size_t node_pool_id() noexcept {
+  static const size_t id =
+      next_node_pool_id.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+} // namespace detail
+
+/**
+ * @brief AST 节点的所有者。
+ * @details
+ *   `create` 返回的指针在上下文存活期间一直有效，调用方不需要也不能
+ *   单独释放节点。一个上下文可以容纳多棵树（例如多次 `ASTBuilder::build`
+ *   的结果），它们会在上下文析构时一起释放。
+ *
+ * @property {生命周期} 节点不能比创建它的上下文活得更久。
+ * @property {线程安全} 非线程安全。
+ */
+class ASTContext {
+public:
+  /**
+   * @brief 构造一个使用自有驻留表的上下文。
+   */
+  ASTContext();
+
+  /**
+   * @brief 构造一个与其他阶段共享驻留表的上下文。
+   * @details 例如与 `lexer::Lexer::set_interner` 使用同一个驻留表，
+   *          构建 AST 时即可直接复用标识符 Token 上的句柄。
+   * @param[in] interner 驻留表，必须比本上下文活得更久。
+   */
+  explicit ASTContext(utils::StringInterner& interner) noexcept;
+
+  /**
+   * @brief 析构所有节点。
+   */
+  ~ASTContext();
+
+  ASTContext(const ASTContext&) = delete;
+  ASTContext& operator=(const ASTContext&) = delete;
+
+  /**
+   * @brief 在 `T` 的节点池中构造一个节点。
+   * @tparam T 节点类型，必须派生自 `ASTNode`。
+   * @param[in] args 转发给 `T` 构造函数的参数。
+   * @return 指向新节点的指针，由本上下文持有。
+   */
+  template <typename T, typename... Args> T* create(Args&&... args) {
+    static_assert(std::is_base_of_v<ASTNode, T>,
+                  "ASTContext can only create AST nodes");
+
+    NodePool& pool = get_pool<T>();
+    if (pool.slabs.empty() ||
+        pool.slabs.back().size == pool.slabs.back().capacity) {
+      add_slab(pool, alignof(T));
+    }
+
+    // NOTE: 构造成功后才计入 slab，构造失败时这个槽位留给下一个节点，
+    //       析构时也不会碰到未构造的内存。
+    Slab& slab = pool.slabs.back();
+    T* node = new (slab.data + slab.size * sizeof(T))
+        T(std::forward<Args>(args)...);
+    ++slab.size;
+    ++node_count;
+    return node;
+  }
+
+  /**
+   * @brief 按创建顺序对每个类型恰好为 `T` 的节点调用 `func(T&)`。
+   * @details 只扫描 `T` 的节点池，不经过树的结构，也不包含 `T` 的派生类
+   *          或其他类型的节点。被接管的上下文中的节点排在本上下文的节点
+   *          之后，按接管的顺序。回调中不能创建新的 `T` 节点。
+   */
+  template <typename T, typename Func> void for_each_node(Func&& func) {
+    static_assert(std::is_base_of_v<ASTNode, T>,
+                  "ASTContext only pools AST nodes");
+    size_t id = detail::node_pool_id<T>();
+    if (id < pools.size()) {
+      for (const Slab& slab : pools[id].slabs) {
+        for (uint32_t i = 0; i < slab.size; ++i) {
+          func(
+              *std::launder(reinterpret_cast<T*>(slab.data + i * sizeof(T))));
+        }
+      }
+    }
+    for (const auto& child : adopted) {
+      child->for_each_node<T>(func);
+    }
+  }
+
+  /**
+   * @brief 按创建顺序对每个类型恰好为 `T` 的节点调用 `func(const T&)`。
+   */
+  template <typename T, typename Func>
+  void for_each_node(Func&& func) const {
+    static_assert(std::is_base_of_v<ASTNode, T>,
+                  "ASTContext only pools AST nodes");
+    size_t id = detail::node_pool_id<T>();
+    if (id < pools.size()) {
+      for (const Slab& slab : pools[id].slabs) {
+        for (uint32_t i = 0; i < slab.size; ++i) {
+          func(*std::launder(
+              reinterpret_cast<const T*>(slab.data + i * sizeof(T))));
+        }
+      }
+    }
+    for (const auto& child : adopted) {
+      std::as_const(*child).for_each_node<T>(func);
+    }
+  }
+
+  /**
+   * @brief 在上下文的驻留表中驻留一个字符串。
+   */
+  [[nodiscard]] utils::InternedString intern(std::string_view text) {
+    return interner->intern(text);
+  }
+
+  /**
+   * @brief 获取上下文使用的驻留表。
+   */
+  [[nodiscard]] utils::StringInterner& get_interner() noexcept {
+    return *interner;
+  }
+
+  /**
+   * @brief 获取已创建的节点数量。
+   */
+  [[nodiscard]] size_t get_node_count() const noexcept {
+    return node_count;
+  }
+
+  /**
+   * @brief 获取已创建的类型恰好为 `T` 的节点数量。
+   */
+  template <typename T> [[nodiscard]] size_t get_node_count() const noexcept {
+    size_t id = detail::node_pool_id<T>();
+    size_t count = id < pools.size() ? pools[id].count() : 0;
+    for (const auto& child : adopted) {
+      count += child->get_node_count<T>();
+    }
+    return count;
+  }
+
+  /**
+   * @brief 接管 `other` 的全部节点，它们此后与本上下文的节点同生共死。
+   * @details `for_each_node` 与各项计数都包含被接管的节点；
+   *          `get_arena` 只返回本上下文自己的 Arena。
+   * @param[in] other 与本上下文使用同一个驻留表的上下文，不能为空。
+   * @throws std::invalid_argument 两者的驻留表不同时抛出。
+   */
+  void adopt(std::unique_ptr<ASTContext> other);
+
+  /**
+   * @brief 获取节点所使用的 Arena。
+   */
+  [[nodiscard]] const utils::Arena& get_arena() const noexcept {
+    return arena;
+  }
+
+  /**
+   * @brief 估算节点占用的字节数（Arena 中的节点池加上池的目录）。
+   * @details 不含驻留表，驻留表可能在多个上下文间共享，见
+   *          `utils::StringInterner::get_memory_bytes`。
+   */
+  [[nodiscard]] size_t get_memory_bytes() const noexcept;
+
+private:
+  // 节点池第一块 slab 容纳的节点数；之后每块翻倍，直到 `MAX_SLAB_NODES`。
+  static constexpr uint32_t FIRST_SLAB_NODES = 16;
+  static constexpr uint32_t MAX_SLAB_NODES = 1024;
+
+  /**
+   * @brief 节点池中一块连续的节点数组。
+   */
+  struct Slab {
+    std::byte* data;
+    // 已构造的节点数
+    uint32_t size;
+    uint32_t capacity;
+  };
+
+  /**
+   * @brief 同一类型节点的池。
+   */
+  struct NodePool {
+    std::vector<Slab> slabs;
+    // 节点的大小，为 0 表示池尚未初始化
+    size_t stride = 0;
+    // 析构一个节点；平凡析构的类型为空
+    void (*destroy)(void*) = nullptr;
+
+    [[nodiscard]] size_t count() const noexcept;
+  };
+
+  /**
+   * @brief 获取 `T` 的节点池，第一次使用时初始化。
+   */
+  template <typename T> NodePool& get_pool() {
+    size_t id = detail::node_pool_id<T>();
+    if (id >= pools.size()) {
+      pools.resize(id + 1);
+    }
+    NodePool& pool = pools[id];
+    if (pool.stride == 0) {
+      pool.stride = sizeof(T);
+      if constexpr (!std::is_trivially_destructible_v<T>) {
+        pool.destroy = [](void* node) { static_cast<T*>(node)->~T(); };
+      }
+    }
+    return pool;
+  }
+
+  /**
+   * @brief 从 Arena 中为 `pool` 分配下一块 slab。
+   */
+  void add_slab(NodePool& pool, size_t align);
+
+  // 节点池的存储。
+  utils::Arena arena;
+
+  // 按 `detail::node_pool_id` 编号的节点池，没有用到的类型对应空池。
+  std::vector<NodePool> pools;
+
+  // 由 `adopt` 接管的上下文。
+  std::vector<std::unique_ptr<ASTContext>> adopted;
+
+  // 全部节点池（含被接管的上下文）中的节点数。
+  size_t node_count = 0;
+
+  // 未共享驻留表时上下文自有的驻留表。
+  std::unique_ptr<utils::StringInterner> owned_interner;
+
+  // 实际使用的驻留表。
+  utils::StringInterner* interner;
+};
+
+} // namespace czc::ast
+
+#endif // CZC_AST_CONTEXT_HPP
@@ -1,7 +1,13 @@
 /**
  * @file ast_node.hpp
  * @brief AST（抽象语法树）节点定义
- * @details 定义 AST 节点的基础类型和结构，AST 是从 CST 转换而来的语义层表示
+ * @details
+ *   定义 AST 节点的基础类型和结构，AST 是从 CST 转换而来的语义层表示。
+ *
+ *   所有节点都由 `ASTContext` 创建并持有（见 ast_context.hpp），节点之间
+ *   以裸指针相连：指针只是非拥有的引用，在所属 `ASTContext` 存活期间有效，
+ *   遍历时不涉及任何引用计数。名字与字符串字面量都驻留在上下文的
+ *   `StringInterner` 中，节点只保存句柄与指向驻留文本的视图。
  * @author BegoniaHe
  * @date 2025-11-13
  */
@@ -10,10 +16,12 @@
 #define CZC_AST_NODE_HPP
 
 #include "czc/utils/source_location.hpp"
+#include "czc/utils/symbol.hpp"
 
-#include <memory>
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace czc::ast {
@@ -41,6 +49,7 @@ enum class ASTNodeKind {
   StructDecl,    ///< 结构体声明: struct Name { fields }
   StructField,   ///< 结构体字段: name: type
   TypeAliasDecl, ///< 类型别名: type Name = Type
+  Parameter,     ///< 函数参数: name: type
 
   // === 语句 (Statements) ===
   BlockStmt,    ///< 块语句: { stmts }
@@ -158,21 +167,21 @@ public:
   /**
    * @brief 设置类型信息（用于类型检查阶段）
    */
-  void set_type(std::shared_ptr<Type> type) {
+  void set_type(Type* type) noexcept {
     type_ = type;
   }
 
   /**
    * @brief 获取类型信息
    */
-  [[nodiscard]] std::shared_ptr<Type> get_type() const noexcept {
+  [[nodiscard]] Type* get_type() const noexcept {
     return type_;
   }
 
 protected:
   ASTNodeKind kind_;               ///< 节点类型
   utils::SourceLocation location_; ///< 源码位置
-  std::shared_ptr<Type> type_;     ///< 类型信息（类型检查后填充）
+  Type* type_{nullptr};            ///< 类型信息（类型检查后填充）
 };
 
 /**
@@ -226,17 +235,17 @@ public:
   Program(const utils::SourceLocation& location)
       : ASTNode(ASTNodeKind::Program, location) {}
 
-  void add_declaration(std::shared_ptr<Declaration> decl) {
+  void add_declaration(Declaration* decl) {
     declarations_.push_back(decl);
   }
 
-  [[nodiscard]] const std::vector<std::shared_ptr<Declaration>>&
+  [[nodiscard]] const std::vector<Declaration*>&
   get_declarations() const noexcept {
     return declarations_;
   }
 
 private:
-  std::vector<std::shared_ptr<Declaration>> declarations_;
+  std::vector<Declaration*> declarations_;
 };
 
 /**
@@ -245,15 +254,19 @@ private:
  */
 class Identifier : public Expression {
 public:
-  Identifier(const std::string& name, const utils::SourceLocation& location)
+  Identifier(utils::InternedString name,
+             const utils::SourceLocation& location)
       : Expression(ASTNodeKind::Identifier, location), name_(name) {}
 
-  [[nodiscard]] const std::string& get_name() const noexcept {
-    return name_;
+  [[nodiscard]] std::string_view get_name() const noexcept {
+    return name_.get_view();
+  }
+  [[nodiscard]] utils::Symbol get_name_symbol() const noexcept {
+    return name_.get_symbol();
   }
 
 private:
-  std::string name_;
+  utils::InternedString name_;
 };
 
 /**
@@ -279,8 +292,7 @@ private:
  */
 class BinaryOpExpr : public Expression {
 public:
-  BinaryOpExpr(BinaryOperator op, std::shared_ptr<Expression> left,
-               std::shared_ptr<Expression> right,
+  BinaryOpExpr(BinaryOperator op, Expression* left, Expression* right,
                const utils::SourceLocation& location)
       : Expression(ASTNodeKind::BinaryOp, location), op_(op), left_(left),
         right_(right) {}
@@ -288,17 +300,23 @@ public:
   [[nodiscard]] BinaryOperator get_operator() const noexcept {
     return op_;
   }
-  [[nodiscard]] std::shared_ptr<Expression> get_left() const noexcept {
+  [[nodiscard]] Expression* get_left() const noexcept {
     return left_;
   }
-  [[nodiscard]] std::shared_ptr<Expression> get_right() const noexcept {
+  [[nodiscard]] Expression* get_right() const noexcept {
     return right_;
   }
+  void set_left(Expression* left) noexcept {
+    left_ = left;
+  }
+  void set_right(Expression* right) noexcept {
+    right_ = right;
+  }
 
 private:
   BinaryOperator op_;
-  std::shared_ptr<Expression> left_;
-  std::shared_ptr<Expression> right_;
+  Expression* left_;
+  Expression* right_;
 };
 
 /**
@@ -310,17 +328,17 @@ public:
   BlockStmt(const utils::SourceLocation& location)
       : Statement(ASTNodeKind::BlockStmt, location) {}
 
-  void add_statement(std::shared_ptr<Statement> stmt) {
+  void add_statement(Statement* stmt) {
     statements_.push_back(stmt);
   }
 
-  [[nodiscard]] const std::vector<std::shared_ptr<Statement>>&
+  [[nodiscard]] const std::vector<Statement*>&
   get_statements() const noexcept {
     return statements_;
   }
 
 private:
-  std::vector<std::shared_ptr<Statement>> statements_;
+  std::vector<Statement*> statements_;
 };
 
 /**
@@ -329,26 +347,31 @@ private:
  */
 class VarDecl : public Declaration {
 public:
-  VarDecl(const std::string& name, std::shared_ptr<Type> type,
-          std::shared_ptr<Expression> init,
+  VarDecl(utils::InternedString name, Type* type, Expression* init,
           const utils::SourceLocation& location)
       : Declaration(ASTNodeKind::VarDecl, location), name_(name), type_(type),
         init_(init) {}
 
-  [[nodiscard]] const std::string& get_name() const noexcept {
-    return name_;
+  [[nodiscard]] std::string_view get_name() const noexcept {
+    return name_.get_view();
   }
-  [[nodiscard]] std::shared_ptr<Type> get_type_annotation() const noexcept {
+  [[nodiscard]] utils::Symbol get_name_symbol() const noexcept {
+    return name_.get_symbol();
+  }
+  [[nodiscard]] Type* get_type_annotation() const noexcept {
     return type_;
   }
-  [[nodiscard]] std::shared_ptr<Expression> get_initializer() const noexcept {
+  [[nodiscard]] Expression* get_initializer() const noexcept {
     return init_;
   }
+  void set_initializer(Expression* init) noexcept {
+    init_ = init;
+  }
 
 private:
-  std::string name_;
-  std::shared_ptr<Type> type_;       // 可选
-  std::shared_ptr<Expression> init_; // 可选
+  utils::InternedString name_;
+  Type* type_;       // 可选
+  Expression* init_; // 可选
 };
 
 /**
@@ -374,15 +397,19 @@ private:
  */
 class StringLiteral : public Expression {
 public:
-  StringLiteral(const std::string& value, const utils::SourceLocation& location)
+  StringLiteral(utils::InternedString value,
+                const utils::SourceLocation& location)
       : Expression(ASTNodeKind::StringLiteral, location), value_(value) {}
 
-  [[nodiscard]] const std::string& get_value() const noexcept {
-    return value_;
+  [[nodiscard]] std::string_view get_value() const noexcept {
+    return value_.get_view();
+  }
+  [[nodiscard]] utils::Symbol get_value_symbol() const noexcept {
+    return value_.get_symbol();
   }
 
 private:
-  std::string value_;
+  utils::InternedString value_;
 };
 
 /**
@@ -408,7 +435,7 @@ private:
  */
 class UnaryOpExpr : public Expression {
 public:
-  UnaryOpExpr(UnaryOperator op, std::shared_ptr<Expression> operand,
+  UnaryOpExpr(UnaryOperator op, Expression* operand,
               const utils::SourceLocation& location)
       : Expression(ASTNodeKind::UnaryOp, location), op_(op), operand_(operand) {
   }
@@ -416,13 +443,16 @@ public:
   [[nodiscard]] UnaryOperator get_operator() const noexcept {
     return op_;
   }
-  [[nodiscard]] std::shared_ptr<Expression> get_operand() const noexcept {
+  [[nodiscard]] Expression* get_operand() const noexcept {
     return operand_;
   }
+  void set_operand(Expression* operand) noexcept {
+    operand_ = operand;
+  }
 
 private:
   UnaryOperator op_;
-  std::shared_ptr<Expression> operand_;
+  Expression* operand_;
 };
 
 /**
@@ -432,16 +462,15 @@ private:
  */
 class ParenExpr : public Expression {
 public:
-  ParenExpr(std::shared_ptr<Expression> expr,
-            const utils::SourceLocation& location)
+  ParenExpr(Expression* expr, const utils::SourceLocation& location)
       : Expression(ASTNodeKind::ParenExpr, location), expr_(expr) {}
 
-  [[nodiscard]] std::shared_ptr<Expression> get_expression() const noexcept {
+  [[nodiscard]] Expression* get_expression() const noexcept {
     return expr_;
   }
 
 private:
-  std::shared_ptr<Expression> expr_;
+  Expression* expr_;
 };
 
 /**
@@ -451,23 +480,28 @@ private:
  */
 class CallExpr : public Expression {
 public:
-  CallExpr(std::shared_ptr<Expression> callee,
-           std::vector<std::shared_ptr<Expression>> arguments,
+  CallExpr(Expression* callee, std::vector<Expression*> arguments,
            const utils::SourceLocation& location)
       : Expression(ASTNodeKind::CallExpr, location), callee_(callee),
         arguments_(std::move(arguments)) {}
 
-  [[nodiscard]] std::shared_ptr<Expression> get_callee() const noexcept {
+  [[nodiscard]] Expression* get_callee() const noexcept {
     return callee_;
   }
-  [[nodiscard]] const std::vector<std::shared_ptr<Expression>>&
+  [[nodiscard]] const std::vector<Expression*>&
   get_arguments() const noexcept {
     return arguments_;
   }
+  void set_callee(Expression* callee) noexcept {
+    callee_ = callee;
+  }
+  void set_argument(size_t index, Expression* argument) noexcept {
+    arguments_[index] = argument;
+  }
 
 private:
-  std::shared_ptr<Expression> callee_;
-  std::vector<std::shared_ptr<Expression>> arguments_;
+  Expression* callee_;
+  std::vector<Expression*> arguments_;
 };
 
 /**
@@ -477,22 +511,27 @@ private:
  */
 class IndexExpr : public Expression {
 public:
-  IndexExpr(std::shared_ptr<Expression> object,
-            std::shared_ptr<Expression> index,
+  IndexExpr(Expression* object, Expression* index,
             const utils::SourceLocation& location)
       : Expression(ASTNodeKind::IndexExpr, location), object_(object),
         index_(index) {}
 
-  [[nodiscard]] std::shared_ptr<Expression> get_object() const noexcept {
+  [[nodiscard]] Expression* get_object() const noexcept {
     return object_;
   }
-  [[nodiscard]] std::shared_ptr<Expression> get_index() const noexcept {
+  [[nodiscard]] Expression* get_index() const noexcept {
     return index_;
   }
+  void set_object(Expression* object) noexcept {
+    object_ = object;
+  }
+  void set_index(Expression* index) noexcept {
+    index_ = index;
+  }
 
 private:
-  std::shared_ptr<Expression> object_;
-  std::shared_ptr<Expression> index_;
+  Expression* object_;
+  Expression* index_;
 };
 
 /**
@@ -502,21 +541,27 @@ private:
  */
 class MemberExpr : public Expression {
 public:
-  MemberExpr(std::shared_ptr<Expression> object, const std::string& member,
+  MemberExpr(Expression* object, utils::InternedString member,
              const utils::SourceLocation& location)
       : Expression(ASTNodeKind::MemberExpr, location), object_(object),
         member_(member) {}
 
-  [[nodiscard]] std::shared_ptr<Expression> get_object() const noexcept {
+  [[nodiscard]] Expression* get_object() const noexcept {
     return object_;
   }
-  [[nodiscard]] std::string get_member() const noexcept {
-    return member_;
+  [[nodiscard]] std::string_view get_member() const noexcept {
+    return member_.get_view();
+  }
+  [[nodiscard]] utils::Symbol get_member_symbol() const noexcept {
+    return member_.get_symbol();
+  }
+  void set_object(Expression* object) noexcept {
+    object_ = object;
   }
 
 private:
-  std::shared_ptr<Expression> object_;
-  std::string member_;
+  Expression* object_;
+  utils::InternedString member_;
 };
 
 /**
@@ -525,16 +570,18 @@ private:
  */
 class ExprStmt : public Statement {
 public:
-  ExprStmt(std::shared_ptr<Expression> expr,
-           const utils::SourceLocation& location)
+  ExprStmt(Expression* expr, const utils::SourceLocation& location)
       : Statement(ASTNodeKind::ExprStmt, location), expr_(expr) {}
 
-  [[nodiscard]] std::shared_ptr<Expression> get_expression() const noexcept {
+  [[nodiscard]] Expression* get_expression() const noexcept {
     return expr_;
   }
+  void set_expression(Expression* expr) noexcept {
+    expr_ = expr;
+  }
 
 private:
-  std::shared_ptr<Expression> expr_;
+  Expression* expr_;
 };
 
 /**
@@ -543,16 +590,18 @@ private:
  */
 class ReturnStmt : public Statement {
 public:
-  ReturnStmt(std::shared_ptr<Expression> value,
-             const utils::SourceLocation& location)
+  ReturnStmt(Expression* value, const utils::SourceLocation& location)
       : Statement(ASTNodeKind::ReturnStmt, location), value_(value) {}
 
-  [[nodiscard]] std::shared_ptr<Expression> get_value() const noexcept {
+  [[nodiscard]] Expression* get_value() const noexcept {
     return value_;
   }
+  void set_value(Expression* value) noexcept {
+    value_ = value;
+  }
 
 private:
-  std::shared_ptr<Expression> value_; // 可选
+  Expression* value_; // 可选
 };
 
 /**
@@ -561,27 +610,28 @@ private:
  */
 class IfStmt : public Statement {
 public:
-  IfStmt(std::shared_ptr<Expression> condition,
-         std::shared_ptr<Statement> then_branch,
-         std::shared_ptr<Statement> else_branch,
+  IfStmt(Expression* condition, Statement* then_branch, Statement* else_branch,
          const utils::SourceLocation& location)
       : Statement(ASTNodeKind::IfStmt, location), condition_(condition),
         then_branch_(then_branch), else_branch_(else_branch) {}
 
-  [[nodiscard]] std::shared_ptr<Expression> get_condition() const noexcept {
+  [[nodiscard]] Expression* get_condition() const noexcept {
     return condition_;
   }
-  [[nodiscard]] std::shared_ptr<Statement> get_then_branch() const noexcept {
+  void set_condition(Expression* condition) noexcept {
+    condition_ = condition;
+  }
+  [[nodiscard]] Statement* get_then_branch() const noexcept {
     return then_branch_;
   }
-  [[nodiscard]] std::shared_ptr<Statement> get_else_branch() const noexcept {
+  [[nodiscard]] Statement* get_else_branch() const noexcept {
     return else_branch_;
   }
 
 private:
-  std::shared_ptr<Expression> condition_;
-  std::shared_ptr<Statement> then_branch_;
-  std::shared_ptr<Statement> else_branch_; // 可选
+  Expression* condition_;
+  Statement* then_branch_;
+  Statement* else_branch_; // 可选
 };
 
 /**
@@ -590,20 +640,23 @@ private:
  */
 class Parameter : public ASTNode {
 public:
-  Parameter(const std::string& name, std::shared_ptr<Type> type,
+  Parameter(utils::InternedString name, Type* type,
             const utils::SourceLocation& location)
-      : ASTNode(ASTNodeKind::VarDecl, location), name_(name), type_(type) {}
+      : ASTNode(ASTNodeKind::Parameter, location), name_(name), type_(type) {}
 
-  [[nodiscard]] const std::string& get_name() const noexcept {
-    return name_;
+  [[nodiscard]] std::string_view get_name() const noexcept {
+    return name_.get_view();
+  }
+  [[nodiscard]] utils::Symbol get_name_symbol() const noexcept {
+    return name_.get_symbol();
   }
-  [[nodiscard]] std::shared_ptr<Type> get_type() const noexcept {
+  [[nodiscard]] Type* get_type() const noexcept {
     return type_;
   }
 
 private:
-  std::string name_;
-  std::shared_ptr<Type> type_; // 可选
+  utils::InternedString name_;
+  Type* type_; // 可选
 };
 
 /**
@@ -612,33 +665,36 @@ private:
  */
 class FunctionDecl : public Declaration {
 public:
-  FunctionDecl(const std::string& name,
-               std::vector<std::shared_ptr<Parameter>> parameters,
-               std::shared_ptr<Type> return_type,
-               std::shared_ptr<BlockStmt> body,
+  FunctionDecl(utils::InternedString name,
+               std::vector<Parameter*> parameters,
+               Type* return_type, BlockStmt* body,
                const utils::SourceLocation& location)
       : Declaration(ASTNodeKind::FunctionDecl, location), name_(name),
-        parameters_(parameters), return_type_(return_type), body_(body) {}
+        parameters_(std::move(parameters)), return_type_(return_type),
+        body_(body) {}
 
-  [[nodiscard]] const std::string& get_name() const noexcept {
-    return name_;
+  [[nodiscard]] std::string_view get_name() const noexcept {
+    return name_.get_view();
   }
-  [[nodiscard]] const std::vector<std::shared_ptr<Parameter>>&
+  [[nodiscard]] utils::Symbol get_name_symbol() const noexcept {
+    return name_.get_symbol();
+  }
+  [[nodiscard]] const std::vector<Parameter*>&
   get_parameters() const noexcept {
     return parameters_;
   }
-  [[nodiscard]] std::shared_ptr<Type> get_return_type() const noexcept {
+  [[nodiscard]] Type* get_return_type() const noexcept {
     return return_type_;
   }
-  [[nodiscard]] std::shared_ptr<BlockStmt> get_body() const noexcept {
+  [[nodiscard]] BlockStmt* get_body() const noexcept {
     return body_;
   }
 
 private:
-  std::string name_;
-  std::vector<std::shared_ptr<Parameter>> parameters_;
-  std::shared_ptr<Type> return_type_; // 可选
-  std::shared_ptr<BlockStmt> body_;
+  utils::InternedString name_;
+  std::vector<Parameter*> parameters_;
+  Type* return_type_; // 可选
+  BlockStmt* body_;
 };
 
 /**
@@ -648,20 +704,23 @@ private:
  */
 class StructField : public ASTNode {
 public:
-  StructField(const std::string& name, std::shared_ptr<Type> type,
+  StructField(utils::InternedString name, Type* type,
               const utils::SourceLocation& loc)
       : ASTNode(ASTNodeKind::StructField, loc), name_(name), type_(type) {}
 
-  [[nodiscard]] std::string get_name() const noexcept {
-    return name_;
+  [[nodiscard]] std::string_view get_name() const noexcept {
+    return name_.get_view();
+  }
+  [[nodiscard]] utils::Symbol get_name_symbol() const noexcept {
+    return name_.get_symbol();
   }
-  [[nodiscard]] std::shared_ptr<Type> get_type() const noexcept {
+  [[nodiscard]] Type* get_type() const noexcept {
     return type_;
   }
 
 private:
-  std::string name_;
-  std::shared_ptr<Type> type_;
+  utils::InternedString name_;
+  Type* type_;
 };
 
 /**
@@ -671,23 +730,25 @@ private:
  */
 class StructDecl : public Declaration {
 public:
-  StructDecl(const std::string& name,
-             std::vector<std::shared_ptr<StructField>> fields,
+  StructDecl(utils::InternedString name, std::vector<StructField*> fields,
              const utils::SourceLocation& loc)
       : Declaration(ASTNodeKind::StructDecl, loc), name_(name),
         fields_(std::move(fields)) {}
 
-  [[nodiscard]] std::string get_name() const noexcept {
-    return name_;
+  [[nodiscard]] std::string_view get_name() const noexcept {
+    return name_.get_view();
+  }
+  [[nodiscard]] utils::Symbol get_name_symbol() const noexcept {
+    return name_.get_symbol();
   }
-  [[nodiscard]] const std::vector<std::shared_ptr<StructField>>&
+  [[nodiscard]] const std::vector<StructField*>&
   get_fields() const noexcept {
     return fields_;
   }
 
 private:
-  std::string name_;
-  std::vector<std::shared_ptr<StructField>> fields_;
+  utils::InternedString name_;
+  std::vector<StructField*> fields_;
 };
 
 // 更多具体节点类型将在后续实现中添加...
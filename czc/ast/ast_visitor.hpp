@@ -1,7 +1,10 @@
 /**
  * @file ast_visitor.hpp
  * @brief AST 访问者模式接口
- * @details 提供访问者模式的抽象接口，用于遍历和处理 AST
+ * @details
+ *   提供访问者模式的抽象接口，用于遍历和处理 AST。
+ *   虚函数分派建立在 `visit_node`（见 ast_walker.hpp）之上；对性能敏感的
+ *   多遍分析应直接使用可内联的 `ASTWalker`。
  * @author BegoniaHe
  * @date 2025-11-13
  */
@@ -9,11 +12,10 @@
 #ifndef CZC_AST_VISITOR_HPP
 #define CZC_AST_VISITOR_HPP
 
-#include <memory>
-
 namespace czc::ast {
 
 // 前向声明所有 AST 节点类型
+class ASTNode;
 class Program;
 class Identifier;
 class IntegerLiteral;
@@ -22,6 +24,10 @@ class StringLiteral;
 class BooleanLiteral;
 class BinaryOpExpr;
 class UnaryOpExpr;
+class CallExpr;
+class IndexExpr;
+class MemberExpr;
+class ParenExpr;
 class BlockStmt;
 class ExprStmt;
 class ReturnStmt;
@@ -30,6 +36,7 @@ class VarDecl;
 class FunctionDecl;
 class StructDecl;
 class StructField;
+class Parameter;
 
 /**
  * @class ASTVisitor
@@ -58,6 +65,10 @@ public:
   virtual void visit_boolean_literal(BooleanLiteral* node) = 0;
   virtual void visit_binary_op(BinaryOpExpr* node) = 0;
   virtual void visit_unary_op(UnaryOpExpr* node) = 0;
+  virtual void visit_call_expr(CallExpr* node) = 0;
+  virtual void visit_index_expr(IndexExpr* node) = 0;
+  virtual void visit_member_expr(MemberExpr* node) = 0;
+  virtual void visit_paren_expr(ParenExpr* node) = 0;
 
   // === 语句 ===
   virtual void visit_block_stmt(BlockStmt* node) = 0;
@@ -70,8 +81,25 @@ public:
   virtual void visit_function_decl(FunctionDecl* node) = 0;
   virtual void visit_struct_decl(StructDecl* node) = 0;
   virtual void visit_struct_field(StructField* node) = 0;
+  virtual void visit_parameter(Parameter* node) = 0;
 };
 
+/**
+ * @brief 以节点的具体类型调用访问者中对应的方法
+ * @details 只访问 `node` 本身；尚无具体节点类的种类不调用任何方法
+ * @param node 要访问的节点，可以为空
+ * @param visitor 访问者
+ */
+void accept(ASTNode* node, ASTVisitor& visitor);
+
+/**
+ * @brief 先序遍历以 `root` 为根的整棵树，对每个节点调用访问者
+ * @details 由 `ASTWalker` 驱动，访问者无需自行递归
+ * @param root 根节点，可以为空
+ * @param visitor 访问者
+ */
+void walk(ASTNode* root, ASTVisitor& visitor);
+
 /**
  * @class ASTBaseVisitor
  * @brief AST 访问者基类
@@ -92,6 +120,10 @@ public:
   void visit_boolean_literal(BooleanLiteral* node) override {}
   void visit_binary_op(BinaryOpExpr* node) override {}
   void visit_unary_op(UnaryOpExpr* node) override {}
+  void visit_call_expr(CallExpr* /*node*/) override {}
+  void visit_index_expr(IndexExpr* /*node*/) override {}
+  void visit_member_expr(MemberExpr* /*node*/) override {}
+  void visit_paren_expr(ParenExpr* /*node*/) override {}
   void visit_block_stmt(BlockStmt* node) override {}
   void visit_expr_stmt(ExprStmt* node) override {}
   void visit_return_stmt(ReturnStmt* node) override {}
@@ -100,6 +132,7 @@ public:
   void visit_function_decl(FunctionDecl* node) override {}
   void visit_struct_decl(StructDecl* node) override {}
   void visit_struct_field(StructField* node) override {}
+  void visit_parameter(Parameter* /*node*/) override {}
 };
 
 /**
@@ -0,0 +1,364 @@
+/**
+ * @file ast_walker.hpp
+ * @brief 按 `ASTNodeKind` 静态分派的 AST 访问与遍历
+ * @details
+ *   `visit_node` 根据节点的 `ASTNodeKind` 把节点转换为具体类型后交给
+ *   可调用对象，`ASTWalker` 在此之上提供 CRTP 形式的先序/后序遍历。
+ *   两者都不经过虚函数，编译器可以把整条遍历连同派生类的回调一起内联，
+ *   适合需要多遍扫描 AST 的分析阶段。
+ *
+ *   虚函数形式的 `ASTVisitor`（见 ast_visitor.hpp）保留为一层薄适配：
+ *   `accept` 与 `walk` 都建立在这里的分派之上。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_AST_WALKER_HPP
+#define CZC_AST_WALKER_HPP
+
+#include "czc/ast/ast_node.hpp"
+
+namespace czc::ast {
+
+/**
+ * @brief 以节点的具体类型调用 `func`。
+ * @details
+ *   对有具体节点类的种类调用 `func(static_cast<T*>(node))`；
+ *   尚无具体节点类的种类（如各种类型节点）以 `func(node)` 调用。
+ *   所有分支的返回类型必须相同。
+ * @param node 非空节点
+ * @param func 接受各具体节点指针的可调用对象（通常是泛型 lambda）
+ */
+template <typename Func>
+decltype(auto) visit_node(ASTNode* node, Func&& func) {
+  switch (node->get_kind()) {
+  case ASTNodeKind::Program:
+    return func(static_cast<Program*>(node));
+  case ASTNodeKind::VarDecl:
+    return func(static_cast<VarDecl*>(node));
+  case ASTNodeKind::FunctionDecl:
+    return func(static_cast<FunctionDecl*>(node));
+  case ASTNodeKind::StructDecl:
+    return func(static_cast<StructDecl*>(node));
+  case ASTNodeKind::StructField:
+    return func(static_cast<StructField*>(node));
+  case ASTNodeKind::Parameter:
+    return func(static_cast<Parameter*>(node));
+  case ASTNodeKind::BlockStmt:
+    return func(static_cast<BlockStmt*>(node));
+  case ASTNodeKind::ExprStmt:
+    return func(static_cast<ExprStmt*>(node));
+  case ASTNodeKind::ReturnStmt:
+    return func(static_cast<ReturnStmt*>(node));
+  case ASTNodeKind::IfStmt:
+    return func(static_cast<IfStmt*>(node));
+  case ASTNodeKind::IntegerLiteral:
+    return func(static_cast<IntegerLiteral*>(node));
+  case ASTNodeKind::FloatLiteral:
+    return func(static_cast<FloatLiteral*>(node));
+  case ASTNodeKind::StringLiteral:
+    return func(static_cast<StringLiteral*>(node));
+  case ASTNodeKind::BooleanLiteral:
+    return func(static_cast<BooleanLiteral*>(node));
+  case ASTNodeKind::Identifier:
+    return func(static_cast<Identifier*>(node));
+  case ASTNodeKind::BinaryOp:
+    return func(static_cast<BinaryOpExpr*>(node));
+  case ASTNodeKind::UnaryOp:
+    return func(static_cast<UnaryOpExpr*>(node));
+  case ASTNodeKind::CallExpr:
+    return func(static_cast<CallExpr*>(node));
+  case ASTNodeKind::IndexExpr:
+    return func(static_cast<IndexExpr*>(node));
+  case ASTNodeKind::MemberExpr:
+    return func(static_cast<MemberExpr*>(node));
+  case ASTNodeKind::ParenExpr:
+    return func(static_cast<ParenExpr*>(node));
+  default:
+    return func(node);
+  }
+}
+
+/**
+ * @class ASTWalker
+ * @brief CRTP 形式的 AST 先序/后序遍历器
+ * @details
+ *   派生类以 `class MyPass : public ASTWalker<MyPass>` 的形式继承，并按需
+ *   定义同名的回调来隐藏默认实现（无需 virtual）：
+ *   - `bool enter_xxx(T* node)`：先序回调，返回 false 时跳过该节点的子节点；
+ *   - `void leave_xxx(T* node)`：后序回调，在子节点之后调用（即使被跳过）。
+ *   空的子节点指针会被忽略，尚无具体节点类的种类不会触发任何回调。
+ *
+ * @tparam Derived 派生类自身
+ */
+template <typename Derived> class ASTWalker {
+public:
+  /**
+   * @brief 从 `node` 开始遍历，`node` 可以为空
+   */
+  void walk(ASTNode* node) {
+    if (node == nullptr) {
+      return;
+    }
+    visit_node(node, [this](auto* concrete) { walk_node(concrete); });
+  }
+
+  // === 默认回调：进入时继续遍历，离开时什么都不做 ===
+  bool enter_program(Program*) {
+    return true;
+  }
+  void leave_program(Program*) {}
+  bool enter_var_decl(VarDecl*) {
+    return true;
+  }
+  void leave_var_decl(VarDecl*) {}
+  bool enter_function_decl(FunctionDecl*) {
+    return true;
+  }
+  void leave_function_decl(FunctionDecl*) {}
+  bool enter_struct_decl(StructDecl*) {
+    return true;
+  }
+  void leave_struct_decl(StructDecl*) {}
+  bool enter_struct_field(StructField*) {
+    return true;
+  }
+  void leave_struct_field(StructField*) {}
+  bool enter_parameter(Parameter*) {
+    return true;
+  }
+  void leave_parameter(Parameter*) {}
+  bool enter_block_stmt(BlockStmt*) {
+    return true;
+  }
+  void leave_block_stmt(BlockStmt*) {}
+  bool enter_expr_stmt(ExprStmt*) {
+    return true;
+  }
+  void leave_expr_stmt(ExprStmt*) {}
+  bool enter_return_stmt(ReturnStmt*) {
+    return true;
+  }
+  void leave_return_stmt(ReturnStmt*) {}
+  bool enter_if_stmt(IfStmt*) {
+    return true;
+  }
+  void leave_if_stmt(IfStmt*) {}
+  bool enter_integer_literal(IntegerLiteral*) {
+    return true;
+  }
+  void leave_integer_literal(IntegerLiteral*) {}
+  bool enter_float_literal(FloatLiteral*) {
+    return true;
+  }
+  void leave_float_literal(FloatLiteral*) {}
+  bool enter_string_literal(StringLiteral*) {
+    return true;
+  }
+  void leave_string_literal(StringLiteral*) {}
+  bool enter_boolean_literal(BooleanLiteral*) {
+    return true;
+  }
+  void leave_boolean_literal(BooleanLiteral*) {}
+  bool enter_identifier(Identifier*) {
+    return true;
+  }
+  void leave_identifier(Identifier*) {}
+  bool enter_binary_op(BinaryOpExpr*) {
+    return true;
+  }
+  void leave_binary_op(BinaryOpExpr*) {}
+  bool enter_unary_op(UnaryOpExpr*) {
+    return true;
+  }
+  void leave_unary_op(UnaryOpExpr*) {}
+  bool enter_call_expr(CallExpr*) {
+    return true;
+  }
+  void leave_call_expr(CallExpr*) {}
+  bool enter_index_expr(IndexExpr*) {
+    return true;
+  }
+  void leave_index_expr(IndexExpr*) {}
+  bool enter_member_expr(MemberExpr*) {
+    return true;
+  }
+  void leave_member_expr(MemberExpr*) {}
+  bool enter_paren_expr(ParenExpr*) {
+    return true;
+  }
+  void leave_paren_expr(ParenExpr*) {}
+
+protected:
+  ASTWalker() = default;
+
+private:
+  Derived& derived() noexcept {
+    return static_cast<Derived&>(*this);
+  }
+
+  // NOTE: 以下每个重载先调用先序回调，再按源码顺序遍历子节点，
+  //       最后调用后序回调。
+
+  void walk_node(Program* node) {
+    if (derived().enter_program(node)) {
+      for (auto* decl : node->get_declarations()) {
+        walk(decl);
+      }
+    }
+    derived().leave_program(node);
+  }
+
+  void walk_node(VarDecl* node) {
+    if (derived().enter_var_decl(node)) {
+      walk(node->get_type_annotation());
+      walk(node->get_initializer());
+    }
+    derived().leave_var_decl(node);
+  }
+
+  void walk_node(FunctionDecl* node) {
+    if (derived().enter_function_decl(node)) {
+      for (auto* param : node->get_parameters()) {
+        walk(param);
+      }
+      walk(node->get_return_type());
+      walk(node->get_body());
+    }
+    derived().leave_function_decl(node);
+  }
+
+  void walk_node(StructDecl* node) {
+    if (derived().enter_struct_decl(node)) {
+      for (auto* field : node->get_fields()) {
+        walk(field);
+      }
+    }
+    derived().leave_struct_decl(node);
+  }
+
+  void walk_node(StructField* node) {
+    if (derived().enter_struct_field(node)) {
+      walk(node->get_type());
+    }
+    derived().leave_struct_field(node);
+  }
+
+  void walk_node(Parameter* node) {
+    if (derived().enter_parameter(node)) {
+      walk(node->get_type());
+    }
+    derived().leave_parameter(node);
+  }
+
+  void walk_node(BlockStmt* node) {
+    if (derived().enter_block_stmt(node)) {
+      for (auto* stmt : node->get_statements()) {
+        walk(stmt);
+      }
+    }
+    derived().leave_block_stmt(node);
+  }
+
+  void walk_node(ExprStmt* node) {
+    if (derived().enter_expr_stmt(node)) {
+      walk(node->get_expression());
+    }
+    derived().leave_expr_stmt(node);
+  }
+
+  void walk_node(ReturnStmt* node) {
+    if (derived().enter_return_stmt(node)) {
+      walk(node->get_value());
+    }
+    derived().leave_return_stmt(node);
+  }
+
+  void walk_node(IfStmt* node) {
+    if (derived().enter_if_stmt(node)) {
+      walk(node->get_condition());
+      walk(node->get_then_branch());
+      walk(node->get_else_branch());
+    }
+    derived().leave_if_stmt(node);
+  }
+
+  void walk_node(IntegerLiteral* node) {
+    derived().enter_integer_literal(node);
+    derived().leave_integer_literal(node);
+  }
+
+  void walk_node(FloatLiteral* node) {
+    derived().enter_float_literal(node);
+    derived().leave_float_literal(node);
+  }
+
+  void walk_node(StringLiteral* node) {
+    derived().enter_string_literal(node);
+    derived().leave_string_literal(node);
+  }
+
+  void walk_node(BooleanLiteral* node) {
+    derived().enter_boolean_literal(node);
+    derived().leave_boolean_literal(node);
+  }
+
+  void walk_node(Identifier* node) {
+    derived().enter_identifier(node);
+    derived().leave_identifier(node);
+  }
+
+  void walk_node(BinaryOpExpr* node) {
+    if (derived().enter_binary_op(node)) {
+      walk(node->get_left());
+      walk(node->get_right());
+    }
+    derived().leave_binary_op(node);
+  }
+
+  void walk_node(UnaryOpExpr* node) {
+    if (derived().enter_unary_op(node)) {
+      walk(node->get_operand());
+    }
+    derived().leave_unary_op(node);
+  }
+
+  void walk_node(CallExpr* node) {
+    if (derived().enter_call_expr(node)) {
+      walk(node->get_callee());
+      for (auto* arg : node->get_arguments()) {
+        walk(arg);
+      }
+    }
+    derived().leave_call_expr(node);
+  }
+
+  void walk_node(IndexExpr* node) {
+    if (derived().enter_index_expr(node)) {
+      walk(node->get_object());
+      walk(node->get_index());
+    }
+    derived().leave_index_expr(node);
+  }
+
+  void walk_node(MemberExpr* node) {
+    if (derived().enter_member_expr(node)) {
+      walk(node->get_object());
+    }
+    derived().leave_member_expr(node);
+  }
+
+  void walk_node(ParenExpr* node) {
+    if (derived().enter_paren_expr(node)) {
+      walk(node->get_expression());
+    }
+    derived().leave_paren_expr(node);
+  }
+
+  // 尚无具体节点类的种类：没有可遍历的子节点。
+  void walk_node(ASTNode*) {}
+};
+
+} // namespace czc::ast
+
+#endif // CZC_AST_WALKER_HPP
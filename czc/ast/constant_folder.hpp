@@ -0,0 +1,109 @@
+/**
+ * @file constant_folder.hpp
+ * @brief 常量折叠与字面量规范化的 AST 变换 `ConstantFolder`
+ * @details
+ *   把只由字面量与运算符组成的子表达式就地替换为一个字面量节点，并去掉
+ *   全部 `ParenExpr` 包装（树的结构已经表达了优先级），例如
+ *   `let x = (1 + 2) * -3;` 变为 `let x = -9;`，`f(x + (2 * 4))` 变为
+ *   `f(x + 8)`。这一遍是可选的，由需要更小的树的调用方显式运行。
+ *
+ *   数值的类型与溢出规则与科学计数法字面量的类型推断一致（见
+ *   `token_preprocessor::ScientificNotationAnalyzer`）：整数运算的结果
+ *   超出 `int64_t` 时按 `InferredNumericType::FLOAT` 表示；超出 float64
+ *   范围（`token_preprocessor::MAX_F64_MAGNITUDE`）的结果视为溢出，保留
+ *   原表达式不折叠。
+ *
+ *   语言尚未规定整数除法与取模的语义，因此只折叠各种语义下结果都相同的
+ *   情形：能整除的除法，以及两个操作数都非负的取模。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_AST_CONSTANT_FOLDER_HPP
+#define CZC_AST_CONSTANT_FOLDER_HPP
+
+#include "czc/ast/ast_context.hpp"
+#include "czc/ast/ast_node.hpp"
+#include "czc/ast/ast_visitor.hpp"
+
+#include <cstddef>
+
+namespace czc::ast {
+
+/**
+ * @brief 一次常量折叠的工作量。
+ */
+struct ConstantFoldStats {
+  // 被替换为字面量的运算表达式数
+  size_t folded_expressions = 0;
+  // 去掉的括号表达式数
+  size_t collapsed_parens = 0;
+  // 整数结果超出 int64_t、改用浮点数表示的次数
+  size_t promoted_to_float = 0;
+  // 结果超出 float64 范围或除数为零而未折叠的运算数
+  size_t overflowed = 0;
+};
+
+/**
+ * @class ConstantFolder
+ * @brief 就地折叠常量子表达式的访问者
+ * @details
+ *   由 `ast::walk` 先序驱动：访问每个持有表达式的节点时，先把它的直接
+ *   子表达式整个折叠，再继续遍历折叠后的子树，因此嵌在调用参数、索引
+ *   等位置里的常量也会被折叠。新的字面量节点在 `context` 中创建，
+ *   被替换下来的节点仍由上下文持有，随上下文一起释放。
+ *
+ * @property {线程安全} 非线程安全。
+ */
+class ConstantFolder : public ASTBaseVisitor {
+public:
+  /**
+   * @param[in] context 创建新字面量节点的上下文，通常就是树所在的上下文。
+   */
+  explicit ConstantFolder(ASTContext& context) noexcept : context_(context) {}
+
+  /**
+   * @brief 折叠以 `root` 为根的整棵树，`root` 可以为空。
+   */
+  void run(ASTNode* root);
+
+  /**
+   * @brief 折叠一棵表达式树，返回替换它的表达式。
+   * @details 只处理运算符与括号构成的部分；返回值可能就是 `expr` 本身。
+   * @param[in] expr 表达式，可以为空。
+   */
+  Expression* fold(Expression* expr);
+
+  /**
+   * @brief 获取自构造以来的累计工作量。
+   */
+  [[nodiscard]] const ConstantFoldStats& get_stats() const noexcept {
+    return stats_;
+  }
+
+  void visit_var_decl(VarDecl* node) override;
+  void visit_expr_stmt(ExprStmt* node) override;
+  void visit_return_stmt(ReturnStmt* node) override;
+  void visit_if_stmt(IfStmt* node) override;
+  void visit_call_expr(CallExpr* node) override;
+  void visit_index_expr(IndexExpr* node) override;
+  void visit_member_expr(MemberExpr* node) override;
+
+private:
+  /**
+   * @brief 两个操作数都已折叠后，尝试把二元运算替换为字面量。
+   */
+  Expression* fold_binary(BinaryOpExpr* node);
+
+  /**
+   * @brief 操作数已折叠后，尝试把一元运算替换为字面量。
+   */
+  Expression* fold_unary(UnaryOpExpr* node);
+
+  ASTContext& context_;
+  ConstantFoldStats stats_;
+};
+
+} // namespace czc::ast
+
+#endif // CZC_AST_CONSTANT_FOLDER_HPP
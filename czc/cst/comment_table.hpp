@@ -0,0 +1,167 @@
+/**
+ * @file comment_table.hpp
+ * @brief 定义了在 CST 之外保存注释的侧表 `CommentTable`。
+ * @details
+ *   默认情况下注释作为 `Comment` 节点与真正的子节点混在一起，每个消费者
+ *   （`ASTBuilder`、格式化器、各种遍历）都得逐个跳过它们。给 Parser 设置
+ *   注释表后（见 `Parser::set_comment_table`），注释不再进入树中，而是按
+ *   所附着的节点记录在这里：树更小，遍历也不必再判断节点类型，需要注释
+ *   的格式化器再按节点查询。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_CST_COMMENT_TABLE_HPP
+#define CZC_CST_COMMENT_TABLE_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/token.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace czc::cst {
+
+/**
+ * @brief 注释相对于所附着节点的位置。
+ */
+enum class CommentPlacement : uint8_t {
+  Leading,  ///< 独占一行、位于节点之前的注释
+  Trailing, ///< 与节点在同一行、位于节点之后的行内注释
+  Dangling, ///< 位于容器最后一个元素之后、右括号之前的注释
+};
+
+/**
+ * @brief 附着在同一节点同一位置上的一组注释，按源码顺序排列。
+ */
+class CommentRange {
+public:
+  CommentRange() noexcept = default;
+
+  CommentRange(const lexer::Token* first, size_t count) noexcept
+      : first(first), count(count) {}
+
+  [[nodiscard]] const lexer::Token* begin() const noexcept {
+    return first;
+  }
+
+  [[nodiscard]] const lexer::Token* end() const noexcept {
+    return first + count;
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return count;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return count == 0;
+  }
+
+private:
+  const lexer::Token* first{nullptr};
+  size_t count{0};
+};
+
+/**
+ * @brief 以"节点 + 位置"为键保存注释 Token 的侧表。
+ * @details
+ *   Parser 的附着规则：
+ *   - 语句、声明之后同一行的注释是该节点的 `Trailing` 注释；
+ *   - 代码块、结构体字段列表、结构体字面量字段列表以及顶层中独占一行的
+ *     注释是其后第一个元素的 `Leading` 注释（结构体字面量的元素是字段名的
+ *     `Identifier` 节点）；
+ *   - 之后再没有元素的注释是容器（`StatementList`、`StructDeclaration`、
+ *     `StructLiteral`）的 `Dangling` 注释；顶层末尾的注释附着在空指针上，
+ *     表示文件末尾。
+ *
+ *   注释 Token 集中存放在一个向量中，每组注释占据其中连续的一段，查询
+ *   只需一次哈希查找。
+ *
+ * @property {生命周期} 键是节点的地址：表只对填充它的那棵树有效，节点被
+ *           释放或移动到其他树后对应的条目失效。`get` 返回的范围在下一次
+ *           `attach` 之前有效。
+ * @property {线程安全} 非线程安全；填充完毕后只读访问是线程安全的。
+ */
+class CommentTable {
+public:
+  /**
+   * @brief 在 `anchor` 的 `placement` 位置追加一条注释。
+   * @details 同一组的注释应按源码顺序追加。
+   * @param[in] anchor    所附着的节点；为空表示文件末尾。
+   * @param[in] placement 注释相对于节点的位置。
+   * @param[in] comment   注释 Token。
+   */
+  void attach(const CSTNode* anchor, CommentPlacement placement,
+              const lexer::Token& comment);
+
+  /**
+   * @brief 获取附着在 `anchor` 的 `placement` 位置上的注释。
+   */
+  [[nodiscard]] CommentRange get(const CSTNode* anchor,
+                                 CommentPlacement placement) const;
+
+  [[nodiscard]] CommentRange leading(const CSTNode* anchor) const {
+    return get(anchor, CommentPlacement::Leading);
+  }
+
+  [[nodiscard]] CommentRange trailing(const CSTNode* anchor) const {
+    return get(anchor, CommentPlacement::Trailing);
+  }
+
+  [[nodiscard]] CommentRange dangling(const CSTNode* anchor) const {
+    return get(anchor, CommentPlacement::Dangling);
+  }
+
+  /**
+   * @brief 获取表中的注释总数。
+   */
+  [[nodiscard]] size_t size() const noexcept {
+    return count;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return count == 0;
+  }
+
+  /**
+   * @brief 清空表，保留已分配的容量。
+   */
+  void clear() noexcept {
+    comments.clear();
+    groups.clear();
+    count = 0;
+  }
+
+private:
+  struct Key {
+    const CSTNode* anchor;
+    CommentPlacement placement;
+
+    bool operator==(const Key& other) const noexcept {
+      return anchor == other.anchor && placement == other.placement;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const noexcept;
+  };
+
+  // 一组注释在 `comments` 中的区间
+  struct Group {
+    uint32_t begin;
+    uint32_t size;
+  };
+
+  // 全部注释 Token；一组注释被后来者隔开时整组移到末尾，留下的旧副本
+  // 不再被引用
+  std::vector<lexer::Token> comments;
+  std::unordered_map<Key, Group, KeyHash> groups;
+  // 有效的注释数（不含被移走的旧副本）
+  size_t count{0};
+};
+
+} // namespace czc::cst
+
+#endif // CZC_CST_COMMENT_TABLE_HPP
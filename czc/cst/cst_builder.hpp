@@ -55,7 +55,8 @@ public:
   [[nodiscard]] static std::unique_ptr<CSTNode>
   create_node(CSTNodeType type, const lexer::Token& token) {
     auto node = create_node(
-        type, utils::SourceLocation(token.value, token.line, token.column));
+        type, utils::SourceLocation(utils::UNKNOWN_FILE_ID, token.line,
+                                    token.column));
     node->set_token(token);
     return node;
   }
@@ -0,0 +1,130 @@
+/**
+ * @file cst_cache.hpp
+ * @brief 定义了 Token 序列与 CST 的二进制序列化格式，以及按源码哈希
+ *        索引的磁盘缓存 `CSTCache`。
+ * @details
+ *   格式由三部分组成：
+ *   - 头部：魔数、格式版本、内容种类（Token 序列或 CST）、czc 版本字符串、
+ *     源码的 FNV-1a 哈希与字节数，以及其后全部数据（字符串表与正文）的
+ *     FNV-1a 校验和。任何一项与当前不符的数据都被拒绝；校验和使损坏但
+ *     恰好仍能解码的数据同样视为未命中，而不是被当作有效的树使用。
+ *   - 字符串表：去重后的 Token 文本。与源码区间 `[offset, offset + length)`
+ *     完全相同的文本不进入字符串表，载入时直接从源码切出。
+ *   - 正文：按前序排列的节点（或顺序排列的 Token），所有整数都是 LEB128
+ *     变长编码；行号与字节偏移量记为与前一项之差（zigzag 编码），因此
+ *     节点类型、位置与子节点数大多只占一个字节。
+ *
+ *   解码直接读取给定的字节区间，没有任何中间缓冲；`CSTCache::load` 把缓存
+ *   文件交给 `utils::SourceBuffer` 打开，大文件因此是内存映射后零拷贝解码。
+ *   所有读取都做越界检查，截断或损坏的数据只会让解码失败，不会越界访问。
+ *
+ *   解码以显式栈进行，很深的树也不会耗尽调用栈。Token 的驻留句柄
+ *   （`symbol`）不被保存，载入后为无效句柄。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_CST_CACHE_HPP
+#define CZC_CST_CACHE_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/token.hpp"
+#include "czc/utils/source_location.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::cst {
+
+// 二进制格式的版本号，布局改变时递增。
+inline constexpr uint32_t CST_CACHE_FORMAT_VERSION = 2;
+
+/**
+ * @brief 计算源码的 FNV-1a 64 位哈希，作为缓存的键。
+ */
+[[nodiscard]] uint64_t hash_source(std::string_view source) noexcept;
+
+/**
+ * @brief 把一棵 CST 序列化为二进制数据。
+ * @param[in] root    根节点，不能为空。
+ * @param[in] source  构建这棵树的源码，Token 文本与其比对以省去字符串表项。
+ * @param[in] version czc 的版本字符串，写入头部。
+ */
+[[nodiscard]] std::string serialize_cst(const CSTNode* root,
+                                        std::string_view source,
+                                        std::string_view version);
+
+/**
+ * @brief 从二进制数据还原一棵 CST。
+ * @param[in] data    `serialize_cst` 产生的数据。
+ * @param[in] source  当前的源码；其哈希或长度与头部不符时拒绝。
+ * @param[in] version 当前的 czc 版本字符串；与头部不符时拒绝。
+ * @param[in] file_id 还原出的所有位置所属的文件。
+ * @return 成功时返回根节点（在堆上分配）；数据不匹配或已损坏时返回空。
+ */
+[[nodiscard]] std::unique_ptr<CSTNode>
+deserialize_cst(std::string_view data, std::string_view source,
+                std::string_view version, utils::FileId file_id);
+
+/**
+ * @brief 把一个 Token 序列序列化为二进制数据，参数含义同 `serialize_cst`。
+ */
+[[nodiscard]] std::string
+serialize_tokens(const std::vector<lexer::Token>& tokens,
+                 std::string_view source, std::string_view version);
+
+/**
+ * @brief 从二进制数据还原一个 Token 序列，参数含义同 `deserialize_cst`。
+ * @return 成功时返回 Token 序列；数据不匹配或已损坏时返回空。
+ */
+[[nodiscard]] std::optional<std::vector<lexer::Token>>
+deserialize_tokens(std::string_view data, std::string_view source,
+                   std::string_view version);
+
+/**
+ * @brief 以源码哈希为键、保存序列化 CST 的缓存目录。
+ * @details
+ *   每个条目是目录下的一个 `<哈希>.cst` 文件。内容相同的文件共用同一个
+ *   条目，载入时位置改属调用方给出的文件。条目以原子替换的方式写入，
+ *   多个进程或线程同时读写同一目录是安全的。
+ * @property {线程安全} 所有成员函数都是 const 的，可以并发调用。
+ */
+class CSTCache {
+public:
+  /**
+   * @brief 以一个已存在的目录构造缓存。
+   * @param[in] directory 缓存目录。
+   * @param[in] version   czc 的版本字符串，版本不同的条目视为未命中。
+   */
+  CSTCache(std::string directory, std::string version);
+
+  /**
+   * @brief 获取 `source` 对应条目的路径。
+   */
+  [[nodiscard]] std::string entry_path(std::string_view source) const;
+
+  /**
+   * @brief 载入 `source` 对应的 CST。
+   * @return 命中时返回根节点；条目不存在、版本不符或已损坏时返回空。
+   */
+  [[nodiscard]] std::unique_ptr<CSTNode> load(std::string_view source,
+                                              utils::FileId file_id) const;
+
+  /**
+   * @brief 保存 `source` 解析得到的 CST。
+   * @return 写入成功时返回 true。
+   */
+  bool store(std::string_view source, const CSTNode* root) const;
+
+private:
+  std::string directory;
+  std::string version;
+};
+
+} // namespace czc::cst
+
+#endif // CZC_CST_CACHE_HPP
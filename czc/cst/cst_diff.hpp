@@ -0,0 +1,67 @@
+/**
+ * @file cst_diff.hpp
+ * @brief 借助结构哈希比较两棵 CST 的 `cst_diff`。
+ * @details
+ *   逐个节点递归比较两棵大树的开销与树的大小成正比，即使它们几乎完全
+ *   相同。`cst_diff` 先比较结构哈希（见 `compute_structural_hash`），
+ *   哈希相同的子树整个跳过，只深入真正不同的部分：改动一个函数时，
+ *   其余声明各只比较一次哈希。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_CST_DIFF_HPP
+#define CZC_CST_DIFF_HPP
+
+#include "czc/cst/cst_node.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace czc::cst {
+
+/**
+ * @brief 一处差异的种类。
+ */
+enum class CSTChangeKind {
+  Inserted, ///< 新树中多出的子树，`old_node` 为空
+  Removed,  ///< 旧树中被删去的子树，`new_node` 为空
+  Modified, ///< 位置对应、但类型或 Token 不同的一对节点
+};
+
+/**
+ * @brief 两棵 CST 之间的一处差异。
+ * @details 节点指针指向传给 `cst_diff` 的两棵树，随树一起失效。
+ */
+struct CSTChange {
+  CSTChangeKind kind;
+  const CSTNode* old_node;
+  const CSTNode* new_node;
+};
+
+// 对齐子节点时最长公共子序列表格的单元数上限，超出时按位置对齐。
+inline constexpr size_t CST_DIFF_MAX_LCS_CELLS = 1 << 20;
+
+/**
+ * @brief 按源码顺序列出从 `old_root` 到 `new_root` 的差异。
+ * @details
+ *   两个节点的结构哈希相同即视为相同（64 位哈希，碰撞的概率可以忽略）。
+ *   类型与 Token 都相同、只是子孙不同的节点不单独报告，而是继续比较
+ *   子节点：先去掉哈希相同的公共前缀与后缀，剩余部分按哈希求最长公共
+ *   子序列；未匹配的子节点按位置配对，类型相同的一对继续比较，其余报告
+ *   为删除或插入。
+ *
+ *   尚未计算哈希的节点在比较前补算（已由 Parser 在解析时算好的则直接
+ *   沿用，见 `Parser::set_structural_hash_enabled`）。差异只涉及结构与
+ *   文本，不含位置：只平移了位置的子树视为相同。以显式栈遍历，深度再大
+ *   也不会耗尽调用栈。
+ * @param[in] old_root 旧树的根，可以为空。
+ * @param[in] new_root 新树的根，可以为空。
+ * @return 差异列表；两棵树相同时为空。
+ */
+[[nodiscard]] std::vector<CSTChange> cst_diff(const CSTNode* old_root,
+                                              const CSTNode* new_root);
+
+} // namespace czc::cst
+
+#endif // CZC_CST_DIFF_HPP
@@ -9,8 +9,11 @@
 #define CZC_CST_NODE_HPP
 
 #include "czc/lexer/token.hpp"
+#include "czc/utils/arena.hpp"
 #include "czc/utils/source_location.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -92,6 +95,81 @@ enum class CSTNodeType {
   Comment, ///< 注释
 };
 
+// `CSTNodeType` 的取值个数；新增类型时须放在 `Comment` 之前。
+inline constexpr size_t CST_NODE_TYPE_COUNT =
+    static_cast<size_t>(CSTNodeType::Comment) + 1;
+
+class CSTNode;
+
+/**
+ * @brief 一次编辑之后，沿用的子树及其错误需要做的位置平移。
+ * @details 与 `lexer::Lexer::relex` 平移旧 Token 的规则相同：字节偏移量与
+ *          行号整体平移；只有位于锚点所在行（平移前的行号）上的列号需要
+ *          平移，更靠后的行列号不受影响。行号为 0 的位置（EOF 以及落在
+ *          EOF 上的虚拟 Token、节点与错误）固定为 0:0，行列号不平移。
+ */
+struct PositionShift {
+  // 字节偏移量的增量
+  std::ptrdiff_t offset_delta = 0;
+  // 行号的增量
+  std::ptrdiff_t line_delta = 0;
+  // 锚点在平移前所在的行号
+  size_t anchor_line = 0;
+  // 锚点所在行上的列号增量
+  std::ptrdiff_t column_delta = 0;
+
+  /**
+   * @brief 平移一个源码位置。
+   */
+  void apply(utils::SourceLocation& location) const noexcept {
+    if (location.line != 0) {
+      if (location.line == anchor_line) {
+        location.column = shift(location.column, column_delta);
+      }
+      location.line = shift(location.line, line_delta);
+    }
+    if (location.end_line != 0) {
+      if (location.end_line == anchor_line) {
+        location.end_column = shift(location.end_column, column_delta);
+      }
+      location.end_line = shift(location.end_line, line_delta);
+    }
+  }
+
+  /**
+   * @brief 平移一个 Token 的偏移量与行列号。
+   * @details 虚拟 Token 不对应源码文本，偏移量总是 0，只平移行列号。
+   */
+  void apply(lexer::Token& token) const noexcept {
+    if (!token.is_synthetic) {
+      token.offset = shift(token.offset, offset_delta);
+    }
+    if (token.line == 0) {
+      return;
+    }
+    if (token.line == anchor_line) {
+      token.column = shift(token.column, column_delta);
+    }
+    token.line = shift(token.line, line_delta);
+  }
+
+private:
+  template <typename T>
+  static T shift(T value, std::ptrdiff_t delta) noexcept {
+    return static_cast<T>(static_cast<std::ptrdiff_t>(value) + delta);
+  }
+};
+
+/**
+ * @brief CST 节点的子节点列表。
+ * @details
+ *   分配器在节点构造时绑定当前活动的 Arena（见 `CSTArenaScope`），
+ *   未处于 Arena 作用域时退回全局堆。
+ */
+using CSTChildList =
+    std::vector<std::unique_ptr<CSTNode>,
+                utils::ArenaAllocator<std::unique_ptr<CSTNode>>>;
+
 /**
  * @brief 具体语法树（CST）的基类节点，忠实保留源码的所有语法细节。
  * @details
@@ -101,6 +179,8 @@ enum class CSTNodeType {
  *   精确错误提示和高级 IDE 功能（如语法高亮）的基石。
  *
  * @property {生命周期} 节点的生命周期由 `std::unique_ptr` 自动管理。
+ *   在 `CSTArenaScope` 作用域内创建的节点及其子节点列表从该作用域的
+ *   Arena 中分配：析构时仍会运行析构函数，但内存随 Arena 一次性释放。
  * @property {线程安全} 非线程安全。所有对 CST 的操作都应在单线程内完成。
  */
 class CSTNode {
@@ -114,8 +194,21 @@ public:
 
   /**
    * @brief 虚析构函数。
+   * @details 以显式栈逐个释放子孙节点，析构很深的树（例如很长的左结合
+   *          运算链）不会耗尽调用栈。
+   */
+  virtual ~CSTNode();
+
+  /**
+   * @brief 分配节点内存：处于 `CSTArenaScope` 作用域内时从 Arena 分配，
+   *        否则从全局堆分配。
+   */
+  static void* operator new(size_t size);
+
+  /**
+   * @brief 释放节点内存：堆上的节点归还全局堆，Arena 中的节点不做任何事。
    */
-  virtual ~CSTNode() = default;
+  static void operator delete(void* ptr, size_t size) noexcept;
 
   /**
    * @brief 获取节点类型。
@@ -143,11 +236,19 @@ public:
    * @brief 获取所有子节点。
    * @return 子节点列表的常量引用。
    */
-  [[nodiscard]] const std::vector<std::unique_ptr<CSTNode>>&
-  get_children() const noexcept {
+  [[nodiscard]] const CSTChildList& get_children() const noexcept {
     return children;
   }
 
+  /**
+   * @brief 取走所有子节点，本节点的子节点列表随后为空。
+   * @return 原先的子节点列表。
+   */
+  [[nodiscard]] CSTChildList take_children() noexcept {
+    structural_hash = 0;
+    return std::move(children);
+  }
+
   /**
    * @brief 关联一个 Token 到此节点。
    * @details
@@ -156,6 +257,12 @@ public:
    */
   void set_token(const lexer::Token& token);
 
+  /**
+   * @brief 关联一个 Token 到此节点，接管其文本而不复制。
+   * @param[in] token Token 对象。
+   */
+  void set_token(lexer::Token&& token);
+
   /**
    * @brief 获取关联的 Token。
    * @return Token 的可选值。
@@ -164,7 +271,19 @@ public:
     return token;
   }
 
+  /**
+   * @brief 获取缓存的结构哈希，尚未计算时返回 0。
+   * @details 见 `compute_structural_hash`。
+   */
+  [[nodiscard]] uint64_t get_structural_hash() const noexcept {
+    return structural_hash;
+  }
+
 protected:
+  friend void shift_positions(std::vector<CSTNode*> roots,
+                              const PositionShift& shift);
+  friend uint64_t compute_structural_hash(const CSTNode* root);
+
   // 节点的具体语法类型。
   CSTNodeType node_type;
 
@@ -172,11 +291,85 @@ protected:
   utils::SourceLocation location;
 
   // 子节点列表，所有权由本节点通过 `std::unique_ptr` 管理。
-  std::vector<std::unique_ptr<CSTNode>> children;
+  CSTChildList children;
 
   // 关联的单个 Token，用于表示关键字、运算符、分隔符等叶子节点。
   // @note 对于复合节点，此项通常为空。
   std::optional<lexer::Token> token;
+
+  // 缓存的结构哈希，0 表示尚未计算；只清除本节点自己的缓存，
+  // 不影响已经混入了它的祖先节点。
+  mutable uint64_t structural_hash{0};
+};
+
+/**
+ * @brief 在作用域内把新建的 CST 节点分配到指定的 Arena。
+ * @details
+ *   作用域是线程局部的，可以嵌套，析构时恢复外层作用域。
+ *   作用域内创建的节点必须挂在由同一 Arena 的所有者（通常是 `CSTArenaRoot`）
+ *   管理的树上，且不能比该 Arena 活得更久。
+ */
+class CSTArenaScope {
+public:
+  explicit CSTArenaScope(utils::Arena& arena) noexcept;
+  ~CSTArenaScope();
+
+  CSTArenaScope(const CSTArenaScope&) = delete;
+  CSTArenaScope& operator=(const CSTArenaScope&) = delete;
+
+  /**
+   * @brief 获取当前线程活动的 Arena；不在任何作用域内时返回 nullptr。
+   */
+  [[nodiscard]] static utils::Arena* get_active_arena() noexcept;
+
+private:
+  // 进入本作用域前活动的 Arena。
+  utils::Arena* previous;
+};
+
+/**
+ * @brief 持有整棵树 Arena 的根节点。
+ * @details
+ *   根节点本身在堆上分配（应在 `CSTArenaScope` 之外创建），其余节点在
+ *   `CSTArenaScope(root->get_arena())` 内创建。丢弃根节点时先析构所有
+ *   子孙节点，再一次性释放 Arena 的全部内存块。
+ */
+class CSTArenaRoot final : public CSTNode {
+public:
+  /**
+   * @param[in] initial_block_size Arena 的首块大小（字节），可按预估的
+   *            树大小一次预留，见 `utils::CapacityEstimate`。
+   */
+  CSTArenaRoot(CSTNodeType type, const utils::SourceLocation& location,
+               size_t initial_block_size = utils::Arena::DEFAULT_BLOCK_SIZE);
+
+  /**
+   * @brief 先析构子节点，再释放 Arena。
+   */
+  ~CSTArenaRoot() override;
+
+  /**
+   * @brief 获取子孙节点所使用的 Arena。
+   */
+  [[nodiscard]] utils::Arena& get_arena() noexcept {
+    return *arenas.front();
+  }
+
+  [[nodiscard]] const utils::Arena& get_arena() const noexcept {
+    return *arenas.front();
+  }
+
+  /**
+   * @brief 接管另一棵 Arena 树的全部子节点及其 Arena。
+   * @details 子节点按原顺序追加到本节点的子节点之后，`other` 成为空树。
+   *          用于拼接在不同线程上分别构建的子树。
+   */
+  void adopt_children(CSTArenaRoot& other);
+
+private:
+  // 子孙节点及其子节点列表的存储：首个是本树自己的 Arena，
+  // 其余是通过 `adopt_children` 接管的 Arena。
+  std::vector<std::unique_ptr<utils::Arena>> arenas;
 };
 
 // --- 辅助函数 ---
@@ -188,6 +381,55 @@ protected:
  */
 [[nodiscard]] std::string cst_node_type_to_string(CSTNodeType type);
 
+/**
+ * @brief 一棵 CST 的内存占用估算，见 `measure_memory`。
+ */
+struct CSTMemoryStats {
+  // 节点数量
+  size_t node_count = 0;
+  // 节点本身占用的字节数（`sizeof(CSTNode)` 之和）
+  size_t node_bytes = 0;
+  // 所有子节点列表的元素数之和
+  size_t children_size = 0;
+  // 所有子节点列表的容量之和
+  size_t children_capacity = 0;
+  // 节点中 Token 文本的堆内存，见 `lexer::get_heap_bytes`
+  size_t token_text_bytes = 0;
+};
+
+/**
+ * @brief 估算以 `root` 为根的整棵 CST 的内存占用。
+ * @details 以显式栈遍历，深度再大也不会耗尽调用栈。无论节点位于堆上还是
+ *          Arena 中都按同样的方式计算。
+ * @param[in] root 根节点，可以为空。
+ */
+[[nodiscard]] CSTMemoryStats measure_memory(const CSTNode* root);
+
+/**
+ * @brief 平移以 `roots` 中各节点为根的子树中所有节点及 Token 的位置。
+ * @details `roots` 直接用作遍历的显式栈：深度再大也不会耗尽调用栈，
+ *          一次平移许多棵子树也只分配一次。
+ */
+void shift_positions(std::vector<CSTNode*> roots, const PositionShift& shift);
+
+/**
+ * @brief 计算并缓存以 `root` 为根的子树中各节点的结构哈希。
+ * @details
+ *   结构哈希自底向上计算，覆盖节点类型、关联 Token 的类型与文本（加工值
+ *   与原始文本）以及按顺序排列的子节点哈希，不含位置：结构与文本相同的
+ *   两棵子树哈希相同，平移位置（`shift_positions`）不改变哈希。文本使用
+ *   FNV-1a，结果与平台和运行无关，可以用作缓存的键。
+ *
+ *   已缓存哈希的节点直接沿用，不再遍历其子树；因此对整棵树重复调用只需
+ *   常数时间。修改节点（`add_child`、`set_token`、`take_children`）会清除
+ *   它自己的缓存，但不会清除祖先节点的缓存：修改已计算过哈希的树后，
+ *   需要对新建的树重新计算，不能沿用被修改节点的祖先。以显式栈遍历，
+ *   深度再大也不会耗尽调用栈。
+ * @param[in] root 根节点，可以为空。
+ * @return 根节点的结构哈希（非 0）；`root` 为空时返回 0。
+ */
+uint64_t compute_structural_hash(const CSTNode* root);
+
 /**
  * @brief 创建一个新的 CST 节点。
  * @param[in] type 节点类型。
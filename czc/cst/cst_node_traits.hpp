@@ -0,0 +1,176 @@
+/**
+ * @file cst_node_traits.hpp
+ * @brief 按 `CSTNodeType` 索引的节点静态属性表。
+ * @details
+ *   节点的名称、所属类别（声明、语句、表达式、类型……）等只取决于节点
+ *   类型。这些属性集中放在一张按枚举值排列的编译期表中，查询只需一次
+ *   下标访问；新的遍历可以直接复用，而不必再写一遍 `switch`。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_CST_NODE_TRAITS_HPP
+#define CZC_CST_NODE_TRAITS_HPP
+
+#include "czc/cst/cst_node.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace czc::cst {
+
+/**
+ * @brief 节点所属的语法类别，与 `CSTNodeType` 中的分组一致。
+ */
+enum class CSTNodeCategory : uint8_t {
+  Program,     ///< 程序根节点
+  Declaration, ///< 顶层或语句中的声明
+  Statement,   ///< 语句
+  Expression,  ///< 表达式（含字面量与标识符）
+  Type,        ///< 类型表达式（含结构体字段）
+  Parameter,   ///< 参数与参数列表
+  List,        ///< 实参列表与语句列表
+  Token,       ///< 只包装一个 Token 的运算符与分隔符
+  Comment,     ///< 注释
+};
+
+/**
+ * @brief 一种节点类型的静态属性。
+ */
+struct CSTNodeTraits {
+  // 节点类型，用于编译期校验表的顺序
+  CSTNodeType type;
+  // 类型名，与 `cst_node_type_to_string` 相同
+  std::string_view name;
+  CSTNodeCategory category;
+  // 是否是整数、浮点数、字符串或布尔字面量
+  bool is_literal;
+};
+
+/**
+ * @brief 按枚举值排列的节点属性表。
+ */
+inline constexpr std::array<CSTNodeTraits, CST_NODE_TYPE_COUNT>
+    CST_NODE_TRAITS{{
+    {CSTNodeType::Program, "Program", CSTNodeCategory::Program, false},
+    {CSTNodeType::VarDeclaration, "VarDeclaration",
+     CSTNodeCategory::Declaration, false},
+    {CSTNodeType::FnDeclaration, "FnDeclaration",
+     CSTNodeCategory::Declaration, false},
+    {CSTNodeType::StructDeclaration, "StructDeclaration",
+     CSTNodeCategory::Declaration, false},
+    {CSTNodeType::TypeAliasDeclaration, "TypeAliasDeclaration",
+     CSTNodeCategory::Declaration, false},
+    {CSTNodeType::ReturnStmt, "ReturnStmt", CSTNodeCategory::Statement, false},
+    {CSTNodeType::IfStmt, "IfStmt", CSTNodeCategory::Statement, false},
+    {CSTNodeType::WhileStmt, "WhileStmt", CSTNodeCategory::Statement, false},
+    {CSTNodeType::BlockStmt, "BlockStmt", CSTNodeCategory::Statement, false},
+    {CSTNodeType::ExprStmt, "ExprStmt", CSTNodeCategory::Statement, false},
+    {CSTNodeType::BinaryExpr, "BinaryExpr", CSTNodeCategory::Expression, false},
+    {CSTNodeType::UnaryExpr, "UnaryExpr", CSTNodeCategory::Expression, false},
+    {CSTNodeType::CallExpr, "CallExpr", CSTNodeCategory::Expression, false},
+    {CSTNodeType::IndexExpr, "IndexExpr", CSTNodeCategory::Expression, false},
+    {CSTNodeType::MemberExpr, "MemberExpr", CSTNodeCategory::Expression, false},
+    {CSTNodeType::AssignExpr, "AssignExpr", CSTNodeCategory::Expression, false},
+    {CSTNodeType::IndexAssignExpr, "IndexAssignExpr",
+     CSTNodeCategory::Expression, false},
+    {CSTNodeType::MemberAssignExpr, "MemberAssignExpr",
+     CSTNodeCategory::Expression, false},
+    {CSTNodeType::ArrayLiteral, "ArrayLiteral",
+     CSTNodeCategory::Expression, false},
+    {CSTNodeType::TupleLiteral, "TupleLiteral",
+     CSTNodeCategory::Expression, false},
+    {CSTNodeType::FunctionLiteral, "FunctionLiteral",
+     CSTNodeCategory::Expression, false},
+    {CSTNodeType::StructLiteral, "StructLiteral",
+     CSTNodeCategory::Expression, false},
+    {CSTNodeType::IntegerLiteral, "IntegerLiteral",
+     CSTNodeCategory::Expression, true},
+    {CSTNodeType::FloatLiteral, "FloatLiteral",
+     CSTNodeCategory::Expression, true},
+    {CSTNodeType::StringLiteral, "StringLiteral",
+     CSTNodeCategory::Expression, true},
+    {CSTNodeType::BooleanLiteral, "BooleanLiteral",
+     CSTNodeCategory::Expression, true},
+    {CSTNodeType::Identifier, "Identifier", CSTNodeCategory::Expression, false},
+    {CSTNodeType::ParenExpr, "ParenExpr", CSTNodeCategory::Expression, false},
+    {CSTNodeType::TypeAnnotation, "TypeAnnotation",
+     CSTNodeCategory::Type, false},
+    {CSTNodeType::ArrayType, "ArrayType", CSTNodeCategory::Type, false},
+    {CSTNodeType::SizedArrayType, "SizedArrayType",
+     CSTNodeCategory::Type, false},
+    {CSTNodeType::UnionType, "UnionType", CSTNodeCategory::Type, false},
+    {CSTNodeType::IntersectionType, "IntersectionType",
+     CSTNodeCategory::Type, false},
+    {CSTNodeType::NegationType, "NegationType", CSTNodeCategory::Type, false},
+    {CSTNodeType::TupleType, "TupleType", CSTNodeCategory::Type, false},
+    {CSTNodeType::FunctionSignatureType, "FunctionSignatureType",
+     CSTNodeCategory::Type, false},
+    {CSTNodeType::AnonymousStructType, "AnonymousStructType",
+     CSTNodeCategory::Type, false},
+    {CSTNodeType::StructField, "StructField", CSTNodeCategory::Type, false},
+    {CSTNodeType::Parameter, "Parameter", CSTNodeCategory::Parameter, false},
+    {CSTNodeType::ParameterList, "ParameterList",
+     CSTNodeCategory::Parameter, false},
+    {CSTNodeType::ArgumentList, "ArgumentList", CSTNodeCategory::List, false},
+    {CSTNodeType::StatementList, "StatementList", CSTNodeCategory::List, false},
+    {CSTNodeType::Operator, "Operator", CSTNodeCategory::Token, false},
+    {CSTNodeType::Delimiter, "Delimiter", CSTNodeCategory::Token, false},
+    {CSTNodeType::Comment, "Comment", CSTNodeCategory::Comment, false},
+    }};
+
+namespace detail {
+
+constexpr bool cst_node_traits_in_order() {
+  for (size_t i = 0; i < CST_NODE_TRAITS.size(); ++i) {
+    if (static_cast<size_t>(CST_NODE_TRAITS[i].type) != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace detail
+
+// 编译期校验属性表与枚举的顺序一致，漏项或错位都无法通过编译。
+static_assert(detail::cst_node_traits_in_order());
+
+/**
+ * @brief 获取节点类型的静态属性。
+ * @param[in] type 节点类型，必须是合法的枚举值。
+ */
+[[nodiscard]] constexpr const CSTNodeTraits&
+get_node_traits(CSTNodeType type) noexcept {
+  return CST_NODE_TRAITS[static_cast<size_t>(type)];
+}
+
+[[nodiscard]] constexpr CSTNodeCategory
+get_node_category(CSTNodeType type) noexcept {
+  return get_node_traits(type).category;
+}
+
+[[nodiscard]] constexpr bool is_declaration(CSTNodeType type) noexcept {
+  return get_node_category(type) == CSTNodeCategory::Declaration;
+}
+
+[[nodiscard]] constexpr bool is_statement(CSTNodeType type) noexcept {
+  return get_node_category(type) == CSTNodeCategory::Statement;
+}
+
+[[nodiscard]] constexpr bool is_expression(CSTNodeType type) noexcept {
+  return get_node_category(type) == CSTNodeCategory::Expression;
+}
+
+[[nodiscard]] constexpr bool is_type(CSTNodeType type) noexcept {
+  return get_node_category(type) == CSTNodeCategory::Type;
+}
+
+[[nodiscard]] constexpr bool is_literal(CSTNodeType type) noexcept {
+  return get_node_traits(type).is_literal;
+}
+
+} // namespace czc::cst
+
+#endif // CZC_CST_NODE_TRAITS_HPP
@@ -0,0 +1,339 @@
+/**
+ * @file flat_cst.hpp
+ * @brief 定义了以连续数组存储的扁平 CST `FlatCST` 及其遍历接口。
+ * @details
+ *   `FlatCST` 按先序把所有节点存放在一个连续数组中，节点之间用下标
+ *   （首个子节点、下一个兄弟节点、子树末尾）而非指针相连，关联的 Token
+ *   集中存放在另一个数组中。格式化、AST 构建等按先序处理整棵树的遍历
+ *   因此可以顺序扫过内存，也可以用 `subtree_end` 整体跳过一棵子树。
+ *
+ *   `FlatCSTNodeRef` 提供与 `CSTNode` 相近的只读接口（`get_type`、
+ *   `get_token`、`get_children` 等），迁移期间可通过 `FlatCST::from_tree`
+ *   从现有的指针树转换得到，两种表示可以并存。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_CST_FLAT_CST_HPP
+#define CZC_CST_FLAT_CST_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/token.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace czc::cst {
+
+/**
+ * @brief 扁平 CST 中的单个节点（32 字节 POD）。
+ * @details 所有下标都指向所属 `FlatCST` 的节点数组或 Token 数组。
+ */
+struct FlatCSTNode {
+  // 节点的具体语法类型。
+  CSTNodeType node_type;
+
+  // 第一个子节点的下标；没有子节点时为 `FlatCST::NO_NODE`。
+  // NOTE: 先序存储下第一个子节点总是紧跟在父节点之后。
+  uint32_t first_child;
+
+  // 下一个兄弟节点的下标；最后一个子节点为 `FlatCST::NO_NODE`。
+  uint32_t next_sibling;
+
+  // 子树末尾之后的下标：`[index + 1, subtree_end)` 即该节点的全部子孙。
+  uint32_t subtree_end;
+
+  // 关联 Token 在 Token 数组中的下标；没有 Token 时为 `FlatCST::NO_TOKEN`。
+  uint32_t token_index;
+
+  // 直接子节点的数量。
+  uint32_t child_count;
+
+  // 节点在源码中的起始行号与列号。
+  uint32_t line;
+  uint32_t column;
+};
+
+static_assert(sizeof(FlatCSTNode) == 32, "FlatCSTNode must stay 32 bytes");
+static_assert(std::is_trivially_copyable_v<FlatCSTNode>,
+              "FlatCSTNode must be trivially copyable");
+
+class FlatCST;
+
+/**
+ * @brief 指向扁平 CST 中某个节点的轻量句柄。
+ * @details 只包含树指针和下标，按值传递；在所属 `FlatCST` 存活期间有效。
+ */
+class FlatCSTNodeRef {
+public:
+  FlatCSTNodeRef(const FlatCST* tree, uint32_t index) noexcept
+      : tree(tree), index(index) {}
+
+  class ChildRange;
+
+  /**
+   * @brief 获取节点在节点数组中的下标。
+   */
+  [[nodiscard]] uint32_t get_index() const noexcept {
+    return index;
+  }
+
+  /**
+   * @brief 获取底层的节点记录。
+   */
+  [[nodiscard]] const FlatCSTNode& get_node() const noexcept;
+
+  /**
+   * @brief 获取节点类型。
+   */
+  [[nodiscard]] CSTNodeType get_type() const noexcept {
+    return get_node().node_type;
+  }
+
+  /**
+   * @brief 获取节点的起始行号。
+   */
+  [[nodiscard]] size_t get_line() const noexcept {
+    return get_node().line;
+  }
+
+  /**
+   * @brief 获取节点的起始列号。
+   */
+  [[nodiscard]] size_t get_column() const noexcept {
+    return get_node().column;
+  }
+
+  /**
+   * @brief 获取关联的 Token。
+   * @return 指向 Token 的指针；节点没有关联 Token 时返回 nullptr。
+   */
+  [[nodiscard]] const lexer::Token* get_token() const noexcept;
+
+  /**
+   * @brief 获取直接子节点的数量。
+   */
+  [[nodiscard]] size_t get_child_count() const noexcept {
+    return get_node().child_count;
+  }
+
+  /**
+   * @brief 获取第 `position` 个直接子节点。
+   * @details 沿兄弟链线性查找；顺序访问请使用 `get_children()`。
+   * @param[in] position 子节点序号，必须小于 `get_child_count()`。
+   */
+  [[nodiscard]] FlatCSTNodeRef get_child(size_t position) const noexcept;
+
+  /**
+   * @brief 获取可用于范围 for 循环的直接子节点序列。
+   */
+  [[nodiscard]] ChildRange get_children() const noexcept;
+
+  bool operator==(const FlatCSTNodeRef& other) const noexcept {
+    return tree == other.tree && index == other.index;
+  }
+
+  bool operator!=(const FlatCSTNodeRef& other) const noexcept {
+    return !(*this == other);
+  }
+
+private:
+  // 所属的扁平 CST。
+  const FlatCST* tree;
+
+  // 节点下标。
+  uint32_t index;
+};
+
+/**
+ * @brief 先序存储、下标相连的只读 CST。
+ * @details
+ *   下标 0 总是根节点。节点记录与 Token 分别存放在两个连续数组中，
+ *   构建完成后不再修改。
+ *
+ * @property {线程安全} 构建完成后只读访问是线程安全的。
+ */
+class FlatCST {
+public:
+  // 表示不存在的节点下标。
+  static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+  // 表示节点没有关联 Token。
+  static constexpr uint32_t NO_TOKEN = std::numeric_limits<uint32_t>::max();
+
+  FlatCST() = default;
+
+  /**
+   * @brief 从指针树转换得到扁平 CST。
+   * @details 迭代遍历，不受树深度影响；空的子节点指针会被跳过。
+   * @param[in] root 根节点；为 nullptr 时返回空树。
+   * @return 转换后的扁平 CST。
+   */
+  [[nodiscard]] static FlatCST from_tree(const CSTNode* root);
+
+  /**
+   * @brief 树中是否没有任何节点。
+   */
+  [[nodiscard]] bool empty() const noexcept {
+    return nodes.empty();
+  }
+
+  /**
+   * @brief 获取节点总数。
+   */
+  [[nodiscard]] size_t size() const noexcept {
+    return nodes.size();
+  }
+
+  /**
+   * @brief 获取根节点，树不能为空。
+   */
+  [[nodiscard]] FlatCSTNodeRef get_root() const noexcept {
+    return FlatCSTNodeRef(this, 0);
+  }
+
+  /**
+   * @brief 获取指定下标的节点。
+   */
+  [[nodiscard]] FlatCSTNodeRef get_node(uint32_t index) const noexcept {
+    return FlatCSTNodeRef(this, index);
+  }
+
+  /**
+   * @brief 获取按先序排列的全部节点记录，可直接顺序扫描。
+   */
+  [[nodiscard]] const std::vector<FlatCSTNode>& get_nodes() const noexcept {
+    return nodes;
+  }
+
+  /**
+   * @brief 获取节点关联的全部 Token，按节点的先序排列。
+   */
+  [[nodiscard]] const std::vector<lexer::Token>& get_tokens() const noexcept {
+    return tokens;
+  }
+
+  /**
+   * @brief 获取根节点所记录的源文件名。
+   */
+  [[nodiscard]] const std::string& get_filename() const noexcept {
+    return filename;
+  }
+
+private:
+  // 按先序排列的节点记录。
+  std::vector<FlatCSTNode> nodes;
+
+  // 节点关联的 Token。
+  std::vector<lexer::Token> tokens;
+
+  // 源文件名（取自根节点的位置）。
+  std::string filename;
+};
+
+/**
+ * @brief 沿兄弟链遍历直接子节点的前向迭代器。
+ */
+class FlatCSTNodeRef::ChildRange {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = FlatCSTNodeRef;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = FlatCSTNodeRef;
+
+    iterator(const FlatCST* tree, uint32_t index) noexcept
+        : tree(tree), index(index) {}
+
+    FlatCSTNodeRef operator*() const noexcept {
+      return FlatCSTNodeRef(tree, index);
+    }
+
+    iterator& operator++() noexcept {
+      index = tree->get_nodes()[index].next_sibling;
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const iterator& other) const noexcept {
+      return index == other.index;
+    }
+
+    bool operator!=(const iterator& other) const noexcept {
+      return index != other.index;
+    }
+
+  private:
+    const FlatCST* tree;
+    uint32_t index;
+  };
+
+  ChildRange(const FlatCST* tree, uint32_t first, size_t count) noexcept
+      : tree(tree), first(first), count(count) {}
+
+  [[nodiscard]] iterator begin() const noexcept {
+    return iterator(tree, first);
+  }
+
+  [[nodiscard]] iterator end() const noexcept {
+    return iterator(tree, FlatCST::NO_NODE);
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return count;
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return count == 0;
+  }
+
+private:
+  const FlatCST* tree;
+  uint32_t first;
+  size_t count;
+};
+
+// --- FlatCSTNodeRef 的内联实现 ---
+
+inline const FlatCSTNode& FlatCSTNodeRef::get_node() const noexcept {
+  return tree->get_nodes()[index];
+}
+
+inline const lexer::Token* FlatCSTNodeRef::get_token() const noexcept {
+  uint32_t token_index = get_node().token_index;
+  if (token_index == FlatCST::NO_TOKEN) {
+    return nullptr;
+  }
+  return &tree->get_tokens()[token_index];
+}
+
+inline FlatCSTNodeRef
+FlatCSTNodeRef::get_child(size_t position) const noexcept {
+  uint32_t child = get_node().first_child;
+  for (size_t i = 0; i < position; ++i) {
+    child = tree->get_nodes()[child].next_sibling;
+  }
+  return FlatCSTNodeRef(tree, child);
+}
+
+inline FlatCSTNodeRef::ChildRange
+FlatCSTNodeRef::get_children() const noexcept {
+  const FlatCSTNode& node = get_node();
+  return ChildRange(tree, node.first_child, node.child_count);
+}
+
+} // namespace czc::cst
+
+#endif // CZC_CST_FLAT_CST_HPP
@@ -0,0 +1,314 @@
+/**
+ * @file green_tree.hpp
+ * @brief 定义了只记录宽度、可结构共享的不可变 CST（“绿树”）`GreenNode`，
+ *        以及按需计算绝对位置的外观（“红树”）`RedNode`。
+ * @details
+ *   `CSTNode` 记录绝对位置：在文件开头插入一个字符，其后所有节点的位置
+ *   都随之改变，子树无法在不同版本之间共享。绿树只记录每个节点覆盖的
+ *   文本长度（`TextExtent`），Token 的前导空白与注释也作为其文本的一部分
+ *   保存，因此：
+ *   - 一棵绿子树只取决于它覆盖的文本，与它在文件中的位置无关；
+ *   - `GreenCache` 对所有节点做哈希合并（hash-consing）：结构与文本相同的
+ *     子树只存在一份，同一文件的不同版本、乃至不同文件之间都共享它们，
+ *     比较两棵子树是否相同只需比较指针；
+ *   - 绿树可以无损地还原出它覆盖的源码文本。
+ *
+ *   `RedNode` 是“绿节点 + 起始位置”的轻量句柄，按值传递；子节点的位置
+ *   在访问时由前面兄弟节点的宽度累加得到，只为实际访问到的节点计算。
+ *
+ *   迁移期间通过 `GreenCache::from_tree` 从现有的指针树转换得到，两种
+ *   表示可以并存。与 `FlatCST` 相同，空的子节点指针会被跳过。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_CST_GREEN_TREE_HPP
+#define CZC_CST_GREEN_TREE_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/token.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace czc::cst {
+
+/**
+ * @brief 一段文本的长度：字节数、所含换行数与最后一行的字节数。
+ * @details 列号以字节计（与 `SourceTracker` 相同），因此三者足以由起点
+ *          推出终点的偏移量与行列号。
+ */
+struct TextExtent {
+  // 字节数
+  size_t bytes = 0;
+  // 换行符数
+  size_t lines = 0;
+  // 最后一个换行符之后的字节数；没有换行时等于 `bytes`
+  size_t tail = 0;
+
+  /**
+   * @brief 测量一段文本。
+   */
+  [[nodiscard]] static TextExtent measure(std::string_view text) noexcept;
+
+  /**
+   * @brief 拼接：先是本段文本，其后紧跟 `next`。
+   */
+  [[nodiscard]] TextExtent then(const TextExtent& next) const noexcept {
+    return {bytes + next.bytes, lines + next.lines,
+            next.lines > 0 ? next.tail : tail + next.tail};
+  }
+
+  bool operator==(const TextExtent& other) const noexcept {
+    return bytes == other.bytes && lines == other.lines && tail == other.tail;
+  }
+};
+
+/**
+ * @brief 源码中的一个绝对位置。
+ */
+struct TextPosition {
+  // 字节偏移量（从 0 开始）
+  size_t offset = 0;
+  // 行号（从 1 开始）
+  size_t line = 1;
+  // 列号（从 1 开始）
+  size_t column = 1;
+
+  /**
+   * @brief 越过一段长度为 `extent` 的文本之后的位置。
+   */
+  [[nodiscard]] TextPosition advance(const TextExtent& extent) const noexcept {
+    return {offset + extent.bytes, line + extent.lines,
+            extent.lines > 0 ? extent.tail + 1 : column + extent.tail};
+  }
+};
+
+/**
+ * @brief 绿树中一个节点关联的 Token。
+ */
+struct GreenToken {
+  // 去掉位置信息（偏移量与行列号为 0）的 Token
+  lexer::Token token;
+  // 紧邻 Token 之前、未被 CST 记录的文本（空白与行内注释）
+  std::string leading;
+  // Token 在源码中的原文；原文归另一个节点所有时为空
+  std::string text;
+  // `leading` 与 `text` 的长度
+  TextExtent leading_extent;
+  TextExtent text_extent;
+};
+
+/**
+ * @brief 不可变、与位置无关的 CST 节点。
+ * @details 经由 `GreenCache` 创建，在所属的 `GreenCache` 存活期间有效。
+ *          关联的 Token 在源码中位于前 `get_token_slot()` 个子节点之后。
+ */
+class GreenNode {
+public:
+  GreenNode(CSTNodeType type, std::optional<GreenToken> token,
+            size_t token_slot, std::vector<const GreenNode*> children);
+
+  /**
+   * @brief 获取节点类型。
+   */
+  [[nodiscard]] CSTNodeType get_type() const noexcept {
+    return node_type;
+  }
+
+  /**
+   * @brief 获取关联的 Token。
+   */
+  [[nodiscard]] const std::optional<GreenToken>& get_token() const noexcept {
+    return token;
+  }
+
+  /**
+   * @brief 获取源码中位于关联 Token 之前的子节点数。
+   */
+  [[nodiscard]] size_t get_token_slot() const noexcept {
+    return token_slot;
+  }
+
+  /**
+   * @brief 获取直接子节点，均不为空。
+   */
+  [[nodiscard]] const std::vector<const GreenNode*>&
+  get_children() const noexcept {
+    return children;
+  }
+
+  /**
+   * @brief 获取节点覆盖的全部文本（含各 Token 的前导文本）的长度。
+   */
+  [[nodiscard]] const TextExtent& get_extent() const noexcept {
+    return extent;
+  }
+
+  /**
+   * @brief 获取结构哈希；相同的子树哈希相同。
+   */
+  [[nodiscard]] uint64_t get_hash() const noexcept {
+    return hash;
+  }
+
+  /**
+   * @brief 还原节点覆盖的源码文本。
+   * @details 以显式栈遍历，深度再大也不会耗尽调用栈。
+   */
+  [[nodiscard]] std::string to_text() const;
+
+  /**
+   * @brief 结构比较：类型、Token 与子节点（按指针）都相同。
+   * @details 子节点都已合并，因此逐层比较指针即等价于比较整棵子树。
+   */
+  [[nodiscard]] bool same_as(const GreenNode& other) const noexcept;
+
+private:
+  CSTNodeType node_type;
+  std::optional<GreenToken> token;
+  size_t token_slot;
+  std::vector<const GreenNode*> children;
+  TextExtent extent;
+  uint64_t hash;
+};
+
+/**
+ * @brief 创建并合并绿节点的存储。
+ * @details
+ *   所有节点归缓存所有，缓存析构时一并释放。请求一个与已有节点结构相同的
+ *   节点时直接返回已有节点。多个文件或同一文件的多个版本可以共用一个
+ *   缓存，以共享相同的子树。
+ * @property {线程安全} 非线程安全。
+ */
+class GreenCache {
+public:
+  GreenCache() = default;
+  GreenCache(const GreenCache&) = delete;
+  GreenCache& operator=(const GreenCache&) = delete;
+
+  /**
+   * @brief 获取一个节点：存在结构相同的节点时返回它，否则新建。
+   * @param[in] type       节点类型。
+   * @param[in] token      关联的 Token；其位置信息被忽略。
+   * @param[in] token_slot 源码中位于 Token 之前的子节点数。
+   * @param[in] children   子节点，必须都来自本缓存且不为空。
+   */
+  const GreenNode* make_node(CSTNodeType type, std::optional<GreenToken> token,
+                             size_t token_slot,
+                             std::vector<const GreenNode*> children);
+
+  /**
+   * @brief 从指针树转换得到绿树。
+   * @details 各 Token 的前导文本取自源码中它与前一个 Token 之间的文本。
+   *          复合节点的 Token 可能与某个子孙节点的 Token 相同（例如结构体
+   *          字段的名字），此时原文只归子孙节点所有。虚拟 Token 不占任何
+   *          文本；最后一个 Token 之后的文本不属于任何节点。以显式栈遍历，
+   *          不受树深度影响。
+   * @param[in] root   根节点；为 nullptr 时返回 nullptr。
+   * @param[in] source 构建这棵树的源码。
+   */
+  const GreenNode* from_tree(const CSTNode* root, std::string_view source);
+
+  /**
+   * @brief 获取缓存中互不相同的节点数。
+   */
+  [[nodiscard]] size_t size() const noexcept {
+    return nodes.size();
+  }
+
+  /**
+   * @brief 获取由已有节点满足的 `make_node` 请求数。
+   */
+  [[nodiscard]] size_t get_hit_count() const noexcept {
+    return hits;
+  }
+
+private:
+  struct NodeHash {
+    size_t operator()(const GreenNode* node) const noexcept {
+      return static_cast<size_t>(node->get_hash());
+    }
+  };
+
+  struct NodeEqual {
+    bool operator()(const GreenNode* a, const GreenNode* b) const noexcept {
+      return a->same_as(*b);
+    }
+  };
+
+  // 节点的存储。
+  std::vector<std::unique_ptr<GreenNode>> nodes;
+
+  // 按结构索引的全部节点。
+  std::unordered_set<const GreenNode*, NodeHash, NodeEqual> index;
+
+  size_t hits{0};
+};
+
+/**
+ * @brief 绿节点加上其起始位置：按需计算绝对位置的只读句柄。
+ * @details 起始位置指节点覆盖文本的开头，即首个 Token 的前导文本之前。
+ *          按值传递，在所指绿节点存活期间有效。
+ */
+class RedNode {
+public:
+  /**
+   * @brief 以根节点与文件开头的位置构造。
+   */
+  explicit RedNode(const GreenNode* green, TextPosition start = {}) noexcept
+      : green(green), start(start) {}
+
+  [[nodiscard]] const GreenNode* get_green() const noexcept {
+    return green;
+  }
+
+  [[nodiscard]] CSTNodeType get_type() const noexcept {
+    return green->get_type();
+  }
+
+  /**
+   * @brief 获取节点覆盖文本（含前导文本）的起点。
+   */
+  [[nodiscard]] const TextPosition& get_start() const noexcept {
+    return start;
+  }
+
+  /**
+   * @brief 获取节点覆盖文本的终点。
+   */
+  [[nodiscard]] TextPosition get_end() const noexcept {
+    return start.advance(green->get_extent());
+  }
+
+  /**
+   * @brief 获取带绝对位置的关联 Token；节点没有 Token 时返回空。
+   */
+  [[nodiscard]] std::optional<lexer::Token> get_token() const;
+
+  /**
+   * @brief 获取直接子节点及其位置。
+   */
+  [[nodiscard]] std::vector<RedNode> get_children() const;
+
+  /**
+   * @brief 查找原文覆盖字节偏移量 `offset` 的 Token 所在的最深节点。
+   * @details 沿子节点宽度向下定位，只访问从根到目标的一条路径。
+   * @return 找到时返回该节点；`offset` 落在前导文本中或越界时返回空。
+   */
+  [[nodiscard]] std::optional<RedNode> find_token_at(size_t offset) const;
+
+private:
+  const GreenNode* green;
+  TextPosition start;
+};
+
+} // namespace czc::cst
+
+#endif // CZC_CST_GREEN_TREE_HPP
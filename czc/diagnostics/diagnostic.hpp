@@ -10,13 +10,20 @@
 
 #include "czc/utils/source_location.hpp"
 
+#include <cstdint>
+#include <limits>
 #include <memory>
-#include <unordered_map>
+#include <iosfwd>
+#include <string_view>
 #include <vector>
 
 #include "diagnostic_code.hpp"
 #include "diagnostic_reporter.hpp"
 
+namespace czc::utils {
+class SourceTracker;
+} // namespace czc::utils
+
 namespace czc::diagnostics {
 
 /**
@@ -49,29 +56,109 @@ struct MessageTemplate {
  *   从对应的 `.toml` 文件中加载结构化的消息模板。这使得编译器的错误和警告
  *   信息可以轻松地翻译成多种语言，而无需修改编译器本身的源代码。
  *
- * @property {设计} 采用懒加载（lazy loading）模式，仅在需要时加载 `.toml`
- * 文件。
- * @property {线程安全} 非线程安全。在多线程环境中需由调用者外部加锁或为每个线程
- *   创建独立实例。
+ * @property {设计} 采用懒加载（lazy loading）模式，第一次查询消息时才加载；
+ *   启用 `CZC_EMBED_LOCALES` 时优先使用编译进库的目录，不访问文件系统。
+ * @property {线程安全} 非线程安全（第一次查询会触发加载，const 方法也不例外）。
+ *   在多线程环境中需由调用者外部加锁或为每个线程创建独立实例。
  */
 class I18nMessages {
 private:
+  // 表示文本片段，而不是占位符。
+  static constexpr uint32_t LITERAL_SEGMENT =
+      std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief 消息格式字符串中的一段：原样输出的文本或一个 `{n}` 占位符。
+   * @details `offset` / `length` 指向 `MessageTemplate::message` 中的原文，
+   *          占位符没有对应的参数时原样输出。
+   */
+  struct Segment {
+    uint32_t offset;
+    uint32_t length;
+    // 占位符的参数下标；文本片段为 `LITERAL_SEGMENT`
+    uint32_t arg;
+  };
+
+  /**
+   * @brief 加载时预先拆分好占位符的消息模板。
+   */
+  struct CompiledMessage {
+    MessageTemplate tmpl{};
+    std::vector<Segment> segments{};
+    bool loaded = false;
+  };
+
+  // 每个模块占用的代码值区间（L 为 0-999，T 为 1000-1999，依此类推）。
+  static constexpr int CODE_GROUP_SPAN = 1000;
+  // 模块数（L、T、P、S）。
+  static constexpr size_t CODE_GROUP_COUNT = 4;
+
   // 当前设置的语言环境字符串，例如 "en_US"。
   std::string current_locale;
-  // 存储从 .toml 文件加载的所有诊断消息模板。
-  // 键是诊断代码的字符串表示（如 "L0001"）。
-  std::unordered_map<std::string, MessageTemplate> messages;
+  // 存储加载的所有诊断消息模板。
+  // NOTE: 按模块分组的稠密表，组内以代码值除以 `CODE_GROUP_SPAN` 的余数为
+  //       下标，查找时无需把诊断代码转换为字符串再哈希。
+  //       消息在第一次被查询时才加载，从不报告诊断的运行不付出任何代价，
+  //       因此这两个成员在 const 方法中也会被修改。
+  mutable std::vector<CompiledMessage> messages[CODE_GROUP_COUNT];
+  // `current_locale` 的消息是否已经加载。
+  mutable bool loaded = false;
+
+  /**
+   * @brief 把消息格式字符串拆分为文本片段与 `{n}` 占位符。
+   * @details 只有花括号中是不带前导零的十进制数时才视为占位符，
+   *          其余花括号按普通文本处理。
+   */
+  static std::vector<Segment> split_placeholders(const std::string& message);
+
+  /**
+   * @brief 查找诊断代码对应的已加载模板。
+   * @return 找不到时返回空。
+   */
+  const CompiledMessage* find(DiagnosticCode code) const;
+
+  /**
+   * @brief 若尚未加载，加载 `current_locale` 的消息，失败时回退到 "en_US"。
+   */
+  void ensure_loaded() const;
 
   /**
-   * @brief 从指定的 .toml 文件加载特定语言环境的消息。
+   * @brief 加载特定语言环境的消息。
+   * @details 依次尝试 `ZERO_LOCALE_PATH` 下的文件、编译进库的目录，以及
+   *          相对于当前工作目录的常见路径。
    * @param[in] locale 要加载的语言环境标识符，例如 "en_US"。
-   * @return 如果文件成功加载并解析，则返回 `true`，否则返回 `false`。
+   * @return 如果找到并成功加载，则返回 `true`，否则返回 `false`。
+   */
+  bool load(const std::string& locale) const;
+
+  /**
+   * @brief 从 .toml 文件加载消息。
+   * @param[in] filepath 文件路径。
+   * @return 如果文件成功解析且至少包含一条消息，则返回 `true`。
+   */
+  bool load_from_file(const std::string& filepath) const;
+
+  /**
+   * @brief 从编译进库的目录加载消息。
+   * @return 该语言环境未被编译进库时返回 `false`。
+   */
+  bool load_embedded(const std::string& locale) const;
+
+  /**
+   * @brief 清空所有已加载的消息，保留容量。
+   */
+  void clear_messages() const;
+
+  /**
+   * @brief 预先拆分模板的占位符并存入稠密表。
+   * @return 键不是有效的诊断代码时返回 `false`。
    */
-  bool load_from_file(const std::string& locale);
+  bool add_message(std::string_view key, MessageTemplate tmpl) const;
 
 public:
   /**
    * @brief 构造并初始化一个国际化消息管理器。
+   * @details 构造时不加载任何消息，推迟到第一次查询时进行。
    * @param[in] locale 初始的语言环境，默认为 "en_US"。
    */
   I18nMessages(const std::string& locale = "en_US");
@@ -79,7 +166,8 @@ public:
   /**
    * @brief 切换当前的语言环境。
    * @details
-   *   如果新的语言环境与当前不同，将尝试从对应的 .toml 文件加载新的消息模板。
+   *   如果新的语言环境与当前不同，丢弃已加载的消息，新的消息模板推迟到
+   *   下一次查询时加载。
    * @param[in] locale 新的语言环境标识符。
    */
   void set_locale(const std::string& locale);
@@ -103,6 +191,16 @@ public:
    */
   std::string format_message(DiagnosticCode code,
                              const std::vector<std::string>& args) const;
+
+  /**
+   * @brief 格式化一条诊断消息，并追加到 `out` 末尾。
+   * @details 依次追加预先拆分好的文本片段与参数，不再扫描模板文本。
+   * @param[out] out 输出缓冲区。
+   * @param[in] code 诊断代码。
+   * @param[in] args 用于替换消息模板中占位符的字符串列表。
+   */
+  void append_message(std::string& out, DiagnosticCode code,
+                      const std::vector<std::string>& args) const;
 };
 
 /**
@@ -134,6 +232,9 @@ private:
   std::vector<std::string> args{};
   // 发生诊断的源代码行内容，用于在报告中显示上下文。
   std::string source_line{};
+  // 高亮标记按字符计数的起始列（从 1 开始）与长度，0 表示按字节列号计算。
+  size_t caret_column{0};
+  size_t caret_length{0};
 
 public:
   /**
@@ -156,6 +257,18 @@ public:
     source_line = line;
   }
 
+  /**
+   * @brief 设置高亮标记在源代码行中按字符计数的位置。
+   * @details 位置中的列号按字节计数，行内有多字节 UTF-8 字符时直接用它
+   *          缩进会使标记错位；设置后按这里的字符位置输出标记。
+   * @param[in] column 起始列（从 1 开始）。
+   * @param[in] length 标记的字符数，至少为 1。
+   */
+  void set_caret(size_t column, size_t length) {
+    caret_column = column;
+    caret_length = length;
+  }
+
   /**
    * @brief 获取诊断的严重级别。
    * @return 返回诊断级别枚举值。
@@ -213,26 +326,112 @@ public:
  * @details
  *   此类是整个诊断系统的引擎，实现了 `IDiagnosticReporter` 接口，作为所有
  *   编译器组件（词法、语法、语义分析器等）报告错误的统一入口。它负责：
- *   1. 收集并存储所有报告的 `Diagnostic` 对象。
+ *   1. 以紧凑记录的形式收集所有报告的诊断。
  *   2. 实时跟踪错误和警告的数量，以决定编译流程是否应提前终止。
  *   3. 协调 `I18nMessages` 实例，以支持多语言的诊断报告。
  *   4. 在编译结束时，将所有收集到的诊断信息格式化并呈现给用户。
  *
+ *   报告时只记录诊断代码、位置与参数在参数池中的区间，不构造 `Diagnostic`
+ *   对象，也不提取源码行；源码行、颜色与本地化消息文本都推迟到
+ *   `print_all` 时才生成。配合 `set_max_retained`，只关心错误数量的调用方
+ *   （例如模糊测试）几乎不为没人阅读的诊断付出代价。
+ *
  * @property {生命周期} `DiagnosticEngine`
  *   的实例必须在所有可能报告诊断的组件（如 Lexer,
- * Parser）的生命周期内保持有效。
+ * Parser）的生命周期内保持有效。通过 `set_source` 关联的 `SourceTracker`
+ *   必须存活到最后一次打印之后。
  * @property {线程安全} 非线程安全。应在主编译线程中创建和使用。
  */
 class DiagnosticEngine : public IDiagnosticReporter {
 private:
-  // 存储所有已报告的诊断信息的列表。
-  std::vector<std::shared_ptr<Diagnostic>> diagnostics;
+  // 表示“未显式给出源码行，打印时从 `source` 中提取”。
+  static constexpr uint32_t NO_SOURCE_LINE =
+      std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief 一条尚未渲染的诊断。
+   * @details 参数与显式给出的源码行都存放在引擎的池中，记录本身只保存
+   *          它们的下标；文件名则以 `SourceManager` 的编号保存。
+   */
+  struct DiagnosticRecord {
+    DiagnosticLevel level;
+    DiagnosticCode code;
+    utils::FileId file_id;
+    uint32_t line;
+    uint32_t column;
+    uint32_t end_line;
+    uint32_t end_column;
+    // 参数在 `arg_spans` 中的区间 [first_arg, first_arg + arg_count)
+    uint32_t first_arg;
+    uint32_t arg_count;
+    // 显式给出的源码行在 `source_lines` 中的下标
+    uint32_t source_line_index;
+  };
+
+  // 按报告顺序保存的诊断记录。
+  std::vector<DiagnosticRecord> records;
+  /**
+   * @brief 一个参数在 `arg_text` 中的字节区间。
+   */
+  struct ArgSpan {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  // 所有记录的参数文本，按记录顺序首尾相接地存放在同一块缓冲区中。
+  std::string arg_text;
+  // 每个参数在 `arg_text` 中的区间。
+  std::vector<ArgSpan> arg_spans;
+  // 通过 `report(std::shared_ptr<Diagnostic>)` 显式给出的源码行。
+  std::vector<std::string> source_lines;
+  // 打印时按需提取源码行的来源，可以为空。
+  const utils::SourceTracker* source = nullptr;
+  // 最多保存的记录数，超出后只计数。
+  size_t max_retained = std::numeric_limits<size_t>::max();
+  // 最多接受的错误数，达到后的错误既不保存也不计数。
+  size_t error_limit = std::numeric_limits<size_t>::max();
   // 指向国际化消息管理器的共享指针。
   std::shared_ptr<I18nMessages> i18n;
   // 已报告的错误总数。
   size_t error_count = 0;
   // 已报告的警告总数。
   size_t warning_count = 0;
+  // 按模块（诊断代码值 / 1000，即 L、T、P、S 与其他）统计的错误数。
+  size_t group_error_counts[5] = {};
+
+  /**
+   * @brief 更新计数，并判断是否还应保存这条诊断。
+   */
+  bool count(DiagnosticLevel level, DiagnosticCode code);
+
+  /**
+   * @brief 追加一条记录，参数 [first, last) 的文本复制到参数缓冲区。
+   */
+  void add_record(DiagnosticLevel level, DiagnosticCode code,
+                  const utils::SourceLocation& location,
+                  const std::string* first, const std::string* last,
+                  uint32_t source_line_index);
+
+  /**
+   * @brief 如果有错误，打印结尾的中止信息。
+   */
+  static void print_summary(std::ostream& os, size_t errors);
+
+  /**
+   * @brief 把一条记录还原为不含源码行的 `Diagnostic` 对象。
+   */
+  [[nodiscard]] Diagnostic
+  make_diagnostic(const DiagnosticRecord& record) const;
+
+  /**
+   * @brief 打印诊断代码属于 `code_prefixes` 中某个模块的记录。
+   * @details 需要从 `source` 提取源码行的记录先收集起始与结束偏移，排序后
+   *          用 `SourceTracker::resolve_offsets` 一次换算出所在行与按字符
+   *          计数的列，再逐条渲染。
+   * @param[in] code_prefixes 为空指针时打印全部记录。
+   */
+  void print_records(std::ostream& os, bool use_color,
+                     const std::string_view* code_prefixes) const;
 
 public:
   /**
@@ -249,15 +448,78 @@ public:
     i18n->set_locale(locale);
   }
 
+  /**
+   * @brief 设置打印时提取源码行所用的源码跟踪器。
+   * @param[in] tracker 源码跟踪器，为空表示不显示源码行。
+   */
+  void set_source(const utils::SourceTracker* tracker) noexcept {
+    source = tracker;
+  }
+
+  /**
+   * @brief 设置最多保存的诊断数。
+   * @details 超出的诊断仍计入错误与警告数量，但不再保存，也不会被打印。
+   */
+  void set_max_retained(size_t limit) noexcept {
+    max_retained = limit;
+  }
+
+  /**
+   * @brief 设置最多接受的错误数（`--max-errors`）。
+   * @details 达到上限后 `error_limit_reached` 返回 `true`，写入本引擎的
+   *          各阶段据此提前停止；此后报告的错误直接丢弃，不保存也不计数。
+   *          警告不受影响。上限在 `clear` 之后仍然有效。
+   */
+  void set_error_limit(size_t limit) noexcept {
+    error_limit = limit;
+  }
+
+  [[nodiscard]] bool error_limit_reached() const noexcept override {
+    return error_count >= error_limit;
+  }
+
+  /**
+   * @brief 丢弃全部诊断与计数，并解除关联的源码跟踪器。
+   * @details 记录与参数池保留已分配的容量，已加载的消息也不丢弃，同一个
+   *          引擎可以依次用于多个文件，不必每个文件都重新预热。
+   */
+  void clear() noexcept;
+
   /**
    * @brief 报告一个新的诊断事件。
    * @details
    *   这是 IDiagnosticReporter 接口的实现。此方法会接收一个诊断对象，
-   *   根据其级别更新错误或警告计数，并将其存储以备后续报告。
+   *   根据其级别更新错误或警告计数，并将其转换为紧凑记录保存；
+   *   对象上已设置的源码行会被保留。
    * @param[in] diag 要报告的诊断对象的共享指针。
    */
   void report(std::shared_ptr<Diagnostic> diag) override;
 
+  /**
+   * @brief 以紧凑形式报告一个诊断，不构造 `Diagnostic` 对象。
+   * @details 这是 IDiagnosticReporter 接口的实现。文件名按下标记录，
+   *          参数文本追加到共享的参数缓冲区。
+   * @param[in] level 诊断的严重级别。
+   * @param[in] code 唯一的诊断代码。
+   * @param[in] location 源代码中的位置。
+   * @param[in] args 格式化消息所需的参数。
+   */
+  void report(DiagnosticLevel level, DiagnosticCode code,
+              const utils::SourceLocation& location,
+              const std::vector<std::string>& args = {}) override;
+
+  /**
+   * @brief 把一个阶段收集的全部错误作为 Error 级别的诊断报告。
+   * @details 元素需提供 `code`、`location` 与 `args` 成员，
+   *          例如 `LexerError` 与 `ParserError`。
+   * @param[in] errors 错误列表。
+   */
+  template <typename ErrorList> void report_errors(const ErrorList& errors) {
+    for (const auto& error : errors) {
+      report(DiagnosticLevel::Error, error.code, error.location, error.args);
+    }
+  }
+
   /**
    * @brief 检查是否报告了任何错误。
    * @details 这是 IDiagnosticReporter 接口的实现。
@@ -267,12 +529,61 @@ public:
     return error_count > 0;
   }
 
+  [[nodiscard]] size_t get_error_count() const noexcept {
+    return error_count;
+  }
+
+  [[nodiscard]] size_t get_warning_count() const noexcept {
+    return warning_count;
+  }
+
+  /**
+   * @brief 获取保存的诊断数（不超过 `set_max_retained` 的上限）。
+   */
+  [[nodiscard]] size_t size() const noexcept {
+    return records.size();
+  }
+
+  /**
+   * @brief 估算保存的诊断占用的字节数（记录、参数池与显式源码行）。
+   */
+  [[nodiscard]] size_t get_memory_bytes() const noexcept;
+
+  /**
+   * @brief 把第 `index` 条保存的诊断还原为 `Diagnostic` 对象（含源码行）。
+   */
+  [[nodiscard]] Diagnostic get_diagnostic(size_t index) const;
+
   /**
    * @brief 将所有收集到的诊断信息打印到标准输出。
    * @param[in] use_color 如果为 true，则使用 ANSI 颜色代码进行打印。
    */
   void print_all(bool use_color = true) const;
 
+  /**
+   * @brief 将所有收集到的诊断信息打印到给定的输出流。
+   * @param[out] os 目标输出流。
+   * @param[in] use_color 如果为 true，则使用 ANSI 颜色代码进行打印。
+   */
+  void print_all(std::ostream& os, bool use_color = true) const;
+
+  /**
+   * @brief 只打印属于给定模块的诊断。
+   * @details 多个编译阶段共享同一个引擎时，用于按阶段报告错误；
+   *          结尾的总结只统计这些模块的错误。
+   * @param[out] os 目标输出流。
+   * @param[in] use_color 如果为 true，则使用 ANSI 颜色代码进行打印。
+   * @param[in] code_prefixes 诊断代码的前缀字母，例如 "PS" 表示语法分析。
+   */
+  void print_all(std::ostream& os, bool use_color,
+                 std::string_view code_prefixes) const;
+
+  /**
+   * @brief 统计属于给定模块的错误数（包括超出保存上限而未保存的）。
+   * @param[in] code_prefixes 诊断代码的前缀字母，例如 "L" 表示词法分析。
+   */
+  [[nodiscard]] size_t get_error_count(std::string_view code_prefixes) const;
+
   /**
    * @brief 获取对内部 I18nMessages 管理器的访问权限。
    * @return 对 I18nMessages 对象的常量引用。
@@ -10,7 +10,9 @@
 
 #include "czc/utils/source_location.hpp"
 
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace czc::diagnostics {
 
@@ -64,6 +66,7 @@ enum class DiagnosticCode {
   P0011_ExpectedTypeAnnotation,  // 期望类型注解
   P0012_ExpectedArrow,           // 期望箭头 ->
   P0013_InvalidAssignmentTarget, // 无效的赋值目标
+  P0014_NestingTooDeep,          // 语法嵌套过深
 
   // === Struct 相关错误 (S0001-S0999) ===
   S0001_ExpectedStructName = 3001,   // 期望结构体名称
@@ -89,6 +92,16 @@ enum class DiagnosticCode {
  */
 std::string diagnostic_code_to_string(DiagnosticCode code);
 
+/**
+ * @brief 将诊断代码的字符串表示（如 "L0001"）解析回 DiagnosticCode。
+ * @details 这是 `diagnostic_code_to_string` 的逆运算，只检查格式，
+ *          不检查该代码是否已在枚举中定义。
+ * @param[in] text 诊断代码的字符串表示。
+ * @return 解析成功时返回诊断代码，格式无效时返回空。
+ */
+std::optional<DiagnosticCode>
+diagnostic_code_from_string(std::string_view text);
+
 } // namespace czc::diagnostics
 
 #endif // CZC_DIAGNOSTIC_CODE_HPP
@@ -8,7 +8,12 @@
 #ifndef CZC_DIAGNOSTIC_REPORTER_HPP
 #define CZC_DIAGNOSTIC_REPORTER_HPP
 
+#include "czc/diagnostics/diagnostic_code.hpp"
+#include "czc/utils/source_location.hpp"
+
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace czc::diagnostics {
 
@@ -38,6 +43,21 @@ public:
    */
   virtual void report(std::shared_ptr<Diagnostic> diag) = 0;
 
+  /**
+   * @brief 以紧凑形式报告一个诊断事件，不要求调用方构造诊断对象。
+   * @details
+   *   各阶段的错误收集器关联报告器后通过此方法直接写入。默认实现构造一个
+   *   `Diagnostic` 并转交给 `report(std::shared_ptr<Diagnostic>)`；
+   *   `DiagnosticEngine` 会改为直接记录，不做任何中间转换。
+   * @param[in] level 诊断的严重级别。
+   * @param[in] code 唯一的诊断代码。
+   * @param[in] location 源代码中的位置。
+   * @param[in] args 格式化消息所需的参数。
+   */
+  virtual void report(DiagnosticLevel level, DiagnosticCode code,
+                      const utils::SourceLocation& location,
+                      const std::vector<std::string>& args);
+
   /**
    * @brief 检查是否已报告任何错误级别的诊断。
    * @details
@@ -46,6 +66,17 @@ public:
    *         否则返回 `false`。
    */
   virtual bool has_errors() const = 0;
+
+  /**
+   * @brief 检查报告的错误数是否已达到上限。
+   * @details
+   *   各阶段的错误收集器每报告一个错误后查询一次，达到上限时各阶段尽快
+   *   停止工作（见 `utils::ErrorCollector::set_error_limit`）。
+   *   默认实现没有上限。
+   */
+  [[nodiscard]] virtual bool error_limit_reached() const noexcept {
+    return false;
+  }
 };
 
 } // namespace czc::diagnostics
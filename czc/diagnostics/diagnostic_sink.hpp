@@ -0,0 +1,149 @@
+/**
+ * @file diagnostic_sink.hpp
+ * @brief 定义了可供多个线程同时报告的诊断接收器 `DiagnosticSink`。
+ * @details
+ *   `DiagnosticEngine` 不是线程安全的。多个文件或多个阶段并行处理、却要
+ *   向同一处报告诊断时，给引擎加锁会让所有线程在报告处排队。
+ *   `DiagnosticSink` 为每个报告线程准备一个只有它自己写入的缓冲区：报告时
+ *   只追加到本线程的缓冲区，再对全局序号做一次原子递增，不加任何锁；
+ *   错误数也按缓冲区分别统计，查询时才汇总。
+ *   线程第一次向某个接收器报告时，以无锁的方式（CAS）把新缓冲区挂到
+ *   接收器的链表上。
+ *
+ *   全部报告结束后，`merge_into` 把各缓冲区的诊断按（文件编号，报告序号）
+ *   排序后交给一个 `DiagnosticEngine`，之后照常打印。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_DIAGNOSTIC_SINK_HPP
+#define CZC_DIAGNOSTIC_SINK_HPP
+
+#include "czc/diagnostics/diagnostic.hpp"
+#include "czc/diagnostics/diagnostic_reporter.hpp"
+#include "czc/utils/source_location.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace czc::diagnostics {
+
+/**
+ * @brief 多生产者、单消费者的诊断接收器。
+ * @details
+ *   合并后的顺序：先按文件编号，同一文件内按报告的先后。`SourceManager`
+ *   按登记顺序分配编号，因此只要在并行开始前按串行处理的顺序登记各文件，
+ *   并且每个文件同一时刻只由一个线程报告（逐文件并行时总是如此），
+ *   合并后 `print_all` 的输出就与串行执行完全一致。
+ *
+ * @property {线程安全} `report` 与 `has_errors` 可以从任意线程并发调用；
+ *           `merge_into`、`size` 与析构只能在所有报告结束后调用。
+ */
+class DiagnosticSink : public IDiagnosticReporter {
+public:
+  DiagnosticSink();
+  ~DiagnosticSink() override;
+
+  DiagnosticSink(const DiagnosticSink&) = delete;
+  DiagnosticSink& operator=(const DiagnosticSink&) = delete;
+
+  /**
+   * @brief 报告一个诊断对象，对象上已设置的源码行会被保留。
+   */
+  void report(std::shared_ptr<Diagnostic> diag) override;
+
+  /**
+   * @brief 以紧凑形式报告一个诊断，追加到当前线程的缓冲区。
+   */
+  void report(DiagnosticLevel level, DiagnosticCode code,
+              const utils::SourceLocation& location,
+              const std::vector<std::string>& args = {}) override;
+
+  /**
+   * @brief 自创建以来是否报告过错误。
+   */
+  bool has_errors() const override {
+    return get_error_count() > 0;
+  }
+
+  /**
+   * @brief 获取自创建以来报告的错误数。
+   */
+  [[nodiscard]] size_t get_error_count() const noexcept;
+
+  /**
+   * @brief 获取尚未合并的诊断数。
+   */
+  [[nodiscard]] size_t size() const noexcept;
+
+  /**
+   * @brief 把全部尚未合并的诊断按（文件编号，报告序号）的顺序报告给
+   *        `engine`，并清空各缓冲区。
+   * @details 错误计数不会清零，`has_errors` 仍反映自创建以来的全部报告。
+   */
+  void merge_into(DiagnosticEngine& engine);
+
+private:
+  // 表示记录不是以诊断对象报告的。
+  static constexpr uint32_t NO_DIAGNOSTIC = UINT32_MAX;
+
+  /**
+   * @brief 一条尚未合并的诊断。
+   * @details 与 `DiagnosticEngine` 一样只保存参数在缓冲区参数池中的区间，
+   *          报告时不为每条诊断单独分配参数列表。
+   */
+  struct Entry {
+    // 接收器内全局递增的报告序号
+    uint64_t sequence;
+    DiagnosticLevel level;
+    DiagnosticCode code;
+    utils::SourceLocation location;
+    // 参数文本在 `Buffer::arg_text` 中的起始字节，长度在
+    // `Buffer::arg_lengths` 的 [first_arg, first_arg + arg_count) 中
+    uint32_t arg_offset;
+    uint32_t first_arg;
+    uint32_t arg_count;
+    // 以诊断对象报告时，对象在 `Buffer::diagnostics` 中的下标
+    uint32_t diagnostic_index;
+  };
+
+  /**
+   * @brief 只由一个线程写入的缓冲区。
+   */
+  struct Buffer {
+    std::vector<Entry> entries;
+    // 各条诊断的参数文本首尾相接
+    std::string arg_text;
+    std::vector<uint32_t> arg_lengths;
+    std::vector<std::shared_ptr<Diagnostic>> diagnostics;
+    // 经由此缓冲区报告的错误数；只有所属线程写入，不需要原子的读改写
+    std::atomic<size_t> error_count{0};
+    Buffer* next = nullptr;
+
+    void clear();
+  };
+
+  /**
+   * @brief 获取当前线程在此接收器上的缓冲区，第一次调用时创建并登记。
+   */
+  Buffer& local_buffer();
+
+  /**
+   * @brief 更新 `buffer` 的错误计数并分配一个报告序号。
+   */
+  uint64_t count(Buffer& buffer, DiagnosticLevel level);
+
+  // 区分不同接收器的编号，线程局部的缓冲区缓存以此查找，永不复用
+  const uint64_t id;
+  // 各线程缓冲区组成的链表，新缓冲区以 CAS 插入表头
+  std::atomic<Buffer*> head{nullptr};
+  std::atomic<uint64_t> next_sequence{0};
+};
+
+} // namespace czc::diagnostics
+
+#endif // CZC_DIAGNOSTIC_SINK_HPP
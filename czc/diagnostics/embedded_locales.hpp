@@ -0,0 +1,52 @@
+/**
+ * @file embedded_locales.hpp
+ * @brief 声明编译进 `czc` 库的诊断消息目录。
+ * @details
+ *   启用 CMake 选项 `CZC_EMBED_LOCALES`（默认开启）时，构建过程会由
+ *   `cmake/EmbedLocales.cmake` 把 `locales/<locale>/diagnostics.toml`
+ *   转换为常量初始化的表，`I18nMessages` 因此无需搜索文件系统、也无需
+ *   解析 TOML 即可加载消息。关闭该选项时目录为空，只从文件加载。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_EMBEDDED_LOCALES_HPP
+#define CZC_EMBEDDED_LOCALES_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace czc::diagnostics {
+
+/**
+ * @brief 一条编译进库的消息模板，字段与 `diagnostics.toml` 中的同名键一致。
+ */
+struct EmbeddedMessage {
+  // 诊断代码的字符串表示，例如 "L0001"
+  const char* code;
+  const char* message;
+  const char* help;
+  const char* source;
+};
+
+/**
+ * @brief 一个编译进库的语言环境。
+ */
+struct EmbeddedLocale {
+  // 语言环境标识符，例如 "en_US"
+  const char* name;
+  const EmbeddedMessage* messages;
+  size_t message_count;
+};
+
+/**
+ * @brief 查找编译进库的语言环境。
+ * @param[in] name 语言环境标识符。
+ * @return 找不到或未启用 `CZC_EMBED_LOCALES` 时返回空。
+ */
+[[nodiscard]] const EmbeddedLocale*
+find_embedded_locale(std::string_view name) noexcept;
+
+} // namespace czc::diagnostics
+
+#endif // CZC_EMBEDDED_LOCALES_HPP
@@ -0,0 +1,165 @@
+/**
+ * @file doc.hpp
+ * @brief 定义了用于自动换行的文档中间表示 `Document` 及其排版器。
+ * @details
+ *   采用 Wadler/Prettier 风格的文档代数：文本（text）、可断行的空白
+ *   （line / softline）、组（group）、缩进（nest）以及按断行状态二选一的
+ *   if_break。格式化器在一行超出 `FormatOptions::max_line_length` 时，
+ *   把该行的表达式转换成文档，再由 `print_document` 决定在哪些组处断行。
+ *
+ *   排版从外向内逐组决定：一个组若能连同其后直到下一个断行点的内容一起
+ *   放进剩余宽度，就整体平铺，否则在该组的 line 处断行，再对内层的组
+ *   重复这一判断。判断只向前扫描至多一行的宽度，决定之后不再回溯，因此
+ *   总耗时与文档大小成线性关系（行宽视为常数）。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_DOC_HPP
+#define CZC_DOC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::formatter {
+
+// 文档节点的编号。
+using DocId = uint32_t;
+
+/**
+ * @brief 文档节点的种类。
+ */
+enum class DocKind : uint8_t {
+  Text,     // 原样输出的文本
+  Line,     // 平铺时为一个空格，断行时为换行加缩进
+  SoftLine, // 平铺时为空，断行时为换行加缩进
+  Concat,   // 依次输出若干子节点
+  Group,    // 排版器在此决定平铺或断行
+  Nest,     // 子节点中的换行多缩进一级
+  IfBreak   // 所在组断行时输出第一个子节点，否则输出第二个
+};
+
+/**
+ * @brief 一棵文档树，节点连续存放、以编号相互引用。
+ * @details 同一个 `Document` 可以 `clear` 后反复使用，保留已分配的容量。
+ * @property {线程安全} 非线程安全。
+ */
+class Document {
+public:
+  /**
+   * @brief 一个文档节点。
+   * @details `first` / `second` 的含义随种类而定：
+   *   - Text：文本在文本池中的偏移与长度，`width` 为显示宽度；
+   *   - Concat：子节点在子节点池中的起始位置与数量；
+   *   - Group / Nest：`first` 为唯一的子节点；
+   *   - IfBreak：`first` 为断行时的子节点，`second` 为平铺时的子节点。
+   */
+  struct Node {
+    DocKind kind;
+    uint32_t first;
+    uint32_t second;
+    uint32_t width;
+  };
+
+  [[nodiscard]] DocId text(std::string_view content);
+
+  /**
+   * @brief 开始一个就地写入的 Text 节点。
+   * @details 调用方把文本追加到返回的字符串末尾，再调用 `end_text`；
+   *          期间不能创建其他节点。
+   */
+  [[nodiscard]] std::string& begin_text() noexcept {
+    pending_text = texts.size();
+    return texts;
+  }
+
+  /**
+   * @brief 结束 `begin_text` 开始的 Text 节点。
+   */
+  [[nodiscard]] DocId end_text();
+
+  [[nodiscard]] DocId line();
+  [[nodiscard]] DocId softline();
+  [[nodiscard]] DocId concat(std::initializer_list<DocId> parts);
+  [[nodiscard]] DocId concat(const std::vector<DocId>& parts);
+  [[nodiscard]] DocId group(DocId content);
+  [[nodiscard]] DocId nest(DocId content);
+  [[nodiscard]] DocId if_break(DocId broken, DocId flat);
+
+  /**
+   * @brief 清空所有节点，保留容量。
+   */
+  void clear() noexcept;
+
+  [[nodiscard]] const Node& get_node(DocId id) const {
+    return nodes[id];
+  }
+
+  /**
+   * @brief 获取 Text 节点的文本。
+   */
+  [[nodiscard]] std::string_view get_text(const Node& node) const {
+    return std::string_view(texts).substr(node.first, node.second);
+  }
+
+  /**
+   * @brief 获取 Concat 节点的第 `index` 个子节点。
+   */
+  [[nodiscard]] DocId get_part(const Node& node, uint32_t index) const {
+    return parts[node.first + index];
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return nodes.size();
+  }
+
+private:
+  DocId add(DocKind kind, uint32_t first, uint32_t second, uint32_t width);
+
+  std::vector<Node> nodes;
+  std::vector<DocId> parts;
+  std::string texts;
+  // `begin_text` 开始时文本池的长度
+  size_t pending_text = 0;
+};
+
+/**
+ * @brief 排版参数。
+ */
+struct DocLayout {
+  // 最大行宽（列）
+  size_t max_width = 80;
+  // 一级缩进输出的文本（若干空格或一个制表符）
+  std::string_view indent_text = "    ";
+  // 一级缩进占用的列数
+  size_t indent_columns = 4;
+  // 文档所在行的基础缩进级别，断行后的行至少缩进到这一级
+  size_t base_level = 0;
+  // 文档开始时所在的列
+  size_t start_column = 0;
+  // 文档之后同一行上还要输出的列数（例如结尾的分号）
+  size_t reserved_tail = 0;
+};
+
+/**
+ * @brief 按给定参数排版文档，并把结果追加到 `out`。
+ * @param[in] doc 文档。
+ * @param[in] root 根节点。
+ * @param[in] layout 排版参数。
+ * @param[out] out 输出缓冲区。
+ */
+void print_document(const Document& doc, DocId root, const DocLayout& layout,
+                    std::string& out);
+
+/**
+ * @brief 计算文本的显示宽度（按 UTF-8 码点计数）。
+ */
+[[nodiscard]] size_t display_width(std::string_view text) noexcept;
+
+} // namespace czc::formatter
+
+#endif // CZC_DOC_HPP
@@ -0,0 +1,102 @@
+/**
+ * @file format_cache.hpp
+ * @brief 定义了 `FormatCache` 类，记录已经格式化过的文件内容。
+ * @details
+ *   缓存以文件内容的长度与 64 位哈希为键：`fmt --check --cache` 对命中的
+ *   文件不做任何格式化就判定通过，两者都相同才算命中，单凭哈希碰撞不能
+ *   让未格式化的文件通过检查。格式化选项与 czc 版本合成一个指纹
+ *   写在缓存文件的首行，指纹不符时整个缓存作废，因此键中无需再包含它们。
+ *   命中缓存的文件可以直接跳过，连词法分析都不必进行。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_FORMAT_CACHE_HPP
+#define CZC_FORMAT_CACHE_HPP
+
+#include "czc/formatter/format_options.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace czc::formatter {
+
+/**
+ * @brief 已格式化内容的哈希集合，可以保存到文件并在下次运行时载入。
+ * @property {线程安全} `contains` 与 `insert` 可以从多个线程并发调用；
+ *           `load` 与 `save` 不能与其他调用并发。
+ */
+class FormatCache {
+public:
+  /**
+   * @param[in] options 本次运行使用的格式化选项。
+   * @param[in] version czc 的版本号。
+   */
+  FormatCache(const FormatOptions& options, std::string_view version);
+
+  /**
+   * @brief 从文件载入缓存。
+   * @details 文件不存在、格式不对或指纹不符时保持为空。
+   * @return 成功载入了与当前指纹相符的缓存时返回 true。
+   */
+  bool load(const std::string& path);
+
+  /**
+   * @brief 把缓存保存到文件（覆盖原有内容）。
+   * @return 写入成功时返回 true。
+   */
+  bool save(const std::string& path) const;
+
+  /**
+   * @brief 内容是否已知为格式化后的结果。
+   */
+  [[nodiscard]] bool contains(std::string_view content) const;
+
+  /**
+   * @brief 记录一段已经格式化的内容。
+   */
+  void insert(std::string_view content);
+
+  [[nodiscard]] size_t size() const noexcept {
+    return entries.size();
+  }
+
+  /**
+   * @brief 计算内容的 64 位 FNV-1a 哈希。
+   */
+  [[nodiscard]] static uint64_t hash_content(std::string_view content) noexcept;
+
+private:
+  /**
+   * @brief 一段已格式化内容的键：长度与哈希。
+   */
+  struct Entry {
+    uint64_t length = 0;
+    uint64_t hash = 0;
+
+    bool operator==(const Entry& other) const noexcept {
+      return length == other.length && hash == other.hash;
+    }
+  };
+
+  struct EntryHash {
+    size_t operator()(const Entry& entry) const noexcept;
+  };
+
+  [[nodiscard]] static Entry make_entry(std::string_view content) noexcept;
+
+  // 格式化选项与版本号的指纹
+  uint64_t fingerprint;
+  // 已格式化内容的键
+  std::unordered_set<Entry, EntryHash> entries;
+  // 保护 `entries`，供并行格式化时共用一个缓存
+  mutable std::mutex mutex;
+};
+
+} // namespace czc::formatter
+
+#endif // CZC_FORMAT_CACHE_HPP
@@ -0,0 +1,122 @@
+/**
+ * @file format_memo.hpp
+ * @brief 定义了 `FormatMemo` 类，按内容寻址地记住顶层声明的格式化结果。
+ * @details
+ *   大型代码库中许多顶层声明（生成的结构体、样板函数）在不同文件中完全
+ *   相同。`FormatMemo` 以声明的原文、格式化选项与缩进级别为键保存格式化
+ *   结果，`Formatter` 遇到相同的声明时直接复用，不再重新排版。
+ *
+ *   顶层声明之间不共享解析状态，声明的原文因此唯一确定了它的子树，进而
+ *   确定了格式化结果；与它在文件中的位置无关。以原文而非逐个节点计算键：
+ *   哈希一段连续的字节比遍历子树快得多，而遍历子树的开销与格式化本身
+ *   相当。键由两个独立的 64 位哈希组成，误认两段不同原文的概率可以忽略。
+ *   结果总量超过上限后不再记录新的结果，已有的结果继续可用。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_FORMAT_MEMO_HPP
+#define CZC_FORMAT_MEMO_HPP
+
+#include "czc/formatter/format_options.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace czc::formatter {
+
+/**
+ * @brief 一个格式化结果的键。
+ */
+struct FormatMemoKey {
+  uint64_t hash = 0;
+  // 以不同方式计算的第二个哈希，用于排除碰撞
+  uint64_t check = 0;
+
+  bool operator==(const FormatMemoKey& other) const noexcept {
+    return hash == other.hash && check == other.check;
+  }
+};
+
+/**
+ * @brief 子树格式化结果的缓存，可在多个文件与多个 `Formatter` 之间共享。
+ * @property {线程安全} 所有成员函数都可以从多个线程并发调用。
+ */
+class FormatMemo {
+public:
+  // 默认的结果总量上限（字节）。
+  static constexpr size_t DEFAULT_MAX_BYTES = 32 * 1024 * 1024;
+
+  /**
+   * @param[in] max_bytes 保存的格式化结果的总字节数上限。
+   */
+  explicit FormatMemo(size_t max_bytes = DEFAULT_MAX_BYTES)
+      : max_bytes(max_bytes) {}
+
+  FormatMemo(const FormatMemo&) = delete;
+  FormatMemo& operator=(const FormatMemo&) = delete;
+
+  /**
+   * @brief 计算一段声明原文在给定选项与缩进级别下的键。
+   * @param[in] text         声明的原文。
+   * @param[in] options      格式化选项。
+   * @param[in] indent_level 声明开始格式化时的缩进级别。
+   */
+  [[nodiscard]] static FormatMemoKey make_key(std::string_view text,
+                                              const FormatOptions& options,
+                                              int indent_level) noexcept;
+
+  /**
+   * @brief 查找键对应的结果，找到时追加到 `out`。
+   * @return 找到时返回 true。
+   */
+  bool lookup(const FormatMemoKey& key, std::string& out) const;
+
+  /**
+   * @brief 记录一个结果；键已存在或总量已达上限时不做任何事。
+   */
+  void insert(const FormatMemoKey& key, std::string_view text);
+
+  /**
+   * @brief 获取保存的结果数。
+   */
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @brief 获取保存的结果总字节数。
+   */
+  [[nodiscard]] size_t get_bytes() const;
+
+  /**
+   * @brief 获取命中的 `lookup` 次数。
+   */
+  [[nodiscard]] size_t get_hit_count() const;
+
+  /**
+   * @brief 获取未命中的 `lookup` 次数。
+   */
+  [[nodiscard]] size_t get_miss_count() const;
+
+private:
+  struct KeyHash {
+    size_t operator()(const FormatMemoKey& key) const noexcept {
+      return static_cast<size_t>(key.hash);
+    }
+  };
+
+  size_t max_bytes;
+  size_t bytes{0};
+  mutable size_t hits{0};
+  mutable size_t misses{0};
+  std::unordered_map<FormatMemoKey, std::string, KeyHash> entries;
+  // 保护以上全部状态，供并行格式化时共用一个缓存
+  mutable std::mutex mutex;
+};
+
+} // namespace czc::formatter
+
+#endif // CZC_FORMAT_MEMO_HPP
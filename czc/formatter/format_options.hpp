@@ -30,7 +30,8 @@ struct FormatOptions {
   IndentStyle indent_style;
   // 缩进宽度 (如果使用空格)
   size_t indent_width;
-  // 最大行长度，用于未来的自动换行功能
+  // 最大行长度，超出时在调用参数、数组元素和二元运算符处自动换行；
+  // 为 0 时不限制
   size_t max_line_length;
   // 是否在函数调用的括号前添加空格
   bool space_before_paren;
@@ -61,6 +62,19 @@ struct FormatOptions {
       : indent_style(style), indent_width(width), max_line_length(max_len),
         space_before_paren(space_paren), space_after_comma(space_comma),
         newline_before_brace(newline_brace) {}
+
+  bool operator==(const FormatOptions& other) const noexcept {
+    return indent_style == other.indent_style &&
+           indent_width == other.indent_width &&
+           max_line_length == other.max_line_length &&
+           space_before_paren == other.space_before_paren &&
+           space_after_comma == other.space_after_comma &&
+           newline_before_brace == other.newline_before_brace;
+  }
+
+  bool operator!=(const FormatOptions& other) const noexcept {
+    return !(*this == other);
+  }
 };
 
 } // namespace czc::formatter
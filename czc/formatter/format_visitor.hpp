@@ -10,8 +10,6 @@
 
 #include "czc/cst/cst_node.hpp"
 
-#include <string>
-
 namespace czc::formatter {
 
 /**
@@ -19,20 +17,21 @@ namespace czc::formatter {
  * @details
  *   采用访问者模式设计，每种 CST 节点类型对应一个 visit 方法。
  *   相比巨大的 switch-case，访问者模式符合开闭原则，更易于扩展和维护。
+ *   visit 方法不返回字符串，而是把节点的格式化结果直接追加到实现者的
+ *   输出缓冲区中，避免父节点反复拼接子节点的结果。
  */
 class FormatVisitor {
 public:
   virtual ~FormatVisitor() = default;
 
   // --- 程序结构 ---
-  virtual std::string visit_program(const cst::CSTNode* node) = 0;
+  virtual void visit_program(const cst::CSTNode* node) = 0;
 
   // --- 声明 ---
 
   /**
    * @brief 访问变量声明节点。
    * @param[in] node 变量声明节点。
-   * @return 格式化后的字符串。
    * @details
    *   变量声明用于在当前作用域中创建新的变量绑定。
    *   支持 let（不可变）和 var（可变）两种声明方式。
@@ -46,12 +45,11 @@ public:
    *   let message = "Hello";
    *   var total = a + b;  // 计算总和
    */
-  virtual std::string visit_var_declaration(const cst::CSTNode* node) = 0;
+  virtual void visit_var_declaration(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问函数声明节点。
    * @param[in] node 函数声明节点。
-   * @return 格式化后的字符串。
    * @details
    *   函数声明定义了一个可重用的代码块，包含名称、参数列表、可选的返回类型和函数体。
    *   格式化时需要处理多个组成部分：
@@ -78,12 +76,11 @@ public:
    *     return x - y;
    *   }
    */
-  virtual std::string visit_fn_declaration(const cst::CSTNode* node) = 0;
+  virtual void visit_fn_declaration(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问结构体声明节点。
    * @param[in] node 结构体声明节点。
-   * @return 格式化后的字符串。
    * @details 格式化结构体定义，包括名称和字段列表。
    * @note 格式: struct Name { field: Type, ... };
    * @example
@@ -92,27 +89,24 @@ public:
    *     age: Integer
    *   };
    */
-  virtual std::string visit_struct_declaration(const cst::CSTNode* node) = 0;
+  virtual void visit_struct_declaration(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问类型别名声明节点。
    * @param[in] node 类型别名声明节点。
-   * @return 格式化后的字符串。
    * @details 格式化类型别名定义，支持复杂类型表达式。
    * @note 格式: type Name = TypeExpr;
    * @example
    *   type User = Person;
    *   type NumberOrString = Integer | String;
    */
-  virtual std::string
-  visit_type_alias_declaration(const cst::CSTNode* node) = 0;
+  virtual void visit_type_alias_declaration(const cst::CSTNode* node) = 0;
 
   // --- 语句 ---
 
   /**
    * @brief 访问返回语句节点。
    * @param[in] node 返回语句节点。
-   * @return 格式化后的字符串。
    * @details
    *   返回语句用于从函数中返回值并终止函数执行。
    * @note 格式: return expr;
@@ -121,12 +115,11 @@ public:
    *   return a + b;
    *   return calculate(x, y);
    */
-  virtual std::string visit_return_stmt(const cst::CSTNode* node) = 0;
+  virtual void visit_return_stmt(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问条件语句节点。
    * @param[in] node 条件语句节点。
-   * @return 格式化后的字符串。
    * @details
    *   条件语句根据条件表达式的真假值来决定执行哪个代码块。
    *   格式化时需要注意括号前的空格、花括号的位置等细节。
@@ -142,12 +135,11 @@ public:
    *     return false;
    *   }
    */
-  virtual std::string visit_if_stmt(const cst::CSTNode* node) = 0;
+  virtual void visit_if_stmt(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问循环语句节点。
    * @param[in] node 循环语句节点。
-   * @return 格式化后的字符串。
    * @details
    *   while 循环在条件为真时重复执行代码块。
    *   格式化规则与 if 语句类似，需要处理条件表达式的括号和代码块的花括号。
@@ -158,12 +150,11 @@ public:
    *     print(i);
    *   }
    */
-  virtual std::string visit_while_stmt(const cst::CSTNode* node) = 0;
+  virtual void visit_while_stmt(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问代码块语句节点。
    * @param[in] node 代码块节点。
-   * @return 格式化后的字符串。
    * @details
    *   代码块是由花括号包围的语句序列，定义了一个新的作用域。
    *   格式化时需要管理缩进级别：进入代码块时增加缩进，退出时减少缩进。
@@ -176,12 +167,11 @@ public:
    *     print(x + y);
    *   }
    */
-  virtual std::string visit_block_stmt(const cst::CSTNode* node) = 0;
+  virtual void visit_block_stmt(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问表达式语句节点。
    * @param[in] node 表达式语句节点。
-   * @return 格式化后的字符串。
    * @details
    *   表达式语句是单独成行的表达式，通常是函数调用、赋值或其他有副作用的表达式。
    *   格式化时需要在行首添加正确的缩进，并在行末添加分号和换行符。
@@ -193,14 +183,13 @@ public:
    *   calculate(x, y);
    *   arr[0] = 42;  // 行内注释
    */
-  virtual std::string visit_expr_stmt(const cst::CSTNode* node) = 0;
+  virtual void visit_expr_stmt(const cst::CSTNode* node) = 0;
 
   // --- 表达式 ---
 
   /**
    * @brief 访问二元表达式节点。
    * @param[in] node 二元表达式节点。
-   * @return 格式化后的字符串。
    * @details
    *   二元表达式由两个操作数和一个中缀运算符组成。
    *   格式化时需要在运算符两侧添加空格以提高可读性。
@@ -213,12 +202,11 @@ public:
    *   count >= 10
    *   isValid && isActive
    */
-  virtual std::string visit_binary_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_binary_expr(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问一元表达式节点。
    * @param[in] node 一元表达式节点。
-   * @return 格式化后的字符串。
    * @details
    *   一元表达式由一个运算符和一个操作数组成。
    *   运算符通常紧贴操作数，不添加额外空格。
@@ -229,12 +217,11 @@ public:
    *   -value
    *   !isEnabled
    */
-  virtual std::string visit_unary_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_unary_expr(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问函数调用表达式节点。
    * @param[in] node 函数调用节点。
-   * @return 格式化后的字符串。
    * @details
    *   函数调用表达式由被调用者（通常是标识符或成员表达式）和参数列表组成。
    *   格式化时保持函数名与左括号之间无空格，参数之间用逗号和空格分隔。
@@ -244,12 +231,11 @@ public:
    *   calculate(x, y, z)
    *   math.sqrt(16)
    */
-  virtual std::string visit_call_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_call_expr(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问索引访问表达式节点。
    * @param[in] node 索引访问节点。
-   * @return 格式化后的字符串。
    * @details
    *   索引访问用于访问数组或类似容器的元素。
    *   格式化时方括号紧贴对象和索引表达式，不添加额外空格。
@@ -259,12 +245,11 @@ public:
    *   matrix[i][j]
    *   data[count - 1]
    */
-  virtual std::string visit_index_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_index_expr(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问成员访问表达式节点。
    * @param[in] node 成员访问节点。
-   * @return 格式化后的字符串。
    * @details
    *   成员访问用于访问对象的属性或方法。
    *   格式化时点号两侧不添加空格，保持紧凑格式。
@@ -274,12 +259,11 @@ public:
    *   math.pi
    *   config.settings.timeout
    */
-  virtual std::string visit_member_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_member_expr(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问赋值表达式节点。
    * @param[in] node 赋值表达式节点。
-   * @return 格式化后的字符串。
    * @details
    *   赋值表达式将右侧的值赋给左侧的变量。
    *   格式化时在等号两侧添加空格以提高可读性。
@@ -290,12 +274,11 @@ public:
    *   name = "Alice"
    *   result = a + b
    */
-  virtual std::string visit_assign_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_assign_expr(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问索引赋值表达式节点。
    * @param[in] node 索引赋值节点。
-   * @return 格式化后的字符串。
    * @details
    *   索引赋值用于修改数组或容器中特定位置的元素值。
    *   格式化时方括号紧贴对象和索引，等号两侧添加空格。
@@ -305,24 +288,22 @@ public:
    *   matrix[i][j] = 0
    *   data[key] = "value"
    */
-  virtual std::string visit_index_assign_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_index_assign_expr(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问成员赋值表达式节点。
    * @param[in] node 成员赋值表达式节点。
-   * @return 格式化后的字符串。
    * @details 格式化对结构体成员的赋值操作。
    * @note 格式: object.member = value
    * @example
    *   person.age = 31
    *   obj.field = new_value
    */
-  virtual std::string visit_member_assign_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_member_assign_expr(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问数组字面量节点。
    * @param[in] node 数组字面量节点。
-   * @return 格式化后的字符串。
    * @details
    *   数组字面量是用方括号包围的元素列表。
    *   格式化时元素之间用逗号分隔，逗号后根据配置选项添加空格。
@@ -333,23 +314,21 @@ public:
    *   ["a", "b", "c"]
    *   [x + 1, y * 2, z - 3]
    */
-  virtual std::string visit_array_literal(const cst::CSTNode* node) = 0;
+  virtual void visit_array_literal(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问结构体字面量节点。
    * @param[in] node 结构体字面量节点。
-   * @return 格式化后的字符串。
    * @details 格式化结构体实例化表达式，包含字段初始化列表。
    * @note 格式: TypeName { field: value, ... }
    * @example
    *   Person { name: "Alice", age: 30 }
    */
-  virtual std::string visit_struct_literal(const cst::CSTNode* node) = 0;
+  virtual void visit_struct_literal(const cst::CSTNode* node) = 0;
 
   /**
    * @brief 访问括号表达式节点。
    * @param[in] node 括号表达式节点。
-   * @return 格式化后的字符串。
    * @details
    *   括号表达式用于改变运算优先级或提高代码可读性。
    *   格式化时保持括号内外的表达式格式，括号与内容之间不添加空格。
@@ -359,40 +338,39 @@ public:
    *   (x * y) + z
    *   ((a + b) * c)
    */
-  virtual std::string visit_paren_expr(const cst::CSTNode* node) = 0;
+  virtual void visit_paren_expr(const cst::CSTNode* node) = 0;
 
   // --- 字面量 ---
-  virtual std::string visit_integer_literal(const cst::CSTNode* node) = 0;
-  virtual std::string visit_float_literal(const cst::CSTNode* node) = 0;
-  virtual std::string visit_string_literal(const cst::CSTNode* node) = 0;
-  virtual std::string visit_boolean_literal(const cst::CSTNode* node) = 0;
-  virtual std::string visit_identifier(const cst::CSTNode* node) = 0;
+  virtual void visit_integer_literal(const cst::CSTNode* node) = 0;
+  virtual void visit_float_literal(const cst::CSTNode* node) = 0;
+  virtual void visit_string_literal(const cst::CSTNode* node) = 0;
+  virtual void visit_boolean_literal(const cst::CSTNode* node) = 0;
+  virtual void visit_identifier(const cst::CSTNode* node) = 0;
 
   // --- 类型 ---
-  virtual std::string visit_type_annotation(const cst::CSTNode* node) = 0;
-  virtual std::string visit_array_type(const cst::CSTNode* node) = 0;
-  virtual std::string visit_sized_array_type(const cst::CSTNode* node) = 0;
-  virtual std::string visit_tuple_literal(const cst::CSTNode* node) = 0;
-  virtual std::string visit_function_literal(const cst::CSTNode* node) = 0;
-  virtual std::string visit_union_type(const cst::CSTNode* node) = 0;
-  virtual std::string visit_intersection_type(const cst::CSTNode* node) = 0;
-  virtual std::string visit_negation_type(const cst::CSTNode* node) = 0;
-  virtual std::string visit_tuple_type(const cst::CSTNode* node) = 0;
-  virtual std::string
-  visit_function_signature_type(const cst::CSTNode* node) = 0;
-  virtual std::string visit_anonymous_struct_type(const cst::CSTNode* node) = 0;
-  virtual std::string visit_struct_field(const cst::CSTNode* node) = 0;
+  virtual void visit_type_annotation(const cst::CSTNode* node) = 0;
+  virtual void visit_array_type(const cst::CSTNode* node) = 0;
+  virtual void visit_sized_array_type(const cst::CSTNode* node) = 0;
+  virtual void visit_tuple_literal(const cst::CSTNode* node) = 0;
+  virtual void visit_function_literal(const cst::CSTNode* node) = 0;
+  virtual void visit_union_type(const cst::CSTNode* node) = 0;
+  virtual void visit_intersection_type(const cst::CSTNode* node) = 0;
+  virtual void visit_negation_type(const cst::CSTNode* node) = 0;
+  virtual void visit_tuple_type(const cst::CSTNode* node) = 0;
+  virtual void visit_function_signature_type(const cst::CSTNode* node) = 0;
+  virtual void visit_anonymous_struct_type(const cst::CSTNode* node) = 0;
+  virtual void visit_struct_field(const cst::CSTNode* node) = 0;
 
   // --- 参数和列表 ---
-  virtual std::string visit_parameter(const cst::CSTNode* node) = 0;
-  virtual std::string visit_parameter_list(const cst::CSTNode* node) = 0;
-  virtual std::string visit_argument_list(const cst::CSTNode* node) = 0;
-  virtual std::string visit_statement_list(const cst::CSTNode* node) = 0;
+  virtual void visit_parameter(const cst::CSTNode* node) = 0;
+  virtual void visit_parameter_list(const cst::CSTNode* node) = 0;
+  virtual void visit_argument_list(const cst::CSTNode* node) = 0;
+  virtual void visit_statement_list(const cst::CSTNode* node) = 0;
 
   // --- 符号 ---
-  virtual std::string visit_operator(const cst::CSTNode* node) = 0;
-  virtual std::string visit_delimiter(const cst::CSTNode* node) = 0;
-  virtual std::string visit_comment(const cst::CSTNode* node) = 0;
+  virtual void visit_operator(const cst::CSTNode* node) = 0;
+  virtual void visit_delimiter(const cst::CSTNode* node) = 0;
+  virtual void visit_comment(const cst::CSTNode* node) = 0;
 };
 
 } // namespace czc::formatter
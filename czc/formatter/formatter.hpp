@@ -8,13 +8,20 @@
 #ifndef CZC_FORMATTER_HPP
 #define CZC_FORMATTER_HPP
 
+#include "czc/cst/comment_table.hpp"
 #include "czc/cst/cst_node.hpp"
+#include "czc/formatter/doc.hpp"
 #include "czc/formatter/error_collector.hpp"
+#include "czc/formatter/format_memo.hpp"
 #include "czc/formatter/format_options.hpp"
 #include "czc/formatter/format_visitor.hpp"
+#include "czc/formatter/output_sink.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace czc::formatter {
 
@@ -25,6 +32,16 @@ const std::string FOUR_WIDTH_SPACE_STRING = "    "; // 四个空格字符串常
 
 const std::string TAB_STRING = "\t"; // 制表符字符串常量
 
+/**
+ * @brief 对源码的一处文本替换。
+ * @details 把源码中的字节区间 [start_offset, end_offset) 替换为 `new_text`。
+ */
+struct TextEdit {
+  size_t start_offset;
+  size_t end_offset;
+  std::string new_text;
+};
+
 /**
  * @brief 将 CST 格式化为美化的源代码。
  * @details 此类通过访问者模式遍历
@@ -32,7 +49,7 @@ const std::string TAB_STRING = "\t"; // 制表符字符串常量
  *          生成符合编码规范的可读源代码。它是实现 `zero format` 命令的核心。
  * @property {线程安全} 非线程安全。格式化过程是有状态的（例如，跟踪缩进级别）。
  */
-class Formatter : public FormatVisitor {
+class Formatter final : public FormatVisitor {
 public:
   /**
    * @brief 构造一个新的 Formatter 实例。
@@ -49,6 +66,88 @@ public:
    */
   [[nodiscard]] std::string format(const cst::CSTNode* root);
 
+  /**
+   * @brief 格式化给定的 CST 树，并把结果写入输出端。
+   * @details
+   *   结果先追加到格式化器内部可复用的缓冲区中，每当缓冲区超过
+   *   `SINK_FLUSH_THRESHOLD` 就在顶层声明之间交给 `sink`，结束时交出剩余
+   *   部分。多次调用之间缓冲区的容量得以保留。
+   * @param[in] root 指向 CST 根节点的指针，为空时不写入任何内容。
+   * @param[in] sink 输出端。
+   */
+  void format_to(const cst::CSTNode* root, OutputSink& sink);
+
+  /**
+   * @brief 判断源码是否已经是格式化后的样子。
+   * @details
+   *   格式化结果不落地，而是在每个顶层声明之后与 `source` 的对应部分比较，
+   *   出现第一处差异时立即停止，不再格式化后面的声明。
+   * @param[in] root 指向 CST 根节点的指针。
+   * @param[in] source 生成该 CST 的源码。
+   * @return 格式化结果与 `source` 完全相同时返回 true。
+   */
+  [[nodiscard]] bool is_formatted(const cst::CSTNode* root,
+                                  std::string_view source);
+
+  /**
+   * @brief 只格式化与给定字节区间重叠的声明或语句。
+   * @details
+   *   借助 token 的字节偏移，在顶层声明中二分查找与区间重叠的部分；若区间
+   *   完全落在某个代码块的花括号之内，则继续进入该代码块的语句列表，直到
+   *   找到包住区间的最小一组声明或语句。只有这组节点会被格式化，因此耗时
+   *   与文件大小无关。
+   *
+   *   替换区间尽量扩展到整行：节点前只有空白时从行首开始，节点后只有空白
+   *   时一直到行尾的换行符（含）。格式化结果与原文相同时不产生替换。
+   *   替换区间以节点的 Token 为界，注释必须在树中：设置了注释表时不产生
+   *   任何替换。
+   * @param[in] root 指向 CST 根节点的指针。
+   * @param[in] source 生成该 CST 的源码，用于确定行的边界。
+   * @param[in] start_offset 区间起点（字节）。
+   * @param[in] end_offset 区间终点（字节），与起点相同时表示光标位置。
+   * @return 需要应用到源码上的替换，按偏移升序排列，可能为空。
+   */
+  [[nodiscard]] std::vector<TextEdit> format_range(const cst::CSTNode* root,
+                                                   std::string_view source,
+                                                   size_t start_offset,
+                                                   size_t end_offset);
+
+  // `format_to` 在顶层声明之间交出缓冲区内容的阈值（字节）。
+  static constexpr size_t SINK_FLUSH_THRESHOLD = 64 * 1024;
+
+  /**
+   * @brief 设置顶层声明格式化结果的缓存。
+   * @details 设置后，每个顶层声明先以其原文在缓存中查找，命中时直接输出
+   *          保存的结果，否则照常格式化并记录结果。原文无法确定的声明
+   *          （首尾是虚拟 Token）照常格式化。
+   * @param[in] memo   缓存，为空时不使用；必须比格式化器活得更久，可以与
+   *                   其他格式化器共用。
+   * @param[in] source 之后要格式化的 CST 的源码，必须在格式化期间有效。
+   */
+  void set_memo(FormatMemo* memo, std::string_view source) noexcept {
+    this->memo = memo;
+    memo_source = source;
+  }
+
+  /**
+   * @brief 设置之后格式化的 CST 的注释表。
+   * @details CST 由设置了注释表的 Parser 解析时（见
+   *          `parser::Parser::set_comment_table`），注释不在树中，而是
+   *          按所附着的节点从表中取出，输出与带注释节点的树相同。
+   * @param[in] table 注释表，为空时只输出树中的 `Comment` 节点；必须在
+   *                  格式化期间有效。
+   */
+  void set_comment_table(const cst::CommentTable* table) noexcept {
+    comments = table;
+  }
+
+  /**
+   * @brief 获取构造时给定的格式化选项。
+   */
+  [[nodiscard]] const FormatOptions& get_options() const noexcept {
+    return options;
+  }
+
   /**
    * @brief 获取对内部错误收集器的访问权限。
    * @return 对 FormatterErrorCollector 对象的引用。
@@ -66,51 +165,51 @@ public:
   }
 
   // --- FormatVisitor 接口实现 ---
-  std::string visit_program(const cst::CSTNode* node) override;
-  std::string visit_var_declaration(const cst::CSTNode* node) override;
-  std::string visit_fn_declaration(const cst::CSTNode* node) override;
-  std::string visit_struct_declaration(const cst::CSTNode* node) override;
-  std::string visit_type_alias_declaration(const cst::CSTNode* node) override;
-  std::string visit_return_stmt(const cst::CSTNode* node) override;
-  std::string visit_if_stmt(const cst::CSTNode* node) override;
-  std::string visit_while_stmt(const cst::CSTNode* node) override;
-  std::string visit_block_stmt(const cst::CSTNode* node) override;
-  std::string visit_expr_stmt(const cst::CSTNode* node) override;
-  std::string visit_binary_expr(const cst::CSTNode* node) override;
-  std::string visit_unary_expr(const cst::CSTNode* node) override;
-  std::string visit_call_expr(const cst::CSTNode* node) override;
-  std::string visit_index_expr(const cst::CSTNode* node) override;
-  std::string visit_member_expr(const cst::CSTNode* node) override;
-  std::string visit_assign_expr(const cst::CSTNode* node) override;
-  std::string visit_index_assign_expr(const cst::CSTNode* node) override;
-  std::string visit_member_assign_expr(const cst::CSTNode* node) override;
-  std::string visit_array_literal(const cst::CSTNode* node) override;
-  std::string visit_struct_literal(const cst::CSTNode* node) override;
-  std::string visit_paren_expr(const cst::CSTNode* node) override;
-  std::string visit_integer_literal(const cst::CSTNode* node) override;
-  std::string visit_float_literal(const cst::CSTNode* node) override;
-  std::string visit_string_literal(const cst::CSTNode* node) override;
-  std::string visit_boolean_literal(const cst::CSTNode* node) override;
-  std::string visit_identifier(const cst::CSTNode* node) override;
-  std::string visit_type_annotation(const cst::CSTNode* node) override;
-  std::string visit_array_type(const cst::CSTNode* node) override;
-  std::string visit_sized_array_type(const cst::CSTNode* node) override;
-  std::string visit_tuple_literal(const cst::CSTNode* node) override;
-  std::string visit_function_literal(const cst::CSTNode* node) override;
-  std::string visit_union_type(const cst::CSTNode* node) override;
-  std::string visit_intersection_type(const cst::CSTNode* node) override;
-  std::string visit_negation_type(const cst::CSTNode* node) override;
-  std::string visit_tuple_type(const cst::CSTNode* node) override;
-  std::string visit_function_signature_type(const cst::CSTNode* node) override;
-  std::string visit_anonymous_struct_type(const cst::CSTNode* node) override;
-  std::string visit_struct_field(const cst::CSTNode* node) override;
-  std::string visit_parameter(const cst::CSTNode* node) override;
-  std::string visit_parameter_list(const cst::CSTNode* node) override;
-  std::string visit_argument_list(const cst::CSTNode* node) override;
-  std::string visit_statement_list(const cst::CSTNode* node) override;
-  std::string visit_operator(const cst::CSTNode* node) override;
-  std::string visit_delimiter(const cst::CSTNode* node) override;
-  std::string visit_comment(const cst::CSTNode* node) override;
+  void visit_program(const cst::CSTNode* node) override;
+  void visit_var_declaration(const cst::CSTNode* node) override;
+  void visit_fn_declaration(const cst::CSTNode* node) override;
+  void visit_struct_declaration(const cst::CSTNode* node) override;
+  void visit_type_alias_declaration(const cst::CSTNode* node) override;
+  void visit_return_stmt(const cst::CSTNode* node) override;
+  void visit_if_stmt(const cst::CSTNode* node) override;
+  void visit_while_stmt(const cst::CSTNode* node) override;
+  void visit_block_stmt(const cst::CSTNode* node) override;
+  void visit_expr_stmt(const cst::CSTNode* node) override;
+  void visit_binary_expr(const cst::CSTNode* node) override;
+  void visit_unary_expr(const cst::CSTNode* node) override;
+  void visit_call_expr(const cst::CSTNode* node) override;
+  void visit_index_expr(const cst::CSTNode* node) override;
+  void visit_member_expr(const cst::CSTNode* node) override;
+  void visit_assign_expr(const cst::CSTNode* node) override;
+  void visit_index_assign_expr(const cst::CSTNode* node) override;
+  void visit_member_assign_expr(const cst::CSTNode* node) override;
+  void visit_array_literal(const cst::CSTNode* node) override;
+  void visit_struct_literal(const cst::CSTNode* node) override;
+  void visit_paren_expr(const cst::CSTNode* node) override;
+  void visit_integer_literal(const cst::CSTNode* node) override;
+  void visit_float_literal(const cst::CSTNode* node) override;
+  void visit_string_literal(const cst::CSTNode* node) override;
+  void visit_boolean_literal(const cst::CSTNode* node) override;
+  void visit_identifier(const cst::CSTNode* node) override;
+  void visit_type_annotation(const cst::CSTNode* node) override;
+  void visit_array_type(const cst::CSTNode* node) override;
+  void visit_sized_array_type(const cst::CSTNode* node) override;
+  void visit_tuple_literal(const cst::CSTNode* node) override;
+  void visit_function_literal(const cst::CSTNode* node) override;
+  void visit_union_type(const cst::CSTNode* node) override;
+  void visit_intersection_type(const cst::CSTNode* node) override;
+  void visit_negation_type(const cst::CSTNode* node) override;
+  void visit_tuple_type(const cst::CSTNode* node) override;
+  void visit_function_signature_type(const cst::CSTNode* node) override;
+  void visit_anonymous_struct_type(const cst::CSTNode* node) override;
+  void visit_struct_field(const cst::CSTNode* node) override;
+  void visit_parameter(const cst::CSTNode* node) override;
+  void visit_parameter_list(const cst::CSTNode* node) override;
+  void visit_argument_list(const cst::CSTNode* node) override;
+  void visit_statement_list(const cst::CSTNode* node) override;
+  void visit_operator(const cst::CSTNode* node) override;
+  void visit_delimiter(const cst::CSTNode* node) override;
+  void visit_comment(const cst::CSTNode* node) override;
 
 private:
   // 格式化选项
@@ -119,21 +218,57 @@ private:
   FormatterErrorCollector error_collector;
   // 当前缩进级别
   int indent_level;
+  // 一长串空格或制表符，任意深度的缩进都是它的前缀
+  std::string indent_cache;
+  // 当前的输出目标：`format` 的返回值或 `format_to` 的内部缓冲区
+  std::string* out = nullptr;
+  // `format_to` 复用的缓冲区
+  std::string buffer;
+  // `format_to` 的输出端，`format` 期间为空
+  OutputSink* sink = nullptr;
+  // 缓冲区超过多少字节时交给输出端
+  size_t flush_threshold = SINK_FLUSH_THRESHOLD;
+  // 下一个 if 语句紧跟在 else 之后，不输出缩进
+  bool inline_next_if = false;
+  // 自动换行时复用的文档
+  Document doc;
+  // 正在构建文档，此时表达式只平铺输出
+  bool building_doc = false;
+  // 顶层声明格式化结果的缓存，为空时不使用
+  FormatMemo* memo = nullptr;
+  // 正在格式化的 CST 的源码，声明的原文取自其中
+  std::string_view memo_source;
+  // 树外的注释，为空时注释都在树中
+  const cst::CommentTable* comments = nullptr;
+
+  /**
+   * @brief 追加一段文本到当前输出。
+   */
+  void emit(std::string_view text) {
+    out->append(text);
+  }
+
+  /**
+   * @brief 把缓冲区的内容交给输出端。
+   * @param[in] force 为 false 时只在缓冲区超过阈值时交出。
+   */
+  void flush_to_sink(bool force);
 
   /**
    * @brief 递归地格式化单个 CST 节点。
    * @details 这是格式化逻辑的核心，它根据节点的类型（`CSTNodeType`）
-   *          应用不同的格式化规则。
+   *          应用不同的格式化规则：按类型索引处理函数表，直接调用对应的
+   *          `visit_*`，不经过虚函数分派（因此本类为 `final`）。
    * @param[in] node 要格式化的节点。
-   * @return 该节点及其子节点格式化后的字符串。
    */
-  std::string format_node(const cst::CSTNode* node);
+  void format_node(const cst::CSTNode* node);
 
   /**
-   * @brief 根据当前缩进级别和选项生成缩进字符串。
-   * @return 由空格或制表符组成的缩进字符串。
+   * @brief 获取当前缩进级别对应的缩进。
+   * @details 返回 `indent_cache` 的前缀，只在缩进比缓存更深时才扩容。
+   * @return 由空格或制表符组成的缩进，在下一次调用前有效。
    */
-  std::string get_indent() const;
+  std::string_view get_indent();
 
   /**
    * @brief 增加缩进级别。
@@ -151,21 +286,65 @@ private:
     }
   }
 
+  /**
+   * @brief 格式化语句中的一个表达式，必要时自动换行。
+   * @details
+   *   先照常平铺输出；若该行因此超出 `FormatOptions::max_line_length`，
+   *   则撤销这段输出，把表达式转换成文档后重新排版。调用、数组字面量和
+   *   二元运算链可以在参数、元素和运算符处断行。
+   * @param[in] node 表达式节点（也可以是语句中的其他子节点，会原样输出）。
+   * @param[in] next 同一行上紧随其后的兄弟节点（如分号），可以为空。
+   */
+  void format_expression(const cst::CSTNode* node, const cst::CSTNode* next);
+
+  /**
+   * @brief 把表达式转换为 `doc` 中的文档节点。
+   */
+  DocId build_doc(const cst::CSTNode* node);
+
+  /**
+   * @brief 为逗号分隔的列表构建可断行的文档。
+   * @param[in] items 列表中的元素与逗号，取 `[begin, end)` 一段。
+   */
+  DocId build_list_doc(const cst::CSTChildList& items, size_t begin,
+                       size_t end);
+
+  /**
+   * @brief 以平铺形式格式化节点，并作为文本节点加入 `doc`。
+   */
+  DocId build_flat_doc(const cst::CSTNode* node);
+
+  /**
+   * @brief 格式化一个顶层声明，设置了缓存时先在缓存中查找。
+   */
+  void format_top_level(const cst::CSTNode* node);
+
   /**
    * @brief 格式化行内注释（在语句后）。
    * @details 在注释前添加固定的两个空格。
    * @param[in] comment 注释节点。
-   * @return 格式化后的注释字符串，前置两个空格。
    */
-  std::string format_inline_comment(const cst::CSTNode* comment);
+  void format_inline_comment(const cst::CSTNode* comment);
 
   /**
    * @brief 格式化独立行注释。
    * @details 添加当前缩进并在末尾换行。
    * @param[in] comment 注释节点。
-   * @return 格式化后的注释字符串，带缩进和换行。
    */
-  std::string format_standalone_comment(const cst::CSTNode* comment);
+  void format_standalone_comment(const cst::CSTNode* comment);
+
+  /**
+   * @brief 以行内注释的形式输出注释表中附着在 `node` 之后的注释。
+   */
+  void format_trailing_comments(const cst::CSTNode* node);
+
+  /**
+   * @brief 以独立行注释的形式输出注释表中附着在 `node` 上的注释。
+   * @param[in] node      所附着的节点，为空表示文件末尾。
+   * @param[in] placement `Leading` 或 `Dangling`。
+   */
+  void format_standalone_comments(const cst::CSTNode* node,
+                                  cst::CommentPlacement placement);
 };
 
 } // namespace czc::formatter
@@ -12,9 +12,11 @@
 #include "czc/formatter/error_collector.hpp"
 #include "czc/formatter/format_options.hpp"
 #include "czc/formatter/format_visitor.hpp"
+#include "czc/formatter/output_sink.hpp"
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace czc::cst {
 // 前向声明 - 避免包含完整头文件
@@ -51,6 +53,13 @@ public:
    */
   std::string format(const cst::CSTNode* root);
 
+  /**
+   * @brief 格式化给定的 CST 树，并把结果写入输出端
+   * @param[in] root 指向 CST 根节点的指针
+   * @param[in] sink 输出端
+   */
+  void format_to(const cst::CSTNode* root, OutputSink& sink);
+
   /**
    * @brief 获取对内部错误收集器的访问权限
    * @return 对 FormatterErrorCollector 对象的引用
@@ -69,66 +78,65 @@ public:
 
   // --- FormatVisitor 接口实现 ---
   // 所有方法都使用指针参数，避免完整类型定义
-  std::string visit_program(const cst::CSTNode* node) override;
-  std::string visit_var_declaration(const cst::CSTNode* node) override;
-  std::string visit_fn_declaration(const cst::CSTNode* node) override;
-  std::string visit_struct_declaration(const cst::CSTNode* node) override;
-  std::string visit_type_alias_declaration(const cst::CSTNode* node) override;
-  std::string visit_return_stmt(const cst::CSTNode* node) override;
-  std::string visit_if_stmt(const cst::CSTNode* node) override;
-  std::string visit_while_stmt(const cst::CSTNode* node) override;
-  std::string visit_block_stmt(const cst::CSTNode* node) override;
-  std::string visit_expr_stmt(const cst::CSTNode* node) override;
-  std::string visit_binary_expr(const cst::CSTNode* node) override;
-  std::string visit_unary_expr(const cst::CSTNode* node) override;
-  std::string visit_call_expr(const cst::CSTNode* node) override;
-  std::string visit_index_expr(const cst::CSTNode* node) override;
-  std::string visit_member_expr(const cst::CSTNode* node) override;
-  std::string visit_assign_expr(const cst::CSTNode* node) override;
-  std::string visit_index_assign_expr(const cst::CSTNode* node) override;
-  std::string visit_member_assign_expr(const cst::CSTNode* node) override;
-  std::string visit_array_literal(const cst::CSTNode* node) override;
-  std::string visit_struct_literal(const cst::CSTNode* node) override;
-  std::string visit_paren_expr(const cst::CSTNode* node) override;
-  std::string visit_integer_literal(const cst::CSTNode* node) override;
-  std::string visit_float_literal(const cst::CSTNode* node) override;
-  std::string visit_string_literal(const cst::CSTNode* node) override;
-  std::string visit_boolean_literal(const cst::CSTNode* node) override;
-  std::string visit_identifier(const cst::CSTNode* node) override;
-  std::string visit_type_annotation(const cst::CSTNode* node) override;
-  std::string visit_array_type(const cst::CSTNode* node) override;
-  std::string visit_sized_array_type(const cst::CSTNode* node) override;
-  std::string visit_tuple_literal(const cst::CSTNode* node) override;
-  std::string visit_function_literal(const cst::CSTNode* node) override;
-  std::string visit_union_type(const cst::CSTNode* node) override;
-  std::string visit_intersection_type(const cst::CSTNode* node) override;
-  std::string visit_negation_type(const cst::CSTNode* node) override;
-  std::string visit_tuple_type(const cst::CSTNode* node) override;
-  std::string visit_function_signature_type(const cst::CSTNode* node) override;
-  std::string visit_anonymous_struct_type(const cst::CSTNode* node) override;
-  std::string visit_struct_field(const cst::CSTNode* node) override;
-  std::string visit_parameter(const cst::CSTNode* node) override;
-  std::string visit_parameter_list(const cst::CSTNode* node) override;
-  std::string visit_argument_list(const cst::CSTNode* node) override;
-  std::string visit_statement_list(const cst::CSTNode* node) override;
-  std::string visit_operator(const cst::CSTNode* node) override;
-  std::string visit_delimiter(const cst::CSTNode* node) override;
-  std::string visit_comment(const cst::CSTNode* node) override;
+  void visit_program(const cst::CSTNode* node) override;
+  void visit_var_declaration(const cst::CSTNode* node) override;
+  void visit_fn_declaration(const cst::CSTNode* node) override;
+  void visit_struct_declaration(const cst::CSTNode* node) override;
+  void visit_type_alias_declaration(const cst::CSTNode* node) override;
+  void visit_return_stmt(const cst::CSTNode* node) override;
+  void visit_if_stmt(const cst::CSTNode* node) override;
+  void visit_while_stmt(const cst::CSTNode* node) override;
+  void visit_block_stmt(const cst::CSTNode* node) override;
+  void visit_expr_stmt(const cst::CSTNode* node) override;
+  void visit_binary_expr(const cst::CSTNode* node) override;
+  void visit_unary_expr(const cst::CSTNode* node) override;
+  void visit_call_expr(const cst::CSTNode* node) override;
+  void visit_index_expr(const cst::CSTNode* node) override;
+  void visit_member_expr(const cst::CSTNode* node) override;
+  void visit_assign_expr(const cst::CSTNode* node) override;
+  void visit_index_assign_expr(const cst::CSTNode* node) override;
+  void visit_member_assign_expr(const cst::CSTNode* node) override;
+  void visit_array_literal(const cst::CSTNode* node) override;
+  void visit_struct_literal(const cst::CSTNode* node) override;
+  void visit_paren_expr(const cst::CSTNode* node) override;
+  void visit_integer_literal(const cst::CSTNode* node) override;
+  void visit_float_literal(const cst::CSTNode* node) override;
+  void visit_string_literal(const cst::CSTNode* node) override;
+  void visit_boolean_literal(const cst::CSTNode* node) override;
+  void visit_identifier(const cst::CSTNode* node) override;
+  void visit_type_annotation(const cst::CSTNode* node) override;
+  void visit_array_type(const cst::CSTNode* node) override;
+  void visit_sized_array_type(const cst::CSTNode* node) override;
+  void visit_tuple_literal(const cst::CSTNode* node) override;
+  void visit_function_literal(const cst::CSTNode* node) override;
+  void visit_union_type(const cst::CSTNode* node) override;
+  void visit_intersection_type(const cst::CSTNode* node) override;
+  void visit_negation_type(const cst::CSTNode* node) override;
+  void visit_tuple_type(const cst::CSTNode* node) override;
+  void visit_function_signature_type(const cst::CSTNode* node) override;
+  void visit_anonymous_struct_type(const cst::CSTNode* node) override;
+  void visit_struct_field(const cst::CSTNode* node) override;
+  void visit_parameter(const cst::CSTNode* node) override;
+  void visit_parameter_list(const cst::CSTNode* node) override;
+  void visit_argument_list(const cst::CSTNode* node) override;
+  void visit_statement_list(const cst::CSTNode* node) override;
+  void visit_operator(const cst::CSTNode* node) override;
+  void visit_delimiter(const cst::CSTNode* node) override;
+  void visit_comment(const cst::CSTNode* node) override;
 
 private:
   /**
    * @brief 递归地格式化单个 CST 节点
    * @details 这是格式化逻辑的核心，在实现文件中定义
    * @param[in] node 要格式化的节点
-   * @return 该节点及其子节点格式化后的字符串
    */
-  std::string format_node(const cst::CSTNode* node);
+  void format_node(const cst::CSTNode* node);
 
   /**
-   * @brief 根据当前缩进级别和选项生成缩进字符串
-   * @return 由空格或制表符组成的缩进字符串
+   * @brief 获取当前缩进级别对应的缩进
+   * @return 由空格或制表符组成的缩进，在下一次调用前有效
    */
-  std::string get_indent() const;
+  std::string_view get_indent();
 
   /**
    * @brief 增加缩进级别
@@ -149,21 +157,37 @@ private:
   /**
    * @brief 格式化行内注释（在语句后）
    * @param[in] comment 注释节点
-   * @return 格式化后的注释字符串，前置两个空格
    */
-  std::string format_inline_comment(const cst::CSTNode* comment);
+  void format_inline_comment(const cst::CSTNode* comment);
 
   /**
    * @brief 格式化独立行注释
    * @param[in] comment 注释节点
-   * @return 格式化后的注释字符串，带缩进和换行
    */
-  std::string format_standalone_comment(const cst::CSTNode* comment);
+  void format_standalone_comment(const cst::CSTNode* comment);
+
+  /**
+   * @brief 追加一段文本到当前输出
+   */
+  void emit(std::string_view text) {
+    out->append(text);
+  }
+
+  /**
+   * @brief 把缓冲区的内容交给输出端
+   * @param[in] force 为 false 时只在缓冲区超过阈值时交出
+   */
+  void flush_to_sink(bool force);
 
   // 成员变量
   FormatOptions options;                   ///< 格式化选项
   FormatterErrorCollector error_collector; ///< 错误收集器
   int indent_level;                        ///< 当前缩进级别
+  std::string indent_cache;                ///< 缩进的共享前缀缓存
+  std::string* out = nullptr;              ///< 当前的输出目标
+  std::string buffer;                      ///< `format_to` 复用的缓冲区
+  OutputSink* sink = nullptr;              ///< `format_to` 的输出端
+  bool inline_next_if = false;             ///< 下一个 if 紧跟在 else 之后
 };
 
 /**
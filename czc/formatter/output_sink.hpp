@@ -0,0 +1,119 @@
+/**
+ * @file output_sink.hpp
+ * @brief 定义了格式化结果的输出端 `OutputSink` 及其常用实现。
+ * @details
+ *   `Formatter::format_to` 把格式化结果写入一个输出端，而不是返回字符串。
+ *   格式化器内部只维护一块可复用的缓冲区，每格式化完若干顶层声明就把
+ *   缓冲区的内容交给输出端，因此输出端收到的是较大的连续片段。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_OUTPUT_SINK_HPP
+#define CZC_OUTPUT_SINK_HPP
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace czc::formatter {
+
+/**
+ * @brief 格式化结果的输出端接口。
+ */
+class OutputSink {
+public:
+  virtual ~OutputSink() = default;
+
+  /**
+   * @brief 追加一段已格式化的文本。
+   * @param[in] text 文本内容，调用返回后不再引用。
+   */
+  virtual void write(std::string_view text) = 0;
+
+  /**
+   * @brief 输出端是否已不再需要后续内容。
+   * @details 返回 true 时格式化器在下一个顶层声明之前停止。
+   */
+  [[nodiscard]] virtual bool is_finished() const {
+    return false;
+  }
+};
+
+/**
+ * @brief 把格式化结果追加到一个字符串中。
+ */
+class StringSink : public OutputSink {
+public:
+  /**
+   * @param[in] target 目标字符串，必须比本对象活得更久。
+   */
+  explicit StringSink(std::string& target) : target(target) {}
+
+  void write(std::string_view text) override {
+    target.append(text);
+  }
+
+private:
+  std::string& target;
+};
+
+/**
+ * @brief 把格式化结果写入一个输出流（如文件或标准输出）。
+ */
+class StreamSink : public OutputSink {
+public:
+  /**
+   * @param[in] stream 目标流，必须比本对象活得更久。
+   */
+  explicit StreamSink(std::ostream& stream) : stream(stream) {}
+
+  void write(std::string_view text) override {
+    stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+  }
+
+private:
+  std::ostream& stream;
+};
+
+/**
+ * @brief 把格式化结果与期望的文本逐段比较，不保存任何输出。
+ * @details 一旦出现差异即进入结束状态，格式化器随之停止，
+ *          用于 `--check` 模式判断文件是否已经格式化。
+ */
+class CompareSink : public OutputSink {
+public:
+  /**
+   * @param[in] expected 期望的文本，必须比本对象活得更久。
+   */
+  explicit CompareSink(std::string_view expected) : expected(expected) {}
+
+  void write(std::string_view text) override {
+    if (!differs && expected.substr(matched, text.size()) == text) {
+      matched += text.size();
+    } else {
+      differs = true;
+    }
+  }
+
+  [[nodiscard]] bool is_finished() const override {
+    return differs;
+  }
+
+  /**
+   * @brief 已写入的内容是否恰好等于整个期望文本。
+   */
+  [[nodiscard]] bool matches() const noexcept {
+    return !differs && matched == expected.size();
+  }
+
+private:
+  std::string_view expected;
+  // 已比较且一致的字节数
+  size_t matched = 0;
+  bool differs = false;
+};
+
+} // namespace czc::formatter
+
+#endif // CZC_OUTPUT_SINK_HPP
@@ -0,0 +1,187 @@
+/**
+ * @file symbol_index.hpp
+ * @brief 定义了提取顶层符号的 `extract_symbols` 与可增量更新的磁盘符号
+ *        索引 `SymbolIndex`。
+ * @details
+ *   代码检索工具只关心顶层的 `fn`、`struct` 与 `type` 声明、函数的参数列表
+ *   以及结构体字段。`extract_symbols` 直接扫描 Token 序列：只在大括号深度
+ *   为 0 处识别声明，函数体按括号配对一步跳过，不构建 CST，也不报告任何
+ *   错误；不完整的声明能提取多少就提取多少。
+ *
+ *   `SymbolIndex` 为每个文件记录修改时间、大小与符号列表。更新时只重新
+ *   扫描修改时间或大小变化了的文件（并行进行），其余文件的符号原样沿用。
+ *   索引文件是紧凑的二进制格式（见 `utils::ByteWriter`），头部记录格式
+ *   版本与 czc 版本，任何一项不符都视为空索引。载入后按名字建立哈希表，
+ *   查询只需一次查找。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_SYMBOL_INDEX_HPP
+#define CZC_SYMBOL_INDEX_HPP
+
+#include "czc/lexer/token.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace czc::utils {
+class ThreadPool;
+} // namespace czc::utils
+
+namespace czc::index {
+
+// 索引文件格式的版本号，布局或提取规则改变时递增。
+inline constexpr uint32_t SYMBOL_INDEX_FORMAT_VERSION = 1;
+
+/**
+ * @brief 符号的种类。
+ */
+enum class SymbolKind : uint8_t {
+  Function,  ///< 顶层函数声明
+  Struct,    ///< 顶层结构体声明
+  TypeAlias, ///< 顶层类型别名声明
+  Parameter, ///< 函数参数
+  Field,     ///< 结构体字段
+};
+
+/**
+ * @brief 获取符号种类的小写名称，如 "function"。
+ */
+[[nodiscard]] std::string_view symbol_kind_to_string(SymbolKind kind) noexcept;
+
+/**
+ * @brief 一个符号。
+ */
+struct Symbol {
+  // 表示没有所属声明（顶层声明）。
+  static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+  SymbolKind kind = SymbolKind::Function;
+  std::string name;
+  // 声明的原文，空白与注释折叠为一个空格：函数为参数列表与返回类型，
+  // 参数与字段为其类型，类型别名为 `=` 右侧的类型；没有时为空
+  std::string detail;
+  // 名字所在的行列号（从 1 开始）
+  uint32_t line = 0;
+  uint32_t column = 0;
+  // 参数与字段所属的声明在同一文件符号列表中的下标
+  uint32_t parent = NO_PARENT;
+};
+
+/**
+ * @brief 从 Token 序列中提取顶层符号，不构建 CST。
+ * @param[in] tokens 以 EOF 结尾的 Token 序列，可以包含注释。
+ * @param[in] source 产生这些 Token 的源码，用于截取 `Symbol::detail`。
+ * @return 按源码顺序排列的符号；参数与字段紧跟在所属声明之后。
+ */
+[[nodiscard]] std::vector<Symbol>
+extract_symbols(const std::vector<lexer::Token>& tokens,
+                std::string_view source);
+
+/**
+ * @brief 一次 `SymbolIndex::update` 的工作量。
+ */
+struct IndexUpdateStats {
+  // 修改时间与大小都未改变、沿用原有符号的文件数
+  size_t reused_files = 0;
+  // 新增或改变、重新扫描的文件数
+  size_t scanned_files = 0;
+  // 不再属于索引而被移除的文件数
+  size_t removed_files = 0;
+  // 无法读取而未被索引的文件数
+  size_t failed_files = 0;
+};
+
+/**
+ * @brief 一次查询命中的符号。
+ */
+struct SymbolMatch {
+  const std::string* file = nullptr;
+  const Symbol* symbol = nullptr;
+  // 参数与字段所属的声明；顶层声明为 nullptr
+  const Symbol* parent = nullptr;
+};
+
+/**
+ * @brief 一组文件的符号索引。
+ * @property {线程安全} 非线程安全；`update` 自己在线程池上并行扫描文件。
+ */
+class SymbolIndex {
+public:
+  /**
+   * @brief 一个文件的索引条目。
+   */
+  struct FileEntry {
+    // 扫描时文件的修改时间（文件系统时钟的计数）与字节数
+    int64_t mtime = 0;
+    uint64_t size = 0;
+    std::vector<Symbol> symbols;
+  };
+
+  /**
+   * @param[in] version czc 的版本字符串，写入索引文件的头部。
+   */
+  explicit SymbolIndex(std::string version);
+
+  /**
+   * @brief 从文件载入索引。
+   * @details 文件不存在、格式不对、已损坏或版本不符时保持为空。
+   * @return 成功载入时返回 true。
+   */
+  bool load(const std::string& path);
+
+  /**
+   * @brief 把索引原子地保存到文件（见 `utils::write_file_atomic`）。
+   * @return 写入成功时返回 true。
+   */
+  [[nodiscard]] bool save(const std::string& path) const;
+
+  /**
+   * @brief 使索引恰好覆盖 `files`：扫描新增或改变了的文件，移除其余文件。
+   * @param[in] files 要索引的文件路径。
+   * @param[in] pool  扫描文件的线程池；为 nullptr 时在当前线程扫描。
+   */
+  IndexUpdateStats update(const std::vector<std::string>& files,
+                          utils::ThreadPool* pool = nullptr);
+
+  /**
+   * @brief 查找名字为 `name` 的全部符号，按文件路径与源码顺序排列。
+   */
+  [[nodiscard]] std::vector<SymbolMatch> find(std::string_view name) const;
+
+  /**
+   * @brief 获取全部文件的条目，按路径排序。
+   */
+  [[nodiscard]] const std::map<std::string, FileEntry>&
+  get_files() const noexcept {
+    return files;
+  }
+
+  /**
+   * @brief 获取全部文件的符号总数。
+   */
+  [[nodiscard]] size_t symbol_count() const noexcept;
+
+private:
+  /**
+   * @brief 按名字重建查询用的哈希表。
+   */
+  void rebuild_lookup();
+
+  std::string version;
+  std::map<std::string, FileEntry> files;
+
+  // 名字 -> 符号，视图指向 `files` 中的字符串
+  std::unordered_map<std::string_view, std::vector<SymbolMatch>> by_name;
+};
+
+} // namespace czc::index
+
+#endif // CZC_SYMBOL_INDEX_HPP
@@ -0,0 +1,162 @@
+/**
+ * @file char_class.hpp
+ * @brief 词法分析器使用的编译期字符分类表与运算符表。
+ * @details
+ *   `Lexer::scan_token` 以 Token 首字节查表得到字符类别，再通过类别索引的
+ *   处理函数表完成分派；运算符则再查一次 `OPERATOR_TABLE` 确定单字符与
+ *   双字符形式。所有表都在编译期生成，且与 locale 无关。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_LEXER_CHAR_CLASS_HPP
+#define CZC_LEXER_CHAR_CLASS_HPP
+
+#include "czc/lexer/token.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace czc::lexer {
+
+/**
+ * @brief Token 首字节的字符类别。
+ * @details 枚举值同时是 `Lexer::scan_token` 处理函数表的下标。
+ */
+enum class CharClass : uint8_t {
+  Other,      // 无法开始任何 Token 的字节（包括单引号）
+  Whitespace, // 空白字符，与 "C" locale 下的 `isspace` 一致
+  Digit,      // `0-9`，开始一个数字字面量
+  IdentStart, // `A-Za-z_` 以及 UTF-8 起始字节（>= 0x80）
+  Quote,      // `"`，开始一个字符串字面量
+  Operator,   // 运算符与分隔符（`/` 同时可能开始注释）
+};
+
+// 字符类别的数量，用于确定处理函数表的大小。
+inline constexpr size_t CHAR_CLASS_COUNT =
+    static_cast<size_t>(CharClass::Operator) + 1;
+
+namespace detail {
+
+constexpr std::array<CharClass, 256> build_char_class_table() {
+  std::array<CharClass, 256> table{};
+  for (auto& entry : table) {
+    entry = CharClass::Other;
+  }
+  for (char c : std::string_view(" \t\n\v\f\r")) {
+    table[static_cast<unsigned char>(c)] = CharClass::Whitespace;
+  }
+  for (int c = '0'; c <= '9'; ++c) {
+    table[c] = CharClass::Digit;
+  }
+  for (int c = 'a'; c <= 'z'; ++c) {
+    table[c] = CharClass::IdentStart;
+    table[c - 'a' + 'A'] = CharClass::IdentStart;
+  }
+  table['_'] = CharClass::IdentStart;
+  for (int c = 0x80; c <= 0xFF; ++c) {
+    table[c] = CharClass::IdentStart;
+  }
+  table['"'] = CharClass::Quote;
+  for (char c : std::string_view("+-*/%=!~<>&|(){}[],;:.")) {
+    table[static_cast<unsigned char>(c)] = CharClass::Operator;
+  }
+  return table;
+}
+
+} // namespace detail
+
+// 以字节值为下标的字符类别表。
+inline constexpr std::array<CharClass, 256> CHAR_CLASS_TABLE =
+    detail::build_char_class_table();
+
+/**
+ * @brief 查询字节 `c` 的字符类别。
+ */
+[[nodiscard]] constexpr CharClass char_class(char c) noexcept {
+  return CHAR_CLASS_TABLE[static_cast<unsigned char>(c)];
+}
+
+/**
+ * @brief 以运算符首字符为下标的表项。
+ * @details 记录单字符形式，以及最多两个可与之组成双字符运算符的后继字符。
+ *          `pair_count` 为 0 表示该运算符没有双字符形式。
+ */
+struct OperatorEntry {
+  TokenType single{TokenType::Unknown};
+  std::string_view single_text;
+
+  uint8_t pair_count{0};
+  std::array<char, 2> pair_second{};
+  std::array<TokenType, 2> pair_type{TokenType::Unknown, TokenType::Unknown};
+  std::array<std::string_view, 2> pair_text{};
+};
+
+namespace detail {
+
+constexpr void add_operator(std::array<OperatorEntry, 256>& table,
+                            std::string_view text, TokenType type) {
+  OperatorEntry& entry = table[static_cast<unsigned char>(text[0])];
+  if (text.size() == 1) {
+    entry.single = type;
+    entry.single_text = text;
+    return;
+  }
+  entry.pair_second[entry.pair_count] = text[1];
+  entry.pair_type[entry.pair_count] = type;
+  entry.pair_text[entry.pair_count] = text;
+  entry.pair_count++;
+}
+
+constexpr std::array<OperatorEntry, 256> build_operator_table() {
+  std::array<OperatorEntry, 256> table{};
+
+  add_operator(table, "+", TokenType::Plus);
+  add_operator(table, "+=", TokenType::PlusEqual);
+  add_operator(table, "-", TokenType::Minus);
+  add_operator(table, "-=", TokenType::MinusEqual);
+  add_operator(table, "->", TokenType::Arrow);
+  add_operator(table, "*", TokenType::Star);
+  add_operator(table, "*=", TokenType::StarEqual);
+  add_operator(table, "/", TokenType::Slash);
+  add_operator(table, "/=", TokenType::SlashEqual);
+  add_operator(table, "%", TokenType::Percent);
+  add_operator(table, "%=", TokenType::PercentEqual);
+  add_operator(table, "=", TokenType::Equal);
+  add_operator(table, "==", TokenType::EqualEqual);
+  add_operator(table, "!", TokenType::Bang);
+  add_operator(table, "!=", TokenType::BangEqual);
+  add_operator(table, "~", TokenType::Tilde);
+  add_operator(table, "<", TokenType::Less);
+  add_operator(table, "<=", TokenType::LessEqual);
+  add_operator(table, ">", TokenType::Greater);
+  add_operator(table, ">=", TokenType::GreaterEqual);
+  add_operator(table, "&", TokenType::And);
+  add_operator(table, "&&", TokenType::AndAnd);
+  add_operator(table, "|", TokenType::Or);
+  add_operator(table, "||", TokenType::OrOr);
+  add_operator(table, "(", TokenType::LeftParen);
+  add_operator(table, ")", TokenType::RightParen);
+  add_operator(table, "{", TokenType::LeftBrace);
+  add_operator(table, "}", TokenType::RightBrace);
+  add_operator(table, "[", TokenType::LeftBracket);
+  add_operator(table, "]", TokenType::RightBracket);
+  add_operator(table, ",", TokenType::Comma);
+  add_operator(table, ";", TokenType::Semicolon);
+  add_operator(table, ":", TokenType::Colon);
+  add_operator(table, ".", TokenType::Dot);
+  add_operator(table, "..", TokenType::DotDot);
+
+  return table;
+}
+
+} // namespace detail
+
+// 以运算符首字节为下标的运算符表。
+inline constexpr std::array<OperatorEntry, 256> OPERATOR_TABLE =
+    detail::build_operator_table();
+
+} // namespace czc::lexer
+
+#endif // CZC_LEXER_CHAR_CLASS_HPP
@@ -11,15 +11,68 @@
 #include "czc/diagnostics/diagnostic_code.hpp"
 #include "czc/lexer/error_collector.hpp"
 #include "czc/lexer/token.hpp"
+#include "czc/lexer/token_span.hpp"
 #include "czc/utils/source_tracker.hpp"
 
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+namespace czc::utils {
+class StringInterner;
+class ThreadPool;
+} // namespace czc::utils
+
 namespace czc::lexer {
 
+/**
+ * @brief 对源码的一次编辑：将旧源码中 [offset, offset + length) 替换为 `text`。
+ */
+struct SourceEdit {
+  // 被替换区间在旧源码中的起始字节偏移。
+  size_t offset{0};
+
+  // 被替换区间的字节数（纯插入时为 0）。
+  size_t length{0};
+
+  // 替换后的文本（纯删除时为空）。
+  std::string text;
+};
+
+/**
+ * @brief `Lexer::relex` 的结果：描述 Token 序列中被替换的窗口。
+ * @details 更新后的序列中，[first, first + inserted) 是重新分析得到的 Token，
+ *          它们取代了旧序列中的 [first, first + removed)。窗口之前的 Token
+ *          保持不变，之后的 Token 只平移了位置。
+ */
+struct RelexRange {
+  size_t first{0};
+  size_t removed{0};
+  size_t inserted{0};
+};
+
+/**
+ * @brief 在词法分析期间确定科学计数法字面量最终类型的回调接口。
+ * @details
+ *   词法分析器本身只把 `1.5e3` 这类字面量标记为 `ScientificExponent`。
+ *   设置了分类器后，`read_number()` 在识别出这类字面量时立即调用它，
+ *   从而省去单独的预处理遍历。词法层只依赖这个接口，具体实现
+ *   （例如 `token_preprocessor::ScientificTokenClassifier`）位于上层模块。
+ */
+class ScientificLiteralClassifier {
+public:
+  virtual ~ScientificLiteralClassifier() = default;
+
+  /**
+   * @brief 确定一个科学计数法字面量的最终类型。
+   * @param[in] token 刚识别出的 `ScientificExponent` Token，`value` 为其文本。
+   * @return 最终的 Token 类型（`Integer`、`Float` 或 `Unknown`）。
+   */
+  virtual TokenType classify(const Token& token) = 0;
+};
+
 /**
  * @brief 负责将源代码文本流转换为词法单元（Token）序列的词法分析器。
  * @details
@@ -44,11 +97,56 @@ private:
   // 用于收集在词法分析期间遇到的所有词法错误。
   LexErrorCollector error_collector;
 
+  // 零拷贝模式开关。开启后各 `read_*` 方法不再为与源码一致的文本构造
+  // `Token::value` / `Token::raw_literal`，Token 的文本通过 offset/length 获取。
+  bool span_mode{false};
+
+  // 零拷贝模式下最近一个字符串 Token 的加工值：不含转义时指向源码切片，
+  // 否则指向 `string_scratch`，在读取下一个字符串之前有效。
+  std::string_view cooked_string;
+
+  // 零拷贝模式下构造含转义字符串的加工值的缓冲区，在各字符串之间复用。
+  std::string string_scratch;
+
+  // 科学计数法字面量的分类器，为空时保留 `ScientificExponent` 类型。
+  ScientificLiteralClassifier* scientific_classifier{nullptr};
+
+  // 标识符驻留表，为空时不填写 `Token::symbol`。
+  utils::StringInterner* interner{nullptr};
+
+  /**
+   * @brief 识别当前位置开始的一个 Token（不含前导空白）。
+   * @return 返回识别出的 Token，尚未填写 offset/length。
+   */
+  Token scan_token();
+
   /**
    * @brief 将 `current_char` 更新为输入流中的下一个字符。
    */
   void advance();
 
+  /**
+   * @brief 将扫描位置一次性推进到 `new_pos`，并同步 `current_char`。
+   * @details 供批量扫描内核使用，区间内的行列号由 tracker 批量更新。
+   * @param[in] new_pos 目标字节位置，不得小于当前位置。
+   */
+  void advance_to(size_t new_pos);
+
+  /**
+   * @brief 将扫描位置跳转到一个已知行列号的位置，并同步 `current_char`。
+   * @details 仅供增量词法分析从旧 Token 的起点恢复扫描。
+   */
+  void seek(size_t pos, size_t line, size_t column);
+
+  /**
+   * @brief 在达到错误上限的那个错误处截断并行分析拼接出的 Token 序列。
+   * @details 截断后末尾补上 EOF，结果与串行分析在该错误处停止时相同。
+   * @param[in,out] tokens   已拼接的 Token 序列，可能已含最后一块的 EOF。
+   * @param[in]     location 达到上限的错误的位置。
+   */
+  void truncate_at_error(std::vector<Token>& tokens,
+                         const utils::SourceLocation& location);
+
   /**
    * @brief 向前查看输入流中的字符，而不消耗它。
    * @param[in] offset 从当前位置开始的偏移量。
@@ -85,6 +183,15 @@ private:
    */
   Token read_string();
 
+  /**
+   * @brief 将当前位置到 `run_end` 之间无需转义的内容追加到字符串值中。
+   * @details 区间内容经 `Utf8Handler::validate` 批量验证：有效前缀整段追加，
+   *          遇到无效序列时在其所在位置报告 L0011 并跳过该字节。
+   * @param[in,out] value   正在构造的字符串值。
+   * @param[in]     run_end 区间结束位置（不含）。
+   */
+  void consume_verbatim_run(std::string& value, size_t run_end);
+
   /**
    * @brief 从当前位置解析一个原始字符串字面量。
    * @return 返回一个表示该原始字符串的 Token。
@@ -92,17 +199,40 @@ private:
   Token read_raw_string();
 
   /**
-   * @brief 解析一个 `\u` 或 `\U` 形式的 Unicode 转义序列。
-   * @param[in] digit_count 期望的十六进制数字位数（4 或 8）。
-   * @return 返回转义序列对应的 UTF-8 编码字符串。
+   * @brief 尝试以不含转义的方式读取当前字符串的内容。
+   * @details 仅当 `content_end` 处是结尾的 `"` 且其间的内容是有效的 UTF-8
+   *          时成功：跳过内容与结尾引号，把切片作为字符串值（零拷贝模式下
+   *          写入 `cooked_string`，不复制）。失败时不消耗任何字符。
+   * @param[in]     content_end 从内容起点扫描到的第一个分隔符的位置。
+   * @param[in]     start_pos   字面量（含前缀与开头引号）的起始位置。
+   * @param[in,out] token       正在构造的字符串 Token。
+   * @return 成功时返回 true。
+   */
+  bool try_read_verbatim_string(size_t content_end, size_t start_pos,
+                                Token& token);
+
+  /**
+   * @brief 把构造好的字符串值交给 Token（零拷贝模式下交给 `cooked_string`）。
+   */
+  void finish_string_token(Token& token, std::string& value, size_t start_pos);
+
+  /**
+   * @brief 解析一个 `\uXXXX` 形式的 Unicode 转义序列，追加到 `value`。
+   * @param[in]     digit_count 期望的十六进制数字位数。
+   * @param[in,out] value       正在构造的字符串值。
+   */
+  void parse_unicode_escape(size_t digit_count, std::string& value);
+
+  /**
+   * @brief 解析 `\u{...}` 形式的 Unicode 转义序列（已跳过 `{`），追加到
+   *        `value`。
    */
-  std::string parse_unicode_escape(size_t digit_count);
+  void parse_braced_unicode_escape(std::string& value);
 
   /**
-   * @brief 解析一个 `\x` 形式的十六进制转义序列。
-   * @return 返回转义序列对应的 UTF-8 编码字符串。
+   * @brief 解析一个 `\x` 形式的十六进制转义序列，追加到 `value`。
    */
-  std::string parse_hex_escape();
+  void parse_hex_escape(std::string& value);
 
   /**
    * @brief 读取并验证一个带特定前缀的数字（例如 0x, 0b, 0o）。
@@ -127,24 +257,25 @@ private:
                     const std::vector<std::string>& args = {});
 
   /**
-   * @brief 尝试读取双字符运算符。
-   * @param[in] first_char 第一个字符
-   * @param[in] token_line Token 开始的行号
-   * @param[in] token_column Token 开始的列号
-   * @return 如果成功匹配双字符运算符，返回对应的 Token；否则返回 std::nullopt
+   * @brief 读取以 `CharClass::IdentStart` 字节开头的 Token。
+   * @details `r"` 开头时读取原始字符串，否则读取标识符或关键字。
+   * @return 对应的 Token。
+   */
+  Token read_word();
+
+  /**
+   * @brief 读取运算符、分隔符或以 `//` 开头的注释。
+   * @details 首字节查 `OPERATOR_TABLE` 得到单字符形式，再用后继字节匹配
+   *          双字符形式（最大匹配原则）。
+   * @return 对应的 Token。
    */
-  std::optional<Token> try_read_two_char_operator(char first_char,
-                                                  size_t token_line,
-                                                  size_t token_column);
+  Token read_operator();
 
   /**
-   * @brief 读取单字符分隔符或运算符。
-   * @param[in] ch 要处理的字符
-   * @param[in] token_line Token 开始的行号
-   * @param[in] token_column Token 开始的列号
-   * @return 对应的 Token
+   * @brief 将当前字节作为 `TokenType::Unknown` Token 消耗。
+   * @return 对应的 Token。
    */
-  Token read_single_char_token(char ch, size_t token_line, size_t token_column);
+  Token read_unknown();
 
 public:
   /**
@@ -154,6 +285,56 @@ public:
    */
   Lexer(const std::string& input_str, const std::string& fname = "<stdin>");
 
+  /**
+   * @brief 构造一个接管源码字符串的词法分析器，不复制源码。
+   * @param[in] input_str 要进行词法分析的源代码字符串，其内容被移入。
+   * @param[in] fname (可选) 源代码的文件名，用于错误报告。
+   */
+  Lexer(std::string&& input_str, const std::string& fname = "<stdin>");
+
+  /**
+   * @brief 构造一个共享源码缓冲区的词法分析器，不复制源码。
+   * @details `tokenize_spans()` 返回的容器同样共享这份缓冲区。
+   * @param[in] source 共享的源码缓冲区，不能为空。
+   * @param[in] fname (可选) 源代码的文件名，用于错误报告。
+   */
+  Lexer(std::shared_ptr<const utils::SourceBuffer> source,
+        const std::string& fname = "<stdin>");
+
+  /**
+   * @brief 构造一个直接借用源码缓冲区的词法分析器，不复制源码。
+   * @param[in] input 源码缓冲区，必须比本对象以及由它产生的诊断活得更久。
+   * @param[in] fname (可选) 源代码的文件名，用于错误报告。
+   */
+  Lexer(const utils::SourceBuffer& input,
+        const std::string& fname = "<stdin>");
+
+  /**
+   * @brief 设置科学计数法字面量的分类器，使词法分析与 Token 预处理一趟完成。
+   * @details
+   *   设置后 `next_token()`、`tokenize()` 等产生的科学计数法字面量直接带有
+   *   最终类型，分类器报告的错误与单独执行预处理时完全一致。
+   * @param[in] classifier 分类器，须在本 Lexer 使用期间保持有效；
+   *                       传入 nullptr 可恢复默认行为。
+   */
+  void set_scientific_classifier(
+      ScientificLiteralClassifier* classifier) noexcept {
+    scientific_classifier = classifier;
+  }
+
+  /**
+   * @brief 设置标识符驻留表。
+   * @details
+   *   设置后产生的每个标识符 Token 都在 `Token::symbol` 中带有驻留句柄，
+   *   后续阶段（CST 消费者、`ASTBuilder`）可以直接按句柄比较名字。
+   *   驻留表是线程安全的，`tokenize_parallel` 的各分块共享同一个驻留表。
+   * @param[in] table 驻留表，须在本 Lexer 使用期间保持有效；
+   *                  传入 nullptr 可恢复默认行为。
+   */
+  void set_interner(utils::StringInterner* table) noexcept {
+    interner = table;
+  }
+
   /**
    * @brief 从输入流中获取并返回下一个 Token。
    * @return 返回解析出的下一个 Token。当到达输入末尾时，
@@ -167,6 +348,54 @@ public:
    */
   [[nodiscard]] std::vector<Token> tokenize();
 
+  /**
+   * @brief 以零拷贝模式对整个输入执行词法分析。
+   * @details
+   *   返回的 `TokenSpanList` 只为加工值与源码不一致的 Token（例如含转义的
+   *   字符串）分配字符串，其余 Token 仅记录源码区间。结果包含 `EndOfFile` Token，
+   *   可通过 `TokenSpanList::to_tokens()` 转换为现有 Parser 使用的 Token 序列。
+   * @return 包含所有 Token 区间及源码缓冲区的 TokenSpanList。
+   */
+  [[nodiscard]] TokenSpanList tokenize_spans();
+
+  // `tokenize_parallel` 默认的最小分块大小（字节）。
+  static constexpr size_t DEFAULT_PARALLEL_CHUNK_BYTES = 256 * 1024;
+
+  /**
+   * @brief 将输入切分为若干块，在线程池上并行执行词法分析。
+   * @details
+   *   切分点选在不位于字符串、原始字符串或注释内部的换行符之后。
+   *   各块独立分析后按顺序拼接，并修正 Token 的偏移与行号以及错误位置。
+   *   返回的 Token 序列与收集到的错误均与串行的 `tokenize()` 完全一致；
+   *   若拼接校验发现某个切分点并不安全，则退回串行分析。
+   *   输入不足两块时直接串行分析。设置了错误上限时，拼接到达到上限的错误
+   *   为止，在出错的 Token 之后截断，与 `tokenize()` 同样以 EOF 结束。
+   * @param[in] pool            执行分块任务的线程池。
+   * @param[in] min_chunk_bytes 每块的最小字节数。
+   * @return 与 `tokenize()` 相同的 Token 序列。
+   */
+  [[nodiscard]] std::vector<Token>
+  tokenize_parallel(utils::ThreadPool& pool,
+                    size_t min_chunk_bytes = DEFAULT_PARALLEL_CHUNK_BYTES);
+
+  /**
+   * @brief 根据一次编辑增量更新 Token 序列。
+   * @details
+   *   本 Lexer 必须以编辑后的源码构造，且尚未开始分析；`tokens` 必须是
+   *   编辑前源码的 `tokenize()` 结果。从编辑点之前最近的一个不受影响的
+   *   Token 起点恢复扫描，直到新产生的 Token 越过编辑区间、且其起点恰好
+   *   对应旧序列中某个 Token 的起点（即重新同步）为止；其后的旧 Token
+   *   只需平移字节偏移、行号以及同一行上的列号。
+   *
+   *   分析工作量只与编辑附近受影响的 Token 数量有关，而与文件大小无关。
+   *   错误收集器中只包含重新分析窗口内的词法错误。
+   *   若编辑区间超出旧源码范围，则退回全量分析。
+   * @param[in,out] tokens 编辑前的 Token 序列，原地更新为编辑后的结果。
+   * @param[in]     edit   本次编辑。
+   * @return 被替换的 Token 窗口。
+   */
+  RelexRange relex(std::vector<Token>& tokens, const SourceEdit& edit);
+
   /**
    * @brief 获取对内部错误收集器的只读访问权限。
    * @return 对 LexErrorCollector 对象的常量引用。
@@ -174,6 +403,34 @@ public:
   [[nodiscard]] const LexErrorCollector& get_errors() const noexcept {
     return error_collector;
   }
+
+  /**
+   * @brief 把之后的词法错误直接写入共享的报告器，见
+   *        `ErrorCollector::set_reporter`。
+   */
+  void
+  set_error_reporter(diagnostics::IDiagnosticReporter* reporter) noexcept {
+    error_collector.set_reporter(reporter);
+  }
+
+  /**
+   * @brief 设置最多报告的错误数，见 `ErrorCollector::set_error_limit`。
+   * @details 达到上限（或共享的报告器达到它的上限）后，下一个 Token 即为
+   *          EOF。
+   */
+  void set_error_limit(size_t limit) noexcept {
+    error_collector.set_error_limit(limit);
+  }
+
+  /**
+   * @brief 获取词法分析器使用的源码跟踪器。
+   * @details 分析过程中已顺带建立行索引，诊断输出可直接复用，
+   *          而无需再构造一个 SourceTracker 重新扫描输入。
+   * @return 对 SourceTracker 对象的常量引用。
+   */
+  [[nodiscard]] const utils::SourceTracker& get_source_tracker() const noexcept {
+    return tracker;
+  }
 };
 
 } // namespace czc::lexer
@@ -0,0 +1,57 @@
+/**
+ * @file number_decoder.hpp
+ * @brief 数字字面量的值解码：整数（含进制前缀与整数值的科学计数法）与浮点数。
+ * @details
+ *   Lexer 在识别数字字面量时顺带解码其值并存入 Token（见
+ *   `Token::integer_value`），AST 构建不必再解析文本；Token 不带解码值时
+ *   （如从 `TokenSpanList` 或 CST 缓存还原的 Token）可以直接对文本调用这里
+ *   的函数。
+ *
+ *   十进制数字每 8 位一组以 SWAR（一个 64 位整数内的并行运算）方式转换，
+ *   浮点数交给 `std::from_chars`。所有函数都不分配内存，也不抛出异常。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_LEXER_NUMBER_DECODER_HPP
+#define CZC_LEXER_NUMBER_DECODER_HPP
+
+#include "czc/lexer/token.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+namespace czc::lexer {
+
+/**
+ * @brief 解码整数字面量。
+ * @details 支持十进制、`0x`/`0b`/`0o` 前缀（大小写均可），以及数学上为整数
+ *          的科学计数法（如 `1.5e3`）。
+ * @param[in]  literal 字面量文本，不含正负号。
+ * @param[out] value   解码结果，仅在返回 true 时写入。
+ * @return 格式不合法或超出 `int64_t` 范围时返回 false。
+ */
+[[nodiscard]] bool decode_integer(std::string_view literal,
+                                  int64_t& value) noexcept;
+
+/**
+ * @brief 解码浮点数字面量（十进制，可带小数部分与指数）。
+ * @param[in]  literal 字面量文本，不含正负号。
+ * @param[out] value   解码结果，仅在返回 true 时写入。
+ * @return 格式不合法或超出 `double` 的范围时返回 false。
+ */
+[[nodiscard]] bool decode_float(std::string_view literal,
+                                double& value) noexcept;
+
+/**
+ * @brief 按 Token 的类型解码 `text` 并存入 Token。
+ * @details 只处理 `Integer` 与 `Float`，其他类型以及解码失败时把
+ *          `has_numeric_value` 置为 false。
+ * @param[in,out] token 待写入的 Token。
+ * @param[in]     text  字面量文本（零拷贝模式下 Token 本身不带文本）。
+ */
+void decode_numeric_value(Token& token, std::string_view text) noexcept;
+
+} // namespace czc::lexer
+
+#endif // CZC_LEXER_NUMBER_DECODER_HPP
@@ -0,0 +1,78 @@
+/**
+ * @file scan_kernels.hpp
+ * @brief 词法分析器热点循环使用的批量扫描内核。
+ * @details
+ *   提供以数据块为单位查找空白串、ASCII 标识符串、ASCII 串、字符串分隔符
+ *   和行尾的内核函数。
+ *   在 x86-64 上使用 SSE2，在 AArch64 上使用 NEON（二者均为对应架构的
+ *   基线指令集，无需运行时检测），其他平台回退到标量实现。x86-64 上
+ *   CPU 支持 AVX2 时先按 32 字节推进：以 `-march` 启用 AVX2 时在编译期
+ *   选定，否则（GCC / Clang）在启动时检测一次。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_LEXER_SCAN_KERNELS_HPP
+#define CZC_LEXER_SCAN_KERNELS_HPP
+
+#include <cstddef>
+
+namespace czc::lexer::scan {
+
+/**
+ * @brief 查找从 `pos` 开始的连续空白字符串的结束位置。
+ * @details 空白字符与 "C" locale 下的 `std::isspace` 一致：
+ *          空格、`\t`、`\n`、`\v`、`\f`、`\r`。
+ * @param[in] data 输入缓冲区。
+ * @param[in] pos  起始位置。
+ * @param[in] size 缓冲区长度。
+ * @return 第一个非空白字符的位置；若直到末尾都是空白则返回 `size`。
+ */
+[[nodiscard]] size_t skip_whitespace(const char* data, size_t pos,
+                                     size_t size) noexcept;
+
+/**
+ * @brief 查找从 `pos` 开始的连续 ASCII 标识符字符（`[A-Za-z0-9_]`）的结束位置。
+ * @details 非 ASCII 字节（>= 0x80）会终止扫描，由调用方按 UTF-8 规则继续处理。
+ * @return 第一个不属于该字符集的位置；若直到末尾都属于则返回 `size`。
+ */
+[[nodiscard]] size_t scan_identifier(const char* data, size_t pos,
+                                     size_t size) noexcept;
+
+/**
+ * @brief 查找从 `pos` 开始的连续 ASCII 字节（< 0x80）的结束位置。
+ * @return 第一个非 ASCII 字节的位置；若直到末尾都是 ASCII 则返回 `size`。
+ */
+[[nodiscard]] size_t skip_ascii(const char* data, size_t pos,
+                                size_t size) noexcept;
+
+/**
+ * @brief 查找从 `pos` 开始的第一个 `"` 或 `\` 的位置。
+ * @details 用于普通字符串字面量：两者之间的内容无需逐字符处理。
+ * @return 第一个分隔字节的位置；若不存在则返回 `size`。
+ */
+[[nodiscard]] size_t find_string_delimiter(const char* data, size_t pos,
+                                           size_t size) noexcept;
+
+/**
+ * @brief 查找从 `pos` 开始的第一个字节 `target` 的位置。
+ * @return 该字节所在位置；若不存在则返回 `size`。
+ */
+[[nodiscard]] size_t find_byte(const char* data, size_t pos, size_t size,
+                               char target) noexcept;
+
+/**
+ * @brief 查找从 `pos` 开始的第一个换行符 `\n` 的位置。
+ * @return 换行符所在位置；若不存在则返回 `size`。
+ */
+[[nodiscard]] size_t find_line_end(const char* data, size_t pos,
+                                   size_t size) noexcept;
+
+/**
+ * @brief 返回选定的扫描内核名称（"avx2"、"sse2"、"neon" 或 "scalar"）。
+ */
+[[nodiscard]] const char* kernel_name() noexcept;
+
+} // namespace czc::lexer::scan
+
+#endif // CZC_LEXER_SCAN_KERNELS_HPP
@@ -0,0 +1,156 @@
+/**
+ * @file stream_lexer.hpp
+ * @brief 定义了随输入分段到达而推进的流式词法分析器 `StreamLexer`。
+ * @details
+ *   `Lexer` 需要一次拿到完整的源码。嵌入到异步服务中时，源码往往从套接字
+ *   或文件中分段读入；`StreamLexer` 让调用方每读到一段就 `feed` 一次，
+ *   立即得到已经不会再变化的 Token，全部读完后 `finish`。每次调用只做与
+ *   新到达的字节相称的工作后返回，从不阻塞，也不持有整个输入：
+ *   协程在两次 `co_await` 读取之间调用它即可，无需专门的线程。
+ *   `parser::StreamParser` 以同样的方式消费这些 Token。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_LEXER_STREAM_LEXER_HPP
+#define CZC_LEXER_STREAM_LEXER_HPP
+
+#include "czc/lexer/error_collector.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/lexer/token.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::lexer {
+
+/**
+ * @brief 按段接收源码的词法分析器。
+ * @details
+ *   扫描器在 Token 结尾之后最多再查看一个字节，因此一个 Token 之后只要
+ *   还有 `LOOKAHEAD_BYTES` 个字节已经到达，它就不会再因后续输入而改变；
+ *   这样的 Token 立即提交，其余字节（通常不足一个 Token）留待下一段
+ *   到达后从该 Token 的起点重新分析。提交的 Token 与错误都已换算为在
+ *   整个输入中的偏移与行列号，与对完整输入调用 `Lexer::tokenize()` 的
+ *   结果完全一致，无论输入如何分段。
+ *
+ *   跨越很多段的长 Token（如大段的块注释或字符串）在增长到上次尝试时的
+ *   两倍之前不会重新分析，因此总工作量与输入长度呈线性关系。
+ *
+ * @property {线程安全} 非线程安全。
+ */
+class StreamLexer {
+public:
+  // Token 结尾之后必须已经到达的字节数，见 `Lexer::relex`。
+  static constexpr size_t LOOKAHEAD_BYTES = 1;
+
+  /**
+   * @param[in] filename 源文件名，用于错误报告。
+   */
+  explicit StreamLexer(const std::string& filename = "<stdin>");
+
+  /**
+   * @brief 设置标识符驻留表，见 `Lexer::set_interner`。
+   */
+  void set_interner(utils::StringInterner* table) noexcept {
+    interner = table;
+  }
+
+  /**
+   * @brief 设置科学计数法字面量的分类器，见
+   *        `Lexer::set_scientific_classifier`。
+   * @details 分类在 Token 提交时进行，位置已是整个输入中的位置。
+   */
+  void set_scientific_classifier(
+      ScientificLiteralClassifier* classifier) noexcept {
+    scientific_classifier = classifier;
+  }
+
+  /**
+   * @brief 追加一段输入，提交其中已经确定的 Token。
+   * @details `finish` 之后调用无效。
+   * @param[in] bytes 新到达的字节，可以在任意位置切分（包括 UTF-8
+   *                  字符内部）。调用返回后不再引用。
+   * @return 本次新提交的 Token 数。
+   */
+  size_t feed(std::string_view bytes);
+
+  /**
+   * @brief 声明输入已经结束，提交剩余的全部 Token 以及 EOF Token。
+   * @return 本次新提交的 Token 数（含 EOF）。
+   */
+  size_t finish();
+
+  /**
+   * @brief 取走已提交、尚未取走的 Token。
+   */
+  [[nodiscard]] std::vector<Token> take_tokens();
+
+  /**
+   * @brief 是否已调用 `finish`。
+   */
+  [[nodiscard]] bool is_finished() const noexcept {
+    return finished;
+  }
+
+  /**
+   * @brief 获取已到达、但尚未提交为 Token 的字节数。
+   */
+  [[nodiscard]] size_t get_pending_bytes() const noexcept {
+    return pending.size();
+  }
+
+  /**
+   * @brief 获取已提交的 Token 上的词法错误。
+   */
+  [[nodiscard]] const LexErrorCollector& get_errors() const noexcept {
+    return error_collector;
+  }
+
+  /**
+   * @brief 把之后提交的词法错误直接写入共享的报告器，见
+   *        `ErrorCollector::set_reporter`。
+   */
+  void
+  set_error_reporter(diagnostics::IDiagnosticReporter* reporter) noexcept {
+    error_collector.set_reporter(reporter);
+  }
+
+private:
+  /**
+   * @brief 分析 `pending`，提交已经确定的 Token 并丢弃其字节。
+   * @param[in] at_end 输入是否已经结束。
+   * @return 提交的 Token 数。
+   */
+  size_t scan(bool at_end);
+
+  std::string filename;
+
+  // 尚未提交的输入，总是从一个 Token（或空白）的起点开始
+  std::string pending;
+
+  // `pending` 的第一个字节在整个输入中的偏移与行列号
+  size_t base_offset{0};
+  size_t base_line{1};
+  size_t base_column{1};
+
+  // 上一次分析没有提交任何 Token 时，`pending` 需要增长到的大小
+  size_t retry_size{0};
+
+  // 已提交、尚未取走的 Token
+  std::vector<Token> ready;
+
+  LexErrorCollector error_collector;
+
+  ScientificLiteralClassifier* scientific_classifier{nullptr};
+
+  utils::StringInterner* interner{nullptr};
+
+  bool finished{false};
+};
+
+} // namespace czc::lexer
+
+#endif // CZC_LEXER_STREAM_LEXER_HPP
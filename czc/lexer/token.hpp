@@ -8,8 +8,13 @@
 #ifndef CZC_LEXER_TOKEN_HPP
 #define CZC_LEXER_TOKEN_HPP
 
+#include "czc/utils/symbol.hpp"
+
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace czc::lexer {
 
@@ -18,8 +23,9 @@ namespace czc::lexer {
  * @details
  *   此枚举是编译器语法分析的基础，它将源代码的字符流转换为
  *   具有明确语法含义的离散单元。
+ *   底层类型固定为 1 字节，以便紧凑的 `TokenSpan` 直接存储它。
  */
-enum class TokenType {
+enum class TokenType : uint8_t {
   // === 字面量 ===
   Integer,            // 整数字面量, e.g., `123`, `0xFF`
   Float,              // 浮点数字面量, e.g., `3.14`
@@ -93,6 +99,10 @@ enum class TokenType {
   Unknown,   // 表示无法识别的字符或序列
 };
 
+// `TokenType` 的取值个数；新增类型时须放在 `Unknown` 之前。
+inline constexpr size_t TOKEN_TYPE_COUNT =
+    static_cast<size_t>(TokenType::Unknown) + 1;
+
 /**
  * @brief 代表源代码中的一个原子性语法单元（词法单元）。
  * @details
@@ -107,9 +117,6 @@ enum class TokenType {
  */
 class Token {
 public:
-  // Token 的语法类型，如 `Identifier`, `Integer`, `Plus` 等。
-  TokenType token_type;
-
   // Token 在源代码中的原始文本表示，例如 "my_var", "42", "+"。
   std::string value;
 
@@ -124,6 +131,10 @@ public:
   // Token 在源代码中起始位置的列号（UTF-8 字符计数，从 1 开始）。
   size_t column;
 
+  // Token 的语法类型，如 `Identifier`, `Integer`, `Plus` 等。
+  // NOTE: 与下面几个单字节字段放在一起，共用一个 8 字节槽位。
+  TokenType token_type;
+
   // 标记这是否是一个由解析器插入的虚拟 Token（用于错误恢复）。
   // 虚拟 Token 不对应源码中的实际文本，不应被格式化器输出。
   bool is_synthetic;
@@ -132,6 +143,29 @@ public:
   // 仅对 TokenType::String 有意义，其他类型忽略此字段。
   bool is_raw_string{false};
 
+  // 数字字面量的值是否已在词法分析时解码，见 `integer_value`。
+  bool has_numeric_value{false};
+
+  // 标识符在驻留表中的句柄，仅当 Lexer 设置了驻留表时填写（见
+  // `Lexer::set_interner`）；其他情况下为无效句柄。
+  // NOTE: 放在两个 bool 之后，占用原本的对齐填充，不增大 Token。
+  utils::Symbol symbol;
+
+  // Token 在源码缓冲区中的起始字节偏移量。
+  // 与 `length` 一起构成该 Token 对应源码文本的字节区间 [offset, offset + length)。
+  size_t offset{0};
+
+  // Token 在源码中占用的字节数。虚拟 Token 与 EOF Token 为 0。
+  size_t length{0};
+
+  // 数字字面量解码后的值（见 `decode_numeric_value`）：`Integer` 使用
+  // `integer_value`，`Float` 使用 `float_value`。仅当 `has_numeric_value`
+  // 为 true 时有意义，之后的阶段不必再解析文本。
+  union {
+    int64_t integer_value{0};
+    double float_value;
+  };
+
   /**
    * @brief 构造一个新的 Token 对象。
    * @param[in] type   Token 的类型。
@@ -157,11 +191,14 @@ public:
 
 /**
  * @brief 检查一个字符串是否为关键字，并返回其对应的 TokenType。
+ * @details 接受 `std::string_view`，零拷贝的词法分析路径可以直接传入
+ *          源码切片，而无需为查找关键字构造临时字符串。
  * @param[in] word 要检查的字符串。
  * @return 如果 `word` 是一个关键字，则返回对应的 `TokenType`；
  *         否则返回 `std::nullopt`。
  */
-[[nodiscard]] std::optional<TokenType> get_keyword(const std::string& word);
+[[nodiscard]] std::optional<TokenType>
+get_keyword(std::string_view word) noexcept;
 
 /**
  * @brief 将 TokenType 枚举转换为人类可读的字符串表示。
@@ -171,6 +208,21 @@ public:
  */
 [[nodiscard]] std::string token_type_to_string(TokenType type);
 
+/**
+ * @brief 获取 TokenType 的名称，与 `token_type_to_string` 相同但不分配内存。
+ * @details 查一次按枚举值索引的静态表；超出范围的值返回 "Unknown"。
+ * @param[in] type 要转换的 TokenType。
+ * @return 指向静态存储的名称。
+ */
+[[nodiscard]] std::string_view token_type_name(TokenType type) noexcept;
+
+/**
+ * @brief 估算 Token 的文本在堆上占用的字节数。
+ * @details 只计入 `value` 与 `raw_literal` 超出短字符串优化（SSO）容量后
+ *          单独分配的缓冲区，不含 `sizeof(Token)` 本身。用于 `--mem-report`。
+ */
+[[nodiscard]] size_t get_heap_bytes(const Token& token) noexcept;
+
 } // namespace czc::lexer
 
 #endif // CZC_LEXER_TOKEN_HPP
@@ -0,0 +1,235 @@
+/**
+ * @file token_source.hpp
+ * @brief 定义了按需拉取 Token 的 `TokenSource` 接口及其基础实现。
+ * @details
+ *   `TokenSource` 让语法分析器按需从上游拉取 Token，而不必事先物化完整的
+ *   `std::vector<Token>`。配合 Parser 内部的有界前瞻缓冲区，峰值内存只与
+ *   前瞻深度相关，而与文件大小无关。
+ * @author BegoniaHe
+ * @date 2025-11-20
+ */
+
+#ifndef CZC_LEXER_TOKEN_SOURCE_HPP
+#define CZC_LEXER_TOKEN_SOURCE_HPP
+
+#include "czc/lexer/lexer.hpp"
+#include "czc/lexer/token.hpp"
+#include "czc/lexer/token_span.hpp"
+#include "czc/utils/capacity_estimate.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace czc::lexer {
+
+/**
+ * @brief 按需产生 Token 的拉取式数据源接口。
+ * @details 实现者在数据耗尽后必须持续返回 `TokenType::EndOfFile` 类型的 Token。
+ */
+class TokenSource {
+public:
+  virtual ~TokenSource() = default;
+
+  /**
+   * @brief 拉取下一个 Token。
+   * @return 下一个 Token；数据耗尽后持续返回 EOF Token。
+   */
+  virtual Token next() = 0;
+
+  /**
+   * @brief 若数据源背后是一个已物化的完整 Token 序列，返回该序列。
+   * @details 供需要随机访问全部 Token 的场景（例如并行解析的预扫描）使用。
+   * @return 完整的 Token 序列（包含 EOF）；流式数据源返回 nullptr。
+   */
+  [[nodiscard]] virtual const std::vector<Token>*
+  get_materialized_tokens() const noexcept {
+    return nullptr;
+  }
+
+  /**
+   * @brief 跳过接下来最多 `count` 个 Token，且保证不会越过 EOF Token。
+   * @details 供错误恢复直接跳到已知位置；默认不支持跳过。
+   * @return 实际跳过的 Token 数量。
+   */
+  virtual size_t skip(size_t count) {
+    (void)count;
+    return 0;
+  }
+
+  /**
+   * @brief 估计数据源还会产生多少个 Token（含 EOF），用于预留容量。
+   * @return 估计的 Token 数；无法估计时返回 0。
+   */
+  [[nodiscard]] virtual size_t size_hint() const noexcept {
+    return 0;
+  }
+};
+
+/**
+ * @brief 以已物化的 Token 序列作为数据源。
+ * @details
+ *   可以引用调用方持有的向量（不拷贝），也可以接管一个右值向量。
+ *   引用模式下，调用方必须保证向量在数据源使用期间保持有效。
+ */
+class VectorTokenSource : public TokenSource {
+private:
+  // 接管的 Token 序列（仅在右值构造时使用）。
+  std::vector<Token> owned;
+
+  // 实际读取的 Token 序列，指向调用方的向量或 `owned`。
+  const std::vector<Token>* tokens;
+
+  // 下一个要返回的 Token 的下标。
+  size_t index{0};
+
+  // 读取范围的末尾（不含）；到达后返回 EOF Token。
+  size_t end;
+
+public:
+  /**
+   * @brief 引用一个已有的 Token 序列（不拷贝）。
+   */
+  explicit VectorTokenSource(const std::vector<Token>& tokens)
+      : tokens(&tokens), end(tokens.size()) {}
+
+  /**
+   * @brief 引用已有 Token 序列中的区间 `[begin, end)`（不拷贝）。
+   * @details 区间之后返回 `Token::makeEOF()`；区间本身可以包含 EOF Token。
+   */
+  VectorTokenSource(const std::vector<Token>& tokens, size_t begin, size_t end)
+      : tokens(&tokens), index(begin), end(end) {}
+
+  /**
+   * @brief 接管一个 Token 序列的所有权。
+   */
+  explicit VectorTokenSource(std::vector<Token>&& tokens)
+      : owned(std::move(tokens)), tokens(&owned), end(owned.size()) {}
+
+  VectorTokenSource(const VectorTokenSource&) = delete;
+  VectorTokenSource& operator=(const VectorTokenSource&) = delete;
+
+  Token next() override {
+    if (index < end) {
+      return (*tokens)[index++];
+    }
+    return Token::makeEOF();
+  }
+
+  size_t skip(size_t count) override {
+    // NOTE: 保留区间的最后一个 Token 交给 `next()` 返回，
+    //       它可能是 EOF，调用方需要据此确定流的末尾。
+    size_t available = index + 1 < end ? end - index - 1 : 0;
+    size_t skipped = count < available ? count : available;
+    index += skipped;
+    return skipped;
+  }
+
+  [[nodiscard]] size_t size_hint() const noexcept override {
+    return index < end ? end - index : 0;
+  }
+
+  /**
+   * @brief 仅当尚未开始读取且覆盖整个序列时返回该序列。
+   */
+  [[nodiscard]] const std::vector<Token>*
+  get_materialized_tokens() const noexcept override {
+    return index == 0 && end == tokens->size() ? tokens : nullptr;
+  }
+};
+
+/**
+ * @brief 以紧凑的 `TokenSpanList` 作为数据源，让 Parser 直接消费 16 字节的 span。
+ * @details
+ *   每次 `next()` 只为当前 Token 还原字符串，Parser 的前瞻缓冲区之外不存在
+ *   任何 `Token` 对象。span 的偏移单调递增，因此行号通过一个随之推进的
+ *   游标求得，整体为 O(N)。与 `VectorTokenSource` 一样支持引用与接管两种模式。
+ */
+class SpanTokenSource : public TokenSource {
+private:
+  // 接管的 span 序列（仅在右值构造时使用）。
+  std::optional<TokenSpanList> owned;
+
+  // 实际读取的 span 序列，指向调用方的容器或 `owned`。
+  const TokenSpanList* spans;
+
+  // 下一个要返回的 span 的下标。
+  size_t index{0};
+
+  // 当前行号（从 1 开始），随偏移单调推进。
+  size_t line{1};
+
+public:
+  /**
+   * @brief 引用一个已有的 span 序列（不拷贝）。
+   */
+  explicit SpanTokenSource(const TokenSpanList& spans) : spans(&spans) {}
+
+  /**
+   * @brief 接管一个 span 序列的所有权。
+   */
+  explicit SpanTokenSource(TokenSpanList&& spans)
+      : owned(std::move(spans)), spans(&*owned) {}
+
+  SpanTokenSource(const SpanTokenSource&) = delete;
+  SpanTokenSource& operator=(const SpanTokenSource&) = delete;
+
+  Token next() override {
+    if (index >= spans->size()) {
+      return Token::makeEOF();
+    }
+    const TokenSpan& span = (*spans)[index];
+    if (span.token_type == TokenType::EndOfFile) {
+      return spans->to_token(index++, {0, 0});
+    }
+
+    const auto& starts = spans->line_starts();
+    while (line < starts.size() && starts[line] <= span.offset) {
+      line++;
+    }
+    return spans->to_token(index++,
+                           {line, span.offset - starts[line - 1] + 1});
+  }
+
+  [[nodiscard]] size_t size_hint() const noexcept override {
+    return spans->size() - index;
+  }
+};
+
+/**
+ * @brief 直接从 `Lexer` 拉取 Token 的数据源（不做任何预处理）。
+ */
+class LexerTokenSource : public TokenSource {
+private:
+  Lexer lexer;
+
+public:
+  /**
+   * @brief 构造一个基于源码的 Token 数据源。
+   * @param[in] input    源代码字符串。
+   * @param[in] filename 源文件名，用于错误报告。
+   */
+  explicit LexerTokenSource(const std::string& input,
+                            const std::string& filename = "<stdin>")
+      : lexer(input, filename) {}
+
+  Token next() override {
+    return lexer.next_token();
+  }
+
+  [[nodiscard]] size_t size_hint() const noexcept override {
+    return utils::CapacityEstimate::estimate_tokens(
+        lexer.get_source_tracker().get_input().size());
+  }
+
+  /**
+   * @brief 获取词法分析期间收集到的错误。
+   */
+  [[nodiscard]] const LexErrorCollector& get_errors() const noexcept {
+    return lexer.get_errors();
+  }
+};
+
+} // namespace czc::lexer
+
+#endif // CZC_LEXER_TOKEN_SOURCE_HPP
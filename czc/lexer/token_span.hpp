@@ -0,0 +1,243 @@
+/**
+ * @file token_span.hpp
+ * @brief 定义了零拷贝的 Token 表示 `TokenSpan` 及其容器 `TokenSpanList`。
+ * @details
+ *   `TokenSpan` 不持有任何字符串，只记录 Token 在源码缓冲区中的字节区间，
+ *   整个结构固定为 16 字节，便于在大文件上顺序遍历。
+ *   只有当 Token 的"加工值"（cooked value）与源码文本不一致时（例如含有
+ *   转义序列的字符串），才会在 `TokenSpanList` 的侧表中保存一份字符串；
+ *   这些字符串统一写入容器的 `utils::Arena`，不逐个分配。
+ * @author BegoniaHe
+ * @date 2025-11-20
+ */
+
+#ifndef CZC_LEXER_TOKEN_SPAN_HPP
+#define CZC_LEXER_TOKEN_SPAN_HPP
+
+#include "czc/lexer/token.hpp"
+#include "czc/utils/arena.hpp"
+#include "czc/utils/source_tracker.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace czc::lexer {
+
+/**
+ * @brief 以源码区间表示的紧凑 Token（16 字节 POD）。
+ * @details
+ *   所有文本都通过所属的 `TokenSpanList` 访问，`TokenSpan` 本身不分配内存。
+ *   行号与列号不逐个存储，而是由 `TokenSpanList` 根据字节偏移在行索引上
+ *   推算，因此单个源文件的大小不能超过 4 GiB。
+ */
+struct TokenSpan {
+  // 表示该 Token 没有单独保存的加工值，其值直接取自源码。
+  static constexpr uint32_t NO_COOKED = std::numeric_limits<uint32_t>::max();
+
+  // `flags` 中的标志位：原始字符串（r"..."）。
+  static constexpr uint8_t FLAG_RAW_STRING = 1u << 0;
+
+  // Token 在源码中的起始字节偏移量。
+  uint32_t offset{0};
+
+  // Token 在源码中占用的字节数。
+  uint32_t length{0};
+
+  // 加工值在侧表中的下标；为 `NO_COOKED` 时表示值与源码文本一致。
+  uint32_t cooked_index{NO_COOKED};
+
+  // Token 的语法类型。
+  TokenType token_type{TokenType::Unknown};
+
+  // 标志位集合，见 `FLAG_*` 常量。
+  uint8_t flags{0};
+
+  /**
+   * @brief 是否为原始字符串（r"..."）。
+   */
+  [[nodiscard]] bool is_raw_string() const noexcept {
+    return (flags & FLAG_RAW_STRING) != 0;
+  }
+};
+
+static_assert(sizeof(TokenSpan) == 16, "TokenSpan must stay 16 bytes");
+static_assert(std::is_trivially_copyable_v<TokenSpan>,
+              "TokenSpan must be trivially copyable");
+
+/**
+ * @brief 持有源码缓冲区与 `TokenSpan` 序列的容器。
+ * @details
+ *   `TokenSpanList` 共享持有源码缓冲区（通常与产生它的 Lexer 是同一份），
+ *   因此返回的 `std::string_view` 在容器存活期间始终有效。行号与列号由 `line_column()` 按需计算。通过 `value()` 可以获得与 `Token::value`
+ *   语义一致的加工值，通过 `to_token()` / `to_tokens()` 可以将其还原为
+ *   现有 Parser 和 Formatter 使用的 `Token`。
+ *
+ * @property {生命周期} 返回的视图不得超出容器本身的生命周期。
+ * @property {线程安全} 构建完成且行索引就绪后（由 Lexer 设置，或已调用过
+ *                     `line_starts()`），只读访问是线程安全的。
+ */
+class TokenSpanList {
+private:
+  // 源码缓冲区，所有 span 都指向这里。
+  std::shared_ptr<const utils::SourceBuffer> buffer_;
+  // `buffer_` 的内容
+  std::string_view source_;
+
+  // Token 区间序列。
+  std::vector<TokenSpan> spans_;
+
+  // 加工值侧表，只保存与源码文本不一致的值，文本位于 `cooked_arena_` 中。
+  std::vector<std::string_view> cooked_values_;
+
+  // 加工值文本的存储，第一次需要保存加工值时才创建。
+  std::unique_ptr<utils::Arena> cooked_arena_;
+
+  // `cooked_arena_` 的首块大小：含转义的字符串通常很少，不必一开始就
+  // 占用默认的 64 KiB。
+  static constexpr size_t COOKED_ARENA_BLOCK_SIZE = 4 * 1024;
+
+  /**
+   * @brief 把 `value` 复制到 `cooked_arena_` 中，返回指向副本的视图。
+   */
+  [[nodiscard]] std::string_view store_cooked(std::string_view value);
+
+  // 行索引：第 i 个元素是第 i+1 行的起始字节偏移。
+  // 通常由 Lexer 在分析结束后交给容器；为空时在首次查询时自行构建。
+  mutable std::vector<uint32_t> line_starts_;
+
+  /**
+   * @brief 确保行索引可用。
+   */
+  void ensure_line_starts() const;
+
+  /**
+   * @brief 计算字符串 Token 在不经过转义处理时的"自然值"。
+   * @details 即去掉两端引号（以及原始字符串的 `r` 前缀）后的源码切片。
+   */
+  [[nodiscard]] std::string_view natural_string_value(const TokenSpan& span) const;
+
+public:
+  /**
+   * @brief 构造一个空的 TokenSpanList。
+   * @param[in] source 源码文本，容器会持有它的拷贝。
+   */
+  explicit TokenSpanList(std::string source = {});
+
+  /**
+   * @brief 构造一个与其他对象共享源码缓冲区的空 TokenSpanList。
+   * @param[in] source 共享的源码缓冲区，不能为空。
+   */
+  explicit TokenSpanList(std::shared_ptr<const utils::SourceBuffer> source);
+
+  /**
+   * @brief 追加一个 Token，并在必要时保存其加工值。
+   * @details 仅当 `cooked` 与该 Token 的源码文本（或字符串的自然值）不一致时才会保存。
+   * @param[in] span   Token 区间（`cooked_index` 字段会被忽略）。
+   * @param[in] cooked 该 Token 的加工值。
+   */
+  void push_back(TokenSpan span, std::string_view cooked);
+
+  /**
+   * @brief 设置行索引，避免容器再次扫描源码。
+   * @param[in] line_starts 每行的起始字节偏移，第一个元素必须为 0。
+   */
+  void set_line_starts(std::vector<uint32_t> line_starts);
+
+  /**
+   * @brief 覆盖指定 Token 的加工值（例如 Token 预处理器的规范化结果）。
+   */
+  void set_cooked(size_t index, std::string_view value);
+
+  /**
+   * @brief 为至少 `count` 个 Token 预留空间。
+   */
+  void reserve(size_t count) {
+    spans_.reserve(count);
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return spans_.size();
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return spans_.empty();
+  }
+
+  [[nodiscard]] const TokenSpan& operator[](size_t index) const noexcept {
+    return spans_[index];
+  }
+
+  [[nodiscard]] std::vector<TokenSpan>::const_iterator begin() const noexcept {
+    return spans_.begin();
+  }
+
+  [[nodiscard]] std::vector<TokenSpan>::const_iterator end() const noexcept {
+    return spans_.end();
+  }
+
+  /**
+   * @brief 获取容器持有的源码文本。
+   */
+  [[nodiscard]] std::string_view source() const noexcept {
+    return source_;
+  }
+
+  /**
+   * @brief 获取保存在侧表中的加工值数量（即实际分配的字符串数量）。
+   */
+  [[nodiscard]] size_t cooked_count() const noexcept {
+    return cooked_values_.size();
+  }
+
+  /**
+   * @brief 获取 Token 对应的原始源码文本。
+   */
+  [[nodiscard]] std::string_view text(size_t index) const noexcept;
+
+  /**
+   * @brief 获取 Token 的加工值，语义与 `Token::value` 一致。
+   */
+  [[nodiscard]] std::string_view value(size_t index) const noexcept;
+
+  /**
+   * @brief 获取字符串 Token 的原始字面量（含引号），对其他 Token 返回空视图。
+   */
+  [[nodiscard]] std::string_view raw_literal(size_t index) const noexcept;
+
+  /**
+   * @brief 获取完整的行索引。
+   */
+  [[nodiscard]] const std::vector<uint32_t>& line_starts() const;
+
+  /**
+   * @brief 计算 Token 起始位置的行号与列号（列号按字节计数）。
+   * @details 在行索引上二分查找；EOF Token 与 `Token::makeEOF` 一致，返回 {0, 0}。
+   */
+  [[nodiscard]] utils::LineColumn line_column(size_t index) const;
+
+  /**
+   * @brief 将指定位置的 span 还原为一个拥有字符串的 `Token`。
+   */
+  [[nodiscard]] Token to_token(size_t index) const;
+
+  /**
+   * @brief 使用调用方已知的位置信息还原 `Token`，跳过行号查找。
+   * @details 供顺序遍历的调用方（如 `SpanTokenSource`）使用，
+   *          它们可以随偏移单调推进行游标，而无需每次二分查找。
+   */
+  [[nodiscard]] Token to_token(size_t index, utils::LineColumn position) const;
+
+  /**
+   * @brief 将所有 span 还原为 `Token` 序列，供现有的 Parser 使用。
+   */
+  [[nodiscard]] std::vector<Token> to_tokens() const;
+};
+
+} // namespace czc::lexer
+
+#endif // CZC_LEXER_TOKEN_SPAN_HPP
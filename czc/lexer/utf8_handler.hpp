@@ -52,6 +52,12 @@ public:
    */
   static std::string codepoint_to_utf8(unsigned int codepoint);
 
+  /**
+   * @brief 将一个 Unicode 码点的 UTF-8 编码追加到 `result` 末尾。
+   * @details 超出 Unicode 范围（大于 0x10FFFF）的码点不追加任何内容。
+   */
+  static void append_utf8(std::string& result, unsigned int codepoint);
+
   /**
    * @brief 从输入字符串的指定位置读取一个完整的 UTF-8 字符。
    * @param[in]     input 从中读取的源字符串。
@@ -73,6 +79,27 @@ public:
    */
   static bool read_char(const std::vector<char>& input, size_t& pos,
                         std::string& dest);
+
+  /**
+   * @brief 批量验证 `[pos, end)` 区间内的 UTF-8 序列。
+   * @details
+   *   纯 ASCII 部分由扫描内核按数据块整段跳过，只有多字节字符才逐个检查，
+   *   且全程不复制任何字节。验证规则与 `read_char` 一致；跨越 `end` 的
+   *   不完整序列视为无效。
+   * @param[in] data 输入缓冲区。
+   * @param[in] pos  起始位置。
+   * @param[in] end  区间结束位置（不含）。
+   * @return 第一个无效序列的起始字节位置；若区间全部有效则返回 `end`。
+   */
+  static size_t validate(const char* data, size_t pos, size_t end) noexcept;
+
+  /**
+   * @brief 跳过从 `pos` 开始的连续有效多字节 UTF-8 字符。
+   * @details 遇到 ASCII 字节、无效序列或 `end` 时停止，供标识符扫描使用。
+   * @return 停止处的字节位置。
+   */
+  static size_t skip_multibyte(const char* data, size_t pos,
+                               size_t end) noexcept;
 };
 
 } // namespace czc::lexer
@@ -0,0 +1,76 @@
+/**
+ * @file bracket_table.hpp
+ * @brief 定义了预先计算括号配对关系的 `BracketTable`。
+ * @details
+ *   错误恢复需要回答“当前代码块在哪里结束”这类问题。逐个 Token 向前扫描
+ *   在严重损坏的输入上会反复扫过同一片区域；`BracketTable` 在一次线性扫描
+ *   中记录每个括号的配对位置以及每个 Token 所在的最内层代码块，
+ *   之后的查询都是 O(1)。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_PARSER_BRACKET_TABLE_HPP
+#define CZC_PARSER_BRACKET_TABLE_HPP
+
+#include "czc/lexer/token.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace czc::parser {
+
+/**
+ * @brief 一个 Token 序列中所有括号的配对表。
+ * @details
+ *   小括号、方括号与大括号各自独立配对，与按种类计数括号深度的扫描结果
+ *   一致：`( }` 这样的交错不会让大括号的配对错位。
+ *
+ * @property {线程安全} 构建完成后只读访问是线程安全的。
+ */
+class BracketTable {
+public:
+  // 表示没有配对的括号或不在任何代码块中。
+  static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief 对 Token 序列做一次线性扫描，构建配对表。
+   * @param[in] tokens 完整的 Token 序列。
+   */
+  explicit BracketTable(const std::vector<lexer::Token>& tokens);
+
+  /**
+   * @brief 获取括号 Token 的配对位置。
+   * @param[in] index Token 下标。
+   * @return 配对括号的下标；不是括号或没有配对时返回 `NONE`。
+   */
+  [[nodiscard]] uint32_t get_match(size_t index) const noexcept {
+    return index < match.size() ? match[index] : NONE;
+  }
+
+  /**
+   * @brief 获取下标 `index` 之前尚未闭合的最内层 `{`。
+   * @details
+   *   `index` 本身是 `{` 时返回其外层的 `{`；是 `}` 时返回它所闭合的 `{`。
+   *   因此从 `index` 开始按大括号深度向前扫描时，第一个使深度降到外层的
+   *   `}` 正是 `get_match(get_enclosing_brace(index))`。
+   * @param[in] index Token 下标。
+   * @return 左大括号的下标；不在任何代码块中时返回 `NONE`。
+   */
+  [[nodiscard]] uint32_t get_enclosing_brace(size_t index) const noexcept {
+    return index < enclosing_brace.size() ? enclosing_brace[index] : NONE;
+  }
+
+private:
+  // 每个 Token 的配对括号下标。
+  std::vector<uint32_t> match;
+
+  // 每个 Token 所在的最内层代码块的左大括号下标。
+  std::vector<uint32_t> enclosing_brace;
+};
+
+} // namespace czc::parser
+
+#endif // CZC_PARSER_BRACKET_TABLE_HPP
@@ -0,0 +1,46 @@
+/**
+ * @file declaration_sink.hpp
+ * @brief 定义了接收顶层声明的 `DeclarationSink` 接口。
+ * @details
+ *   `Parser::parse(DeclarationSink&)` 每解析完一个顶层声明（或顶层注释）
+ *   就把它交给接收器，而不是挂到 `Program` 节点下。接收器决定如何处理：
+ *   保留下来拼成完整的 CST，或立即转换成 AST 后丢弃，使同一时刻只有
+ *   一个声明的 CST 存活。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_PARSER_DECLARATION_SINK_HPP
+#define CZC_PARSER_DECLARATION_SINK_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/utils/source_location.hpp"
+
+#include <memory>
+
+namespace czc::parser {
+
+/**
+ * @brief 顶层声明的接收器。
+ * @details 回调按源码顺序在解析线程上同步调用。
+ */
+class DeclarationSink {
+public:
+  virtual ~DeclarationSink() = default;
+
+  /**
+   * @brief 开始解析前调用一次。
+   * @param[in] location 程序的起始位置（即 `Program` 节点的位置）。
+   */
+  virtual void begin_program(const utils::SourceLocation& location) = 0;
+
+  /**
+   * @brief 每解析完一个顶层声明或顶层注释调用一次。
+   * @param[in] node 声明（或 `Comment`）节点，所有权转移给接收器。
+   */
+  virtual void add_declaration(std::unique_ptr<cst::CSTNode> node) = 0;
+};
+
+} // namespace czc::parser
+
+#endif // CZC_PARSER_DECLARATION_SINK_HPP
@@ -0,0 +1,165 @@
+/**
+ * @file incremental_parser.hpp
+ * @brief 定义了在编辑之间复用 CST 子树的增量语法分析器 `IncrementalParser`。
+ * @details
+ *   顶层条目（声明与顶层注释）之间不共享解析状态：同一段 Token 从同一个
+ *   条目起点开始解析，得到的子树与错误总是相同。`IncrementalParser`
+ *   因此记录每个条目消费的 Token 区间及其错误，在 `Lexer::relex` 更新
+ *   Token 序列之后：
+ *   - 编辑窗口之前、且解析时查看过的 Token 都未改变的条目原样保留；
+ *   - 从第一个受影响的条目起重新解析，直到某个新条目的结尾越过编辑窗口、
+ *     且恰好落在旧序列中某个条目的起点上（重新同步）；
+ *   - 其后的旧条目连同子树与错误一起沿用，只平移位置（见
+ *     `cst::shift_positions`）。
+ *
+ *   重新解析的工作量只与受影响的顶层条目有关；沿用的后缀仍需逐节点平移
+ *   位置，但不分配任何内存。条目内部（如函数体中的语句）不单独复用，
+ *   修改函数体会重新解析整个函数。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_PARSER_INCREMENTAL_PARSER_HPP
+#define CZC_PARSER_INCREMENTAL_PARSER_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/lexer/token.hpp"
+#include "czc/parser/error_collector.hpp"
+#include "czc/parser/parser.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace czc::parser {
+
+/**
+ * @brief 一次 `IncrementalParser::reparse` 的工作量。
+ */
+struct ReparseStats {
+  // 原样保留或平移后沿用的顶层条目数
+  size_t reused_items = 0;
+  // 重新解析的顶层条目数
+  size_t reparsed_items = 0;
+};
+
+/**
+ * @brief 保留上一次的 CST，只重新解析受编辑影响的顶层条目。
+ * @details CST 总是在堆上分配：沿用的子树会在不同版本的树之间移动。
+ * @property {线程安全} 非线程安全。
+ */
+class IncrementalParser {
+public:
+  /**
+   * @brief 构造一个增量语法分析器。
+   * @param[in] filename 源文件名，用于节点位置与错误报告。
+   */
+  explicit IncrementalParser(const std::string& filename = "<unknown>");
+
+  /**
+   * @brief 全量解析一个 Token 序列，丢弃之前的树。
+   * @param[in] tokens 以 EOF 结尾的完整 Token 序列。
+   * @return 程序根节点，在下一次解析前有效。
+   */
+  const cst::CSTNode* parse(const std::vector<lexer::Token>& tokens);
+
+  /**
+   * @brief 在 `Lexer::relex` 更新 Token 序列之后增量地更新 CST。
+   * @details 结果（树结构、位置与错误）与对 `tokens` 全量解析完全相同。
+   *          尚未解析过或窗口与上一次的序列不符时退回全量解析。
+   * @param[in] tokens 更新后的完整 Token 序列。
+   * @param[in] range  `relex` 返回的被替换窗口。
+   * @return 程序根节点，在下一次解析前有效。
+   */
+  const cst::CSTNode* reparse(const std::vector<lexer::Token>& tokens,
+                              const lexer::RelexRange& range);
+
+  /**
+   * @brief 获取当前的程序根节点；尚未解析时返回 nullptr。
+   */
+  [[nodiscard]] const cst::CSTNode* get_tree() const noexcept {
+    return program.get();
+  }
+
+  /**
+   * @brief 获取当前树的全部语法错误，按源码顺序排列。
+   */
+  [[nodiscard]] const std::vector<ParserError>& get_errors() const noexcept {
+    return errors;
+  }
+
+  [[nodiscard]] bool has_errors() const noexcept {
+    return !errors.empty();
+  }
+
+  /**
+   * @brief 获取最近一次 `parse` 或 `reparse` 的工作量。
+   */
+  [[nodiscard]] const ReparseStats& get_last_stats() const noexcept {
+    return last_stats;
+  }
+
+  /**
+   * @brief 设置允许的最大语法嵌套深度，见 `Parser::set_max_depth`。
+   */
+  void set_max_depth(size_t depth) noexcept {
+    max_depth = depth;
+  }
+
+private:
+  /**
+   * @brief 一个顶层条目：一次 `Parser::parse_top_level_item` 的结果。
+   */
+  struct Item {
+    // 消费的 Token 区间 [first_token, end_token)
+    size_t first_token = 0;
+    size_t end_token = 0;
+    // 首个 Token 的位置，用于计算沿用时的平移
+    size_t line = 0;
+    size_t column = 0;
+    size_t offset = 0;
+    // 是否解析出了节点（同步失败时没有）
+    bool has_node = false;
+    // 重新组装期间暂存的节点；平时节点挂在 `program` 之下
+    std::unique_ptr<cst::CSTNode> node;
+    // 解析该条目时报告的错误
+    std::vector<ParserError> errors;
+  };
+
+  /**
+   * @brief 从第 `start` 个 Token 起逐个解析条目。
+   * @param[in] resync_begin 新序列中可以重新同步的最小下标；新条目在此之后
+   *                         结束、且其结尾对应 `old_items` 中某个条目的起点时
+   *                         停止，返回该条目的下标。
+   * @param[in] index_delta  窗口之后新旧 Token 下标之差。
+   * @return 重新同步的旧条目下标；一直解析到 EOF 时返回 `old_items.size()`。
+   */
+  size_t parse_items(const std::vector<lexer::Token>& tokens, size_t start,
+                     size_t resync_begin, std::ptrdiff_t index_delta,
+                     const std::vector<Item>& old_items);
+
+  /**
+   * @brief 由条目重新组装程序根节点与错误列表。
+   */
+  void rebuild(const std::vector<lexer::Token>& tokens);
+
+  // 源文件名与其在 `SourceManager` 中的编号
+  std::string filename;
+  utils::FileId file_id;
+  size_t max_depth{Parser::DEFAULT_MAX_DEPTH};
+
+  // 上一次解析的 Token 数
+  size_t token_count{0};
+  // 按源码顺序排列的顶层条目；节点在 `rebuild` 时挂到 `program` 下
+  std::vector<Item> items;
+
+  std::unique_ptr<cst::CSTNode> program;
+  std::vector<ParserError> errors;
+  ReparseStats last_stats;
+};
+
+} // namespace czc::parser
+
+#endif // CZC_PARSER_INCREMENTAL_PARSER_HPP
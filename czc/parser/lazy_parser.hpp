@@ -0,0 +1,131 @@
+/**
+ * @file lazy_parser.hpp
+ * @brief 定义了按需解析函数体的语法分析器 `LazyParser`。
+ * @details
+ *   大纲、符号索引与签名查询只关心顶层声明，解析每个函数体都是浪费。
+ *   `LazyParser` 先以 `Parser::set_defer_bodies` 解析出只有签名的树，
+ *   函数体由括号配对表一步跳过，只留下空的占位节点；某个函数体第一次经由
+ *   `get_body` 访问时，才解析它的 Token 区间并替换占位节点。
+ *
+ *   函数体单独解析时的位置与嵌套深度都与在函数声明中相同（见
+ *   `Parser::parse_function_body`），因此展开后的子树与全量解析的结果完全
+ *   一致。函数体含有语法错误时，错误恢复不会越过配对的 `}`，结果可能与
+ *   全量解析不同。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_PARSER_LAZY_PARSER_HPP
+#define CZC_PARSER_LAZY_PARSER_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/token.hpp"
+#include "czc/parser/error_collector.hpp"
+#include "czc/parser/parser.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace czc::parser {
+
+/**
+ * @brief 先只解析顶层声明，函数体在首次访问时才解析。
+ * @details CST 总是在堆上分配：展开函数体时需要替换占位节点。
+ * @property {线程安全} 非线程安全。
+ */
+class LazyParser {
+public:
+  /**
+   * @brief 构造一个按需解析函数体的语法分析器。
+   * @param[in] tokens   以 EOF 结尾的完整 Token 序列。LazyParser 直接引用
+   *                     该序列而不拷贝，调用方必须保证它在 LazyParser
+   *                     存活期间保持有效。
+   * @param[in] filename 源文件名，用于节点位置与错误报告。
+   */
+  explicit LazyParser(const std::vector<lexer::Token>& tokens,
+                      const std::string& filename = "<unknown>");
+
+  /**
+   * @brief 解析顶层声明，推迟全部函数体；丢弃之前的树。
+   * @return 程序根节点，在下一次 `parse` 前有效。函数体在展开前是语句
+   *         列表为空的 `BlockStmt`。
+   */
+  const cst::CSTNode* parse();
+
+  /**
+   * @brief 获取函数声明的函数体，尚未解析时先解析它。
+   * @param[in] function 当前树中的 `FnDeclaration` 节点。
+   * @return 函数体节点；函数声明不完整、没有函数体时返回 nullptr。
+   */
+  const cst::CSTNode* get_body(const cst::CSTNode* function);
+
+  /**
+   * @brief 按源码顺序展开全部尚未解析的函数体。
+   */
+  void expand_all();
+
+  /**
+   * @brief 函数声明的函数体是否还未解析。
+   */
+  [[nodiscard]] bool is_deferred(const cst::CSTNode* function) const {
+    return pending.count(function) != 0;
+  }
+
+  /**
+   * @brief 获取尚未解析的函数体数。
+   */
+  [[nodiscard]] size_t get_deferred_count() const noexcept {
+    return pending.size();
+  }
+
+  /**
+   * @brief 获取当前的程序根节点；尚未解析时返回 nullptr。
+   */
+  [[nodiscard]] const cst::CSTNode* get_tree() const noexcept {
+    return program.get();
+  }
+
+  /**
+   * @brief 获取目前为止的语法错误。
+   * @details 先是顶层声明的错误，其后是各函数体的错误，按展开的顺序排列。
+   */
+  [[nodiscard]] const std::vector<ParserError>& get_errors() const noexcept {
+    return errors;
+  }
+
+  [[nodiscard]] bool has_errors() const noexcept {
+    return !errors.empty();
+  }
+
+  /**
+   * @brief 设置允许的最大语法嵌套深度，见 `Parser::set_max_depth`。
+   */
+  void set_max_depth(size_t depth) noexcept {
+    max_depth = depth;
+  }
+
+private:
+  /**
+   * @brief 解析一个函数体并替换其占位节点。
+   */
+  void expand(const DeferredBody& body);
+
+  const std::vector<lexer::Token>& tokens;
+  std::string filename;
+  size_t max_depth{Parser::DEFAULT_MAX_DEPTH};
+
+  std::unique_ptr<cst::CSTNode> program;
+  std::vector<ParserError> errors;
+
+  // 按源码顺序排列的推迟解析的函数体
+  std::vector<DeferredBody> bodies;
+  // 尚未解析的函数体：函数声明节点 -> `bodies` 中的下标
+  std::unordered_map<const cst::CSTNode*, size_t> pending;
+};
+
+} // namespace czc::parser
+
+#endif // CZC_PARSER_LAZY_PARSER_HPP
@@ -11,15 +11,44 @@
 #include "czc/cst/cst_node.hpp"
 #include "czc/diagnostics/diagnostic_reporter.hpp"
 #include "czc/lexer/token.hpp"
+#include "czc/lexer/token_source.hpp"
+#include "czc/parser/bracket_table.hpp"
 #include "czc/parser/error_collector.hpp"
+#include "czc/parser/token_buffer.hpp"
 
+#include <cstdint>
+#include <initializer_list>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+namespace czc::utils {
+class ThreadPool;
+} // namespace czc::utils
+
+namespace czc::cst {
+class CommentTable;
+enum class CommentPlacement : uint8_t;
+} // namespace czc::cst
+
 namespace czc::parser {
 
+class DeclarationSink;
+
+/**
+ * @brief 一个推迟解析的函数体，见 `Parser::set_defer_bodies`。
+ */
+struct DeferredBody {
+  // 函数体所属的 `FnDeclaration` 节点
+  cst::CSTNode* function = nullptr;
+  // 代替函数体的空 `BlockStmt` 节点，是 `function` 的子节点
+  cst::CSTNode* placeholder = nullptr;
+  // 函数体的 Token 区间 [first_token, end_token)：从 `{` 到配对的 `}`
+  size_t first_token = 0;
+  size_t end_token = 0;
+};
+
 /**
  * @brief 负责将 Token 流转换为具体语法树（CST）的语法分析器。
  * @details
@@ -35,20 +64,195 @@ namespace czc::parser {
  */
 class Parser {
 public:
+  // 默认的最大语法嵌套深度，见 `set_max_depth`。
+  static constexpr size_t DEFAULT_MAX_DEPTH = 512;
+
+  // 单个代码块内允许累积的错误数量，超过后跳过该代码块的剩余部分。
+  static constexpr size_t MAX_ERRORS_PER_BLOCK = 16;
+
   /**
    * @brief 构造一个语法分析器。
-   * @param[in] tokens Token 序列。
+   * @param[in] tokens Token 序列。Parser 直接引用该序列而不拷贝，
+   *                   调用方必须保证它在 `parse()` 返回前保持有效。
    * @param[in] filename 源文件名，用于错误报告（默认为 "<unknown>"）。
    */
   explicit Parser(const std::vector<lexer::Token>& tokens,
                   const std::string& filename = "<unknown>");
 
+  /**
+   * @brief 构造一个语法分析器，并接管 Token 序列的所有权。
+   * @param[in] tokens Token 序列（将被移动）。
+   * @param[in] filename 源文件名，用于错误报告（默认为 "<unknown>"）。
+   */
+  explicit Parser(std::vector<lexer::Token>&& tokens,
+                  const std::string& filename = "<unknown>");
+
+  /**
+   * @brief 构造一个从拉取式数据源按需读取 Token 的语法分析器。
+   * @details
+   *   Parser 只在有界的前瞻窗口内缓存 Token，不会物化完整的 Token 序列。
+   *   例如配合 `PreprocessedTokenSource`，词法分析与科学计数法预处理会
+   *   随着解析过程内联执行。
+   * @param[in] source Token 数据源。
+   * @param[in] filename 源文件名，用于错误报告（默认为 "<unknown>"）。
+   */
+  explicit Parser(std::unique_ptr<lexer::TokenSource> source,
+                  const std::string& filename = "<unknown>");
+
   /**
    * @brief 解析 Token 流并生成 CST。
    * @return 解析成功返回程序根节点，失败返回 nullptr。
    */
   [[nodiscard]] std::unique_ptr<cst::CSTNode> parse();
 
+  /**
+   * @brief 解析 Token 流，把每个顶层声明依次交给接收器。
+   * @details
+   *   不构造 `Program` 节点，也不保留已交出的声明：接收器立即转换并丢弃
+   *   声明时（例如直接构建 AST），同一时刻只有一个声明的 CST 存活。
+   *   节点总是在堆上分配，`set_arena_enabled` 对此方法无效。
+   *   错误恢复与 `parse()` 完全相同。
+   * @param[in,out] sink 接收顶层声明与顶层注释的接收器。
+   */
+  void parse(DeclarationSink& sink);
+
+  /**
+   * @brief 从当前位置解析一个顶层条目：一个声明或一条顶层注释。
+   * @details
+   *   即 `parse()` 顶层循环的一轮：声明解析失败时同步到下一个语句开始，
+   *   每次调用至少前进一个 Token。条目之间不共享任何解析状态，因此同一段
+   *   Token 从同一个条目起点开始解析，得到的节点与错误总是相同
+   *   （见 `IncrementalParser`）。节点的分配方式同 `parse()`。
+   * @return 解析出的节点；声明解析失败或已到达 EOF 时返回空。
+   */
+  [[nodiscard]] std::unique_ptr<cst::CSTNode> parse_top_level_item();
+
+  /**
+   * @brief 从当前位置（`{`）解析一个推迟的函数体，见 `set_defer_bodies`。
+   * @details 节点位置与嵌套深度都与在函数声明中解析时相同。
+   * @return 函数体节点；超出嵌套深度上限时返回空。
+   */
+  [[nodiscard]] std::unique_ptr<cst::CSTNode> parse_function_body();
+
+  /**
+   * @brief 是否已到达 Token 流的末尾（当前 Token 为 EOF）。
+   */
+  [[nodiscard]] bool at_end() const {
+    return check(lexer::TokenType::EndOfFile);
+  }
+
+  /**
+   * @brief 获取已消费的 Token 数，即当前 Token 在数据源中的下标。
+   */
+  [[nodiscard]] size_t get_position() const noexcept {
+    return current;
+  }
+
+  // `parse_parallel` 默认的最小分块大小（Token 数）。
+  static constexpr size_t DEFAULT_PARALLEL_CHUNK_TOKENS = 4096;
+
+  /**
+   * @brief 按顶层声明切分 Token 序列，在线程池上并行解析。
+   * @details
+   *   预扫描只跟踪括号深度：深度为 0、前一个非注释 Token 为 `;` 或 `}`
+   *   的 `fn`/`struct`/`type`/`let`/`var` 可以作为切分点。各块由独立的
+   *   Parser 解析成子树，按顺序挂到同一个 `Program` 节点下，错误也按块的
+   *   顺序合并，因此 CST 与错误列表都与串行的 `parse()` 完全一致。
+   *
+   *   只有前面的块全部无错时，串行解析才保证在切分点处于顶层；因此从第一个
+   *   出错的块开始，其后的输入会作为一个整体重新串行解析。
+   *
+   *   仅当 Parser 由 Token 向量构造且尚未开始解析时可用，否则（以及输入
+   *   不足两块时）直接退回 `parse()`。
+   * @param[in] pool             执行分块任务的线程池。
+   * @param[in] min_chunk_tokens 每块的最小 Token 数。
+   * @return 与 `parse()` 相同的程序根节点。
+   */
+  [[nodiscard]] std::unique_ptr<cst::CSTNode>
+  parse_parallel(utils::ThreadPool& pool,
+                 size_t min_chunk_tokens = DEFAULT_PARALLEL_CHUNK_TOKENS);
+
+  /**
+   * @brief 设置是否在 Arena 中分配 CST。
+   * @details
+   *   启用后 `parse()` 返回一个 `cst::CSTArenaRoot`，所有子孙节点及其子节点
+   *   列表从根节点持有的内存块中按指针递增分配，丢弃整棵树时一次性释放。
+   *   适用于解析后整体使用、整体丢弃的场景（例如一次格式化或编译）。
+   * @param[in] enabled 是否启用（默认关闭）。
+   */
+  void set_arena_enabled(bool enabled) noexcept {
+    arena_enabled = enabled;
+  }
+
+  /**
+   * @brief 设置是否推迟解析函数声明的函数体。
+   * @details
+   *   启用后，`fn` 声明的函数体按括号配对表直接跳到配对的 `}`，只生成一个
+   *   语句列表为空的 `BlockStmt` 占位节点，并把 Token 区间记录在
+   *   `get_deferred_bodies()` 中，供之后按需解析（见 `LazyParser`）。
+   *   函数体内的语法错误因此不会报告。只需要顶层声明的场景（大纲、符号
+   *   索引、签名）可以据此省去绝大部分解析工作。
+   *
+   *   仅当 Parser 由 Token 向量构造时生效；流式数据源无法回头读取函数体，
+   *   此时照常解析。找不到配对的 `}` 时该函数体也照常解析。
+   * @param[in] enabled 是否启用（默认关闭）。
+   */
+  void set_defer_bodies(bool enabled) noexcept {
+    defer_bodies = enabled;
+  }
+
+  /**
+   * @brief 设置是否在解析过程中计算结构哈希。
+   * @details
+   *   启用后，每个顶层条目一解析完就自底向上计算其中全部节点的结构哈希
+   *   （见 `cst::compute_structural_hash`），交给接收器的声明已经带有哈希；
+   *   `parse()` 与 `parse_parallel` 返回前再计算 `Program` 节点的哈希。
+   *   之后比较两个版本的树（`cst::cst_diff`）或以子树哈希作缓存的键时，
+   *   不必再遍历整棵树。与推迟的函数体一起使用时，展开函数体会使祖先的
+   *   哈希过期。
+   * @param[in] enabled 是否启用（默认关闭）。
+   */
+  void set_structural_hash_enabled(bool enabled) noexcept {
+    structural_hash_enabled = enabled;
+  }
+
+  /**
+   * @brief 设置接收注释的侧表。
+   * @details
+   *   设置后注释不再作为 `Comment` 节点进入 CST，而是按附着规则记录在
+   *   `table` 中（见 `cst::CommentTable`），树中只剩真正的语法节点。
+   *   独立注释要等到其后的元素解析完才能附着，因此这一模式下顶层条目之间
+   *   共享暂存的注释：`IncrementalParser`、`StreamParser`、`LazyParser`
+   *   与 `parse_parallel` 内部创建的 Parser 不使用注释表，仍生成注释节点。
+   * @param[in] table 注释表，为空时恢复默认行为；必须比解析出的树活得
+   *                  更久。
+   */
+  void set_comment_table(cst::CommentTable* table) noexcept {
+    comment_table = table;
+  }
+
+  /**
+   * @brief 获取推迟解析的函数体，按源码顺序排列。
+   * @details 其中的节点指针指向 `parse()` 返回的树，随树一起失效。
+   */
+  [[nodiscard]] const std::vector<DeferredBody>&
+  get_deferred_bodies() const noexcept {
+    return deferred_bodies;
+  }
+
+  /**
+   * @brief 设置允许的最大语法嵌套深度。
+   * @details
+   *   每一层代码块、括号/数组/调用参数中的表达式、前缀运算符、赋值以及
+   *   类型表达式都计为一层嵌套。超出上限时报告一次 P0014 错误并放弃解析
+   *   剩余的输入，而不是让递归下降耗尽调用栈，从而保证不可信输入下的
+   *   栈深度与内存都有上界。
+   * @param[in] depth 最大嵌套深度（默认 `DEFAULT_MAX_DEPTH`）。
+   */
+  void set_max_depth(size_t depth) noexcept {
+    max_depth = depth;
+  }
+
   /**
    * @brief 获取解析过程中收集的所有错误。
    * @return 错误列表的常量引用。
@@ -65,27 +269,80 @@ public:
     return error_collector.has_errors();
   }
 
+  /**
+   * @brief 把之后的语法错误直接写入共享的报告器，见
+   *        `ErrorCollector::set_reporter`；此后 `get_errors` 不再包含它们。
+   */
+  void
+  set_error_reporter(diagnostics::IDiagnosticReporter* reporter) noexcept {
+    error_collector.set_reporter(reporter);
+  }
+
+  /**
+   * @brief 设置最多报告的错误数，见 `ErrorCollector::set_error_limit`。
+   * @details 达到上限（或共享的报告器达到它的上限）后，语法分析在当前
+   *          位置结束，已构建的部分照常返回。
+   */
+  void set_error_limit(size_t limit) noexcept {
+    error_collector.set_error_limit(limit);
+  }
+
 private:
+  /**
+   * @brief 顶层解析循环：逐个解析声明并交给接收器。
+   */
+  void parse_top_level(DeclarationSink& sink);
+
+  // --- 注释 ---
+
+  /**
+   * @brief 把当前位置的行内注释（若有）附着在 `node` 之后。
+   * @details 设置了注释表时记为 `node` 的 `Trailing` 注释，否则作为
+   *          `Comment` 子节点追加到 `node`。
+   */
+  void trailing_comment(cst::CSTNode& node);
+
+  /**
+   * @brief 消费当前位置连续的独立注释。
+   * @details 设置了注释表时暂存到 `pending`，等之后的元素解析完再附着
+   *          （见 `attach_comments`）；否则作为 `Comment` 子节点追加到
+   *          `container`。
+   */
+  void collect_comments(cst::CSTNode& container,
+                        std::vector<lexer::Token>& pending);
+
+  /**
+   * @brief 把暂存的注释附着在 `anchor` 的 `placement` 位置并清空 `pending`。
+   */
+  void attach_comments(const cst::CSTNode* anchor,
+                       cst::CommentPlacement placement,
+                       std::vector<lexer::Token>& pending);
+
   // --- Token 流管理 ---
 
+  // NOTE: 以下访问方法返回指向 `TokenBuffer` 窗口的常量引用，不拷贝 Token。
+  //       引用在继续拉取 `TokenBuffer::CAPACITY - 1` 个 Token 之前保持有效，
+  //       足以覆盖 "取出 Token 后立即构造 CST 节点" 的用法；
+  //       需要跨越子表达式解析保存 Token 时必须显式拷贝。
+
   /**
    * @brief 获取当前 Token。
-   * @return 当前 Token，如果到达末尾则返回 EOF Token。
+   * @return 当前 Token，如果到达末尾则返回 EOF Token 哨兵。
    */
-  lexer::Token current_token() const;
+  const lexer::Token& current_token() const;
 
   /**
    * @brief 向前查看指定偏移量的 Token。
    * @param[in] offset 偏移量（0 表示当前 Token）。
-   * @return 指定位置的 Token，如果超出范围则返回 EOF Token。
+   * @return 指定位置的 Token，如果超出范围则返回 EOF Token 哨兵。
    */
-  lexer::Token peek(size_t offset = 0) const;
+  const lexer::Token& peek(size_t offset = 0) const;
 
   /**
    * @brief 前进到下一个 Token。
-   * @return 前进前的当前 Token。
+   * @return 前进前的当前 Token（即此后的 `tokens[current - 1]`）。
    */
-  lexer::Token advance();
+  const lexer::Token& advance();
 
   /**
    * @brief 检查当前 Token 是否为指定类型。
@@ -99,15 +356,46 @@ private:
    * @param[in] types 允许的 Token 类型列表。
    * @return 如果匹配并消费了某个类型返回 true，否则返回 false。
    */
-  bool match_token(const std::vector<lexer::TokenType>& types);
+  bool match_token(std::initializer_list<lexer::TokenType> types);
 
   /**
    * @brief 消费一个指定类型的 Token，如果不匹配则报错。
    * @param[in] type 期望的 Token 类型。
    * @param[in] message 错误消息。
-   * @return 如果成功返回消费的 Token，否则返回 nullopt。
+   * @return 如果成功返回指向消费的 Token 的指针；错误恢复时可能返回指向
+   *         虚拟 Token 的指针（在下一次 `consume` 前有效）；否则返回 nullptr。
    */
-  std::optional<lexer::Token> consume(lexer::TokenType type);
+  const lexer::Token* consume(lexer::TokenType type);
+
+  // --- 嵌套深度限制 ---
+
+  /**
+   * @brief 记录一层语法嵌套的 RAII 守卫。
+   * @details
+   *   构造时加深一层，析构时恢复。首次超出 `max_depth` 时报告错误并
+   *   跳过剩余的全部 Token，此后所有守卫都处于 `exceeded()` 状态，
+   *   调用方应立即返回，递归随之逐层退出。
+   */
+  class NestingGuard {
+  public:
+    explicit NestingGuard(Parser& parser);
+    ~NestingGuard() {
+      --parser.depth;
+    }
+
+    NestingGuard(const NestingGuard&) = delete;
+    NestingGuard& operator=(const NestingGuard&) = delete;
+
+    /**
+     * @brief 是否已超出嵌套深度上限（此时解析已被放弃）。
+     */
+    [[nodiscard]] bool exceeded() const noexcept {
+      return parser.depth_exceeded;
+    }
+
+  private:
+    Parser& parser;
+  };
 
   // --- 错误处理 ---
 
@@ -139,10 +427,17 @@ private:
   /**
    * @brief 错误恢复：同步到代码块结束。
    * @details
-   *   在代码块解析失败时，跳过直到找到右大括号或 EOF。
+   *   在代码块解析失败时，跳过直到找到右大括号或 EOF。Token 序列已物化时
+   *   借助 `BracketTable` 直接跳到配对的右大括号，否则逐个扫描。
    */
   void synchronize_to_block_end();
 
+  /**
+   * @brief 获取括号配对表，首次调用时构建。
+   * @return 配对表；数据源不是完整的已物化序列时返回 nullptr。
+   */
+  const BracketTable* get_bracket_table();
+
   /**
    * @brief 从当前 Token 创建源码位置。
    * @return 源码位置对象。
@@ -255,6 +550,13 @@ private:
    */
   std::unique_ptr<cst::CSTNode> block_statement();
 
+  /**
+   * @brief 跳过当前 `{` 开始的函数体，生成占位节点并记录其 Token 区间。
+   * @param[in] function 函数体所属的函数声明节点。
+   * @return 占位节点；无法确定函数体的结尾时返回 nullptr，且不消费 Token。
+   */
+  std::unique_ptr<cst::CSTNode> deferred_body(cst::CSTNode* function);
+
   /**
    * @brief 解析表达式语句。
    * @details 语法：expression ;
@@ -278,46 +580,16 @@ private:
   std::unique_ptr<cst::CSTNode> assignment();
 
   /**
-   * @brief 解析逻辑或表达式。
-   * @details 语法：and (|| and)*
-   * @return 逻辑或表达式节点。
-   */
-  std::unique_ptr<cst::CSTNode> logical_or();
-
-  /**
-   * @brief 解析逻辑与表达式。
-   * @details 语法：equality (&& equality)*
-   * @return 逻辑与表达式节点。
-   */
-  std::unique_ptr<cst::CSTNode> logical_and();
-
-  /**
-   * @brief 解析相等性表达式。
-   * @details 语法：comparison ((== | !=) comparison)*
-   * @return 相等性表达式节点。
-   */
-  std::unique_ptr<cst::CSTNode> equality();
-
-  /**
-   * @brief 解析比较表达式。
-   * @details 语法：term ((< | <= | > | >=) term)*
-   * @return 比较表达式节点。
-   */
-  std::unique_ptr<cst::CSTNode> comparison();
-
-  /**
-   * @brief 解析加减表达式。
-   * @details 语法：factor ((+ | -) factor)*
-   * @return 加减表达式节点。
-   */
-  std::unique_ptr<cst::CSTNode> term();
-
-  /**
-   * @brief 解析乘除取模表达式。
-   * @details 语法：unary ((* | / | %) unary)*
-   * @return 乘除取模表达式节点。
+   * @brief 以优先级爬升（Pratt）方式解析二元运算表达式。
+   * @details
+   *   语法：unary (op unary)*，其中 op 为 `||`、`&&`、相等、比较、加减、
+   *   乘除取模六个左结合的优先级层次（见 parser_expr.cpp 中的优先级表）。
+   *   只消费优先级不低于 `min_precedence` 的运算符，生成的 `BinaryExpr`
+   *   与逐级递归下降的结果完全一致。
+   * @param[in] min_precedence 允许的最低运算符优先级。
+   * @return 表达式节点。
    */
-  std::unique_ptr<cst::CSTNode> factor();
+  std::unique_ptr<cst::CSTNode> binary_expression(uint8_t min_precedence);
 
   /**
    * @brief 解析一元表达式。
@@ -357,14 +629,43 @@ private:
 
   // --- 成员变量 ---
 
-  // 从词法分析器接收到的、需要解析的 Token 序列。
-  std::vector<lexer::Token> tokens;
+  // 需要解析的 Token 流，以有界环形缓冲区的形式按需从数据源拉取。
+  TokenBuffer tokens;
 
-  // 指向 `tokens` 向量中当前正在处理的 Token 的索引。
+  // 当前正在处理的 Token 在 Token 流中的绝对下标。
   size_t current;
 
-  // 源文件名，用于错误报告
-  std::string filename;
+  // 构造时数据源背后的完整 Token 序列（流式数据源为 nullptr），
+  // 以及首次错误恢复时据此构建的括号配对表。
+  const std::vector<lexer::Token>* materialized_tokens;
+  std::optional<BracketTable> bracket_table;
+
+  // `consume` 在错误恢复时返回的虚拟 Token 的存放位置。
+  lexer::Token synthetic_token{lexer::TokenType::Unknown, ""};
+
+  // 源文件名在 `SourceManager` 中的编号，用于错误报告
+  utils::FileId file_id;
+
+  // 是否在 Arena 中分配 CST，见 `set_arena_enabled`。
+  bool arena_enabled{false};
+
+  // 是否推迟解析函数体，以及已推迟的函数体，见 `set_defer_bodies`。
+  bool defer_bodies{false};
+  std::vector<DeferredBody> deferred_bodies;
+
+  // 是否在解析过程中计算结构哈希，见 `set_structural_hash_enabled`。
+  bool structural_hash_enabled{false};
+
+  // 接收注释的侧表，见 `set_comment_table`；以及顶层尚未附着的独立注释。
+  cst::CommentTable* comment_table{nullptr};
+  std::vector<lexer::Token> pending_top_level_comments;
+
+  // 允许的最大嵌套深度与当前嵌套深度，见 `set_max_depth`。
+  size_t max_depth{DEFAULT_MAX_DEPTH};
+  size_t depth{0};
+
+  // 是否已因嵌套过深而放弃解析。
+  bool depth_exceeded{false};
 
   // 用于收集在语法分析期间遇到的所有语法错误。
   ParserErrorCollector error_collector;
@@ -0,0 +1,144 @@
+/**
+ * @file stream_parser.hpp
+ * @brief 定义了随 Token 分批到达而推进的流式语法分析器 `StreamParser`。
+ * @details
+ *   `Parser` 从 `TokenSource` 拉取 Token，数据源取不到时只能阻塞。
+ *   `StreamParser` 反过来由调用方推入 Token（通常是 `lexer::StreamLexer`
+ *   每次 `feed` 后取走的那一批），每当一个顶层条目确定下来就立即交给
+ *   `DeclarationSink`，因此大文件在上传的过程中就已逐个声明地完成解析。
+ *   与 `StreamLexer` 一样，每次调用只做与新到达的 Token 相称的工作后返回，
+ *   可以直接在异步服务的协程或事件回调中调用。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_PARSER_STREAM_PARSER_HPP
+#define CZC_PARSER_STREAM_PARSER_HPP
+
+#include "czc/lexer/token.hpp"
+#include "czc/parser/declaration_sink.hpp"
+#include "czc/parser/error_collector.hpp"
+#include "czc/parser/parser.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace czc::parser {
+
+/**
+ * @brief 按批接收 Token 的语法分析器。
+ * @details
+ *   顶层条目之间不共享解析状态（见 `IncrementalParser`）：已到达的 Token
+ *   从一个条目起点开始逐个解析条目，解析中没有看到缓冲区末尾的条目不会
+ *   再因后续 Token 而改变，连同它的错误一起提交；第一个看到末尾的条目
+ *   及其后的 Token 留待下一批到达后从该条目的起点重新解析。接收器因此
+ *   收到的声明与错误都与对完整 Token 序列调用 `Parser::parse(sink)` 完全
+ *   一致，无论 Token 如何分批。
+ *
+ *   只有一批 Token 在括号深度 0 处出现 `;` 或 `}`（即可能结束一个条目）时
+ *   才立即尝试解析；否则缓冲区增长到上次尝试时的两倍才再次尝试，因此
+ *   一个很长的函数体逐批到达时，总工作量仍与 Token 数呈线性关系。
+ *
+ * @property {线程安全} 非线程安全；接收器在调用 `push`/`finish` 的线程上
+ *           同步调用。
+ */
+class StreamParser {
+public:
+  /**
+   * @param[in,out] sink 接收顶层声明与顶层注释的接收器，必须比本对象
+   *                     活得更久。
+   * @param[in] filename 源文件名，用于错误报告（默认为 "<unknown>"）。
+   */
+  explicit StreamParser(DeclarationSink& sink,
+                        const std::string& filename = "<unknown>");
+
+  /**
+   * @brief 设置允许的最大语法嵌套深度，见 `Parser::set_max_depth`。
+   */
+  void set_max_depth(size_t depth) noexcept {
+    max_depth = depth;
+  }
+
+  /**
+   * @brief 追加一批 Token，把其中已经确定的顶层条目交给接收器。
+   * @details `finish` 之后调用无效。批中的 EOF Token 表示输入到此结束。
+   * @param[in] tokens 新到达的 Token，按源码顺序排列。
+   * @return 本次交给接收器的条目数。
+   */
+  size_t push(std::vector<lexer::Token> tokens);
+
+  /**
+   * @brief 声明 Token 已经全部到达，解析剩余的全部条目。
+   * @return 本次交给接收器的条目数。
+   */
+  size_t finish();
+
+  /**
+   * @brief 是否已调用 `finish`。
+   */
+  [[nodiscard]] bool is_finished() const noexcept {
+    return finished;
+  }
+
+  /**
+   * @brief 获取已到达、但尚未解析为条目的 Token 数。
+   */
+  [[nodiscard]] size_t get_pending_tokens() const noexcept {
+    return pending.size();
+  }
+
+  /**
+   * @brief 获取已提交的条目上的语法错误。
+   */
+  [[nodiscard]] const std::vector<ParserError>& get_errors() const noexcept {
+    return error_collector.get_errors();
+  }
+
+  /**
+   * @brief 检查已提交的条目上是否有语法错误。
+   */
+  [[nodiscard]] bool has_errors() const noexcept {
+    return error_collector.has_errors();
+  }
+
+  /**
+   * @brief 把之后提交的语法错误直接写入共享的报告器，见
+   *        `ErrorCollector::set_reporter`。
+   */
+  void
+  set_error_reporter(diagnostics::IDiagnosticReporter* reporter) noexcept {
+    error_collector.set_reporter(reporter);
+  }
+
+private:
+  /**
+   * @brief 从 `pending` 的起点逐个解析条目，提交已经确定的条目。
+   * @param[in] at_end Token 是否已经全部到达。
+   * @return 提交的条目数。
+   */
+  size_t parse_pending(bool at_end);
+
+  DeclarationSink& sink;
+  std::string filename;
+  utils::FileId file_id;
+  size_t max_depth{Parser::DEFAULT_MAX_DEPTH};
+
+  // 尚未提交的 Token，总是从一个顶层条目的起点开始
+  std::vector<lexer::Token> pending;
+
+  // 已推入的 Token 末尾的括号深度
+  size_t depth{0};
+
+  // 上一次解析没有提交任何条目时，`pending` 需要增长到的大小
+  size_t retry_size{0};
+
+  ParserErrorCollector error_collector;
+
+  bool begun{false};
+  bool finished{false};
+};
+
+} // namespace czc::parser
+
+#endif // CZC_PARSER_STREAM_PARSER_HPP
@@ -0,0 +1,106 @@
+/**
+ * @file token_buffer.hpp
+ * @brief 定义了 Parser 使用的有界前瞻环形缓冲区 `TokenBuffer`。
+ * @author BegoniaHe
+ * @date 2025-11-20
+ */
+
+#ifndef CZC_PARSER_TOKEN_BUFFER_HPP
+#define CZC_PARSER_TOKEN_BUFFER_HPP
+
+#include "czc/lexer/token.hpp"
+#include "czc/lexer/token_source.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace czc::parser {
+
+/**
+ * @brief 从 `TokenSource` 按需拉取 Token 的环形缓冲区。
+ * @details
+ *   Parser 以绝对下标访问 Token 流，但任一时刻只会用到当前位置附近的
+ *   少量 Token：前一个 Token（`tokens[current - 1]`）、一步回退以及
+ *   `peek(1)` 的前瞻。因此缓冲区只需保留一个固定大小的窗口，
+ *   峰值内存与前瞻深度相关，而与文件大小无关。
+ *
+ *   下标超过 EOF 后始终返回 EOF Token，语义与原先的向量实现一致。
+ *
+ * @property {线程安全} 非线程安全。
+ */
+class TokenBuffer {
+public:
+  // 窗口容量（必须为 2 的幂）。Parser 最多需要 2 个历史 Token 与 2 个前瞻 Token。
+  static constexpr size_t CAPACITY = 8;
+
+  /**
+   * @brief 构造一个缓冲区并接管数据源。
+   * @param[in] source Token 数据源。
+   */
+  explicit TokenBuffer(std::unique_ptr<lexer::TokenSource> source);
+
+  /**
+   * @brief 按绝对下标访问 Token，必要时从数据源拉取。
+   * @details 下标必须位于当前窗口内，即不早于已拉取的最后一个 Token 之前
+   *          `CAPACITY - 1` 个位置。
+   * @param[in] index Token 的绝对下标。
+   * @return 对应 Token 的常量引用，在下一次拉取前有效。
+   */
+  const lexer::Token& operator[](size_t index) const;
+
+  /**
+   * @brief 判断下标是否已越过 EOF Token。
+   * @details 对应原先向量实现中的 `index >= tokens.size()`。
+   */
+  [[nodiscard]] bool past_end(size_t index) const;
+
+  /**
+   * @brief 跳到绝对下标 `index`，中间的 Token 尽量不经过缓冲区。
+   * @details
+   *   数据源支持 `skip` 时直接跳过，否则与逐个拉取等价。跳转后
+   *   `index - 1` 处的 Token 仍然可用。`index` 不能早于当前窗口。
+   * @param[in] index 目标 Token 的绝对下标。
+   */
+  void skip_to(size_t index);
+
+  /**
+   * @brief 把下标 `index` 处变为 EOF，之后不再从数据源拉取。
+   * @details 用于提前结束语法分析（如达到错误上限）：所有读取 Token 的
+   *          循环随即看到 EOF 而退出。EOF 沿用原 Token 的位置；`index`
+   *          必须位于当前窗口内，且不晚于已拉取的 Token 数。
+   * @param[in] index 新的 EOF Token 的绝对下标。
+   */
+  void truncate(size_t index);
+
+  /**
+   * @brief 获取上游数据源。
+   */
+  [[nodiscard]] const lexer::TokenSource& get_source() const noexcept {
+    return *source;
+  }
+
+private:
+  // 上游数据源。
+  std::unique_ptr<lexer::TokenSource> source;
+
+  // NOTE: 拉取是惰性的，逻辑上不改变缓冲区的可观察状态，
+  //       因此以下成员声明为 mutable，使 `operator[]` 可以保持 const。
+  //       这与 SourceTracker 惰性构建行索引的做法一致。
+  // 固定容量的环形窗口，构造时一次性分配 `CAPACITY` 个槽位。
+  mutable std::vector<lexer::Token> ring;
+
+  // 已从数据源拉取的 Token 数量。
+  mutable size_t filled{0};
+
+  // EOF Token 的绝对下标；未拉取到 EOF 前为 `npos`。
+  mutable size_t eof_index{static_cast<size_t>(-1)};
+
+  /**
+   * @brief 持续拉取直到下标 `index` 可用（或已到达 EOF）。
+   */
+  void fill_to(size_t index) const;
+};
+
+} // namespace czc::parser
+
+#endif // CZC_PARSER_TOKEN_BUFFER_HPP
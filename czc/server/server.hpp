@@ -0,0 +1,154 @@
+/**
+ * @file server.hpp
+ * @brief 定义了常驻进程模式的请求服务器 `Server`。
+ * @details
+ *   `czc-cli daemon` 启动一个常驻进程，通过标准输入输出或 Unix 域套接字
+ *   接收 JSON-RPC 2.0 请求（每行一个），依次处理并在同一连接上逐行返回
+ *   响应。与每次调用都重新启动相比，以下状态在请求之间保持：
+ *   - 各语言环境已解析的诊断消息（`I18nMessages`）；
+ *   - 标识符驻留表；
+ *   - 每个文件最近一次解析得到的 CST 及其诊断，按内容哈希校验，内容
+ *     未变时格式化与解析请求直接复用；超出 `max_cached_files` 时淘汰
+ *     最久未使用的文件；
+ *   - 顶层声明的格式化结果（`FormatMemo`），各文件中重复的声明只排版一次。
+ *
+ *   支持的方法：`tokenize`、`parse`、`format`、`status` 与 `shutdown`。
+ *   前三者的参数为 `path`（必需）、`text`（可选，省略时读取文件）与
+ *   `locale`（可选）；`format` 另外接受 `indent_width`、`use_tabs` 与
+ *   `max_line_length`（不是 32 位非负整数时返回参数错误）。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_SERVER_HPP
+#define CZC_SERVER_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/diagnostics/diagnostic.hpp"
+#include "czc/formatter/format_memo.hpp"
+#include "czc/utils/json.hpp"
+#include "czc/utils/source_buffer.hpp"
+#include "czc/utils/string_interner.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <list>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace czc::server {
+
+/**
+ * @brief 服务器的配置。
+ */
+struct ServerOptions {
+  // 请求未指定 `locale` 时使用的语言环境
+  std::string locale = "en_US";
+  // 最多缓存多少个文件的 CST
+  size_t max_cached_files = 256;
+};
+
+/**
+ * @brief 处理 JSON-RPC 请求的常驻服务器。
+ * @property {线程安全} 非线程安全；请求按到达顺序逐个处理。
+ */
+class Server {
+public:
+  explicit Server(ServerOptions server_options = {});
+
+  /**
+   * @brief 处理一个已解析的请求。
+   * @return 响应对象；请求是通知（没有 `id`）时返回 null。
+   */
+  [[nodiscard]] utils::JsonValue handle(const utils::JsonValue& request);
+
+  /**
+   * @brief 处理一行请求文本。
+   * @return 一行响应文本（不含换行符）；通知返回空字符串。
+   */
+  [[nodiscard]] std::string handle_line(std::string_view line);
+
+  /**
+   * @brief 从 `in` 逐行读取请求并把响应写入 `out`，直到输入结束或收到
+   *        `shutdown`。
+   */
+  void serve(std::istream& in, std::ostream& out);
+
+  /**
+   * @brief 在 Unix 域套接字上监听，依次服务每个连接，直到收到 `shutdown`。
+   * @details 套接字文件已存在时先删除；退出时删除套接字文件。仅在 POSIX
+   *          平台可用。
+   * @param[in] path 套接字路径。
+   * @return 成功监听并正常退出时返回 true；无法创建套接字时返回 false。
+   */
+  bool serve_unix_socket(const std::string& path);
+
+  [[nodiscard]] bool is_shutdown_requested() const noexcept {
+    return shutdown_requested;
+  }
+
+  [[nodiscard]] size_t get_cached_file_count() const noexcept {
+    return files.size();
+  }
+
+private:
+  /**
+   * @brief 一个文件最近一次解析的结果。
+   */
+  struct FileEntry {
+    // 源码内容的哈希
+    uint64_t hash = 0;
+    // 源码内容，用于判断格式化结果是否有变化及提取诊断所在行
+    utils::SourceBuffer source;
+    // 各阶段的诊断，按报告顺序排列；发生错误时不再保留 CST
+    std::vector<diagnostics::Diagnostic> diagnostics;
+    std::unique_ptr<cst::CSTNode> cst;
+    // 在 `recent_files` 中的位置
+    std::list<std::string>::iterator recent_position;
+  };
+
+  /**
+   * @brief 获取语言环境的诊断消息，首次使用时加载并缓存。
+   */
+  const diagnostics::I18nMessages& get_messages(const std::string& locale);
+
+  /**
+   * @brief 返回文件的解析结果；内容未变时直接复用缓存。
+   * @param[out] reused 是否复用了缓存的结果。
+   */
+  const FileEntry& parse_cached(const std::string& path, std::string text,
+                                bool& reused);
+
+  utils::JsonValue render_diagnostics(
+      const std::vector<diagnostics::Diagnostic>& list,
+      const diagnostics::I18nMessages& messages) const;
+
+  utils::JsonValue tokenize(const std::string& path, std::string text,
+                            const diagnostics::I18nMessages& messages);
+  utils::JsonValue parse(const std::string& path, std::string text,
+                         const diagnostics::I18nMessages& messages);
+  utils::JsonValue format(const std::string& path, std::string text,
+                          const utils::JsonValue& params,
+                          const diagnostics::I18nMessages& messages);
+
+  ServerOptions options;
+  std::unordered_map<std::string,
+                     std::unique_ptr<diagnostics::I18nMessages>>
+      locales;
+  utils::StringInterner interner;
+  std::unordered_map<std::string, FileEntry> files;
+  // 已缓存的文件路径，最近使用的在前
+  std::list<std::string> recent_files;
+  // 各次格式化请求共用的顶层声明格式化结果
+  formatter::FormatMemo format_memo;
+  bool shutdown_requested = false;
+};
+
+} // namespace czc::server
+
+#endif // CZC_SERVER_HPP
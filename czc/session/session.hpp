@@ -0,0 +1,164 @@
+/**
+ * @file session.hpp
+ * @brief 定义了批量处理内存中源码的库接口 `Session`。
+ * @details
+ *   嵌入方（编辑器插件、构建系统等）往往一次拿到许多内存中的源码，却只能
+ *   照着 `czc-cli` 的做法逐个文件串联词法分析、预处理、语法分析与格式化，
+ *   每个文件都重新付出全部准备开销。`Session` 一次接收一组（名称，源码）
+ *   对，在内部线程池上并行处理，按输入顺序返回每份源码的结果与诊断。
+ *   以下状态在会话内共享，在多次 `run` 之间保留：
+ *   - 标识符驻留表（`utils::StringInterner`，线程安全）；
+ *   - 语言环境的诊断消息：每个工作线程的诊断引擎只加载一次，各份源码之间
+ *     只清空记录；
+ *   - 线程池与每个工作线程的格式化器，CST 的内存块由 `Arena` 的线程块缓存
+ *     复用；
+ *   - 顶层声明的格式化结果（`FormatMemo`），各源码中重复的声明只排版一次。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_SESSION_HPP
+#define CZC_SESSION_HPP
+
+#include "czc/ast/ast_context.hpp"
+#include "czc/ast/ast_node.hpp"
+#include "czc/cst/cst_node.hpp"
+#include "czc/diagnostics/diagnostic.hpp"
+#include "czc/formatter/format_memo.hpp"
+#include "czc/formatter/format_options.hpp"
+#include "czc/utils/string_interner.hpp"
+#include "czc/utils/thread_pool.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::session {
+
+/**
+ * @brief 对每份源码执行到哪一步。
+ * @details 三者都先完成词法分析、Token 预处理与语法分析。
+ */
+enum class SessionAction {
+  Parse,    ///< 只检查语法；`keep_cst` 时返回 CST
+  Format,   ///< 格式化，返回格式化后的源码
+  BuildAST, ///< 直接从 Parser 构建 AST，不保留完整的 CST
+};
+
+/**
+ * @brief 会话选项，对会话内的所有源码生效。
+ */
+struct SessionOptions {
+  SessionAction action = SessionAction::Format;
+  // 诊断消息的语言环境
+  std::string locale = "en_US";
+  // 格式化选项，仅用于 `SessionAction::Format`
+  formatter::FormatOptions format_options;
+  // 工作线程数；为 0 时使用 `utils::ThreadPool::default_thread_count()`
+  size_t jobs = 0;
+  // `SessionAction::Parse` 时是否在结果中返回 CST
+  bool keep_cst = false;
+  // 是否在各源码之间共享顶层声明的格式化结果
+  bool share_format_memo = true;
+  // 每份源码最多报告的错误数，达到后该源码提前停止分析；为 0 时不限制
+  size_t max_errors = 0;
+};
+
+/**
+ * @brief 一份待处理的源码。
+ * @details `text` 只是借用：它必须在 `Session::run` 返回前保持有效，
+ *          结果中不再引用它。
+ */
+struct SourceInput {
+  // 源码的名称，用于诊断中的文件名
+  std::string name;
+  std::string_view text;
+};
+
+/**
+ * @brief 一份源码的处理结果。
+ */
+struct SourceResult {
+  // 所有阶段都没有错误
+  bool success = false;
+  // 各阶段的诊断（含所在行的源码），按报告顺序排列
+  std::vector<diagnostics::Diagnostic> diagnostics;
+  // `SessionAction::Format` 成功时为格式化后的源码
+  std::string formatted;
+  // 格式化结果与原文不同
+  bool changed = false;
+  // `keep_cst` 时解析成功的 CST
+  std::unique_ptr<cst::CSTNode> cst;
+  // `SessionAction::BuildAST` 成功时的 AST 及持有它的上下文；上下文与
+  // 会话共享驻留表，不能比会话活得更久
+  std::unique_ptr<ast::ASTContext> ast_context;
+  ast::Program* program = nullptr;
+};
+
+/**
+ * @brief 在线程池上批量处理内存中的源码。
+ * @details
+ *   每份源码由一个工作线程从头到尾处理，工作线程按需依次领取下一份，
+ *   源码之间互不依赖。只有一个工作线程或一份源码时直接在调用线程上
+ *   处理，不启动线程池。发生错误的源码不返回 CST、AST 与格式化结果。
+ *
+ * @property {线程安全} 非线程安全：同一时刻只能有一个 `run` 在执行。
+ */
+class Session {
+public:
+  explicit Session(SessionOptions session_options = {});
+
+  ~Session();
+
+  Session(const Session&) = delete;
+  Session& operator=(const Session&) = delete;
+
+  /**
+   * @brief 处理一组源码。
+   * @details 某个源码的处理抛出异常时，等待其余源码处理完毕后再重新抛出。
+   * @param[in] sources 待处理的源码。
+   * @return 与 `sources` 一一对应的结果。
+   */
+  [[nodiscard]] std::vector<SourceResult>
+  run(const std::vector<SourceInput>& sources);
+
+  [[nodiscard]] const SessionOptions& get_options() const noexcept {
+    return options;
+  }
+
+  /**
+   * @brief 获取会话的诊断消息，用于渲染结果中的诊断（见
+   *        `diagnostics::Diagnostic::format`）。
+   */
+  [[nodiscard]] const diagnostics::I18nMessages& get_messages() const noexcept {
+    return messages;
+  }
+
+  [[nodiscard]] utils::StringInterner& get_interner() noexcept {
+    return interner;
+  }
+
+private:
+  // 一个工作线程处理各源码时复用的对象，见 session.cpp。
+  struct Worker;
+
+  SessionOptions options;
+  utils::StringInterner interner;
+  diagnostics::I18nMessages messages;
+  formatter::FormatMemo format_memo;
+  // 首次需要并行处理时创建
+  std::unique_ptr<utils::ThreadPool> pool;
+  // 每个工作线程一个，下标与领取任务的顺序无关
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  /**
+   * @brief 用 `worker` 处理一份源码。
+   */
+  SourceResult process(Worker& worker, const SourceInput& input);
+};
+
+} // namespace czc::session
+
+#endif // CZC_SESSION_HPP
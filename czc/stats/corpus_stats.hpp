@@ -0,0 +1,196 @@
+/**
+ * @file corpus_stats.hpp
+ * @brief 定义了统计一批源码的 Token 流与 CST 形状的 `CorpusStats`。
+ * @details
+ *   Arena 首块、Token 向量的预留容量以及各种紧凑格式的字段宽度，都依赖
+ *   对真实代码的假设：每 Token 多少字节、标识符与字符串多长、节点有几个
+ *   子节点、树有多深。`CorpusStats` 逐个文件累计这些分布，多个线程各自
+ *   统计后用 `merge` 合并，最后以 JSON 输出（`czc-cli stats`），用于校准
+ *   `utils::CapacityEstimate` 的初始比例与生成基准测试的语料。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_STATS_CORPUS_STATS_HPP
+#define CZC_STATS_CORPUS_STATS_HPP
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/token.hpp"
+#include "czc/utils/json.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace czc::stats {
+
+/**
+ * @brief 非负整数的分布。
+ * @details
+ *   小于 `LINEAR_BUCKETS` 的值各占一个桶，更大的值按 2 的幂分桶
+ *   （[64, 127]、[128, 255]……），桶数固定，合并只是逐桶相加。
+ *   分位数取所在桶的上界（不超过最大值）。
+ *
+ * @property {线程安全} 非线程安全。
+ */
+class Histogram {
+public:
+  // 逐值计数的桶数
+  static constexpr size_t LINEAR_BUCKETS = 64;
+  // 总桶数：线性部分之后每个 2 的幂区间一个桶，直到 2^63
+  static constexpr size_t BUCKET_COUNT = LINEAR_BUCKETS + 58;
+
+  /**
+   * @brief 记录 `times` 次值 `value`。
+   */
+  void add(uint64_t value, uint64_t times = 1) noexcept;
+
+  /**
+   * @brief 把另一个分布累加到本分布。
+   */
+  void merge(const Histogram& other) noexcept;
+
+  [[nodiscard]] uint64_t get_count() const noexcept {
+    return count;
+  }
+
+  [[nodiscard]] uint64_t get_sum() const noexcept {
+    return sum;
+  }
+
+  [[nodiscard]] uint64_t get_max() const noexcept {
+    return max;
+  }
+
+  /**
+   * @brief 获取 `q`（0 到 1 之间）分位数的上界；没有样本时为 0。
+   */
+  [[nodiscard]] uint64_t percentile(double q) const noexcept;
+
+  /**
+   * @brief 输出样本数、总和、平均值、最大值、常用分位数与非空的桶。
+   */
+  [[nodiscard]] utils::JsonValue to_json() const;
+
+private:
+  std::array<uint64_t, BUCKET_COUNT> buckets{};
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+
+  [[nodiscard]] static size_t bucket_of(uint64_t value) noexcept;
+  [[nodiscard]] static uint64_t bucket_min(size_t bucket) noexcept;
+  [[nodiscard]] static uint64_t bucket_max(size_t bucket) noexcept;
+};
+
+/**
+ * @brief 一批源码的 Token 流与 CST 统计。
+ * @details
+ *   通过 `add_file` 按文件累计：
+ *   - Token 总数与各类型的计数、标识符长度、字符串字面量（转义处理后）
+ *     的长度；
+ *   - CST 各节点类型的计数、每个节点的子节点数；
+ *   - 每个文件的 Token 数、每 Token 源码字节数与 CST 的最大深度
+ *     （根节点深度为 0）；
+ *   - 汇总的每 Token 源码字节数与 Arena 字节数，与
+ *     `utils::CapacityEstimate` 的两个比例口径相同。
+ *
+ * @property {线程安全} 非线程安全；每个线程各用一个，最后 `merge`。
+ */
+class CorpusStats {
+public:
+  /**
+   * @brief 累计一个成功解析的文件。
+   * @param[in] source_bytes 源码的字节数。
+   * @param[in] tokens       词法分析（及预处理）后的 Token 序列，含 EOF。
+   * @param[in] root         由 `tokens` 解析得到的 CST 根节点，可以为空。
+   * @param[in] arena_bytes  CST 在 Arena 中占用的字节数；未使用 Arena 时为 0。
+   */
+  void add_file(size_t source_bytes, const std::vector<lexer::Token>& tokens,
+                const cst::CSTNode* root, size_t arena_bytes = 0);
+
+  /**
+   * @brief 记录一个无法读取或存在错误、未参与统计的文件。
+   */
+  void add_failed_file() noexcept {
+    ++failed_files;
+  }
+
+  /**
+   * @brief 把另一份统计累加到本统计。
+   */
+  void merge(const CorpusStats& other);
+
+  [[nodiscard]] uint64_t get_files() const noexcept {
+    return files;
+  }
+
+  [[nodiscard]] uint64_t get_failed_files() const noexcept {
+    return failed_files;
+  }
+
+  [[nodiscard]] uint64_t get_tokens() const noexcept {
+    return tokens;
+  }
+
+  [[nodiscard]] uint64_t get_cst_nodes() const noexcept {
+    return cst_nodes;
+  }
+
+  [[nodiscard]] uint64_t get_token_count(lexer::TokenType type) const noexcept {
+    return token_types[static_cast<size_t>(type)];
+  }
+
+  [[nodiscard]] uint64_t get_node_count(cst::CSTNodeType type) const noexcept {
+    return node_types[static_cast<size_t>(type)];
+  }
+
+  [[nodiscard]] const Histogram& get_identifier_lengths() const noexcept {
+    return identifier_lengths;
+  }
+
+  [[nodiscard]] const Histogram& get_string_lengths() const noexcept {
+    return string_lengths;
+  }
+
+  [[nodiscard]] const Histogram& get_children_per_node() const noexcept {
+    return children_per_node;
+  }
+
+  [[nodiscard]] const Histogram& get_max_depths() const noexcept {
+    return max_depths;
+  }
+
+  /**
+   * @brief 以 JSON 输出全部统计；计数为 0 的 Token 与节点类型省略。
+   */
+  [[nodiscard]] utils::JsonValue to_json() const;
+
+private:
+  uint64_t files = 0;
+  uint64_t failed_files = 0;
+  uint64_t source_bytes = 0;
+  uint64_t tokens = 0;
+  uint64_t cst_nodes = 0;
+  uint64_t arena_bytes = 0;
+  // 参与 Arena 统计的文件的 Token 数
+  uint64_t arena_tokens = 0;
+
+  std::array<uint64_t, lexer::TOKEN_TYPE_COUNT> token_types{};
+  std::array<uint64_t, cst::CST_NODE_TYPE_COUNT> node_types{};
+
+  Histogram identifier_lengths;
+  Histogram string_lengths;
+  Histogram children_per_node;
+  // 以下每个文件一个样本
+  Histogram max_depths;
+  Histogram tokens_per_file;
+  Histogram bytes_per_token;
+
+  void add_tree(const cst::CSTNode* root);
+};
+
+} // namespace czc::stats
+
+#endif // CZC_STATS_CORPUS_STATS_HPP
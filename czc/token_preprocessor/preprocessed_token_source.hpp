@@ -0,0 +1,156 @@
+/**
+ * @file preprocessed_token_source.hpp
+ * @brief 定义了边词法分析边预处理的 `PreprocessedTokenSource`。
+ * @author BegoniaHe
+ * @date 2025-11-20
+ */
+
+#ifndef CZC_PREPROCESSED_TOKEN_SOURCE_HPP
+#define CZC_PREPROCESSED_TOKEN_SOURCE_HPP
+
+#include "czc/lexer/lexer.hpp"
+#include "czc/lexer/token_source.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace czc::token_preprocessor {
+
+/**
+ * @brief 将 `Lexer` 与 `TokenPreprocessor` 串联为单个拉取式数据源。
+ * @details
+ *   每次 `next()` 调用都会驱动 `Lexer::next_token()` 产生一个 Token；
+ *   Lexer 挂接了 `ScientificTokenClassifier`，科学计数法字面量在
+ *   `read_number()` 中就地完成类型推断。
+ *   整个过程不会物化任何中间的 Token 向量。
+ *
+ * @property {线程安全} 非线程安全。
+ */
+class PreprocessedTokenSource : public lexer::TokenSource {
+private:
+  // 源文件名，用于预处理阶段的错误报告。
+  std::string filename;
+
+  // 底层词法分析器。
+  lexer::Lexer lexer;
+
+  // 完整的源码内容，供科学计数法分析的上下文使用（借用 Lexer 的源码）。
+  std::string_view source_content;
+
+  // 内联执行的 Token 预处理器。
+  TokenPreprocessor preprocessor;
+
+  // 挂接到 Lexer 上的分类器，引用上面的预处理器、文件名与源码。
+  ScientificTokenClassifier classifier;
+
+public:
+  /**
+   * @brief 构造一个数据源。
+   * @param[in] input 源代码字符串。
+   * @param[in] fname 源文件名。
+   */
+  explicit PreprocessedTokenSource(const std::string& input,
+                                   const std::string& fname = "<stdin>")
+      : filename(fname), lexer(input, fname),
+        source_content(lexer.get_source_tracker().get_input()),
+        classifier(preprocessor, filename, source_content) {
+    lexer.set_scientific_classifier(&classifier);
+  }
+
+  /**
+   * @brief 构造一个接管源码字符串的数据源，不复制源码。
+   * @param[in] input 源代码字符串，其内容被移入底层词法分析器。
+   * @param[in] fname 源文件名。
+   */
+  explicit PreprocessedTokenSource(std::string&& input,
+                                   const std::string& fname = "<stdin>")
+      : filename(fname), lexer(std::move(input), fname),
+        source_content(lexer.get_source_tracker().get_input()),
+        classifier(preprocessor, filename, source_content) {
+    lexer.set_scientific_classifier(&classifier);
+  }
+
+  /**
+   * @brief 构造一个直接借用源码缓冲区的数据源，不复制源码。
+   * @param[in] input 源码缓冲区，必须比本对象活得更久。
+   * @param[in] fname 源文件名。
+   */
+  explicit PreprocessedTokenSource(const utils::SourceBuffer& input,
+                                   const std::string& fname = "<stdin>")
+      : filename(fname), lexer(input, fname),
+        source_content(lexer.get_source_tracker().get_input()),
+        classifier(preprocessor, filename, source_content) {
+    lexer.set_scientific_classifier(&classifier);
+  }
+
+  PreprocessedTokenSource(const PreprocessedTokenSource&) = delete;
+  PreprocessedTokenSource& operator=(const PreprocessedTokenSource&) = delete;
+
+  lexer::Token next() override {
+    // NOTE: 预处理错误由预处理器的收集器计数，Lexer 不知道它是否已达到
+    //       上限，因此在这里结束 Token 流。
+    if (preprocessor.get_errors().limit_reached()) {
+      lexer::Token eof = lexer::Token::makeEOF();
+      eof.offset = lexer.get_source_tracker().get_position();
+      return eof;
+    }
+    return lexer.next_token();
+  }
+
+  [[nodiscard]] size_t size_hint() const noexcept override {
+    return utils::CapacityEstimate::estimate_tokens(source_content.size());
+  }
+
+  /**
+   * @brief 设置标识符的驻留表，见 `Lexer::set_interner`。
+   */
+  void set_interner(utils::StringInterner* table) noexcept {
+    lexer.set_interner(table);
+  }
+
+  /**
+   * @brief 让词法与预处理错误都直接写入同一个共享的报告器。
+   */
+  void
+  set_error_reporter(diagnostics::IDiagnosticReporter* reporter) noexcept {
+    lexer.set_error_reporter(reporter);
+    preprocessor.set_error_reporter(reporter);
+  }
+
+  /**
+   * @brief 为词法分析与预处理分别设置最多报告的错误数。
+   * @details 任一方达到上限后 `next` 都返回 EOF：预处理错误发生在词法分析
+   *          过程中，由词法分析器结束 Token 流。
+   */
+  void set_error_limit(size_t limit) noexcept {
+    lexer.set_error_limit(limit);
+    preprocessor.set_error_limit(limit);
+  }
+
+  /**
+   * @brief 获取词法分析期间收集到的错误。
+   */
+  [[nodiscard]] const lexer::LexErrorCollector& get_lexer_errors() const noexcept {
+    return lexer.get_errors();
+  }
+
+  /**
+   * @brief 获取底层词法分析器的源码跟踪器（含分析过程中建立的行索引）。
+   */
+  [[nodiscard]] const utils::SourceTracker& get_source_tracker() const noexcept {
+    return lexer.get_source_tracker();
+  }
+
+  /**
+   * @brief 获取 Token 预处理期间收集到的错误。
+   */
+  [[nodiscard]] const TPErrorCollector& get_preprocessor_errors() const noexcept {
+    return preprocessor.get_errors();
+  }
+};
+
+} // namespace czc::token_preprocessor
+
+#endif // CZC_PREPROCESSED_TOKEN_SOURCE_HPP
@@ -9,12 +9,14 @@
 #define CZC_TOKEN_PREPROCESSOR_HPP
 
 #include "czc/diagnostics/diagnostic_reporter.hpp"
+#include "czc/lexer/lexer.hpp"
 #include "czc/lexer/token.hpp"
 #include "czc/token_preprocessor/error_collector.hpp"
 
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace czc::token_preprocessor {
@@ -60,6 +62,27 @@ struct ScientificNotationInfo {
   std::string normalized_value;
 };
 
+/**
+ * @brief 一次扫描科学计数法字面量得到的数值特征。
+ * @details
+ *   只记录整数和指向原字面量的视图，不持有任何字符串，
+ *   类型推断与溢出检查都只依赖这些字段。
+ */
+struct ScientificComponents {
+  // 尾数部分，指向原字面量, e.g., "1.5"。
+  std::string_view mantissa;
+  // 指数部分, e.g., 10。
+  int64_t exponent;
+  // 尾数是否包含小数点。
+  bool has_decimal_point;
+  // 小数点后的有效位数（去除尾随0后）。
+  size_t decimal_digits;
+  // 小数点后的原始字符数（含尾随0）。
+  size_t decimal_places;
+  // 去除前导0后尾数中的数字个数；尾数为0时为0。
+  int64_t significant_digits;
+};
+
 /**
  * @brief 封装了执行分析所需的上下文信息。
  * @details
@@ -69,7 +92,7 @@ struct AnalysisContext {
   // 当前分析的文件名。
   const std::string& filename;
   // 当前文件的完整源码内容。
-  const std::string& source_content;
+  std::string_view source_content;
   // 用于报告错误的收集器实例。
   TPErrorCollector* error_collector;
 
@@ -83,7 +106,7 @@ struct AnalysisContext {
    * @warning 前两个参数都是字符串引用，容易混淆。
    *          正确顺序为: 文件名, 源码内容, 错误收集器。
    */
-  AnalysisContext(const std::string& fname, const std::string& source,
+  AnalysisContext(const std::string& fname, std::string_view source,
                   TPErrorCollector* collector = nullptr)
       : filename(fname), source_content(source), error_collector(collector) {}
 };
@@ -116,76 +139,75 @@ public:
   analyze(const std::string& literal, const lexer::Token* token,
           const AnalysisContext& context);
 
-private:
-  /**
-   * @brief 从字面量中解析出尾数和指数部分。
-   * @param[in]  literal  字面量字符串。
-   * @param[out] mantissa 解析出的尾数。
-   * @param[out] exponent 解析出的指数。
-   * @return 如果解析成功，返回 `true`。
-   */
-  static bool parse_components(const std::string& literal,
-                               std::string& mantissa, int64_t& exponent);
-
   /**
-   * @brief 去除小数部分的尾随零。
-   * @param[in] decimal_part 小数部分字符串。
-   * @return 去除尾随零后的字符串。
+   * @brief 只推断字面量的数值类型，不分配内存。
+   * @details
+   *   与 `analyze` 的 `inferred_type` 及其报告的错误完全一致，但不构造
+   *   `ScientificNotationInfo`；Token 预处理走的是这条路径。
+   * @param[in] literal 要分析的字面量。
+   * @param[in] token   与字面量关联的 Token，用于错误报告。
+   * @param[in] context 当前的分析上下文。
+   * @return 推断出的类型；字面量格式错误时返回 `std::nullopt`。
    */
-  static std::string trim_trailing_zeros(const std::string& decimal_part);
+  static std::optional<InferredNumericType>
+  infer(std::string_view literal, const lexer::Token* token,
+        const AnalysisContext& context);
 
+private:
   /**
-   * @brief 计算去除尾随零后的小数位数。
-   * @param[in] mantissa 尾数字符串。
-   * @return 小数位数。
+   * @brief 一次扫描字面量，分解出尾数与指数并统计各项数值特征。
+   * @param[in]  literal    字面量。
+   * @param[out] components 分解结果。
+   * @return 如果字面量是合法的科学计数法形式，返回 `true`。
    */
-  static size_t count_decimal_digits(const std::string& mantissa);
+  static bool decompose(std::string_view literal,
+                        ScientificComponents& components);
 
   /**
    * @brief 根据规则推断数值类型（INT64 或 FLOAT）。
-   * @param[in] info    已部分填充的科学计数法信息。
-   * @param[in] token   关联的 Token。
-   * @param[in] context 分析上下文。
+   * @param[in] components 字面量的数值特征。
+   * @param[in] token      关联的 Token。
+   * @param[in] context    分析上下文。
    * @return 推断出的数值类型。
    */
-  static InferredNumericType infer_type(const ScientificNotationInfo& info,
+  static InferredNumericType infer_type(const ScientificComponents& components,
                                         const lexer::Token* token,
                                         const AnalysisContext& context);
 
   /**
    * @brief 检查一个潜在的整数值是否在 `int64_t` 的表示范围内。
-   * @param[in] mantissa 尾数字符串。
-   * @param[in] exponent 指数。
-   * @param[in] token    关联的 Token。
-   * @param[in] context  分析上下文。
+   * @param[in] components 字面量的数值特征。
+   * @param[in] token      关联的 Token。
+   * @param[in] context    分析上下文。
    * @return 如果值适合 `int64_t`，则返回 `true`。
    */
-  static bool fits_in_int64(const std::string& mantissa, int64_t exponent,
+  static bool fits_in_int64(const ScientificComponents& components,
                             const lexer::Token* token,
                             const AnalysisContext& context);
 
   /**
    * @brief 计算数值的“数量级”（大致的位数）。
-   * @param[in] mantissa 尾数字符串。
-   * @param[in] exponent 指数。
-   * @param[in] token    关联的 Token。
-   * @param[in] context  分析上下文。
-   * @return 返回计算出的数量级。
+   * @param[in] components 字面量的数值特征。
+   * @param[in] token      关联的 Token。
+   * @param[in] context    分析上下文。
+   * @return 返回计算出的数量级；超出 float64 范围时返回 `std::nullopt`。
    */
   static std::optional<int64_t>
-  calculate_magnitude(const std::string& mantissa, int64_t exponent,
+  calculate_magnitude(const ScientificComponents& components,
                       const lexer::Token* token,
                       const AnalysisContext& context);
 
   /**
    * @brief 报告一个数值溢出错误。
-   * @param[in] token    关联的 Token。
-   * @param[in] mantissa 尾数字符串。
-   * @param[in] exponent 指数。
-   * @param[in] context  分析上下文。
+   * @details 只有在报告错误时才会为消息参数构造字符串。
+   * @param[in] code       诊断代码（整数或浮点数溢出）。
+   * @param[in] token      关联的 Token。
+   * @param[in] components 字面量的数值特征。
+   * @param[in] context    分析上下文。
    */
-  static void report_overflow(const lexer::Token* token,
-                              const std::string& mantissa, int64_t exponent,
+  static void report_overflow(diagnostics::DiagnosticCode code,
+                              const lexer::Token* token,
+                              const ScientificComponents& components,
                               const AnalysisContext& context);
 };
 
@@ -229,8 +251,8 @@ public:
   /**
    * @brief 处理一个完整的 Token 列表。
    * @details
-   *   遍历输入的 Token 向量，当遇到 `ScientificExponent` 类型的 Token 时，
-   *   调用 `process_scientific_token` 对其进行处理和转换。
+   *   复制输入的 Token 向量后调用 `process_in_place`，原列表保持不变。
+   *   调用方不再需要原列表时，应使用右值重载或 `process_in_place`。
    * @param[in] tokens         从词法分析器获得的原始 Token 列表。
    * @param[in] filename       源代码的文件名。
    * @param[in] source_content 完整的源代码内容。
@@ -238,7 +260,33 @@ public:
    */
   std::vector<lexer::Token> process(const std::vector<lexer::Token>& tokens,
                                     const std::string& filename,
-                                    const std::string& source_content);
+                                    std::string_view source_content);
+
+  /**
+   * @brief 接管一个 Token 列表，就地处理后原样返回。
+   * @details 与 `process_in_place` 相同，不会复制 Token 流。
+   * @param[in] tokens         从词法分析器获得的原始 Token 列表（右值）。
+   * @param[in] filename       源代码的文件名。
+   * @param[in] source_content 完整的源代码内容。
+   * @return 返回经过处理和类型调整的 Token 列表。
+   */
+  std::vector<lexer::Token> process(std::vector<lexer::Token>&& tokens,
+                                    const std::string& filename,
+                                    std::string_view source_content);
+
+  /**
+   * @brief 就地处理一个完整的 Token 列表。
+   * @details
+   *   只修改 `ScientificExponent` 类型 Token 的类型字段，其余 Token 不会被
+   *   读取以外的方式触碰。不含科学计数法字面量的输入只需一次类型扫描，
+   *   不产生任何内存分配。
+   * @param[in,out] tokens     从词法分析器获得的原始 Token 列表。
+   * @param[in] filename       源代码的文件名。
+   * @param[in] source_content 完整的源代码内容。
+   */
+  void process_in_place(std::vector<lexer::Token>& tokens,
+                        const std::string& filename,
+                        std::string_view source_content);
 
   /**
    * @brief 分析并转换单个科学计数法 Token。
@@ -252,7 +300,19 @@ public:
    */
   lexer::Token process_scientific_token(const lexer::Token& token,
                                         const std::string& filename,
-                                        const std::string& source_content);
+                                        std::string_view source_content);
+
+  /**
+   * @brief 推断单个科学计数法 Token 应转换成的类型，不复制 Token。
+   * @details 错误报告与 `process_scientific_token` 相同。
+   * @param[in] token          一个类型为 `ScientificExponent` 的 Token。
+   * @param[in] filename       源代码的文件名。
+   * @param[in] source_content 完整的源代码内容。
+   * @return `Integer` 或 `Float`；分析失败（如溢出）时返回 `Unknown`。
+   */
+  lexer::TokenType classify_scientific_token(const lexer::Token& token,
+                                             const std::string& filename,
+                                             std::string_view source_content);
 
   /**
    * @brief 获取对内部错误收集器的只读访问权限。
@@ -262,6 +322,24 @@ public:
     return error_collector;
   }
 
+  /**
+   * @brief 把之后的预处理错误直接写入共享的报告器，见
+   *        `ErrorCollector::set_reporter`。
+   */
+  void
+  set_error_reporter(diagnostics::IDiagnosticReporter* reporter) noexcept {
+    error_collector.set_reporter(reporter);
+  }
+
+  /**
+   * @brief 设置最多报告的错误数，见 `ErrorCollector::set_error_limit`。
+   * @details 达到上限后，`process_in_place` 在出错的 Token 之后截断 Token
+   *          流并补上 EOF。
+   */
+  void set_error_limit(size_t limit) noexcept {
+    error_collector.set_error_limit(limit);
+  }
+
 private:
   /**
    * @brief 将内部的 InferredNumericType 映射到词法分析器的 TokenType。
@@ -271,6 +349,40 @@ private:
   static lexer::TokenType inferred_type_to_token_type(InferredNumericType type);
 };
 
+/**
+ * @brief 让 `Lexer` 在识别出科学计数法字面量时直接交给 `TokenPreprocessor`。
+ * @details
+ *   通过 `Lexer::set_scientific_classifier` 挂接后，词法分析产生的 Token
+ *   已是预处理后的结果，无需再调用 `TokenPreprocessor::process`；
+ *   预处理错误仍收集在所引用的 `TokenPreprocessor` 中，代码与位置不变。
+ *
+ * @property {生命周期} 只保存引用，所引用的对象须比本对象存活更久。
+ */
+class ScientificTokenClassifier : public lexer::ScientificLiteralClassifier {
+public:
+  /**
+   * @brief 构造一个分类器。
+   * @param[in] preprocessor   执行分析并收集错误的预处理器。
+   * @param[in] filename       源代码的文件名。
+   * @param[in] source_content 完整的源代码内容。
+   */
+  ScientificTokenClassifier(TokenPreprocessor& preprocessor,
+                            const std::string& filename,
+                            std::string_view source_content)
+      : preprocessor(preprocessor), filename(filename),
+        source_content(source_content) {}
+
+  lexer::TokenType classify(const lexer::Token& token) override {
+    return preprocessor.classify_scientific_token(token, filename,
+                                                  source_content);
+  }
+
+private:
+  TokenPreprocessor& preprocessor;
+  const std::string& filename;
+  std::string_view source_content;
+};
+
 /**
  * @brief 将 InferredNumericType 转换为字符串表示。
  * @param[in] type 推断的数值类型。
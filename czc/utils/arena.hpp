@@ -0,0 +1,181 @@
+/**
+ * @file arena.hpp
+ * @brief 定义了块式线性分配器 `Arena` 及其 STL 适配器 `ArenaAllocator`。
+ * @details
+ *   `Arena` 以内存块为单位向系统申请内存，块内按指针递增（bump-pointer）
+ *   分配，单次分配只是一次对齐和加法。分配出的内存不能单独释放，只能在
+ *   `Arena` 析构（或 `reset`）时一次性归还，适用于生命周期一致的大量小对象，
+ *   例如一次解析产生的全部语法树节点。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_ARENA_HPP
+#define CZC_UTILS_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace czc::utils {
+
+/**
+ * @brief 块式线性分配器。
+ * @details
+ *   块大小从 `initial_block_size` 开始按 2 倍增长（上限 `MAX_BLOCK_SIZE`），
+ *   超过当前块容量的大对象单独占用一个块。
+ *
+ * @property {生命周期} 所有分配的内存在 `Arena` 析构时一并归还（常规块
+ *   进入当前线程的块缓存，缓存已满或大对象块则释放），不会调用其中对象的
+ *   析构函数。
+ * @property {线程安全} 非线程安全。
+ */
+class Arena {
+public:
+  // 默认的首块大小（字节）。
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  // 块大小增长的上限（字节）。
+  static constexpr size_t MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+
+  // 每个线程的块缓存最多保留的字节数。
+  static constexpr size_t MAX_CACHED_BYTES = 8 * 1024 * 1024;
+
+  /**
+   * @brief 构造一个空的 Arena，首次分配时才申请内存块。
+   * @param[in] initial_block_size 首块大小（字节）。
+   */
+  explicit Arena(size_t initial_block_size = DEFAULT_BLOCK_SIZE) noexcept;
+
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * @brief 分配一段对齐的内存。
+   * @param[in] size  字节数。
+   * @param[in] align 对齐要求，必须是 2 的幂且不超过 `alignof(std::max_align_t)`。
+   * @return 指向未初始化内存的指针，生命周期与 Arena 相同。
+   */
+  [[nodiscard]] void* allocate(size_t size,
+                               size_t align = alignof(std::max_align_t)) {
+    size_t aligned = (offset + align - 1) & ~(align - 1);
+    if (aligned + size > capacity) {
+      return allocate_slow(size, align);
+    }
+    offset = aligned + size;
+    bytes_used += size;
+    return current + aligned;
+  }
+
+  /**
+   * @brief 归还所有内存块，回到初始状态。
+   */
+  void reset() noexcept;
+
+  /**
+   * @brief 获取已分配给调用方的字节数（不含对齐填充）。
+   */
+  [[nodiscard]] size_t get_bytes_used() const noexcept {
+    return bytes_used;
+  }
+
+  /**
+   * @brief 获取已向系统申请的内存块数量。
+   */
+  [[nodiscard]] size_t get_block_count() const noexcept {
+    return blocks.size();
+  }
+
+  /**
+   * @brief 获取当前线程的块缓存中保留的字节数。
+   */
+  [[nodiscard]] static size_t get_cached_bytes() noexcept;
+
+private:
+  /**
+   * @brief 一个内存块。
+   */
+  struct Block {
+    std::unique_ptr<std::byte[]> memory;
+    size_t size;
+    // 是否是常规块；只有常规块会放进块缓存
+    bool regular;
+  };
+
+  // 已申请的内存块。
+  std::vector<Block> blocks;
+
+  // 当前块的起始地址、容量以及已使用的偏移。
+  std::byte* current{nullptr};
+  size_t capacity{0};
+  size_t offset{0};
+
+  // 下一个常规块的大小。
+  size_t next_block_size;
+
+  // 已分配给调用方的字节数。
+  size_t bytes_used{0};
+
+  /**
+   * @brief 当前块放不下时申请新块并在其中分配。
+   */
+  void* allocate_slow(size_t size, size_t align);
+};
+
+/**
+ * @brief 从 `Arena` 分配内存的 STL 分配器。
+ * @details
+ *   `deallocate` 不做任何事，内存随 Arena 一起释放；容器扩容时旧缓冲区
+ *   会留在 Arena 中直到其析构。未绑定 Arena（空指针）时退回全局堆，
+ *   因此同一种容器类型可以同时用于堆模式与 Arena 模式。
+ */
+template <typename T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  ArenaAllocator() noexcept = default;
+
+  explicit ArenaAllocator(Arena* arena) noexcept : arena(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena(other.get_arena()) {}
+
+  [[nodiscard]] T* allocate(size_t count) {
+    if (arena == nullptr) {
+      return std::allocator<T>().allocate(count);
+    }
+    return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* ptr, size_t count) noexcept {
+    if (arena == nullptr) {
+      std::allocator<T>().deallocate(ptr, count);
+    }
+  }
+
+  [[nodiscard]] Arena* get_arena() const noexcept {
+    return arena;
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const noexcept {
+    return arena == other.get_arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+    return arena != other.get_arena();
+  }
+
+private:
+  // 所绑定的 Arena；为空时使用全局堆。
+  Arena* arena{nullptr};
+};
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_ARENA_HPP
@@ -0,0 +1,38 @@
+/**
+ * @file atomic_file.hpp
+ * @brief 提供原子地替换文件内容的写入函数。
+ * @details
+ *   内容先一次性写入同一目录下的临时文件，再通过重命名替换目标文件。
+ *   读者在任何时刻看到的要么是完整的旧内容，要么是完整的新内容；写入
+ *   中途失败时目标文件保持不变，临时文件被删除。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_ATOMIC_FILE_HPP
+#define CZC_ATOMIC_FILE_HPP
+
+#include <string>
+#include <string_view>
+
+namespace czc::utils {
+
+/**
+ * @brief 原子地把 `content` 写入 `path`。
+ * @details 目标文件已存在时沿用其权限位。重命名会替换目录项而不是改写
+ *          原文件，因此仍映射着旧内容的 `SourceBuffer` 不受影响（Windows
+ *          上被映射的文件无法替换，调用方应先释放映射）。`path` 是符号
+ *          链接时写入链接指向的文件，链接本身保持不变。
+ * @param[in] path    目标文件路径。
+ * @param[in] content 新的文件内容。
+ * @param[in] sync    是否在重命名前把临时文件刷到磁盘（`fsync`），
+ *                    以保证掉电后不会留下空文件。
+ * @return 成功时返回 true；任何一步失败时返回 false，目标文件保持不变。
+ */
+[[nodiscard]] bool write_file_atomic(const std::string& path,
+                                     std::string_view content,
+                                     bool sync = false);
+
+} // namespace czc::utils
+
+#endif // CZC_ATOMIC_FILE_HPP
@@ -0,0 +1,106 @@
+/**
+ * @file bounded_queue.hpp
+ * @brief 定义了连接流水线各阶段的有界阻塞队列 `BoundedQueue`。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_BOUNDED_QUEUE_HPP
+#define CZC_UTILS_BOUNDED_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace czc::utils {
+
+/**
+ * @brief 容量固定的多生产者、多消费者队列。
+ * @details
+ *   队列满时 `push` 阻塞，上游阶段不会比下游快出太多，积压的数据（如预读
+ *   的文件）因此有上限；队列空时 `pop` 阻塞。上游全部结束后调用 `close`，
+ *   消费者取完剩余的元素后 `pop` 返回空，据此退出。
+ *
+ *   流水线的每个元素是一整个文件，每秒的交接次数很少，锁的开销可以忽略；
+ *   因此用互斥锁与条件变量实现，等待时不占用 CPU。
+ *
+ * @property {线程安全} 所有成员函数都可以从任意线程并发调用。
+ */
+template <typename T> class BoundedQueue {
+public:
+  /**
+   * @param[in] capacity 最多容纳的元素数，为 0 时按 1 处理。
+   */
+  explicit BoundedQueue(size_t capacity)
+      : capacity(capacity == 0 ? 1 : capacity) {}
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  /**
+   * @brief 放入一个元素，队列满时等待。
+   * @return 队列已关闭时不放入并返回 false。
+   */
+  bool push(T value) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_full.wait(lock, [this] { return closed || items.size() < capacity; });
+    if (closed) {
+      return false;
+    }
+    items.push_back(std::move(value));
+    lock.unlock();
+    not_empty.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief 取出最早放入的元素，队列空时等待。
+   * @return 队列已关闭且已取空时返回空。
+   */
+  std::optional<T> pop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_empty.wait(lock, [this] { return closed || !items.empty(); });
+    if (items.empty()) {
+      return std::nullopt;
+    }
+    T value = std::move(items.front());
+    items.pop_front();
+    lock.unlock();
+    not_full.notify_one();
+    return value;
+  }
+
+  /**
+   * @brief 关闭队列：不再接受新元素，唤醒所有等待的线程。
+   * @details 已放入的元素仍然可以取出。
+   */
+  void close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+    }
+    not_full.notify_all();
+    not_empty.notify_all();
+  }
+
+  [[nodiscard]] size_t get_capacity() const noexcept {
+    return capacity;
+  }
+
+private:
+  const size_t capacity;
+  std::deque<T> items;
+  std::mutex mutex;
+  // 有元素被取出或队列关闭时通知生产者
+  std::condition_variable not_full;
+  // 有元素放入或队列关闭时通知消费者
+  std::condition_variable not_empty;
+  bool closed{false};
+};
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_BOUNDED_QUEUE_HPP
@@ -0,0 +1,143 @@
+/**
+ * @file byte_io.hpp
+ * @brief 定义了读写紧凑二进制格式的 `ByteWriter` 与 `ByteReader`。
+ * @details
+ *   整数以 LEB128 变长编码，有符号整数先做 zigzag 变换，字符串以长度开头。
+ *   磁盘缓存（`cst::CSTCache`）与符号索引共用这套编码。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_BYTE_IO_HPP
+#define CZC_BYTE_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace czc::utils {
+
+/**
+ * @brief 追加写入 LEB128 变长整数与原始字节。
+ */
+class ByteWriter {
+public:
+  void put_varint(uint64_t value) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  /**
+   * @brief 以 zigzag 编码写入有符号整数，绝对值小的负数同样只占一个字节。
+   */
+  void put_signed(int64_t value) {
+    put_varint((static_cast<uint64_t>(value) << 1) ^
+               static_cast<uint64_t>(value >> 63));
+  }
+
+  void put_fixed64(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+  void put_string(std::string_view text) {
+    put_varint(text.size());
+    out.append(text);
+  }
+
+  void put_bytes(std::string_view bytes) {
+    out.append(bytes);
+  }
+
+  [[nodiscard]] std::string take() noexcept {
+    return std::move(out);
+  }
+
+private:
+  std::string out;
+};
+
+/**
+ * @brief 带越界检查地读取 `ByteWriter` 写出的数据。
+ * @details 任何一次读取越界后 `ok()` 返回 false，此后的读取都返回零值。
+ */
+class ByteReader {
+public:
+  explicit ByteReader(std::string_view data) noexcept : data(data) {}
+
+  uint64_t get_varint() noexcept {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (pos >= data.size()) {
+        failed = true;
+        return 0;
+      }
+      auto byte = static_cast<unsigned char>(data[pos++]);
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    failed = true;
+    return 0;
+  }
+
+  int64_t get_signed() noexcept {
+    uint64_t value = get_varint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  uint64_t get_fixed64() noexcept {
+    std::string_view bytes = get_bytes(8);
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes.size(); ++i) {
+      value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i]))
+               << (8 * i);
+    }
+    return value;
+  }
+
+  std::string_view get_bytes(uint64_t count) noexcept {
+    if (failed || count > data.size() - pos) {
+      failed = true;
+      return {};
+    }
+    std::string_view bytes = data.substr(pos, static_cast<size_t>(count));
+    pos += static_cast<size_t>(count);
+    return bytes;
+  }
+
+  std::string_view get_string() noexcept {
+    return get_bytes(get_varint());
+  }
+
+  [[nodiscard]] bool ok() const noexcept {
+    return !failed;
+  }
+
+  [[nodiscard]] bool at_end() const noexcept {
+    return pos == data.size();
+  }
+
+  /**
+   * @brief 获取尚未读取的全部数据，不移动读取位置。
+   */
+  [[nodiscard]] std::string_view remaining() const noexcept {
+    return data.substr(pos);
+  }
+
+private:
+  std::string_view data;
+  size_t pos = 0;
+  bool failed = false;
+};
+
+} // namespace czc::utils
+
+#endif // CZC_BYTE_IO_HPP
@@ -0,0 +1,107 @@
+/**
+ * @file capacity_estimate.hpp
+ * @brief 定义了按输入长度预估容器容量的 `CapacityEstimate`。
+ * @details
+ *   Token 序列与 CST 的 Arena 都随输入逐步增长：向量按 2 倍扩容，每次扩容
+ *   都要把已有的 Token 整体搬移一遍；Arena 从 64 KiB 的首块开始逐块翻倍。
+ *   对大文件（尤其是生成的代码）这会带来多次重新分配与复制。
+ *
+ *   `CapacityEstimate` 维护两个比例：源码每多少字节产生一个 Token，以及
+ *   每个 Token 在 CST 的 Arena 中占用多少字节。处理前据此一次性预留容量，
+ *   处理后用实际结果以指数滑动平均修正比例，因此同一批文件处理得越多，
+ *   估计越接近这批文件的实际情况。太小的输入不参与修正，以免个别短文件
+ *   带偏比例。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_CAPACITY_ESTIMATE_HPP
+#define CZC_UTILS_CAPACITY_ESTIMATE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace czc::utils {
+
+/**
+ * @brief 进程级的容量预估比例。
+ * @property {线程安全} 所有成员函数都是线程安全的。多个线程同时修正时
+ *           个别样本可能丢失，只影响估计的收敛速度，不影响正确性。
+ */
+class CapacityEstimate {
+public:
+  // 初始的每 Token 源码字节数。
+  static constexpr double DEFAULT_BYTES_PER_TOKEN = 4.0;
+
+  // 初始的每 Token 在 CST Arena 中占用的字节数。
+  static constexpr double DEFAULT_ARENA_BYTES_PER_TOKEN = 256.0;
+
+  // 参与修正比例的最少 Token 数。
+  static constexpr size_t MIN_SAMPLE_TOKENS = 256;
+
+  // 预估 Token 数的上限：约 1 MiB 的普通源码，Token 向量约占 28 MiB。
+  static constexpr size_t MAX_ESTIMATED_TOKENS = size_t{1} << 18;
+
+  /**
+   * @brief 估算 `source_bytes` 字节的源码产生的 Token 数（含 EOF）。
+   * @details 在比例之外多留 1/8 的余量，使估计略偏大的情况占多数，
+   *          避免在最后一个 Token 处还要扩容一次。结果不超过
+   *          `MAX_ESTIMATED_TOKENS`：比例只反映此前的文件，一个几乎全是
+   *          空白或注释的大文件不应一次预留巨大的向量，超出部分照常
+   *          按倍数扩容。
+   */
+  [[nodiscard]] static size_t estimate_tokens(size_t source_bytes) noexcept;
+
+  /**
+   * @brief 以一次词法分析的实际结果修正每 Token 的源码字节数。
+   */
+  static void observe_tokens(size_t source_bytes, size_t token_count) noexcept;
+
+  /**
+   * @brief 估算 `token_count` 个 Token 构成的 CST 所需的 Arena 首块大小。
+   * @return `Arena::DEFAULT_BLOCK_SIZE` 的 2 的幂倍，不超过
+   *         `Arena::MAX_BLOCK_SIZE`；取 2 的幂倍是为了与 Arena 自身的块
+   *         大小一致，释放后仍能经由线程的块缓存复用。
+   */
+  [[nodiscard]] static size_t estimate_arena_block(size_t token_count) noexcept;
+
+  /**
+   * @brief 以一次语法分析的实际结果修正每 Token 的 Arena 字节数。
+   */
+  static void observe_arena(size_t token_count, size_t arena_bytes) noexcept;
+
+  /**
+   * @brief 获取当前的每 Token 源码字节数。
+   */
+  [[nodiscard]] static double get_bytes_per_token() noexcept;
+
+  /**
+   * @brief 获取当前的每 Token Arena 字节数。
+   */
+  [[nodiscard]] static double get_arena_bytes_per_token() noexcept;
+
+  /**
+   * @brief 把两个比例恢复为初始值。
+   */
+  static void reset() noexcept;
+
+private:
+  // NOTE: 比例以 1/256 为单位的定点数保存，读写都只是一次原子操作。
+  static constexpr uint32_t FIXED_ONE = 256;
+
+  /**
+   * @brief 以新样本 `numerator / denominator` 修正比例，新样本占 1/4 的权重。
+   */
+  static void update(std::atomic<uint32_t>& ratio, uint64_t numerator,
+                     uint64_t denominator) noexcept;
+
+  static inline std::atomic<uint32_t> bytes_per_token{
+      static_cast<uint32_t>(DEFAULT_BYTES_PER_TOKEN * FIXED_ONE)};
+  static inline std::atomic<uint32_t> arena_bytes_per_token{
+      static_cast<uint32_t>(DEFAULT_ARENA_BYTES_PER_TOKEN * FIXED_ONE)};
+};
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_CAPACITY_ESTIMATE_HPP
@@ -9,8 +9,10 @@
 #define CZC_UTILS_ERROR_COLLECTOR_HPP
 
 #include "czc/diagnostics/diagnostic_code.hpp"
+#include "czc/diagnostics/diagnostic_reporter.hpp"
 #include "czc/utils/source_tracker.hpp"
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -50,6 +52,16 @@ struct ErrorInfo {
  *   通过模板参数化，可以适应不同模块的错误类型需求，同时保持代码
  *   的一致性和可维护性。
  *
+ *   默认情况下错误保存在收集器自己的列表中。通过 `set_reporter` 关联一个
+ *   `IDiagnosticReporter`（通常是整次编译共享的 `DiagnosticEngine`）后，
+ *   错误直接以 Error 级别写入报告器，不再构造 `ErrorType`，也不在本地保存；
+ *   `has_errors` 与 `count` 仍然统计本收集器报告过的错误。
+ *
+ *   通过 `set_error_limit` 可以限制错误数（`--max-errors`、`--fail-fast`）：
+ *   本收集器的错误数达到上限，或关联的报告器报告已达到它自己的上限后，
+ *   `limit_reached` 返回 `true`，之后的错误既不报告也不计数。各阶段在主循环中检查
+ *   `limit_reached`，提前结束工作，而不是对已经放弃的输入继续分析。
+ *
  * @example
  *   using LexerError = ErrorInfo<SourceLocation>;
  *   ErrorCollector<LexerError> collector;
@@ -67,7 +79,17 @@ public:
   void add(diagnostics::DiagnosticCode code,
            const typename ErrorType::LocationType_t& location,
            const std::vector<std::string>& args = {}) {
-    errors_.emplace_back(code, location, args);
+    if (limit_reached_ || poll_limit()) {
+      return;
+    }
+    ++count_;
+    if (reporter_ != nullptr) {
+      reporter_->report(diagnostics::DiagnosticLevel::Error, code, location,
+                        args);
+    } else {
+      errors_.emplace_back(code, location, args);
+    }
+    update_limit();
   }
 
   /**
@@ -75,11 +97,64 @@ public:
    * @param[in] error 错误对象
    */
   void add(const ErrorType& error) {
-    errors_.push_back(error);
+    if (limit_reached_ || poll_limit()) {
+      return;
+    }
+    ++count_;
+    if (reporter_ != nullptr) {
+      reporter_->report(diagnostics::DiagnosticLevel::Error, error.code,
+                        error.location, error.args);
+    } else {
+      errors_.push_back(error);
+    }
+    update_limit();
+  }
+
+  /**
+   * @brief 设置本收集器最多报告的错误数。
+   * @param[in] limit 上限；默认不限制。已经达到上限时立即生效。
+   */
+  void set_error_limit(size_t limit) noexcept {
+    limit_ = limit;
+    update_limit();
   }
 
   /**
-   * @brief 获取所有收集到的错误。
+   * @brief 是否已达到错误上限，此时调用方应尽快停止工作。
+   * @details 只在本收集器报告错误时更新，可以在热路径上廉价地调用；
+   *          其他阶段使报告器达到上限的情况见 `poll_limit`。
+   */
+  [[nodiscard]] bool limit_reached() const noexcept {
+    return limit_reached_;
+  }
+
+  /**
+   * @brief 同时向关联的报告器确认是否已达到错误上限。
+   * @details 报告器由多个阶段共享时，其他阶段的错误也会使它达到上限。
+   *          涉及一次虚函数调用，适合在较粗的粒度（如每个顶层声明）上检查。
+   */
+  [[nodiscard]] bool poll_limit() noexcept {
+    update_limit();
+    return limit_reached_;
+  }
+
+  /**
+   * @brief 关联一个报告器，之后的错误直接写入它。
+   * @param[in] reporter 报告器，为空表示恢复为在本地保存；
+   *            必须比收集器的最后一次 `add` 活得更久。
+   */
+  void set_reporter(diagnostics::IDiagnosticReporter* reporter) noexcept {
+    reporter_ = reporter;
+  }
+
+  [[nodiscard]] diagnostics::IDiagnosticReporter*
+  get_reporter() const noexcept {
+    return reporter_;
+  }
+
+  /**
+   * @brief 获取所有在本地保存的错误。
+   * @details 关联报告器之后添加的错误不会出现在这里。
    * @return 错误列表的常量引用
    */
   const std::vector<ErrorType>& get_errors() const {
@@ -91,14 +166,17 @@ public:
    * @return 如果有错误返回 true，否则返回 false
    */
   bool has_errors() const {
-    return !errors_.empty();
+    return count_ > 0;
   }
 
   /**
    * @brief 清空所有错误。
+   * @details 已经写入报告器的错误不受影响，只重置本收集器的计数。
    */
   void clear() {
     errors_.clear();
+    count_ = 0;
+    limit_reached_ = false;
   }
 
   /**
@@ -106,11 +184,20 @@ public:
    * @return 错误数量
    */
   size_t count() const {
-    return errors_.size();
+    return count_;
   }
 
 private:
   std::vector<ErrorType> errors_; ///< 错误列表
+  size_t count_ = 0;              ///< 报告过的错误数（含写入报告器的）
+  diagnostics::IDiagnosticReporter* reporter_ = nullptr; ///< 关联的报告器
+  size_t limit_ = std::numeric_limits<size_t>::max(); ///< 错误数上限
+  bool limit_reached_ = false; ///< 是否已达到上限
+
+  void update_limit() noexcept {
+    limit_reached_ = count_ >= limit_ ||
+                     (reporter_ != nullptr && reporter_->error_limit_reached());
+  }
 };
 
 } // namespace czc::utils
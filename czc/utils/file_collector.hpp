@@ -8,40 +8,56 @@
 #ifndef CZC_FILE_COLLECTOR_HPP
 #define CZC_FILE_COLLECTOR_HPP
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
 namespace czc::utils {
 
+/**
+ * @brief 文件收集的选项。
+ */
+struct CollectOptions {
+  // 并行遍历目录的线程数，1 表示在调用线程中串行遍历
+  size_t jobs = 1;
+  // 是否按遍历到的 `.gitignore` 排除文件与目录
+  bool use_gitignore = true;
+  // 持久化目录索引的路径，为空时不使用
+  std::string index_path;
+};
+
 /**
  * @brief 提供根据通配符模式查找和收集文件的静态工具方法。
  * @details 此类主要用于命令行接口（CLI），以解析用户输入的文件路径，
- *          这些路径可能包含通配符（如 `*` 和 `?`）。它负责将这些模式
- *          扩展为匹配的具体文件列表。
- * @property {线程安全} 此类仅包含静态方法，不维护状态，因此是线程安全的。
+ *          这些路径可能包含通配符（如 `*`、`?` 以及匹配任意层目录的
+ *          `**`）。它负责将这些模式扩展为匹配的具体文件列表。
+ *
+ *          模式先编译为 `GlobPattern`，开头的字面目录相同的模式共享一次
+ *          遍历，并跳过不可能包含匹配文件的子树。遍历按层进行，同一层的
+ *          目录可以在线程池中并行读取。`.gitignore` 的规则从模式根目录所在
+ *          的 Git 仓库顶层开始生效，`.git` 目录总是被跳过。
+ *
+ *          指定索引文件时，每个目录的条目列表连同目录的修改时间（以及其中
+ *          `.gitignore` 的修改时间与大小）一起保存；再次运行时只有时间戳
+ *          变化了的目录才需要重新读取。
+ * @property {线程安全} 此类仅包含静态方法，不维护状态，因此是线程安全的；
+ *                     但并发使用同一个索引文件时，以最后写入者为准。
  */
 class FileCollector {
 public:
   /**
    * @brief 根据一组文件路径或通配符模式收集所有匹配的文件。
    * @param[in] patterns 一个包含文件路径或模式的字符串向量。模式可以包含 `*`
-   *                     （匹配任意数量的字符）和 `?`（匹配单个字符）。
+   *                     （匹配任意数量的字符）、`?`（匹配单个字符）和 `**`
+   *                     （匹配任意层目录）。
+   * @param[in] options  遍历选项。
    * @return 返回一个包含所有匹配的、按字母顺序排序的文件路径的向量。
-   *         如果模式匹配了重复的文件，结果中可能包含重复项。
-   *         如果没有找到匹配的文件，则返回空向量。
+   *         如果多个根目录不同的模式匹配了同一个文件，结果中可能包含
+   *         重复项。如果没有找到匹配的文件，则返回空向量。
    */
   static std::vector<std::string>
-  collect_files(const std::vector<std::string>& patterns);
-
-private:
-  /**
-   * @brief 将给定的文件名与单个通配符模式进行匹配。
-   * @param[in] filename 要检查的文件名。
-   * @param[in] pattern 包含 `*` 和/或 `?` 的通配符模式。
-   * @return 如果文件名与模式匹配，则返回 `true`，否则返回 `false`。
-   */
-  static bool matches_pattern(const std::string& filename,
-                              const std::string& pattern);
+  collect_files(const std::vector<std::string>& patterns,
+                const CollectOptions& options = {});
 };
 
 } // namespace czc::utils
@@ -0,0 +1,28 @@
+/**
+ * @file file_id.hpp
+ * @brief 定义了源文件编号 `FileId` 及预先登记的编号。
+ * @details 从 `source_manager.hpp` 中分离出来：`SourceLocation` 嵌在几乎
+ *          每个头文件里，只需要编号本身，不必引入登记表的 `<mutex>`、
+ *          `<deque>` 与 `<unordered_map>`。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_FILE_ID_HPP
+#define CZC_UTILS_FILE_ID_HPP
+
+#include <cstdint>
+
+namespace czc::utils {
+
+// 源文件在 `SourceManager` 中的编号。
+using FileId = uint32_t;
+
+// 预先登记的 "<stdin>"，见 `SourceManager::STDIN_FILE`。
+inline constexpr FileId STDIN_FILE_ID = 0;
+// 预先登记的空文件名，见 `SourceManager::UNKNOWN_FILE`。
+inline constexpr FileId UNKNOWN_FILE_ID = 1;
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_FILE_ID_HPP
@@ -0,0 +1,129 @@
+/**
+ * @file glob.hpp
+ * @brief 定义了预编译的通配符匹配器 `GlobSegment` 与 `GlobPattern`。
+ * @details
+ *   模式按 `/` 切分为若干段，每段在构造时预先分析：不含通配符的段直接
+ *   按字符串比较；含通配符的段记下首个通配符之前的字面前缀与最后一个
+ *   通配符之后的字面后缀（通常是扩展名），匹配时先比较二者，不符即可
+ *   立刻排除，只有通过检查的名字才进入完整的回溯匹配。`**` 段匹配零个
+ *   或多个路径段。
+ *
+ *   模式开头不含通配符的若干段构成"根目录"，遍历只需从这里开始。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_GLOB_HPP
+#define CZC_GLOB_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace czc::utils {
+
+/**
+ * @brief 将名字与单个通配符模式匹配，支持 `*` 与 `?`。
+ * @details 经典的单次回溯算法，最坏情况 O(名字长度 × 模式长度)。
+ */
+[[nodiscard]] bool wildcard_match(std::string_view name,
+                                  std::string_view pattern) noexcept;
+
+/**
+ * @brief 判断文本是否包含通配符 `*` 或 `?`。
+ */
+[[nodiscard]] bool has_wildcards(std::string_view text) noexcept;
+
+/**
+ * @brief 预编译的单个路径段模式。
+ * @property {线程安全} 构造后只读，可在多个线程间共享。
+ */
+class GlobSegment {
+public:
+  explicit GlobSegment(std::string text);
+
+  /**
+   * @brief 判断一个路径段（文件名或目录名）是否与本段匹配。
+   */
+  [[nodiscard]] bool matches(std::string_view name) const noexcept;
+
+  /**
+   * @brief 本段是否为匹配任意层目录的 `**`。
+   */
+  [[nodiscard]] bool is_recursive() const noexcept {
+    return recursive;
+  }
+
+  [[nodiscard]] const std::string& get_text() const noexcept {
+    return text;
+  }
+
+private:
+  std::string text;
+  // 不含通配符，按字符串比较
+  bool literal = false;
+  // 整段为 `**`
+  bool recursive = false;
+  // 首个通配符之前与最后一个通配符之后的字面部分的长度
+  size_t prefix_length = 0;
+  size_t suffix_length = 0;
+};
+
+/**
+ * @brief 预编译的路径模式，如 `src/main.?ero` 或含 `**` 段的递归模式。
+ * @details 匹配时使用相对于 `get_root()` 的路径段。
+ * @property {线程安全} 构造后只读，可在多个线程间共享。
+ */
+class GlobPattern {
+public:
+  /**
+   * @brief 编译一个模式。
+   * @param[in] pattern 以 `/` 分隔的模式；开头不含通配符的段并入根目录。
+   */
+  explicit GlobPattern(std::string_view pattern);
+
+  /**
+   * @brief 由已切分好的段构造一个没有根目录的模式（供 `.gitignore` 使用）。
+   */
+  explicit GlobPattern(std::vector<GlobSegment> segments);
+
+  /**
+   * @brief 模式开头的字面目录；没有时为空字符串。
+   */
+  [[nodiscard]] const std::string& get_root() const noexcept {
+    return root;
+  }
+
+  [[nodiscard]] const std::vector<GlobSegment>& get_segments() const noexcept {
+    return segments;
+  }
+
+  /**
+   * @brief 判断相对于根目录的路径是否与模式完整匹配。
+   */
+  [[nodiscard]] bool
+  matches(const std::vector<std::string_view>& path) const noexcept;
+
+  /**
+   * @brief 判断相对于根目录的目录之下是否可能存在匹配的文件。
+   * @details 遍历据此跳过不可能匹配的子树。
+   */
+  [[nodiscard]] bool
+  may_contain(const std::vector<std::string_view>& directory) const noexcept;
+
+private:
+  [[nodiscard]] bool match_from(size_t segment_index,
+                                const std::vector<std::string_view>& path,
+                                size_t path_index) const noexcept;
+  [[nodiscard]] bool
+  may_contain_from(size_t segment_index,
+                   const std::vector<std::string_view>& directory,
+                   size_t path_index) const noexcept;
+
+  std::string root;
+  std::vector<GlobSegment> segments;
+};
+
+} // namespace czc::utils
+
+#endif // CZC_GLOB_HPP
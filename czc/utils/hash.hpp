@@ -0,0 +1,47 @@
+/**
+ * @file hash.hpp
+ * @brief 定义了各模块共用的 64 位哈希工具。
+ * @details
+ *   磁盘缓存的键（`cst::CSTCache`、`formatter::FormatCache`）与 CST 的结构
+ *   哈希都要求结果与平台和运行无关，因此不使用 `std::hash`，统一采用
+ *   FNV-1a 与 `hash_combine`。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_HASH_HPP
+#define CZC_UTILS_HASH_HPP
+
+#include <cstdint>
+#include <string_view>
+
+namespace czc::utils {
+
+inline constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+inline constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+/**
+ * @brief 计算 `text` 的 64 位 FNV-1a 哈希。
+ * @param[in] hash 初始值，可传入上一段文本的结果以连续哈希。
+ */
+[[nodiscard]] constexpr uint64_t
+fnv1a(std::string_view text, uint64_t hash = FNV_OFFSET_BASIS) noexcept {
+  for (char c : text) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * @brief 把 `value` 混入哈希值 `seed`。
+ */
+[[nodiscard]] constexpr uint64_t hash_combine(uint64_t seed,
+                                              uint64_t value) noexcept {
+  seed ^= value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2);
+  return seed;
+}
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_HASH_HPP
@@ -0,0 +1,161 @@
+/**
+ * @file json.hpp
+ * @brief 定义了用于机器可读输出与 JSON-RPC 的最小 JSON 值类型 `JsonValue`。
+ * @details
+ *   支持 JSON 的全部六种值。对象按插入顺序保存成员，因此序列化结果与
+ *   构造顺序一致、便于比较；按键查找是线性的，适合成员不多的消息。
+ *   解析遵循 RFC 8259，拒绝尾随内容，嵌套深度限制为 `MAX_DEPTH`。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_JSON_HPP
+#define CZC_JSON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace czc::utils {
+
+/**
+ * @brief 一个 JSON 值。
+ * @property {线程安全} 非线程安全；只读访问可以并发。
+ */
+class JsonValue {
+public:
+  enum class Kind : uint8_t { Null, Bool, Number, String, Array, Object };
+
+  using Array = std::vector<JsonValue>;
+  using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+  // 解析时允许的最大嵌套深度
+  static constexpr size_t MAX_DEPTH = 256;
+
+  JsonValue() = default;
+  JsonValue(std::nullptr_t) {}
+  JsonValue(bool value) : kind(Kind::Bool), boolean(value) {}
+  JsonValue(std::string value) : kind(Kind::String), text(std::move(value)) {}
+  JsonValue(std::string_view value) : kind(Kind::String), text(value) {}
+  JsonValue(const char* value) : kind(Kind::String), text(value) {}
+
+  /**
+   * @brief 以任意算术类型（`bool` 除外）构造一个数字。
+   */
+  template <typename T,
+            std::enable_if_t<std::is_arithmetic_v<T> &&
+                                 !std::is_same_v<T, bool>,
+                             int> = 0>
+  JsonValue(T value) : kind(Kind::Number), number(static_cast<double>(value)) {}
+
+  [[nodiscard]] static JsonValue array() {
+    JsonValue value;
+    value.kind = Kind::Array;
+    return value;
+  }
+
+  [[nodiscard]] static JsonValue object() {
+    JsonValue value;
+    value.kind = Kind::Object;
+    return value;
+  }
+
+  /**
+   * @brief 解析一段 JSON 文本。
+   * @return 文本不是合法的 JSON 时返回空。
+   */
+  [[nodiscard]] static std::optional<JsonValue> parse(std::string_view input);
+
+  [[nodiscard]] Kind get_kind() const noexcept {
+    return kind;
+  }
+
+  [[nodiscard]] bool is_null() const noexcept {
+    return kind == Kind::Null;
+  }
+  [[nodiscard]] bool is_bool() const noexcept {
+    return kind == Kind::Bool;
+  }
+  [[nodiscard]] bool is_number() const noexcept {
+    return kind == Kind::Number;
+  }
+  [[nodiscard]] bool is_string() const noexcept {
+    return kind == Kind::String;
+  }
+  [[nodiscard]] bool is_array() const noexcept {
+    return kind == Kind::Array;
+  }
+  [[nodiscard]] bool is_object() const noexcept {
+    return kind == Kind::Object;
+  }
+
+  [[nodiscard]] bool as_bool() const noexcept {
+    return boolean;
+  }
+  [[nodiscard]] double as_number() const noexcept {
+    return number;
+  }
+  [[nodiscard]] const std::string& as_string() const noexcept {
+    return text;
+  }
+  [[nodiscard]] const Array& as_array() const noexcept {
+    return elements;
+  }
+  [[nodiscard]] const Object& as_object() const noexcept {
+    return members;
+  }
+
+  /**
+   * @brief 查找对象的成员。
+   * @return 不是对象或没有该成员时返回空指针。
+   */
+  [[nodiscard]] const JsonValue* find(std::string_view key) const noexcept;
+
+  /**
+   * @brief 设置对象的成员；已有同名成员时覆盖它。
+   * @return 对本对象的引用，便于链式调用。
+   */
+  JsonValue& set(std::string key, JsonValue value);
+
+  /**
+   * @brief 向数组末尾追加一个元素。
+   */
+  void push_back(JsonValue value) {
+    elements.push_back(std::move(value));
+  }
+
+  /**
+   * @brief 把值序列化为紧凑的单行文本，追加到 `out`。
+   */
+  void dump_to(std::string& out) const;
+
+  [[nodiscard]] std::string dump() const {
+    std::string out;
+    dump_to(out);
+    return out;
+  }
+
+private:
+  Kind kind = Kind::Null;
+  bool boolean = false;
+  double number = 0;
+  std::string text;
+  Array elements;
+  Object members;
+};
+
+/**
+ * @brief 把字符串按 JSON 的规则转义并加上引号，追加到 `out`。
+ * @details 输出总是有效的 UTF-8：不构成有效 UTF-8 序列的字节逐个替换为
+ *          U+FFFD（`\\ufffd`）。
+ */
+void append_json_string(std::string& out, std::string_view text);
+
+} // namespace czc::utils
+
+#endif // CZC_JSON_HPP
@@ -0,0 +1,142 @@
+/**
+ * @file mem_report.hpp
+ * @brief 定义了按数据结构统计内存占用的 `MemReport`。
+ * @details
+ *   命令行的 `--mem-report` 在每个文件处理完、各结构仍然存活时测量它们
+ *   占用的字节数（源码缓冲区、行索引、Token 序列、CST 节点及其子节点
+ *   列表、AST、诊断与驻留的字符串），累加到这里，运行结束时打印为表格
+ *   或 JSON。
+ *
+ *   每一项同时记录 `std::vector` 等容器已分配但未使用的容量（slack），
+ *   以及单个文件中该项的最大字节数，后者可用来估算批处理工作线程的
+ *   内存需求。所有字节数都是按容量与 `sizeof` 估算的堆占用，不含分配器
+ *   自身的开销。报告末尾附上 `CapacityEstimate` 修正后的容量预估比例。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_MEM_REPORT_HPP
+#define CZC_UTILS_MEM_REPORT_HPP
+
+#include "czc/utils/json.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace czc::utils {
+
+/**
+ * @brief 被统计内存的数据结构。
+ */
+enum class MemCategory : uint8_t {
+  // 源码缓冲区（内存映射或读入的副本）
+  Source,
+  // `SourceTracker` 的行起始偏移索引
+  LineIndex,
+  // `Lexer::tokenize` 产生的 Token 序列
+  Tokens,
+  // Token 文本中超出 SSO 的堆内存
+  TokenText,
+  // CST 节点本身
+  CSTNodes,
+  // CST 节点的子节点列表
+  CSTChildren,
+  // CST 中 Token 文本的堆内存
+  CSTTokenText,
+  // AST 节点（含 Arena 与登记表）
+  ASTNodes,
+  // `DiagnosticEngine` 保存的诊断
+  Diagnostics,
+  // 驻留表中的字符串
+  InternedStrings
+};
+
+// 数据结构的种类数量。
+inline constexpr size_t MEM_CATEGORY_COUNT = 10;
+
+/**
+ * @brief 一种数据结构的汇总结果。
+ */
+struct MemStats {
+  // 记录过该项的文件数
+  uint64_t files = 0;
+  // 元素总数（节点数、Token 数、行数等）
+  uint64_t count = 0;
+  // 占用的总字节数（含 slack）
+  uint64_t bytes = 0;
+  // 已分配但未使用的容量
+  uint64_t slack_bytes = 0;
+  // 单个文件中的最大字节数
+  uint64_t max_bytes = 0;
+};
+
+/**
+ * @brief 进程级的内存占用汇总。
+ * @property {线程安全} 所有成员函数都是线程安全的。
+ */
+class MemReport {
+public:
+  /**
+   * @brief 打开或关闭统计。
+   */
+  static void set_enabled(bool value) noexcept {
+    enabled.store(value, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static bool is_enabled() noexcept {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 累加一个文件中某个数据结构的占用。
+   * @param[in] count       元素数量。
+   * @param[in] bytes       占用的字节数（含 slack）。
+   * @param[in] slack_bytes 其中已分配但未使用的字节数。
+   */
+  static void add(MemCategory category, uint64_t count, uint64_t bytes,
+                  uint64_t slack_bytes = 0) noexcept;
+
+  /**
+   * @brief 获取一种数据结构的汇总结果。
+   */
+  [[nodiscard]] static MemStats get(MemCategory category) noexcept;
+
+  /**
+   * @brief 清空所有汇总结果（不改变开关）。
+   */
+  static void reset() noexcept;
+
+  /**
+   * @brief 以对齐的表格打印所有记录过的数据结构及合计。
+   */
+  static void print_table(std::ostream& os);
+
+  /**
+   * @brief 以 JSON 对象返回所有数据结构的汇总结果。
+   */
+  [[nodiscard]] static JsonValue to_json();
+
+  /**
+   * @brief 获取数据结构的显示名称。
+   */
+  [[nodiscard]] static const char* category_name(MemCategory category) noexcept;
+
+private:
+  // NOTE: 只作为静态成员使用，静态存储期保证各计数从零开始。
+  struct Slot {
+    std::atomic<uint64_t> files;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> slack_bytes;
+    std::atomic<uint64_t> max_bytes;
+  };
+
+  static inline std::atomic<bool> enabled{false};
+  static inline Slot slots[MEM_CATEGORY_COUNT];
+};
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_MEM_REPORT_HPP
@@ -0,0 +1,115 @@
+/**
+ * @file source_buffer.hpp
+ * @brief 定义了只读的源码缓冲区 `SourceBuffer`。
+ * @details
+ *   较大的常规文件通过内存映射（POSIX 的 `mmap`，Windows 的
+ *   `MapViewOfFile`）直接暴露给 `Lexer` 与 `SourceTracker`，不经过任何
+ *   复制；小文件、管道与标准输入等无法映射的来源则一次性读入自有的字符串。
+ *   两种情况对使用者完全透明，都通过 `view()` 访问。此外还可以用
+ *   `borrow` 包装调用方持有的一段内存，不发生任何复制。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_SOURCE_BUFFER_HPP
+#define CZC_SOURCE_BUFFER_HPP
+
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace czc::utils {
+
+/**
+ * @brief 一份只读的源码内容，可能来自内存映射，也可能来自自有的字符串。
+ * @details 只能移动，不能复制；借用其内容的对象（如以 `SourceBuffer`
+ *          构造的 `Lexer`）必须在它之前销毁。
+ * @property {线程安全} 内容只读，可在多个线程间共享读取。
+ */
+class SourceBuffer {
+public:
+  // 不小于此大小的常规文件才使用内存映射，更小的文件直接读取更快。
+  static constexpr size_t MMAP_THRESHOLD = 64 * 1024;
+
+  /**
+   * @brief 构造一个空缓冲区。
+   */
+  SourceBuffer() = default;
+
+  /**
+   * @brief 以一个字符串的内容构造缓冲区（接管该字符串）。
+   */
+  explicit SourceBuffer(std::string content);
+
+  ~SourceBuffer();
+
+  SourceBuffer(SourceBuffer&& other) noexcept;
+  SourceBuffer& operator=(SourceBuffer&& other) noexcept;
+  SourceBuffer(const SourceBuffer&) = delete;
+  SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+  /**
+   * @brief 打开一个文件。
+   * @details 不小于 `MMAP_THRESHOLD` 的常规文件以只读方式映射；映射失败、
+   *          小文件以及管道等非常规文件退回为一次性读取。
+   * @param[in] path 文件路径。
+   * @return 成功时返回缓冲区；文件无法打开时返回空。
+   */
+  [[nodiscard]] static std::optional<SourceBuffer>
+  open(const std::string& path);
+
+  /**
+   * @brief 借用调用方持有的一段内存，不复制也不接管。
+   * @param[in] text 源码内容，必须比缓冲区以及借用它的对象活得更久。
+   */
+  [[nodiscard]] static SourceBuffer borrow(std::string_view text) noexcept;
+
+  /**
+   * @brief 把一个输入流（如标准输入）剩余的全部内容读入缓冲区。
+   */
+  [[nodiscard]] static SourceBuffer read_stream(std::istream& stream);
+
+  [[nodiscard]] std::string_view view() const noexcept {
+    return std::string_view(data, length);
+  }
+
+  [[nodiscard]] size_t size() const noexcept {
+    return length;
+  }
+
+  /**
+   * @brief 内容是否来自内存映射。
+   */
+  [[nodiscard]] bool is_mapped() const noexcept {
+    return mapping != nullptr;
+  }
+
+  /**
+   * @brief 把映射的内容提前读入内存。
+   * @details 映射的页面在首次访问时才从磁盘（或网络文件系统）读入，缺页
+   *          会发生在词法分析的途中。预读线程调用此函数依次访问每个页面，
+   *          读取的等待由它承担，之后的分析不再因 I/O 停顿。内容不是映射
+   *          来的时候什么也不做。
+   */
+  void prefetch() const noexcept;
+
+private:
+  /**
+   * @brief 解除映射并清空内容。
+   */
+  void reset() noexcept;
+
+  // 内容的起始地址：映射区域、`storage` 的数据或借用的内存
+  const char* data = nullptr;
+  size_t length = 0;
+  // 映射区域的起始地址，为空表示内容在 `storage` 中或是借用的
+  void* mapping = nullptr;
+  // 未映射时的自有内容
+  std::string storage;
+};
+
+} // namespace czc::utils
+
+#endif // CZC_SOURCE_BUFFER_HPP
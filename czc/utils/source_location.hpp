@@ -8,35 +8,67 @@
 #ifndef CZC_SOURCE_LOCATION_HPP
 #define CZC_SOURCE_LOCATION_HPP
 
-#include <string>
+#include "czc/utils/file_id.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 namespace czc::utils {
 
 /**
  * @brief 代表源代码中的一个特定区域（或点）。
  * @details 此结构体用于精确定位 Token、AST 节点或诊断信息在源文件中的位置。
- *          它包含了文件名、起始和结束的行号与列号，是实现精确错误报告和
+ *          它包含了文件编号、起始和结束的行号与列号，是实现精确错误报告和
  *          源代码交互（如 IDE 高亮）的基础。
- * @property {数据成员} 所有成员均为公开的 `size_t` 或 `std::string`，
+ *
+ *          文件名登记在 `SourceManager` 中，这里只保存 32 位的 `FileId`，
+ *          行列号也以 32 位存储，整个结构体为 20 字节且不涉及堆分配，
+ *          可以廉价地嵌入每个节点并随错误复制。
+ * @property {数据成员} 所有成员均为公开的 32 位整数，
  *           这是一个纯数据结构 (Plain Old Data, POD-like)。
  */
 struct SourceLocation {
-  // 关联的源文件名
-  std::string filename;
+  // 关联的源文件在 `SourceManager` 中的编号
+  FileId file_id;
   // 区域开始的行号（从 1 开始计数）
-  size_t line;
+  uint32_t line;
   // 区域开始的列号（从 1 开始计数）
-  size_t column;
+  uint32_t column;
   // 区域结束的行号（从 1 开始计数）
-  size_t end_line;
+  uint32_t end_line;
   // 区域结束的列号（从 1 开始计数）
-  size_t end_column;
+  uint32_t end_column;
+
+  /**
+   * @brief 构造一个指向 "<stdin>" 第 1 行第 1 列的位置。
+   */
+  SourceLocation() noexcept
+      : file_id(STDIN_FILE_ID), line(1), column(1), end_line(1),
+        end_column(1) {}
+
+  /**
+   * @brief 以已登记的文件编号构造一个新的 SourceLocation 对象。
+   * @details 解析器等热路径预先登记文件名，之后每个位置都不再查表。
+   *          如果结束行号或列号未提供（或为0），它们将自动设置为与起始
+   *          位置相同，从而创建一个表示单个点的 SourceLocation。
+   *
+   * @param[in] file     文件编号。
+   * @param[in] ln       起始行号（1-based）。
+   * @param[in] col      起始列号（1-based）。
+   * @param[in] end_ln   结束行号（1-based），若为0则等于 `ln`。
+   * @param[in] end_col  结束列号（1-based），若为0则等于 `col`。
+   */
+  SourceLocation(FileId file, size_t ln, size_t col = 1, size_t end_ln = 0,
+                 size_t end_col = 0) noexcept
+      : file_id(file), line(static_cast<uint32_t>(ln)),
+        column(static_cast<uint32_t>(col)),
+        end_line(static_cast<uint32_t>(end_ln ? end_ln : ln)),
+        end_column(static_cast<uint32_t>(end_col ? end_col : col)) {}
 
   /**
    * @brief 构造一个新的 SourceLocation 对象。
-   * @details
-   * 如果结束行号或列号未提供（或为0），它们将自动设置为与起始位置相同，
-   *          从而创建一个表示单个点的 SourceLocation。
+   * @details 文件名会登记到 `SourceManager`；参数含义同上。
    *
    * @param[in] file     文件名。
    * @param[in] ln       起始行号（1-based）。
@@ -51,10 +83,13 @@ struct SourceLocation {
    *   // 创建跨越范围的 SourceLocation
    *   SourceLocation range("file.cpp", 10, 5, 10, 15);
    */
-  SourceLocation(const std::string& file = "<stdin>", size_t ln = 1,
-                 size_t col = 1, size_t end_ln = 0, size_t end_col = 0)
-      : filename(file), line(ln), column(col), end_line(end_ln ? end_ln : ln),
-        end_column(end_col ? end_col : col) {}
+  SourceLocation(std::string_view file, size_t ln = 1, size_t col = 1,
+                 size_t end_ln = 0, size_t end_col = 0);
+
+  /**
+   * @brief 获取关联的源文件名。
+   */
+  [[nodiscard]] std::string_view get_filename() const;
 };
 
 } // namespace czc::utils
@@ -0,0 +1,78 @@
+/**
+ * @file source_manager.hpp
+ * @brief 定义了源文件名登记表 `SourceManager` 与文件编号 `FileId`。
+ * @details
+ *   `SourceLocation` 嵌在每个 CST / AST 节点与每条错误中，若各自持有一份
+ *   `std::string` 文件名，路径超过 SSO 长度时每个节点都要一次堆分配。
+ *   因此文件名统一登记在进程级的 `SourceManager` 中，位置只记录 32 位的
+ *   `FileId`，需要输出时再查回文件名。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_SOURCE_MANAGER_HPP
+#define CZC_UTILS_SOURCE_MANAGER_HPP
+
+#include "czc/utils/file_id.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace czc::utils {
+
+/**
+ * @brief 只增不减的文件名登记表。
+ * @details 同一个文件名总是得到同一个编号；文件名在进程结束前不会被释放，
+ *          `get_filename` 返回的视图因此一直有效。编号 `STDIN_FILE` 与
+ *          `UNKNOWN_FILE` 预先登记，构造这两种位置时无需加锁。
+ * @property {线程安全} 所有成员函数都是线程安全的。
+ */
+class SourceManager {
+public:
+  // 预先登记的 "<stdin>"，默认构造的位置使用它。
+  static constexpr FileId STDIN_FILE = STDIN_FILE_ID;
+  // 预先登记的空文件名，用于暂不知道所属文件的位置。
+  static constexpr FileId UNKNOWN_FILE = UNKNOWN_FILE_ID;
+
+  SourceManager(const SourceManager&) = delete;
+  SourceManager& operator=(const SourceManager&) = delete;
+
+  /**
+   * @brief 获取进程级的登记表。
+   */
+  [[nodiscard]] static SourceManager& instance();
+
+  /**
+   * @brief 登记一个文件名。
+   * @param[in] filename 文件名，调用返回后不再引用。
+   * @return 文件编号；相同的文件名总是得到相同的编号。
+   */
+  [[nodiscard]] FileId add_file(std::string_view filename);
+
+  /**
+   * @brief 获取编号对应的文件名。
+   * @return 文件名；编号未登记时返回空视图。
+   */
+  [[nodiscard]] std::string_view get_filename(FileId id) const;
+
+  /**
+   * @brief 获取已登记的文件名数量（含预先登记的两项）。
+   */
+  [[nodiscard]] size_t size() const;
+
+private:
+  SourceManager();
+
+  mutable std::mutex mutex;
+  // NOTE: `std::deque` 追加时不移动已有元素，索引中的视图始终有效。
+  std::deque<std::string> filenames;
+  std::unordered_map<std::string_view, FileId> index;
+};
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_SOURCE_MANAGER_HPP
@@ -8,13 +8,46 @@
 #ifndef CZC_SOURCE_TRACKER_HPP
 #define CZC_SOURCE_TRACKER_HPP
 
+#include "czc/utils/source_buffer.hpp"
 #include "czc/utils/source_location.hpp"
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace czc::utils {
 
+/**
+ * @brief 由字节偏移换算得到的行号与列号（均从 1 开始）。
+ */
+struct LineColumn {
+  size_t line;
+  size_t column;
+};
+
+/**
+ * @brief 批量换算得到的位置，见 `SourceTracker::resolve_offsets`。
+ */
+struct ResolvedOffset {
+  // 行号（从 1 开始）
+  size_t line;
+  // 按字节计数的列号（从 1 开始），与 `LineColumn` 一致
+  size_t column;
+  // 按 UTF-8 字符计数的列号（从 1 开始），用于在终端中对齐高亮标记
+  size_t char_column;
+  // 所在行的文本（不含换行符），在 SourceTracker 存活期间有效
+  std::string_view line_text;
+};
+
+/**
+ * @brief 统计 `text` 中的 UTF-8 字符数，即不是续字节（10xxxxxx）的字节数。
+ * @details 每次读入 8 个字节，在一个 64 位整数内同时判断全部字节
+ *          （SWAR），不依赖任何平台的 SIMD 指令集。非法的 UTF-8 序列同样
+ *          按上述规则计数，不会越界。
+ */
+[[nodiscard]] size_t count_utf8_chars(std::string_view text) noexcept;
+
 /**
  * @brief 管理源代码文本并精确跟踪当前的扫描位置。
  * @details
@@ -36,8 +69,14 @@ class SourceTracker {
 private:
   // 正在处理的源文件的名称，用于生成 `SourceLocation`
   std::string filename;
-  // 源文件的完整内容，存储为字符向量以便高效索引
-  std::vector<char> input;
+  // 源文件名在 `SourceManager` 中的编号
+  FileId file_id;
+  // 共享持有的源码；借用 `SourceBuffer` 时为空。
+  // NOTE: 放在堆上以引用计数共享，复制或移动跟踪器时 `input` 仍然有效，
+  //       `TokenSpanList` 等下游对象也可以直接共享它而无需再复制一份。
+  std::shared_ptr<const SourceBuffer> owned;
+  // 源文件的完整内容：指向 `owned` 或所借用的 `SourceBuffer`
+  std::string_view input;
   // 当前在 `input` 向量中的字节索引，范围: [0, input.size()]
   size_t position;
   // 当前位置对应的行号（从 1 开始计数）
@@ -45,32 +84,31 @@ private:
   // 当前位置在当前行中的列号（从 1 开始计数）
   size_t column;
 
-  // --- 性能优化: 行索引缓存 ---
-  // NOTE(BegoniaHe): 为了优化 `get_source_line`
-  // 的性能，我们使用惰性初始化的行索引表。 line_offsets[i] 存储第 i+1
-  // 行的起始字节位置（行号从 1 开始）。 例如: line_offsets[0] = 0 (第 1
-  // 行从字节 0 开始)
+  // --- 性能优化: 行索引 ---
+  // NOTE(BegoniaHe): line_offsets[i] 存储第 i+1 行的起始字节位置（行号从 1
+  // 开始）。 例如: line_offsets[0] = 0 (第 1 行从字节 0 开始)
   //      line_offsets[1] = 15 (第 2 行从字节 15 开始，假设第 1 行有 14 个字符 +
   //      '\n')
-  // 使用 mutable 允许在 const 方法中构建索引（惰性初始化）。
+  // 索引在 `advance` / `advance_bytes` 向前扫描时顺带记录，词法分析结束后
+  // 即已完整，无需再次扫描输入。只有在扫描尚未到达的位置被查询时，
+  // 才会惰性地补齐剩余部分。使用 mutable 允许在 const 方法中补齐索引。
   mutable std::vector<size_t> line_offsets;
-  mutable bool line_offsets_built = false;
+  // `line_offsets` 已覆盖的输入范围: [0, indexed_until)
+  mutable size_t indexed_until = 0;
 
   /**
-   * @brief 惰性构建行起始位置索引表。
-   * @details 此方法在首次调用 `get_source_line` 时执行。它遍历整个输入一次，
-   *          记录每一行的起始字节位置。后续的 `get_source_line` 调用将直接使用
-   *          这个索引表，实现 O(1) 的行查找性能。
+   * @brief 将行索引补齐到至少覆盖 `[0, until)`。
+   * @details 只扫描尚未被 `advance` 覆盖的部分，因此对于已完成词法分析的
+   *          输入，此方法不做任何工作。
    *
    *          复杂度分析:
-   *          - 构建索引: O(n)，其中 n 是源文件的字节数
-   *          - 查找行号: O(1)
-   *          - 总体复杂度（对于 m 个错误）: O(n + m) vs 原先的 O(n × m)
+   *          - 补齐索引: O(until - indexed_until)
+   *          - 查找行号: O(1)；按偏移查找行列号: O(log L)
    *
    * @note 使用 mutable 和 const 标记允许在 const 方法中缓存数据，
    *       这是一种常见的惰性初始化模式。
    */
-  void build_line_offsets() const;
+  void extend_line_offsets(size_t until) const;
 
 public:
   /**
@@ -81,6 +119,29 @@ public:
   SourceTracker(const std::string& source,
                 const std::string& fname = "<stdin>");
 
+  /**
+   * @brief 构造一个接管源码字符串的 SourceTracker，不复制源码。
+   * @param[in] source 要跟踪的源代码字符串，其内容被移入跟踪器。
+   * @param[in] fname  (可选) 源代码的文件名，用于创建 SourceLocation。
+   */
+  SourceTracker(std::string&& source, const std::string& fname = "<stdin>");
+
+  /**
+   * @brief 构造一个与其他对象共享源码缓冲区的 SourceTracker，不复制源码。
+   * @param[in] source 共享的源码缓冲区，不能为空。
+   * @param[in] fname  (可选) 源代码的文件名，用于创建 SourceLocation。
+   */
+  SourceTracker(std::shared_ptr<const SourceBuffer> source,
+                const std::string& fname = "<stdin>");
+
+  /**
+   * @brief 构造一个借用 `SourceBuffer` 内容的 SourceTracker，不复制源码。
+   * @param[in] source 源码缓冲区，必须比本对象活得更久。
+   * @param[in] fname  (可选) 源代码的文件名，用于创建 SourceLocation。
+   */
+  SourceTracker(const SourceBuffer& source,
+                const std::string& fname = "<stdin>");
+
   /**
    * @brief 向前移动一个字符，并根据字符内容更新行号和列号。
    * @details 这是推进词法分析器状态的核心方法。
@@ -88,6 +149,26 @@ public:
    */
   void advance(char c);
 
+  /**
+   * @brief 一次性向前移动 `count` 个字节，并批量更新行号和列号。
+   * @details 等价于对区间内的每个字节依次调用 `advance`，但只统计区间内的
+   *          换行符数量和最后一个换行符的位置，适用于批量扫描内核跳过的
+   *          空白串、标识符和注释。
+   * @param[in] count 要消耗的字节数，超出输入末尾的部分会被截断。
+   */
+  void advance_bytes(size_t count);
+
+  /**
+   * @brief 直接跳转到一个已知行列号的位置。
+   * @details 供增量词法分析从某个旧 Token 的起点恢复扫描。跳过的区间不会
+   *          写入行索引；此后的前进也只有在与已索引范围相接时才会顺带记录，
+   *          其余部分在查询时由 `extend_line_offsets` 惰性补齐。
+   * @param[in] pos        目标字节位置，超出输入末尾时截断。
+   * @param[in] new_line   该位置的行号（从 1 开始）。
+   * @param[in] new_column 该位置的列号（从 1 开始）。
+   */
+  void seek(size_t pos, size_t new_line, size_t new_column);
+
   /**
    * @brief 获取当前在输入中的字节位置。
    * @return 返回当前位置的字节索引。
@@ -120,6 +201,13 @@ public:
     return filename;
   }
 
+  /**
+   * @brief 获取源文件名在 `SourceManager` 中的编号。
+   */
+  [[nodiscard]] FileId get_file_id() const noexcept {
+    return file_id;
+  }
+
   /**
    * @brief 创建一个从指定起始点到当前位置的 SourceLocation。
    * @param[in] start_line 区域的起始行号。
@@ -135,13 +223,82 @@ public:
    */
   std::string get_source_line(size_t line_num) const;
 
+  /**
+   * @brief 获取指定行源代码文本的只读视图（不含换行符，不复制）。
+   * @param[in] line_num 要提取的行号（从 1 开始）。
+   * @return 该行文本的视图，在 SourceTracker 存活期间有效。
+   *         如果行号无效，则返回空视图。
+   */
+  [[nodiscard]] std::string_view get_source_line_view(size_t line_num) const;
+
+  /**
+   * @brief 将字节偏移转换为行号与列号。
+   * @details 在行索引上二分查找，列号与 `advance` 的约定一致，按字节计数。
+   * @param[in] offset 字节偏移，超出输入末尾时按输入末尾处理。
+   * @return 该偏移对应的行号与列号（均从 1 开始）。
+   */
+  [[nodiscard]] LineColumn offset_to_line_column(size_t offset) const;
+
+  /**
+   * @brief 将一批按升序排列的字节偏移一次性换算为位置。
+   * @details
+   *   与逐个调用 `offset_to_line_column` 各做一次二分查找不同，这里沿行
+   *   索引合并遍历：相邻偏移之间只隔几行时逐行前进，相隔很远时才在剩余
+   *   部分二分查找。同一行上的多个偏移接着上一个偏移继续统计 UTF-8 字符，
+   *   每个字节至多统计一次。
+   *
+   *   偏移不是升序时结果依然正确，只是退化为逐个查找。
+   * @param[in]  offsets 字节偏移，超出输入末尾时按输入末尾处理。
+   * @param[out] out     与 `offsets` 一一对应的位置，原有内容被清除。
+   */
+  void resolve_offsets(const std::vector<size_t>& offsets,
+                       std::vector<ResolvedOffset>& out) const;
+
+  /**
+   * @brief 将行号与按字节计数的列号换算为字节偏移。
+   * @details `offset_to_line_column` 的逆运算。
+   * @return 该位置的字节偏移；行号无效时返回输入末尾，列号越过行尾时
+   *         截断到行尾。
+   */
+  [[nodiscard]] size_t line_column_to_offset(size_t line_num,
+                                             size_t column_num) const;
+
+  /**
+   * @brief 获取输入的总行数。
+   * @details 词法分析完成后行索引已完整，此方法为 O(1)。
+   */
+  [[nodiscard]] size_t get_line_count() const {
+    extend_line_offsets(input.size());
+    return line_offsets.size();
+  }
+
+  /**
+   * @brief 获取完整的行索引。
+   * @details 第 i 个元素是第 i+1 行的起始字节偏移。词法分析完成后索引已完整，
+   *          此方法不会再次扫描输入。
+   */
+  [[nodiscard]] const std::vector<size_t>& get_line_offsets() const {
+    extend_line_offsets(input.size());
+    return line_offsets;
+  }
+
   /**
    * @brief 获取对整个输入源文本的只读访问权限。
-   * @return 返回对内部字符向量的常量引用。
+   * @return 返回源文本的视图，在 SourceTracker（及其借用的缓冲区）存活期间有效。
    */
-  [[nodiscard]] const std::vector<char>& get_input() const noexcept {
+  [[nodiscard]] std::string_view get_input() const noexcept {
     return input;
   }
+
+  /**
+   * @brief 获取共享持有的源码缓冲区。
+   * @return 以字符串或共享缓冲区构造时返回该缓冲区；借用 `SourceBuffer`
+   *         时返回空。
+   */
+  [[nodiscard]] const std::shared_ptr<const SourceBuffer>&
+  get_shared_input() const noexcept {
+    return owned;
+  }
 };
 
 } // namespace czc::utils
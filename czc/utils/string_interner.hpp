@@ -0,0 +1,92 @@
+/**
+ * @file string_interner.hpp
+ * @brief 定义了线程安全的字符串驻留表 `StringInterner`。
+ * @details
+ *   同一个驻留表中，内容相同的字符串总是得到同一个 `Symbol`，且只存储
+ *   一份。标识符、成员名、字符串字面量等在一个文件里反复出现的名字驻留后，
+ *   名字比较变成整数比较，节点也不再各自持有 `std::string` 副本。
+ *
+ *   驻留表按字符串哈希分成若干分片，每个分片有自己的互斥锁、索引和存储，
+ *   多个线程（例如多文件并行解析）可以共享同一个驻留表。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_STRING_INTERNER_HPP
+#define CZC_UTILS_STRING_INTERNER_HPP
+
+#include "czc/utils/arena.hpp"
+#include "czc/utils/symbol.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace czc::utils {
+
+/**
+ * @brief 分片加锁的字符串驻留表。
+ * @details
+ *   字符串按哈希值落到 `SHARD_COUNT` 个分片之一，`Symbol` 的低
+ *   `SHARD_BITS` 位记录分片，其余位是分片内的序号，因此查找文本只需
+ *   锁住一个分片。字符串内容存放在分片的 `Arena` 中，地址在驻留表
+ *   析构前保持不变。
+ *
+ * @property {线程安全} 所有成员函数都是线程安全的。
+ */
+class StringInterner {
+public:
+  // 分片编号占用的位数。
+  static constexpr uint32_t SHARD_BITS = 4;
+
+  // 分片数量。
+  static constexpr size_t SHARD_COUNT = size_t{1} << SHARD_BITS;
+
+  StringInterner() = default;
+
+  StringInterner(const StringInterner&) = delete;
+  StringInterner& operator=(const StringInterner&) = delete;
+
+  /**
+   * @brief 驻留一个字符串。
+   * @param[in] text 字符串内容，调用返回后不再引用。
+   * @return 驻留后的句柄及文本；内容相同的字符串总是得到相同的句柄。
+   */
+  [[nodiscard]] InternedString intern(std::string_view text);
+
+  /**
+   * @brief 获取句柄对应的文本。
+   * @param[in] symbol 由本驻留表产生的句柄。
+   * @return 驻留的文本；句柄无效或不属于本驻留表时返回空视图。
+   */
+  [[nodiscard]] std::string_view get_string(Symbol symbol) const;
+
+  /**
+   * @brief 获取已驻留的不同字符串数量。
+   */
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @brief 估算驻留表占用的字节数。
+   * @details 包括字符串内容、句柄表与哈希索引（按桶数与元素数估算）。
+   */
+  [[nodiscard]] size_t get_memory_bytes() const;
+
+private:
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<std::string_view, uint32_t> index;
+    std::vector<std::string_view> strings;
+    Arena storage{4 * 1024};
+  };
+
+  std::array<Shard, SHARD_COUNT> shards;
+};
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_STRING_INTERNER_HPP
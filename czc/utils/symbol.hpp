@@ -0,0 +1,111 @@
+/**
+ * @file symbol.hpp
+ * @brief 定义了驻留字符串的 32 位句柄 `Symbol` 与 `InternedString`。
+ * @details 句柄由 `StringInterner` 产生（见 string_interner.hpp）。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_SYMBOL_HPP
+#define CZC_UTILS_SYMBOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string_view>
+
+namespace czc::utils {
+
+/**
+ * @brief 驻留字符串的 32 位句柄。
+ * @details 只在产生它的 `StringInterner` 内有意义；默认构造的句柄无效。
+ */
+class Symbol {
+public:
+  // 无效句柄的编号。
+  static constexpr uint32_t INVALID_ID = std::numeric_limits<uint32_t>::max();
+
+  constexpr Symbol() noexcept = default;
+
+  constexpr explicit Symbol(uint32_t id) noexcept : id(id) {}
+
+  /**
+   * @brief 获取句柄的编号。
+   */
+  [[nodiscard]] constexpr uint32_t get_id() const noexcept {
+    return id;
+  }
+
+  /**
+   * @brief 句柄是否有效。
+   */
+  [[nodiscard]] constexpr bool is_valid() const noexcept {
+    return id != INVALID_ID;
+  }
+
+  constexpr bool operator==(Symbol other) const noexcept {
+    return id == other.id;
+  }
+
+  constexpr bool operator!=(Symbol other) const noexcept {
+    return id != other.id;
+  }
+
+  constexpr bool operator<(Symbol other) const noexcept {
+    return id < other.id;
+  }
+
+private:
+  uint32_t id{INVALID_ID};
+};
+
+/**
+ * @brief 驻留后的字符串：句柄及其在驻留表中的文本。
+ * @details
+ *   文本视图指向驻留表的存储，在驻留表存活期间有效。来自同一驻留表的
+ *   两个值按句柄比较；默认构造的值为空文本、无效句柄。
+ */
+class InternedString {
+public:
+  InternedString() noexcept = default;
+
+  InternedString(Symbol symbol, std::string_view text) noexcept
+      : text(text), symbol(symbol) {}
+
+  /**
+   * @brief 获取句柄。
+   */
+  [[nodiscard]] Symbol get_symbol() const noexcept {
+    return symbol;
+  }
+
+  /**
+   * @brief 获取文本。
+   */
+  [[nodiscard]] std::string_view get_view() const noexcept {
+    return text;
+  }
+
+  bool operator==(const InternedString& other) const noexcept {
+    return symbol == other.symbol;
+  }
+
+  bool operator!=(const InternedString& other) const noexcept {
+    return symbol != other.symbol;
+  }
+
+private:
+  std::string_view text;
+  Symbol symbol;
+};
+
+} // namespace czc::utils
+
+template <> struct std::hash<czc::utils::Symbol> {
+  size_t operator()(czc::utils::Symbol symbol) const noexcept {
+    return std::hash<uint32_t>()(symbol.get_id());
+  }
+};
+
+#endif // CZC_UTILS_SYMBOL_HPP
@@ -0,0 +1,107 @@
+/**
+ * @file thread_pool.hpp
+ * @brief 定义了固定大小的线程池 `ThreadPool`。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_THREAD_POOL_HPP
+#define CZC_UTILS_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace czc::utils {
+
+/**
+ * @brief 固定数量工作线程的任务队列。
+ * @details
+ *   任务按提交顺序进入一个共享队列，由空闲的工作线程依次取出执行。
+ *   `submit` 返回 `std::future`，调用方通过它等待结果；任务中抛出的
+ *   异常会在 `future::get()` 时重新抛出。析构时会执行完队列中剩余的
+ *   任务后再回收线程。
+ *
+ * @property {线程安全} `submit` 可以从任意线程并发调用。
+ */
+class ThreadPool {
+private:
+  // 工作线程。
+  std::vector<std::thread> workers;
+
+  // 待执行的任务队列。
+  std::queue<std::function<void()>> tasks;
+
+  // 保护 `tasks` 与 `stopping`。
+  std::mutex mutex;
+
+  // 有新任务或需要停止时通知工作线程。
+  std::condition_variable condition;
+
+  // 析构开始后置为 true，不再接受新任务。
+  bool stopping{false};
+
+  /**
+   * @brief 工作线程的主循环：取出任务并执行，直到线程池停止且队列为空。
+   */
+  void worker_loop();
+
+public:
+  /**
+   * @brief 创建线程池并启动工作线程。
+   * @param[in] thread_count 工作线程数量；为 0 时使用 `default_thread_count()`。
+   */
+  explicit ThreadPool(size_t thread_count = 0);
+
+  /**
+   * @brief 执行完剩余任务后回收所有工作线程。
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief 获取工作线程数量。
+   */
+  [[nodiscard]] size_t size() const noexcept {
+    return workers.size();
+  }
+
+  /**
+   * @brief 返回默认的工作线程数量（硬件并发数，至少为 1）。
+   */
+  [[nodiscard]] static size_t default_thread_count() noexcept;
+
+  /**
+   * @brief 提交一个任务。
+   * @param[in] task 无参可调用对象。
+   * @return 用于获取任务结果的 future。
+   */
+  template <typename F>
+  auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+
+    // NOTE: std::function 要求可拷贝，而 packaged_task 只能移动，
+    //       因此借助 shared_ptr 包装后再放入队列。
+    auto packaged =
+        std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> result = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    condition.notify_one();
+    return result;
+  }
+};
+
+} // namespace czc::utils
+
+#endif // CZC_UTILS_THREAD_POOL_HPP
@@ -0,0 +1,332 @@
+/**
+ * @file time_report.hpp
+ * @brief 定义了按编译阶段统计耗时与计数的 `TimeReport` 及计时器。
+ * @details
+ *   `Lexer::tokenize`、`TokenPreprocessor::process`、`Parser::parse`、
+ *   `ASTBuilder::build` 与 `Formatter::format` 各自用 `CZC_TIME_PHASE`
+ *   打开一个作用域计时器，并用 `CZC_COUNT` 记录 Token、CST 节点、AST
+ *   节点与错误的数量；命令行的 `--time-report` 在运行结束时把汇总结果
+ *   打印为表格或 JSON。
+ *
+ *   统计默认关闭，关闭时每个埋点只有一次原子读取。以
+ *   `CZC_ENABLE_TIME_REPORT=0` 编译（CMake 选项 `CZC_TIME_REPORT=OFF`）
+ *   时两个宏展开为空，埋点完全不产生代码。
+ *
+ *   各阶段的时间是包含式的：流式解析时词法分析在 `Parser::parse` 内部
+ *   按需进行，计入 Parse 阶段。并行处理多个文件时时间为各线程之和。
+ *
+ *   另外可以打开事件追踪：每个阶段计时器以及 `CZC_TRACE_SPAN` 标出的
+ *   区间（如加载语言环境、处理单个文件）都记录为一个带线程与文件名的
+ *   事件，`write_trace` 把它们输出为 Chrome Trace Event JSON，可以直接
+ *   在 Perfetto 或 chrome://tracing 中查看多文件并行时的调度情况。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#ifndef CZC_UTILS_TIME_REPORT_HPP
+#define CZC_UTILS_TIME_REPORT_HPP
+
+#include "czc/utils/json.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+#ifndef CZC_ENABLE_TIME_REPORT
+#define CZC_ENABLE_TIME_REPORT 1
+#endif
+
+namespace czc::utils {
+
+/**
+ * @brief 被统计的编译阶段。
+ */
+enum class Phase : uint8_t { Lex, Preprocess, Parse, BuildAST, Format };
+
+// 阶段的数量。
+inline constexpr size_t PHASE_COUNT = 5;
+
+/**
+ * @brief 各阶段可以累加的计数。
+ */
+enum class Metric : uint8_t { Tokens, CSTNodes, ASTNodes, Errors };
+
+// 计数的种类数量。
+inline constexpr size_t METRIC_COUNT = 4;
+
+/**
+ * @brief 一个阶段的汇总结果。
+ */
+struct PhaseStats {
+  // 阶段被执行的次数
+  uint64_t calls = 0;
+  // 累计耗时（纳秒）
+  uint64_t nanoseconds = 0;
+  // 阶段执行期间的堆分配次数（需要可执行文件调用 `note_allocation`）
+  uint64_t allocations = 0;
+  // 按 `Metric` 下标排列的计数
+  uint64_t metrics[METRIC_COUNT] = {};
+};
+
+/**
+ * @brief 进程级的耗时与计数汇总。
+ * @property {线程安全} 所有成员函数都是线程安全的。
+ */
+class TimeReport {
+public:
+  /**
+   * @brief 打开或关闭统计。
+   */
+  static void set_enabled(bool value) noexcept {
+    set_mode(MODE_STATS, value);
+  }
+
+  [[nodiscard]] static bool is_enabled() noexcept {
+    return (mode.load(std::memory_order_relaxed) & MODE_STATS) != 0;
+  }
+
+  /**
+   * @brief 打开或关闭事件追踪。
+   */
+  static void set_tracing(bool value) noexcept {
+    set_mode(MODE_TRACE, value);
+  }
+
+  [[nodiscard]] static bool is_tracing() noexcept {
+    return (mode.load(std::memory_order_relaxed) & MODE_TRACE) != 0;
+  }
+
+  /**
+   * @brief 统计或追踪是否至少打开了一项。
+   */
+  [[nodiscard]] static bool is_active() noexcept {
+    return mode.load(std::memory_order_relaxed) != 0;
+  }
+
+  /**
+   * @brief 记录一次堆分配。
+   * @details 库本身不替换 `operator new`；需要分配计数的可执行文件在
+   *          自己的 `operator new` 中调用它。
+   */
+  static void note_allocation() noexcept {
+    if (is_enabled()) {
+      allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief 获取进程至今（统计打开期间）的堆分配次数。
+   */
+  [[nodiscard]] static uint64_t get_allocations() noexcept {
+    return allocations.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 累加一个阶段的一次执行。
+   */
+  static void add_call(Phase phase, uint64_t nanoseconds,
+                       uint64_t allocation_count) noexcept;
+
+  /**
+   * @brief 累加一个阶段的计数。
+   */
+  static void add(Phase phase, Metric metric, uint64_t value) noexcept;
+
+  /**
+   * @brief 获取一个阶段的汇总结果。
+   */
+  [[nodiscard]] static PhaseStats get(Phase phase) noexcept;
+
+  /**
+   * @brief 记录一个追踪事件，所属文件取当前线程的文件名。
+   * @param[in] name     事件名，必须是静态存储期的字符串。
+   * @param[in] category 事件分类，必须是静态存储期的字符串。
+   */
+  static void add_trace_event(const char* name, const char* category,
+                              std::chrono::steady_clock::time_point start,
+                              std::chrono::steady_clock::time_point end);
+
+  /**
+   * @brief 设置当前线程正在处理的文件名，之后的事件都标注为该文件。
+   */
+  static void set_thread_file(std::string_view filename);
+
+  /**
+   * @brief 获取当前线程正在处理的文件名。
+   */
+  [[nodiscard]] static std::string_view get_thread_file() noexcept;
+
+  /**
+   * @brief 获取已记录的追踪事件数量。
+   */
+  [[nodiscard]] static size_t trace_event_count();
+
+  /**
+   * @brief 把所有追踪事件输出为 Chrome Trace Event JSON。
+   * @details 每个事件是一个完整事件（`"ph": "X"`），时间以微秒计，
+   *          起点为进程启动；另外为每个线程输出一个线程名元数据事件。
+   */
+  static void write_trace(std::ostream& os);
+
+  /**
+   * @brief 清空所有汇总结果与追踪事件（不改变开关）。
+   */
+  static void reset() noexcept;
+
+  /**
+   * @brief 以对齐的表格打印所有执行过的阶段及合计。
+   */
+  static void print_table(std::ostream& os);
+
+  /**
+   * @brief 以 JSON 对象返回所有阶段的汇总结果。
+   */
+  [[nodiscard]] static JsonValue to_json();
+
+  /**
+   * @brief 获取阶段的显示名称。
+   */
+  [[nodiscard]] static const char* phase_name(Phase phase) noexcept;
+
+private:
+  // NOTE: 只作为静态成员使用，静态存储期保证各计数从零开始。
+  struct PhaseSlot {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> nanoseconds;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> metrics[METRIC_COUNT];
+  };
+
+  static constexpr uint8_t MODE_STATS = 1;
+  static constexpr uint8_t MODE_TRACE = 2;
+
+  static void set_mode(uint8_t bit, bool value) noexcept {
+    if (value) {
+      mode.fetch_or(bit, std::memory_order_relaxed);
+    } else {
+      mode.fetch_and(static_cast<uint8_t>(~bit), std::memory_order_relaxed);
+    }
+  }
+
+  static inline std::atomic<uint8_t> mode{0};
+  static inline std::atomic<uint64_t> allocations{0};
+  static inline PhaseSlot slots[PHASE_COUNT];
+};
+
+/**
+ * @brief 在作用域内为一个阶段计时。
+ * @details 构造时统计与追踪都未打开则什么也不做，析构时同样跳过。
+ */
+class ScopedPhaseTimer {
+public:
+  explicit ScopedPhaseTimer(Phase phase) noexcept
+      : phase(phase), active(TimeReport::is_active()) {
+    if (active) {
+      start_allocations = TimeReport::get_allocations();
+      start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedPhaseTimer() {
+    if (!active) {
+      return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (TimeReport::is_enabled()) {
+      TimeReport::add_call(
+          phase,
+          static_cast<uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                  .count()),
+          TimeReport::get_allocations() - start_allocations);
+    }
+    if (TimeReport::is_tracing()) {
+      TimeReport::add_trace_event(TimeReport::phase_name(phase), "phase",
+                                  start, end);
+    }
+  }
+
+  ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+  ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+  Phase phase;
+  bool active;
+  uint64_t start_allocations = 0;
+  std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief 在作用域内记录一个追踪事件（只在追踪打开时生效）。
+ * @details 给出文件名时，作用域内当前线程的事件都标注为该文件，
+ *          离开作用域后恢复为原来的文件名。
+ */
+class ScopedTraceSpan {
+public:
+  ScopedTraceSpan(const char* name, const char* category,
+                  std::string_view filename = {})
+      : name(name), category(category), active(TimeReport::is_tracing()),
+        sets_file(active && !filename.empty()) {
+    if (!active) {
+      return;
+    }
+    if (sets_file) {
+      previous_file = TimeReport::get_thread_file();
+      TimeReport::set_thread_file(filename);
+    }
+    start = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedTraceSpan() {
+    if (!active) {
+      return;
+    }
+    TimeReport::add_trace_event(name, category, start,
+                                std::chrono::steady_clock::now());
+    if (sets_file) {
+      TimeReport::set_thread_file(previous_file);
+    }
+  }
+
+  ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+  ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+private:
+  const char* name;
+  const char* category;
+  bool active;
+  bool sets_file;
+  // NOTE: 线程的文件名在作用域内被覆盖，这里保存一份副本用于恢复。
+  std::string previous_file;
+  std::chrono::steady_clock::time_point start;
+};
+
+} // namespace czc::utils
+
+#if CZC_ENABLE_TIME_REPORT
+// 为当前作用域计时，计入阶段 `phase`（`czc::utils::Phase` 的枚举值名）。
+#define CZC_TIME_PHASE(phase)                                                  \
+  ::czc::utils::ScopedPhaseTimer czc_phase_timer_(::czc::utils::Phase::phase)
+// 统计打开时为阶段 `phase` 的计数 `metric` 累加 `value`。
+#define CZC_COUNT(phase, metric, value)                                        \
+  do {                                                                         \
+    if (::czc::utils::TimeReport::is_enabled()) {                              \
+      ::czc::utils::TimeReport::add(::czc::utils::Phase::phase,                \
+                                    ::czc::utils::Metric::metric,              \
+                                    static_cast<uint64_t>(value));             \
+    }                                                                          \
+  } while (false)
+// 追踪打开时把当前作用域记录为一个事件。
+#define CZC_TRACE_SPAN(name, category)                                         \
+  ::czc::utils::ScopedTraceSpan czc_trace_span_(name, category)
+#else
+#define CZC_TIME_PHASE(phase) static_cast<void>(0)
+#define CZC_TRACE_SPAN(name, category) static_cast<void>(0)
+#define CZC_COUNT(phase, metric, value) static_cast<void>(0)
+#endif
+
+#endif // CZC_UTILS_TIME_REPORT_HPP
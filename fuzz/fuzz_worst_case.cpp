@@ -0,0 +1,152 @@
+/**
+ * @file fuzz_worst_case.cpp
+ * @brief 寻找让词法分析、解析或格式化变成超线性的输入的 libFuzzer 目标。
+ * @details
+ *   每个输入依次经过 Lexer → TokenPreprocessor → Parser → Formatter，并测量
+ *   整条流水线的开销：Linux 上优先使用用户态指令数（`perf_event_open`），
+ *   不可用时退回到纳秒计时。
+ *
+ *   开销按“每字节开销”的对数分桶写入 libFuzzer 的额外计数器
+ *   （`__libfuzzer_extra_counters` 段），达到新的慢速等级的输入因此被视为
+ *   新覆盖而保留下来，模糊测试会逐步逼近最坏情况。设置环境变量
+ *   `CZC_FUZZ_MAX_COST_PER_BYTE` 后，每字节开销超过该值的输入会直接中止，
+ *   由 libFuzzer 当作崩溃保存；这些输入应加入 `benchmarks/slow_inputs`，
+ *   由 `benchmark_worst_case` 作为回归基准持续运行。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 慢速等级的桶数，第 i 个桶对应每字节开销位于 [2^i, 2^(i+1))。
+constexpr size_t COST_BUCKETS = 64;
+
+#if defined(__linux__)
+// NOTE: libFuzzer 在 Linux 上把该段中的字节当作额外的覆盖计数器。
+__attribute__((used, section("__libfuzzer_extra_counters")))
+uint8_t slowness_counters[COST_BUCKETS];
+
+// 打开当前线程的用户态指令计数器，失败时返回 -1。
+int open_instruction_counter() {
+  perf_event_attr attr{};
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#else
+uint8_t slowness_counters[COST_BUCKETS];
+#endif
+
+/**
+ * @brief 测量一段代码的开销（指令数或纳秒）。
+ */
+class CostMeter {
+public:
+  CostMeter() {
+#if defined(__linux__)
+    counter_fd = open_instruction_counter();
+#endif
+  }
+
+  [[nodiscard]] bool counts_instructions() const noexcept {
+    return counter_fd >= 0;
+  }
+
+  template <typename Fn> uint64_t measure(Fn&& work) {
+#if defined(__linux__)
+    if (counter_fd >= 0) {
+      ioctl(counter_fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(counter_fd, PERF_EVENT_IOC_ENABLE, 0);
+      work();
+      ioctl(counter_fd, PERF_EVENT_IOC_DISABLE, 0);
+      uint64_t instructions = 0;
+      if (read(counter_fd, &instructions, sizeof(instructions)) ==
+          static_cast<ssize_t>(sizeof(instructions))) {
+        return instructions;
+      }
+      return 0;
+    }
+#endif
+    auto start = std::chrono::steady_clock::now();
+    work();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+  }
+
+private:
+  int counter_fd = -1;
+};
+
+size_t floor_log2(uint64_t value) {
+  size_t bucket = 0;
+  while (value > 1 && bucket + 1 < COST_BUCKETS) {
+    value >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void run_pipeline(const std::string& source) {
+  czc::lexer::Lexer lexer(source, "fuzz.zero");
+  auto tokens = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "fuzz.zero", source);
+  czc::parser::Parser parser(tokens, "fuzz.zero");
+  auto cst = parser.parse();
+  if (cst) {
+    czc::formatter::Formatter formatter;
+    (void)formatter.format(cst.get());
+  }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  static CostMeter meter;
+  static const uint64_t max_cost_per_byte = []() -> uint64_t {
+    const char* env = std::getenv("CZC_FUZZ_MAX_COST_PER_BYTE");
+    return env ? std::strtoull(env, nullptr, 10) : 0;
+  }();
+
+  std::string source(reinterpret_cast<const char*>(data), size);
+  uint64_t cost = meter.measure([&]() { run_pipeline(source); });
+  uint64_t cost_per_byte = cost / (size + 1);
+  slowness_counters[floor_log2(cost_per_byte)] = 1;
+
+  if (max_cost_per_byte != 0 && cost_per_byte > max_cost_per_byte) {
+    std::fprintf(stderr,
+                 "czc fuzz: %llu %s per byte exceeds the limit of %llu "
+                 "(input of %zu bytes)\n",
+                 static_cast<unsigned long long>(cost_per_byte),
+                 meter.counts_instructions() ? "instructions" : "ns",
+                 static_cast<unsigned long long>(max_cost_per_byte), size);
+    std::abort();
+  }
+  return 0;
+}
@@ -8,12 +8,16 @@
 #include "czc/ast/ast_builder.hpp"
 
 #include "czc/cst/cst_node.hpp"
+#include "czc/lexer/number_decoder.hpp"
+#include "czc/parser/declaration_sink.hpp"
+#include "czc/utils/time_report.hpp"
 
 #include <stdexcept>
+#include <utility>
 
 namespace czc::ast {
 
-std::shared_ptr<Program> ASTBuilder::build(const cst::CSTNode* cst_root) {
+Program* ASTBuilder::build(const cst::CSTNode* cst_root) {
   if (cst_root == nullptr) {
     throw std::runtime_error("CST root is null");
   }
@@ -22,12 +26,47 @@ std::shared_ptr<Program> ASTBuilder::build(const cst::CSTNode* cst_root) {
     throw std::runtime_error("CST root must be a Program node");
   }
 
-  return build_program(cst_root);
+  CZC_TIME_PHASE(BuildAST);
+  [[maybe_unused]] size_t nodes_before = context.get_node_count();
+  Program* program = build_program(cst_root);
+  CZC_COUNT(BuildAST, ASTNodes, context.get_node_count() - nodes_before);
+  return program;
 }
 
-std::shared_ptr<Program>
-ASTBuilder::build_program(const cst::CSTNode* cst_node) {
-  auto program = std::make_shared<Program>(cst_node->get_location());
+class ASTBuilder::StreamingSink final : public parser::DeclarationSink {
+public:
+  explicit StreamingSink(ASTBuilder& builder) noexcept : builder(builder) {}
+
+  void begin_program(const utils::SourceLocation& location) override {
+    program = builder.context.create<Program>(location);
+  }
+
+  void add_declaration(std::unique_ptr<cst::CSTNode> node) override {
+    // NOTE: 与 build_program 相同，无法转换的顶层节点（如注释）直接丢弃；
+    //       函数返回时 `node` 析构，这个声明的 CST 随之释放。
+    auto decl = builder.build_declaration(node.get());
+    if (decl) {
+      program->add_declaration(decl);
+    }
+  }
+
+  [[nodiscard]] Program* get_program() const noexcept {
+    return program;
+  }
+
+private:
+  ASTBuilder& builder;
+  Program* program{nullptr};
+};
+
+Program* ASTBuilder::build(parser::Parser& parser) {
+  StreamingSink sink(*this);
+  parser.parse(sink);
+  return sink.get_program();
+}
+
+Program* ASTBuilder::build_program(const cst::CSTNode* cst_node) {
+  auto program = context.create<Program>(cst_node->get_location());
 
   // 遍历 CST 的所有顶层子节点，转换为声明
   for (const auto& child : cst_node->get_children()) {
@@ -40,8 +79,7 @@ ASTBuilder::build_program(const cst::CSTNode* cst_node) {
   return program;
 }
 
-std::shared_ptr<Declaration>
-ASTBuilder::build_declaration(const cst::CSTNode* cst_node) {
+Declaration* ASTBuilder::build_declaration(const cst::CSTNode* cst_node) {
   if (cst_node == nullptr) {
     return nullptr;
   }
@@ -62,8 +100,7 @@ ASTBuilder::build_declaration(const cst::CSTNode* cst_node) {
   }
 }
 
-std::shared_ptr<Statement>
-ASTBuilder::build_statement(const cst::CSTNode* cst_node) {
+Statement* ASTBuilder::build_statement(const cst::CSTNode* cst_node) {
   if (cst_node == nullptr) {
     return nullptr;
   }
@@ -87,8 +124,7 @@ ASTBuilder::build_statement(const cst::CSTNode* cst_node) {
   }
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_expression(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_expression(const cst::CSTNode* cst_node) {
   if (cst_node == nullptr) {
     return nullptr;
   }
@@ -127,15 +163,14 @@ ASTBuilder::build_expression(const cst::CSTNode* cst_node) {
   }
 }
 
-std::shared_ptr<Type> ASTBuilder::build_type(const cst::CSTNode* cst_node) {
+Type* ASTBuilder::build_type(const cst::CSTNode* cst_node) {
   // TODO: 实现类型转换
   return nullptr;
 }
 
 // === 具体节点转换实现（骨架） ===
 
-std::shared_ptr<Declaration>
-ASTBuilder::build_var_declaration(const cst::CSTNode* cst_node) {
+Declaration* ASTBuilder::build_var_declaration(const cst::CSTNode* cst_node) {
   // CST 结构：VarDeclaration
   //   - Delimiter (let/var 关键字)
   //   - Identifier (变量名)
@@ -145,9 +180,9 @@ ASTBuilder::build_var_declaration(const cst::CSTNode* cst_node) {
   //   - [Expression (初始化表达式)]
   //   - [Delimiter (分号)]
 
-  std::string var_name;
-  std::shared_ptr<Type> type_annotation = nullptr;
-  std::shared_ptr<Expression> initializer = nullptr;
+  utils::InternedString var_name;
+  Type* type_annotation = nullptr;
+  Expression* initializer = nullptr;
 
   // 遍历子节点提取信息
   for (const auto& child : cst_node->get_children()) {
@@ -156,7 +191,7 @@ ASTBuilder::build_var_declaration(const cst::CSTNode* cst_node) {
       // 变量名
       const auto& token = child->get_token();
       if (token.has_value()) {
-        var_name = token->value;
+        var_name = intern_token(*token);
       }
       break;
     }
@@ -191,11 +226,11 @@ ASTBuilder::build_var_declaration(const cst::CSTNode* cst_node) {
     }
   }
 
-  return std::make_shared<VarDecl>(var_name, type_annotation, initializer,
-                                   cst_node->get_location());
+  return context.create<VarDecl>(var_name, type_annotation, initializer,
+                                 cst_node->get_location());
 }
 
-std::shared_ptr<Declaration>
+Declaration*
 ASTBuilder::build_function_declaration(const cst::CSTNode* cst_node) {
   // CST 结构：FnDeclaration
   //   - Delimiter (fn 关键字)
@@ -213,20 +248,20 @@ ASTBuilder::build_function_declaration(const cst::CSTNode* cst_node) {
   //   - [TypeAnnotation (返回类型)]
   //   - BlockStmt (函数体)
 
-  std::string func_name;
-  std::vector<std::shared_ptr<Parameter>> parameters;
-  std::shared_ptr<Type> return_type = nullptr;
-  std::shared_ptr<BlockStmt> body = nullptr;
+  utils::InternedString func_name;
+  std::vector<Parameter*> parameters;
+  Type* return_type = nullptr;
+  BlockStmt* body = nullptr;
 
   // 遍历子节点提取信息
   for (const auto& child : cst_node->get_children()) {
     switch (child->get_type()) {
     case cst::CSTNodeType::Identifier: {
       // 函数名（第一个 Identifier）
-      if (func_name.empty()) {
+      if (func_name.get_view().empty()) {
         const auto& token = child->get_token();
         if (token.has_value()) {
-          func_name = token->value;
+          func_name = intern_token(*token);
         }
       }
       break;
@@ -255,7 +290,7 @@ ASTBuilder::build_function_declaration(const cst::CSTNode* cst_node) {
     case cst::CSTNodeType::BlockStmt: {
       // 函数体
       auto stmt = build_statement(child.get());
-      body = std::dynamic_pointer_cast<BlockStmt>(stmt);
+      body = dynamic_cast<BlockStmt*>(stmt);
       break;
     }
 
@@ -265,26 +300,26 @@ ASTBuilder::build_function_declaration(const cst::CSTNode* cst_node) {
     }
   }
 
-  return std::make_shared<FunctionDecl>(func_name, parameters, return_type,
-                                        body, cst_node->get_location());
+  return context.create<FunctionDecl>(func_name, std::move(parameters),
+                                      return_type, body,
+                                      cst_node->get_location());
 }
 
-std::shared_ptr<Parameter>
-ASTBuilder::build_parameter(const cst::CSTNode* cst_node) {
+Parameter* ASTBuilder::build_parameter(const cst::CSTNode* cst_node) {
   // CST 结构：Parameter
   //   - Identifier (参数名)
   //   - [Delimiter (冒号)]
   //   - [TypeAnnotation (类型)]
 
-  std::string param_name;
-  std::shared_ptr<Type> param_type = nullptr;
+  utils::InternedString param_name;
+  Type* param_type = nullptr;
 
   for (const auto& child : cst_node->get_children()) {
     switch (child->get_type()) {
     case cst::CSTNodeType::Identifier: {
       const auto& token = child->get_token();
       if (token.has_value()) {
-        param_name = token->value;
+        param_name = intern_token(*token);
       }
       break;
     }
@@ -300,11 +335,11 @@ ASTBuilder::build_parameter(const cst::CSTNode* cst_node) {
     }
   }
 
-  return std::make_shared<Parameter>(param_name, param_type,
-                                     cst_node->get_location());
+  return context.create<Parameter>(param_name, param_type,
+                                   cst_node->get_location());
 }
 
-std::shared_ptr<Declaration>
+Declaration*
 ASTBuilder::build_struct_declaration(const cst::CSTNode* cst_node) {
   // CST 结构：StructDeclaration
   //   - Delimiter (struct 关键字)
@@ -320,18 +355,18 @@ ASTBuilder::build_struct_declaration(const cst::CSTNode* cst_node) {
   //   - Delimiter (右大括号)
   //   - [Delimiter (分号)]
 
-  std::string struct_name;
-  std::vector<std::shared_ptr<StructField>> fields;
+  utils::InternedString struct_name;
+  std::vector<StructField*> fields;
 
   // 遍历子节点提取信息
   for (const auto& child : cst_node->get_children()) {
     switch (child->get_type()) {
     case cst::CSTNodeType::Identifier: {
       // 结构体名（第一个 Identifier）
-      if (struct_name.empty()) {
+      if (struct_name.get_view().empty()) {
         const auto& token = child->get_token();
         if (token.has_value()) {
-          struct_name = token->value;
+          struct_name = intern_token(*token);
         }
       }
       break;
@@ -352,29 +387,28 @@ ASTBuilder::build_struct_declaration(const cst::CSTNode* cst_node) {
     }
   }
 
-  return std::make_shared<StructDecl>(struct_name, fields,
-                                      cst_node->get_location());
+  return context.create<StructDecl>(struct_name, std::move(fields),
+                                    cst_node->get_location());
 }
 
-std::shared_ptr<StructField>
-ASTBuilder::build_struct_field(const cst::CSTNode* cst_node) {
+StructField* ASTBuilder::build_struct_field(const cst::CSTNode* cst_node) {
   // CST 结构：StructField
   //   - Identifier (字段名)
   //   - Delimiter (冒号)
   //   - TypeAnnotation (字段类型)
 
-  std::string field_name;
-  std::shared_ptr<Type> field_type = nullptr;
+  utils::InternedString field_name;
+  Type* field_type = nullptr;
 
   // 遍历子节点提取信息
   for (const auto& child : cst_node->get_children()) {
     switch (child->get_type()) {
     case cst::CSTNodeType::Identifier: {
       // 字段名
-      if (field_name.empty()) {
+      if (field_name.get_view().empty()) {
         const auto& token = child->get_token();
         if (token.has_value()) {
-          field_name = token->value;
+          field_name = intern_token(*token);
         }
       }
       break;
@@ -392,13 +426,12 @@ ASTBuilder::build_struct_field(const cst::CSTNode* cst_node) {
     }
   }
 
-  return std::make_shared<StructField>(field_name, field_type,
-                                       cst_node->get_location());
+  return context.create<StructField>(field_name, field_type,
+                                     cst_node->get_location());
 }
 
-std::shared_ptr<Statement>
-ASTBuilder::build_block_statement(const cst::CSTNode* cst_node) {
-  auto block = std::make_shared<BlockStmt>(cst_node->get_location());
+Statement* ASTBuilder::build_block_statement(const cst::CSTNode* cst_node) {
+  auto block = context.create<BlockStmt>(cst_node->get_location());
 
   // CST 结构：BlockStmt
   //   - Delimiter (左大括号)
@@ -430,13 +463,12 @@ ASTBuilder::build_block_statement(const cst::CSTNode* cst_node) {
   return block;
 }
 
-std::shared_ptr<Statement>
-ASTBuilder::build_expr_statement(const cst::CSTNode* cst_node) {
+Statement* ASTBuilder::build_expr_statement(const cst::CSTNode* cst_node) {
   // CST 结构：ExprStmt
   //   - Expression
   //   - [Delimiter (分号)]
 
-  std::shared_ptr<Expression> expr = nullptr;
+  Expression* expr = nullptr;
 
   // 遍历子节点，查找表达式
   for (const auto& child : cst_node->get_children()) {
@@ -451,17 +483,16 @@ ASTBuilder::build_expr_statement(const cst::CSTNode* cst_node) {
     return nullptr;
   }
 
-  return std::make_shared<ExprStmt>(expr, cst_node->get_location());
+  return context.create<ExprStmt>(expr, cst_node->get_location());
 }
 
-std::shared_ptr<Statement>
-ASTBuilder::build_return_statement(const cst::CSTNode* cst_node) {
+Statement* ASTBuilder::build_return_statement(const cst::CSTNode* cst_node) {
   // CST 结构：ReturnStmt
   //   - Delimiter (return 关键字)
   //   - [Expression (返回值)]
   //   - [Delimiter (分号)]
 
-  std::shared_ptr<Expression> return_value = nullptr;
+  Expression* return_value = nullptr;
 
   // 遍历子节点，查找返回值表达式
   for (const auto& child : cst_node->get_children()) {
@@ -473,11 +504,10 @@ ASTBuilder::build_return_statement(const cst::CSTNode* cst_node) {
   }
 
   // 返回值可以为空（void 返回）
-  return std::make_shared<ReturnStmt>(return_value, cst_node->get_location());
+  return context.create<ReturnStmt>(return_value, cst_node->get_location());
 }
 
-std::shared_ptr<Statement>
-ASTBuilder::build_if_statement(const cst::CSTNode* cst_node) {
+Statement* ASTBuilder::build_if_statement(const cst::CSTNode* cst_node) {
   // CST 结构：IfStmt
   //   - Delimiter (if 关键字)
   //   - Expression (条件)
@@ -485,9 +515,9 @@ ASTBuilder::build_if_statement(const cst::CSTNode* cst_node) {
   //   - [Delimiter (else 关键字)]
   //   - [BlockStmt/IfStmt (else 分支)]
 
-  std::shared_ptr<Expression> condition = nullptr;
-  std::shared_ptr<Statement> then_branch = nullptr;
-  std::shared_ptr<Statement> else_branch = nullptr;
+  Expression* condition = nullptr;
+  Statement* then_branch = nullptr;
+  Statement* else_branch = nullptr;
 
   bool found_else = false;
 
@@ -523,20 +553,19 @@ ASTBuilder::build_if_statement(const cst::CSTNode* cst_node) {
     return nullptr;
   }
 
-  return std::make_shared<IfStmt>(condition, then_branch, else_branch,
-                                  cst_node->get_location());
+  return context.create<IfStmt>(condition, then_branch, else_branch,
+                                cst_node->get_location());
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_binary_expr(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_binary_expr(const cst::CSTNode* cst_node) {
   // CST 结构：BinaryExpr
   //   - Expression (左操作数)
   //   - Operator (运算符)
   //   - Expression (右操作数)
 
-  std::shared_ptr<Expression> left = nullptr;
-  std::shared_ptr<Expression> right = nullptr;
-  BinaryOperator op;
+  Expression* left = nullptr;
+  Expression* right = nullptr;
+  BinaryOperator op = BinaryOperator::Add;
   bool found_operator = false;
 
   // 遍历子节点
@@ -566,18 +595,17 @@ ASTBuilder::build_binary_expr(const cst::CSTNode* cst_node) {
     return nullptr;
   }
 
-  return std::make_shared<BinaryOpExpr>(op, left, right,
-                                        cst_node->get_location());
+  return context.create<BinaryOpExpr>(op, left, right,
+                                      cst_node->get_location());
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_unary_expr(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_unary_expr(const cst::CSTNode* cst_node) {
   // CST 结构：UnaryExpr
   //   - Operator (运算符)
   //   - Expression (操作数)
 
-  UnaryOperator op;
-  std::shared_ptr<Expression> operand = nullptr;
+  UnaryOperator op = UnaryOperator::Plus;
+  Expression* operand = nullptr;
   bool found_operator = false;
 
   // 遍历子节点
@@ -600,11 +628,10 @@ ASTBuilder::build_unary_expr(const cst::CSTNode* cst_node) {
     return nullptr;
   }
 
-  return std::make_shared<UnaryOpExpr>(op, operand, cst_node->get_location());
+  return context.create<UnaryOpExpr>(op, operand, cst_node->get_location());
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_literal(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_literal(const cst::CSTNode* cst_node) {
   const auto& token = cst_node->get_token();
   if (!token.has_value()) {
     return nullptr;
@@ -612,23 +639,24 @@ ASTBuilder::build_literal(const cst::CSTNode* cst_node) {
 
   switch (cst_node->get_type()) {
   case cst::CSTNodeType::IntegerLiteral: {
-    int64_t value = parse_integer_literal(token->value);
-    return std::make_shared<IntegerLiteral>(value, cst_node->get_location());
+    int64_t value = parse_integer_literal(*token);
+    return context.create<IntegerLiteral>(value, cst_node->get_location());
   }
 
   case cst::CSTNodeType::FloatLiteral: {
-    double value = parse_float_literal(token->value);
-    return std::make_shared<FloatLiteral>(value, cst_node->get_location());
+    double value = parse_float_literal(*token);
+    return context.create<FloatLiteral>(value, cst_node->get_location());
   }
 
   case cst::CSTNodeType::StringLiteral: {
-    std::string value = parse_string_literal(token->value);
-    return std::make_shared<StringLiteral>(value, cst_node->get_location());
+    // NOTE: Lexer 已处理转义序列并去掉了引号，`value` 就是字符串的值。
+    return context.create<StringLiteral>(context.intern(token->value),
+                                         cst_node->get_location());
   }
 
   case cst::CSTNodeType::BooleanLiteral: {
     bool value = (token->value == "true");
-    return std::make_shared<BooleanLiteral>(value, cst_node->get_location());
+    return context.create<BooleanLiteral>(value, cst_node->get_location());
   }
 
   default:
@@ -636,18 +664,30 @@ ASTBuilder::build_literal(const cst::CSTNode* cst_node) {
   }
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_identifier(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_identifier(const cst::CSTNode* cst_node) {
   const auto& token = cst_node->get_token();
   if (!token.has_value()) {
     return nullptr;
   }
 
-  return std::make_shared<Identifier>(token->value, cst_node->get_location());
+  return context.create<Identifier>(intern_token(*token),
+                                    cst_node->get_location());
 }
 
 // === 辅助方法实现 ===
 
+utils::InternedString ASTBuilder::intern_token(const lexer::Token& token) {
+  // NOTE: 句柄可能来自另一个驻留表，因此用文本校验后才复用；
+  //       校验只是一次按长度的比较，不需要哈希。
+  if (token.symbol.is_valid()) {
+    std::string_view text = context.get_interner().get_string(token.symbol);
+    if (text == token.value) {
+      return utils::InternedString(token.symbol, text);
+    }
+  }
+  return context.intern(token.value);
+}
+
 BinaryOperator ASTBuilder::parse_binary_operator(const std::string& op_str) {
   if (op_str == "+") {
     return BinaryOperator::Add;
@@ -706,40 +746,35 @@ UnaryOperator ASTBuilder::parse_unary_operator(const std::string& op_str) {
   throw std::runtime_error("Unknown unary operator: " + op_str);
 }
 
-int64_t ASTBuilder::parse_integer_literal(const std::string& literal_str) {
-  try {
-    return std::stoll(literal_str);
-  } catch (const std::exception& e) {
-    throw std::runtime_error("Failed to parse integer literal: " + literal_str);
+int64_t ASTBuilder::parse_integer_literal(const lexer::Token& token) {
+  if (token.has_numeric_value) {
+    return token.integer_value;
   }
-}
-
-double ASTBuilder::parse_float_literal(const std::string& literal_str) {
-  try {
-    return std::stod(literal_str);
-  } catch (const std::exception& e) {
-    throw std::runtime_error("Failed to parse float literal: " + literal_str);
+  int64_t value = 0;
+  if (!lexer::decode_integer(token.value, value)) {
+    throw std::runtime_error("Failed to parse integer literal: " + token.value);
   }
+  return value;
 }
 
-std::string ASTBuilder::parse_string_literal(const std::string& literal_str) {
-  // TODO: 实现字符串字面量解析（处理转义字符）
-  // 现在简单地移除引号
-  if (literal_str.length() >= 2 && literal_str.front() == '"' &&
-      literal_str.back() == '"') {
-    return literal_str.substr(1, literal_str.length() - 2);
+double ASTBuilder::parse_float_literal(const lexer::Token& token) {
+  if (token.has_numeric_value) {
+    return token.float_value;
+  }
+  double value = 0;
+  if (!lexer::decode_float(token.value, value)) {
+    throw std::runtime_error("Failed to parse float literal: " + token.value);
   }
-  return literal_str;
+  return value;
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_paren_expr(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_paren_expr(const cst::CSTNode* cst_node) {
   // CST 结构：ParenExpr
   //   - Delimiter (左括号)
   //   - Expression (内部表达式)
   //   - Delimiter (右括号)
 
-  std::shared_ptr<Expression> expr = nullptr;
+  Expression* expr = nullptr;
 
   // 遍历子节点,跳过分隔符
   for (const auto& child : cst_node->get_children()) {
@@ -753,11 +788,10 @@ ASTBuilder::build_paren_expr(const cst::CSTNode* cst_node) {
     return nullptr;
   }
 
-  return std::make_shared<ParenExpr>(expr, cst_node->get_location());
+  return context.create<ParenExpr>(expr, cst_node->get_location());
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_call_expr(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_call_expr(const cst::CSTNode* cst_node) {
   // CST 结构：CallExpr
   //   - Expression (被调用的函数)
   //   - Delimiter (左括号)
@@ -768,8 +802,8 @@ ASTBuilder::build_call_expr(const cst::CSTNode* cst_node) {
   //     - ...
   //   - Delimiter (右括号)
 
-  std::shared_ptr<Expression> callee = nullptr;
-  std::vector<std::shared_ptr<Expression>> arguments;
+  Expression* callee = nullptr;
+  std::vector<Expression*> arguments;
 
   // 遍历子节点
   for (const auto& child : cst_node->get_children()) {
@@ -797,20 +831,19 @@ ASTBuilder::build_call_expr(const cst::CSTNode* cst_node) {
     return nullptr;
   }
 
-  return std::make_shared<CallExpr>(callee, arguments,
-                                    cst_node->get_location());
+  return context.create<CallExpr>(callee, std::move(arguments),
+                                  cst_node->get_location());
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_index_expr(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_index_expr(const cst::CSTNode* cst_node) {
   // CST 结构：IndexExpr
   //   - Expression (被索引的对象)
   //   - Delimiter (左方括号)
   //   - Expression (索引)
   //   - Delimiter (右方括号)
 
-  std::shared_ptr<Expression> object = nullptr;
-  std::shared_ptr<Expression> index = nullptr;
+  Expression* object = nullptr;
+  Expression* index = nullptr;
 
   // 遍历子节点
   int expr_count = 0;
@@ -833,18 +866,17 @@ ASTBuilder::build_index_expr(const cst::CSTNode* cst_node) {
     return nullptr;
   }
 
-  return std::make_shared<IndexExpr>(object, index, cst_node->get_location());
+  return context.create<IndexExpr>(object, index, cst_node->get_location());
 }
 
-std::shared_ptr<Expression>
-ASTBuilder::build_member_expr(const cst::CSTNode* cst_node) {
+Expression* ASTBuilder::build_member_expr(const cst::CSTNode* cst_node) {
   // CST 结构：MemberExpr
   //   - Expression (对象)
   //   - Delimiter (点号)
   //   - Identifier (成员名)
 
-  std::shared_ptr<Expression> object = nullptr;
-  std::string member;
+  Expression* object = nullptr;
+  utils::InternedString member;
 
   // 遍历子节点
   for (const auto& child : cst_node->get_children()) {
@@ -852,7 +884,7 @@ ASTBuilder::build_member_expr(const cst::CSTNode* cst_node) {
       // 成员名
       const auto& token = child->get_token();
       if (token.has_value()) {
-        member = token->value;
+        member = intern_token(*token);
       }
     } else if (child->get_type() != cst::CSTNodeType::Delimiter &&
                child->get_type() != cst::CSTNodeType::Comment) {
@@ -863,11 +895,11 @@ ASTBuilder::build_member_expr(const cst::CSTNode* cst_node) {
     }
   }
 
-  if (!object || member.empty()) {
+  if (!object || member.get_view().empty()) {
     return nullptr;
   }
 
-  return std::make_shared<MemberExpr>(object, member, cst_node->get_location());
+  return context.create<MemberExpr>(object, member, cst_node->get_location());
 }
 
 } // namespace czc::ast
@@ -0,0 +1,121 @@
+/**
+ * @file ast_builder_parallel.cpp
+ * @brief 按顶层声明并行构建 AST 的实现。
+ * @details
+ *   Program 的子节点被均分为连续的若干块，各块在线程池上由独立的
+ *   ASTBuilder 转换到各自的 `ASTContext`；最后由本上下文接管这些上下文，
+ *   并按顺序把声明挂到同一个 `Program` 节点下。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/ast/ast_builder.hpp"
+
+#include "czc/utils/thread_pool.hpp"
+#include "czc/utils/time_report.hpp"
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace czc::ast {
+
+namespace {
+
+/**
+ * @brief 单个分块的转换结果。
+ */
+struct ChunkResult {
+  // 持有本块全部节点的上下文
+  std::unique_ptr<ASTContext> context;
+  std::vector<Declaration*> declarations;
+};
+
+} // namespace
+
+Program* ASTBuilder::build_parallel(const cst::CSTNode* cst_root,
+                                    utils::ThreadPool& pool,
+                                    size_t min_chunk_declarations) {
+  if (cst_root == nullptr) {
+    throw std::runtime_error("CST root is null");
+  }
+
+  if (cst_root->get_type() != cst::CSTNodeType::Program) {
+    throw std::runtime_error("CST root must be a Program node");
+  }
+
+  const auto& children = cst_root->get_children();
+  if (min_chunk_declarations == 0) {
+    min_chunk_declarations = 1;
+  }
+  size_t chunk_count = pool.size();
+  if (children.size() / min_chunk_declarations < chunk_count) {
+    chunk_count = children.size() / min_chunk_declarations;
+  }
+  if (chunk_count < 2) {
+    return build(cst_root);
+  }
+
+  CZC_TIME_PHASE(BuildAST);
+  [[maybe_unused]] size_t nodes_before = context.get_node_count();
+
+  // 把 `[begin, end)` 中的顶层节点转换到一个新的上下文。
+  // NOTE: 驻留表是线程安全的，各块共享它，驻留后的字符串视图在合并后仍有效。
+  utils::StringInterner& interner = context.get_interner();
+  auto build_range = [&children, &interner](size_t begin, size_t end) {
+    ChunkResult result;
+    result.context = std::make_unique<ASTContext>(interner);
+    result.declarations.reserve(end - begin);
+    ASTBuilder builder(*result.context);
+    for (size_t i = begin; i < end; ++i) {
+      auto decl = builder.build_declaration(children[i].get());
+      if (decl) {
+        result.declarations.push_back(decl);
+      }
+    }
+    return result;
+  };
+
+  // --- 并行转换各分块 ---
+  std::vector<std::future<ChunkResult>> futures;
+  futures.reserve(chunk_count);
+  for (size_t i = 0; i < chunk_count; ++i) {
+    size_t begin = children.size() * i / chunk_count;
+    size_t end = children.size() * (i + 1) / chunk_count;
+    futures.push_back(pool.submit(
+        [&build_range, begin, end]() { return build_range(begin, end); }));
+  }
+
+  // NOTE: 任务引用了本函数的局部变量，必须等全部任务结束后才能抛出异常。
+  std::vector<ChunkResult> chunks;
+  chunks.reserve(futures.size());
+  std::exception_ptr failure;
+  for (auto& future : futures) {
+    try {
+      chunks.push_back(future.get());
+    } catch (...) {
+      if (!failure) {
+        failure = std::current_exception();
+      }
+    }
+  }
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+
+  // --- 接管各块的上下文，按顺序拼接声明 ---
+  auto program = context.create<Program>(cst_root->get_location());
+  for (auto& chunk : chunks) {
+    context.adopt(std::move(chunk.context));
+    for (auto decl : chunk.declarations) {
+      program->add_declaration(decl);
+    }
+  }
+
+  CZC_COUNT(BuildAST, ASTNodes, context.get_node_count() - nodes_before);
+  return program;
+}
+
+} // namespace czc::ast
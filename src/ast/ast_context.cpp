@@ -0,0 +1,84 @@
+/**
+ * @file ast_context.cpp
+ * @brief `ASTContext` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/ast/ast_context.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace czc::ast {
+
+ASTContext::ASTContext()
+    : owned_interner(std::make_unique<utils::StringInterner>()),
+      interner(owned_interner.get()) {}
+
+ASTContext::ASTContext(utils::StringInterner& interner) noexcept
+    : interner(&interner) {}
+
+ASTContext::~ASTContext() {
+  // NOTE: 节点的析构函数只释放自身的子节点列表，不会访问其他节点，
+  //       因此可以逐个节点池析构，不必按创建顺序。
+  for (const NodePool& pool : pools) {
+    if (pool.destroy == nullptr) {
+      continue;
+    }
+    for (const Slab& slab : pool.slabs) {
+      for (uint32_t i = 0; i < slab.size; ++i) {
+        pool.destroy(slab.data + i * pool.stride);
+      }
+    }
+  }
+}
+
+size_t ASTContext::NodePool::count() const noexcept {
+  size_t total = 0;
+  for (const Slab& slab : slabs) {
+    total += slab.size;
+  }
+  return total;
+}
+
+void ASTContext::add_slab(NodePool& pool, size_t align) {
+  uint32_t capacity =
+      pool.slabs.empty()
+          ? FIRST_SLAB_NODES
+          : std::min(pool.slabs.back().capacity * 2, MAX_SLAB_NODES);
+  // 先预留目录的空间，Arena 分配成功后登记不会再抛出异常。
+  if (pool.slabs.size() == pool.slabs.capacity()) {
+    pool.slabs.reserve(std::max<size_t>(4, pool.slabs.size() * 2));
+  }
+  auto* data =
+      static_cast<std::byte*>(arena.allocate(capacity * pool.stride, align));
+  pool.slabs.push_back({data, 0, capacity});
+}
+
+void ASTContext::adopt(std::unique_ptr<ASTContext> other) {
+  if (other == nullptr) {
+    return;
+  }
+  // NOTE: 节点中的名字通过驻留表的句柄比较，驻留表不同时句柄没有可比性。
+  if (other->interner != interner) {
+    throw std::invalid_argument(
+        "ASTContext can only adopt contexts sharing its interner");
+  }
+  node_count += other->node_count;
+  adopted.push_back(std::move(other));
+}
+
+size_t ASTContext::get_memory_bytes() const noexcept {
+  size_t bytes = arena.get_bytes_used() + pools.capacity() * sizeof(NodePool) +
+                 adopted.capacity() * sizeof(adopted[0]);
+  for (const NodePool& pool : pools) {
+    bytes += pool.slabs.capacity() * sizeof(Slab);
+  }
+  for (const auto& child : adopted) {
+    bytes += child->get_memory_bytes();
+  }
+  return bytes;
+}
+
+} // namespace czc::ast
@@ -8,11 +8,139 @@
 #include "czc/ast/ast_visitor.hpp"
 
 #include "czc/ast/ast_node.hpp"
+#include "czc/ast/ast_walker.hpp"
 
 #include <iostream>
 
 namespace czc::ast {
 
+namespace {
+
+/**
+ * @brief 把 `ASTWalker` 的先序回调转发给虚函数访问者。
+ */
+class ASTVisitorAdapter : public ASTWalker<ASTVisitorAdapter> {
+public:
+  explicit ASTVisitorAdapter(ASTVisitor& visitor) : visitor(visitor) {}
+
+#define CZC_FORWARD(name, type)                                                \
+  bool enter_##name(type* node) {                                              \
+    visitor.visit_##name(node);                                                \
+    return true;                                                               \
+  }
+
+  CZC_FORWARD(program, Program)
+  CZC_FORWARD(var_decl, VarDecl)
+  CZC_FORWARD(function_decl, FunctionDecl)
+  CZC_FORWARD(struct_decl, StructDecl)
+  CZC_FORWARD(struct_field, StructField)
+  CZC_FORWARD(parameter, Parameter)
+  CZC_FORWARD(block_stmt, BlockStmt)
+  CZC_FORWARD(expr_stmt, ExprStmt)
+  CZC_FORWARD(return_stmt, ReturnStmt)
+  CZC_FORWARD(if_stmt, IfStmt)
+  CZC_FORWARD(integer_literal, IntegerLiteral)
+  CZC_FORWARD(float_literal, FloatLiteral)
+  CZC_FORWARD(string_literal, StringLiteral)
+  CZC_FORWARD(boolean_literal, BooleanLiteral)
+  CZC_FORWARD(identifier, Identifier)
+  CZC_FORWARD(binary_op, BinaryOpExpr)
+  CZC_FORWARD(unary_op, UnaryOpExpr)
+  CZC_FORWARD(call_expr, CallExpr)
+  CZC_FORWARD(index_expr, IndexExpr)
+  CZC_FORWARD(member_expr, MemberExpr)
+  CZC_FORWARD(paren_expr, ParenExpr)
+
+#undef CZC_FORWARD
+
+private:
+  ASTVisitor& visitor;
+};
+
+// 以具体类型调用访问者方法的可调用对象，供 `accept` 使用。
+struct AcceptDispatch {
+  ASTVisitor& visitor;
+
+  void operator()(Program* node) const {
+    visitor.visit_program(node);
+  }
+  void operator()(VarDecl* node) const {
+    visitor.visit_var_decl(node);
+  }
+  void operator()(FunctionDecl* node) const {
+    visitor.visit_function_decl(node);
+  }
+  void operator()(StructDecl* node) const {
+    visitor.visit_struct_decl(node);
+  }
+  void operator()(StructField* node) const {
+    visitor.visit_struct_field(node);
+  }
+  void operator()(Parameter* node) const {
+    visitor.visit_parameter(node);
+  }
+  void operator()(BlockStmt* node) const {
+    visitor.visit_block_stmt(node);
+  }
+  void operator()(ExprStmt* node) const {
+    visitor.visit_expr_stmt(node);
+  }
+  void operator()(ReturnStmt* node) const {
+    visitor.visit_return_stmt(node);
+  }
+  void operator()(IfStmt* node) const {
+    visitor.visit_if_stmt(node);
+  }
+  void operator()(IntegerLiteral* node) const {
+    visitor.visit_integer_literal(node);
+  }
+  void operator()(FloatLiteral* node) const {
+    visitor.visit_float_literal(node);
+  }
+  void operator()(StringLiteral* node) const {
+    visitor.visit_string_literal(node);
+  }
+  void operator()(BooleanLiteral* node) const {
+    visitor.visit_boolean_literal(node);
+  }
+  void operator()(Identifier* node) const {
+    visitor.visit_identifier(node);
+  }
+  void operator()(BinaryOpExpr* node) const {
+    visitor.visit_binary_op(node);
+  }
+  void operator()(UnaryOpExpr* node) const {
+    visitor.visit_unary_op(node);
+  }
+  void operator()(CallExpr* node) const {
+    visitor.visit_call_expr(node);
+  }
+  void operator()(IndexExpr* node) const {
+    visitor.visit_index_expr(node);
+  }
+  void operator()(MemberExpr* node) const {
+    visitor.visit_member_expr(node);
+  }
+  void operator()(ParenExpr* node) const {
+    visitor.visit_paren_expr(node);
+  }
+  // 尚无具体节点类的种类。
+  void operator()(ASTNode*) const {}
+};
+
+} // namespace
+
+void accept(ASTNode* node, ASTVisitor& visitor) {
+  if (node != nullptr) {
+    visit_node(node, AcceptDispatch{visitor});
+  }
+}
+
+void walk(ASTNode* root, ASTVisitor& visitor) {
+  ASTVisitorAdapter adapter(visitor);
+  adapter.walk(root);
+}
+
 // === ASTPrinter 实现 ===
 
 void ASTPrinter::print_indent() {
@@ -26,10 +154,8 @@ void ASTPrinter::visit_program(Program* node) {
   std::cout << "Program" << std::endl;
 
   increase_indent();
-  for (const auto& decl : node->get_declarations()) {
-    // TODO: 访问每个声明
-    print_indent();
-    std::cout << "Declaration (TODO)" << std::endl;
+  for (auto* decl : node->get_declarations()) {
+    accept(decl, *this);
   }
   decrease_indent();
 }
@@ -53,13 +179,13 @@ void ASTPrinter::visit_binary_op(BinaryOpExpr* node) {
   print_indent();
   std::cout << "Left:" << std::endl;
   increase_indent();
-  // TODO: 访问左操作数
+  accept(node->get_left(), *this);
   decrease_indent();
 
   print_indent();
   std::cout << "Right:" << std::endl;
   increase_indent();
-  // TODO: 访问右操作数
+  accept(node->get_right(), *this);
   decrease_indent();
 
   decrease_indent();
@@ -70,10 +196,8 @@ void ASTPrinter::visit_block_stmt(BlockStmt* node) {
   std::cout << "BlockStmt" << std::endl;
 
   increase_indent();
-  for (const auto& stmt : node->get_statements()) {
-    // TODO: 访问每个语句
-    print_indent();
-    std::cout << "Statement (TODO)" << std::endl;
+  for (auto* stmt : node->get_statements()) {
+    accept(stmt, *this);
   }
   decrease_indent();
 }
@@ -0,0 +1,351 @@
+/**
+ * @file constant_folder.cpp
+ * @brief `ConstantFolder` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/ast/constant_folder.hpp"
+
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace czc::ast {
+
+using token_preprocessor::InferredNumericType;
+
+namespace {
+
+/**
+ * @brief 一个字面量节点的值。
+ */
+struct Constant {
+  bool is_boolean = false;
+  // 数值的类型，仅在 `is_boolean` 为 false 时有效
+  InferredNumericType type = InferredNumericType::INT64;
+  int64_t integer = 0;
+  double real = 0;
+  bool boolean = false;
+
+  [[nodiscard]] bool is_integer() const noexcept {
+    return !is_boolean && type == InferredNumericType::INT64;
+  }
+  [[nodiscard]] bool is_number() const noexcept {
+    return !is_boolean;
+  }
+  [[nodiscard]] double as_real() const noexcept {
+    return type == InferredNumericType::INT64 ? static_cast<double>(integer)
+                                              : real;
+  }
+};
+
+Constant make_integer(int64_t value) {
+  Constant constant;
+  constant.integer = value;
+  return constant;
+}
+
+Constant make_real(double value) {
+  Constant constant;
+  constant.type = InferredNumericType::FLOAT;
+  constant.real = value;
+  return constant;
+}
+
+Constant make_boolean(bool value) {
+  Constant constant;
+  constant.is_boolean = true;
+  constant.boolean = value;
+  return constant;
+}
+
+/**
+ * @brief 获取字面量节点的值，不是数值或布尔字面量时返回空。
+ */
+std::optional<Constant> as_constant(const Expression* expr) {
+  switch (expr->get_kind()) {
+  case ASTNodeKind::IntegerLiteral:
+    return make_integer(static_cast<const IntegerLiteral*>(expr)->get_value());
+  case ASTNodeKind::FloatLiteral:
+    return make_real(static_cast<const FloatLiteral*>(expr)->get_value());
+  case ASTNodeKind::BooleanLiteral:
+    return make_boolean(static_cast<const BooleanLiteral*>(expr)->get_value());
+  default:
+    return std::nullopt;
+  }
+}
+
+/**
+ * @brief 比较两个数值，两者都是整数时精确比较。
+ * @return 小于、等于、大于分别返回 -1、0、1。
+ */
+int compare_numbers(const Constant& left, const Constant& right) {
+  if (left.is_integer() && right.is_integer()) {
+    return left.integer < right.integer ? -1 : left.integer > right.integer;
+  }
+  double lhs = left.as_real();
+  double rhs = right.as_real();
+  return lhs < rhs ? -1 : lhs > rhs;
+}
+
+/**
+ * @brief 比较运算的结果，不是比较运算时返回空。
+ */
+std::optional<bool> compare(BinaryOperator op, int order) {
+  switch (op) {
+  case BinaryOperator::Eq:
+    return order == 0;
+  case BinaryOperator::Ne:
+    return order != 0;
+  case BinaryOperator::Lt:
+    return order < 0;
+  case BinaryOperator::Le:
+    return order <= 0;
+  case BinaryOperator::Gt:
+    return order > 0;
+  case BinaryOperator::Ge:
+    return order >= 0;
+  default:
+    return std::nullopt;
+  }
+}
+
+} // namespace
+
+void ConstantFolder::run(ASTNode* root) {
+  walk(root, *this);
+}
+
+Expression* ConstantFolder::fold(Expression* expr) {
+  if (expr == nullptr) {
+    return nullptr;
+  }
+
+  switch (expr->get_kind()) {
+  case ASTNodeKind::ParenExpr: {
+    Expression* inner = static_cast<ParenExpr*>(expr)->get_expression();
+    if (inner == nullptr) {
+      return expr;
+    }
+    ++stats_.collapsed_parens;
+    return fold(inner);
+  }
+
+  case ASTNodeKind::UnaryOp: {
+    auto* unary = static_cast<UnaryOpExpr*>(expr);
+    unary->set_operand(fold(unary->get_operand()));
+    return fold_unary(unary);
+  }
+
+  case ASTNodeKind::BinaryOp: {
+    auto* binary = static_cast<BinaryOpExpr*>(expr);
+    binary->set_left(fold(binary->get_left()));
+    binary->set_right(fold(binary->get_right()));
+    return fold_binary(binary);
+  }
+
+  default:
+    return expr;
+  }
+}
+
+Expression* ConstantFolder::fold_binary(BinaryOpExpr* node) {
+  if (node->get_left() == nullptr || node->get_right() == nullptr) {
+    return node;
+  }
+  auto left = as_constant(node->get_left());
+  auto right = as_constant(node->get_right());
+  if (!left || !right) {
+    return node;
+  }
+
+  BinaryOperator op = node->get_operator();
+  const auto& location = node->get_location();
+  auto fold_to_boolean = [&](bool value) -> Expression* {
+    ++stats_.folded_expressions;
+    return context_.create<BooleanLiteral>(value, location);
+  };
+
+  if (left->is_boolean || right->is_boolean) {
+    if (!left->is_boolean || !right->is_boolean) {
+      return node;
+    }
+    switch (op) {
+    case BinaryOperator::And:
+      return fold_to_boolean(left->boolean && right->boolean);
+    case BinaryOperator::Or:
+      return fold_to_boolean(left->boolean || right->boolean);
+    case BinaryOperator::Eq:
+      return fold_to_boolean(left->boolean == right->boolean);
+    case BinaryOperator::Ne:
+      return fold_to_boolean(left->boolean != right->boolean);
+    default:
+      return node;
+    }
+  }
+
+  if (auto result = compare(op, compare_numbers(*left, *right))) {
+    return fold_to_boolean(*result);
+  }
+
+  // --- 整数运算 ---
+  // NOTE: 与科学计数法字面量的推断规则一样，数学上是整数但超出 int64_t
+  //       的结果改用浮点数表示（推断为 FLOAT），而不是回绕。
+  std::optional<Constant> result;
+  if (left->is_integer() && right->is_integer()) {
+    int64_t lhs = left->integer;
+    int64_t rhs = right->integer;
+    int64_t value = 0;
+    bool overflow = false;
+    switch (op) {
+    case BinaryOperator::Add:
+      overflow = __builtin_add_overflow(lhs, rhs, &value);
+      break;
+    case BinaryOperator::Sub:
+      overflow = __builtin_sub_overflow(lhs, rhs, &value);
+      break;
+    case BinaryOperator::Mul:
+      overflow = __builtin_mul_overflow(lhs, rhs, &value);
+      break;
+    case BinaryOperator::Div:
+      // 只折叠能整除的除法，截断与向下取整、整数与浮点除法的结果都相同。
+      if (rhs == 0 || lhs % rhs != 0) {
+        return node;
+      }
+      overflow = lhs == std::numeric_limits<int64_t>::min() && rhs == -1;
+      value = overflow ? 0 : lhs / rhs;
+      break;
+    case BinaryOperator::Mod:
+      if (lhs < 0 || rhs <= 0) {
+        return node;
+      }
+      value = lhs % rhs;
+      break;
+    default:
+      return node;
+    }
+    if (!overflow) {
+      result = make_integer(value);
+    } else {
+      ++stats_.promoted_to_float;
+    }
+  }
+
+  // --- 浮点运算（含溢出后改用浮点数的整数运算） ---
+  if (!result) {
+    double lhs = left->as_real();
+    double rhs = right->as_real();
+    double value = 0;
+    switch (op) {
+    case BinaryOperator::Add:
+      value = lhs + rhs;
+      break;
+    case BinaryOperator::Sub:
+      value = lhs - rhs;
+      break;
+    case BinaryOperator::Mul:
+      value = lhs * rhs;
+      break;
+    case BinaryOperator::Div:
+      if (rhs == 0) {
+        ++stats_.overflowed;
+        return node;
+      }
+      value = lhs / rhs;
+      break;
+    default:
+      return node;
+    }
+    // NOTE: 有限的 double 数量级不会超过 MAX_F64_MAGNITUDE，超出即为无穷。
+    if (!std::isfinite(value)) {
+      ++stats_.overflowed;
+      return node;
+    }
+    result = make_real(value);
+  }
+
+  ++stats_.folded_expressions;
+  if (result->is_integer()) {
+    return context_.create<IntegerLiteral>(result->integer, location);
+  }
+  return context_.create<FloatLiteral>(result->real, location);
+}
+
+Expression* ConstantFolder::fold_unary(UnaryOpExpr* node) {
+  if (node->get_operand() == nullptr) {
+    return node;
+  }
+  auto operand = as_constant(node->get_operand());
+  if (!operand) {
+    return node;
+  }
+
+  const auto& location = node->get_location();
+  switch (node->get_operator()) {
+  case UnaryOperator::Not:
+    if (!operand->is_boolean) {
+      return node;
+    }
+    ++stats_.folded_expressions;
+    return context_.create<BooleanLiteral>(!operand->boolean, location);
+
+  case UnaryOperator::Plus:
+  case UnaryOperator::Minus: {
+    if (!operand->is_number()) {
+      return node;
+    }
+    bool negate = node->get_operator() == UnaryOperator::Minus;
+    ++stats_.folded_expressions;
+    if (operand->is_integer()) {
+      if (!negate) {
+        return context_.create<IntegerLiteral>(operand->integer, location);
+      }
+      if (operand->integer != std::numeric_limits<int64_t>::min()) {
+        return context_.create<IntegerLiteral>(-operand->integer, location);
+      }
+      ++stats_.promoted_to_float;
+    }
+    double value = operand->as_real();
+    return context_.create<FloatLiteral>(negate ? -value : value, location);
+  }
+  }
+  return node;
+}
+
+void ConstantFolder::visit_var_decl(VarDecl* node) {
+  node->set_initializer(fold(node->get_initializer()));
+}
+
+void ConstantFolder::visit_expr_stmt(ExprStmt* node) {
+  node->set_expression(fold(node->get_expression()));
+}
+
+void ConstantFolder::visit_return_stmt(ReturnStmt* node) {
+  node->set_value(fold(node->get_value()));
+}
+
+void ConstantFolder::visit_if_stmt(IfStmt* node) {
+  node->set_condition(fold(node->get_condition()));
+}
+
+void ConstantFolder::visit_call_expr(CallExpr* node) {
+  node->set_callee(fold(node->get_callee()));
+  for (size_t i = 0; i < node->get_arguments().size(); ++i) {
+    node->set_argument(i, fold(node->get_arguments()[i]));
+  }
+}
+
+void ConstantFolder::visit_index_expr(IndexExpr* node) {
+  node->set_object(fold(node->get_object()));
+  node->set_index(fold(node->get_index()));
+}
+
+void ConstantFolder::visit_member_expr(MemberExpr* node) {
+  node->set_object(fold(node->get_object()));
+}
+
+} // namespace czc::ast
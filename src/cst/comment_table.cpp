@@ -0,0 +1,47 @@
+/**
+ * @file comment_table.cpp
+ * @brief `CommentTable` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/cst/comment_table.hpp"
+
+#include <functional>
+
+namespace czc::cst {
+
+size_t CommentTable::KeyHash::operator()(const Key& key) const noexcept {
+  return std::hash<const CSTNode*>()(key.anchor) * 3 +
+         static_cast<size_t>(key.placement);
+}
+
+void CommentTable::attach(const CSTNode* anchor, CommentPlacement placement,
+                          const lexer::Token& comment) {
+  auto end = static_cast<uint32_t>(comments.size());
+  auto [it, inserted] =
+      groups.try_emplace(Key{anchor, placement}, Group{end, 0});
+  Group& group = it->second;
+  // NOTE: 同一组的注释通常连续追加；被其他组隔开时把整组移到末尾，
+  //       保证每组在向量中始终连续。
+  if (!inserted && group.begin + group.size != end) {
+    for (uint32_t i = 0; i < group.size; ++i) {
+      comments.push_back(comments[group.begin + i]);
+    }
+    group.begin = end;
+  }
+  comments.push_back(comment);
+  ++group.size;
+  ++count;
+}
+
+CommentRange CommentTable::get(const CSTNode* anchor,
+                               CommentPlacement placement) const {
+  auto it = groups.find(Key{anchor, placement});
+  if (it == groups.end()) {
+    return {};
+  }
+  return {comments.data() + it->second.begin, it->second.size};
+}
+
+} // namespace czc::cst
@@ -0,0 +1,445 @@
+/**
+ * @file cst_cache.cpp
+ * @brief Token 序列与 CST 的二进制序列化以及 `CSTCache` 的实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/cst/cst_cache.hpp"
+
+#include "czc/utils/atomic_file.hpp"
+#include "czc/utils/byte_io.hpp"
+#include "czc/utils/hash.hpp"
+#include "czc/utils/source_buffer.hpp"
+#include "czc/utils/time_report.hpp"
+
+#include <cstdio>
+#include <unordered_map>
+#include <utility>
+
+namespace czc::cst {
+
+namespace {
+
+constexpr char MAGIC[4] = {'C', 'Z', 'C', 'B'};
+
+// 正文的内容种类。
+enum class PayloadKind : uint8_t { Tokens = 1, Tree = 2 };
+
+// Token 记录的标志位。
+constexpr uint64_t TOKEN_SYNTHETIC = 1U << 0;
+constexpr uint64_t TOKEN_RAW_STRING = 1U << 1;
+// `value` 与源码区间相同，不进入字符串表
+constexpr uint64_t TOKEN_VALUE_IN_SOURCE = 1U << 2;
+// `raw_literal` 非空
+constexpr uint64_t TOKEN_HAS_RAW = 1U << 3;
+// `raw_literal` 与源码区间相同，不进入字符串表
+constexpr uint64_t TOKEN_RAW_IN_SOURCE = 1U << 4;
+
+// 节点记录的标志位。
+constexpr uint64_t NODE_HAS_TOKEN = 1U << 0;
+
+constexpr uint64_t MAX_NODE_TYPE = CST_NODE_TYPE_COUNT - 1;
+constexpr uint64_t MAX_TOKEN_TYPE = lexer::TOKEN_TYPE_COUNT - 1;
+
+using Writer = utils::ByteWriter;
+using Reader = utils::ByteReader;
+
+/**
+ * @brief 编码正文，同时收集字符串表。
+ * @details 字符串以视图保存，被编码的 Token 必须在 `finish` 之前一直存活。
+ */
+class Encoder {
+public:
+  explicit Encoder(std::string_view source) noexcept : source(source) {}
+
+  void put_token(const lexer::Token& token) {
+    uint64_t flags = 0;
+    if (token.is_synthetic) {
+      flags |= TOKEN_SYNTHETIC;
+    }
+    if (token.is_raw_string) {
+      flags |= TOKEN_RAW_STRING;
+    }
+    if (is_source_slice(token, token.value)) {
+      flags |= TOKEN_VALUE_IN_SOURCE;
+    }
+    if (!token.raw_literal.empty()) {
+      flags |= TOKEN_HAS_RAW;
+      if (is_source_slice(token, token.raw_literal)) {
+        flags |= TOKEN_RAW_IN_SOURCE;
+      }
+    }
+
+    body.put_varint(static_cast<uint64_t>(token.token_type));
+    body.put_varint(flags);
+    put_line(token.line);
+    body.put_varint(token.column);
+    body.put_signed(static_cast<int64_t>(token.offset - previous_offset));
+    previous_offset = token.offset;
+    body.put_varint(token.length);
+    if ((flags & TOKEN_VALUE_IN_SOURCE) == 0) {
+      body.put_varint(intern(token.value));
+    }
+    if ((flags & TOKEN_HAS_RAW) != 0 && (flags & TOKEN_RAW_IN_SOURCE) == 0) {
+      body.put_varint(intern(token.raw_literal));
+    }
+  }
+
+  /**
+   * @brief 写入一个行号，记为与上一个行号之差。
+   * @details 节点与 Token 按源码顺序出现，相邻的行号与偏移量都很接近，
+   *          差值几乎总能放进一个字节。
+   */
+  void put_line(size_t line) {
+    body.put_signed(static_cast<int64_t>(line - previous_line));
+    previous_line = line;
+  }
+
+  Writer& get_body() noexcept {
+    return body;
+  }
+
+  /**
+   * @brief 依次写出头部、字符串表与正文。
+   */
+  std::string finish(PayloadKind kind, std::string_view version) {
+    Writer out;
+    out.put_bytes(std::string_view(MAGIC, sizeof(MAGIC)));
+    out.put_varint(CST_CACHE_FORMAT_VERSION);
+    out.put_varint(static_cast<uint64_t>(kind));
+    out.put_string(version);
+    out.put_fixed64(hash_source(source));
+    out.put_varint(source.size());
+
+    Writer payload;
+    payload.put_varint(strings.size());
+    for (std::string_view text : strings) {
+      payload.put_string(text);
+    }
+    payload.put_bytes(body.take());
+    std::string bytes = payload.take();
+    out.put_fixed64(utils::fnv1a(bytes));
+    out.put_bytes(bytes);
+    return out.take();
+  }
+
+private:
+  bool is_source_slice(const lexer::Token& token,
+                       const std::string& text) const noexcept {
+    return token.length == text.size() && token.offset <= source.size() &&
+           token.length <= source.size() - token.offset &&
+           source.compare(token.offset, token.length, text) == 0;
+  }
+
+  uint64_t intern(std::string_view text) {
+    auto [it, inserted] = index.try_emplace(text, strings.size());
+    if (inserted) {
+      strings.push_back(text);
+    }
+    return it->second;
+  }
+
+  std::string_view source;
+  Writer body;
+  size_t previous_line = 0;
+  size_t previous_offset = 0;
+  std::unordered_map<std::string_view, uint64_t> index;
+  std::vector<std::string_view> strings;
+};
+
+/**
+ * @brief 校验头部与校验和并读出字符串表，随后按记录解码正文。
+ */
+class Decoder {
+public:
+  Decoder(std::string_view data, std::string_view source) noexcept
+      : reader(data), source(source) {}
+
+  /**
+   * @brief 读取并校验头部与字符串表。
+   * @return 头部与 `kind`、`version` 及当前源码都相符时返回 true。
+   */
+  bool read_header(PayloadKind kind, std::string_view version) {
+    if (reader.get_bytes(sizeof(MAGIC)) !=
+            std::string_view(MAGIC, sizeof(MAGIC)) ||
+        reader.get_varint() != CST_CACHE_FORMAT_VERSION ||
+        reader.get_varint() != static_cast<uint64_t>(kind) ||
+        reader.get_string() != version ||
+        reader.get_fixed64() != hash_source(source) ||
+        reader.get_varint() != source.size() || !reader.ok()) {
+      return false;
+    }
+    // NOTE: 先读出校验和再取剩余数据，两者不能放在同一个表达式中求值。
+    uint64_t checksum = reader.get_fixed64();
+    if (!reader.ok() || checksum != utils::fnv1a(reader.remaining())) {
+      return false;
+    }
+
+    // NOTE: 不按声明的数量预留空间，损坏的数量只会在读到末尾时失败。
+    uint64_t count = reader.get_varint();
+    for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+      strings.push_back(reader.get_string());
+    }
+    return reader.ok();
+  }
+
+  std::optional<lexer::Token> get_token() {
+    uint64_t type = reader.get_varint();
+    uint64_t flags = reader.get_varint();
+    uint64_t line = get_line();
+    uint64_t column = reader.get_varint();
+    uint64_t offset = previous_offset + reader.get_signed();
+    previous_offset = offset;
+    uint64_t length = reader.get_varint();
+    if (!reader.ok() || type > MAX_TOKEN_TYPE || offset > source.size() ||
+        length > source.size() - offset) {
+      return std::nullopt;
+    }
+    std::string_view slice =
+        source.substr(static_cast<size_t>(offset), static_cast<size_t>(length));
+
+    std::string_view value = slice;
+    if ((flags & TOKEN_VALUE_IN_SOURCE) == 0 && !get_indexed(value)) {
+      return std::nullopt;
+    }
+    std::string_view raw;
+    if ((flags & TOKEN_HAS_RAW) != 0) {
+      raw = slice;
+      if ((flags & TOKEN_RAW_IN_SOURCE) == 0 && !get_indexed(raw)) {
+        return std::nullopt;
+      }
+    }
+
+    lexer::Token token(static_cast<lexer::TokenType>(type), std::string(value),
+                       static_cast<size_t>(line), static_cast<size_t>(column),
+                       (flags & TOKEN_SYNTHETIC) != 0);
+    token.raw_literal = std::string(raw);
+    token.is_raw_string = (flags & TOKEN_RAW_STRING) != 0;
+    token.offset = static_cast<size_t>(offset);
+    token.length = static_cast<size_t>(length);
+    return token;
+  }
+
+  /**
+   * @brief 读取 `Encoder::put_line` 写入的行号。
+   */
+  uint64_t get_line() noexcept {
+    previous_line += reader.get_signed();
+    return previous_line;
+  }
+
+  Reader& get_reader() noexcept {
+    return reader;
+  }
+
+private:
+  bool get_indexed(std::string_view& text) noexcept {
+    uint64_t index = reader.get_varint();
+    if (!reader.ok() || index >= strings.size()) {
+      return false;
+    }
+    text = strings[static_cast<size_t>(index)];
+    return true;
+  }
+
+  Reader reader;
+  std::string_view source;
+  uint64_t previous_line = 0;
+  uint64_t previous_offset = 0;
+  std::vector<std::string_view> strings;
+};
+
+/**
+ * @brief 读取一个节点记录（不含子节点）。
+ * @tparam Node 新节点的类型：根节点为 `CSTArenaRoot`，其余为 `CSTNode`。
+ * @param[out] child_count 节点的子节点数。
+ * @return 成功时返回新节点；数据损坏时返回空。
+ */
+template <typename Node>
+std::unique_ptr<Node> read_node(Decoder& decoder, utils::FileId file_id,
+                                uint64_t& child_count) {
+  Reader& reader = decoder.get_reader();
+  uint64_t type = reader.get_varint();
+  uint64_t flags = reader.get_varint();
+  uint64_t line = decoder.get_line();
+  uint64_t column = reader.get_varint();
+  uint64_t end_line = line + reader.get_signed();
+  uint64_t end_column = reader.get_varint();
+  child_count = reader.get_varint();
+  if (!reader.ok() || type > MAX_NODE_TYPE) {
+    return nullptr;
+  }
+
+  auto node = std::make_unique<Node>(
+      static_cast<CSTNodeType>(type),
+      utils::SourceLocation(file_id, static_cast<size_t>(line),
+                            static_cast<size_t>(column),
+                            static_cast<size_t>(end_line),
+                            static_cast<size_t>(end_column)));
+  if ((flags & NODE_HAS_TOKEN) != 0) {
+    auto token = decoder.get_token();
+    if (!token) {
+      return nullptr;
+    }
+    node->set_token(std::move(*token));
+  }
+  return node;
+}
+
+} // namespace
+
+uint64_t hash_source(std::string_view source) noexcept {
+  return utils::fnv1a(source);
+}
+
+std::string serialize_cst(const CSTNode* root, std::string_view source,
+                          std::string_view version) {
+  Encoder encoder(source);
+  Writer& body = encoder.get_body();
+
+  // 前序遍历：每个节点记录之后紧跟其全部子孙的记录。
+  std::vector<const CSTNode*> stack{root};
+  while (!stack.empty()) {
+    const CSTNode* node = stack.back();
+    stack.pop_back();
+
+    const auto& location = node->get_location();
+    const auto& token = node->get_token();
+    body.put_varint(static_cast<uint64_t>(node->get_type()));
+    body.put_varint(token ? NODE_HAS_TOKEN : 0);
+    encoder.put_line(location.line);
+    body.put_varint(location.column);
+    body.put_signed(static_cast<int64_t>(location.end_line) -
+                    static_cast<int64_t>(location.line));
+    body.put_varint(location.end_column);
+    body.put_varint(node->get_children().size());
+    if (token) {
+      encoder.put_token(*token);
+    }
+
+    const auto& children = node->get_children();
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+      stack.push_back(it->get());
+    }
+  }
+  return encoder.finish(PayloadKind::Tree, version);
+}
+
+std::unique_ptr<CSTNode> deserialize_cst(std::string_view data,
+                                         std::string_view source,
+                                         std::string_view version,
+                                         utils::FileId file_id) {
+  Decoder decoder(data, source);
+  if (!decoder.read_header(PayloadKind::Tree, version)) {
+    return nullptr;
+  }
+
+  // NOTE: 与 Parser 的 Arena 模式相同，根节点在堆上，其余节点及其子节点
+  //       列表都分配在根节点的 Arena 中，载入一棵树只有少量的大块分配。
+  uint64_t child_count = 0;
+  auto root = read_node<CSTArenaRoot>(decoder, file_id, child_count);
+  if (!root) {
+    return nullptr;
+  }
+  CSTArenaScope scope(root->get_arena());
+
+  // 每一项是一个尚未读完子节点的节点及其剩余的子节点数。
+  std::vector<std::pair<CSTNode*, uint64_t>> pending;
+  pending.emplace_back(root.get(), child_count);
+  while (!pending.empty()) {
+    if (pending.back().second == 0) {
+      pending.pop_back();
+      continue;
+    }
+    --pending.back().second;
+    CSTNode* parent = pending.back().first;
+
+    auto child = read_node<CSTNode>(decoder, file_id, child_count);
+    if (!child) {
+      return nullptr;
+    }
+    CSTNode* raw = child.get();
+    parent->add_child(std::move(child));
+    pending.emplace_back(raw, child_count);
+  }
+
+  if (!decoder.get_reader().at_end()) {
+    return nullptr;
+  }
+  return root;
+}
+
+std::string serialize_tokens(const std::vector<lexer::Token>& tokens,
+                             std::string_view source,
+                             std::string_view version) {
+  Encoder encoder(source);
+  encoder.get_body().put_varint(tokens.size());
+  for (const auto& token : tokens) {
+    encoder.put_token(token);
+  }
+  return encoder.finish(PayloadKind::Tokens, version);
+}
+
+std::optional<std::vector<lexer::Token>>
+deserialize_tokens(std::string_view data, std::string_view source,
+                   std::string_view version) {
+  Decoder decoder(data, source);
+  if (!decoder.read_header(PayloadKind::Tokens, version)) {
+    return std::nullopt;
+  }
+
+  uint64_t count = decoder.get_reader().get_varint();
+  std::vector<lexer::Token> tokens;
+  // NOTE: 每个 Token 记录至少占六个字节，据此限制预留的空间。
+  if (count <= data.size() / 6) {
+    tokens.reserve(static_cast<size_t>(count));
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    auto token = decoder.get_token();
+    if (!token) {
+      return std::nullopt;
+    }
+    tokens.push_back(std::move(*token));
+  }
+
+  if (!decoder.get_reader().ok() || !decoder.get_reader().at_end()) {
+    return std::nullopt;
+  }
+  return tokens;
+}
+
+CSTCache::CSTCache(std::string directory, std::string version)
+    : directory(std::move(directory)), version(std::move(version)) {}
+
+std::string CSTCache::entry_path(std::string_view source) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.cst",
+                static_cast<unsigned long long>(hash_source(source)));
+  std::string path = directory;
+  if (!path.empty() && path.back() != '/') {
+    path += '/';
+  }
+  return path + name;
+}
+
+std::unique_ptr<CSTNode> CSTCache::load(std::string_view source,
+                                        utils::FileId file_id) const {
+  // NOTE: 载入代替了解析，耗时计入解析阶段。
+  CZC_TIME_PHASE(Parse);
+  auto entry = utils::SourceBuffer::open(entry_path(source));
+  if (!entry) {
+    return nullptr;
+  }
+  return deserialize_cst(entry->view(), source, version, file_id);
+}
+
+bool CSTCache::store(std::string_view source, const CSTNode* root) const {
+  if (root == nullptr) {
+    return false;
+  }
+  return utils::write_file_atomic(entry_path(source),
+                                  serialize_cst(root, source, version));
+}
+
+} // namespace czc::cst
@@ -0,0 +1,182 @@
+/**
+ * @file cst_diff.cpp
+ * @brief `cst_diff` 的实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/cst/cst_diff.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace czc::cst {
+
+namespace {
+
+/**
+ * @brief 待处理的一项工作：比较一对节点，或直接输出一处差异。
+ */
+struct Task {
+  // 为 Modified 时表示比较 `old_node` 与 `new_node`
+  CSTChangeKind kind;
+  const CSTNode* old_node;
+  const CSTNode* new_node;
+};
+
+uint64_t hash_of(const CSTNode* node) noexcept {
+  return node != nullptr ? node->get_structural_hash() : 0;
+}
+
+/**
+ * @brief 两个节点本身（不含子节点）是否相同。
+ */
+bool same_shallow(const CSTNode& a, const CSTNode& b) noexcept {
+  if (a.get_type() != b.get_type()) {
+    return false;
+  }
+  const auto& x = a.get_token();
+  const auto& y = b.get_token();
+  if (x.has_value() != y.has_value()) {
+    return false;
+  }
+  return !x.has_value() ||
+         (x->token_type == y->token_type &&
+          x->is_synthetic == y->is_synthetic && x->value == y->value &&
+          x->raw_literal == y->raw_literal);
+}
+
+/**
+ * @brief 对齐两组子节点，按源码顺序追加比较与输出的工作。
+ * @details 追加的顺序与输出顺序相同，调用方再把它们逆序压入栈中。
+ */
+void align_children(const CSTChildList& old_children,
+                    const CSTChildList& new_children,
+                    std::vector<Task>& out) {
+  size_t old_size = old_children.size();
+  size_t new_size = new_children.size();
+
+  // --- 去掉哈希相同的公共前缀与后缀 ---
+  size_t prefix = 0;
+  while (prefix < old_size && prefix < new_size &&
+         hash_of(old_children[prefix].get()) ==
+             hash_of(new_children[prefix].get())) {
+    ++prefix;
+  }
+  size_t suffix = 0;
+  while (suffix < old_size - prefix && suffix < new_size - prefix &&
+         hash_of(old_children[old_size - 1 - suffix].get()) ==
+             hash_of(new_children[new_size - 1 - suffix].get())) {
+    ++suffix;
+  }
+  size_t n = old_size - prefix - suffix;
+  size_t m = new_size - prefix - suffix;
+  auto old_at = [&](size_t i) { return old_children[prefix + i].get(); };
+  auto new_at = [&](size_t j) { return new_children[prefix + j].get(); };
+
+  // --- 在剩余部分中按哈希求最长公共子序列 ---
+  // 匹配的 (i, j) 对，按顺序排列，最后追加一个哨兵 (n, m)。
+  std::vector<std::pair<size_t, size_t>> matches;
+  if (n > 0 && m > 0 && n * m <= CST_DIFF_MAX_LCS_CELLS) {
+    // lengths[i * (m + 1) + j] 为 old[i..] 与 new[j..] 的 LCS 长度。
+    std::vector<uint32_t> lengths((n + 1) * (m + 1), 0);
+    for (size_t i = n; i-- > 0;) {
+      for (size_t j = m; j-- > 0;) {
+        uint32_t& cell = lengths[i * (m + 1) + j];
+        if (hash_of(old_at(i)) == hash_of(new_at(j))) {
+          cell = lengths[(i + 1) * (m + 1) + j + 1] + 1;
+        } else {
+          cell = std::max(lengths[(i + 1) * (m + 1) + j],
+                          lengths[i * (m + 1) + j + 1]);
+        }
+      }
+    }
+    size_t i = 0;
+    size_t j = 0;
+    while (i < n && j < m) {
+      if (hash_of(old_at(i)) == hash_of(new_at(j))) {
+        matches.emplace_back(i++, j++);
+      } else if (lengths[(i + 1) * (m + 1) + j] >=
+                 lengths[i * (m + 1) + j + 1]) {
+        ++i;
+      } else {
+        ++j;
+      }
+    }
+  }
+  matches.emplace_back(n, m);
+
+  // --- 匹配之间未匹配的子节点按位置配对 ---
+  size_t i = 0;
+  size_t j = 0;
+  for (const auto& [match_i, match_j] : matches) {
+    for (; i < match_i && j < match_j; ++i, ++j) {
+      const CSTNode* a = old_at(i);
+      const CSTNode* b = new_at(j);
+      if (a != nullptr && b != nullptr && a->get_type() == b->get_type()) {
+        out.push_back({CSTChangeKind::Modified, a, b});
+      } else {
+        out.push_back({CSTChangeKind::Removed, a, nullptr});
+        out.push_back({CSTChangeKind::Inserted, nullptr, b});
+      }
+    }
+    for (; i < match_i; ++i) {
+      out.push_back({CSTChangeKind::Removed, old_at(i), nullptr});
+    }
+    for (; j < match_j; ++j) {
+      out.push_back({CSTChangeKind::Inserted, nullptr, new_at(j)});
+    }
+    // 跳过匹配的一对（哨兵之后循环结束）。
+    ++i;
+    ++j;
+  }
+}
+
+} // namespace
+
+std::vector<CSTChange> cst_diff(const CSTNode* old_root,
+                                const CSTNode* new_root) {
+  compute_structural_hash(old_root);
+  compute_structural_hash(new_root);
+
+  std::vector<CSTChange> changes;
+  std::vector<Task> stack{{CSTChangeKind::Modified, old_root, new_root}};
+  std::vector<Task> children;
+  while (!stack.empty()) {
+    Task task = stack.back();
+    stack.pop_back();
+
+    if (task.kind != CSTChangeKind::Modified) {
+      if (task.old_node != nullptr || task.new_node != nullptr) {
+        changes.push_back({task.kind, task.old_node, task.new_node});
+      }
+      continue;
+    }
+
+    const CSTNode* a = task.old_node;
+    const CSTNode* b = task.new_node;
+    if (a == nullptr || b == nullptr) {
+      if (a != nullptr) {
+        changes.push_back({CSTChangeKind::Removed, a, nullptr});
+      } else if (b != nullptr) {
+        changes.push_back({CSTChangeKind::Inserted, nullptr, b});
+      }
+      continue;
+    }
+    if (a->get_structural_hash() == b->get_structural_hash()) {
+      continue;
+    }
+    if (!same_shallow(*a, *b)) {
+      changes.push_back({CSTChangeKind::Modified, a, b});
+      continue;
+    }
+
+    children.clear();
+    align_children(a->get_children(), b->get_children(), children);
+    stack.insert(stack.end(), children.rbegin(), children.rend());
+  }
+  return changes;
+}
+
+} // namespace czc::cst
@@ -6,117 +6,251 @@
  */
 
 #include "czc/cst/cst_node.hpp"
+#include "czc/cst/cst_node_traits.hpp"
+#include "czc/utils/hash.hpp"
+#include "czc/utils/source_manager.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <utility>
 
 namespace czc::cst {
 
+namespace {
+
+// 当前线程活动的 CST Arena。
+thread_local utils::Arena* active_arena = nullptr;
+
+// 每个节点前的分配头，记录节点来自全局堆还是 Arena。
+// NOTE: 头部占满一个 max_align_t，保证其后的节点本身仍然满足最大对齐。
+constexpr size_t NODE_HEADER_SIZE = alignof(std::max_align_t);
+
+enum class NodeStorage : uint8_t { Heap, Arena };
+
+/**
+ * @brief 在子节点的哈希都已缓存时计算 `node` 自己的结构哈希。
+ */
+uint64_t hash_node(const CSTNode& node) noexcept {
+  using utils::fnv1a;
+  using utils::hash_combine;
+  uint64_t hash = hash_combine(utils::FNV_OFFSET_BASIS,
+                               static_cast<uint64_t>(node.get_type()));
+  if (const auto& token = node.get_token()) {
+    hash = hash_combine(hash, static_cast<uint64_t>(token->token_type) + 1);
+    hash = hash_combine(hash, token->is_synthetic);
+    hash = hash_combine(hash, fnv1a(token->value));
+    hash = hash_combine(hash, fnv1a(token->raw_literal));
+  }
+  hash = hash_combine(hash, node.get_children().size());
+  for (const auto& child : node.get_children()) {
+    hash = hash_combine(hash, child ? child->get_structural_hash() : 0);
+  }
+  // 0 保留给“尚未计算”。
+  return hash != 0 ? hash : 1;
+}
+
+} // namespace
+
 CSTNode::CSTNode(CSTNodeType type, const utils::SourceLocation& location)
-    : node_type(type), location(location), children(), token() {}
+    : node_type(type), location(location),
+      children(CSTChildList::allocator_type(active_arena)), token() {}
+
+CSTNode::~CSTNode() {
+  // 只有叶子子节点时直接交给 `children` 析构，不必搭建显式栈。
+  bool has_grandchildren = false;
+  for (const auto& child : children) {
+    if (child && !child->children.empty()) {
+      has_grandchildren = true;
+      break;
+    }
+  }
+  if (!has_grandchildren) {
+    return;
+  }
+
+  // NOTE: 先把子节点的子节点搬到显式栈上，再析构子节点本身，
+  //       这样每次析构都只面对已清空的子节点列表，递归深度恒为 1。
+  std::vector<std::unique_ptr<CSTNode>> pending;
+  for (auto& child : children) {
+    pending.push_back(std::move(child));
+  }
+  children.clear();
+
+  while (!pending.empty()) {
+    std::unique_ptr<CSTNode> node = std::move(pending.back());
+    pending.pop_back();
+    if (!node) {
+      continue;
+    }
+    for (auto& child : node->children) {
+      pending.push_back(std::move(child));
+    }
+    node->children.clear();
+  }
+}
+
+void* CSTNode::operator new(size_t size) {
+  size_t total = size + NODE_HEADER_SIZE;
+  NodeStorage storage = active_arena ? NodeStorage::Arena : NodeStorage::Heap;
+  auto* base = static_cast<std::byte*>(
+      active_arena ? active_arena->allocate(total) : ::operator new(total));
+  std::memcpy(base, &storage, sizeof(storage));
+  return base + NODE_HEADER_SIZE;
+}
+
+void CSTNode::operator delete(void* ptr, size_t /*size*/) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto* base = static_cast<std::byte*>(ptr) - NODE_HEADER_SIZE;
+  NodeStorage storage;
+  std::memcpy(&storage, base, sizeof(storage));
+  if (storage == NodeStorage::Heap) {
+    ::operator delete(base);
+  }
+}
+
+CSTArenaScope::CSTArenaScope(utils::Arena& arena) noexcept
+    : previous(active_arena) {
+  active_arena = &arena;
+}
+
+CSTArenaScope::~CSTArenaScope() {
+  active_arena = previous;
+}
+
+utils::Arena* CSTArenaScope::get_active_arena() noexcept {
+  return active_arena;
+}
+
+CSTArenaRoot::CSTArenaRoot(CSTNodeType type,
+                           const utils::SourceLocation& location,
+                           size_t initial_block_size)
+    : CSTNode(type, location) {
+  arenas.push_back(std::make_unique<utils::Arena>(initial_block_size));
+}
+
+CSTArenaRoot::~CSTArenaRoot() {
+  // NOTE: 成员 `arenas` 会先于基类的 `children` 析构，
+  //       因此必须在这里提前析构所有子孙节点。
+  children.clear();
+}
+
+void CSTArenaRoot::adopt_children(CSTArenaRoot& other) {
+  for (auto& child : other.children) {
+    children.emplace_back(std::move(child));
+  }
+  other.children.clear();
+  structural_hash = 0;
+  other.structural_hash = 0;
+  for (auto& arena : other.arenas) {
+    arenas.push_back(std::move(arena));
+  }
+  other.arenas.clear();
+}
 
 void CSTNode::add_child(std::unique_ptr<CSTNode> child) {
   // NOTE: 使用 emplace_back 和 std::move 可以最高效地将 unique_ptr 的所有权
   //       转移到 vector 中，避免了不必要的内存分配或拷贝操作。
   children.emplace_back(std::move(child));
+  structural_hash = 0;
 }
 
 void CSTNode::set_token(const lexer::Token& tok) {
   token = tok;
+  structural_hash = 0;
+}
+
+void CSTNode::set_token(lexer::Token&& tok) {
+  token = std::move(tok);
+  structural_hash = 0;
 }
 
 std::string cst_node_type_to_string(CSTNodeType type) {
-  switch (type) {
-  case CSTNodeType::Program:
-    return "Program";
-  case CSTNodeType::VarDeclaration:
-    return "VarDeclaration";
-  case CSTNodeType::FnDeclaration:
-    return "FnDeclaration";
-  case CSTNodeType::StructDeclaration:
-    return "StructDeclaration";
-  case CSTNodeType::TypeAliasDeclaration:
-    return "TypeAliasDeclaration";
-  case CSTNodeType::ReturnStmt:
-    return "ReturnStmt";
-  case CSTNodeType::IfStmt:
-    return "IfStmt";
-  case CSTNodeType::WhileStmt:
-    return "WhileStmt";
-  case CSTNodeType::BlockStmt:
-    return "BlockStmt";
-  case CSTNodeType::ExprStmt:
-    return "ExprStmt";
-  case CSTNodeType::BinaryExpr:
-    return "BinaryExpr";
-  case CSTNodeType::UnaryExpr:
-    return "UnaryExpr";
-  case CSTNodeType::CallExpr:
-    return "CallExpr";
-  case CSTNodeType::IndexExpr:
-    return "IndexExpr";
-  case CSTNodeType::MemberExpr:
-    return "MemberExpr";
-  case CSTNodeType::AssignExpr:
-    return "AssignExpr";
-  case CSTNodeType::IndexAssignExpr:
-    return "IndexAssignExpr";
-  case CSTNodeType::MemberAssignExpr:
-    return "MemberAssignExpr";
-  case CSTNodeType::ArrayLiteral:
-    return "ArrayLiteral";
-  case CSTNodeType::TupleLiteral:
-    return "TupleLiteral";
-  case CSTNodeType::FunctionLiteral:
-    return "FunctionLiteral";
-  case CSTNodeType::StructLiteral:
-    return "StructLiteral";
-  case CSTNodeType::IntegerLiteral:
-    return "IntegerLiteral";
-  case CSTNodeType::FloatLiteral:
-    return "FloatLiteral";
-  case CSTNodeType::StringLiteral:
-    return "StringLiteral";
-  case CSTNodeType::BooleanLiteral:
-    return "BooleanLiteral";
-  case CSTNodeType::Identifier:
-    return "Identifier";
-  case CSTNodeType::ParenExpr:
-    return "ParenExpr";
-  case CSTNodeType::TypeAnnotation:
-    return "TypeAnnotation";
-  case CSTNodeType::ArrayType:
-    return "ArrayType";
-  case CSTNodeType::SizedArrayType:
-    return "SizedArrayType";
-  case CSTNodeType::UnionType:
-    return "UnionType";
-  case CSTNodeType::IntersectionType:
-    return "IntersectionType";
-  case CSTNodeType::NegationType:
-    return "NegationType";
-  case CSTNodeType::TupleType:
-    return "TupleType";
-  case CSTNodeType::FunctionSignatureType:
-    return "FunctionSignatureType";
-  case CSTNodeType::AnonymousStructType:
-    return "AnonymousStructType";
-  case CSTNodeType::StructField:
-    return "StructField";
-  case CSTNodeType::Parameter:
-    return "Parameter";
-  case CSTNodeType::ParameterList:
-    return "ParameterList";
-  case CSTNodeType::ArgumentList:
-    return "ArgumentList";
-  case CSTNodeType::StatementList:
-    return "StatementList";
-  case CSTNodeType::Operator:
-    return "Operator";
-  case CSTNodeType::Delimiter:
-    return "Delimiter";
-  case CSTNodeType::Comment:
-    return "Comment";
-  default:
+  auto index = static_cast<size_t>(type);
+  if (index >= CST_NODE_TRAITS.size()) {
     return "Unknown";
   }
+  return std::string(CST_NODE_TRAITS[index].name);
+}
+
+CSTMemoryStats measure_memory(const CSTNode* root) {
+  CSTMemoryStats stats;
+  std::vector<const CSTNode*> pending;
+  if (root != nullptr) {
+    pending.push_back(root);
+  }
+  while (!pending.empty()) {
+    const CSTNode* node = pending.back();
+    pending.pop_back();
+    ++stats.node_count;
+    stats.node_bytes += sizeof(CSTNode);
+    const CSTChildList& children = node->get_children();
+    stats.children_size += children.size();
+    stats.children_capacity += children.capacity();
+    if (node->get_token()) {
+      stats.token_text_bytes += lexer::get_heap_bytes(*node->get_token());
+    }
+    for (const auto& child : children) {
+      if (child) {
+        pending.push_back(child.get());
+      }
+    }
+  }
+  return stats;
+}
+
+void shift_positions(std::vector<CSTNode*> pending,
+                     const PositionShift& shift) {
+  while (!pending.empty()) {
+    CSTNode* node = pending.back();
+    pending.pop_back();
+    shift.apply(node->location);
+    if (node->token) {
+      shift.apply(*node->token);
+    }
+    for (const auto& child : node->children) {
+      if (child) {
+        pending.push_back(child.get());
+      }
+    }
+  }
+}
+
+uint64_t compute_structural_hash(const CSTNode* root) {
+  if (root == nullptr) {
+    return 0;
+  }
+
+  // 后序遍历：栈帧记录下一个待检查的子节点，子节点全部就绪后才计算本节点。
+  struct Frame {
+    const CSTNode* node;
+    size_t next_child;
+  };
+  std::vector<Frame> stack;
+  if (root->structural_hash == 0) {
+    stack.push_back({root, 0});
+  }
+  while (!stack.empty()) {
+    Frame& frame = stack.back();
+    const CSTChildList& children = frame.node->children;
+    while (frame.next_child < children.size()) {
+      const CSTNode* child = children[frame.next_child].get();
+      if (child != nullptr && child->structural_hash == 0) {
+        break;
+      }
+      ++frame.next_child;
+    }
+    if (frame.next_child < children.size()) {
+      // NOTE: push_back 可能使 `frame` 失效，此后不再使用它。
+      stack.push_back({children[frame.next_child].get(), 0});
+      continue;
+    }
+    frame.node->structural_hash = hash_node(*frame.node);
+    stack.pop_back();
+  }
+  return root->structural_hash;
 }
 
 std::unique_ptr<CSTNode> make_cst_node(CSTNodeType type,
@@ -127,8 +261,9 @@ std::unique_ptr<CSTNode> make_cst_node(CSTNodeType type,
 std::unique_ptr<CSTNode> make_cst_node(CSTNodeType type,
                                        const lexer::Token& token) {
   // NOTE: 从 Token 创建 CST 节点时，我们只关心其起始位置。
-  //       文件名此时未知，因此留空，将在更高层级的组件中填充。
-  auto location = utils::SourceLocation("", token.line, token.column);
+  //       文件名此时未知，因此使用预先登记的空文件名。
+  auto location = utils::SourceLocation(utils::SourceManager::UNKNOWN_FILE,
+                                        token.line, token.column);
   auto node = std::make_unique<CSTNode>(type, location);
   node->set_token(token);
   return node;
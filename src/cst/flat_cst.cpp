@@ -0,0 +1,85 @@
+/**
+ * @file flat_cst.cpp
+ * @brief `FlatCST` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/cst/flat_cst.hpp"
+
+namespace czc::cst {
+
+namespace {
+
+/**
+ * @brief 转换过程中尚未处理完子节点的一个祖先节点。
+ */
+struct PendingFlatNode {
+  const CSTNode* node;
+  uint32_t index;
+  // 下一个待处理的子节点序号。
+  size_t next_child;
+  // 已输出的最后一个子节点下标，用于链接兄弟节点。
+  uint32_t last_child;
+};
+
+} // namespace
+
+FlatCST FlatCST::from_tree(const CSTNode* root) {
+  FlatCST flat;
+  if (root == nullptr) {
+    return flat;
+  }
+  flat.filename = std::string(root->get_location().get_filename());
+
+  auto emit = [&flat](const CSTNode* node) {
+    auto index = static_cast<uint32_t>(flat.nodes.size());
+    uint32_t token_index = NO_TOKEN;
+    if (node->get_token().has_value()) {
+      token_index = static_cast<uint32_t>(flat.tokens.size());
+      flat.tokens.push_back(*node->get_token());
+    }
+    const auto& location = node->get_location();
+    flat.nodes.push_back({node->get_type(), NO_NODE, NO_NODE, index + 1,
+                          token_index, 0, location.line, location.column});
+    return index;
+  };
+
+  // NOTE: 用显式栈代替递归，深层嵌套的表达式不会耗尽调用栈。
+  std::vector<PendingFlatNode> stack;
+  stack.push_back({root, emit(root), 0, NO_NODE});
+
+  while (!stack.empty()) {
+    PendingFlatNode& top = stack.back();
+    const auto& children = top.node->get_children();
+
+    if (top.next_child == children.size()) {
+      flat.nodes[top.index].subtree_end =
+          static_cast<uint32_t>(flat.nodes.size());
+      stack.pop_back();
+      continue;
+    }
+
+    const CSTNode* child = children[top.next_child++].get();
+    if (child == nullptr) {
+      continue;
+    }
+
+    uint32_t child_index = emit(child);
+    FlatCSTNode& parent = flat.nodes[top.index];
+    if (top.last_child == NO_NODE) {
+      parent.first_child = child_index;
+    } else {
+      flat.nodes[top.last_child].next_sibling = child_index;
+    }
+    parent.child_count++;
+    top.last_child = child_index;
+
+    // `top` 在 push_back 后可能失效，此后不再使用。
+    stack.push_back({child, child_index, 0, NO_NODE});
+  }
+
+  return flat;
+}
+
+} // namespace czc::cst
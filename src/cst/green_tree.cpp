@@ -0,0 +1,382 @@
+/**
+ * @file green_tree.cpp
+ * @brief 绿树 `GreenNode`、`GreenCache` 与红树外观 `RedNode` 的实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/cst/green_tree.hpp"
+
+#include "czc/utils/hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace czc::cst {
+
+namespace {
+
+using utils::hash_combine;
+
+uint64_t hash_text(std::string_view text) noexcept {
+  return std::hash<std::string_view>{}(text);
+}
+
+bool same_token(const GreenToken& a, const GreenToken& b) noexcept {
+  return a.token.token_type == b.token.token_type &&
+         a.token.is_synthetic == b.token.is_synthetic &&
+         a.token.is_raw_string == b.token.is_raw_string &&
+         a.token.length == b.token.length && a.token.value == b.token.value &&
+         a.token.raw_literal == b.token.raw_literal && a.leading == b.leading &&
+         a.text == b.text;
+}
+
+/**
+ * @brief 一个 Token 在源码中占据的文本：前导文本的起点，以及原文是否
+ *        归它所有。
+ */
+struct TokenSpan {
+  size_t leading_begin = 0;
+  size_t leading_end = 0;
+  bool owns_text = false;
+};
+
+/**
+ * @brief 转换过程中尚未处理完子节点的一个祖先节点。
+ */
+struct PendingGreenNode {
+  const CSTNode* node;
+  // 下一个待处理的子节点序号。
+  size_t next_child;
+  std::optional<GreenToken> token;
+  // Token 的字节偏移量；虚拟 Token 为 `NO_OFFSET`
+  size_t token_offset;
+  // 子树中最靠前的 Token 偏移量
+  size_t first_offset;
+  std::vector<const GreenNode*> children;
+  // 各子节点子树中最靠前的 Token 偏移量
+  std::vector<size_t> child_offsets;
+};
+
+constexpr size_t NO_OFFSET = std::numeric_limits<size_t>::max();
+
+} // namespace
+
+TextExtent TextExtent::measure(std::string_view text) noexcept {
+  TextExtent extent{text.size(), 0, text.size()};
+  const char* data = text.data();
+  size_t cursor = 0;
+  while (cursor < text.size()) {
+    const void* hit = std::memchr(data + cursor, '\n', text.size() - cursor);
+    if (hit == nullptr) {
+      break;
+    }
+    cursor = static_cast<size_t>(static_cast<const char*>(hit) - data) + 1;
+    extent.lines++;
+    extent.tail = text.size() - cursor;
+  }
+  return extent;
+}
+
+GreenNode::GreenNode(CSTNodeType type, std::optional<GreenToken> token,
+                     size_t token_slot, std::vector<const GreenNode*> children)
+    : node_type(type), token(std::move(token)),
+      token_slot(std::min(token_slot, children.size())),
+      children(std::move(children)), hash(static_cast<uint64_t>(type)) {
+  TextExtent before;
+  TextExtent after;
+  for (size_t i = 0; i < this->children.size(); ++i) {
+    const GreenNode* child = this->children[i];
+    TextExtent& part = i < this->token_slot ? before : after;
+    part = part.then(child->extent);
+    hash = hash_combine(hash, child->hash);
+  }
+  extent = before;
+  if (this->token.has_value()) {
+    const GreenToken& green = *this->token;
+    extent = extent.then(green.leading_extent).then(green.text_extent);
+    hash = hash_combine(hash, static_cast<uint64_t>(green.token.token_type));
+    hash = hash_combine(hash, this->token_slot);
+    hash = hash_combine(hash, hash_text(green.token.value));
+    hash = hash_combine(hash, hash_text(green.leading));
+    hash = hash_combine(hash, hash_text(green.text));
+  }
+  extent = extent.then(after);
+}
+
+std::string GreenNode::to_text() const {
+  std::string text;
+  text.reserve(extent.bytes);
+  // 栈中的每一项是一个节点，或（`token_of` 非空时）该节点的 Token。
+  struct Part {
+    const GreenNode* node;
+    const GreenToken* token_of;
+  };
+  std::vector<Part> pending{{this, nullptr}};
+  while (!pending.empty()) {
+    Part part = pending.back();
+    pending.pop_back();
+    if (part.token_of != nullptr) {
+      text += part.token_of->leading;
+      text += part.token_of->text;
+      continue;
+    }
+    // 逆序入栈，使 Token 与子节点按源码顺序输出。
+    const GreenNode* node = part.node;
+    for (size_t i = node->children.size() + 1; i-- > 0;) {
+      if (i == node->token_slot && node->token.has_value()) {
+        pending.push_back({node, &*node->token});
+      }
+      if (i > 0) {
+        pending.push_back({node->children[i - 1], nullptr});
+      }
+    }
+  }
+  return text;
+}
+
+bool GreenNode::same_as(const GreenNode& other) const noexcept {
+  if (node_type != other.node_type || hash != other.hash ||
+      token_slot != other.token_slot ||
+      token.has_value() != other.token.has_value() ||
+      children != other.children) {
+    return false;
+  }
+  return !token.has_value() || same_token(*token, *other.token);
+}
+
+const GreenNode* GreenCache::make_node(CSTNodeType type,
+                                       std::optional<GreenToken> token,
+                                       size_t token_slot,
+                                       std::vector<const GreenNode*> children) {
+  if (token.has_value()) {
+    token->token.line = 0;
+    token->token.column = 0;
+    token->token.offset = 0;
+    token->token.symbol = utils::Symbol();
+  }
+  GreenNode candidate(type, std::move(token), token_slot,
+                      std::move(children));
+  auto found = index.find(&candidate);
+  if (found != index.end()) {
+    hits++;
+    return *found;
+  }
+  nodes.push_back(std::make_unique<GreenNode>(std::move(candidate)));
+  const GreenNode* node = nodes.back().get();
+  index.insert(node);
+  return node;
+}
+
+const GreenNode* GreenCache::from_tree(const CSTNode* root,
+                                       std::string_view source) {
+  if (root == nullptr) {
+    return nullptr;
+  }
+
+  // 第一遍：按先序收集非虚拟 Token，再按源码顺序划分前导文本与原文。
+  // NOTE: 复合节点的 Token 可能排在先序中其子节点之后（如 `:` 先于字段名
+  //       记录在父节点上），也可能与子孙节点的 Token 相同，只有按偏移量
+  //       排序才能得到正确的源码顺序。
+  std::vector<const lexer::Token*> tokens;
+  std::vector<const CSTNode*> walk{root};
+  while (!walk.empty()) {
+    const CSTNode* node = walk.back();
+    walk.pop_back();
+    if (node->get_token().has_value()) {
+      tokens.push_back(&*node->get_token());
+    }
+    const auto& children = node->get_children();
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+      if (*it != nullptr) {
+        walk.push_back(it->get());
+      }
+    }
+  }
+
+  std::vector<size_t> order;
+  order.reserve(tokens.size());
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    const lexer::Token& token = *tokens[i];
+    if (!token.is_synthetic && token.offset <= source.size() &&
+        token.length <= source.size() - token.offset) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&tokens](size_t a, size_t b) {
+    return tokens[a]->offset < tokens[b]->offset;
+  });
+
+  std::vector<TokenSpan> spans(tokens.size());
+  size_t cursor = 0;
+  for (size_t k = 0; k < order.size(); ++k) {
+    const lexer::Token& token = *tokens[order[k]];
+    TokenSpan& span = spans[order[k]];
+    if (token.offset < cursor) {
+      // 与前面的原文重叠（错误恢复产生），不占文本。
+      span.leading_begin = span.leading_end = cursor;
+      continue;
+    }
+    span.leading_begin = cursor;
+    span.leading_end = token.offset;
+    cursor = token.offset;
+    // 偏移量相同的一组 Token 中，前导文本归第一个，原文归最后一个（最深）。
+    bool last_at_offset = k + 1 == order.size() ||
+                          tokens[order[k + 1]]->offset != token.offset;
+    if (last_at_offset) {
+      span.owns_text = true;
+      cursor = token.offset + token.length;
+    }
+  }
+
+  // 第二遍：以同样的先序自底向上合并节点。
+  size_t next_token = 0;
+  auto enter = [&](const CSTNode* node) {
+    PendingGreenNode pending{node, 0, std::nullopt, NO_OFFSET,
+                             NO_OFFSET, {}, {}};
+    pending.children.reserve(node->get_children().size());
+    pending.child_offsets.reserve(node->get_children().size());
+    if (!node->get_token().has_value()) {
+      return pending;
+    }
+    const lexer::Token& token = *node->get_token();
+    const TokenSpan& span = spans[next_token++];
+    GreenToken green{token, {}, {}, {}, {}};
+    green.leading = std::string(source.substr(
+        span.leading_begin, span.leading_end - span.leading_begin));
+    if (span.owns_text) {
+      green.text = std::string(source.substr(token.offset, token.length));
+    }
+    green.leading_extent = TextExtent::measure(green.leading);
+    green.text_extent = TextExtent::measure(green.text);
+    pending.token = std::move(green);
+    if (!token.is_synthetic) {
+      pending.token_offset = token.offset;
+      pending.first_offset = token.offset;
+    }
+    return pending;
+  };
+
+  // NOTE: 用显式栈代替递归，深层嵌套的表达式不会耗尽调用栈。
+  std::vector<PendingGreenNode> stack;
+  stack.push_back(enter(root));
+  const GreenNode* result = nullptr;
+
+  while (!stack.empty()) {
+    PendingGreenNode& top = stack.back();
+    const auto& children = top.node->get_children();
+
+    if (top.next_child == children.size()) {
+      size_t slot = 0;
+      while (slot < top.child_offsets.size() &&
+             top.child_offsets[slot] < top.token_offset) {
+        ++slot;
+      }
+      const GreenNode* node =
+          make_node(top.node->get_type(), std::move(top.token), slot,
+                    std::move(top.children));
+      size_t first_offset = top.first_offset;
+      stack.pop_back();
+      if (stack.empty()) {
+        result = node;
+      } else {
+        PendingGreenNode& parent = stack.back();
+        parent.children.push_back(node);
+        parent.child_offsets.push_back(first_offset);
+        parent.first_offset = std::min(parent.first_offset, first_offset);
+      }
+      continue;
+    }
+
+    const CSTNode* child = children[top.next_child++].get();
+    if (child == nullptr) {
+      continue;
+    }
+    // `top` 在 push_back 后可能失效，此后不再使用。
+    stack.push_back(enter(child));
+  }
+
+  return result;
+}
+
+std::optional<lexer::Token> RedNode::get_token() const {
+  const auto& green_token = green->get_token();
+  if (!green_token.has_value()) {
+    return std::nullopt;
+  }
+  TextPosition position = start;
+  const auto& children = green->get_children();
+  for (size_t i = 0; i < green->get_token_slot(); ++i) {
+    position = position.advance(children[i]->get_extent());
+  }
+  position = position.advance(green_token->leading_extent);
+
+  lexer::Token token = green_token->token;
+  token.line = position.line;
+  token.column = position.column;
+  if (!token.is_synthetic) {
+    token.offset = position.offset;
+  }
+  return token;
+}
+
+std::vector<RedNode> RedNode::get_children() const {
+  const auto& children = green->get_children();
+  std::vector<RedNode> result;
+  result.reserve(children.size());
+  TextPosition position = start;
+  for (size_t i = 0; i < children.size(); ++i) {
+    if (i == green->get_token_slot() && green->get_token().has_value()) {
+      const GreenToken& token = *green->get_token();
+      position = position.advance(token.leading_extent.then(token.text_extent));
+    }
+    result.emplace_back(children[i], position);
+    position = position.advance(children[i]->get_extent());
+  }
+  return result;
+}
+
+std::optional<RedNode> RedNode::find_token_at(size_t offset) const {
+  if (offset < start.offset || offset >= get_end().offset) {
+    return std::nullopt;
+  }
+
+  RedNode node = *this;
+  while (true) {
+    const GreenNode* current = node.green;
+    const auto& children = current->get_children();
+    TextPosition position = node.start;
+    const GreenNode* next = nullptr;
+
+    for (size_t i = 0; i <= children.size() && next == nullptr; ++i) {
+      if (i == current->get_token_slot() && current->get_token().has_value()) {
+        const GreenToken& token = *current->get_token();
+        position = position.advance(token.leading_extent);
+        if (offset < position.offset) {
+          return std::nullopt;
+        }
+        if (offset < position.offset + token.text_extent.bytes) {
+          return node;
+        }
+        position = position.advance(token.text_extent);
+      }
+      if (i < children.size()) {
+        if (offset < position.offset + children[i]->get_extent().bytes) {
+          next = children[i];
+          break;
+        }
+        position = position.advance(children[i]->get_extent());
+      }
+    }
+
+    if (next == nullptr) {
+      return std::nullopt;
+    }
+    node = RedNode(next, position);
+  }
+}
+
+} // namespace czc::cst
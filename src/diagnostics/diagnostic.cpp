@@ -7,40 +7,54 @@
 
 #include "czc/diagnostics/diagnostic.hpp"
 
+#include "czc/diagnostics/embedded_locales.hpp"
 #include "czc/utils/color.hpp"
+#include "czc/utils/source_tracker.hpp"
+#include "czc/utils/time_report.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <utility>
 
 #include <toml++/toml.h>
 
 using namespace czc::diagnostics;
 using namespace czc::utils;
 
-I18nMessages::I18nMessages(const std::string& locale) : current_locale(locale) {
+I18nMessages::I18nMessages(const std::string& locale)
+    : current_locale(locale) {}
+
+void I18nMessages::ensure_loaded() const {
+  if (loaded) {
+    return;
+  }
+  loaded = true;
+  CZC_TRACE_SPAN("load-locale", "diagnostics");
   // NOTE: 尝试加载用户指定的语言环境。如果失败（例如，文件不存在或格式错误），
   //       则立即回退到默认的 "en_US" 语言环境。这种“失败安全” (fail-safe)
   //       的设计确保了诊断系统在任何情况下都能正常工作，至少能提供英文的
   //       错误信息，从而增强了编译器的健壮性。
-  if (!load_from_file(locale)) {
-    load_from_file("en_US");
+  if (!load(current_locale)) {
+    load("en_US");
   }
 }
 
-bool I18nMessages::load_from_file(const std::string& locale) {
-  std::vector<std::string> search_paths;
-
-  // --- 建立本地化文件的搜索路径 ---
-  // NOTE: 采用多路径搜索策略是为了提高程序的灵活性和可移植性，使其能够
+bool I18nMessages::load(const std::string& locale) const {
+  // --- 建立本地化消息的搜索顺序 ---
+  // NOTE: 采用多来源的搜索策略是为了提高程序的灵活性和可移植性，使其能够
   //       适应不同的部署和开发环境。搜索顺序经过精心设计：
   //       1. 环境变量 (`ZERO_LOCALE_PATH`): 优先级最高，允许用户或构建系统
   //          在运行时动态指定本地化文件的位置，非常适合容器化或自定义安装。
-  //       2. 相对路径: 其次尝试相对于当前工作目录的常见路径，这覆盖了
-  //          大多数本地开发和标准构建输出的场景。
+  //       2. 编译进库的目录: 不访问文件系统，也不解析 TOML，命令行工具
+  //          每处理一个文件就启动一次时尤其重要。
+  //       3. 相对路径: 最后尝试相对于当前工作目录的常见路径，这覆盖了
+  //          未编译进库的新语言环境以及关闭 `CZC_EMBED_LOCALES` 的构建。
 
   // 1. 检查环境变量 `ZERO_LOCALE_PATH`
   const char* env_path = std::getenv("ZERO_LOCALE_PATH");
@@ -51,27 +65,52 @@ bool I18nMessages::load_from_file(const std::string& locale) {
         (base_path.back() == '/' || base_path.back() == '\\')) {
       base_path.pop_back();
     }
-    search_paths.push_back(base_path + "/" + locale + "/diagnostics.toml");
+    std::string path = base_path + "/" + locale + "/diagnostics.toml";
+    if (std::filesystem::exists(path)) {
+      return load_from_file(path);
+    }
   }
 
-  // 2. 添加相对于当前工作目录的常见相对路径
+  // 2. 编译进库的目录
+  if (load_embedded(locale)) {
+    return true;
+  }
+
+  // 3. 相对于当前工作目录的常见相对路径
+  std::vector<std::string> search_paths;
   search_paths.push_back("locales/" + locale + "/diagnostics.toml");
   search_paths.push_back("../locales/" + locale + "/diagnostics.toml");
   search_paths.push_back("../../locales/" + locale + "/diagnostics.toml");
 
-  // --- 查找并打开文件 ---
-  std::string filepath;
   for (const auto& path : search_paths) {
     if (std::filesystem::exists(path)) {
-      filepath = path;
-      break; // NOTE: 找到第一个有效文件后立即停止搜索，确保了搜索路径的优先级。
+      // NOTE: 找到第一个有效文件后立即停止搜索，确保了搜索路径的优先级。
+      return load_from_file(path);
     }
   }
 
-  if (filepath.empty()) {
-    return false; // 在所有搜索路径中都找不到文件。
+  return false; // 在所有搜索路径中都找不到文件。
+}
+
+bool I18nMessages::load_embedded(const std::string& locale) const {
+  const EmbeddedLocale* embedded = find_embedded_locale(locale);
+  if (embedded == nullptr) {
+    return false;
   }
 
+  clear_messages();
+  size_t loaded_count = 0;
+  for (size_t i = 0; i < embedded->message_count; ++i) {
+    const EmbeddedMessage& entry = embedded->messages[i];
+    if (add_message(entry.code,
+                    {entry.message, entry.help, entry.source})) {
+      loaded_count++;
+    }
+  }
+  return loaded_count > 0;
+}
+
+bool I18nMessages::load_from_file(const std::string& filepath) const {
   // --- 使用 tomlplusplus 解析 TOML 文件 ---
   // NOTE: 使用 tomlplusplus 库来解析 TOML 文件，这是一个现代化的、
   //       符合 TOML v1.0.0 标准的 C++17 头文件库。相比手写解析器，
@@ -80,7 +119,8 @@ bool I18nMessages::load_from_file(const std::string& locale) {
     toml::table tbl = toml::parse_file(filepath);
 
     // 在加载新文件之前，清空旧的消息映射表，这是支持动态语言切换的关键步骤。
-    messages.clear();
+    clear_messages();
+    size_t loaded_count = 0;
 
     // 遍历 TOML 文件中的所有表（每个诊断代码对应一个表）
     for (const auto& [key, value] : tbl) {
@@ -110,11 +150,14 @@ bool I18nMessages::load_from_file(const std::string& locale) {
         tmpl.source = *source;
       }
 
-      // 将模板存入映射表
-      messages[std::string(key)] = tmpl;
+      // NOTE: 键必须是诊断代码的字符串形式（如 "L0001"），
+      //       无法识别的键不对应任何诊断，直接跳过。
+      if (add_message(std::string(key), std::move(tmpl))) {
+        loaded_count++;
+      }
     }
 
-    return !messages.empty();
+    return loaded_count > 0;
 
   } catch (const toml::parse_error& err) {
     // NOTE: 如果解析失败（例如，TOML 格式错误），捕获异常并返回 false。
@@ -126,54 +169,142 @@ bool I18nMessages::load_from_file(const std::string& locale) {
   }
 }
 
+void I18nMessages::clear_messages() const {
+  for (auto& group : messages) {
+    group.clear();
+  }
+}
+
+bool I18nMessages::add_message(std::string_view key,
+                               MessageTemplate tmpl) const {
+  auto code = diagnostic_code_from_string(key);
+  if (!code) {
+    return false;
+  }
+
+  int code_num = static_cast<int>(*code);
+  auto& group = messages[static_cast<size_t>(code_num / CODE_GROUP_SPAN)];
+  size_t index = static_cast<size_t>(code_num % CODE_GROUP_SPAN);
+  if (group.size() <= index) {
+    group.resize(index + 1);
+  }
+  group[index].segments = split_placeholders(tmpl.message);
+  group[index].tmpl = std::move(tmpl);
+  group[index].loaded = true;
+  return true;
+}
+
 void I18nMessages::set_locale(const std::string& locale) {
+  // NOTE: 复用的引擎每处理一个文件都会设置一次语言环境，
+  //       未改变时保留已加载的消息。
+  if (locale == current_locale) {
+    return;
+  }
   current_locale = locale;
-  if (!load_from_file(locale)) {
-    load_from_file("en_US"); // Fallback to English
+  clear_messages();
+  loaded = false;
+}
+
+std::vector<I18nMessages::Segment>
+I18nMessages::split_placeholders(const std::string& message) {
+  std::vector<Segment> segments;
+  size_t text_begin = 0;
+  size_t pos = 0;
+  while ((pos = message.find('{', pos)) != std::string::npos) {
+    size_t digits = pos + 1;
+    size_t end = digits;
+    uint64_t arg = 0;
+    while (end < message.size() && end - digits < 9 && message[end] >= '0' &&
+           message[end] <= '9') {
+      arg = arg * 10 + static_cast<uint64_t>(message[end] - '0');
+      ++end;
+    }
+    bool valid = end > digits && end < message.size() &&
+                 message[end] == '}' &&
+                 (message[digits] != '0' || end == digits + 1);
+    if (!valid) {
+      ++pos;
+      continue;
+    }
+    if (pos > text_begin) {
+      segments.push_back({static_cast<uint32_t>(text_begin),
+                          static_cast<uint32_t>(pos - text_begin),
+                          LITERAL_SEGMENT});
+    }
+    segments.push_back({static_cast<uint32_t>(pos),
+                        static_cast<uint32_t>(end + 1 - pos),
+                        static_cast<uint32_t>(arg)});
+    pos = end + 1;
+    text_begin = pos;
+  }
+  if (text_begin < message.size()) {
+    segments.push_back({static_cast<uint32_t>(text_begin),
+                        static_cast<uint32_t>(message.size() - text_begin),
+                        LITERAL_SEGMENT});
   }
+  return segments;
+}
+
+const I18nMessages::CompiledMessage*
+I18nMessages::find(DiagnosticCode code) const {
+  ensure_loaded();
+  int code_num = static_cast<int>(code);
+  if (code_num < 0) {
+    return nullptr;
+  }
+  size_t group = static_cast<size_t>(code_num / CODE_GROUP_SPAN);
+  size_t index = static_cast<size_t>(code_num % CODE_GROUP_SPAN);
+  if (group >= CODE_GROUP_COUNT || index >= messages[group].size() ||
+      !messages[group][index].loaded) {
+    return nullptr;
+  }
+  return &messages[group][index];
 }
 
 const MessageTemplate& I18nMessages::get_message(DiagnosticCode code) const {
-  std::string code_str = diagnostic_code_to_string(code);
-  auto it = messages.find(code_str);
+  const CompiledMessage* compiled = find(code);
 
   // NOTE: 如果在消息映射中找不到对应的模板（例如，.toml 文件不完整或
   //       代码中新增了诊断码但忘记更新 .toml），我们不能让程序崩溃。
   //       返回一个静态的、通用的未知错误模板是一种健壮的错误处理方式，
   //       确保了即使在配置不完整的情况下，程序也能继续运行并提供有意义的
   //       （尽管是通用的）反馈。
-  if (it == messages.end()) {
+  if (compiled == nullptr) {
     static MessageTemplate unknown{"unknown error", "", "system"};
     return unknown;
   }
 
-  return it->second;
+  return compiled->tmpl;
 }
 
 std::string
 I18nMessages::format_message(DiagnosticCode code,
                              const std::vector<std::string>& args) const {
-  const auto& tmpl = get_message(code);
-  std::string result = tmpl.message;
-
-  // --- 替换占位符 {0}, {1}, ... ---
-  // 这是一个简单的模板替换逻辑。它会查找 `{0}`, `{1}` 等占位符，
-  // 并将它们替换为 `args` 向量中对应索引的字符串。
-  for (size_t i = 0; i < args.size(); ++i) {
-    std::string placeholder = "{" + std::to_string(i) + "}";
-    size_t pos = 0;
-    // NOTE: 这里使用循环来查找并替换所有出现的同一个占位符（例如，消息
-    //       `"{0} is not compatible with {0}"`）。在 `replace` 之后，
-    //       必须将搜索起始位置 `pos` 更新到被替换内容之后，以防止
-    //       当替换内容本身也包含占位符时（虽然不太可能，但仍是好的实践）
-    //       导致的无限循环。
-    while ((pos = result.find(placeholder, pos)) != std::string::npos) {
-      result.replace(pos, placeholder.length(), args[i]);
-      pos += args[i].length();
-    }
+  std::string result;
+  append_message(result, code, args);
+  return result;
+}
+
+void I18nMessages::append_message(std::string& out, DiagnosticCode code,
+                                  const std::vector<std::string>& args) const {
+  const CompiledMessage* compiled = find(code);
+  if (compiled == nullptr) {
+    out += get_message(code).message;
+    return;
   }
 
-  return result;
+  // --- 依次追加文本片段与参数 ---
+  // NOTE: 占位符在加载时已经拆分好，这里只是线性地拼接，同一个占位符
+  //       出现多次（例如 `"{0} is not compatible with {0}"`）也无需特殊处理；
+  //       参数本身包含的 `{n}` 不会再被替换。
+  std::string_view message = compiled->tmpl.message;
+  for (const Segment& segment : compiled->segments) {
+    if (segment.arg != LITERAL_SEGMENT && segment.arg < args.size()) {
+      out += args[segment.arg];
+    } else {
+      out.append(message.substr(segment.offset, segment.length));
+    }
+  }
 }
 
 std::string Diagnostic::format(const I18nMessages& i18n, bool use_color) const {
@@ -213,7 +344,8 @@ std::string Diagnostic::format(const I18nMessages& i18n, bool use_color) const {
 
   // --- 2. 打印源代码位置信息 ---
   // 示例: --> examples/test_unterminated.zero:1:1
-  if (!location.filename.empty()) {
+  std::string_view filename = location.get_filename();
+  if (!filename.empty()) {
     if (use_color) {
       oss << Color::Blue << Color::Bold;
     }
@@ -221,7 +353,7 @@ std::string Diagnostic::format(const I18nMessages& i18n, bool use_color) const {
     if (use_color) {
       oss << Color::Reset;
     }
-    oss << location.filename << ":" << location.line << ":" << location.column
+    oss << filename << ":" << location.line << ":" << location.column
         << "\n";
   }
 
@@ -261,7 +393,8 @@ std::string Diagnostic::format(const I18nMessages& i18n, bool use_color) const {
     }
 
     // 计算高亮标记前的空格数。
-    size_t spaces = location.column > 0 ? location.column - 1 : 0;
+    size_t column = caret_column > 0 ? caret_column : location.column;
+    size_t spaces = column > 0 ? column - 1 : 0;
     oss << std::string(spaces, ' ');
 
     // 计算高亮标记的长度。
@@ -271,6 +404,9 @@ std::string Diagnostic::format(const I18nMessages& i18n, bool use_color) const {
     size_t length = location.end_column > location.column
                         ? location.end_column - location.column
                         : 1;
+    if (caret_column > 0) {
+      length = caret_length;
+    }
     oss << std::string(length, '^');
     if (use_color) {
       oss << Color::Reset;
@@ -294,35 +430,252 @@ std::string Diagnostic::format(const I18nMessages& i18n, bool use_color) const {
   return oss.str();
 }
 
+void IDiagnosticReporter::report(DiagnosticLevel level, DiagnosticCode code,
+                                 const utils::SourceLocation& location,
+                                 const std::vector<std::string>& args) {
+  report(std::make_shared<Diagnostic>(level, code, location, args));
+}
+
+namespace {
+
+// 各模块诊断代码的前缀字母，下标为代码值 / 1000。
+constexpr std::string_view CODE_GROUP_PREFIXES = "LTPS";
+
+/**
+ * @brief 诊断代码所属的模块下标，未知模块归入最后一组。
+ */
+size_t code_group(DiagnosticCode code) {
+  size_t group = static_cast<size_t>(code) / 1000;
+  return group < CODE_GROUP_PREFIXES.size() ? group
+                                            : CODE_GROUP_PREFIXES.size();
+}
+
+bool in_groups(DiagnosticCode code, std::string_view code_prefixes) {
+  size_t group = code_group(code);
+  return group < CODE_GROUP_PREFIXES.size() &&
+         code_prefixes.find(CODE_GROUP_PREFIXES[group]) !=
+             std::string_view::npos;
+}
+
+} // namespace
+
 DiagnosticEngine::DiagnosticEngine(const std::string& locale)
     : i18n(std::make_shared<I18nMessages>(locale)) {}
 
-void DiagnosticEngine::report(std::shared_ptr<Diagnostic> diag) {
-  if (!diag) {
-    return;
-  }
-
+bool DiagnosticEngine::count(DiagnosticLevel level, DiagnosticCode code) {
   // 根据诊断的严重级别，增加相应的计数器。
   // 这是为了后续可以快速判断编译是否应该因错误而中止。
-  if (diag->get_level() == DiagnosticLevel::Error ||
-      diag->get_level() == DiagnosticLevel::Fatal) {
+  if (level == DiagnosticLevel::Error || level == DiagnosticLevel::Fatal) {
+    if (error_count >= error_limit) {
+      return false;
+    }
     error_count++;
-  } else if (diag->get_level() == DiagnosticLevel::Warning) {
+    group_error_counts[code_group(code)]++;
+  } else if (level == DiagnosticLevel::Warning) {
     warning_count++;
   }
+  return records.size() < max_retained;
+}
 
-  diagnostics.push_back(diag);
+void DiagnosticEngine::add_record(DiagnosticLevel level, DiagnosticCode code,
+                                  const utils::SourceLocation& location,
+                                  const std::string* first,
+                                  const std::string* last,
+                                  uint32_t source_line_index) {
+  DiagnosticRecord record;
+  record.level = level;
+  record.code = code;
+  record.file_id = location.file_id;
+  record.line = location.line;
+  record.column = location.column;
+  record.end_line = location.end_line;
+  record.end_column = location.end_column;
+  record.first_arg = static_cast<uint32_t>(arg_spans.size());
+  record.arg_count = static_cast<uint32_t>(last - first);
+  record.source_line_index = source_line_index;
+  for (const std::string* arg = first; arg != last; ++arg) {
+    arg_spans.push_back({static_cast<uint32_t>(arg_text.size()),
+                         static_cast<uint32_t>(arg->size())});
+    arg_text += *arg;
+  }
+  records.push_back(record);
+}
+
+void DiagnosticEngine::report(std::shared_ptr<Diagnostic> diag) {
+  if (!diag || !count(diag->get_level(), diag->get_code())) {
+    return;
+  }
+
+  uint32_t source_line_index = NO_SOURCE_LINE;
+  if (!diag->get_source_line().empty()) {
+    source_line_index = static_cast<uint32_t>(source_lines.size());
+    source_lines.push_back(diag->get_source_line());
+  }
+  const auto& args = diag->get_args();
+  add_record(diag->get_level(), diag->get_code(), diag->get_location(),
+             args.data(), args.data() + args.size(), source_line_index);
+}
+
+void DiagnosticEngine::report(DiagnosticLevel level, DiagnosticCode code,
+                              const utils::SourceLocation& location,
+                              const std::vector<std::string>& args) {
+  if (!count(level, code)) {
+    return;
+  }
+  add_record(level, code, location, args.data(), args.data() + args.size(),
+             NO_SOURCE_LINE);
+}
+
+void DiagnosticEngine::clear() noexcept {
+  records.clear();
+  arg_text.clear();
+  arg_spans.clear();
+  source_lines.clear();
+  source = nullptr;
+  error_count = 0;
+  warning_count = 0;
+  std::fill(std::begin(group_error_counts), std::end(group_error_counts), 0);
+}
+
+size_t DiagnosticEngine::get_memory_bytes() const noexcept {
+  size_t total = records.capacity() * sizeof(DiagnosticRecord) +
+                 arg_text.capacity() + arg_spans.capacity() * sizeof(ArgSpan) +
+                 source_lines.capacity() * sizeof(std::string);
+  for (const auto& line : source_lines) {
+    total += line.capacity();
+  }
+  return total;
+}
+
+Diagnostic DiagnosticEngine::make_diagnostic(
+    const DiagnosticRecord& record) const {
+  utils::SourceLocation location(record.file_id, record.line, record.column,
+                                 record.end_line, record.end_column);
+  std::vector<std::string> args;
+  args.reserve(record.arg_count);
+  for (uint32_t i = 0; i < record.arg_count; ++i) {
+    const ArgSpan& span = arg_spans[record.first_arg + i];
+    args.emplace_back(arg_text, span.offset, span.length);
+  }
+  return Diagnostic(record.level, record.code, location, std::move(args));
+}
+
+Diagnostic DiagnosticEngine::get_diagnostic(size_t index) const {
+  const DiagnosticRecord& record = records.at(index);
+  Diagnostic diag = make_diagnostic(record);
+  if (record.source_line_index != NO_SOURCE_LINE) {
+    diag.set_source_line(source_lines[record.source_line_index]);
+  } else if (source != nullptr) {
+    diag.set_source_line(source->get_source_line(record.line));
+  }
+  return diag;
+}
+
+size_t DiagnosticEngine::get_error_count(std::string_view code_prefixes) const {
+  size_t total = 0;
+  for (size_t group = 0; group < CODE_GROUP_PREFIXES.size(); ++group) {
+    if (code_prefixes.find(CODE_GROUP_PREFIXES[group]) !=
+        std::string_view::npos) {
+      total += group_error_counts[group];
+    }
+  }
+  return total;
 }
 
 void DiagnosticEngine::print_all(bool use_color) const {
-  for (const auto& diag : diagnostics) {
-    std::cerr << diag->format(*i18n, use_color);
+  print_all(std::cerr, use_color);
+}
+
+void DiagnosticEngine::print_all(std::ostream& os, bool use_color) const {
+  print_records(os, use_color, nullptr);
+  print_summary(os, error_count);
+}
+
+void DiagnosticEngine::print_all(std::ostream& os, bool use_color,
+                                 std::string_view code_prefixes) const {
+  print_records(os, use_color, &code_prefixes);
+  print_summary(os, get_error_count(code_prefixes));
+}
+
+void DiagnosticEngine::print_records(
+    std::ostream& os, bool use_color,
+    const std::string_view* code_prefixes) const {
+  // NOTE: 诊断在这里才逐条还原并渲染，源码行也在此时才提取。
+  std::vector<size_t> selected;
+  selected.reserve(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (code_prefixes == nullptr ||
+        in_groups(records[i].code, *code_prefixes)) {
+      selected.push_back(i);
+    }
+  }
+
+  // --- 批量换算需要从 `source` 提取源码行的记录 ---
+  // 每条记录占两个槽位：起始位置与结束位置。结束位置不在同一行时只用
+  // 起始位置，标记长度仍按字节列号计算。
+  std::vector<utils::ResolvedOffset> resolved;
+  std::vector<uint32_t> slot_of;
+  if (source != nullptr) {
+    std::vector<std::pair<size_t, uint32_t>> requests;
+    requests.reserve(selected.size() * 2);
+    for (size_t k = 0; k < selected.size(); ++k) {
+      const DiagnosticRecord& record = records[selected[k]];
+      if (record.source_line_index != NO_SOURCE_LINE) {
+        continue;
+      }
+      auto slot = static_cast<uint32_t>(k * 2);
+      requests.emplace_back(
+          source->line_column_to_offset(record.line, record.column), slot);
+      if (record.end_line == record.line &&
+          record.end_column > record.column) {
+        requests.emplace_back(source->line_column_to_offset(
+                                  record.end_line, record.end_column),
+                              slot + 1);
+      }
+    }
+    std::sort(requests.begin(), requests.end());
+
+    std::vector<size_t> offsets;
+    offsets.reserve(requests.size());
+    for (const auto& request : requests) {
+      offsets.push_back(request.first);
+    }
+    source->resolve_offsets(offsets, resolved);
+
+    constexpr uint32_t UNRESOLVED = std::numeric_limits<uint32_t>::max();
+    slot_of.assign(selected.size() * 2, UNRESOLVED);
+    for (size_t i = 0; i < requests.size(); ++i) {
+      slot_of[requests[i].second] = static_cast<uint32_t>(i);
+    }
   }
 
+  for (size_t k = 0; k < selected.size(); ++k) {
+    const DiagnosticRecord& record = records[selected[k]];
+    if (record.source_line_index != NO_SOURCE_LINE || source == nullptr ||
+        slot_of[k * 2] >= resolved.size()) {
+      os << get_diagnostic(selected[k]).format(*i18n, use_color);
+      continue;
+    }
+    const utils::ResolvedOffset& start = resolved[slot_of[k * 2]];
+    Diagnostic diag = make_diagnostic(record);
+    diag.set_source_line(std::string(start.line_text));
+    size_t length = record.end_column > record.column
+                        ? record.end_column - record.column
+                        : 1;
+    if (slot_of[k * 2 + 1] < resolved.size()) {
+      const utils::ResolvedOffset& end = resolved[slot_of[k * 2 + 1]];
+      length = std::max<size_t>(end.char_column - start.char_column, 1);
+    }
+    diag.set_caret(start.char_column, length);
+    os << diag.format(*i18n, use_color);
+  }
+}
+
+void DiagnosticEngine::print_summary(std::ostream& os, size_t errors) {
   // 在打印完所有详细的诊断信息后，如果存在错误，
   // 打印一个总结性的中止信息。
-  if (error_count > 0) {
-    std::cerr << "\nerror: aborting due to " << error_count << " previous error"
-              << (error_count > 1 ? "s" : "") << "\n";
+  if (errors > 0) {
+    os << "\nerror: aborting due to " << errors << " previous error"
+       << (errors > 1 ? "s" : "") << "\n";
   }
 }
@@ -7,8 +7,6 @@
 
 #include "czc/diagnostics/diagnostic_code.hpp"
 
-#include <iomanip>
-#include <sstream>
 
 namespace czc::diagnostics {
 
@@ -46,13 +44,54 @@ std::string diagnostic_code_to_string(DiagnosticCode code) {
   }
 
   // --- 格式化输出 ---
-  // NOTE: 使用 ostringstream 和 iomanip 操纵符（setw, setfill）是
-  //       C++ 中实现零填充数字格式化的标准且安全的方式。这确保了
-  //       所有的诊断代码（如 "L0001", "T0012"）都具有统一的视觉长度，
-  //       提高了可读性。
-  std::ostringstream oss;
-  oss << prefix << std::setw(4) << std::setfill('0') << offset;
-  return oss.str();
+  // NOTE: 偏移量总小于 1000，直接逐位写出四位零填充的数字，保证所有诊断
+  //       代码（如 "L0001", "T0012"）都具有统一的视觉长度，同时避免为每条
+  //       诊断构造一个 ostringstream。
+  std::string result(5, '0');
+  result[0] = prefix;
+  for (size_t i = 4; i > 0 && offset > 0; --i) {
+    result[i] = static_cast<char>('0' + offset % 10);
+    offset /= 10;
+  }
+  return result;
+}
+
+std::optional<DiagnosticCode>
+diagnostic_code_from_string(std::string_view text) {
+  if (text.size() != 5) {
+    return std::nullopt;
+  }
+
+  int base = 0;
+  switch (text[0]) {
+  case 'L':
+    base = 0;
+    break;
+  case 'T':
+    base = 1000;
+    break;
+  case 'P':
+    base = 2000;
+    break;
+  case 'S':
+    base = 3000;
+    break;
+  default:
+    return std::nullopt;
+  }
+
+  int offset = 0;
+  for (char c : text.substr(1)) {
+    if (c < '0' || c > '9') {
+      return std::nullopt;
+    }
+    offset = offset * 10 + (c - '0');
+  }
+  // 四位数字的偏移量不超过 999，超出的编号会落到下一个模块的区间。
+  if (offset == 0 || offset >= 1000) {
+    return std::nullopt;
+  }
+  return static_cast<DiagnosticCode>(base + offset);
 }
 
 } // namespace czc::diagnostics
@@ -0,0 +1,161 @@
+/**
+ * @file diagnostic_sink.cpp
+ * @brief `DiagnosticSink` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/diagnostics/diagnostic_sink.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace czc::diagnostics {
+
+namespace {
+
+// 下一个接收器的编号；0 表示线程局部缓存中的空槽位。
+std::atomic<uint64_t> next_sink_id{1};
+
+} // namespace
+
+DiagnosticSink::DiagnosticSink()
+    : id(next_sink_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+DiagnosticSink::~DiagnosticSink() {
+  Buffer* buffer = head.load(std::memory_order_acquire);
+  while (buffer != nullptr) {
+    Buffer* next = buffer->next;
+    delete buffer;
+    buffer = next;
+  }
+}
+
+DiagnosticSink::Buffer& DiagnosticSink::local_buffer() {
+  // NOTE: 每个线程缓存最近用过的几个接收器的缓冲区。被挤出缓存的接收器
+  //       再次使用时会登记一个新的缓冲区，合并时按序号排序，结果不受影响。
+  struct Slot {
+    uint64_t sink_id = 0;
+    Buffer* buffer = nullptr;
+  };
+  constexpr size_t CACHE_SLOTS = 4;
+  thread_local Slot slots[CACHE_SLOTS];
+  thread_local size_t next_slot = 0;
+
+  for (const Slot& slot : slots) {
+    if (slot.sink_id == id) {
+      return *slot.buffer;
+    }
+  }
+
+  auto* buffer = new Buffer();
+  buffer->next = head.load(std::memory_order_relaxed);
+  while (!head.compare_exchange_weak(buffer->next, buffer,
+                                     std::memory_order_release,
+                                     std::memory_order_relaxed)) {
+  }
+  slots[next_slot] = {id, buffer};
+  next_slot = (next_slot + 1) % CACHE_SLOTS;
+  return *buffer;
+}
+
+uint64_t DiagnosticSink::count(Buffer& buffer, DiagnosticLevel level) {
+  if (level == DiagnosticLevel::Error || level == DiagnosticLevel::Fatal) {
+    buffer.error_count.store(
+        buffer.error_count.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+  }
+  return next_sequence.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t DiagnosticSink::get_error_count() const noexcept {
+  size_t total = 0;
+  for (Buffer* buffer = head.load(std::memory_order_acquire);
+       buffer != nullptr; buffer = buffer->next) {
+    total += buffer->error_count.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void DiagnosticSink::Buffer::clear() {
+  entries.clear();
+  arg_text.clear();
+  arg_lengths.clear();
+  diagnostics.clear();
+}
+
+void DiagnosticSink::report(std::shared_ptr<Diagnostic> diag) {
+  if (!diag) {
+    return;
+  }
+  Buffer& buffer = local_buffer();
+  DiagnosticLevel level = diag->get_level();
+  buffer.entries.push_back({count(buffer, level), level, diag->get_code(),
+                            diag->get_location(), 0, 0, 0,
+                            static_cast<uint32_t>(buffer.diagnostics.size())});
+  buffer.diagnostics.push_back(std::move(diag));
+}
+
+void DiagnosticSink::report(DiagnosticLevel level, DiagnosticCode code,
+                            const utils::SourceLocation& location,
+                            const std::vector<std::string>& args) {
+  Buffer& buffer = local_buffer();
+  buffer.entries.push_back({count(buffer, level), level, code, location,
+                            static_cast<uint32_t>(buffer.arg_text.size()),
+                            static_cast<uint32_t>(buffer.arg_lengths.size()),
+                            static_cast<uint32_t>(args.size()),
+                            NO_DIAGNOSTIC});
+  for (const std::string& arg : args) {
+    buffer.arg_text += arg;
+    buffer.arg_lengths.push_back(static_cast<uint32_t>(arg.size()));
+  }
+}
+
+size_t DiagnosticSink::size() const noexcept {
+  size_t total = 0;
+  for (Buffer* buffer = head.load(std::memory_order_acquire);
+       buffer != nullptr; buffer = buffer->next) {
+    total += buffer->entries.size();
+  }
+  return total;
+}
+
+void DiagnosticSink::merge_into(DiagnosticEngine& engine) {
+  std::vector<std::pair<Buffer*, const Entry*>> entries;
+  entries.reserve(size());
+  for (Buffer* buffer = head.load(std::memory_order_acquire);
+       buffer != nullptr; buffer = buffer->next) {
+    for (const Entry& entry : buffer->entries) {
+      entries.emplace_back(buffer, &entry);
+    }
+  }
+  // 序号各不相同，排序结果唯一。
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+    if (a.second->location.file_id != b.second->location.file_id) {
+      return a.second->location.file_id < b.second->location.file_id;
+    }
+    return a.second->sequence < b.second->sequence;
+  });
+
+  std::vector<std::string> args;
+  for (const auto& [buffer, entry] : entries) {
+    if (entry->diagnostic_index != NO_DIAGNOSTIC) {
+      engine.report(std::move(buffer->diagnostics[entry->diagnostic_index]));
+      continue;
+    }
+    args.clear();
+    size_t offset = entry->arg_offset;
+    for (uint32_t i = 0; i < entry->arg_count; ++i) {
+      uint32_t length = buffer->arg_lengths[entry->first_arg + i];
+      args.emplace_back(buffer->arg_text, offset, length);
+      offset += length;
+    }
+    engine.report(entry->level, entry->code, entry->location, args);
+  }
+  for (Buffer* buffer = head.load(std::memory_order_acquire);
+       buffer != nullptr; buffer = buffer->next) {
+    buffer->clear();
+  }
+}
+
+} // namespace czc::diagnostics
@@ -0,0 +1,222 @@
+/**
+ * @file doc.cpp
+ * @brief `Document` 与文档排版器的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/doc.hpp"
+
+namespace czc::formatter {
+
+namespace {
+
+// 排版模式：平铺或断行。
+enum class Mode : uint8_t { Flat, Break };
+
+// 待输出的文档节点及其所处的缩进级别与模式。
+struct Command {
+  size_t level;
+  Mode mode;
+  DocId id;
+};
+
+/**
+ * @brief 判断 `next` 以平铺模式输出时能否放进剩余宽度。
+ * @details
+ *   先扫描 `next` 本身，再按出栈顺序扫描 `rest` 中尚未输出的内容，
+ *   遇到断行模式下的 line 即说明当前行在那里结束；若一直到文档末尾都
+ *   没有断行点，还要为 `reserved_tail` 留出位置。扫描在宽度耗尽时立即
+ *   停止，因此每次判断至多看一行的内容。
+ */
+bool fits(const Document& doc, Command next, const std::vector<Command>& rest,
+          long width, size_t reserved_tail, std::vector<Command>& scratch) {
+  scratch.clear();
+  scratch.push_back(next);
+  size_t rest_index = rest.size();
+
+  while (width >= 0) {
+    if (scratch.empty()) {
+      if (rest_index == 0) {
+        return width >= static_cast<long>(reserved_tail);
+      }
+      scratch.push_back(rest[--rest_index]);
+      continue;
+    }
+
+    Command command = scratch.back();
+    scratch.pop_back();
+    const Document::Node& node = doc.get_node(command.id);
+
+    switch (node.kind) {
+    case DocKind::Text:
+      width -= static_cast<long>(node.width);
+      break;
+    case DocKind::Line:
+      if (command.mode == Mode::Break) {
+        return true;
+      }
+      width -= 1;
+      break;
+    case DocKind::SoftLine:
+      if (command.mode == Mode::Break) {
+        return true;
+      }
+      break;
+    case DocKind::Concat:
+      for (uint32_t i = node.second; i > 0; --i) {
+        scratch.push_back(
+            {command.level, command.mode, doc.get_part(node, i - 1)});
+      }
+      break;
+    case DocKind::Group:
+    case DocKind::Nest:
+      scratch.push_back({command.level, command.mode, node.first});
+      break;
+    case DocKind::IfBreak:
+      scratch.push_back({command.level, command.mode,
+                         command.mode == Mode::Break ? node.first
+                                                     : node.second});
+      break;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+DocId Document::add(DocKind kind, uint32_t first, uint32_t second,
+                    uint32_t width) {
+  nodes.push_back({kind, first, second, width});
+  return static_cast<DocId>(nodes.size() - 1);
+}
+
+DocId Document::text(std::string_view content) {
+  auto offset = static_cast<uint32_t>(texts.size());
+  texts.append(content);
+  return add(DocKind::Text, offset, static_cast<uint32_t>(content.size()),
+             static_cast<uint32_t>(display_width(content)));
+}
+
+DocId Document::end_text() {
+  std::string_view content = std::string_view(texts).substr(pending_text);
+  return add(DocKind::Text, static_cast<uint32_t>(pending_text),
+             static_cast<uint32_t>(content.size()),
+             static_cast<uint32_t>(display_width(content)));
+}
+
+DocId Document::line() {
+  return add(DocKind::Line, 0, 0, 0);
+}
+
+DocId Document::softline() {
+  return add(DocKind::SoftLine, 0, 0, 0);
+}
+
+DocId Document::concat(std::initializer_list<DocId> items) {
+  auto first = static_cast<uint32_t>(parts.size());
+  parts.insert(parts.end(), items.begin(), items.end());
+  return add(DocKind::Concat, first, static_cast<uint32_t>(items.size()), 0);
+}
+
+DocId Document::concat(const std::vector<DocId>& items) {
+  auto first = static_cast<uint32_t>(parts.size());
+  parts.insert(parts.end(), items.begin(), items.end());
+  return add(DocKind::Concat, first, static_cast<uint32_t>(items.size()), 0);
+}
+
+DocId Document::group(DocId content) {
+  return add(DocKind::Group, content, 0, 0);
+}
+
+DocId Document::nest(DocId content) {
+  return add(DocKind::Nest, content, 0, 0);
+}
+
+DocId Document::if_break(DocId broken, DocId flat) {
+  return add(DocKind::IfBreak, broken, flat, 0);
+}
+
+void Document::clear() noexcept {
+  nodes.clear();
+  parts.clear();
+  texts.clear();
+}
+
+void print_document(const Document& doc, DocId root, const DocLayout& layout,
+                    std::string& out) {
+  std::vector<Command> commands;
+  std::vector<Command> scratch;
+  commands.push_back({layout.base_level, Mode::Break, root});
+  size_t column = layout.start_column;
+
+  while (!commands.empty()) {
+    Command command = commands.back();
+    commands.pop_back();
+    const Document::Node& node = doc.get_node(command.id);
+
+    switch (node.kind) {
+    case DocKind::Text:
+      out.append(doc.get_text(node));
+      column += node.width;
+      break;
+    case DocKind::Line:
+    case DocKind::SoftLine:
+      if (command.mode == Mode::Flat) {
+        if (node.kind == DocKind::Line) {
+          out.push_back(' ');
+          ++column;
+        }
+      } else {
+        out.push_back('\n');
+        for (size_t i = 0; i < command.level; ++i) {
+          out.append(layout.indent_text);
+        }
+        column = command.level * layout.indent_columns;
+      }
+      break;
+    case DocKind::Concat:
+      for (uint32_t i = node.second; i > 0; --i) {
+        commands.push_back(
+            {command.level, command.mode, doc.get_part(node, i - 1)});
+      }
+      break;
+    case DocKind::Group: {
+      // NOTE: 平铺组内的子组必然也平铺，只有断行模式下才需要判断。
+      Mode mode = Mode::Flat;
+      if (command.mode == Mode::Break) {
+        long remaining =
+            static_cast<long>(layout.max_width) - static_cast<long>(column);
+        Command flat{command.level, Mode::Flat, node.first};
+        if (!fits(doc, flat, commands, remaining, layout.reserved_tail,
+                  scratch)) {
+          mode = Mode::Break;
+        }
+      }
+      commands.push_back({command.level, mode, node.first});
+      break;
+    }
+    case DocKind::Nest:
+      commands.push_back({command.level + 1, command.mode, node.first});
+      break;
+    case DocKind::IfBreak:
+      commands.push_back({command.level, command.mode,
+                          command.mode == Mode::Break ? node.first
+                                                      : node.second});
+      break;
+    }
+  }
+}
+
+size_t display_width(std::string_view text) noexcept {
+  size_t width = 0;
+  for (char c : text) {
+    // UTF-8 的后续字节形如 10xxxxxx，不计入宽度。
+    if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+      ++width;
+    }
+  }
+  return width;
+}
+
+} // namespace czc::formatter
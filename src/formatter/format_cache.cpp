@@ -0,0 +1,137 @@
+/**
+ * @file format_cache.cpp
+ * @brief `FormatCache` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/format_cache.hpp"
+
+#include "czc/utils/hash.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace czc::formatter {
+
+namespace {
+
+// 缓存文件首行的标记，格式变化时递增其中的版本号。
+// NOTE: 版本 2 起每行为 `<哈希> <长度>`，版本 1 的缓存整体作废。
+constexpr std::string_view CACHE_HEADER = "czc-format-cache 2";
+
+uint64_t mix(uint64_t hash, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value >> (i * 8)) & 0xFF;
+    hash *= utils::FNV_PRIME;
+  }
+  return hash;
+}
+
+std::string to_hex(uint64_t value) {
+  char text[17];
+  std::snprintf(text, sizeof(text), "%016" PRIx64, value);
+  return text;
+}
+
+bool from_hex(const std::string& text, uint64_t& value) {
+  if (text.size() != 16) {
+    return false;
+  }
+  return std::sscanf(text.c_str(), "%16" SCNx64, &value) == 1;
+}
+
+bool from_decimal(const std::string& text, uint64_t& value) {
+  if (text.empty() || text.size() > 20 ||
+      text.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  return std::sscanf(text.c_str(), "%" SCNu64, &value) == 1;
+}
+
+} // namespace
+
+FormatCache::FormatCache(const FormatOptions& options,
+                         std::string_view version) {
+  uint64_t hash = hash_content(version);
+  hash = mix(hash, static_cast<uint64_t>(options.indent_style));
+  hash = mix(hash, options.indent_width);
+  hash = mix(hash, options.max_line_length);
+  hash = mix(hash, options.space_before_paren);
+  hash = mix(hash, options.space_after_comma);
+  hash = mix(hash, options.newline_before_brace);
+  fingerprint = hash;
+}
+
+bool FormatCache::load(const std::string& path) {
+  entries.clear();
+  std::ifstream input(path);
+  if (!input.is_open()) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(input, line) ||
+      line != std::string(CACHE_HEADER) + " " + to_hex(fingerprint)) {
+    return false;
+  }
+  while (std::getline(input, line)) {
+    Entry entry;
+    size_t space = line.find(' ');
+    if (space == std::string::npos ||
+        !from_hex(line.substr(0, space), entry.hash) ||
+        !from_decimal(line.substr(space + 1), entry.length)) {
+      entries.clear();
+      return false;
+    }
+    entries.insert(entry);
+  }
+  return true;
+}
+
+bool FormatCache::save(const std::string& path) const {
+  std::ofstream output(path, std::ios::binary | std::ios::trunc);
+  if (!output.is_open()) {
+    return false;
+  }
+
+  // 排序后写出，内容相同的缓存得到相同的文件。
+  std::vector<Entry> sorted(entries.begin(), entries.end());
+  std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) {
+    return a.hash != b.hash ? a.hash < b.hash : a.length < b.length;
+  });
+  output << CACHE_HEADER << ' ' << to_hex(fingerprint) << '\n';
+  for (const Entry& entry : sorted) {
+    output << to_hex(entry.hash) << ' ' << entry.length << '\n';
+  }
+  return static_cast<bool>(output);
+}
+
+bool FormatCache::contains(std::string_view content) const {
+  Entry entry = make_entry(content);
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.count(entry) != 0;
+}
+
+void FormatCache::insert(std::string_view content) {
+  Entry entry = make_entry(content);
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.insert(entry);
+}
+
+size_t FormatCache::EntryHash::operator()(const Entry& entry) const noexcept {
+  return static_cast<size_t>(utils::hash_combine(entry.hash, entry.length));
+}
+
+FormatCache::Entry FormatCache::make_entry(std::string_view content) noexcept {
+  return {content.size(), hash_content(content)};
+}
+
+uint64_t FormatCache::hash_content(std::string_view content) noexcept {
+  return utils::fnv1a(content);
+}
+
+} // namespace czc::formatter
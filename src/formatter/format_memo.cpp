@@ -0,0 +1,122 @@
+/**
+ * @file format_memo.cpp
+ * @brief `FormatMemo` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/format_memo.hpp"
+
+#include <cstring>
+
+namespace czc::formatter {
+
+namespace {
+
+// 两个哈希各自的初值与乘数，互不相关。
+constexpr uint64_t HASH_SEED = 14695981039346656037ull;
+constexpr uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t CHECK_SEED = 0x2545F4914F6CDD1Dull;
+constexpr uint64_t CHECK_MULTIPLIER = 0xC6A4A7935BD1E995ull;
+
+/**
+ * @brief 同时计算两个以 64 位字为单位混合的哈希。
+ * @details 文本每次读入 8 个字节，比逐字节的 FNV-1a 快得多；键要在每个
+ *          顶层声明上计算一次，不能比格式化本身更慢。
+ */
+class KeyBuilder {
+public:
+  void add_value(uint64_t value) noexcept {
+    hash = (hash ^ value) * HASH_MULTIPLIER;
+    hash ^= hash >> 32;
+    check = (check + value) * CHECK_MULTIPLIER;
+    check ^= check >> 29;
+  }
+
+  /**
+   * @brief 写入文本及其长度，相邻的两段文本不会混淆。
+   */
+  void add_text(std::string_view text) noexcept {
+    add_value(text.size());
+    size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+      uint64_t word;
+      std::memcpy(&word, text.data() + i, 8);
+      add_value(word);
+    }
+    if (i < text.size()) {
+      uint64_t word = 0;
+      std::memcpy(&word, text.data() + i, text.size() - i);
+      add_value(word);
+    }
+  }
+
+  [[nodiscard]] FormatMemoKey get() const noexcept {
+    return {hash, check};
+  }
+
+private:
+  uint64_t hash = HASH_SEED;
+  uint64_t check = CHECK_SEED;
+};
+
+} // namespace
+
+FormatMemoKey FormatMemo::make_key(std::string_view text,
+                                   const FormatOptions& options,
+                                   int indent_level) noexcept {
+  KeyBuilder builder;
+  builder.add_value(static_cast<uint64_t>(options.indent_style));
+  builder.add_value(options.indent_width);
+  builder.add_value(options.max_line_length);
+  builder.add_value((options.space_before_paren ? 1U : 0U) |
+                    (options.space_after_comma ? 2U : 0U) |
+                    (options.newline_before_brace ? 4U : 0U));
+  builder.add_value(static_cast<uint64_t>(indent_level));
+  builder.add_text(text);
+  return builder.get();
+}
+
+bool FormatMemo::lookup(const FormatMemoKey& key, std::string& out) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = entries.find(key);
+  if (it == entries.end()) {
+    misses++;
+    return false;
+  }
+  hits++;
+  out += it->second;
+  return true;
+}
+
+void FormatMemo::insert(const FormatMemoKey& key, std::string_view text) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (bytes + text.size() > max_bytes) {
+    return;
+  }
+  if (entries.try_emplace(key, text).second) {
+    bytes += text.size();
+  }
+}
+
+size_t FormatMemo::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+size_t FormatMemo::get_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return bytes;
+}
+
+size_t FormatMemo::get_hit_count() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return hits;
+}
+
+size_t FormatMemo::get_miss_count() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return misses;
+}
+
+} // namespace czc::formatter
@@ -6,162 +6,251 @@
  */
 
 #include "czc/formatter/formatter.hpp"
+#include "czc/utils/time_report.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdio>
-#include <sstream>
 
 namespace czc::formatter {
 
+namespace {
+
+// 一级缩进的宽度（字符数）。
+size_t indent_unit(const FormatOptions& options) {
+  return options.indent_style == IndentStyle::SPACES ? options.indent_width
+                                                     : 1;
+}
+
+// 缩进使用的字符。
+char indent_fill(const FormatOptions& options) {
+  return options.indent_style == IndentStyle::SPACES ? ' ' : '\t';
+}
+
+} // namespace
+
 Formatter::Formatter(const FormatOptions& options)
-    : options(options), error_collector(), indent_level(0) {}
+    : options(options), error_collector(), indent_level(0) {
+  // 预先准备 16 级缩进，常见代码的缩进不会再触发分配。
+  indent_cache.assign(16 * indent_unit(options), indent_fill(options));
+}
 
 std::string Formatter::format(const cst::CSTNode* root) {
+  std::string result;
   if (!root) {
-    return "";
+    return result;
   }
+  CZC_TIME_PHASE(Format);
   indent_level = 0;
+  inline_next_if = false;
   error_collector.clear();
-  return format_node(root);
+
+  // NOTE: 直接写入返回值，不经过内部缓冲区，也就不需要再复制一次。
+  out = &result;
+  sink = nullptr;
+  format_node(root);
+  out = nullptr;
+  CZC_COUNT(Format, Errors, error_collector.count());
+  return result;
 }
 
-std::string Formatter::format_node(const cst::CSTNode* node) {
-  if (!node) {
-    return "";
-  }
-
-  // 使用访问者模式分派到具体的 visit 方法
-  switch (node->get_type()) {
-  case cst::CSTNodeType::Program:
-    return visit_program(node);
-  case cst::CSTNodeType::VarDeclaration:
-    return visit_var_declaration(node);
-  case cst::CSTNodeType::FnDeclaration:
-    return visit_fn_declaration(node);
-  case cst::CSTNodeType::StructDeclaration:
-    return visit_struct_declaration(node);
-  case cst::CSTNodeType::TypeAliasDeclaration:
-    return visit_type_alias_declaration(node);
-  case cst::CSTNodeType::ReturnStmt:
-    return visit_return_stmt(node);
-  case cst::CSTNodeType::IfStmt:
-    return visit_if_stmt(node);
-  case cst::CSTNodeType::WhileStmt:
-    return visit_while_stmt(node);
-  case cst::CSTNodeType::BlockStmt:
-    return visit_block_stmt(node);
-  case cst::CSTNodeType::ExprStmt:
-    return visit_expr_stmt(node);
-  case cst::CSTNodeType::BinaryExpr:
-    return visit_binary_expr(node);
-  case cst::CSTNodeType::UnaryExpr:
-    return visit_unary_expr(node);
-  case cst::CSTNodeType::CallExpr:
-    return visit_call_expr(node);
-  case cst::CSTNodeType::IndexExpr:
-    return visit_index_expr(node);
-  case cst::CSTNodeType::MemberExpr:
-    return visit_member_expr(node);
-  case cst::CSTNodeType::AssignExpr:
-    return visit_assign_expr(node);
-  case cst::CSTNodeType::IndexAssignExpr:
-    return visit_index_assign_expr(node);
-  case cst::CSTNodeType::MemberAssignExpr:
-    return visit_member_assign_expr(node);
-  case cst::CSTNodeType::ArrayLiteral:
-    return visit_array_literal(node);
-  case cst::CSTNodeType::TupleLiteral:
-    return visit_tuple_literal(node);
-  case cst::CSTNodeType::FunctionLiteral:
-    return visit_function_literal(node);
-  case cst::CSTNodeType::StructLiteral:
-    return visit_struct_literal(node);
-  case cst::CSTNodeType::ParenExpr:
-    return visit_paren_expr(node);
-  case cst::CSTNodeType::IntegerLiteral:
-    return visit_integer_literal(node);
-  case cst::CSTNodeType::FloatLiteral:
-    return visit_float_literal(node);
-  case cst::CSTNodeType::StringLiteral:
-    return visit_string_literal(node);
-  case cst::CSTNodeType::BooleanLiteral:
-    return visit_boolean_literal(node);
-  case cst::CSTNodeType::Identifier:
-    return visit_identifier(node);
-  case cst::CSTNodeType::TypeAnnotation:
-    return visit_type_annotation(node);
-  case cst::CSTNodeType::ArrayType:
-    return visit_array_type(node);
-  case cst::CSTNodeType::SizedArrayType:
-    return visit_sized_array_type(node);
-  case cst::CSTNodeType::UnionType:
-    return visit_union_type(node);
-  case cst::CSTNodeType::IntersectionType:
-    return visit_intersection_type(node);
-  case cst::CSTNodeType::NegationType:
-    return visit_negation_type(node);
-  case cst::CSTNodeType::TupleType:
-    return visit_tuple_type(node);
-  case cst::CSTNodeType::FunctionSignatureType:
-    return visit_function_signature_type(node);
-  case cst::CSTNodeType::AnonymousStructType:
-    return visit_anonymous_struct_type(node);
-  case cst::CSTNodeType::StructField:
-    return visit_struct_field(node);
-  case cst::CSTNodeType::Parameter:
-    return visit_parameter(node);
-  case cst::CSTNodeType::ParameterList:
-    return visit_parameter_list(node);
-  case cst::CSTNodeType::ArgumentList:
-    return visit_argument_list(node);
-  case cst::CSTNodeType::StatementList:
-    return visit_statement_list(node);
-  case cst::CSTNodeType::Operator:
-    return visit_operator(node);
-  case cst::CSTNodeType::Delimiter:
-    return visit_delimiter(node);
-  case cst::CSTNodeType::Comment:
-    return visit_comment(node);
-  default:
-    // 未处理的节点类型，递归格式化子节点
-    std::ostringstream result;
-    for (const auto& child : node->get_children()) {
-      result << format_node(child.get());
+void Formatter::format_to(const cst::CSTNode* root, OutputSink& sink) {
+  if (!root) {
+    return;
+  }
+  CZC_TIME_PHASE(Format);
+  indent_level = 0;
+  inline_next_if = false;
+  error_collector.clear();
+
+  buffer.clear();
+  out = &buffer;
+  this->sink = &sink;
+  format_node(root);
+  flush_to_sink(true);
+  this->sink = nullptr;
+  out = nullptr;
+  CZC_COUNT(Format, Errors, error_collector.count());
+}
+
+bool Formatter::is_formatted(const cst::CSTNode* root,
+                             std::string_view source) {
+  if (!root) {
+    return source.empty();
+  }
+  // NOTE: 每个顶层声明之后都交给比较端，发现差异即可尽早停止。
+  CompareSink compare(source);
+  flush_threshold = 0;
+  format_to(root, compare);
+  flush_threshold = SINK_FLUSH_THRESHOLD;
+  return compare.matches();
+}
+
+void Formatter::flush_to_sink(bool force) {
+  if (sink == nullptr || buffer.empty()) {
+    return;
+  }
+  if (force || buffer.size() >= flush_threshold) {
+    sink->write(buffer);
+    // clear() 保留容量，后续声明继续复用同一块内存。
+    buffer.clear();
+  }
+}
+
+namespace {
+
+// 格式化一种节点的处理函数。
+using NodeHandler = void (*)(Formatter&, const cst::CSTNode*);
+
+struct NodeHandlerEntry {
+  cst::CSTNodeType type;
+  NodeHandler handler;
+};
+
+// NOTE: 以限定名调用 `Formatter::visit_*`，跳过虚函数表：分派只需按节点
+//       类型取一次表项再间接调用一次。
+#define CZC_HANDLER(type, visit)                                               \
+  {cst::CSTNodeType::type,                                                     \
+   [](Formatter& formatter, const cst::CSTNode* node) {                        \
+     formatter.Formatter::visit(node);                                         \
+   }}
+
+// 按节点类型排列的处理函数表，`format_node` 以枚举值直接索引。
+constexpr std::array<NodeHandlerEntry, cst::CST_NODE_TYPE_COUNT>
+    NODE_HANDLERS{{
+    CZC_HANDLER(Program, visit_program),
+    CZC_HANDLER(VarDeclaration, visit_var_declaration),
+    CZC_HANDLER(FnDeclaration, visit_fn_declaration),
+    CZC_HANDLER(StructDeclaration, visit_struct_declaration),
+    CZC_HANDLER(TypeAliasDeclaration, visit_type_alias_declaration),
+    CZC_HANDLER(ReturnStmt, visit_return_stmt),
+    CZC_HANDLER(IfStmt, visit_if_stmt),
+    CZC_HANDLER(WhileStmt, visit_while_stmt),
+    CZC_HANDLER(BlockStmt, visit_block_stmt),
+    CZC_HANDLER(ExprStmt, visit_expr_stmt),
+    CZC_HANDLER(BinaryExpr, visit_binary_expr),
+    CZC_HANDLER(UnaryExpr, visit_unary_expr),
+    CZC_HANDLER(CallExpr, visit_call_expr),
+    CZC_HANDLER(IndexExpr, visit_index_expr),
+    CZC_HANDLER(MemberExpr, visit_member_expr),
+    CZC_HANDLER(AssignExpr, visit_assign_expr),
+    CZC_HANDLER(IndexAssignExpr, visit_index_assign_expr),
+    CZC_HANDLER(MemberAssignExpr, visit_member_assign_expr),
+    CZC_HANDLER(ArrayLiteral, visit_array_literal),
+    CZC_HANDLER(TupleLiteral, visit_tuple_literal),
+    CZC_HANDLER(FunctionLiteral, visit_function_literal),
+    CZC_HANDLER(StructLiteral, visit_struct_literal),
+    CZC_HANDLER(IntegerLiteral, visit_integer_literal),
+    CZC_HANDLER(FloatLiteral, visit_float_literal),
+    CZC_HANDLER(StringLiteral, visit_string_literal),
+    CZC_HANDLER(BooleanLiteral, visit_boolean_literal),
+    CZC_HANDLER(Identifier, visit_identifier),
+    CZC_HANDLER(ParenExpr, visit_paren_expr),
+    CZC_HANDLER(TypeAnnotation, visit_type_annotation),
+    CZC_HANDLER(ArrayType, visit_array_type),
+    CZC_HANDLER(SizedArrayType, visit_sized_array_type),
+    CZC_HANDLER(UnionType, visit_union_type),
+    CZC_HANDLER(IntersectionType, visit_intersection_type),
+    CZC_HANDLER(NegationType, visit_negation_type),
+    CZC_HANDLER(TupleType, visit_tuple_type),
+    CZC_HANDLER(FunctionSignatureType, visit_function_signature_type),
+    CZC_HANDLER(AnonymousStructType, visit_anonymous_struct_type),
+    CZC_HANDLER(StructField, visit_struct_field),
+    CZC_HANDLER(Parameter, visit_parameter),
+    CZC_HANDLER(ParameterList, visit_parameter_list),
+    CZC_HANDLER(ArgumentList, visit_argument_list),
+    CZC_HANDLER(StatementList, visit_statement_list),
+    CZC_HANDLER(Operator, visit_operator),
+    CZC_HANDLER(Delimiter, visit_delimiter),
+    CZC_HANDLER(Comment, visit_comment),
+}};
+
+#undef CZC_HANDLER
+
+// 编译期校验处理函数表与枚举的顺序一致，漏项或错位都无法通过编译。
+constexpr bool node_handlers_in_order() {
+  for (size_t i = 0; i < NODE_HANDLERS.size(); ++i) {
+    if (static_cast<size_t>(NODE_HANDLERS[i].type) != i) {
+      return false;
     }
-    return result.str();
+  }
+  return true;
+}
+
+static_assert(node_handlers_in_order());
+
+} // namespace
+
+void Formatter::format_node(const cst::CSTNode* node) {
+  if (!node) {
+    return;
+  }
+
+  auto index = static_cast<size_t>(node->get_type());
+  if (index < NODE_HANDLERS.size()) {
+    NODE_HANDLERS[index].handler(*this, node);
+    return;
+  }
+  // 未知的节点类型，递归格式化子节点
+  for (const auto& child : node->get_children()) {
+    format_node(child.get());
   }
 }
 
-std::string Formatter::get_indent() const {
-  if (options.indent_style == IndentStyle::SPACES) {
-    return std::string(indent_level * options.indent_width, ' ');
-  } else {
-    return std::string(indent_level, '\t');
+std::string_view Formatter::get_indent() {
+  if (indent_level <= 0) {
+    return {};
   }
+  size_t width = static_cast<size_t>(indent_level) * indent_unit(options);
+  if (width > indent_cache.size()) {
+    // NOTE: 按倍数扩容，深层嵌套也只会分配对数次。
+    indent_cache.assign(std::max(width, indent_cache.size() * 2),
+                        indent_fill(options));
+  }
+  return std::string_view(indent_cache.data(), width);
 }
 
-std::string Formatter::format_inline_comment(const cst::CSTNode* comment) {
+void Formatter::format_inline_comment(const cst::CSTNode* comment) {
   if (!comment) {
-    return "";
+    return;
   }
-  std::ostringstream result;
-  result << TWO_WIDTH_SPACE_STRING;
+  emit(TWO_WIDTH_SPACE_STRING);
   if (comment->get_token().has_value()) {
-    result << comment->get_token()->value;
+    emit(comment->get_token()->value);
   }
-  return result.str();
 }
 
-std::string Formatter::format_standalone_comment(const cst::CSTNode* comment) {
+void Formatter::format_standalone_comment(const cst::CSTNode* comment) {
   if (!comment) {
-    return "";
+    return;
   }
-  std::ostringstream result;
-  result << get_indent();
+  emit(get_indent());
   if (comment->get_token().has_value()) {
-    result << comment->get_token()->value;
+    emit(comment->get_token()->value);
+  }
+  emit("\n");
+}
+
+void Formatter::format_trailing_comments(const cst::CSTNode* node) {
+  if (comments == nullptr) {
+    return;
+  }
+  for (const auto& comment : comments->trailing(node)) {
+    emit(TWO_WIDTH_SPACE_STRING);
+    emit(comment.value);
+  }
+}
+
+void Formatter::format_standalone_comments(const cst::CSTNode* node,
+                                           cst::CommentPlacement placement) {
+  if (comments == nullptr) {
+    return;
+  }
+  for (const auto& comment : comments->get(node, placement)) {
+    emit(get_indent());
+    emit(comment.value);
+    emit("\n");
   }
-  result << "\n";
-  return result.str();
 }
 
 } // namespace czc::formatter
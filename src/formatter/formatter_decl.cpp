@@ -9,41 +9,44 @@
 
 #include "czc/formatter/formatter.hpp"
 
-#include <sstream>
-
 namespace czc::formatter {
 
-std::string Formatter::visit_var_declaration(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_var_declaration(const cst::CSTNode* node) {
   // VarDeclaration: let a = b; // comment
-  result << get_indent();
+  emit(get_indent());
   for (size_t i = 0; i < node->get_children().size(); ++i) {
     const auto& child = node->get_children()[i];
 
     if (child->get_type() == cst::CSTNodeType::Comment) {
       // 行内注释前加两个空格
-      result << format_inline_comment(child.get());
+      format_inline_comment(child.get());
       continue;
     }
 
-    result << format_node(child.get());
+    const cst::CSTNode* next = i + 1 < node->get_children().size()
+                                   ? node->get_children()[i + 1].get()
+                                   : nullptr;
+    format_expression(child.get(), next);
 
     // 在关键字、标识符和值之间添加空格
-    if (i + 1 < node->get_children().size()) {
-      const auto& next = node->get_children()[i + 1];
+    if (next) {
       if (next->get_type() != cst::CSTNodeType::Delimiter ||
           (next->get_token().has_value() &&
            next->get_token()->token_type != lexer::TokenType::Semicolon)) {
-        result << ONE_WIDTH_SPACE_STRING;
+        emit(ONE_WIDTH_SPACE_STRING);
       }
     }
   }
-  result << "\n";
-  return result.str();
+  // NOTE: 树中的行内注释是分号后的兄弟节点，上面的循环会在它前面多输出
+  //       一个空格；表中的注释同样如此，两种树的输出保持一致。
+  if (comments != nullptr && !comments->trailing(node).empty()) {
+    emit(ONE_WIDTH_SPACE_STRING);
+  }
+  format_trailing_comments(node);
+  emit("\n");
 }
 
-std::string Formatter::visit_fn_declaration(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_fn_declaration(const cst::CSTNode* node) {
   // FnDeclaration: fn func_name(params) [-> return_type] { body }
   //
   // 结构解析：
@@ -56,7 +59,7 @@ std::string Formatter::visit_fn_declaration(const cst::CSTNode* node) {
   // - [TypeAnnotation - 返回类型（可选）]
   // - BlockStmt - 函数体
 
-  result << get_indent();
+  emit(get_indent());
 
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -67,13 +70,14 @@ std::string Formatter::visit_fn_declaration(const cst::CSTNode* node) {
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::Fn) {
           // fn 关键字后加空格
-          result << "fn" << ONE_WIDTH_SPACE_STRING;
+          emit("fn");
+          emit(ONE_WIDTH_SPACE_STRING);
         } else if (token->token_type == lexer::TokenType::LeftParen) {
           // 左括号紧跟函数名，不加空格
-          result << "(";
+          emit("(");
         } else if (token->token_type == lexer::TokenType::RightParen) {
           // 右括号
-          result << ")";
+          emit(")");
           // 检查下一个是否是箭头或代码块，如果是则需要加空格
           if (i + 1 < children.size()) {
             const auto& next = children[i + 1];
@@ -81,49 +85,47 @@ std::string Formatter::visit_fn_declaration(const cst::CSTNode* node) {
               const auto& next_token = next->get_token();
               if (next_token.has_value() &&
                   next_token->token_type == lexer::TokenType::Arrow) {
-                result << ONE_WIDTH_SPACE_STRING;
+                emit(ONE_WIDTH_SPACE_STRING);
               }
             } else if (next->get_type() == cst::CSTNodeType::BlockStmt) {
-              result << ONE_WIDTH_SPACE_STRING;
+              emit(ONE_WIDTH_SPACE_STRING);
             }
           }
         } else if (token->token_type == lexer::TokenType::Arrow) {
           // 箭头：-> 后面加空格
-          result << "->" << ONE_WIDTH_SPACE_STRING;
+          emit("->");
+          emit(ONE_WIDTH_SPACE_STRING);
         } else {
-          result << token->value;
+          emit(token->value);
         }
       }
     } else if (child->get_type() == cst::CSTNodeType::Identifier) {
       // 函数名
-      result << format_node(child.get());
+      format_node(child.get());
     } else if (child->get_type() == cst::CSTNodeType::ParameterList) {
       // 参数列表（不包含括号）
-      result << format_node(child.get());
+      format_node(child.get());
     } else if (child->get_type() == cst::CSTNodeType::TypeAnnotation ||
                child->get_type() == cst::CSTNodeType::ArrayType) {
       // 返回类型
-      result << format_node(child.get());
+      format_node(child.get());
       // 返回类型后面如果有代码块，加空格
       if (i + 1 < children.size() &&
           children[i + 1]->get_type() == cst::CSTNodeType::BlockStmt) {
-        result << ONE_WIDTH_SPACE_STRING;
+        emit(ONE_WIDTH_SPACE_STRING);
       }
     } else if (child->get_type() == cst::CSTNodeType::BlockStmt) {
       // 函数体（如果前面没加过空格，这里会被处理）
-      result << format_node(child.get());
+      format_node(child.get());
     } else {
       // 其他未预期的节点类型
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-
-  return result.str();
 }
 
-std::string Formatter::visit_struct_declaration(const cst::CSTNode* node) {
-  std::ostringstream result;
-  result << get_indent();
+void Formatter::visit_struct_declaration(const cst::CSTNode* node) {
+  emit(get_indent());
 
   // struct Name { field: Type, ... };
   for (size_t i = 0; i < node->get_children().size(); ++i) {
@@ -133,36 +135,43 @@ std::string Formatter::visit_struct_declaration(const cst::CSTNode* node) {
       const auto& token = child->get_token();
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::Struct) {
-          result << token->value << ONE_WIDTH_SPACE_STRING;
+          emit(token->value);
+          emit(ONE_WIDTH_SPACE_STRING);
         } else if (token->token_type == lexer::TokenType::LeftBrace) {
-          result << ONE_WIDTH_SPACE_STRING << token->value << "\n";
+          emit(ONE_WIDTH_SPACE_STRING);
+          emit(token->value);
+          emit("\n");
           indent_level++;
         } else if (token->token_type == lexer::TokenType::RightBrace) {
+          format_standalone_comments(node, cst::CommentPlacement::Dangling);
           indent_level--;
-          result << "\n" << get_indent() << token->value;
+          emit("\n");
+          emit(get_indent());
+          emit(token->value);
         } else if (token->token_type == lexer::TokenType::Semicolon) {
-          result << token->value << "\n";
+          emit(token->value);
+          emit("\n");
         } else if (token->token_type == lexer::TokenType::Comma) {
-          result << token->value << "\n";
+          emit(token->value);
+          emit("\n");
         } else {
-          result << format_node(child.get());
+          format_node(child.get());
         }
       }
     } else if (child->get_type() == cst::CSTNodeType::Identifier) {
-      result << format_node(child.get());
+      format_node(child.get());
     } else if (child->get_type() == cst::CSTNodeType::StructField) {
-      result << get_indent() << format_node(child.get());
+      format_standalone_comments(child.get(), cst::CommentPlacement::Leading);
+      emit(get_indent());
+      format_node(child.get());
     } else if (child->get_type() == cst::CSTNodeType::Comment) {
-      result << format_standalone_comment(child.get());
+      format_standalone_comment(child.get());
     }
   }
-
-  return result.str();
 }
 
-std::string Formatter::visit_type_alias_declaration(const cst::CSTNode* node) {
-  std::ostringstream result;
-  result << get_indent();
+void Formatter::visit_type_alias_declaration(const cst::CSTNode* node) {
+  emit(get_indent());
 
   // type Name = TypeExpr;
   for (size_t i = 0; i < node->get_children().size(); ++i) {
@@ -172,57 +181,54 @@ std::string Formatter::visit_type_alias_declaration(const cst::CSTNode* node) {
       const auto& token = child->get_token();
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::Type) {
-          result << token->value << ONE_WIDTH_SPACE_STRING;
+          emit(token->value);
+          emit(ONE_WIDTH_SPACE_STRING);
         } else if (token->token_type == lexer::TokenType::Equal) {
-          result << ONE_WIDTH_SPACE_STRING << token->value
-                 << ONE_WIDTH_SPACE_STRING;
+          emit(ONE_WIDTH_SPACE_STRING);
+          emit(token->value);
+          emit(ONE_WIDTH_SPACE_STRING);
         } else if (token->token_type == lexer::TokenType::Semicolon) {
-          result << token->value << "\n";
+          emit(token->value);
+          emit("\n");
         } else {
-          result << format_node(child.get());
+          format_node(child.get());
         }
       }
     } else if (child->get_type() == cst::CSTNodeType::Identifier) {
-      result << format_node(child.get());
+      format_node(child.get());
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-
-  return result.str();
 }
 
-std::string Formatter::visit_struct_field(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_struct_field(const cst::CSTNode* node) {
   // field: Type
   for (const auto& child : node->get_children()) {
     if (child->get_type() == cst::CSTNodeType::Delimiter) {
       const auto& token = child->get_token();
       if (token.has_value() && token->token_type == lexer::TokenType::Colon) {
-        result << token->value << ONE_WIDTH_SPACE_STRING;
+        emit(token->value);
+        emit(ONE_WIDTH_SPACE_STRING);
       } else {
-        result << format_node(child.get());
+        format_node(child.get());
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_parameter(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_parameter(const cst::CSTNode* node) {
   // Parameter: name or name: type
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
     const auto& child = children[i];
-    result << format_node(child.get());
+    format_node(child.get());
   }
-  return result.str();
 }
 
-std::string Formatter::visit_parameter_list(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_parameter_list(const cst::CSTNode* node) {
   // ParameterList: a, b, c (不包含括号)
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -230,26 +236,26 @@ std::string Formatter::visit_parameter_list(const cst::CSTNode* node) {
     if (child->get_type() == cst::CSTNodeType::Delimiter) {
       if (child->get_token().has_value() &&
           child->get_token()->token_type == lexer::TokenType::Comma) {
-        result << "," << ONE_WIDTH_SPACE_STRING;
+        emit(",");
+        emit(ONE_WIDTH_SPACE_STRING);
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_statement_list(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_statement_list(const cst::CSTNode* node) {
   // StatementList: 格式化块内的语句列表
   for (const auto& child : node->get_children()) {
     if (child->get_type() == cst::CSTNodeType::Comment) {
-      result << format_standalone_comment(child.get());
+      format_standalone_comment(child.get());
     } else {
-      result << format_node(child.get());
+      format_standalone_comments(child.get(), cst::CommentPlacement::Leading);
+      format_node(child.get());
     }
   }
-  return result.str();
+  format_standalone_comments(node, cst::CommentPlacement::Dangling);
 }
 
 } // namespace czc::formatter
\ No newline at end of file
@@ -0,0 +1,217 @@
+/**
+ * @file formatter_doc.cpp
+ * @brief 超长行的自动换行实现 (调用参数、数组字面量、二元运算链)
+ * @details 语句中的表达式照常平铺输出，只有一行超出 `max_line_length` 时
+ *          才转换为 `Document`，交给 `print_document` 决定断行位置。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/formatter.hpp"
+
+#include <algorithm>
+
+namespace czc::formatter {
+
+namespace {
+
+// 是否是自动换行可以拆开的表达式。
+bool is_wrappable(const cst::CSTNode* node) {
+  switch (node->get_type()) {
+  case cst::CSTNodeType::BinaryExpr:
+  case cst::CSTNodeType::CallExpr:
+  case cst::CSTNodeType::ArrayLiteral:
+  case cst::CSTNodeType::ParenExpr:
+  case cst::CSTNodeType::AssignExpr:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// 是否是给定类型的非虚拟分隔符。
+bool is_delimiter(const cst::CSTNode* node, lexer::TokenType type) {
+  return node->get_type() == cst::CSTNodeType::Delimiter &&
+         node->get_token().has_value() &&
+         node->get_token()->token_type == type;
+}
+
+// 行首一段文本占用的列数，制表符按一级缩进计。
+size_t prefix_columns(std::string_view text, size_t tab_columns) {
+  size_t tabs = static_cast<size_t>(std::count(text.begin(), text.end(), '\t'));
+  return display_width(text) - tabs + tabs * tab_columns;
+}
+
+} // namespace
+
+void Formatter::format_expression(const cst::CSTNode* node,
+                                  const cst::CSTNode* next) {
+  size_t start = out->size();
+  format_node(node);
+  if (options.max_line_length == 0 || building_doc || !is_wrappable(node)) {
+    return;
+  }
+
+  std::string_view written(*out);
+  std::string_view flat = written.substr(start);
+  // NOTE: 内含代码块（如函数字面量）的表达式已经跨行，保持原样。
+  if (flat.find('\n') != std::string_view::npos) {
+    return;
+  }
+
+  size_t line_begin = start == 0 ? 0 : written.rfind('\n', start - 1);
+  line_begin = line_begin == std::string_view::npos ? 0 : line_begin + 1;
+  size_t column = prefix_columns(
+      written.substr(line_begin, start - line_begin), options.indent_width);
+
+  size_t tail = 0;
+  if (next && next->get_type() == cst::CSTNodeType::Delimiter &&
+      next->get_token().has_value() && !next->get_token()->is_synthetic) {
+    tail = display_width(next->get_token()->value);
+  }
+
+  if (column + display_width(flat) + tail <= options.max_line_length) {
+    return;
+  }
+
+  // 超出行宽：撤销平铺输出，改为按文档重新排版。
+  out->resize(start);
+  doc.clear();
+  building_doc = true;
+  DocId root = build_doc(node);
+  building_doc = false;
+
+  DocLayout layout;
+  layout.max_width = options.max_line_length;
+  layout.indent_columns = options.indent_width;
+  layout.indent_text =
+      options.indent_style == IndentStyle::SPACES
+          ? std::string_view(indent_cache.data(), options.indent_width)
+          : std::string_view(indent_cache.data(), 1);
+  layout.base_level = indent_level > 0 ? static_cast<size_t>(indent_level) : 0;
+  layout.start_column = column;
+  layout.reserved_tail = tail;
+  print_document(doc, root, layout, *out);
+}
+
+DocId Formatter::build_doc(const cst::CSTNode* node) {
+  const auto& children = node->get_children();
+
+  switch (node->get_type()) {
+  case cst::CSTNodeType::BinaryExpr: {
+    // NOTE: 左结合的运算链（a + b + c）展开成同一个组，断行时每个运算符
+    //       后都换行并对齐到同一缩进，而不是逐层加深。
+    std::vector<const cst::CSTNode*> operands;
+    std::vector<const cst::CSTNode*> operators;
+    const cst::CSTNode* current = node;
+    while (current->get_type() == cst::CSTNodeType::BinaryExpr &&
+           current->get_children().size() == 3 &&
+           current->get_children()[1]->get_type() ==
+               cst::CSTNodeType::Operator) {
+      operators.push_back(current->get_children()[1].get());
+      operands.push_back(current->get_children()[2].get());
+      current = current->get_children()[0].get();
+    }
+    if (operators.empty()) {
+      return build_flat_doc(node);
+    }
+
+    std::vector<DocId> rest;
+    for (size_t i = operators.size(); i > 0; --i) {
+      rest.push_back(doc.text(ONE_WIDTH_SPACE_STRING));
+      rest.push_back(build_flat_doc(operators[i - 1]));
+      rest.push_back(doc.line());
+      rest.push_back(build_doc(operands[i - 1]));
+    }
+    return doc.group(
+        doc.concat({build_doc(current), doc.nest(doc.concat(rest))}));
+  }
+
+  case cst::CSTNodeType::CallExpr:
+    // callee ( ArgumentList )
+    if (children.size() == 4 &&
+        children[2]->get_type() == cst::CSTNodeType::ArgumentList) {
+      const auto& args = children[2]->get_children();
+      return doc.concat({build_doc(children[0].get()),
+                         build_flat_doc(children[1].get()),
+                         build_list_doc(args, 0, args.size()),
+                         build_flat_doc(children[3].get())});
+    }
+    return build_flat_doc(node);
+
+  case cst::CSTNodeType::ArrayLiteral:
+    // [ elements ]
+    if (children.size() >= 2 &&
+        is_delimiter(children.front().get(), lexer::TokenType::LeftBracket) &&
+        is_delimiter(children.back().get(), lexer::TokenType::RightBracket)) {
+      return doc.concat({build_flat_doc(children.front().get()),
+                         build_list_doc(children, 1, children.size() - 1),
+                         build_flat_doc(children.back().get())});
+    }
+    return build_flat_doc(node);
+
+  case cst::CSTNodeType::ParenExpr:
+    // ( expression )
+    if (children.size() == 3) {
+      return doc.concat({build_flat_doc(children[0].get()),
+                         build_doc(children[1].get()),
+                         build_flat_doc(children[2].get())});
+    }
+    return build_flat_doc(node);
+
+  case cst::CSTNodeType::AssignExpr:
+    // lvalue = rvalue
+    if (children.size() == 3 &&
+        children[1]->get_type() == cst::CSTNodeType::Operator) {
+      return doc.concat(
+          {build_doc(children[0].get()), doc.text(ONE_WIDTH_SPACE_STRING),
+           build_flat_doc(children[1].get()), doc.text(ONE_WIDTH_SPACE_STRING),
+           build_doc(children[2].get())});
+    }
+    return build_flat_doc(node);
+
+  default:
+    return build_flat_doc(node);
+  }
+}
+
+DocId Formatter::build_list_doc(const cst::CSTChildList& items, size_t begin,
+                                size_t end) {
+  if (begin >= end) {
+    return doc.concat({});
+  }
+
+  // ( softline item , line item ... ) softline
+  std::vector<DocId> parts;
+  parts.push_back(doc.softline());
+  for (size_t i = begin; i < end; ++i) {
+    const cst::CSTNode* item = items[i].get();
+    if (!is_delimiter(item, lexer::TokenType::Comma)) {
+      parts.push_back(build_doc(item));
+      continue;
+    }
+
+    parts.push_back(doc.text(","));
+    if (i + 1 == end) {
+      // 末尾的逗号：断行时右括号另起一行，平铺时保持原有的空格。
+      if (options.space_after_comma) {
+        parts.push_back(
+            doc.if_break(doc.concat({}), doc.text(ONE_WIDTH_SPACE_STRING)));
+      }
+    } else {
+      parts.push_back(options.space_after_comma ? doc.line() : doc.softline());
+    }
+  }
+  return doc.group(doc.concat({doc.nest(doc.concat(parts)), doc.softline()}));
+}
+
+DocId Formatter::build_flat_doc(const cst::CSTNode* node) {
+  // NOTE: 叶子节点直接格式化到文档的文本池中，不经过临时字符串。
+  std::string* saved = out;
+  out = &doc.begin_text();
+  format_node(node);
+  out = saved;
+  return doc.end_text();
+}
+
+} // namespace czc::formatter
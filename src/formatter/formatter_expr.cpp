@@ -9,46 +9,38 @@
 
 #include "czc/formatter/formatter.hpp"
 
-#include <sstream>
-
 namespace czc::formatter {
 
-std::string Formatter::visit_binary_expr(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_binary_expr(const cst::CSTNode* node) {
   // BinaryExpr: a + b
   for (size_t i = 0; i < node->get_children().size(); ++i) {
     const auto& child = node->get_children()[i];
 
     if (child->get_type() == cst::CSTNodeType::Operator) {
-      result << ONE_WIDTH_SPACE_STRING << format_node(child.get())
-             << ONE_WIDTH_SPACE_STRING;
+      emit(ONE_WIDTH_SPACE_STRING);
+      format_node(child.get());
+      emit(ONE_WIDTH_SPACE_STRING);
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_unary_expr(const cst::CSTNode* node) {
+void Formatter::visit_unary_expr(const cst::CSTNode* node) {
   // UnaryExpr: 简单地格式化所有子节点
-  std::ostringstream result;
   for (const auto& child : node->get_children()) {
-    result << format_node(child.get());
+    format_node(child.get());
   }
-  return result.str();
 }
 
-std::string Formatter::visit_call_expr(const cst::CSTNode* node) {
+void Formatter::visit_call_expr(const cst::CSTNode* node) {
   // CallExpr: 简单地格式化所有子节点
-  std::ostringstream result;
   for (const auto& child : node->get_children()) {
-    result << format_node(child.get());
+    format_node(child.get());
   }
-  return result.str();
 }
 
-std::string Formatter::visit_index_expr(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_index_expr(const cst::CSTNode* node) {
   // IndexExpr: array[index]
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -57,17 +49,15 @@ std::string Formatter::visit_index_expr(const cst::CSTNode* node) {
     if (child->get_type() == cst::CSTNodeType::Delimiter) {
       const auto& token = child->get_token();
       if (token.has_value()) {
-        result << token->value;
+        emit(token->value);
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_member_expr(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_member_expr(const cst::CSTNode* node) {
   // MemberExpr: object.member
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -76,19 +66,17 @@ std::string Formatter::visit_member_expr(const cst::CSTNode* node) {
     if (child->get_type() == cst::CSTNodeType::Operator) {
       const auto& token = child->get_token();
       if (token.has_value() && token->token_type == lexer::TokenType::Dot) {
-        result << ".";
+        emit(".");
       } else {
-        result << format_node(child.get());
+        format_node(child.get());
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_assign_expr(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_assign_expr(const cst::CSTNode* node) {
   // AssignExpr: lvalue = rvalue
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -97,19 +85,19 @@ std::string Formatter::visit_assign_expr(const cst::CSTNode* node) {
     if (child->get_type() == cst::CSTNodeType::Operator) {
       const auto& token = child->get_token();
       if (token.has_value() && token->token_type == lexer::TokenType::Equal) {
-        result << ONE_WIDTH_SPACE_STRING << "=" << ONE_WIDTH_SPACE_STRING;
+        emit(ONE_WIDTH_SPACE_STRING);
+        emit("=");
+        emit(ONE_WIDTH_SPACE_STRING);
       } else {
-        result << format_node(child.get());
+        format_node(child.get());
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_index_assign_expr(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_index_assign_expr(const cst::CSTNode* node) {
   // IndexAssignExpr: array[index] = value
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -118,19 +106,19 @@ std::string Formatter::visit_index_assign_expr(const cst::CSTNode* node) {
     if (child->get_type() == cst::CSTNodeType::Operator) {
       const auto& token = child->get_token();
       if (token.has_value() && token->token_type == lexer::TokenType::Equal) {
-        result << ONE_WIDTH_SPACE_STRING << "=" << ONE_WIDTH_SPACE_STRING;
+        emit(ONE_WIDTH_SPACE_STRING);
+        emit("=");
+        emit(ONE_WIDTH_SPACE_STRING);
       } else {
-        result << format_node(child.get());
+        format_node(child.get());
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_array_literal(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_array_literal(const cst::CSTNode* node) {
   // ArrayLiteral: [elem1, elem2, elem3]
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -140,69 +128,66 @@ std::string Formatter::visit_array_literal(const cst::CSTNode* node) {
       const auto& token = child->get_token();
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::LeftBracket) {
-          result << "[";
+          emit("[");
         } else if (token->token_type == lexer::TokenType::RightBracket) {
-          result << "]";
+          emit("]");
         } else if (token->token_type == lexer::TokenType::Comma) {
-          result << ",";
+          emit(",");
           if (options.space_after_comma) {
-            result << ONE_WIDTH_SPACE_STRING;
+            emit(ONE_WIDTH_SPACE_STRING);
           }
         } else {
-          result << token->value;
+          emit(token->value);
         }
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_tuple_literal(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_tuple_literal(const cst::CSTNode* node) {
   // TupleLiteral: (expr1, expr2, ...)
   for (const auto& child : node->get_children()) {
     if (child->get_type() == cst::CSTNodeType::Delimiter) {
       const auto& token = child->get_token();
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::Comma) {
-          result << "," << ONE_WIDTH_SPACE_STRING;
+          emit(",");
+          emit(ONE_WIDTH_SPACE_STRING);
         } else {
-          result << token->value;
+          emit(token->value);
         }
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_function_literal(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_function_literal(const cst::CSTNode* node) {
   // FunctionLiteral: fn (params) { body }
   for (const auto& child : node->get_children()) {
     if (child->get_type() == cst::CSTNodeType::Delimiter) {
       const auto& token = child->get_token();
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::Fn) {
-          result << token->value << ONE_WIDTH_SPACE_STRING;
+          emit(token->value);
+          emit(ONE_WIDTH_SPACE_STRING);
         } else {
-          result << format_node(child.get());
+          format_node(child.get());
         }
       }
     } else if (child->get_type() == cst::CSTNodeType::BlockStmt) {
-      result << ONE_WIDTH_SPACE_STRING << format_node(child.get());
+      emit(ONE_WIDTH_SPACE_STRING);
+      format_node(child.get());
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_struct_literal(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_struct_literal(const cst::CSTNode* node) {
 
   // TypeName { field: value, ... }
   for (size_t i = 0; i < node->get_children().size(); ++i) {
@@ -212,41 +197,46 @@ std::string Formatter::visit_struct_literal(const cst::CSTNode* node) {
       const auto& token = child->get_token();
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::LeftBrace) {
-          result << ONE_WIDTH_SPACE_STRING << token->value << "\n";
+          emit(ONE_WIDTH_SPACE_STRING);
+          emit(token->value);
+          emit("\n");
           indent_level++;
         } else if (token->token_type == lexer::TokenType::RightBrace) {
+          format_standalone_comments(node, cst::CommentPlacement::Dangling);
           indent_level--;
-          result << get_indent() << token->value;
+          emit(get_indent());
+          emit(token->value);
         } else if (token->token_type == lexer::TokenType::Comma) {
-          result << token->value << "\n";
+          emit(token->value);
+          emit("\n");
         } else if (token->token_type == lexer::TokenType::Colon) {
-          result << token->value << ONE_WIDTH_SPACE_STRING;
+          emit(token->value);
+          emit(ONE_WIDTH_SPACE_STRING);
         } else {
-          result << format_node(child.get());
+          format_node(child.get());
         }
       }
     } else if (child->get_type() == cst::CSTNodeType::Identifier) {
       // 字段名或类型名
       if (i == 0) {
         // 类型名
-        result << format_node(child.get());
+        format_node(child.get());
       } else {
         // 字段名
-        result << get_indent() << format_node(child.get());
+        format_standalone_comments(child.get(), cst::CommentPlacement::Leading);
+        emit(get_indent());
+        format_node(child.get());
       }
     } else if (child->get_type() == cst::CSTNodeType::Comment) {
-      result << format_standalone_comment(child.get());
+      format_standalone_comment(child.get());
     } else {
       // 字段值表达式
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-
-  return result.str();
 }
 
-std::string Formatter::visit_paren_expr(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_paren_expr(const cst::CSTNode* node) {
   // ParenExpr: (expression)
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -255,78 +245,67 @@ std::string Formatter::visit_paren_expr(const cst::CSTNode* node) {
     if (child->get_type() == cst::CSTNodeType::Delimiter) {
       const auto& token = child->get_token();
       if (token.has_value()) {
-        result << token->value;
+        emit(token->value);
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_integer_literal(const cst::CSTNode* node) {
+void Formatter::visit_integer_literal(const cst::CSTNode* node) {
   if (node->get_token().has_value()) {
-    return node->get_token()->value;
+    emit(node->get_token()->value);
   }
-  return "";
 }
 
-std::string Formatter::visit_float_literal(const cst::CSTNode* node) {
+void Formatter::visit_float_literal(const cst::CSTNode* node) {
   if (node->get_token().has_value()) {
-    return node->get_token()->value;
+    emit(node->get_token()->value);
   }
-  return "";
 }
 
-std::string Formatter::visit_string_literal(const cst::CSTNode* node) {
+void Formatter::visit_string_literal(const cst::CSTNode* node) {
   if (node->get_token().has_value()) {
     const auto& token = node->get_token().value();
     // 直接使用原始字面量文本
-    return token.raw_literal;
+    emit(token.raw_literal);
   }
-  return "";
 }
 
-std::string Formatter::visit_boolean_literal(const cst::CSTNode* node) {
+void Formatter::visit_boolean_literal(const cst::CSTNode* node) {
   if (node->get_token().has_value()) {
-    return node->get_token()->value;
+    emit(node->get_token()->value);
   }
-  return "";
 }
 
-std::string Formatter::visit_identifier(const cst::CSTNode* node) {
+void Formatter::visit_identifier(const cst::CSTNode* node) {
   if (node->get_token().has_value()) {
-    return node->get_token()->value;
+    emit(node->get_token()->value);
   }
-  return "";
 }
 
-std::string Formatter::visit_operator(const cst::CSTNode* node) {
+void Formatter::visit_operator(const cst::CSTNode* node) {
   if (node->get_token().has_value()) {
     const auto& token = node->get_token().value();
     // 跳过虚拟 Token
-    if (token.is_synthetic) {
-      return "";
+    if (!token.is_synthetic) {
+      emit(token.value);
     }
-    return token.value;
   }
-  return "";
 }
 
-std::string Formatter::visit_comment(const cst::CSTNode* node) {
+void Formatter::visit_comment(const cst::CSTNode* node) {
   if (node->get_token().has_value()) {
     const auto& token = node->get_token().value();
     // 虚拟 Token 不会是注释，但为了一致性还是检查
-    if (token.is_synthetic) {
-      return "";
+    if (!token.is_synthetic) {
+      emit(token.value);
     }
-    return token.value;
   }
-  return "";
 }
 
-std::string Formatter::visit_argument_list(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_argument_list(const cst::CSTNode* node) {
   // ArgumentList: arg1, arg2, arg3 (不包含括号)
   const auto& children = node->get_children();
   for (size_t i = 0; i < children.size(); ++i) {
@@ -335,44 +314,40 @@ std::string Formatter::visit_argument_list(const cst::CSTNode* node) {
     if (child->get_type() == cst::CSTNodeType::Delimiter) {
       const auto& token = child->get_token();
       if (token.has_value() && token->token_type == lexer::TokenType::Comma) {
-        result << ",";
+        emit(",");
         if (options.space_after_comma) {
-          result << ONE_WIDTH_SPACE_STRING;
+          emit(ONE_WIDTH_SPACE_STRING);
         }
       } else if (token.has_value()) {
-        result << token->value;
+        emit(token->value);
       }
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
-std::string Formatter::visit_delimiter(const cst::CSTNode* node) {
+void Formatter::visit_delimiter(const cst::CSTNode* node) {
   if (node->get_token().has_value()) {
     const auto& token = node->get_token().value();
     // 跳过虚拟 Token（用于错误恢复的占位符）
-    if (token.is_synthetic) {
-      return "";
+    if (!token.is_synthetic) {
+      emit(token.value);
     }
-    return token.value;
   }
-  return "";
 }
 
-std::string Formatter::visit_member_assign_expr(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_member_assign_expr(const cst::CSTNode* node) {
   // obj.member = value
   for (size_t i = 0; i < node->get_children().size(); ++i) {
     const auto& child = node->get_children()[i];
     if (child->get_type() == cst::CSTNodeType::Operator) {
-      result << ONE_WIDTH_SPACE_STRING << format_node(child.get())
-             << ONE_WIDTH_SPACE_STRING;
+      emit(ONE_WIDTH_SPACE_STRING);
+      format_node(child.get());
+      emit(ONE_WIDTH_SPACE_STRING);
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
 } // namespace czc::formatter
\ No newline at end of file
@@ -0,0 +1,272 @@
+/**
+ * @file formatter_range.cpp
+ * @brief 区间格式化实现 (只格式化与字节区间重叠的声明或语句)
+ * @details 依据 token 的字节偏移定位与区间重叠的最小一组声明或语句，
+ *          只格式化这些节点，并以文本替换的形式返回结果。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/formatter.hpp"
+
+#include <optional>
+#include <utility>
+
+namespace czc::formatter {
+
+namespace {
+
+// 节点在源码中的字节区间 [begin, end)。
+struct Span {
+  size_t begin;
+  size_t end;
+};
+
+// 节点最左侧非虚拟 token 的起始偏移。
+std::optional<size_t> first_offset(const cst::CSTNode* node) {
+  const auto& token = node->get_token();
+  if (token.has_value() && !token->is_synthetic) {
+    return token->offset;
+  }
+  for (const auto& child : node->get_children()) {
+    if (auto offset = first_offset(child.get())) {
+      return offset;
+    }
+  }
+  return std::nullopt;
+}
+
+// 节点最右侧非虚拟 token 的结束偏移。
+std::optional<size_t> last_offset(const cst::CSTNode* node) {
+  const auto& children = node->get_children();
+  for (size_t i = children.size(); i > 0; --i) {
+    if (auto offset = last_offset(children[i - 1].get())) {
+      return offset;
+    }
+  }
+  const auto& token = node->get_token();
+  if (token.has_value() && !token->is_synthetic) {
+    return token->offset + token->length;
+  }
+  return std::nullopt;
+}
+
+std::optional<Span> node_span(const cst::CSTNode* node) {
+  auto begin = first_offset(node);
+  if (!begin) {
+    return std::nullopt;
+  }
+  return Span{*begin, *last_offset(node)};
+}
+
+/**
+ * @brief 查找与闭区间 [start, end] 重叠的子节点。
+ * @details 子节点按源码顺序排列且互不重叠，因此可以按起点二分查找；
+ *          没有非虚拟 token 的子节点视为与其后第一个有位置的子节点同起点。
+ * @return 重叠子节点的下标范围 [first, last]，没有重叠时为空。
+ */
+std::optional<std::pair<size_t, size_t>>
+find_overlapping(const cst::CSTChildList& children, size_t start, size_t end) {
+  // 找到第一个起点在 end 之后的子节点。
+  size_t low = 0;
+  size_t high = children.size();
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    size_t probe = mid;
+    std::optional<size_t> begin;
+    while (probe < high && !(begin = first_offset(children[probe].get()))) {
+      ++probe;
+    }
+    if (begin && *begin <= end) {
+      low = probe + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  std::optional<std::pair<size_t, size_t>> result;
+  for (size_t i = low; i > 0; --i) {
+    auto span = node_span(children[i - 1].get());
+    if (!span) {
+      continue;
+    }
+    if (span->end < start) {
+      break;
+    }
+    if (!result) {
+      result.emplace(i - 1, i - 1);
+    }
+    result->first = i - 1;
+  }
+  return result;
+}
+
+// 是否是给定类型的非虚拟分隔符。
+bool is_real_delimiter(const cst::CSTNode* node, lexer::TokenType type) {
+  return node->get_type() == cst::CSTNodeType::Delimiter &&
+         node->get_token().has_value() && !node->get_token()->is_synthetic &&
+         node->get_token()->token_type == type;
+}
+
+/**
+ * @brief 若 [start, end] 完全落在语句的某个代码块的花括号之内，
+ *        返回该代码块的语句列表。
+ * @details 依次检查函数体、while 循环体、if 的各分支（含 else if 链）
+ *          以及独立的代码块。
+ */
+const cst::CSTNode* enclosing_statement_list(const cst::CSTNode* node,
+                                             size_t start, size_t end) {
+  switch (node->get_type()) {
+  case cst::CSTNodeType::BlockStmt: {
+    const auto& block = node->get_children();
+    if (block.size() < 2 ||
+        !is_real_delimiter(block.front().get(), lexer::TokenType::LeftBrace) ||
+        !is_real_delimiter(block.back().get(), lexer::TokenType::RightBrace)) {
+      return nullptr;
+    }
+    const auto& left = *block.front()->get_token();
+    const auto& right = *block.back()->get_token();
+    if (start < left.offset + left.length || end > right.offset) {
+      return nullptr;
+    }
+    for (const auto& child : block) {
+      if (child->get_type() == cst::CSTNodeType::StatementList) {
+        return child.get();
+      }
+    }
+    return nullptr;
+  }
+  case cst::CSTNodeType::FnDeclaration:
+  case cst::CSTNodeType::WhileStmt:
+  case cst::CSTNodeType::IfStmt:
+    for (const auto& child : node->get_children()) {
+      if (child->get_type() == cst::CSTNodeType::BlockStmt ||
+          child->get_type() == cst::CSTNodeType::IfStmt) {
+        if (auto* list = enclosing_statement_list(child.get(), start, end)) {
+          return list;
+        }
+      }
+    }
+    return nullptr;
+  default:
+    return nullptr;
+  }
+}
+
+bool is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+} // namespace
+
+std::vector<TextEdit> Formatter::format_range(const cst::CSTNode* root,
+                                              std::string_view source,
+                                              size_t start_offset,
+                                              size_t end_offset) {
+  std::vector<TextEdit> edits;
+  if (!root || comments != nullptr) {
+    return edits;
+  }
+  if (start_offset > end_offset) {
+    std::swap(start_offset, end_offset);
+  }
+
+  // 逐层向内查找包住区间的最小一组声明或语句。
+  const cst::CSTNode* container = root;
+  int level = 0;
+  // 最近一个包住整个区间的语句，区间落在其空白处时退回格式化它。
+  const cst::CSTNode* owner = nullptr;
+  int owner_level = 0;
+  // 退回时要格式化的单个语句，为空时格式化 `container` 的 [first, last]
+  const cst::CSTNode* fallback = nullptr;
+  size_t first = 0;
+  size_t last = 0;
+
+  while (true) {
+    const auto& children = container->get_children();
+    auto overlap = find_overlapping(children, start_offset, end_offset);
+    if (!overlap) {
+      if (!owner) {
+        return edits;
+      }
+      fallback = owner;
+      level = owner_level;
+      break;
+    }
+
+    const cst::CSTNode* child = children[overlap->first].get();
+    if (overlap->first == overlap->second) {
+      if (auto* list =
+              enclosing_statement_list(child, start_offset, end_offset)) {
+        owner = child;
+        owner_level = level;
+        container = list;
+        ++level;
+        continue;
+      }
+    }
+    first = overlap->first;
+    last = overlap->second;
+    break;
+  }
+
+  const auto& children = container->get_children();
+  const cst::CSTNode* front = fallback ? fallback : children[first].get();
+  const cst::CSTNode* back = fallback ? fallback : children[last].get();
+  Span span{node_span(front)->begin, node_span(back)->end};
+  if (span.end > source.size()) {
+    return edits;
+  }
+
+  std::string text;
+  indent_level = level;
+  inline_next_if = false;
+  error_collector.clear();
+  out = &text;
+  sink = nullptr;
+  if (fallback) {
+    format_node(fallback);
+  } else {
+    for (size_t i = first; i <= last; ++i) {
+      const cst::CSTNode* child = children[i].get();
+      if (child->get_type() == cst::CSTNodeType::Comment) {
+        format_standalone_comment(child);
+      } else {
+        format_node(child);
+      }
+    }
+  }
+  out = nullptr;
+
+  // 节点前只有缩进时替换整行的缩进，否则保留前面的内容与空白。
+  size_t line_begin = span.begin;
+  while (line_begin > 0 && is_blank(source[line_begin - 1])) {
+    --line_begin;
+  }
+  if (line_begin == 0 || source[line_begin - 1] == '\n') {
+    span.begin = line_begin;
+  } else {
+    size_t indent = text.find_first_not_of(" \t");
+    text.erase(0, indent == std::string::npos ? text.size() : indent);
+  }
+
+  // 节点后只有空白时连同换行符一起替换，否则保留同一行后面的内容。
+  size_t line_end = span.end;
+  while (line_end < source.size() && is_blank(source[line_end])) {
+    ++line_end;
+  }
+  if (line_end == source.size()) {
+    span.end = line_end;
+  } else if (source[line_end] == '\n') {
+    span.end = line_end + 1;
+  } else if (!text.empty() && text.back() == '\n') {
+    text.pop_back();
+  }
+
+  if (source.substr(span.begin, span.end - span.begin) != text) {
+    edits.push_back({span.begin, span.end, std::move(text)});
+  }
+  return edits;
+}
+
+} // namespace czc::formatter
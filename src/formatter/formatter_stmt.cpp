@@ -9,45 +9,119 @@
 
 #include "czc/formatter/formatter.hpp"
 
-#include <sstream>
+#include <optional>
 
 namespace czc::formatter {
 
-std::string Formatter::visit_program(const cst::CSTNode* node) {
-  std::ostringstream result;
+namespace {
+
+/**
+ * @brief 获取子树首个 Token 到最后一个 Token 之间的原文。
+ * @details 子树的 Token 按先序即按源码顺序排列，因此只需沿最左与最右的
+ *          子节点各向下走一条路径。
+ * @return 首尾是虚拟 Token、存在空子节点或超出源码时返回空。
+ */
+std::optional<std::string_view> get_source_text(const cst::CSTNode* node,
+                                                std::string_view source) {
+  const cst::CSTNode* first = node;
+  while (first != nullptr && !first->get_token().has_value()) {
+    const auto& children = first->get_children();
+    first = children.empty() ? nullptr : children.front().get();
+  }
+  const cst::CSTNode* last = node;
+  while (last != nullptr && !last->get_children().empty()) {
+    last = last->get_children().back().get();
+  }
+  if (first == nullptr || last == nullptr || !last->get_token().has_value()) {
+    return std::nullopt;
+  }
+
+  const lexer::Token& begin = *first->get_token();
+  const lexer::Token& end = *last->get_token();
+  if (begin.is_synthetic || end.is_synthetic || begin.offset > end.offset ||
+      end.offset > source.size() ||
+      end.length > source.size() - end.offset) {
+    return std::nullopt;
+  }
+  return source.substr(begin.offset, end.offset + end.length - begin.offset);
+}
+
+} // namespace
+
+void Formatter::visit_program(const cst::CSTNode* node) {
   // Program: 顶层节点，逐个格式化其子节点（通常是声明或语句）
   for (const auto& child : node->get_children()) {
     if (child->get_type() == cst::CSTNodeType::Comment) {
-      result << format_standalone_comment(child.get());
+      format_standalone_comment(child.get());
     } else {
-      result << format_node(child.get());
+      format_standalone_comments(child.get(), cst::CommentPlacement::Leading);
+      format_top_level(child.get());
+    }
+    // 每个顶层声明结束后检查是否需要把缓冲区交给输出端。
+    flush_to_sink(false);
+    if (sink != nullptr && sink->is_finished()) {
+      return;
     }
   }
-  return result.str();
+  // 文件末尾的注释附着在空指针上。
+  format_standalone_comments(nullptr, cst::CommentPlacement::Dangling);
+}
+
+void Formatter::format_top_level(const cst::CSTNode* node) {
+  std::optional<std::string_view> text;
+  // NOTE: 表中的行内注释在声明的原文之外，带有它的声明不能以原文为键。
+  if (memo != nullptr &&
+      (comments == nullptr || comments->trailing(node).empty())) {
+    text = get_source_text(node, memo_source);
+  }
+  if (!text) {
+    format_node(node);
+    return;
+  }
+  FormatMemoKey key = FormatMemo::make_key(*text, options, indent_level);
+  if (memo->lookup(key, *out)) {
+    return;
+  }
+  // NOTE: 顶层声明之间才会把缓冲区交给输出端，本声明的结果此时仍完整地
+  //       留在 `out` 的末尾。
+  size_t start = out->size();
+  size_t errors = error_collector.count();
+  format_node(node);
+  if (error_collector.count() == errors) {
+    memo->insert(key, std::string_view(*out).substr(start));
+  }
 }
 
-std::string Formatter::visit_return_stmt(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_return_stmt(const cst::CSTNode* node) {
   // ReturnStmt: return a + b;
-  result << get_indent() << "return" << ONE_WIDTH_SPACE_STRING;
-  for (const auto& child : node->get_children()) {
+  emit(get_indent());
+  emit("return");
+  emit(ONE_WIDTH_SPACE_STRING);
+  const auto& children = node->get_children();
+  for (size_t i = 0; i < children.size(); ++i) {
+    const auto& child = children[i];
     if (child->get_type() != cst::CSTNodeType::Delimiter ||
         (child->get_token().has_value() &&
          child->get_token()->token_type != lexer::TokenType::Return &&
          child->get_token()->token_type != lexer::TokenType::Semicolon)) {
-      result << format_node(child.get());
+      format_expression(child.get(),
+                        i + 1 < children.size() ? children[i + 1].get()
+                                                : nullptr);
     } else if (child->get_token().has_value() &&
                child->get_token()->token_type == lexer::TokenType::Semicolon) {
-      result << ";";
+      emit(";");
     }
   }
-  result << "\n";
-  return result.str();
+  emit("\n");
 }
 
-std::string Formatter::visit_if_stmt(const cst::CSTNode* node) {
-  std::ostringstream result;
-  result << get_indent();
+void Formatter::visit_if_stmt(const cst::CSTNode* node) {
+  // else if 中的 if 已经跟在 else 后面，不再输出缩进。
+  if (inline_next_if) {
+    inline_next_if = false;
+  } else {
+    emit(get_indent());
+  }
 
   // if 语句结构: if condition { block } [else if condition { block }]* [else {
   // block }]
@@ -61,54 +135,47 @@ std::string Formatter::visit_if_stmt(const cst::CSTNode* node) {
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::If) {
           // if 关键字
-          result << "if";
-          result << ONE_WIDTH_SPACE_STRING;
+          emit("if");
+          emit(ONE_WIDTH_SPACE_STRING);
         } else if (token->token_type == lexer::TokenType::LeftParen) {
           if (options.space_before_paren) {
-            result << ONE_WIDTH_SPACE_STRING;
+            emit(ONE_WIDTH_SPACE_STRING);
           }
-          result << "(";
+          emit("(");
         } else if (token->token_type == lexer::TokenType::RightParen) {
-          result << ")";
+          emit(")");
         } else if (token->token_type == lexer::TokenType::Else) {
           // else 关键字前添加空格
-          result << ONE_WIDTH_SPACE_STRING << "else";
+          emit(ONE_WIDTH_SPACE_STRING);
+          emit("else");
 
           // 检查下一个子节点是否是 if 语句 (else if 情况)
           if (i + 1 < children.size() &&
               children[i + 1]->get_type() == cst::CSTNodeType::IfStmt) {
-            result << ONE_WIDTH_SPACE_STRING;
+            emit(ONE_WIDTH_SPACE_STRING);
           }
         } else {
-          result << format_node(child.get());
+          format_node(child.get());
         }
       }
     } else if (child->get_type() == cst::CSTNodeType::BlockStmt) {
       if (!options.newline_before_brace) {
-        result << ONE_WIDTH_SPACE_STRING;
+        emit(ONE_WIDTH_SPACE_STRING);
       }
-      result << format_node(child.get());
+      format_node(child.get());
     } else if (child->get_type() == cst::CSTNodeType::IfStmt) {
-      // else if 语句：不添加缩进，因为它是同一级别的
-      std::string nested_if = visit_if_stmt(child.get());
-      // 移除嵌套 if 语句的缩进（因为它已经在 else 后面）
-      size_t first_non_space = nested_if.find_first_not_of(" \t");
-      if (first_non_space != std::string::npos) {
-        result << nested_if.substr(first_non_space);
-      } else {
-        result << nested_if;
-      }
+      // else if 语句：紧跟在 else 后面，不添加缩进
+      inline_next_if = true;
+      visit_if_stmt(child.get());
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-
-  return result.str();
 }
 
-std::string Formatter::visit_while_stmt(const cst::CSTNode* node) {
-  std::ostringstream result;
-  result << get_indent() << "while";
+void Formatter::visit_while_stmt(const cst::CSTNode* node) {
+  emit(get_indent());
+  emit("while");
 
   // while 语句结构: while condition { block }
   const auto& children = node->get_children();
@@ -120,66 +187,64 @@ std::string Formatter::visit_while_stmt(const cst::CSTNode* node) {
       if (token.has_value()) {
         if (token->token_type == lexer::TokenType::LeftParen) {
           if (options.space_before_paren) {
-            result << ONE_WIDTH_SPACE_STRING;
+            emit(ONE_WIDTH_SPACE_STRING);
           }
-          result << "(";
+          emit("(");
         } else if (token->token_type == lexer::TokenType::RightParen) {
-          result << ")";
+          emit(")");
         } else {
-          result << format_node(child.get());
+          format_node(child.get());
         }
       }
     } else if (child->get_type() == cst::CSTNodeType::BlockStmt) {
       if (!options.newline_before_brace) {
-        result << ONE_WIDTH_SPACE_STRING;
+        emit(ONE_WIDTH_SPACE_STRING);
       }
-      result << format_node(child.get());
+      format_node(child.get());
     } else {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-
-  return result.str();
 }
 
-std::string Formatter::visit_block_stmt(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_block_stmt(const cst::CSTNode* node) {
   // BlockStmt: { statements }
   for (const auto& child : node->get_children()) {
     if (child->get_type() == cst::CSTNodeType::Delimiter) {
       const auto& token = child->get_token();
       if (token.has_value() &&
           token->token_type == lexer::TokenType::LeftBrace) {
-        result << "{\n";
+        emit("{\n");
         increase_indent();
       } else if (token.has_value() &&
                  token->token_type == lexer::TokenType::RightBrace) {
         decrease_indent();
-        result << get_indent() << "}\n";
+        emit(get_indent());
+        emit("}\n");
       }
     } else if (child->get_type() == cst::CSTNodeType::StatementList) {
-      result << format_node(child.get());
+      format_node(child.get());
     }
   }
-  return result.str();
 }
 
-std::string Formatter::visit_expr_stmt(const cst::CSTNode* node) {
-  std::ostringstream result;
+void Formatter::visit_expr_stmt(const cst::CSTNode* node) {
   // ExprStmt: 表达式语句，通常是一个函数调用或赋值
-  result << get_indent();
+  emit(get_indent());
   for (size_t i = 0; i < node->get_children().size(); ++i) {
     const auto& child = node->get_children()[i];
 
     if (child->get_type() == cst::CSTNodeType::Comment) {
-      result << format_inline_comment(child.get());
+      format_inline_comment(child.get());
       continue;
     }
 
-    result << format_node(child.get());
+    format_expression(child.get(), i + 1 < node->get_children().size()
+                                       ? node->get_children()[i + 1].get()
+                                       : nullptr);
   }
-  result << "\n";
-  return result.str();
+  format_trailing_comments(node);
+  emit("\n");
 }
 
 } // namespace czc::formatter
\ No newline at end of file
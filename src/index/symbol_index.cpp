@@ -0,0 +1,488 @@
+/**
+ * @file symbol_index.cpp
+ * @brief `extract_symbols` 与 `SymbolIndex` 的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/index/symbol_index.hpp"
+
+#include "czc/lexer/lexer.hpp"
+#include "czc/utils/atomic_file.hpp"
+#include "czc/utils/byte_io.hpp"
+#include "czc/utils/source_buffer.hpp"
+#include "czc/utils/thread_pool.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <initializer_list>
+#include <optional>
+#include <utility>
+
+namespace czc::index {
+
+using namespace czc::lexer;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char MAGIC[4] = {'C', 'Z', 'C', 'I'};
+
+constexpr uint64_t MAX_SYMBOL_KIND = static_cast<uint64_t>(SymbolKind::Field);
+
+// 修改时间不可信（扫描期间可能再次变化）的条目，下次更新时总是重新扫描。
+constexpr int64_t UNTRUSTED_MTIME = std::numeric_limits<int64_t>::min();
+
+/**
+ * @brief 在去掉注释的 Token 序列上识别顶层声明。
+ * @details 序列总以 EOF 结尾，任何越界的前瞻都落在 EOF 上。
+ */
+class Skimmer {
+public:
+  Skimmer(const std::vector<Token>& tokens, std::string_view source)
+      : source(source) {
+    code.reserve(tokens.size());
+    for (const Token& token : tokens) {
+      if (token.token_type != TokenType::Comment) {
+        code.push_back(&token);
+      }
+    }
+    if (code.empty() || code.back()->token_type != TokenType::EndOfFile) {
+      code.push_back(&eof);
+    }
+  }
+
+  std::vector<Symbol> run() {
+    int brace_depth = 0;
+    while (!at(TokenType::EndOfFile)) {
+      bool named = peek(1).token_type == TokenType::Identifier;
+      if (brace_depth == 0 && named && at(TokenType::Fn)) {
+        function();
+      } else if (brace_depth == 0 && named && at(TokenType::Struct)) {
+        structure();
+      } else if (brace_depth == 0 && named && at(TokenType::Type)) {
+        type_alias();
+      } else {
+        if (at(TokenType::LeftBrace)) {
+          brace_depth++;
+        } else if (at(TokenType::RightBrace) && brace_depth > 0) {
+          brace_depth--;
+        }
+        pos++;
+      }
+    }
+    return std::move(symbols);
+  }
+
+private:
+  [[nodiscard]] const Token& peek(size_t ahead = 0) const {
+    size_t index = pos + ahead;
+    return index < code.size() ? *code[index] : *code.back();
+  }
+
+  [[nodiscard]] bool at(TokenType type) const {
+    return peek().token_type == type;
+  }
+
+  static bool is_open(TokenType type) {
+    return type == TokenType::LeftParen || type == TokenType::LeftBracket ||
+           type == TokenType::LeftBrace;
+  }
+
+  static bool is_close(TokenType type) {
+    return type == TokenType::RightParen || type == TokenType::RightBracket ||
+           type == TokenType::RightBrace;
+  }
+
+  /**
+   * @brief 越过当前的左括号及其配对的右括号之间的全部 Token。
+   * @details 三种括号合并计数；未闭合时停在 EOF。
+   */
+  void skip_group() {
+    int depth = 0;
+    while (!at(TokenType::EndOfFile)) {
+      TokenType type = peek().token_type;
+      pos++;
+      if (is_open(type)) {
+        depth++;
+      } else if (is_close(type) && --depth <= 0) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief 越过一个类型或表达式，停在括号之外的任一 `stops` 处或未配对的
+   *        右括号处。
+   */
+  void skip_until(std::initializer_list<TokenType> stops) {
+    while (!at(TokenType::EndOfFile)) {
+      TokenType type = peek().token_type;
+      for (TokenType stop : stops) {
+        if (type == stop) {
+          return;
+        }
+      }
+      if (is_close(type)) {
+        return;
+      }
+      if (is_open(type)) {
+        skip_group();
+      } else {
+        pos++;
+      }
+    }
+  }
+
+  /**
+   * @brief 拼接 `code[first, last)` 的原文；Token 之间有空白或注释时以
+   *        一个空格分隔。
+   */
+  [[nodiscard]] std::string text(size_t first, size_t last) const {
+    std::string result;
+    size_t previous_end = 0;
+    for (size_t i = first; i < last; ++i) {
+      const Token& token = *code[i];
+      if (token.offset + token.length > source.size()) {
+        break;
+      }
+      if (i > first && token.offset > previous_end) {
+        result.push_back(' ');
+      }
+      result.append(source.substr(token.offset, token.length));
+      previous_end = token.offset + token.length;
+    }
+    return result;
+  }
+
+  uint32_t add(SymbolKind kind, const Token& name, std::string detail,
+               uint32_t parent = Symbol::NO_PARENT) {
+    Symbol symbol;
+    symbol.kind = kind;
+    symbol.name = name.value;
+    symbol.detail = std::move(detail);
+    symbol.line = static_cast<uint32_t>(name.line);
+    symbol.column = static_cast<uint32_t>(name.column);
+    symbol.parent = parent;
+    symbols.push_back(std::move(symbol));
+    return static_cast<uint32_t>(symbols.size() - 1);
+  }
+
+  /**
+   * @brief 提取 `name: Type` 形式的成员，逗号分隔，直到配对的右括号。
+   * @details 当前位置在左括号上，结束时越过右括号。
+   */
+  void members(SymbolKind kind, uint32_t parent) {
+    pos++;
+    while (!at(TokenType::EndOfFile) && !is_close(peek().token_type)) {
+      if (at(TokenType::Identifier)) {
+        const Token& name = peek();
+        pos++;
+        std::string type;
+        if (at(TokenType::Colon)) {
+          pos++;
+          size_t first = pos;
+          skip_until({TokenType::Comma});
+          type = text(first, pos);
+        }
+        add(kind, name, std::move(type), parent);
+      }
+      skip_until({TokenType::Comma});
+      if (at(TokenType::Comma)) {
+        pos++;
+      }
+    }
+    if (!at(TokenType::EndOfFile)) {
+      pos++;
+    }
+  }
+
+  // fn name(params) [-> type] { body }
+  void function() {
+    const Token& name = peek(1);
+    pos += 2;
+    uint32_t self = add(SymbolKind::Function, name, {});
+    if (!at(TokenType::LeftParen)) {
+      return;
+    }
+    size_t first = pos;
+    members(SymbolKind::Parameter, self);
+    if (at(TokenType::Arrow)) {
+      pos++;
+      // NOTE: 返回类型可能是 `struct { … }`，其中的大括号不是函数体。
+      while (!at(TokenType::EndOfFile) && !at(TokenType::LeftBrace) &&
+             !at(TokenType::Semicolon) && !is_close(peek().token_type)) {
+        bool anonymous = at(TokenType::Struct);
+        if (is_open(peek().token_type)) {
+          skip_group();
+        } else {
+          pos++;
+        }
+        if (anonymous && at(TokenType::LeftBrace)) {
+          skip_group();
+        }
+      }
+    }
+    symbols[self].detail = text(first, pos);
+    if (at(TokenType::LeftBrace)) {
+      skip_group();
+    }
+  }
+
+  // struct Name { field: Type, ... };
+  void structure() {
+    const Token& name = peek(1);
+    pos += 2;
+    uint32_t self = add(SymbolKind::Struct, name, {});
+    if (at(TokenType::LeftBrace)) {
+      members(SymbolKind::Field, self);
+    }
+  }
+
+  // type Name = Type;
+  void type_alias() {
+    const Token& name = peek(1);
+    pos += 2;
+    std::string type;
+    if (at(TokenType::Equal)) {
+      pos++;
+      size_t first = pos;
+      skip_until({TokenType::Semicolon});
+      type = text(first, pos);
+    }
+    add(SymbolKind::TypeAlias, name, std::move(type));
+  }
+
+  std::string_view source;
+  std::vector<const Token*> code;
+  size_t pos = 0;
+  std::vector<Symbol> symbols;
+  Token eof = Token::makeEOF();
+};
+
+/**
+ * @brief 读取并扫描一个文件。
+ * @return 文件无法读取时返回空。
+ */
+std::optional<SymbolIndex::FileEntry> scan_file(const std::string& path,
+                                                int64_t mtime, uint64_t size) {
+  auto buffer = utils::SourceBuffer::open(path);
+  if (!buffer) {
+    return std::nullopt;
+  }
+  SymbolIndex::FileEntry entry;
+  entry.mtime = mtime;
+  entry.size = size;
+  auto tokens = Lexer(*buffer, path).tokenize();
+  entry.symbols = extract_symbols(tokens, buffer->view());
+  return entry;
+}
+
+} // namespace
+
+std::string_view symbol_kind_to_string(SymbolKind kind) noexcept {
+  switch (kind) {
+  case SymbolKind::Function:
+    return "function";
+  case SymbolKind::Struct:
+    return "struct";
+  case SymbolKind::TypeAlias:
+    return "type";
+  case SymbolKind::Parameter:
+    return "parameter";
+  case SymbolKind::Field:
+    return "field";
+  }
+  return "unknown";
+}
+
+std::vector<Symbol> extract_symbols(const std::vector<Token>& tokens,
+                                    std::string_view source) {
+  return Skimmer(tokens, source).run();
+}
+
+SymbolIndex::SymbolIndex(std::string version) : version(std::move(version)) {}
+
+bool SymbolIndex::load(const std::string& path) {
+  files.clear();
+  by_name.clear();
+  auto buffer = utils::SourceBuffer::open(path);
+  if (!buffer) {
+    return false;
+  }
+
+  utils::ByteReader reader(buffer->view());
+  if (reader.get_bytes(sizeof(MAGIC)) != std::string_view(MAGIC, 4) ||
+      reader.get_varint() != SYMBOL_INDEX_FORMAT_VERSION ||
+      reader.get_string() != version) {
+    return false;
+  }
+
+  uint64_t file_count = reader.get_varint();
+  for (uint64_t i = 0; i < file_count && reader.ok(); ++i) {
+    std::string file(reader.get_string());
+    FileEntry entry;
+    entry.mtime = reader.get_signed();
+    entry.size = reader.get_varint();
+    uint64_t symbol_count = reader.get_varint();
+    int64_t line = 0;
+    for (uint64_t j = 0; j < symbol_count && reader.ok(); ++j) {
+      Symbol symbol;
+      uint64_t kind = reader.get_varint();
+      if (kind > MAX_SYMBOL_KIND) {
+        files.clear();
+        return false;
+      }
+      symbol.kind = static_cast<SymbolKind>(kind);
+      symbol.name = reader.get_string();
+      symbol.detail = reader.get_string();
+      line += reader.get_signed();
+      symbol.line = static_cast<uint32_t>(line);
+      symbol.column = static_cast<uint32_t>(reader.get_varint());
+      // 所属声明记为到它的距离，0 表示没有
+      uint64_t distance = reader.get_varint();
+      if (distance > j) {
+        files.clear();
+        return false;
+      }
+      symbol.parent = distance == 0 ? Symbol::NO_PARENT
+                                    : static_cast<uint32_t>(j - distance);
+      entry.symbols.push_back(std::move(symbol));
+    }
+    files.emplace(std::move(file), std::move(entry));
+  }
+  if (!reader.ok() || !reader.at_end()) {
+    files.clear();
+    return false;
+  }
+  rebuild_lookup();
+  return true;
+}
+
+bool SymbolIndex::save(const std::string& path) const {
+  utils::ByteWriter out;
+  out.put_bytes(std::string_view(MAGIC, sizeof(MAGIC)));
+  out.put_varint(SYMBOL_INDEX_FORMAT_VERSION);
+  out.put_string(version);
+  out.put_varint(files.size());
+  for (const auto& [file, entry] : files) {
+    out.put_string(file);
+    out.put_signed(entry.mtime);
+    out.put_varint(entry.size);
+    out.put_varint(entry.symbols.size());
+    int64_t line = 0;
+    for (size_t j = 0; j < entry.symbols.size(); ++j) {
+      const Symbol& symbol = entry.symbols[j];
+      out.put_varint(static_cast<uint64_t>(symbol.kind));
+      out.put_string(symbol.name);
+      out.put_string(symbol.detail);
+      out.put_signed(static_cast<int64_t>(symbol.line) - line);
+      line = symbol.line;
+      out.put_varint(symbol.column);
+      out.put_varint(symbol.parent == Symbol::NO_PARENT ? 0
+                                                        : j - symbol.parent);
+    }
+  }
+  return utils::write_file_atomic(path, out.take());
+}
+
+IndexUpdateStats SymbolIndex::update(const std::vector<std::string>& paths,
+                                     utils::ThreadPool* pool) {
+  IndexUpdateStats stats;
+  auto started = fs::file_time_type::clock::now();
+  std::map<std::string, FileEntry> updated;
+
+  // --- 沿用未改变的文件，其余的交给线程池扫描 ---
+  struct Pending {
+    std::string path;
+    std::future<std::optional<FileEntry>> result;
+  };
+  std::vector<Pending> pending;
+  for (const std::string& path : paths) {
+    if (updated.count(path) != 0) {
+      continue;
+    }
+    std::error_code ec;
+    fs::file_time_type time = fs::last_write_time(path, ec);
+    uint64_t size = ec ? 0 : fs::file_size(path, ec);
+    if (ec) {
+      stats.failed_files++;
+      continue;
+    }
+    auto mtime = static_cast<int64_t>(time.time_since_epoch().count());
+    auto old = files.find(path);
+    if (old != files.end()) {
+      bool unchanged = old->second.mtime == mtime && old->second.size == size;
+      if (unchanged) {
+        updated.emplace(path, std::move(old->second));
+      }
+      files.erase(old);
+      if (unchanged) {
+        stats.reused_files++;
+        continue;
+      }
+    }
+    // 与本次更新开始时间相差不到一秒的文件可能在同一时间刻度内再次变化，
+    // 即使下次时间戳相同也不可信。
+    if (time + std::chrono::seconds(1) >= started) {
+      mtime = UNTRUSTED_MTIME;
+    }
+
+    auto task = [path, mtime, size]() { return scan_file(path, mtime, size); };
+    Pending item{path, {}};
+    if (pool != nullptr) {
+      item.result = pool->submit(std::move(task));
+    } else {
+      std::promise<std::optional<FileEntry>> done;
+      done.set_value(task());
+      item.result = done.get_future();
+    }
+    pending.push_back(std::move(item));
+    updated.emplace(path, FileEntry{});
+  }
+
+  for (Pending& item : pending) {
+    std::optional<FileEntry> entry = item.result.get();
+    if (entry) {
+      updated[item.path] = std::move(*entry);
+      stats.scanned_files++;
+    } else {
+      updated.erase(item.path);
+      stats.failed_files++;
+    }
+  }
+
+  // 剩下的旧条目都不再属于索引。
+  stats.removed_files = files.size();
+  files = std::move(updated);
+  rebuild_lookup();
+  return stats;
+}
+
+std::vector<SymbolMatch> SymbolIndex::find(std::string_view name) const {
+  auto it = by_name.find(name);
+  return it == by_name.end() ? std::vector<SymbolMatch>{} : it->second;
+}
+
+size_t SymbolIndex::symbol_count() const noexcept {
+  size_t count = 0;
+  for (const auto& [file, entry] : files) {
+    count += entry.symbols.size();
+  }
+  return count;
+}
+
+void SymbolIndex::rebuild_lookup() {
+  by_name.clear();
+  for (const auto& [file, entry] : files) {
+    for (const Symbol& symbol : entry.symbols) {
+      const Symbol* parent = symbol.parent == Symbol::NO_PARENT
+                                 ? nullptr
+                                 : &entry.symbols[symbol.parent];
+      by_name[symbol.name].push_back({&file, &symbol, parent});
+    }
+  }
+}
+
+} // namespace czc::index
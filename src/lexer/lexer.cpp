@@ -7,11 +7,20 @@
 
 #include "czc/lexer/lexer.hpp"
 
+#include "czc/lexer/char_class.hpp"
+#include "czc/lexer/scan_kernels.hpp"
 #include "czc/lexer/utf8_handler.hpp"
+#include "czc/utils/capacity_estimate.hpp"
+#include "czc/utils/string_interner.hpp"
+#include "czc/utils/time_report.hpp"
 
+#include <array>
 #include <cctype>
 #include <iomanip>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
+#include <utility>
 
 namespace czc::lexer {
 
@@ -23,7 +32,7 @@ void Lexer::report_error(DiagnosticCode code, size_t error_line,
                          const std::vector<std::string>& args) {
   // NOTE: 创建一个只包含错误发生点的 SourceLocation。对于词法错误，
   //       通常我们只关心单个字符或符号的位置，因此起始和结束位置是相同的。
-  auto loc = SourceLocation(tracker.get_filename(), error_line, error_column,
+  auto loc = SourceLocation(tracker.get_file_id(), error_line, error_column,
                             error_line, error_column);
   LexerError error(code, loc, args);
   error_collector.add(error);
@@ -55,6 +64,35 @@ void Lexer::advance() {
   }
 }
 
+void Lexer::advance_to(size_t new_pos) {
+  size_t pos = tracker.get_position();
+  if (new_pos <= pos) {
+    return;
+  }
+
+  tracker.advance_bytes(new_pos - pos);
+
+  pos = tracker.get_position();
+  const auto& input = tracker.get_input();
+  if (pos < input.size()) {
+    current_char = input[pos];
+  } else {
+    current_char = std::nullopt;
+  }
+}
+
+void Lexer::seek(size_t pos, size_t line, size_t column) {
+  tracker.seek(pos, line, column);
+
+  pos = tracker.get_position();
+  const auto& input = tracker.get_input();
+  if (pos < input.size()) {
+    current_char = input[pos];
+  } else {
+    current_char = std::nullopt;
+  }
+}
+
 std::optional<char> Lexer::peek(size_t offset) const {
   size_t peek_pos = tracker.get_position() + offset;
   const auto& input = tracker.get_input();
@@ -65,13 +103,16 @@ std::optional<char> Lexer::peek(size_t offset) const {
 }
 
 void Lexer::skip_whitespace() {
-  // NOTE: 持续消耗字符，直到遇到非空白字符或源码结束。
-  //       `isspace` 可以正确处理空格、制表符、换行符等多种空白字符。
-  //       转换为 unsigned char 以避免在 char 为有符号类型的平台上出现 UB。
-  while (current_char.has_value() &&
-         std::isspace(static_cast<unsigned char>(current_char.value()))) {
-    advance();
+  // NOTE: 空白字符集与 "C" locale 下的 `isspace` 一致。扫描内核按数据块
+  //       查找空白串的结尾，行列号随后由 tracker 一次性更新。
+  //       Token 之间通常没有空白，先检查当前字符以免进入内核。
+  if (!current_char.has_value() ||
+      char_class(current_char.value()) != CharClass::Whitespace) {
+    return;
   }
+  const auto& input = tracker.get_input();
+  advance_to(
+      scan::skip_whitespace(input.data(), tracker.get_position(), input.size()));
 }
 
 Token Lexer::read_comment() {
@@ -82,15 +123,20 @@ Token Lexer::read_comment() {
   std::string comment_text;
 
   if (current_char == '/' && peek(1) == '/') {
-    // 记录 "//"
-    comment_text += "//";
+    size_t start = tracker.get_position();
     advance(); // 跳过第一个 '/'
     advance(); // 跳过第二个 '/'
 
     // 读取注释内容直到行尾（`\n`）或文件末尾。
-    while (current_char.has_value() && current_char != '\n') {
-      comment_text += current_char.value();
-      advance();
+    const auto& input = tracker.get_input();
+    advance_to(
+        scan::find_line_end(input.data(), tracker.get_position(), input.size()));
+
+    // NOTE: 注释文本（包括 "//"）与源码完全一致，直接整段切片即可，
+    //       零拷贝模式下则完全跳过字符串构造。
+    if (!span_mode) {
+      comment_text.assign(input.data() + start,
+                          tracker.get_position() - start);
     }
 
     // NOTE: 如果是因为换行符而停止，则需要额外调用一次 advance() 来消耗掉
@@ -111,73 +157,45 @@ Token Lexer::read_identifier() {
   size_t token_line = tracker.get_line();
   size_t token_column = tracker.get_column();
 
-  // 处理标识符的第一个字符
-  if (current_char.has_value()) {
-    unsigned char uch = static_cast<unsigned char>(current_char.value());
-
-    // 如果第一个字符是UTF-8起始字节,使用Utf8Handler读取完整字符
-    if (uch >= 0x80) {
-      size_t current_pos = tracker.get_position();
-      std::string utf8_char;
-      const auto& input = tracker.get_input();
-
-      if (Utf8Handler::read_char(input, current_pos, utf8_char)) {
-        // UTF-8 字符有效，同步 tracker 的位置
-        while (tracker.get_position() < current_pos) {
-          advance();
-        }
-      } else {
-        // 第一个字符就是无效的UTF-8序列,返回错误token
-        advance();
-        return Token(TokenType::Unknown, std::string(input.data() + start, 1),
-                     token_line, token_column);
-      }
-    } else {
-      // ASCII字符,直接消耗
-      advance();
-    }
-  }
+  const auto& input = tracker.get_input();
+  const char* data = input.data();
 
-  // 继续读取后续字符
-  while (current_char.has_value()) {
-    char ch = current_char.value();
-    unsigned char uch = static_cast<unsigned char>(ch);
+  // 如果第一个字符就是无效的 UTF-8 序列，返回错误 token。
+  if (static_cast<unsigned char>(data[start]) >= 0x80 &&
+      Utf8Handler::skip_multibyte(data, start, input.size()) == start) {
+    advance();
+    return Token(TokenType::Unknown, std::string(data + start, 1), token_line,
+                 token_column);
+  }
 
-    // 标识符可以包含字母、数字、下划线
-    if (std::isalnum(static_cast<unsigned char>(ch)) || ch == '_') {
-      advance();
-    }
-    // NOTE: 对于非 ASCII 字符（UTF-8 起始字节），使用 Utf8Handler
-    //       来正确读取完整的多字节字符序列，并验证其有效性。
-    else if (uch >= 0x80) {
-      size_t current_pos = tracker.get_position();
-      std::string utf8_char;
-      const auto& input = tracker.get_input();
-
-      if (Utf8Handler::read_char(input, current_pos, utf8_char)) {
-        // UTF-8 字符有效，同步 tracker 的位置
-        while (tracker.get_position() < current_pos) {
-          advance();
-        }
-      } else {
-        // 遇到无效的 UTF-8 序列，标识符在此处结束
-        break;
-      }
-    } else {
+  // 标识符可以包含字母、数字、下划线以及有效的多字节 UTF-8 字符。
+  // NOTE: ASCII 部分交给扫描内核整段跳过，多字节部分由 Utf8Handler 批量
+  //       验证，二者交替直到都无法前进（遇到其他字符或无效的 UTF-8 序列），
+  //       最后一次性推进 tracker。
+  size_t end = start;
+  while (true) {
+    size_t next = scan::scan_identifier(data, end, input.size());
+    next = Utf8Handler::skip_multibyte(data, next, input.size());
+    if (next == end) {
       break;
     }
+    end = next;
   }
+  advance_to(end);
 
-  size_t current_pos = tracker.get_position();
-  const auto& input = tracker.get_input();
-  std::string value(input.data() + start, current_pos - start);
+  std::string_view text(data + start, end - start);
 
   // 检查解析出的字符串是否是语言的关键字。
-  auto keyword_type = get_keyword(value);
+  auto keyword_type = get_keyword(text);
   // 如果是关键字，则使用关键字的 Token 类型；否则，它是一个普通的标识符。
   TokenType token_type = keyword_type.value_or(TokenType::Identifier);
 
-  return Token(token_type, value, token_line, token_column);
+  Token token(token_type, span_mode ? std::string() : std::string(text),
+              token_line, token_column);
+  if (interner != nullptr && token_type == TokenType::Identifier) {
+    token.symbol = interner->intern(text).get_symbol();
+  }
+  return token;
 }
 
 Lexer::Lexer(const std::string& input_str, const std::string& fname)
@@ -190,6 +208,36 @@ Lexer::Lexer(const std::string& input_str, const std::string& fname)
   }
 }
 
+Lexer::Lexer(std::string&& input_str, const std::string& fname)
+    : tracker(std::move(input_str), fname) {
+  const auto& input = tracker.get_input();
+  if (!input.empty()) {
+    current_char = input[0];
+  } else {
+    current_char = std::nullopt;
+  }
+}
+
+Lexer::Lexer(std::shared_ptr<const utils::SourceBuffer> source,
+             const std::string& fname)
+    : tracker(std::move(source), fname) {
+  const auto& input = tracker.get_input();
+  if (!input.empty()) {
+    current_char = input[0];
+  } else {
+    current_char = std::nullopt;
+  }
+}
+
+Lexer::Lexer(const utils::SourceBuffer& input, const std::string& fname)
+    : tracker(input, fname) {
+  if (input.size() > 0) {
+    current_char = input.view()[0];
+  } else {
+    current_char = std::nullopt;
+  }
+}
+
 Token Lexer::next_token() {
   // --- 主循环：跳过空白 ---
   // NOTE: 这个循环是词法分析器的"空转"阶段。它的任务是不断地跳过
@@ -197,184 +245,72 @@ Token Lexer::next_token() {
   //       或者到达文件末尾。注释现在被视为有效的 Token。
   skip_whitespace();
 
-  // 如果在跳过空白后到达了文件末尾，则返回 EOF Token。
-  if (!current_char.has_value()) {
-    return Token::makeEOF();
-  }
-
-  // 检查是否是注释
-  if (current_char == '/' && peek(1) == '/') {
-    return read_comment();
-  }
-
-  char ch = current_char.value();
-  unsigned char uch = static_cast<unsigned char>(ch);
-  size_t token_line = tracker.get_line();
-  size_t token_column = tracker.get_column();
-
-  // --- Token 解析分派 ---
-  // 这是一个典型的词法分析器状态机分派逻辑。
+  size_t start = tracker.get_position();
+  Token token = scan_token();
+  size_t end = tracker.get_position();
 
-  if (std::isdigit(static_cast<unsigned char>(ch))) {
-    return read_number();
+  // NOTE: 注释会连同行尾的换行符一起被消耗，但换行符不属于注释文本，
+  //       因此需要从区间中排除。
+  const auto& input = tracker.get_input();
+  if (token.token_type == TokenType::Comment && end > start &&
+      input[end - 1] == '\n') {
+    --end;
   }
 
-  if (std::isalpha(static_cast<unsigned char>(ch)) || ch == '_' ||
-      uch >= 0x80) {
-    // 特殊情况：`r"` 前缀表示原始字符串。
-    if (ch == 'r' && peek(1) == '"') {
-      return read_raw_string();
-    }
-    return read_identifier();
-  }
+  token.offset = start;
+  token.length = end - start;
+  return token;
+}
 
-  if (ch == '"') {
-    return read_string();
+Token Lexer::scan_token() {
+  // 如果在跳过空白后到达了文件末尾，则返回 EOF Token。
+  // NOTE: 达到错误上限后同样提前返回 EOF，之后的输入不再分析。
+  if (!current_char.has_value() || error_collector.limit_reached()) {
+    return Token::makeEOF();
   }
 
-  // 当前语言不支持单引号字符字面量，因此将其视为未知 Token。
-  if (ch == '\'') {
-    Token token(TokenType::Unknown, "'", token_line, token_column);
-    advance();
-    return token;
-  }
+  // --- Token 解析分派 ---
+  // NOTE: 首字节查一次字符类别表，再按类别跳转到对应的处理函数，
+  //       取代逐个调用 `isdigit` / `isalpha` 并层层比较的分支链。
+  //       表的顺序必须与 `CharClass` 的枚举值一致。
+  using Handler = Token (Lexer::*)();
+  static constexpr std::array<Handler, CHAR_CLASS_COUNT> HANDLERS = {
+      &Lexer::read_unknown,  // CharClass::Other
+      &Lexer::read_unknown,  // CharClass::Whitespace（跳过空白后不会出现）
+      &Lexer::read_number,   // CharClass::Digit
+      &Lexer::read_word,     // CharClass::IdentStart
+      &Lexer::read_string,   // CharClass::Quote
+      &Lexer::read_operator, // CharClass::Operator
+  };
+
+  auto cls = static_cast<size_t>(char_class(current_char.value()));
+  return (this->*HANDLERS[cls])();
+}
 
-  Token token(TokenType::Unknown, "", token_line, token_column);
-
-  // --- 处理单字符和双字符运算符及分隔符 ---
-  // NOTE: 对于可能构成双字符运算符（如 `+=`, `==`）的字符，词法分析器
-  //       必须向前“看”一个字符（peek）来做出决定。如果匹配，则消耗两个
-  //       字符并返回双字符 Token；否则，只消耗当前字符并返回单字符 Token。
-  //       这种策略被称为“最大匹配原则”（Maximal Munch Principle）。
-  switch (ch) {
-  case '+':
-    token = peek(1) == '='
-                ? (advance(),
-                   Token(TokenType::PlusEqual, "+=", token_line, token_column))
-                : Token(TokenType::Plus, "+", token_line, token_column);
-    break;
-  case '-':
-    if (peek(1) == '=') {
-      advance();
-      token = Token(TokenType::MinusEqual, "-=", token_line, token_column);
-    } else if (peek(1) == '>') {
-      advance();
-      token = Token(TokenType::Arrow, "->", token_line, token_column);
-    } else {
-      token = Token(TokenType::Minus, "-", token_line, token_column);
-    }
-    break;
-  case '*':
-    token = peek(1) == '='
-                ? (advance(),
-                   Token(TokenType::StarEqual, "*=", token_line, token_column))
-                : Token(TokenType::Star, "*", token_line, token_column);
-    break;
-  case '/':
-    token = peek(1) == '='
-                ? (advance(),
-                   Token(TokenType::SlashEqual, "/=", token_line, token_column))
-                : Token(TokenType::Slash, "/", token_line, token_column);
-    break;
-  case '%':
-    token = peek(1) == '='
-                ? (advance(), Token(TokenType::PercentEqual, "%=", token_line,
-                                    token_column))
-                : Token(TokenType::Percent, "%", token_line, token_column);
-    break;
-  case '=':
-    token = peek(1) == '='
-                ? (advance(),
-                   Token(TokenType::EqualEqual, "==", token_line, token_column))
-                : Token(TokenType::Equal, "=", token_line, token_column);
-    break;
-  case '!':
-    token = peek(1) == '='
-                ? (advance(),
-                   Token(TokenType::BangEqual, "!=", token_line, token_column))
-                : Token(TokenType::Bang, "!", token_line, token_column);
-    break;
-  case '~':
-    token = Token(TokenType::Tilde, "~", token_line, token_column);
-    break;
-  case '<':
-    token = peek(1) == '='
-                ? (advance(),
-                   Token(TokenType::LessEqual, "<=", token_line, token_column))
-                : Token(TokenType::Less, "<", token_line, token_column);
-    break;
-  case '>':
-    token = peek(1) == '='
-                ? (advance(), Token(TokenType::GreaterEqual, ">=", token_line,
-                                    token_column))
-                : Token(TokenType::Greater, ">", token_line, token_column);
-    break;
-  case '&':
-    if (peek(1) == '&') {
-      advance();
-      token = Token(TokenType::AndAnd, "&&", token_line, token_column);
-    } else {
-      token = Token(TokenType::And, "&", token_line, token_column);
-    }
-    break;
-  case '|':
-    if (peek(1) == '|') {
-      advance();
-      token = Token(TokenType::OrOr, "||", token_line, token_column);
-    } else {
-      token = Token(TokenType::Or, "|", token_line, token_column);
-    }
-    break;
-  case '(':
-    token = Token(TokenType::LeftParen, "(", token_line, token_column);
-    break;
-  case ')':
-    token = Token(TokenType::RightParen, ")", token_line, token_column);
-    break;
-  case '{':
-    token = Token(TokenType::LeftBrace, "{", token_line, token_column);
-    break;
-  case '}':
-    token = Token(TokenType::RightBrace, "}", token_line, token_column);
-    break;
-  case '[':
-    token = Token(TokenType::LeftBracket, "[", token_line, token_column);
-    break;
-  case ']':
-    token = Token(TokenType::RightBracket, "]", token_line, token_column);
-    break;
-  case ',':
-    token = Token(TokenType::Comma, ",", token_line, token_column);
-    break;
-  case ';':
-    token = Token(TokenType::Semicolon, ";", token_line, token_column);
-    break;
-  case ':':
-    token = Token(TokenType::Colon, ":", token_line, token_column);
-    break;
-  case '.':
-    if (peek(1) == '.') {
-      advance();
-      token = Token(TokenType::DotDot, "..", token_line, token_column);
-    } else {
-      token = Token(TokenType::Dot, ".", token_line, token_column);
-    }
-    break;
-  default:
-    // 如果字符不匹配任何已知的 Token 模式，则将其标记为 Unknown。
-    token =
-        Token(TokenType::Unknown, std::string(1, ch), token_line, token_column);
-    break;
+Token Lexer::read_word() {
+  // 特殊情况：`r"` 前缀表示原始字符串。
+  if (current_char == 'r' && peek(1) == '"') {
+    return read_raw_string();
   }
+  return read_identifier();
+}
 
-  // 消耗当前字符，为下一次调用 `next_token` 做准备。
+Token Lexer::read_unknown() {
+  // NOTE: 当前语言不支持单引号字符字面量，单引号与其他无法识别的字节
+  //       一样被视为未知 Token。
+  Token token(TokenType::Unknown, std::string(1, current_char.value()),
+              tracker.get_line(), tracker.get_column());
   advance();
   return token;
 }
 
 std::vector<Token> Lexer::tokenize() {
+  CZC_TIME_PHASE(Lex);
+  // NOTE: 按输入长度一次预留，避免大文件的 Token 序列反复扩容与搬移；
+  //       词法分析结束后再以实际的 Token 数修正估计。
+  const size_t input_size = tracker.get_input().size();
   std::vector<Token> tokens;
-  tokens.reserve(256); // 预分配以提高性能
+  tokens.reserve(utils::CapacityEstimate::estimate_tokens(input_size));
 
   while (true) {
     Token token = next_token();
@@ -386,7 +322,63 @@ std::vector<Token> Lexer::tokenize() {
     }
   }
 
+  utils::CapacityEstimate::observe_tokens(input_size, tokens.size());
+  CZC_COUNT(Lex, Tokens, tokens.size());
+  CZC_COUNT(Lex, Errors, error_collector.count());
   return tokens;
 }
 
+TokenSpanList Lexer::tokenize_spans() {
+  const auto& input = tracker.get_input();
+  // NOTE: TokenSpan 以 32 位记录偏移与长度。
+  if (input.size() > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("source too large for TokenSpan (> 4 GiB)");
+  }
+  // NOTE: 跟踪器共享持有源码时容器直接共享同一份缓冲区；借用调用方的
+  //       `SourceBuffer` 时无法延长其生命周期，只能复制一份。
+  const auto& shared = tracker.get_shared_input();
+  TokenSpanList spans(shared ? shared
+                             : std::make_shared<const utils::SourceBuffer>(
+                                   std::string(input)));
+  spans.reserve(utils::CapacityEstimate::estimate_tokens(input.size()));
+
+  span_mode = true;
+  while (true) {
+    Token token = next_token();
+
+    TokenSpan span;
+    span.token_type = token.token_type;
+    span.offset = static_cast<uint32_t>(token.offset);
+    span.length = static_cast<uint32_t>(token.length);
+    if (token.is_raw_string) {
+      span.flags |= TokenSpan::FLAG_RAW_STRING;
+    }
+
+    // NOTE: 零拷贝模式下，标识符、数字、注释和字符串都不会构造 `value`。
+    //       前三者的值直接取自源码切片；字符串的加工值在 `cooked_string`
+    //       中，不含转义时它就是源码切片，否则由 TokenSpanList 复制保存。
+    if (token.token_type == TokenType::String) {
+      spans.push_back(span, cooked_string);
+    } else if (token.value.empty()) {
+      spans.push_back(span, std::string_view(input.data() + token.offset,
+                                             token.length));
+    } else {
+      spans.push_back(span, token.value);
+    }
+
+    if (token.token_type == TokenType::EndOfFile) {
+      break;
+    }
+  }
+  span_mode = false;
+  utils::CapacityEstimate::observe_tokens(input.size(), spans.size());
+
+  // 行索引已在扫描过程中建好，直接交给容器，行列号由它按需推算。
+  const auto& line_offsets = tracker.get_line_offsets();
+  spans.set_line_starts(
+      std::vector<uint32_t>(line_offsets.begin(), line_offsets.end()));
+
+  return spans;
+}
+
 } // namespace czc::lexer
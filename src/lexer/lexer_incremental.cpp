@@ -0,0 +1,149 @@
+/**
+ * @file lexer_incremental.cpp
+ * @brief 面向编辑器集成的增量词法分析实现。
+ * @details
+ *   词法分析器在任意 Token 起点处都处于同一初始状态（不在字符串或注释中），
+ *   因此只要重新分析得到的 Token 越过编辑区间后，其起点与旧序列中某个
+ *   Token 的起点对齐，之后的字节完全相同，结果也必然相同，可以直接沿用。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/lexer/lexer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace czc::lexer {
+
+namespace {
+
+/**
+ * @brief 判断旧 Token 是否可能受到从 `edit_offset` 开始的编辑影响。
+ * @details 扫描器在 Token 结尾之后最多再查看一个字节（`peek(1)`），
+ *          因此紧跟在结尾之后的字节被修改同样可能改变该 Token。
+ */
+bool may_be_affected(const Token& token, size_t edit_offset) {
+  return token.offset + token.length + 1 >= edit_offset;
+}
+
+size_t shift_offset(size_t offset, std::ptrdiff_t delta) {
+  return static_cast<size_t>(static_cast<std::ptrdiff_t>(offset) + delta);
+}
+
+} // namespace
+
+RelexRange Lexer::relex(std::vector<Token>& tokens, const SourceEdit& edit) {
+  // --- 校验旧序列与编辑区间 ---
+  // 旧序列以 EOF 结尾，EOF 的偏移即旧源码的长度。
+  size_t new_size = tracker.get_input().size();
+  bool well_formed = !tokens.empty() &&
+                     tokens.back().token_type == TokenType::EndOfFile &&
+                     edit.offset + edit.length <= tokens.back().offset &&
+                     tokens.back().offset - edit.length + edit.text.size() ==
+                         new_size;
+  if (!well_formed) {
+    size_t removed = tokens.size();
+    tokens = tokenize();
+    return {0, removed, tokens.size()};
+  }
+
+  const size_t eof_index = tokens.size() - 1;
+  const std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(edit.text.size()) -
+                               static_cast<std::ptrdiff_t>(edit.length);
+  const size_t new_edit_end = edit.offset + edit.text.size();
+
+  // --- 确定恢复点 ---
+  // Token 的结尾单调递增，二分找到第一个可能受影响的 Token。
+  auto affected = std::partition_point(
+      tokens.begin(), tokens.begin() + static_cast<std::ptrdiff_t>(eof_index),
+      [&](const Token& token) { return !may_be_affected(token, edit.offset); });
+  size_t first = static_cast<size_t>(affected - tokens.begin());
+
+  // NOTE: 恢复点不能晚于编辑点。若该 Token 整体位于编辑点之后（编辑发生在
+  //       空白中），则改从前一个 Token 开始；前面没有 Token 时从头开始。
+  if (first == eof_index || tokens[first].offset > edit.offset) {
+    if (first > 0) {
+      --first;
+    }
+  }
+  if (first < eof_index && tokens[first].offset <= edit.offset) {
+    seek(tokens[first].offset, tokens[first].line, tokens[first].column);
+  }
+
+  // --- 重新分析，直到与旧序列重新同步 ---
+  std::vector<Token> window;
+  size_t old_cursor = first;
+  size_t resync = tokens.size(); // 旧序列中第一个直接沿用的 Token
+  while (true) {
+    Token token = next_token();
+    bool is_eof = token.token_type == TokenType::EndOfFile;
+
+    if (!is_eof && token.offset >= new_edit_end) {
+      size_t old_offset = shift_offset(token.offset, -delta);
+      while (old_cursor < eof_index && tokens[old_cursor].offset < old_offset) {
+        ++old_cursor;
+      }
+      if (old_cursor < eof_index && tokens[old_cursor].offset == old_offset &&
+          tokens[old_cursor].token_type == token.token_type) {
+        resync = old_cursor + 1;
+        window.push_back(std::move(token));
+        break;
+      }
+    }
+
+    window.push_back(std::move(token));
+    if (is_eof) {
+      break;
+    }
+  }
+
+  // --- 平移沿用的旧 Token ---
+  // 以同步点为锚：之后的 Token 行号整体平移；与锚点同一行的 Token
+  // 还需平移列号，更靠后的行列号不受影响。EOF 的行列号固定为 0。
+  if (resync < tokens.size()) {
+    const Token& anchor_old = tokens[resync - 1];
+    const Token& anchor_new = window.back();
+    size_t anchor_line = anchor_old.line;
+    auto line_delta = static_cast<std::ptrdiff_t>(anchor_new.line) -
+                      static_cast<std::ptrdiff_t>(anchor_old.line);
+    auto column_delta = static_cast<std::ptrdiff_t>(anchor_new.column) -
+                        static_cast<std::ptrdiff_t>(anchor_old.column);
+
+    for (size_t i = resync; i < tokens.size(); ++i) {
+      Token& token = tokens[i];
+      token.offset = shift_offset(token.offset, delta);
+      if (token.token_type == TokenType::EndOfFile) {
+        continue;
+      }
+      if (token.line == anchor_line) {
+        token.column = shift_offset(token.column, column_delta);
+      }
+      token.line = shift_offset(token.line, line_delta);
+    }
+  }
+
+  // --- 就地替换窗口 ---
+  // 先覆盖重叠部分，再插入或删除差额，避免重建整个序列。
+  size_t removed = resync - first;
+  size_t inserted = window.size();
+  size_t common = std::min(removed, inserted);
+  auto window_begin = tokens.begin() + static_cast<std::ptrdiff_t>(first);
+  std::move(window.begin(),
+            window.begin() + static_cast<std::ptrdiff_t>(common), window_begin);
+  if (inserted > removed) {
+    tokens.insert(
+        window_begin + static_cast<std::ptrdiff_t>(common),
+        std::make_move_iterator(window.begin() +
+                                static_cast<std::ptrdiff_t>(common)),
+        std::make_move_iterator(window.end()));
+  } else {
+    tokens.erase(window_begin + static_cast<std::ptrdiff_t>(common),
+                 window_begin + static_cast<std::ptrdiff_t>(removed));
+  }
+
+  return {first, removed, inserted};
+}
+
+} // namespace czc::lexer
@@ -9,6 +9,7 @@
 
 #include "czc/diagnostics/diagnostic_code.hpp"
 #include "czc/lexer/lexer.hpp"
+#include "czc/lexer/number_decoder.hpp"
 
 namespace czc::lexer {
 
@@ -57,9 +58,11 @@ Token Lexer::read_prefixed_number(const std::string& valid_chars,
   }
 
   const auto& input = tracker.get_input();
-  return Token(TokenType::Integer,
-               std::string(input.data() + start, current_pos - start),
-               token_line, token_column);
+  std::string_view text(input.data() + start, current_pos - start);
+  Token token(TokenType::Integer, span_mode ? std::string() : std::string(text),
+              token_line, token_column);
+  decode_numeric_value(token, text);
+  return token;
 }
 
 Token Lexer::read_number() {
@@ -168,21 +171,37 @@ Token Lexer::read_number() {
 
   size_t current_pos = tracker.get_position();
   const auto& input = tracker.get_input();
-  std::string value(input.data() + start, current_pos - start);
+  std::string_view text(input.data() + start, current_pos - start);
+  // NOTE: 零拷贝模式下数字文本与源码完全一致，不需要构造字符串。
+  std::string value = span_mode ? std::string() : std::string(text);
 
   // --- 根据解析过程中设置的标志，确定最终的 Token 类型 ---
   if (is_scientific) {
     // NOTE: 所有科学计数法字面量都被暂时标记为 `ScientificExponent`。
     //       这是因为在词法分析阶段，我们只关心其语法形式，而不关心其
     //       具体的值。其最终类型（整数或浮点数）的推断和溢出检查将在
-    //       后续的 TokenPreprocessor 阶段完成。
-    return Token(TokenType::ScientificExponent, value, token_line,
-                 token_column);
-  }
-  if (is_float) {
-    return Token(TokenType::Float, value, token_line, token_column);
+    //       后续的 TokenPreprocessor 阶段完成，或在设置了分类器时就地完成。
+    Token token(TokenType::ScientificExponent, value, token_line,
+                token_column);
+    if (scientific_classifier != nullptr) {
+      if (span_mode) {
+        // NOTE: 零拷贝模式下 Token 不带文本，只为分类临时构造一个副本。
+        Token literal(TokenType::ScientificExponent, std::string(text),
+                      token_line, token_column);
+        token.token_type = scientific_classifier->classify(literal);
+      } else {
+        token.token_type = scientific_classifier->classify(token);
+      }
+      // 分类之后类型才确定，此时才能按整数或浮点数解码。
+      decode_numeric_value(token, text);
+    }
+    return token;
   }
-  return Token(TokenType::Integer, value, token_line, token_column);
+  // NOTE: 数字已经扫描过一遍，顺带解码其值，之后的阶段不必再解析文本。
+  Token token(is_float ? TokenType::Float : TokenType::Integer,
+              value, token_line, token_column);
+  decode_numeric_value(token, text);
+  return token;
 }
 
 } // namespace czc::lexer
\ No newline at end of file
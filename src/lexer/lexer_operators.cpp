@@ -7,137 +7,66 @@
  * @date 2025-11-14
  */
 
-#include "czc/diagnostics/diagnostic_code.hpp"
+#include "czc/lexer/char_class.hpp"
 #include "czc/lexer/lexer.hpp"
 
 namespace czc::lexer {
 
-std::optional<Token> Lexer::try_read_two_char_operator(char first_char,
-                                                       size_t token_line,
-                                                       size_t token_column) {
-  std::optional<char> next = peek(1);
-  if (!next.has_value()) {
-    return std::nullopt;
+namespace {
+
+constexpr bool operator_table_is_complete() {
+  for (size_t c = 0; c < CHAR_CLASS_TABLE.size(); ++c) {
+    if (CHAR_CLASS_TABLE[c] == CharClass::Operator &&
+        OPERATOR_TABLE[c].single == TokenType::Unknown) {
+      return false;
+    }
   }
+  return true;
+}
 
-  char second_char = next.value();
+// 每个被分类为 Operator 的字节都必须有对应的单字符运算符。
+static_assert(operator_table_is_complete(),
+              "every CharClass::Operator byte needs an OPERATOR_TABLE entry");
 
-  // Helper lambda to advance and create token
-  auto make_two_char_token = [&](TokenType type,
-                                 const std::string& value) -> Token {
-    advance();
-    return Token(type, value, token_line, token_column);
-  };
+} // namespace
 
-  switch (first_char) {
-  case '+':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::PlusEqual, "+=");
-    break;
-  case '-':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::MinusEqual, "-=");
-    if (second_char == '>')
-      return make_two_char_token(TokenType::Arrow, "->");
-    break;
-  case '*':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::StarEqual, "*=");
-    break;
-  case '/':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::SlashEqual, "/=");
-    break;
-  case '%':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::PercentEqual, "%=");
-    break;
-  case '=':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::EqualEqual, "==");
-    break;
-  case '!':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::BangEqual, "!=");
-    break;
-  case '<':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::LessEqual, "<=");
-    break;
-  case '>':
-    if (second_char == '=')
-      return make_two_char_token(TokenType::GreaterEqual, ">=");
-    break;
-  case '&':
-    if (second_char == '&')
-      return make_two_char_token(TokenType::AndAnd, "&&");
-    break;
-  case '|':
-    if (second_char == '|')
-      return make_two_char_token(TokenType::OrOr, "||");
-    break;
-  case '.':
-    if (second_char == '.')
-      return make_two_char_token(TokenType::DotDot, "..");
-    break;
-  default:
-    break;
+Token Lexer::read_operator() {
+  // 检查是否是注释
+  if (current_char == '/' && peek(1) == '/') {
+    return read_comment();
   }
 
-  return std::nullopt;
-}
+  size_t token_line = tracker.get_line();
+  size_t token_column = tracker.get_column();
+  const OperatorEntry& entry =
+      OPERATOR_TABLE[static_cast<unsigned char>(current_char.value())];
 
-Token Lexer::read_single_char_token(char ch, size_t token_line,
-                                    size_t token_column) {
-  switch (ch) {
-  case '+':
-    return Token(TokenType::Plus, "+", token_line, token_column);
-  case '-':
-    return Token(TokenType::Minus, "-", token_line, token_column);
-  case '*':
-    return Token(TokenType::Star, "*", token_line, token_column);
-  case '/':
-    return Token(TokenType::Slash, "/", token_line, token_column);
-  case '%':
-    return Token(TokenType::Percent, "%", token_line, token_column);
-  case '=':
-    return Token(TokenType::Equal, "=", token_line, token_column);
-  case '!':
-    return Token(TokenType::Bang, "!", token_line, token_column);
-  case '~':
-    return Token(TokenType::Tilde, "~", token_line, token_column);
-  case '<':
-    return Token(TokenType::Less, "<", token_line, token_column);
-  case '>':
-    return Token(TokenType::Greater, ">", token_line, token_column);
-  case '&':
-    return Token(TokenType::And, "&", token_line, token_column);
-  case '|':
-    return Token(TokenType::Or, "|", token_line, token_column);
-  case '(':
-    return Token(TokenType::LeftParen, "(", token_line, token_column);
-  case ')':
-    return Token(TokenType::RightParen, ")", token_line, token_column);
-  case '{':
-    return Token(TokenType::LeftBrace, "{", token_line, token_column);
-  case '}':
-    return Token(TokenType::RightBrace, "}", token_line, token_column);
-  case '[':
-    return Token(TokenType::LeftBracket, "[", token_line, token_column);
-  case ']':
-    return Token(TokenType::RightBracket, "]", token_line, token_column);
-  case ',':
-    return Token(TokenType::Comma, ",", token_line, token_column);
-  case ';':
-    return Token(TokenType::Semicolon, ";", token_line, token_column);
-  case ':':
-    return Token(TokenType::Colon, ":", token_line, token_column);
-  case '.':
-    return Token(TokenType::Dot, ".", token_line, token_column);
-  default:
-    return Token(TokenType::Unknown, std::string(1, ch), token_line,
-                 token_column);
+  TokenType type = entry.single;
+  std::string_view text = entry.single_text;
+
+  // --- 处理双字符运算符 ---
+  // NOTE: 对于可能构成双字符运算符（如 `+=`, `->`）的字符，词法分析器
+  //       必须向前“看”一个字符（peek）来做出决定。如果匹配，则消耗两个
+  //       字符并返回双字符 Token；否则，只消耗当前字符并返回单字符 Token。
+  //       这种策略被称为“最大匹配原则”（Maximal Munch Principle）。
+  if (entry.pair_count > 0) {
+    std::optional<char> next = peek(1);
+    for (uint8_t i = 0; next.has_value() && i < entry.pair_count; ++i) {
+      if (entry.pair_second[i] == next.value()) {
+        type = entry.pair_type[i];
+        text = entry.pair_text[i];
+        advance();
+        break;
+      }
+    }
   }
+
+  // 消耗当前字符，为下一次调用 `next_token` 做准备。
+  advance();
+
+  // NOTE: 运算符文本与源码一致，零拷贝模式下无需构造 `value`。
+  return Token(type, span_mode ? std::string() : std::string(text),
+               token_line, token_column);
 }
 
-} // namespace czc::lexer
\ No newline at end of file
+} // namespace czc::lexer
@@ -0,0 +1,296 @@
+/**
+ * @file lexer_parallel.cpp
+ * @brief 大文件的并行分块词法分析实现。
+ * @details
+ *   先用一个只识别字符串、原始字符串和注释的轻量状态机扫描一遍输入，
+ *   在目标位置附近找到安全的换行符作为切分点；各块随后在线程池上独立
+ *   分析，最后按顺序拼接并修正位置信息。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/lexer/lexer.hpp"
+#include "czc/lexer/scan_kernels.hpp"
+#include "czc/utils/string_interner.hpp"
+#include "czc/utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <future>
+
+namespace czc::lexer {
+
+namespace {
+
+/**
+ * @brief 一个切分点：块的起始字节偏移及其所在行号（列号总是 1）。
+ */
+struct ChunkBoundary {
+  size_t offset;
+  size_t line;
+};
+
+/**
+ * @brief 单个分块的分析结果。
+ */
+struct ChunkResult {
+  std::vector<Token> tokens;
+  std::vector<LexerError> errors;
+};
+
+inline bool is_identifier_byte(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+}
+
+/**
+ * @brief 扫描输入，选出最多 `chunk_count - 1` 个安全的切分点。
+ * @details
+ *   切分点总是紧跟在一个不属于字符串或原始字符串的换行符之后；
+ *   单行注释会在换行符处结束，因此注释末尾的换行符也是安全的。
+ *   状态机只需区分字符串的种类以正确处理反斜杠转义，
+ *   任何判断失误都会在拼接时被检测出来。
+ * @return 切分点列表，第一个元素总是 `{0, 1}`。
+ */
+std::vector<ChunkBoundary> find_chunk_boundaries(const char* data, size_t size,
+                                                 size_t chunk_count) {
+  enum class State { Code, String, RawString, Comment };
+
+  std::vector<ChunkBoundary> boundaries;
+  boundaries.reserve(chunk_count);
+  boundaries.push_back({0, 1});
+
+  State state = State::Code;
+  size_t line = 1;
+  size_t next_target = size / chunk_count;
+
+  auto on_safe_newline = [&](size_t i) {
+    size_t offset = i + 1;
+    if (offset >= next_target && offset < size &&
+        boundaries.size() < chunk_count) {
+      boundaries.push_back({offset, line});
+      // 跳过已经越过的目标位置，保证切分点严格递增。
+      while (next_target <= offset) {
+        next_target += size / chunk_count;
+      }
+    }
+  };
+
+  for (size_t i = 0; i < size; ++i) {
+    char c = data[i];
+    switch (state) {
+    case State::Code:
+      if (c == '"') {
+        // 与 Lexer::read_word 一致：只有单独的 `r` 后紧跟 `"` 才是原始字符串。
+        bool raw = i > 0 && data[i - 1] == 'r' &&
+                   !(i > 1 && is_identifier_byte(
+                                  static_cast<unsigned char>(data[i - 2])));
+        state = raw ? State::RawString : State::String;
+      } else if (c == '/' && i + 1 < size && data[i + 1] == '/') {
+        state = State::Comment;
+        ++i;
+      } else if (c == '\n') {
+        ++line;
+        on_safe_newline(i);
+      }
+      break;
+    case State::String:
+      if (c == '\\' && i + 1 < size) {
+        // 被转义的字符（包括换行符）不会结束字符串。
+        if (data[i + 1] == '\n') {
+          ++line;
+        }
+        ++i;
+      } else if (c == '"') {
+        state = State::Code;
+      } else if (c == '\n') {
+        ++line;
+      }
+      break;
+    case State::RawString:
+      if (c == '"') {
+        state = State::Code;
+      } else if (c == '\n') {
+        ++line;
+      }
+      break;
+    case State::Comment:
+      if (c == '\n') {
+        ++line;
+        state = State::Code;
+        on_safe_newline(i);
+      }
+      break;
+    }
+  }
+
+  return boundaries;
+}
+
+/**
+ * @brief 分析一个分块。
+ */
+ChunkResult lex_chunk(const char* data, size_t begin, size_t end,
+                      const std::string& filename,
+                      utils::StringInterner* interner) {
+  // NOTE: 分块直接借用整个输入中的一段，不为每块复制源码。
+  auto chunk = utils::SourceBuffer::borrow(
+      std::string_view(data + begin, end - begin));
+  Lexer lexer(chunk, filename);
+  lexer.set_interner(interner);
+  ChunkResult result;
+  result.tokens = lexer.tokenize();
+  result.errors = lexer.get_errors().get_errors();
+  return result;
+}
+
+/**
+ * @brief 检查分块的结尾是否确实是一个 Token 边界。
+ * @details 分块总是以换行符结尾。只有跨行的字符串才可能包含这个换行符；
+ *          若最后一个 Token 恰好延伸到分块末尾，说明切分点落在了 Token 内部，
+ *          串行分析时该 Token 会继续延伸到下一块。
+ */
+bool ends_on_token_boundary(const ChunkResult& chunk, size_t chunk_size) {
+  // tokens 的最后一个元素总是 EOF。
+  if (chunk.tokens.size() < 2) {
+    return true;
+  }
+  const Token& last = chunk.tokens[chunk.tokens.size() - 2];
+  return last.offset + last.length < chunk_size;
+}
+
+} // namespace
+
+void Lexer::truncate_at_error(std::vector<Token>& tokens,
+                              const utils::SourceLocation& location) {
+  // NOTE: 串行分析在报告错误的那个 Token 之后立即返回 EOF。错误总是位于
+  //       出错 Token 的起点或其内部，因此保留起点不晚于错误位置的 Token。
+  auto starts_after = [](const utils::SourceLocation& loc, const Token& token) {
+    return loc.line < token.line ||
+           (loc.line == token.line && loc.column < token.column);
+  };
+  // 最后一块的 EOF 已经拼接进来时先去掉它，它的行列号为 0，不参与查找。
+  if (!tokens.empty() && tokens.back().token_type == TokenType::EndOfFile) {
+    tokens.pop_back();
+  }
+  auto end = std::upper_bound(tokens.begin(), tokens.end(), location,
+                              starts_after);
+  tokens.erase(end, tokens.end());
+
+  // EOF 的偏移与串行分析相同：最后一个 Token 之后跳过空白的位置。
+  const auto& input = tracker.get_input();
+  size_t position = 0;
+  if (!tokens.empty()) {
+    position = tokens.back().offset + tokens.back().length;
+  }
+  Token eof = Token::makeEOF();
+  eof.offset = scan::skip_whitespace(input.data(), position, input.size());
+  tokens.push_back(std::move(eof));
+}
+
+std::vector<Token> Lexer::tokenize_parallel(utils::ThreadPool& pool,
+                                            size_t min_chunk_bytes) {
+  const auto& input = tracker.get_input();
+  const char* data = input.data();
+  size_t size = input.size();
+
+  if (min_chunk_bytes == 0) {
+    min_chunk_bytes = 1;
+  }
+  size_t chunk_count = pool.size();
+  if (size / min_chunk_bytes < chunk_count) {
+    chunk_count = size / min_chunk_bytes;
+  }
+  // NOTE: 只能在尚未开始分析时切分，否则各块的位置信息无从对齐。
+  if (chunk_count < 2 || tracker.get_position() != 0 ||
+      error_collector.limit_reached()) {
+    return tokenize();
+  }
+
+  std::vector<ChunkBoundary> boundaries =
+      find_chunk_boundaries(data, size, chunk_count);
+  if (boundaries.size() < 2) {
+    return tokenize();
+  }
+
+  // --- 并行分析各分块 ---
+  const std::string& filename = tracker.get_filename();
+  std::vector<std::future<ChunkResult>> futures;
+  futures.reserve(boundaries.size());
+  for (size_t i = 0; i < boundaries.size(); ++i) {
+    size_t begin = boundaries[i].offset;
+    size_t end = i + 1 < boundaries.size() ? boundaries[i + 1].offset : size;
+    futures.push_back(pool.submit([this, data, begin, end, &filename]() {
+      return lex_chunk(data, begin, end, filename, interner);
+    }));
+  }
+
+  std::vector<ChunkResult> chunks;
+  chunks.reserve(futures.size());
+  for (auto& future : futures) {
+    chunks.push_back(future.get());
+  }
+
+  // --- 校验切分点 ---
+  for (size_t i = 0; i + 1 < chunks.size(); ++i) {
+    size_t chunk_size = boundaries[i + 1].offset - boundaries[i].offset;
+    if (!ends_on_token_boundary(chunks[i], chunk_size)) {
+      return tokenize();
+    }
+  }
+
+  // --- 拼接结果并修正位置信息 ---
+  // NOTE: 每个切分点都位于行首，因此块内的列号无需修正，
+  //       只需平移字节偏移和行号。EOF Token 的行列号固定为 0，保持不变。
+  size_t total_tokens = 0;
+  for (const auto& chunk : chunks) {
+    total_tokens += chunk.tokens.size() - 1;
+  }
+
+  std::vector<Token> tokens;
+  tokens.reserve(total_tokens + 1);
+  bool limit_reached = false;
+  for (size_t i = 0; i < chunks.size() && !limit_reached; ++i) {
+    size_t offset_delta = boundaries[i].offset;
+    size_t line_delta = boundaries[i].line - 1;
+    bool is_last = i + 1 == chunks.size();
+
+    for (auto& token : chunks[i].tokens) {
+      if (token.token_type == TokenType::EndOfFile) {
+        if (!is_last) {
+          continue;
+        }
+      } else {
+        token.line += line_delta;
+      }
+      token.offset += offset_delta;
+      tokens.push_back(std::move(token));
+    }
+
+    for (auto& error : chunks[i].errors) {
+      error.location.line += line_delta;
+      error.location.end_line += line_delta;
+      error_collector.add(error);
+      if (error_collector.limit_reached()) {
+        truncate_at_error(tokens, error.location);
+        limit_reached = true;
+        break;
+      }
+    }
+  }
+
+  // NOTE: 分块 Lexer 不带分类器，因为分类器报告的位置要等行号修正后才正确；
+  //       拼接完成后按顺序补做分类，结果与串行分析一致。
+  if (scientific_classifier != nullptr) {
+    for (auto& token : tokens) {
+      if (token.token_type == TokenType::ScientificExponent) {
+        token.token_type = scientific_classifier->classify(token);
+      }
+    }
+  }
+
+  // 与串行分析一致，分析结束后扫描位置停在输入末尾（或截断处的 EOF）。
+  advance_to(limit_reached ? tokens.back().offset : size);
+  return tokens;
+}
+
+} // namespace czc::lexer
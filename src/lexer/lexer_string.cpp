@@ -9,62 +9,170 @@
 
 #include "czc/diagnostics/diagnostic_code.hpp"
 #include "czc/lexer/lexer.hpp"
+#include "czc/lexer/scan_kernels.hpp"
 #include "czc/lexer/utf8_handler.hpp"
 
-#include <sstream>
-
 namespace czc::lexer {
 
 using diagnostics::DiagnosticCode;
 
-std::string Lexer::parse_unicode_escape(size_t digit_count) {
-  std::string hex_digits;
+namespace {
+
+/**
+ * @brief 获取十六进制数字的值，不是十六进制数字时返回 -1。
+ */
+int hex_digit_value(char ch) noexcept {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  if (ch >= 'a' && ch <= 'f') {
+    return ch - 'a' + 10;
+  }
+  if (ch >= 'A' && ch <= 'F') {
+    return ch - 'A' + 10;
+  }
+  return -1;
+}
+
+} // namespace
+
+void Lexer::parse_unicode_escape(size_t digit_count, std::string& value) {
+  unsigned int codepoint = 0;
 
   for (size_t i = 0; i < digit_count; ++i) {
-    if (!current_char.has_value() ||
-        !std::isxdigit(static_cast<unsigned char>(current_char.value()))) {
+    int digit = current_char.has_value() ? hex_digit_value(*current_char) : -1;
+    if (digit < 0) {
       report_error(DiagnosticCode::L0009_InvalidUnicodeEscape,
                    tracker.get_line(), tracker.get_column(), {"u"});
-      return "";
+      return;
     }
-    hex_digits += current_char.value();
+    codepoint = codepoint * 16 + static_cast<unsigned int>(digit);
     advance();
   }
 
-  unsigned int codepoint;
-  std::stringstream ss;
-  ss << std::hex << hex_digits;
-  ss >> codepoint;
+  // 将解析出的 Unicode 码点以 UTF-8 编码追加到字符串值中。
+  Utf8Handler::append_utf8(value, codepoint);
+}
 
-  // 将解析出的 Unicode 码点转换为 UTF-8 编码的字符串。
-  return Utf8Handler::codepoint_to_utf8(codepoint);
+void Lexer::parse_braced_unicode_escape(std::string& value) {
+  unsigned int codepoint = 0;
+  size_t digit_count = 0;
+
+  while (current_char.has_value() && current_char.value() != '}') {
+    int digit = hex_digit_value(current_char.value());
+    if (digit < 0) {
+      report_error(DiagnosticCode::L0009_InvalidUnicodeEscape,
+                   tracker.get_line(), tracker.get_column(), {"u"});
+      // 尝试恢复：跳过无效内容直到 '}' 或字符串结束
+      while (current_char.has_value() && current_char.value() != '}' &&
+             current_char.value() != '"') {
+        advance();
+      }
+      digit_count = 0; // 标记为失败
+      break;
+    }
+    // NOTE: 超过 6 位的转义无论如何都会被拒绝，不再累加以免溢出。
+    if (digit_count < 6) {
+      codepoint = codepoint * 16 + static_cast<unsigned int>(digit);
+    }
+    ++digit_count;
+    advance();
+  }
+
+  if (!current_char.has_value() || current_char.value() != '}') {
+    report_error(DiagnosticCode::L0009_InvalidUnicodeEscape,
+                 tracker.get_line(), tracker.get_column(), {"u"});
+    return;
+  }
+
+  advance(); // 跳过 '}'
+  if (digit_count > 0 && digit_count <= 6) {
+    Utf8Handler::append_utf8(value, codepoint);
+  } else {
+    report_error(DiagnosticCode::L0009_InvalidUnicodeEscape,
+                 tracker.get_line(), tracker.get_column(), {"u"});
+  }
 }
-std::string Lexer::parse_hex_escape() {
-  std::string hex_digits;
+
+void Lexer::parse_hex_escape(std::string& value) {
+  unsigned int byte_value = 0;
+  size_t digit_count = 0;
 
   // 读取最多 2 个十六进制数字
-  for (size_t i = 0; i < 2; ++i) {
-    if (!current_char.has_value() ||
-        !std::isxdigit(static_cast<unsigned char>(current_char.value()))) {
+  while (digit_count < 2 && current_char.has_value()) {
+    int digit = hex_digit_value(current_char.value());
+    if (digit < 0) {
       break;
     }
-    hex_digits += current_char.value();
+    byte_value = byte_value * 16 + static_cast<unsigned int>(digit);
+    ++digit_count;
     advance();
   }
 
-  if (hex_digits.empty()) {
+  if (digit_count == 0) {
     report_error(DiagnosticCode::L0008_InvalidHexEscape, tracker.get_line(),
                  tracker.get_column(), {"x"});
-    return "";
+    return;
+  }
+
+  value.push_back(static_cast<char>(byte_value));
+}
+
+bool Lexer::try_read_verbatim_string(size_t content_end, size_t start_pos,
+                                     Token& token) {
+  const auto& input = tracker.get_input();
+  size_t content_start = tracker.get_position();
+  if (content_end >= input.size() || input[content_end] != '"' ||
+      Utf8Handler::validate(input.data(), content_start, content_end) !=
+          content_end) {
+    return false;
   }
 
-  // 将十六进制字符串（例如 "FF"）转换为对应的字节值。
-  unsigned int byte_value;
-  std::stringstream ss;
-  ss << std::hex << hex_digits;
-  ss >> byte_value;
+  std::string_view content(input.data() + content_start,
+                           content_end - content_start);
+  advance_to(content_end);
+  advance(); // 跳过结尾的 "
+
+  // NOTE: 零拷贝模式下字符串值就是源码切片本身，不复制；
+  //       否则按确切长度复制一次。
+  if (span_mode) {
+    cooked_string = content;
+  } else {
+    token.value.assign(content.data(), content.size());
+    token.raw_literal.assign(input.data() + start_pos,
+                             tracker.get_position() - start_pos);
+  }
+  return true;
+}
 
-  return std::string(1, static_cast<char>(byte_value));
+void Lexer::finish_string_token(Token& token, std::string& value,
+                                size_t start_pos) {
+  if (span_mode) {
+    cooked_string = value;
+    return;
+  }
+  token.value = std::move(value);
+  // 提取原始字符串字面量文本（从起始位置到当前位置）
+  const auto& input = tracker.get_input();
+  token.raw_literal.assign(input.data() + start_pos,
+                           tracker.get_position() - start_pos);
+}
+
+void Lexer::consume_verbatim_run(std::string& value, size_t run_end) {
+  const auto& input = tracker.get_input();
+  size_t pos = tracker.get_position();
+  size_t valid_end = Utf8Handler::validate(input.data(), pos, run_end);
+
+  value.append(input.data() + pos, valid_end - pos);
+  advance_to(valid_end);
+
+  if (valid_end < run_end) {
+    // NOTE: 此时 tracker 恰好停在无效序列的第一个字节上，错误位置与逐字符
+    //       读取时完全一致。消耗掉这个无效字节，以避免无限循环。
+    report_error(DiagnosticCode::L0011_InvalidUtf8Sequence,
+                 tracker.get_line(), tracker.get_column(), {});
+    advance();
+  }
 }
 
 Token Lexer::read_string() {
@@ -73,8 +181,23 @@ Token Lexer::read_string() {
   size_t start_pos = tracker.get_position(); // 记录起始位置（包括开头的 "）
   advance();                                 // 跳过开头的 "
 
-  std::string value;
-  value.reserve(64); // 预分配以提高性能
+  Token token(TokenType::String, std::string(), token_line, token_column);
+
+  // --- 快速路径：不含转义序列的字符串 ---
+  // NOTE: 绝大多数字符串不含 `\`。批量扫描到的第一个分隔符若是结尾的 `"`，
+  //       且其间的内容是有效的 UTF-8，字符串值就是这段源码本身。
+  const auto& input = tracker.get_input();
+  if (try_read_verbatim_string(
+          scan::find_string_delimiter(input.data(), tracker.get_position(),
+                                      input.size()),
+          start_pos, token)) {
+    return token;
+  }
+
+  // 零拷贝模式下在复用的缓冲区中构造加工值，不为每个字符串分配内存。
+  std::string owned_value;
+  std::string& value = span_mode ? string_scratch : owned_value;
+  value.clear();
   bool terminated = false;
 
   while (current_char.has_value()) {
@@ -85,12 +208,6 @@ Token Lexer::read_string() {
       break;
     }
 
-    if (ch == '\n') { // 允许字符串跨行
-      value += ch;
-      advance();
-      continue;
-    }
-
     if (ch == '\\') {
       // --- 处理转义序列 ---
       advance(); // 消耗反斜杠 '\'
@@ -131,47 +248,15 @@ Token Lexer::read_string() {
         break;
       case 'x': // 十六进制转义 \xHH
         advance();
-        value += parse_hex_escape();
+        parse_hex_escape(value);
         break;
       case 'u': // Unicode 转义 \uXXXX or \u{...}
         advance();
         if (current_char.has_value() && current_char.value() == '{') {
-          // \u{XXXXXX} 格式
           advance(); // 跳过 '{'
-          std::string hex_digits;
-          while (current_char.has_value() && current_char.value() != '}') {
-            if (!std::isxdigit(
-                    static_cast<unsigned char>(current_char.value()))) {
-              report_error(DiagnosticCode::L0009_InvalidUnicodeEscape,
-                           tracker.get_line(), tracker.get_column(), {"u"});
-              // 尝试恢复：跳过无效内容直到 '}' 或字符串结束
-              while (current_char.has_value() && current_char.value() != '}' &&
-                     current_char.value() != '"') {
-                advance();
-              }
-              hex_digits.clear(); // 标记为失败
-              break;
-            }
-            hex_digits += current_char.value();
-            advance();
-          }
-
-          if (!current_char.has_value() || current_char.value() != '}') {
-            report_error(DiagnosticCode::L0009_InvalidUnicodeEscape,
-                         tracker.get_line(), tracker.get_column(), {"u"});
-          } else {
-            advance(); // 跳过 '}'
-            if (!hex_digits.empty() && hex_digits.length() <= 6) {
-              unsigned int codepoint = std::stoul(hex_digits, nullptr, 16);
-              value += Utf8Handler::codepoint_to_utf8(codepoint);
-            } else {
-              report_error(DiagnosticCode::L0009_InvalidUnicodeEscape,
-                           tracker.get_line(), tracker.get_column(), {"u"});
-            }
-          }
+          parse_braced_unicode_escape(value);
         } else {
-          // \uXXXX 格式
-          value += parse_unicode_escape(4);
+          parse_unicode_escape(4, value);
         }
         break;
       default:
@@ -183,49 +268,25 @@ Token Lexer::read_string() {
         break;
       }
     } else {
-      // --- 处理非转义的普通字符（可能为多字节 UTF-8） ---
-      // NOTE: 使用 Utf8Handler::read_char 来确保正确处理多字节字符。
-      //       此函数会完整读取一个 UTF-8 字符（可能是1-4字节），
-      //       并相应地推进 tracker 的位置。
-      size_t current_pos = tracker.get_position();
-      std::string utf8_char;
-      const auto& input = tracker.get_input();
-
-      if (Utf8Handler::read_char(input, current_pos, utf8_char)) {
-        value += utf8_char;
-        // 同步 tracker 和 lexer 的状态
-        while (tracker.get_position() < current_pos) {
-          advance();
-        }
-      } else {
-        // 如果 read_char 失败，说明遇到了无效的 UTF-8 序列。
-        // 报告错误并消耗掉这个无效字节，以避免无限循环。
-        report_error(DiagnosticCode::L0011_InvalidUtf8Sequence,
-                     tracker.get_line(), tracker.get_column(), {});
-        advance();
-      }
+      // --- 处理非转义的普通字符（可能为多字节 UTF-8，允许跨行） ---
+      // NOTE: 到下一个 `"` 或 `\` 之前的内容都按原样进入字符串值，
+      //       因此整段交给 Utf8Handler 批量验证并一次性追加，
+      //       tracker 也只推进一次。
+      consume_verbatim_run(value,
+                           scan::find_string_delimiter(
+                               input.data(), tracker.get_position(),
+                               input.size()));
     }
   }
 
   if (!terminated) {
     report_error(DiagnosticCode::L0007_UnterminatedString, token_line,
                  token_column, {});
-    Token token(TokenType::String, value, token_line, token_column);
-    // 提取原始字符串字面量文本（从起始位置到当前位置）
-    size_t end_pos = tracker.get_position();
-    const auto& input = tracker.get_input();
-    token.raw_literal =
-        std::string(input.begin() + start_pos, input.begin() + end_pos);
-    return token;
+  } else {
+    advance(); // 跳过结尾的 "
   }
 
-  advance(); // 跳过结尾的 "
-  Token token(TokenType::String, value, token_line, token_column);
-  // 提取原始字符串字面量文本（包括两端的引号）
-  size_t end_pos = tracker.get_position();
-  const auto& input = tracker.get_input();
-  token.raw_literal =
-      std::string(input.begin() + start_pos, input.begin() + end_pos);
+  finish_string_token(token, value, start_pos);
   return token;
 }
 
@@ -244,51 +305,35 @@ Token Lexer::read_raw_string() {
 
   advance(); // 跳过 '"'
 
-  std::string value;
-  value.reserve(64);
-  bool terminated = false;
-
-  while (current_char.has_value()) {
-    char ch = current_char.value();
-
-    if (ch == '"') {
-      terminated = true;
-      break;
-    }
+  Token token(TokenType::String, std::string(), token_line, token_column);
+  token.is_raw_string = true; // 标记为原始字符串
 
-    // NOTE: 在原始字符串中，所有字符（包括反斜杠 `\` 和换行符 `\n`）
-    //       都按其字面意义处理，不进行任何转义。
-    //       同样使用 Utf8Handler::read_char 来确保正确处理多字节字符。
-    size_t current_pos = tracker.get_position();
-    std::string utf8_char;
-    const auto& input = tracker.get_input();
+  // NOTE: 在原始字符串中，所有字符（包括反斜杠 `\` 和换行符 `\n`）
+  //       都按其字面意义处理，不进行任何转义，因此直到结尾的 `"`
+  //       之前的内容通常就是字符串值本身。
+  const auto& input = tracker.get_input();
+  size_t content_end =
+      scan::find_byte(input.data(), tracker.get_position(), input.size(), '"');
+  if (try_read_verbatim_string(content_end, start_pos, token)) {
+    return token;
+  }
 
-    if (Utf8Handler::read_char(input, current_pos, utf8_char)) {
-      value += utf8_char;
-      while (tracker.get_position() < current_pos) {
-        advance();
-      }
-    } else {
-      report_error(DiagnosticCode::L0011_InvalidUtf8Sequence,
-                   tracker.get_line(), tracker.get_column(), {});
-      advance();
-    }
+  // 未闭合或含有无效 UTF-8 序列：有效的部分按原样追加，无效字节被跳过。
+  std::string owned_value;
+  std::string& value = span_mode ? string_scratch : owned_value;
+  value.clear();
+  while (tracker.get_position() < content_end) {
+    consume_verbatim_run(value, content_end);
   }
 
-  if (!terminated) {
+  if (!current_char.has_value()) {
     report_error(DiagnosticCode::L0007_UnterminatedString, token_line,
                  token_column, {});
   } else {
     advance(); // 跳过结尾的 "
   }
 
-  Token token(TokenType::String, value, token_line, token_column);
-  token.is_raw_string = true; // 标记为原始字符串
-  // 提取原始字符串字面量文本（包括 r"..."）
-  size_t end_pos = tracker.get_position();
-  const auto& input = tracker.get_input();
-  token.raw_literal =
-      std::string(input.begin() + start_pos, input.begin() + end_pos);
+  finish_string_token(token, value, start_pos);
   return token;
 }
 
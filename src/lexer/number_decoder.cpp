@@ -0,0 +1,283 @@
+/**
+ * @file number_decoder.cpp
+ * @brief 数字字面量值解码的实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/lexer/number_decoder.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+#if !defined(__cpp_lib_to_chars)
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+#endif
+
+namespace czc::lexer {
+
+namespace {
+
+constexpr uint64_t INT64_LIMIT =
+    static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+
+/**
+ * @brief 以小端序读取 8 个字节，使第一个字符位于最低字节。
+ */
+uint64_t load_eight_bytes(const char* data) noexcept {
+  uint64_t chunk;
+  std::memcpy(&chunk, data, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  chunk = __builtin_bswap64(chunk);
+#endif
+  return chunk;
+}
+
+/**
+ * @brief 判断 8 个字节是否全是 ASCII 数字。
+ * @details 每个字节的高半字节必须是 3，且加 6 后高半字节仍为 3（即低半字节
+ *          不超过 9）；两个条件在一个 64 位整数内同时检查。
+ */
+bool is_eight_digits(uint64_t chunk) noexcept {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+          (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+/**
+ * @brief 把 8 个 ASCII 数字转换为数值（SWAR）。
+ * @details 三步分别把相邻的 1 位、2 位、4 位数字合并成 2 位、4 位、8 位，
+ *          用 3 次乘法代替 8 次乘加。
+ */
+uint32_t parse_eight_digits(uint64_t chunk) noexcept {
+  constexpr uint64_t MASK = 0x000000FF000000FF;
+  constexpr uint64_t MUL1 = 100 + (1000000ULL << 32);
+  constexpr uint64_t MUL2 = 1 + (10000ULL << 32);
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & MASK) * MUL1) + (((chunk >> 16) & MASK) * MUL2)) >> 32;
+  return static_cast<uint32_t>(chunk);
+}
+
+/**
+ * @brief 把十进制数字串累加到 `value` 之后（`value * 10^n + digits`）。
+ * @return 含有非数字字符或结果超过 `INT64_LIMIT` 时返回 false。
+ */
+bool accumulate_decimal(std::string_view digits, uint64_t& value) noexcept {
+  size_t pos = 0;
+  while (digits.size() - pos >= 8) {
+    uint64_t chunk = load_eight_bytes(digits.data() + pos);
+    if (!is_eight_digits(chunk)) {
+      return false;
+    }
+    uint64_t part = parse_eight_digits(chunk);
+    if (value > (INT64_LIMIT - part) / 100000000) {
+      return false;
+    }
+    value = value * 100000000 + part;
+    pos += 8;
+  }
+  for (; pos < digits.size(); pos++) {
+    auto digit = static_cast<uint64_t>(digits[pos] - '0');
+    if (digit > 9 || value > (INT64_LIMIT - digit) / 10) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  return true;
+}
+
+/**
+ * @brief 解码 `0x`/`0b`/`0o` 之后的数字部分。
+ */
+bool decode_radix(std::string_view digits, unsigned radix,
+                  uint64_t& value) noexcept {
+  if (digits.empty()) {
+    return false;
+  }
+  value = 0;
+  for (char ch : digits) {
+    unsigned digit;
+    if (ch >= '0' && ch <= '9') {
+      digit = static_cast<unsigned>(ch - '0');
+    } else if (ch >= 'a' && ch <= 'f') {
+      digit = static_cast<unsigned>(ch - 'a' + 10);
+    } else if (ch >= 'A' && ch <= 'F') {
+      digit = static_cast<unsigned>(ch - 'A' + 10);
+    } else {
+      return false;
+    }
+    if (digit >= radix || value > (INT64_LIMIT - digit) / radix) {
+      return false;
+    }
+    value = value * radix + digit;
+  }
+  return true;
+}
+
+/**
+ * @brief 解码数学上为整数的科学计数法，如 `1.25e2`。
+ * @details 尾数按去掉小数点后的整数累加，再按指数与小数位数之差乘或除以
+ *          10；除法必须整除。尾数太长而无法精确累加时返回 false，由调用方
+ *          改走浮点数路径。
+ */
+bool decode_scientific_integer(std::string_view mantissa,
+                               std::string_view exponent_text,
+                               uint64_t& value) noexcept {
+  size_t dot = mantissa.find('.');
+  std::string_view whole = mantissa.substr(0, dot);
+  std::string_view fraction = dot == std::string_view::npos
+                                  ? std::string_view()
+                                  : mantissa.substr(dot + 1);
+  // 小数部分的尾随零不影响数值。
+  while (!fraction.empty() && fraction.back() == '0') {
+    fraction.remove_suffix(1);
+  }
+
+  bool negative = !exponent_text.empty() && exponent_text.front() == '-';
+  if (!exponent_text.empty() &&
+      (exponent_text.front() == '-' || exponent_text.front() == '+')) {
+    exponent_text.remove_prefix(1);
+  }
+  uint64_t exponent = 0;
+  if (exponent_text.empty() || !accumulate_decimal(exponent_text, exponent)) {
+    return false;
+  }
+
+  value = 0;
+  if (!accumulate_decimal(whole, value) ||
+      !accumulate_decimal(fraction, value)) {
+    return false;
+  }
+  if (value == 0) {
+    return true;
+  }
+
+  // NOTE: 超过 19 位的移位必然溢出或无法整除，也避免了有符号溢出。
+  auto magnitude = static_cast<int64_t>(std::min<uint64_t>(exponent, 64));
+  int64_t shift = (negative ? -magnitude : magnitude) -
+                  static_cast<int64_t>(fraction.size());
+  for (; shift > 0; shift--) {
+    if (value > INT64_LIMIT / 10) {
+      return false;
+    }
+    value *= 10;
+  }
+  for (; shift < 0; shift++) {
+    if (value % 10 != 0) {
+      return false;
+    }
+    value /= 10;
+  }
+  return true;
+}
+
+} // namespace
+
+bool decode_integer(std::string_view literal, int64_t& value) noexcept {
+  uint64_t result = 0;
+  if (literal.size() > 2 && literal[0] == '0') {
+    unsigned radix = 0;
+    switch (literal[1]) {
+    case 'x':
+    case 'X':
+      radix = 16;
+      break;
+    case 'b':
+    case 'B':
+      radix = 2;
+      break;
+    case 'o':
+    case 'O':
+      radix = 8;
+      break;
+    default:
+      break;
+    }
+    if (radix != 0) {
+      if (!decode_radix(literal.substr(2), radix, result)) {
+        return false;
+      }
+      value = static_cast<int64_t>(result);
+      return true;
+    }
+  }
+
+  size_t e_pos = literal.find_first_of("eE");
+  if (e_pos == std::string_view::npos) {
+    if (literal.empty() || !accumulate_decimal(literal, result)) {
+      return false;
+    }
+    value = static_cast<int64_t>(result);
+    return true;
+  }
+
+  if (decode_scientific_integer(literal.substr(0, e_pos),
+                                literal.substr(e_pos + 1), result)) {
+    value = static_cast<int64_t>(result);
+    return true;
+  }
+  // NOTE: 尾数太长时退回浮点数解码，只接受恰好是整数且在范围内的结果。
+  double approximate = 0;
+  if (!decode_float(literal, approximate) ||
+      approximate != std::floor(approximate) || approximate < 0 ||
+      approximate >= 9223372036854775808.0) {
+    return false;
+  }
+  value = static_cast<int64_t>(approximate);
+  return true;
+}
+
+bool decode_float(std::string_view literal, double& value) noexcept {
+  if (literal.empty()) {
+    return false;
+  }
+#if defined(__cpp_lib_to_chars)
+  double result = 0;
+  auto [end, error] =
+      std::from_chars(literal.data(), literal.data() + literal.size(), result);
+  if (error != std::errc() || end != literal.data() + literal.size()) {
+    return false;
+  }
+  value = result;
+  return true;
+#else
+  // NOTE: 标准库不支持浮点数的 `from_chars` 时退回 `strtod`，需要一份以
+  //       '\0' 结尾的副本。
+  try {
+    std::string text(literal);
+    char* end = nullptr;
+    errno = 0;
+    double result = std::strtod(text.c_str(), &end);
+    if (errno == ERANGE || end != text.c_str() + text.size()) {
+      return false;
+    }
+    value = result;
+    return true;
+  } catch (...) {
+    return false;
+  }
+#endif
+}
+
+void decode_numeric_value(Token& token, std::string_view text) noexcept {
+  switch (token.token_type) {
+  case TokenType::Integer:
+    token.has_numeric_value = decode_integer(text, token.integer_value);
+    return;
+  case TokenType::Float:
+    token.has_numeric_value = decode_float(text, token.float_value);
+    return;
+  default:
+    token.has_numeric_value = false;
+    return;
+  }
+}
+
+} // namespace czc::lexer
@@ -0,0 +1,401 @@
+/**
+ * @file scan_kernels.cpp
+ * @brief 批量扫描内核的实现（AVX2 / SSE2 / NEON / 标量）。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/lexer/scan_kernels.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CZC_SCAN_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define CZC_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// NOTE: 以 -march 等方式启用了 AVX2 时直接使用 32 字节的内核；否则在
+//       GCC / Clang 的 x86-64 构建中同时编译 AVX2 内核，运行时按 CPU
+//       是否支持 AVX2 选择（见 `CZC_MARCH`）。
+#if defined(CZC_SCAN_SSE2) && defined(__AVX2__)
+#define CZC_SCAN_AVX2 1
+#define CZC_AVX2_TARGET
+#include <immintrin.h>
+#elif defined(CZC_SCAN_SSE2) && defined(__x86_64__) &&                         \
+    (defined(__GNUC__) || defined(__clang__))
+#define CZC_SCAN_AVX2 1
+#define CZC_SCAN_AVX2_DISPATCH 1
+#define CZC_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+namespace czc::lexer::scan {
+
+namespace {
+
+// 每次处理的数据块大小（字节）。
+constexpr size_t BLOCK = 16;
+
+/**
+ * @brief 统计 64 位整数末尾连续 0 的个数（参数不得为 0）。
+ */
+inline unsigned count_trailing_zeros(uint64_t value) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+inline bool is_space_byte(unsigned char c) noexcept {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool is_ident_byte(unsigned char c) noexcept {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+#if defined(CZC_SCAN_SSE2)
+
+// NOTE: 区间判断统一使用 "减去下界后做无符号饱和减法" 的技巧：
+//       对于 x ∈ [lo, lo + n]，(x - lo) 饱和减 n 的结果恰好为 0。
+
+inline __m128i in_range(__m128i v, char lo, char span) noexcept {
+  __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+  return _mm_cmpeq_epi8(_mm_subs_epu8(shifted, _mm_set1_epi8(span)),
+                        _mm_setzero_si128());
+}
+
+inline uint64_t whitespace_mismatch(const char* p) noexcept {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i match = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                               in_range(v, '\t', '\r' - '\t'));
+  return ~static_cast<uint64_t>(_mm_movemask_epi8(match)) & 0xFFFFu;
+}
+
+inline uint64_t identifier_mismatch(const char* p) noexcept {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+  __m128i match = _mm_or_si128(
+      _mm_or_si128(in_range(lower, 'a', 'z' - 'a'), in_range(v, '0', 9)),
+      _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+  return ~static_cast<uint64_t>(_mm_movemask_epi8(match)) & 0xFFFFu;
+}
+
+inline uint64_t ascii_mismatch(const char* p) noexcept {
+  // NOTE: movemask 直接取出每个字节的最高位，即非 ASCII 字节的位置。
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  return static_cast<uint64_t>(_mm_movemask_epi8(v));
+}
+
+inline uint64_t string_delimiter_match(const char* p) noexcept {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i match = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                               _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+  return static_cast<uint64_t>(_mm_movemask_epi8(match));
+}
+
+// SSE2 的 movemask 每个字节对应 1 位。
+constexpr unsigned BITS_PER_BYTE = 1;
+
+#elif defined(CZC_SCAN_NEON)
+
+inline uint8x16_t in_range(uint8x16_t v, uint8_t lo, uint8_t span) noexcept {
+  return vcleq_u8(vsubq_u8(v, vdupq_n_u8(lo)), vdupq_n_u8(span));
+}
+
+// NOTE: NEON 没有 movemask，使用 shrn 将每个字节的比较结果压缩为 4 位。
+inline uint64_t to_nibble_mask(uint8x16_t mismatch) noexcept {
+  uint8x8_t packed = vshrn_n_u16(vreinterpretq_u16_u8(mismatch), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(packed), 0);
+}
+
+inline uint64_t whitespace_mismatch(const char* p) noexcept {
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  uint8x16_t match =
+      vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), in_range(v, '\t', '\r' - '\t'));
+  return to_nibble_mask(vmvnq_u8(match));
+}
+
+inline uint64_t identifier_mismatch(const char* p) noexcept {
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  uint8x16_t lower = vorrq_u8(v, vdupq_n_u8(0x20));
+  uint8x16_t match =
+      vorrq_u8(vorrq_u8(in_range(lower, 'a', 'z' - 'a'), in_range(v, '0', 9)),
+               vceqq_u8(v, vdupq_n_u8('_')));
+  return to_nibble_mask(vmvnq_u8(match));
+}
+
+inline uint64_t ascii_mismatch(const char* p) noexcept {
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  return to_nibble_mask(vcgeq_u8(v, vdupq_n_u8(0x80)));
+}
+
+inline uint64_t string_delimiter_match(const char* p) noexcept {
+  uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+  uint8x16_t match =
+      vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')), vceqq_u8(v, vdupq_n_u8('\\')));
+  return to_nibble_mask(match);
+}
+
+// shrn 压缩后每个字节对应 4 位。
+constexpr unsigned BITS_PER_BYTE = 4;
+
+#else
+
+// NOTE: 无 SIMD 的平台上 `scan_blocks` 不处理任何数据块，
+//       以下占位函数只为让各内核共用同一份代码。
+inline uint64_t whitespace_mismatch(const char*) noexcept { return 0; }
+inline uint64_t identifier_mismatch(const char*) noexcept { return 0; }
+inline uint64_t ascii_mismatch(const char*) noexcept { return 0; }
+inline uint64_t string_delimiter_match(const char*) noexcept { return 0; }
+
+#endif
+
+#if defined(CZC_SCAN_AVX2)
+
+namespace avx2 {
+
+// AVX2 每次处理的数据块大小（字节）。
+constexpr size_t BLOCK = 32;
+
+CZC_AVX2_TARGET inline __m256i in_range(__m256i v, char lo,
+                                        char span) noexcept {
+  __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+  return _mm256_cmpeq_epi8(_mm256_subs_epu8(shifted, _mm256_set1_epi8(span)),
+                           _mm256_setzero_si256());
+}
+
+CZC_AVX2_TARGET inline uint64_t to_mask(__m256i match) noexcept {
+  return static_cast<uint32_t>(_mm256_movemask_epi8(match));
+}
+
+CZC_AVX2_TARGET inline __m256i load(const char* p) noexcept {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+CZC_AVX2_TARGET inline uint64_t whitespace_mismatch(const char* p) noexcept {
+  __m256i v = load(p);
+  __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                  in_range(v, '\t', '\r' - '\t'));
+  return ~to_mask(match) & 0xFFFFFFFFu;
+}
+
+CZC_AVX2_TARGET inline uint64_t identifier_mismatch(const char* p) noexcept {
+  __m256i v = load(p);
+  __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+  __m256i match = _mm256_or_si256(
+      _mm256_or_si256(in_range(lower, 'a', 'z' - 'a'), in_range(v, '0', 9)),
+      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+  return ~to_mask(match) & 0xFFFFFFFFu;
+}
+
+CZC_AVX2_TARGET inline uint64_t ascii_mismatch(const char* p) noexcept {
+  return to_mask(load(p));
+}
+
+CZC_AVX2_TARGET inline uint64_t string_delimiter_match(const char* p) noexcept {
+  __m256i v = load(p);
+  return to_mask(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                 _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))));
+}
+
+/**
+ * @brief 与通用的 `scan_blocks` 相同，但每次处理 32 字节。
+ * @details 剩余不足 32 字节时返回，由调用方继续按 16 字节的数据块处理。
+ */
+template <uint64_t (*BlockMask)(const char*) noexcept>
+CZC_AVX2_TARGET size_t scan_blocks(const char* data, size_t pos, size_t size,
+                                   bool& found) noexcept {
+  found = false;
+  while (pos + BLOCK <= size) {
+    uint64_t mask = BlockMask(data + pos);
+    if (mask != 0) {
+      found = true;
+      return pos + count_trailing_zeros(mask);
+    }
+    pos += BLOCK;
+  }
+  return pos;
+}
+
+#if defined(CZC_SCAN_AVX2_DISPATCH)
+bool detect() noexcept {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+// 启动时检测一次；每次扫描只读取这个值，分支总能被正确预测。
+const bool AVAILABLE = detect();
+#else
+constexpr bool AVAILABLE = true;
+#endif
+
+} // namespace avx2
+
+#else
+
+// NOTE: 没有 AVX2 内核时，以下占位使各内核可以无条件地共用 `scan_all_blocks`。
+namespace avx2 {
+
+constexpr bool AVAILABLE = false;
+
+inline uint64_t whitespace_mismatch(const char*) noexcept { return 0; }
+inline uint64_t identifier_mismatch(const char*) noexcept { return 0; }
+inline uint64_t ascii_mismatch(const char*) noexcept { return 0; }
+inline uint64_t string_delimiter_match(const char*) noexcept { return 0; }
+
+template <uint64_t (*BlockMask)(const char*) noexcept>
+size_t scan_blocks(const char*, size_t pos, size_t, bool& found) noexcept {
+  found = false;
+  return pos;
+}
+
+} // namespace avx2
+
+#endif
+
+/**
+ * @brief 按数据块推进，直到某个数据块的掩码非 0。
+ * @details `block_mask` 返回数据块内 "停止字节" 的位掩码。
+ *          返回停止字节的位置；若没有完整的数据块含停止字节，则返回尚未
+ *          处理的尾部起点，由调用方逐字节处理。
+ * @param[out] found 是否在某个数据块内找到了停止字节。
+ */
+template <typename BlockMask>
+inline size_t scan_blocks(const char* data, size_t pos, size_t size,
+                          BlockMask block_mask, bool& found) noexcept {
+  found = false;
+#if defined(CZC_SCAN_SSE2) || defined(CZC_SCAN_NEON)
+  while (pos + BLOCK <= size) {
+    uint64_t mask = block_mask(data + pos);
+    if (mask != 0) {
+      found = true;
+      return pos + count_trailing_zeros(mask) / BITS_PER_BYTE;
+    }
+    pos += BLOCK;
+  }
+#else
+  (void)data;
+  (void)size;
+  (void)block_mask;
+#endif
+  return pos;
+}
+
+/**
+ * @brief CPU 支持 AVX2 时先按 32 字节的数据块推进，再交给 `scan_blocks`。
+ * @tparam WideMask 与 `block_mask` 等价的 AVX2 掩码函数。
+ */
+template <uint64_t (*WideMask)(const char*) noexcept, typename BlockMask>
+inline size_t scan_all_blocks(const char* data, size_t pos, size_t size,
+                              BlockMask block_mask, bool& found) noexcept {
+  if (avx2::AVAILABLE) {
+    pos = avx2::scan_blocks<WideMask>(data, pos, size, found);
+    if (found) {
+      return pos;
+    }
+  }
+  return scan_blocks(data, pos, size, block_mask, found);
+}
+
+} // namespace
+
+size_t skip_whitespace(const char* data, size_t pos, size_t size) noexcept {
+  bool found;
+  pos = scan_all_blocks<avx2::whitespace_mismatch>(
+      data, pos, size,
+      [](const char* p) noexcept { return whitespace_mismatch(p); }, found);
+  if (found) {
+    return pos;
+  }
+  // 处理不足一个数据块的尾部（或在无 SIMD 的平台上处理全部输入）。
+  while (pos < size && is_space_byte(static_cast<unsigned char>(data[pos]))) {
+    pos++;
+  }
+  return pos;
+}
+
+size_t scan_identifier(const char* data, size_t pos, size_t size) noexcept {
+  bool found;
+  pos = scan_all_blocks<avx2::identifier_mismatch>(
+      data, pos, size,
+      [](const char* p) noexcept { return identifier_mismatch(p); }, found);
+  if (found) {
+    return pos;
+  }
+  while (pos < size && is_ident_byte(static_cast<unsigned char>(data[pos]))) {
+    pos++;
+  }
+  return pos;
+}
+
+size_t skip_ascii(const char* data, size_t pos, size_t size) noexcept {
+  bool found;
+  pos = scan_all_blocks<avx2::ascii_mismatch>(
+      data, pos, size,
+      [](const char* p) noexcept { return ascii_mismatch(p); }, found);
+  if (found) {
+    return pos;
+  }
+  while (pos < size && static_cast<unsigned char>(data[pos]) < 0x80) {
+    pos++;
+  }
+  return pos;
+}
+
+size_t find_string_delimiter(const char* data, size_t pos,
+                             size_t size) noexcept {
+  bool found;
+  pos = scan_all_blocks<avx2::string_delimiter_match>(
+      data, pos, size,
+      [](const char* p) noexcept { return string_delimiter_match(p); }, found);
+  if (found) {
+    return pos;
+  }
+  while (pos < size && data[pos] != '"' && data[pos] != '\\') {
+    pos++;
+  }
+  return pos;
+}
+
+size_t find_byte(const char* data, size_t pos, size_t size,
+                 char target) noexcept {
+  if (pos >= size) {
+    return size;
+  }
+  // NOTE: 标准库的 memchr 在主流平台上已经是向量化实现，直接复用即可。
+  const void* hit = std::memchr(data + pos, target, size - pos);
+  if (hit == nullptr) {
+    return size;
+  }
+  return static_cast<size_t>(static_cast<const char*>(hit) - data);
+}
+
+size_t find_line_end(const char* data, size_t pos, size_t size) noexcept {
+  return find_byte(data, pos, size, '\n');
+}
+
+const char* kernel_name() noexcept {
+#if defined(CZC_SCAN_SSE2)
+  return avx2::AVAILABLE ? "avx2" : "sse2";
+#elif defined(CZC_SCAN_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+}
+
+} // namespace czc::lexer::scan
@@ -0,0 +1,124 @@
+/**
+ * @file stream_lexer.cpp
+ * @brief `StreamLexer` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/lexer/stream_lexer.hpp"
+
+#include "czc/utils/source_buffer.hpp"
+
+#include <utility>
+
+namespace czc::lexer {
+
+StreamLexer::StreamLexer(const std::string& filename) : filename(filename) {}
+
+size_t StreamLexer::feed(std::string_view bytes) {
+  if (finished || bytes.empty()) {
+    return 0;
+  }
+  pending.append(bytes.data(), bytes.size());
+  if (pending.size() < retry_size) {
+    return 0;
+  }
+  size_t committed = scan(false);
+  retry_size = committed == 0 ? pending.size() * 2 : 0;
+  return committed;
+}
+
+size_t StreamLexer::finish() {
+  if (finished) {
+    return 0;
+  }
+  finished = true;
+  return scan(true);
+}
+
+std::vector<Token> StreamLexer::take_tokens() {
+  std::vector<Token> tokens = std::move(ready);
+  ready.clear();
+  return tokens;
+}
+
+size_t StreamLexer::scan(bool at_end) {
+  // NOTE: 分析器直接借用 `pending`，不为每次分析复制源码。
+  auto source = utils::SourceBuffer::borrow(pending);
+  Lexer lexer(source, filename);
+  lexer.set_interner(interner);
+
+  // 第一个未提交的 Token 在 `pending` 中的位置与行列号
+  size_t cut = pending.size();
+  size_t cut_line = 0;
+  size_t cut_column = 0;
+  size_t first_new = ready.size();
+
+  // 把 `pending` 中的行列号换算为整个输入中的行列号。
+  auto shift = [this](auto& line, auto& column) {
+    if (line == 1) {
+      column += base_column - 1;
+    }
+    line += base_line - 1;
+  };
+
+  while (true) {
+    Token token = lexer.next_token();
+    if (token.token_type == TokenType::EndOfFile) {
+      const auto& tracker = lexer.get_source_tracker();
+      cut_line = tracker.get_line();
+      cut_column = tracker.get_column();
+      if (at_end) {
+        // 与 `tokenize()` 一致，EOF Token 的行列号固定为 0。
+        token.offset += base_offset;
+        ready.push_back(std::move(token));
+      }
+      break;
+    }
+    if (!at_end && token.offset + token.length + LOOKAHEAD_BYTES >=
+                       pending.size()) {
+      cut = token.offset;
+      cut_line = token.line;
+      cut_column = token.column;
+      break;
+    }
+    token.offset += base_offset;
+    shift(token.line, token.column);
+    ready.push_back(std::move(token));
+  }
+
+  // --- 提交已确定部分的错误 ---
+  // NOTE: 错误按位置先后报告，未提交的 Token 上的错误都不早于它的起点，
+  //       下一次分析会重新报告它们。
+  for (LexerError error : lexer.get_errors().get_errors()) {
+    if (cut < pending.size() &&
+        (error.location.line > cut_line ||
+         (error.location.line == cut_line &&
+          error.location.column >= cut_column))) {
+      continue;
+    }
+    shift(error.location.line, error.location.column);
+    shift(error.location.end_line, error.location.end_column);
+    error_collector.add(error);
+  }
+
+  // NOTE: 与 `tokenize_parallel` 相同，分类器报告的位置要等行号换算后才
+  //       正确，因此在提交时补做分类。
+  if (scientific_classifier != nullptr) {
+    for (size_t i = first_new; i < ready.size(); ++i) {
+      if (ready[i].token_type == TokenType::ScientificExponent) {
+        ready[i].token_type = scientific_classifier->classify(ready[i]);
+      }
+    }
+  }
+
+  // --- 丢弃已提交的字节 ---
+  base_offset += cut;
+  shift(cut_line, cut_column);
+  base_line = cut_line;
+  base_column = cut_column;
+  pending.erase(0, cut);
+  return ready.size() - first_new;
+}
+
+} // namespace czc::lexer
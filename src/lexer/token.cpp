@@ -7,160 +7,241 @@
 
 #include "czc/lexer/token.hpp"
 
-#include <unordered_map>
+#include <array>
 
 namespace czc::lexer {
 
 Token::Token(TokenType type, const std::string& val, size_t line, size_t column,
              bool synthetic)
-    : token_type(type), value(val), line(line), column(column),
+    : value(val), line(line), column(column), token_type(type),
       is_synthetic(synthetic) {}
 
-std::optional<TokenType> get_keyword(const std::string& word) {
-  // NOTE: 使用静态哈希表优化关键字查找性能。
-  //       相比线性搜索，哈希表查找的时间复杂度从 O(n) 降低到 O(1)。
-  //       对于 15+ 个关键字的场景，这能带来明显的性能提升。
-  //       静态局部变量确保哈希表只初始化一次，避免重复构建开销。
-  static const std::unordered_map<std::string, TokenType> KEYWORDS = {
-      {"let", TokenType::Let},     {"var", TokenType::Var},
-      {"fn", TokenType::Fn},       {"return", TokenType::Return},
-      {"if", TokenType::If},       {"else", TokenType::Else},
-      {"while", TokenType::While}, {"for", TokenType::For},
-      {"in", TokenType::In},       {"struct", TokenType::Struct},
-      {"enum", TokenType::Enum},   {"type", TokenType::Type},
-      {"trait", TokenType::Trait}, {"true", TokenType::True},
-      {"false", TokenType::False}};
-
-  auto it = KEYWORDS.find(word);
-  if (it != KEYWORDS.end()) {
-    return it->second;
-  }
+namespace {
 
-  // 如果字符串不匹配任何关键字，则返回空的可选值，
-  // 表明它应该被视为一个普通标识符。
+/**
+ * @brief 在已知长度与首字符的前提下，与唯一的候选关键字比较一次。
+ */
+constexpr std::optional<TokenType> match_keyword(std::string_view word,
+                                                 std::string_view keyword,
+                                                 TokenType type) {
+  if (word == keyword) {
+    return type;
+  }
   return std::nullopt;
 }
 
-std::string token_type_to_string(TokenType type) {
-  switch (type) {
-  case TokenType::Integer:
-    return "Integer";
-  case TokenType::Float:
-    return "Float";
-  case TokenType::String:
-    return "String";
-  case TokenType::Identifier:
-    return "Identifier";
-  case TokenType::ScientificExponent:
-    return "ScientificExponent";
-  case TokenType::Comment:
-    return "Comment";
-  case TokenType::Let:
-    return "Let";
-  case TokenType::Var:
-    return "Var";
-  case TokenType::Fn:
-    return "Fn";
-  case TokenType::Return:
-    return "Return";
-  case TokenType::If:
-    return "If";
-  case TokenType::Else:
-    return "Else";
-  case TokenType::While:
-    return "While";
-  case TokenType::For:
-    return "For";
-  case TokenType::In:
-    return "In";
-  case TokenType::Struct:
-    return "Struct";
-  case TokenType::Enum:
-    return "Enum";
-  case TokenType::Type:
-    return "Type";
-  case TokenType::Trait:
-    return "Trait";
-  case TokenType::True:
-    return "True";
-  case TokenType::False:
-    return "False";
-  case TokenType::Plus:
-    return "Plus";
-  case TokenType::Minus:
-    return "Minus";
-  case TokenType::Star:
-    return "Star";
-  case TokenType::Slash:
-    return "Slash";
-  case TokenType::Percent:
-    return "Percent";
-  case TokenType::Equal:
-    return "Equal";
-  case TokenType::PlusEqual:
-    return "PlusEqual";
-  case TokenType::MinusEqual:
-    return "MinusEqual";
-  case TokenType::StarEqual:
-    return "StarEqual";
-  case TokenType::PercentEqual:
-    return "PercentEqual";
-  case TokenType::SlashEqual:
-    return "SlashEqual";
-  case TokenType::EqualEqual:
-    return "EqualEqual";
-  case TokenType::Bang:
-    return "Bang";
-  case TokenType::BangEqual:
-    return "BangEqual";
-  case TokenType::Less:
-    return "Less";
-  case TokenType::LessEqual:
-    return "LessEqual";
-  case TokenType::Greater:
-    return "Greater";
-  case TokenType::GreaterEqual:
-    return "GreaterEqual";
-  case TokenType::And:
-    return "And";
-  case TokenType::Or:
-    return "Or";
-  case TokenType::AndAnd:
-    return "AndAnd";
-  case TokenType::OrOr:
-    return "OrOr";
-  case TokenType::Tilde:
-    return "Tilde";
-  case TokenType::LeftParen:
-    return "LeftParen";
-  case TokenType::RightParen:
-    return "RightParen";
-  case TokenType::LeftBrace:
-    return "LeftBrace";
-  case TokenType::RightBrace:
-    return "RightBrace";
-  case TokenType::LeftBracket:
-    return "LeftBracket";
-  case TokenType::RightBracket:
-    return "RightBracket";
-  case TokenType::Comma:
-    return "Comma";
-  case TokenType::Semicolon:
-    return "Semicolon";
-  case TokenType::Colon:
-    return "Colon";
-  case TokenType::Dot:
-    return "Dot";
-  case TokenType::DotDot:
-    return "DotDot";
-  case TokenType::Arrow:
-    return "Arrow";
-  case TokenType::EndOfFile:
-    return "EOF";
-  case TokenType::Unknown:
+/**
+ * @brief 关键字识别的编译期实现。
+ * @details 先按长度、再按首字符分派，每个分支最多剩下一个候选关键字，
+ *          因此任何输入至多进行一次完整的字符串比较，且全程不分配内存。
+ *          新增关键字时，需要在对应长度的分支中补充首字符分派。
+ */
+constexpr std::optional<TokenType> classify_keyword(std::string_view word) {
+  switch (word.size()) {
+  case 2:
+    switch (word[0]) {
+    case 'f':
+      return match_keyword(word, "fn", TokenType::Fn);
+    case 'i':
+      // NOTE: "if" 与 "in" 首字符相同，第二个字符即可区分。
+      if (word[1] == 'f') {
+        return TokenType::If;
+      }
+      if (word[1] == 'n') {
+        return TokenType::In;
+      }
+      return std::nullopt;
+    default:
+      return std::nullopt;
+    }
+  case 3:
+    switch (word[0]) {
+    case 'l':
+      return match_keyword(word, "let", TokenType::Let);
+    case 'v':
+      return match_keyword(word, "var", TokenType::Var);
+    case 'f':
+      return match_keyword(word, "for", TokenType::For);
+    default:
+      return std::nullopt;
+    }
+  case 4:
+    switch (word[0]) {
+    case 'e':
+      // NOTE: "else" 与 "enum" 首字符相同，第二个字符即可区分。
+      if (word[1] == 'l') {
+        return match_keyword(word, "else", TokenType::Else);
+      }
+      return match_keyword(word, "enum", TokenType::Enum);
+    case 't':
+      // NOTE: "type" 与 "true" 首字符相同，第二个字符即可区分。
+      if (word[1] == 'y') {
+        return match_keyword(word, "type", TokenType::Type);
+      }
+      return match_keyword(word, "true", TokenType::True);
+    default:
+      return std::nullopt;
+    }
+  case 5:
+    switch (word[0]) {
+    case 'w':
+      return match_keyword(word, "while", TokenType::While);
+    case 't':
+      return match_keyword(word, "trait", TokenType::Trait);
+    case 'f':
+      return match_keyword(word, "false", TokenType::False);
+    default:
+      return std::nullopt;
+    }
+  case 6:
+    switch (word[0]) {
+    case 'r':
+      return match_keyword(word, "return", TokenType::Return);
+    case 's':
+      return match_keyword(word, "struct", TokenType::Struct);
+    default:
+      return std::nullopt;
+    }
   default:
-    return "Unknown";
+    return std::nullopt;
+  }
+}
+
+// 编译期校验分派表覆盖了全部关键字，并能拒绝相近的非关键字。
+static_assert(classify_keyword("let") == TokenType::Let);
+static_assert(classify_keyword("var") == TokenType::Var);
+static_assert(classify_keyword("fn") == TokenType::Fn);
+static_assert(classify_keyword("return") == TokenType::Return);
+static_assert(classify_keyword("if") == TokenType::If);
+static_assert(classify_keyword("else") == TokenType::Else);
+static_assert(classify_keyword("while") == TokenType::While);
+static_assert(classify_keyword("for") == TokenType::For);
+static_assert(classify_keyword("in") == TokenType::In);
+static_assert(classify_keyword("struct") == TokenType::Struct);
+static_assert(classify_keyword("enum") == TokenType::Enum);
+static_assert(classify_keyword("type") == TokenType::Type);
+static_assert(classify_keyword("trait") == TokenType::Trait);
+static_assert(classify_keyword("true") == TokenType::True);
+static_assert(classify_keyword("false") == TokenType::False);
+static_assert(!classify_keyword("iff").has_value());
+static_assert(!classify_keyword("it").has_value());
+static_assert(!classify_keyword("elsa").has_value());
+static_assert(!classify_keyword("").has_value());
+
+} // namespace
+
+std::optional<TokenType> get_keyword(std::string_view word) noexcept {
+  // NOTE: 关键字集合固定且很小，使用编译期生成的 "长度 + 首字符" 分派
+  //       代替哈希表：无需对输入求哈希，绝大多数普通标识符在长度或首字符
+  //       分派处即被拒绝，其余的也只需一次比较。
+  return classify_keyword(word);
+}
+
+namespace {
+
+struct TokenTypeName {
+  TokenType type;
+  std::string_view name;
+};
+
+// 按枚举值排列的名称表，`token_type_name` 以枚举值直接索引。
+constexpr std::array<TokenTypeName, TOKEN_TYPE_COUNT> TOKEN_TYPE_NAMES{{
+    {TokenType::Integer, "Integer"},
+    {TokenType::Float, "Float"},
+    {TokenType::String, "String"},
+    {TokenType::Identifier, "Identifier"},
+    {TokenType::ScientificExponent, "ScientificExponent"},
+    {TokenType::Comment, "Comment"},
+    {TokenType::Let, "Let"},
+    {TokenType::Var, "Var"},
+    {TokenType::Fn, "Fn"},
+    {TokenType::Return, "Return"},
+    {TokenType::If, "If"},
+    {TokenType::Else, "Else"},
+    {TokenType::While, "While"},
+    {TokenType::For, "For"},
+    {TokenType::In, "In"},
+    {TokenType::Struct, "Struct"},
+    {TokenType::Enum, "Enum"},
+    {TokenType::Type, "Type"},
+    {TokenType::Trait, "Trait"},
+    {TokenType::True, "True"},
+    {TokenType::False, "False"},
+    {TokenType::Plus, "Plus"},
+    {TokenType::Minus, "Minus"},
+    {TokenType::Star, "Star"},
+    {TokenType::Slash, "Slash"},
+    {TokenType::Percent, "Percent"},
+    {TokenType::Equal, "Equal"},
+    {TokenType::PlusEqual, "PlusEqual"},
+    {TokenType::MinusEqual, "MinusEqual"},
+    {TokenType::StarEqual, "StarEqual"},
+    {TokenType::PercentEqual, "PercentEqual"},
+    {TokenType::SlashEqual, "SlashEqual"},
+    {TokenType::EqualEqual, "EqualEqual"},
+    {TokenType::BangEqual, "BangEqual"},
+    {TokenType::Less, "Less"},
+    {TokenType::LessEqual, "LessEqual"},
+    {TokenType::Greater, "Greater"},
+    {TokenType::GreaterEqual, "GreaterEqual"},
+    {TokenType::And, "And"},
+    {TokenType::Or, "Or"},
+    {TokenType::AndAnd, "AndAnd"},
+    {TokenType::OrOr, "OrOr"},
+    {TokenType::Bang, "Bang"},
+    {TokenType::Tilde, "Tilde"},
+    {TokenType::LeftParen, "LeftParen"},
+    {TokenType::RightParen, "RightParen"},
+    {TokenType::LeftBrace, "LeftBrace"},
+    {TokenType::RightBrace, "RightBrace"},
+    {TokenType::LeftBracket, "LeftBracket"},
+    {TokenType::RightBracket, "RightBracket"},
+    {TokenType::Comma, "Comma"},
+    {TokenType::Semicolon, "Semicolon"},
+    {TokenType::Colon, "Colon"},
+    {TokenType::Dot, "Dot"},
+    {TokenType::DotDot, "DotDot"},
+    {TokenType::Arrow, "Arrow"},
+    {TokenType::EndOfFile, "EOF"},
+    {TokenType::Unknown, "Unknown"},
+}};
+
+// 编译期校验名称表与枚举的顺序一致，漏项或错位都无法通过编译。
+constexpr bool token_type_names_in_order() {
+  for (size_t i = 0; i < TOKEN_TYPE_NAMES.size(); ++i) {
+    if (static_cast<size_t>(TOKEN_TYPE_NAMES[i].type) != i) {
+      return false;
+    }
   }
+  return true;
+}
+
+static_assert(token_type_names_in_order());
+
+} // namespace
+
+std::string token_type_to_string(TokenType type) {
+  return std::string(token_type_name(type));
+}
+
+std::string_view token_type_name(TokenType type) noexcept {
+  auto index = static_cast<size_t>(type);
+  return index < TOKEN_TYPE_NAMES.size() ? TOKEN_TYPE_NAMES[index].name
+                                         : "Unknown";
+}
+
+namespace {
+
+// 字符串超出 SSO 容量后的堆缓冲区大小（含结尾的空字符）。
+size_t string_heap_bytes(const std::string& text) noexcept {
+  static const size_t sso_capacity = std::string().capacity();
+  return text.capacity() > sso_capacity ? text.capacity() + 1 : 0;
+}
+
+} // namespace
+
+size_t get_heap_bytes(const Token& token) noexcept {
+  return string_heap_bytes(token.value) + string_heap_bytes(token.raw_literal);
 }
 
 } // namespace czc::lexer
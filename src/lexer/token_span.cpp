@@ -0,0 +1,185 @@
+/**
+ * @file token_span.cpp
+ * @brief `TokenSpanList` 的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-20
+ */
+
+#include "czc/lexer/token_span.hpp"
+
+#include "czc/lexer/number_decoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace czc::lexer {
+
+TokenSpanList::TokenSpanList(std::string source)
+    : TokenSpanList(
+          std::make_shared<const utils::SourceBuffer>(std::move(source))) {}
+
+TokenSpanList::TokenSpanList(std::shared_ptr<const utils::SourceBuffer> source)
+    : buffer_(std::move(source)), source_(buffer_->view()) {}
+
+std::string_view
+TokenSpanList::natural_string_value(const TokenSpan& span) const {
+  std::string_view slice(source_.data() + span.offset, span.length);
+
+  // NOTE: 普通字符串以 `"` 开头，原始字符串以 `r"` 开头。
+  //       未闭合的字符串没有结尾引号，因此只有在末尾确实是 `"` 时才去掉它。
+  size_t prefix = span.is_raw_string() ? 2 : 1;
+  if (slice.size() < prefix) {
+    return {};
+  }
+  slice.remove_prefix(prefix);
+  if (!slice.empty() && slice.back() == '"') {
+    slice.remove_suffix(1);
+  }
+  return slice;
+}
+
+void TokenSpanList::push_back(TokenSpan span, std::string_view cooked) {
+  std::string_view natural =
+      span.token_type == TokenType::String
+          ? natural_string_value(span)
+          : std::string_view(source_.data() + span.offset, span.length);
+
+  span.cooked_index = TokenSpan::NO_COOKED;
+  // NOTE: 不含转义的字符串由 Lexer 直接以源码切片传入，与自然值是同一段
+  //       内存，比较指针即可，不必逐字节比较。
+  if (cooked.data() != natural.data() || cooked.size() != natural.size()) {
+    if (cooked != natural) {
+      span.cooked_index = static_cast<uint32_t>(cooked_values_.size());
+      cooked_values_.push_back(store_cooked(cooked));
+    }
+  }
+  spans_.push_back(span);
+}
+
+void TokenSpanList::set_line_starts(std::vector<uint32_t> line_starts) {
+  line_starts_ = std::move(line_starts);
+}
+
+void TokenSpanList::ensure_line_starts() const {
+  if (!line_starts_.empty()) {
+    return;
+  }
+  line_starts_.push_back(0);
+  const char* data = source_.data();
+  size_t size = source_.size();
+  size_t pos = 0;
+  while (pos < size) {
+    const void* hit = std::memchr(data + pos, '\n', size - pos);
+    if (hit == nullptr) {
+      break;
+    }
+    pos = static_cast<size_t>(static_cast<const char*>(hit) - data) + 1;
+    line_starts_.push_back(static_cast<uint32_t>(pos));
+  }
+}
+
+const std::vector<uint32_t>& TokenSpanList::line_starts() const {
+  ensure_line_starts();
+  return line_starts_;
+}
+
+utils::LineColumn TokenSpanList::line_column(size_t index) const {
+  const TokenSpan& span = spans_[index];
+  if (span.token_type == TokenType::EndOfFile) {
+    return {0, 0};
+  }
+  ensure_line_starts();
+  // 第一个起始偏移大于 offset 的行的前一行即为所在行。
+  auto it = std::upper_bound(line_starts_.begin(), line_starts_.end(),
+                             span.offset);
+  size_t line = static_cast<size_t>(it - line_starts_.begin());
+  return {line, span.offset - line_starts_[line - 1] + 1};
+}
+
+std::string_view TokenSpanList::store_cooked(std::string_view value) {
+  if (value.empty()) {
+    return {};
+  }
+  if (!cooked_arena_) {
+    cooked_arena_ = std::make_unique<utils::Arena>(COOKED_ARENA_BLOCK_SIZE);
+  }
+  auto* data = static_cast<char*>(cooked_arena_->allocate(value.size(), 1));
+  std::memcpy(data, value.data(), value.size());
+  return {data, value.size()};
+}
+
+void TokenSpanList::set_cooked(size_t index, std::string_view value) {
+  TokenSpan& span = spans_[index];
+  // NOTE: 被覆盖的旧值仍留在 Arena 中，随容器一起释放。
+  if (span.cooked_index != TokenSpan::NO_COOKED) {
+    cooked_values_[span.cooked_index] = store_cooked(value);
+    return;
+  }
+  span.cooked_index = static_cast<uint32_t>(cooked_values_.size());
+  cooked_values_.push_back(store_cooked(value));
+}
+
+std::string_view TokenSpanList::text(size_t index) const noexcept {
+  const TokenSpan& span = spans_[index];
+  return {source_.data() + span.offset, span.length};
+}
+
+std::string_view TokenSpanList::value(size_t index) const noexcept {
+  const TokenSpan& span = spans_[index];
+  if (span.cooked_index != TokenSpan::NO_COOKED) {
+    return cooked_values_[span.cooked_index];
+  }
+  if (span.token_type == TokenType::String) {
+    return natural_string_value(span);
+  }
+  return text(index);
+}
+
+std::string_view TokenSpanList::raw_literal(size_t index) const noexcept {
+  if (spans_[index].token_type != TokenType::String) {
+    return {};
+  }
+  return text(index);
+}
+
+Token TokenSpanList::to_token(size_t index) const {
+  return to_token(index, line_column(index));
+}
+
+Token TokenSpanList::to_token(size_t index, utils::LineColumn position) const {
+  const TokenSpan& span = spans_[index];
+  Token token(span.token_type, std::string(value(index)), position.line,
+              position.column);
+  token.raw_literal = std::string(raw_literal(index));
+  token.is_raw_string = span.is_raw_string();
+  token.offset = span.offset;
+  token.length = span.length;
+  // NOTE: span 只有 16 字节，不保存解码值；还原时按文本重新解码一次。
+  decode_numeric_value(token, token.value);
+  return token;
+}
+
+std::vector<Token> TokenSpanList::to_tokens() const {
+  std::vector<Token> tokens;
+  tokens.reserve(spans_.size());
+
+  // NOTE: span 的偏移单调递增，顺序推进行游标即可，无需逐个二分查找。
+  ensure_line_starts();
+  size_t line = 1;
+  for (size_t i = 0; i < spans_.size(); ++i) {
+    const TokenSpan& span = spans_[i];
+    if (span.token_type == TokenType::EndOfFile) {
+      tokens.push_back(to_token(i, {0, 0}));
+      continue;
+    }
+    while (line < line_starts_.size() && line_starts_[line] <= span.offset) {
+      line++;
+    }
+    tokens.push_back(
+        to_token(i, {line, span.offset - line_starts_[line - 1] + 1}));
+  }
+  return tokens;
+}
+
+} // namespace czc::lexer
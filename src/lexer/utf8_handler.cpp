@@ -7,6 +7,8 @@
 
 #include "czc/lexer/utf8_handler.hpp"
 
+#include "czc/lexer/scan_kernels.hpp"
+
 namespace czc::lexer {
 
 bool Utf8Handler::is_continuation(unsigned char ch) {
@@ -48,7 +50,11 @@ size_t Utf8Handler::get_char_length(unsigned char first_byte) {
 
 std::string Utf8Handler::codepoint_to_utf8(unsigned int codepoint) {
   std::string result;
+  append_utf8(result, codepoint);
+  return result;
+}
 
+void Utf8Handler::append_utf8(std::string& result, unsigned int codepoint) {
   // --- Unicode 码点到 UTF-8 字节序列的转换算法 ---
   // NOTE: 该算法严格遵循 RFC 3629 标准。它根据码点的大小范围，将码点的
   //       二进制位填充到对应的 UTF-8 字节模板中。
@@ -84,8 +90,6 @@ std::string Utf8Handler::codepoint_to_utf8(unsigned int codepoint) {
         static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));       // 6 bits
     result.push_back(static_cast<char>(0x80 | (codepoint & 0x3F))); // 6 bits
   }
-
-  return result;
 }
 
 bool Utf8Handler::read_char(const std::string& input, size_t& pos,
@@ -154,4 +158,60 @@ bool Utf8Handler::read_char(const std::vector<char>& input, size_t& pos,
   return true;
 }
 
+namespace {
+
+/**
+ * @brief 返回 `pos` 处完整且有效的 UTF-8 序列的长度；无效时返回 0。
+ */
+size_t valid_sequence_length(const char* data, size_t pos,
+                             size_t end) noexcept {
+  size_t char_len =
+      Utf8Handler::get_char_length(static_cast<unsigned char>(data[pos]));
+  if (char_len == 0 || char_len > end - pos) {
+    return 0;
+  }
+  for (size_t i = 1; i < char_len; i++) {
+    if (!Utf8Handler::is_continuation(
+            static_cast<unsigned char>(data[pos + i]))) {
+      return 0;
+    }
+  }
+  return char_len;
+}
+
+} // namespace
+
+size_t Utf8Handler::validate(const char* data, size_t pos,
+                             size_t end) noexcept {
+  while (pos < end) {
+    // --- ASCII 快速路径 ---
+    pos = scan::skip_ascii(data, pos, end);
+    if (pos >= end) {
+      break;
+    }
+
+    // --- 多字节字符 ---
+    // NOTE: 遇到非 ASCII 字节后连续处理多字节字符，CJK 文本通常整段都是
+    //       多字节字符，无需每个字符都回到 ASCII 内核。
+    size_t next = skip_multibyte(data, pos, end);
+    if (next == pos) {
+      return pos; // pos 处为无效序列
+    }
+    pos = next;
+  }
+  return end;
+}
+
+size_t Utf8Handler::skip_multibyte(const char* data, size_t pos,
+                                   size_t end) noexcept {
+  while (pos < end && static_cast<unsigned char>(data[pos]) >= 0x80) {
+    size_t char_len = valid_sequence_length(data, pos, end);
+    if (char_len == 0) {
+      break;
+    }
+    pos += char_len;
+  }
+  return pos;
+}
+
 } // namespace czc::lexer
@@ -0,0 +1,61 @@
+/**
+ * @file bracket_table.cpp
+ * @brief `BracketTable` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/parser/bracket_table.hpp"
+
+namespace czc::parser {
+
+using namespace czc::lexer;
+
+BracketTable::BracketTable(const std::vector<Token>& tokens)
+    : match(tokens.size(), NONE), enclosing_brace(tokens.size(), NONE) {
+  // 三种括号各用一个栈，保存尚未闭合的左括号下标。
+  std::vector<uint32_t> parens;
+  std::vector<uint32_t> brackets;
+  std::vector<uint32_t> braces;
+
+  auto close = [this](std::vector<uint32_t>& stack, uint32_t index) {
+    if (!stack.empty()) {
+      match[stack.back()] = index;
+      match[index] = stack.back();
+      stack.pop_back();
+    }
+  };
+
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    auto index = static_cast<uint32_t>(i);
+
+    // NOTE: 先记录处理本 Token 之前的最内层 `{`：`{` 因此归属外层代码块，
+    //       `}` 则归属它所闭合的代码块。
+    enclosing_brace[i] = braces.empty() ? NONE : braces.back();
+
+    switch (tokens[i].token_type) {
+    case TokenType::LeftParen:
+      parens.push_back(index);
+      break;
+    case TokenType::LeftBracket:
+      brackets.push_back(index);
+      break;
+    case TokenType::LeftBrace:
+      braces.push_back(index);
+      break;
+    case TokenType::RightParen:
+      close(parens, index);
+      break;
+    case TokenType::RightBracket:
+      close(brackets, index);
+      break;
+    case TokenType::RightBrace:
+      close(braces, index);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+} // namespace czc::parser
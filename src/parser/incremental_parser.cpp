@@ -0,0 +1,200 @@
+/**
+ * @file incremental_parser.cpp
+ * @brief `IncrementalParser` 的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/parser/incremental_parser.hpp"
+
+#include "czc/utils/source_manager.hpp"
+#include "czc/utils/time_report.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace czc::parser {
+
+using namespace czc::cst;
+using namespace czc::lexer;
+
+namespace {
+
+// NOTE: 解析一个条目时最远查看到其结尾之后的那个 Token（顶层循环检查
+//       下一个条目的首个 Token，`peek(1)` 也不会越过它），因此只有结尾
+//       之后至少还有这么多个未改变的 Token 时，条目才能原样保留。
+constexpr size_t LOOKAHEAD = 1;
+
+} // namespace
+
+IncrementalParser::IncrementalParser(const std::string& filename)
+    : filename(filename),
+      file_id(utils::SourceManager::instance().add_file(filename)) {}
+
+const CSTNode* IncrementalParser::parse(const std::vector<Token>& tokens) {
+  CZC_TIME_PHASE(Parse);
+  items.clear();
+  parse_items(tokens, 0, tokens.size(), 0, {});
+  last_stats = {0, items.size()};
+  rebuild(tokens);
+  return program.get();
+}
+
+const CSTNode* IncrementalParser::reparse(const std::vector<Token>& tokens,
+                                          const RelexRange& range) {
+  // --- 校验窗口与上一次的序列是否相符 ---
+  bool consistent = program != nullptr && token_count > 0 &&
+                    range.first + range.removed <= token_count &&
+                    token_count - range.removed + range.inserted ==
+                        tokens.size();
+  if (!consistent) {
+    return parse(tokens);
+  }
+  CZC_TIME_PHASE(Parse);
+
+  // --- 取回各条目的节点 ---
+  CSTChildList children = program->take_children();
+  program.reset();
+  size_t next_child = 0;
+  for (Item& item : items) {
+    if (item.has_node) {
+      item.node = std::move(children[next_child++]);
+    }
+  }
+
+  // --- 保留编辑窗口之前的条目 ---
+  std::vector<Item> old_items = std::move(items);
+  items.clear();
+  size_t prefix = 0;
+  while (prefix < old_items.size() &&
+         old_items[prefix].end_token + LOOKAHEAD <= range.first) {
+    items.push_back(std::move(old_items[prefix]));
+    ++prefix;
+  }
+  size_t start = items.empty() ? 0 : items.back().end_token;
+  old_items.erase(old_items.begin(),
+                  old_items.begin() + static_cast<std::ptrdiff_t>(prefix));
+
+  // --- 重新解析，直到与旧条目重新同步 ---
+  const auto index_delta = static_cast<std::ptrdiff_t>(range.inserted) -
+                           static_cast<std::ptrdiff_t>(range.removed);
+  size_t before = items.size();
+  size_t resync = parse_items(tokens, start, range.first + range.inserted,
+                              index_delta, old_items);
+  size_t reparsed = items.size() - before;
+
+  // --- 平移并沿用其后的旧条目 ---
+  // 以重新同步的条目起点为锚，规则与 `Lexer::relex` 平移旧 Token 相同。
+  if (resync < old_items.size()) {
+    const Item& anchor = old_items[resync];
+    const Token& anchor_token =
+        tokens[static_cast<size_t>(static_cast<std::ptrdiff_t>(
+                                       anchor.first_token) +
+                                   index_delta)];
+    PositionShift shift;
+    shift.offset_delta = static_cast<std::ptrdiff_t>(anchor_token.offset) -
+                         static_cast<std::ptrdiff_t>(anchor.offset);
+    shift.line_delta = static_cast<std::ptrdiff_t>(anchor_token.line) -
+                       static_cast<std::ptrdiff_t>(anchor.line);
+    shift.anchor_line = anchor.line;
+    shift.column_delta = static_cast<std::ptrdiff_t>(anchor_token.column) -
+                         static_cast<std::ptrdiff_t>(anchor.column);
+
+    std::vector<CSTNode*> roots;
+    for (size_t i = resync; i < old_items.size(); ++i) {
+      Item& item = old_items[i];
+      item.first_token = static_cast<size_t>(
+          static_cast<std::ptrdiff_t>(item.first_token) + index_delta);
+      item.end_token = static_cast<size_t>(
+          static_cast<std::ptrdiff_t>(item.end_token) + index_delta);
+      item.offset = static_cast<size_t>(
+          static_cast<std::ptrdiff_t>(item.offset) + shift.offset_delta);
+      if (item.line == shift.anchor_line) {
+        item.column = static_cast<size_t>(
+            static_cast<std::ptrdiff_t>(item.column) + shift.column_delta);
+      }
+      if (item.line != 0) {
+        item.line = static_cast<size_t>(
+            static_cast<std::ptrdiff_t>(item.line) + shift.line_delta);
+      }
+      if (item.node) {
+        roots.push_back(item.node.get());
+      }
+      for (ParserError& error : item.errors) {
+        shift.apply(error.location);
+      }
+      items.push_back(std::move(item));
+    }
+    shift_positions(std::move(roots), shift);
+  }
+
+  last_stats = {items.size() - reparsed, reparsed};
+  rebuild(tokens);
+  return program.get();
+}
+
+size_t IncrementalParser::parse_items(const std::vector<Token>& tokens,
+                                      size_t start, size_t resync_begin,
+                                      std::ptrdiff_t index_delta,
+                                      const std::vector<Item>& old_items) {
+  Parser parser(std::make_unique<VectorTokenSource>(tokens, start,
+                                                    tokens.size()),
+                filename);
+  parser.set_max_depth(max_depth);
+
+  size_t old_cursor = 0;
+  while (!parser.at_end()) {
+    Item item;
+    item.first_token = start + parser.get_position();
+    const Token& first = tokens[item.first_token];
+    item.line = first.line;
+    item.column = first.column;
+    item.offset = first.offset;
+
+    size_t errors_before = parser.get_errors().size();
+    item.node = parser.parse_top_level_item();
+    item.has_node = item.node != nullptr;
+    item.end_token = start + parser.get_position();
+    const auto& all_errors = parser.get_errors();
+    item.errors.assign(
+        all_errors.begin() + static_cast<std::ptrdiff_t>(errors_before),
+        all_errors.end());
+    size_t end = item.end_token;
+    items.push_back(std::move(item));
+
+    // NOTE: 下一个条目与某个旧条目起点相同、且都位于窗口之后时，两者面对
+    //       完全相同的 Token 与全新的顶层状态，其后的解析结果必然相同。
+    if (end < resync_begin) {
+      continue;
+    }
+    auto old_end =
+        static_cast<size_t>(static_cast<std::ptrdiff_t>(end) - index_delta);
+    while (old_cursor < old_items.size() &&
+           old_items[old_cursor].first_token < old_end) {
+      ++old_cursor;
+    }
+    if (old_cursor < old_items.size() &&
+        old_items[old_cursor].first_token == old_end) {
+      return old_cursor;
+    }
+  }
+  return old_items.size();
+}
+
+void IncrementalParser::rebuild(const std::vector<Token>& tokens) {
+  token_count = tokens.size();
+  // 与 `Parser::parse` 相同：程序的位置是首个 Token 的位置。
+  const Token& first = tokens.empty() ? Token::makeEOF() : tokens.front();
+  program = make_cst_node(CSTNodeType::Program,
+                          utils::SourceLocation(file_id, first.line,
+                                                first.column));
+  errors.clear();
+  for (Item& item : items) {
+    if (item.node) {
+      program->add_child(std::move(item.node));
+    }
+    errors.insert(errors.end(), item.errors.begin(), item.errors.end());
+  }
+}
+
+} // namespace czc::parser
@@ -0,0 +1,92 @@
+/**
+ * @file lazy_parser.cpp
+ * @brief `LazyParser` 的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/parser/lazy_parser.hpp"
+
+#include "czc/lexer/token_source.hpp"
+#include "czc/utils/time_report.hpp"
+
+#include <utility>
+
+namespace czc::parser {
+
+using namespace czc::cst;
+using namespace czc::lexer;
+
+LazyParser::LazyParser(const std::vector<Token>& tokens,
+                       const std::string& filename)
+    : tokens(tokens), filename(filename) {}
+
+const CSTNode* LazyParser::parse() {
+  Parser parser(tokens, filename);
+  parser.set_max_depth(max_depth);
+  parser.set_defer_bodies(true);
+  program = parser.parse();
+  errors = parser.get_errors();
+
+  bodies = parser.get_deferred_bodies();
+  pending.clear();
+  pending.reserve(bodies.size());
+  for (size_t i = 0; i < bodies.size(); ++i) {
+    pending.emplace(bodies[i].function, i);
+  }
+  return program.get();
+}
+
+const CSTNode* LazyParser::get_body(const CSTNode* function) {
+  if (function == nullptr) {
+    return nullptr;
+  }
+  auto it = pending.find(function);
+  if (it != pending.end()) {
+    size_t index = it->second;
+    pending.erase(it);
+    expand(bodies[index]);
+  }
+
+  // NOTE: 函数体是函数声明中唯一的 `BlockStmt` 子节点。
+  for (const auto& child : function->get_children()) {
+    if (child && child->get_type() == CSTNodeType::BlockStmt) {
+      return child.get();
+    }
+  }
+  return nullptr;
+}
+
+void LazyParser::expand_all() {
+  for (const DeferredBody& body : bodies) {
+    auto it = pending.find(body.function);
+    if (it != pending.end()) {
+      pending.erase(it);
+      expand(body);
+    }
+  }
+}
+
+void LazyParser::expand(const DeferredBody& body) {
+  CZC_TIME_PHASE(Parse);
+  Parser parser(std::make_unique<VectorTokenSource>(tokens, body.first_token,
+                                                    body.end_token),
+                filename);
+  parser.set_max_depth(max_depth);
+  auto block = parser.parse_function_body();
+  const auto& body_errors = parser.get_errors();
+  errors.insert(errors.end(), body_errors.begin(), body_errors.end());
+  if (!block) {
+    return;
+  }
+
+  CSTChildList children = body.function->take_children();
+  for (auto& child : children) {
+    if (child.get() == body.placeholder) {
+      child = std::move(block);
+    }
+    body.function->add_child(std::move(child));
+  }
+}
+
+} // namespace czc::parser
@@ -7,9 +7,15 @@
 
 #include "czc/parser/parser.hpp"
 
+#include "czc/cst/comment_table.hpp"
 #include "czc/diagnostics/diagnostic_code.hpp"
+#include "czc/parser/declaration_sink.hpp"
+#include "czc/utils/capacity_estimate.hpp"
+#include "czc/utils/source_manager.hpp"
+#include "czc/utils/time_report.hpp"
 
 #include <algorithm>
+#include <optional>
 #include <unordered_set>
 
 namespace czc::parser {
@@ -20,28 +26,35 @@ using namespace czc::lexer;
 using namespace czc::utils;
 
 Parser::Parser(const std::vector<Token>& tokens, const std::string& filename)
-    : tokens(tokens), current(0), filename(filename) {}
-
-Token Parser::current_token() const {
-  if (current < tokens.size()) {
-    return tokens[current];
-  }
-  // NOTE: 返回一个 EOF Token 作为哨兵（Sentinel）。这简化了调用方的代码，
-  //       使其不必在每次调用前都检查是否已到达 Token 流的末尾。
-  return Token::makeEOF();
+    : tokens(std::make_unique<VectorTokenSource>(tokens)), current(0),
+      materialized_tokens(this->tokens.get_source().get_materialized_tokens()),
+      file_id(SourceManager::instance().add_file(filename)) {}
+
+Parser::Parser(std::vector<Token>&& tokens, const std::string& filename)
+    : tokens(std::make_unique<VectorTokenSource>(std::move(tokens))),
+      current(0),
+      materialized_tokens(this->tokens.get_source().get_materialized_tokens()),
+      file_id(SourceManager::instance().add_file(filename)) {}
+
+Parser::Parser(std::unique_ptr<TokenSource> source, const std::string& filename)
+    : tokens(std::move(source)), current(0),
+      materialized_tokens(this->tokens.get_source().get_materialized_tokens()),
+      file_id(SourceManager::instance().add_file(filename)) {}
+
+const Token& Parser::current_token() const {
+  // NOTE: 越过末尾时 TokenBuffer 返回 EOF Token 作为哨兵（Sentinel）。
+  //       这简化了调用方的代码，使其不必在每次调用前都检查是否已到达
+  //       Token 流的末尾。哨兵就是缓冲区中已拉取的 EOF Token，无需每次构造。
+  return tokens[current];
 }
 
-Token Parser::peek(size_t offset) const {
-  size_t index = current + offset;
-  if (index < tokens.size()) {
-    return tokens[index];
-  }
-  return Token::makeEOF();
+const Token& Parser::peek(size_t offset) const {
+  return tokens[current + offset];
 }
 
-Token Parser::advance() {
-  Token token = current_token();
-  if (current < tokens.size()) {
+const Token& Parser::advance() {
+  const Token& token = current_token();
+  if (!tokens.past_end(current)) {
     current++;
   }
   return token;
@@ -51,9 +64,12 @@ bool Parser::check(TokenType type) const {
   return current_token().token_type == type;
 }
 
-bool Parser::match_token(const std::vector<TokenType>& types) {
-  for (const auto& type : types) {
-    if (check(type)) {
+bool Parser::match_token(std::initializer_list<TokenType> types) {
+  // NOTE: 以 initializer_list 传参，`match_token({...})` 不再为每次调用
+  //       构造一个临时的 std::vector。
+  TokenType actual = current_token().token_type;
+  for (TokenType type : types) {
+    if (actual == type) {
       advance();
       return true;
     }
@@ -61,9 +77,9 @@ bool Parser::match_token(const std::vector<TokenType>& types) {
   return false;
 }
 
-std::optional<Token> Parser::consume(TokenType type) {
+const Token* Parser::consume(TokenType type) {
   if (check(type)) {
-    return advance();
+    return &advance();
   }
 
   // 记录错误
@@ -81,18 +97,21 @@ std::optional<Token> Parser::consume(TokenType type) {
   if (type == TokenType::Semicolon) {
     synchronize_to_semicolon();
     // 返回虚拟分号以继续解析（标记为 synthetic）
-    return Token(TokenType::Semicolon, ";", current_token().line,
-                 current_token().column, true);
+    synthetic_token = Token(TokenType::Semicolon, ";", current_token().line,
+                            current_token().column, true);
+    return &synthetic_token;
   }
 
   // 如果期望的是右括号、右方括号、右大括号，尝试同步
   if (type == TokenType::RightParen || type == TokenType::RightBracket ||
       type == TokenType::RightBrace) {
     // 在匹配的分隔符丢失时，返回虚拟 Token（标记为 synthetic）
-    return Token(type, "", current_token().line, current_token().column, true);
+    synthetic_token =
+        Token(type, "", current_token().line, current_token().column, true);
+    return &synthetic_token;
   }
 
-  return std::nullopt;
+  return nullptr;
 }
 
 void Parser::synchronize_to_semicolon() {
@@ -117,7 +136,7 @@ void Parser::synchronize_to_semicolon() {
 
 void Parser::synchronize_to_statement_start() {
   while (!check(TokenType::EndOfFile)) {
-    Token current = current_token();
+    const Token& current = current_token();
 
     // 停在语句关键字
     if (current.token_type == TokenType::Let ||
@@ -141,6 +160,19 @@ void Parser::synchronize_to_statement_start() {
 }
 
 void Parser::synchronize_to_block_end() {
+  // NOTE: 配对表给出的跳转目标与下面按大括号深度扫描的结果相同：
+  //       都是当前位置之前最内层未闭合的 `{` 所配对的 `}`。
+  if (const BracketTable* table = get_bracket_table()) {
+    uint32_t open = table->get_enclosing_brace(current);
+    uint32_t close = open == BracketTable::NONE ? BracketTable::NONE
+                                                : table->get_match(open);
+    if (close != BracketTable::NONE && close >= current) {
+      tokens.skip_to(close);
+      current = close;
+      return;
+    }
+  }
+
   int brace_depth = 1; // 我们已经在一个代码块内
 
   while (!check(TokenType::EndOfFile) && brace_depth > 0) {
@@ -156,40 +188,225 @@ void Parser::synchronize_to_block_end() {
   }
 }
 
+const BracketTable* Parser::get_bracket_table() {
+  if (materialized_tokens == nullptr) {
+    return nullptr;
+  }
+  if (!bracket_table) {
+    bracket_table.emplace(*materialized_tokens);
+  }
+  return &*bracket_table;
+}
+
+Parser::NestingGuard::NestingGuard(Parser& parser) : parser(parser) {
+  if (++parser.depth <= parser.max_depth || parser.depth_exceeded) {
+    return;
+  }
+
+  parser.report_error(DiagnosticCode::P0014_NestingTooDeep,
+                      parser.make_location(),
+                      {std::to_string(parser.max_depth)});
+  parser.depth_exceeded = true;
+
+  // NOTE: 直接跳到输入末尾：各层调用看到 EOF 后自然退出，
+  //       无需在每个解析函数中增加额外的退出路径。
+  while (!parser.check(TokenType::EndOfFile)) {
+    parser.advance();
+  }
+}
+
 void Parser::report_error(DiagnosticCode code, const SourceLocation& location,
                           const std::vector<std::string>& args) {
+  // 放弃解析后不再报告由此引发的级联错误（缺少右括号、分号等）。
+  if (depth_exceeded) {
+    return;
+  }
   ParserError error(code, location, args);
   error_collector.add(error);
+  // NOTE: 达到错误上限后在当前位置截断 Token 流：各层调用看到 EOF 后
+  //       自然退出，剩余的源码也不再进行词法分析。
+  if (error_collector.limit_reached()) {
+    tokens.truncate(current);
+  }
 }
 
 SourceLocation Parser::make_location() const {
-  Token token = current_token();
-  return SourceLocation(filename, token.line, token.column);
+  const Token& token = current_token();
+  return SourceLocation(file_id, token.line, token.column);
 }
 
+namespace {
+
+/**
+ * @brief 把顶层声明依次挂到 `Program` 节点下的接收器，即 `parse()` 的行为。
+ */
+class ProgramSink final : public DeclarationSink {
+public:
+  explicit ProgramSink(CSTNode& program) noexcept : program(program) {}
+
+  void begin_program(const SourceLocation&) override {}
+
+  void add_declaration(std::unique_ptr<CSTNode> node) override {
+    program.add_child(std::move(node));
+  }
+
+private:
+  CSTNode& program;
+};
+
+/**
+ * @brief 统计一棵 CST 的节点数（供 `--time-report` 使用）。
+ */
+[[maybe_unused]] size_t count_nodes(const CSTNode* root) {
+  size_t count = 0;
+  std::vector<const CSTNode*> stack{root};
+  while (!stack.empty()) {
+    const CSTNode* node = stack.back();
+    stack.pop_back();
+    ++count;
+    for (const auto& child : node->get_children()) {
+      stack.push_back(child.get());
+    }
+  }
+  return count;
+}
+
+} // namespace
+
 std::unique_ptr<CSTNode> Parser::parse() {
-  auto program = make_cst_node(CSTNodeType::Program, make_location());
+  CZC_TIME_PHASE(Parse);
+  std::unique_ptr<CSTNode> program;
+  std::optional<CSTArenaScope> arena_scope;
+  size_t token_hint = 0;
+  if (arena_enabled) {
+    // NOTE: 根节点在作用域之外创建，它本身留在堆上并持有 Arena；
+    //       之后创建的所有节点都落在该 Arena 中。Arena 的首块按预估的
+    //       Token 数一次申请，大文件不必经过多轮逐块翻倍。
+    token_hint = tokens.get_source().size_hint();
+    size_t block_size =
+        utils::CapacityEstimate::estimate_arena_block(token_hint);
+    auto root = std::make_unique<CSTArenaRoot>(CSTNodeType::Program,
+                                               make_location(), block_size);
+    arena_scope.emplace(root->get_arena());
+    program = std::move(root);
+  } else {
+    program = make_cst_node(CSTNodeType::Program, make_location());
+  }
 
+  ProgramSink sink(*program);
+  parse_top_level(sink);
+  if (structural_hash_enabled) {
+    compute_structural_hash(program.get());
+  }
+  if (arena_enabled) {
+    const auto& root = static_cast<const CSTArenaRoot&>(*program);
+    // NOTE: 以预估时所用的 Token 数修正，使比例与 `size_hint` 的口径
+    //       （如是否计入注释）一致。
+    utils::CapacityEstimate::observe_arena(token_hint ? token_hint : current,
+                                           root.get_arena().get_bytes_used());
+  }
+  CZC_COUNT(Parse, CSTNodes, count_nodes(program.get()));
+  CZC_COUNT(Parse, Errors, error_collector.count());
+  return program;
+}
+
+void Parser::parse(DeclarationSink& sink) {
+  CZC_TIME_PHASE(Parse);
+  sink.begin_program(make_location());
+  parse_top_level(sink);
+  CZC_COUNT(Parse, Errors, error_collector.count());
+}
+
+void Parser::parse_top_level(DeclarationSink& sink) {
   while (!check(TokenType::EndOfFile)) {
-    // 处理注释：将注释作为 CST 节点添加到程序中
-    if (check(TokenType::Comment)) {
-      auto comment_token = advance();
-      auto comment_node = make_cst_node(CSTNodeType::Comment, comment_token);
-      program->add_child(std::move(comment_node));
-      continue;
+    // 共享的报告器可能因词法或预处理错误达到上限，每个声明确认一次。
+    if (error_collector.poll_limit()) {
+      tokens.truncate(current);
+      break;
+    }
+    if (auto item = parse_top_level_item()) {
+      if (structural_hash_enabled) {
+        compute_structural_hash(item.get());
+      }
+      sink.add_declaration(std::move(item));
+    }
+  }
+}
+
+std::unique_ptr<CSTNode> Parser::parse_top_level_item() {
+  if (check(TokenType::EndOfFile)) {
+    return nullptr;
+  }
+
+  // 处理注释：将注释作为 CST 节点交给接收器
+  if (check(TokenType::Comment)) {
+    if (comment_table == nullptr) {
+      const Token& comment_token = advance();
+      return make_cst_node(CSTNodeType::Comment, comment_token);
+    }
+    // 设置了注释表时暂存，附着到之后的声明上；文件末尾的附着在空指针上。
+    while (check(TokenType::Comment)) {
+      pending_top_level_comments.push_back(advance());
     }
+    if (check(TokenType::EndOfFile)) {
+      attach_comments(nullptr, CommentPlacement::Dangling,
+                      pending_top_level_comments);
+      return nullptr;
+    }
+  }
+
+  size_t start = current;
+  auto stmt = declaration();
+  if (!stmt) {
+    // --- 增强的错误恢复 ---
+    // 当声明解析失败时，使用专门的同步方法恢复到下一个语句开始
+    synchronize_to_statement_start();
+  }
+
+  // NOTE: 顶层多余的 `}` 既不能开始语句，也会让同步原地停下；
+  //       此时跳过它，保证每轮循环至少前进一个 Token。
+  if (current == start) {
+    advance();
+  }
+  if (stmt) {
+    attach_comments(stmt.get(), CommentPlacement::Leading,
+                    pending_top_level_comments);
+  }
+  return stmt;
+}
 
-    auto stmt = declaration();
-    if (stmt) {
-      program->add_child(std::move(stmt));
+void Parser::trailing_comment(CSTNode& node) {
+  if (!check(TokenType::Comment)) {
+    return;
+  }
+  const Token& comment_token = advance();
+  if (comment_table != nullptr) {
+    comment_table->attach(&node, CommentPlacement::Trailing, comment_token);
+  } else {
+    node.add_child(make_cst_node(CSTNodeType::Comment, comment_token));
+  }
+}
+
+void Parser::collect_comments(CSTNode& container, std::vector<Token>& pending) {
+  while (check(TokenType::Comment)) {
+    const Token& comment_token = advance();
+    if (comment_table != nullptr) {
+      pending.push_back(comment_token);
     } else {
-      // --- 增强的错误恢复 ---
-      // 当声明解析失败时，使用专门的同步方法恢复到下一个语句开始
-      synchronize_to_statement_start();
+      container.add_child(make_cst_node(CSTNodeType::Comment, comment_token));
     }
   }
+}
 
-  return program;
+void Parser::attach_comments(const CSTNode* anchor, CommentPlacement placement,
+                             std::vector<Token>& pending) {
+  if (comment_table == nullptr) {
+    return;
+  }
+  for (const auto& comment : pending) {
+    comment_table->attach(anchor, placement, comment);
+  }
+  pending.clear();
 }
 
 std::unique_ptr<CSTNode>
@@ -197,7 +414,7 @@ Parser::parse_array_suffix(std::unique_ptr<CSTNode> base_type) {
   // NOTE: 此函数处理类型表达式后的数组声明符，支持多维数组。
   //       通过循环包装 base_type，直到没有更多左方括号为止。
   while (check(TokenType::LeftBracket)) {
-    Token left_bracket = advance();
+    const Token& left_bracket = advance();
 
     if (check(TokenType::Integer)) {
       // 固定大小数组 T[N]
@@ -208,7 +425,7 @@ Parser::parse_array_suffix(std::unique_ptr<CSTNode> base_type) {
       auto lbracket_node = make_cst_node(CSTNodeType::Delimiter, left_bracket);
       sized_array->add_child(std::move(lbracket_node));
 
-      Token size_token = advance();
+      const Token& size_token = advance();
       auto size_node = make_cst_node(CSTNodeType::IntegerLiteral, size_token);
       sized_array->add_child(std::move(size_node));
 
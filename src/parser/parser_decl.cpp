@@ -5,6 +5,7 @@
  * @date 2025-11-13
  */
 
+#include "czc/cst/comment_table.hpp"
 #include "czc/diagnostics/diagnostic_code.hpp"
 #include "czc/parser/parser.hpp"
 
@@ -19,6 +20,11 @@ using namespace czc::lexer;
 using namespace czc::utils;
 
 std::unique_ptr<CSTNode> Parser::declaration() {
+  NestingGuard guard(*this);
+  if (guard.exceeded()) {
+    return nullptr;
+  }
+
   if (match_token({TokenType::Let, TokenType::Var})) {
     return var_declaration();
   } else if (match_token({TokenType::Fn})) {
@@ -39,7 +45,7 @@ std::unique_ptr<CSTNode> Parser::var_declaration() {
   //       `let` 或 `var` 关键字，但我们通过 `tokens[current - 1]`
   //       回溯一个位置来获取它，并将其作为一个 `Delimiter` 类型的子节点
   //       添加到 CST 中。
-  Token keyword_token = tokens[current - 1];
+  const Token& keyword_token = tokens[current - 1];
   auto keyword_node = make_cst_node(CSTNodeType::Delimiter, keyword_token);
   node->add_child(std::move(keyword_node));
 
@@ -56,7 +62,7 @@ std::unique_ptr<CSTNode> Parser::var_declaration() {
   // 解析可选的类型注解
   if (match_token({TokenType::Colon})) {
     // 保留冒号
-    Token colon = tokens[current - 1];
+    const Token& colon = tokens[current - 1];
     auto colon_node = make_cst_node(CSTNodeType::Delimiter, colon);
     node->add_child(std::move(colon_node));
 
@@ -74,7 +80,7 @@ std::unique_ptr<CSTNode> Parser::var_declaration() {
   // 解析可选的初始化表达式
   if (match_token({TokenType::Equal})) {
     // 保留等号
-    Token equal = tokens[current - 1];
+    const Token& equal = tokens[current - 1];
     auto equal_node = make_cst_node(CSTNodeType::Operator, equal);
     node->add_child(std::move(equal_node));
 
@@ -97,11 +103,7 @@ std::unique_ptr<CSTNode> Parser::var_declaration() {
   }
 
   // 检查是否有行内注释
-  if (check(TokenType::Comment)) {
-    auto comment_token = advance();
-    auto comment_node = make_cst_node(CSTNodeType::Comment, comment_token);
-    node->add_child(std::move(comment_node));
-  }
+  trailing_comment(*node);
 
   return node;
 }
@@ -110,7 +112,7 @@ std::unique_ptr<CSTNode> Parser::fn_declaration() {
   auto node = make_cst_node(CSTNodeType::FnDeclaration, make_location());
 
   // fn 关键字
-  Token fn_keyword = tokens[current - 1];
+  const Token& fn_keyword = tokens[current - 1];
   auto fn_node = make_cst_node(CSTNodeType::Delimiter, fn_keyword);
   node->add_child(std::move(fn_node));
 
@@ -164,7 +166,7 @@ std::unique_ptr<CSTNode> Parser::fn_declaration() {
 
       // 解析可选的类型注解
       if (match_token({TokenType::Colon})) {
-        Token colon = tokens[current - 1];
+        const Token& colon = tokens[current - 1];
         auto colon_node = make_cst_node(CSTNodeType::Delimiter, colon);
         param_node->add_child(std::move(colon_node));
 
@@ -179,7 +181,7 @@ std::unique_ptr<CSTNode> Parser::fn_declaration() {
 
       // 检查是否有逗号
       if (match_token({TokenType::Comma})) {
-        Token comma = tokens[current - 1];
+        const Token& comma = tokens[current - 1];
         auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
         param_list->add_child(std::move(comma_node));
       } else {
@@ -199,7 +201,7 @@ std::unique_ptr<CSTNode> Parser::fn_declaration() {
 
   // 解析可选的返回类型
   if (match_token({TokenType::Arrow})) {
-    Token arrow = tokens[current - 1];
+    const Token& arrow = tokens[current - 1];
     auto arrow_node = make_cst_node(CSTNodeType::Delimiter, arrow);
     node->add_child(std::move(arrow_node));
 
@@ -211,6 +213,12 @@ std::unique_ptr<CSTNode> Parser::fn_declaration() {
   }
 
   // 解析函数体
+  if (defer_bodies && check(TokenType::LeftBrace)) {
+    if (auto placeholder = deferred_body(node.get())) {
+      node->add_child(std::move(placeholder));
+      return node;
+    }
+  }
   auto body = block_statement();
   if (body) {
     node->add_child(std::move(body));
@@ -222,11 +230,45 @@ std::unique_ptr<CSTNode> Parser::fn_declaration() {
   return node;
 }
 
+std::unique_ptr<CSTNode> Parser::parse_function_body() {
+  // NOTE: 函数声明本身在 `declaration` 中占一层嵌套。
+  NestingGuard guard(*this);
+  if (guard.exceeded()) {
+    return nullptr;
+  }
+  return block_statement();
+}
+
+std::unique_ptr<CSTNode> Parser::deferred_body(CSTNode* function) {
+  const BracketTable* table = get_bracket_table();
+  if (table == nullptr) {
+    return nullptr;
+  }
+  size_t first = current;
+  uint32_t close = table->get_match(first);
+  if (close == BracketTable::NONE) {
+    return nullptr;
+  }
+
+  // NOTE: 与空函数体的结构相同：`{`、空的语句列表、`}`。
+  //       位置也与 `block_statement` 给出的相同，签名部分因此与全量解析
+  //       的结果一致。
+  auto node = make_cst_node(CSTNodeType::BlockStmt, make_location());
+  node->add_child(make_cst_node(CSTNodeType::Delimiter, advance()));
+  node->add_child(make_cst_node(CSTNodeType::StatementList, make_location()));
+  tokens.skip_to(close);
+  current = close;
+  node->add_child(make_cst_node(CSTNodeType::Delimiter, advance()));
+
+  deferred_bodies.push_back({function, node.get(), first, current});
+  return node;
+}
+
 std::unique_ptr<CSTNode> Parser::parse_type() {
   std::unique_ptr<CSTNode> base_type = nullptr;
 
   // --- 基础类型解析 ---
-  Token token = current_token();
+  const Token& token = current_token();
   if (token.token_type == TokenType::Identifier) {
     advance();
     base_type = make_cst_node(CSTNodeType::TypeAnnotation, token);
@@ -247,7 +289,7 @@ std::unique_ptr<CSTNode> Parser::struct_declaration() {
   auto node = make_cst_node(CSTNodeType::StructDeclaration, make_location());
 
   // struct 关键字
-  Token struct_keyword = tokens[current - 1];
+  const Token& struct_keyword = tokens[current - 1];
   auto struct_node = make_cst_node(CSTNodeType::Delimiter, struct_keyword);
   node->add_child(std::move(struct_node));
 
@@ -280,15 +322,13 @@ std::unique_ptr<CSTNode> Parser::struct_declaration() {
   // 解析字段列表
   // NOTE: 使用 unordered_set 提供 O(1) 平均查找时间，避免 O(n²) 复杂度。
   std::unordered_set<std::string> field_names; // 用于检测重复字段名
+  // 设置了注释表时尚未附着的独立注释
+  std::vector<Token> leading_comments;
 
   if (!check(TokenType::RightBrace)) {
     do {
       // 跳过注释
-      while (check(TokenType::Comment)) {
-        auto comment_token = advance();
-        auto comment_node = make_cst_node(CSTNodeType::Comment, comment_token);
-        node->add_child(std::move(comment_node));
-      }
+      collect_comments(*node, leading_comments);
 
       if (check(TokenType::RightBrace))
         break;
@@ -368,11 +408,13 @@ std::unique_ptr<CSTNode> Parser::struct_declaration() {
       }
       field_node->add_child(std::move(type_node));
 
+      attach_comments(field_node.get(), CommentPlacement::Leading,
+                      leading_comments);
       node->add_child(std::move(field_node));
 
       // 检查逗号或右花括号
       if (match_token({TokenType::Comma})) {
-        Token comma = tokens[current - 1];
+        const Token& comma = tokens[current - 1];
         auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
         node->add_child(std::move(comma_node));
         // 允许尾随逗号
@@ -390,6 +432,7 @@ std::unique_ptr<CSTNode> Parser::struct_declaration() {
       }
     } while (true);
   }
+  attach_comments(node.get(), CommentPlacement::Dangling, leading_comments);
 
   // 消费右花括号
   auto right_brace = consume(TokenType::RightBrace);
@@ -401,7 +444,7 @@ std::unique_ptr<CSTNode> Parser::struct_declaration() {
   // 消费可选的分号（为了与现代语言习惯保持一致）
   // NOTE: 分号现在是可选的，但如果存在则会被保留在 CST 中用于格式化。
   if (check(TokenType::Semicolon)) {
-    Token semicolon = advance();
+    const Token& semicolon = advance();
     auto semicolon_node = make_cst_node(CSTNodeType::Delimiter, semicolon);
     node->add_child(std::move(semicolon_node));
   }
@@ -413,7 +456,7 @@ std::unique_ptr<CSTNode> Parser::type_alias_declaration() {
   auto node = make_cst_node(CSTNodeType::TypeAliasDeclaration, make_location());
 
   // type 关键字
-  Token type_keyword = tokens[current - 1];
+  const Token& type_keyword = tokens[current - 1];
   auto type_node = make_cst_node(CSTNodeType::Delimiter, type_keyword);
   node->add_child(std::move(type_node));
 
@@ -5,10 +5,13 @@
  * @date 2025-11-13
  */
 
+#include "czc/cst/comment_table.hpp"
 #include "czc/diagnostics/diagnostic_code.hpp"
 #include "czc/parser/parser.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <unordered_set>
 
 namespace czc::parser {
@@ -18,21 +21,65 @@ using namespace czc::diagnostics;
 using namespace czc::lexer;
 using namespace czc::utils;
 
+// --- 二元运算符优先级表 ---
+
+namespace {
+
+// NOTE: 优先级从 1 开始递增，0 表示不是二元运算符。所有二元运算符都是
+//       左结合的；赋值是唯一的右结合运算符，由 `assignment` 单独处理。
+constexpr uint8_t NOT_BINARY = 0;
+constexpr uint8_t PREC_LOWEST = 1;
+
+constexpr std::array<uint8_t, 256> make_binary_precedence_table() {
+  std::array<uint8_t, 256> table{};
+  auto set = [&table](TokenType type, uint8_t precedence) {
+    table[static_cast<uint8_t>(type)] = precedence;
+  };
+  set(TokenType::OrOr, 1);
+  set(TokenType::AndAnd, 2);
+  set(TokenType::EqualEqual, 3);
+  set(TokenType::BangEqual, 3);
+  set(TokenType::Greater, 4);
+  set(TokenType::GreaterEqual, 4);
+  set(TokenType::Less, 4);
+  set(TokenType::LessEqual, 4);
+  set(TokenType::Plus, 5);
+  set(TokenType::Minus, 5);
+  set(TokenType::Star, 6);
+  set(TokenType::Slash, 6);
+  set(TokenType::Percent, 6);
+  return table;
+}
+
+constexpr std::array<uint8_t, 256> BINARY_PRECEDENCE =
+    make_binary_precedence_table();
+
+inline uint8_t binary_precedence(TokenType type) {
+  return BINARY_PRECEDENCE[static_cast<uint8_t>(type)];
+}
+
+} // namespace
+
 // --- 表达式解析的入口 ---
-// NOTE: 表达式的解析遵循操作符优先级规则。这是通过一系列函数的链式调用
-//       来实现的，每个函数负责处理一个特定优先级的操作符。调用链从最低
-//       优先级的 `assignment` 开始，逐级向下，直到最高优先级的 `primary`。
-//       例如，`term`（加减）会调用 `factor`（乘除），确保了乘除法
-//       会先于加减法被组合成子树。
+// NOTE: 赋值之下的所有二元运算都由 `binary_expression` 按优先级表解析，
+//       叶子表达式只经过 assignment → binary_expression → unary → call →
+//       primary 这一条固定的调用链，而不是为每个优先级层次各调用一次。
 std::unique_ptr<CSTNode> Parser::expression() {
   return assignment();
 }
 
 std::unique_ptr<CSTNode> Parser::assignment() {
-  auto expr = logical_or();
+  // NOTE: 所有嵌套的子表达式（括号、数组元素、调用参数、索引）以及
+  //       右结合的赋值链都会经过这里，每经过一次计为一层嵌套。
+  NestingGuard guard(*this);
+  if (guard.exceeded()) {
+    return nullptr;
+  }
+
+  auto expr = binary_expression(PREC_LOWEST);
 
   if (match_token({TokenType::Equal})) {
-    Token equal = tokens[current - 1];
+    const Token& equal = tokens[current - 1];
 
     // NOTE: 赋值操作符是右结合的。例如 `a = b = c` 被解析为 `a = (b = c)`。
     //       这是通过在 `assignment` 函数中递归调用 `assignment()` 来解析
@@ -84,137 +131,26 @@ std::unique_ptr<CSTNode> Parser::assignment() {
   return expr;
 }
 
-std::unique_ptr<CSTNode> Parser::logical_or() {
-  auto expr = logical_and();
-
-  // NOTE: 这是一个典型的左结合二元操作符的解析循环。
-  //       1. 首先解析一个更高优先级的表达式（`logical_and`）作为左操作数
-  //       `expr`。
-  //       2. 然后进入一个 `while` 循环，检查当前 Token
-  //       是否是本级别的操作符（`||`）。
-  //       3.
-  //       如果是，就消耗掉操作符，并解析另一个更高优先级的表达式作为右操作数。
-  //       4. 将左操作数、操作符和右操作数组合成一个新的 `BinaryExpr` 节点。
-  //       5. 将这个新节点赋值给 `expr`，使其成为下一次循环的左操作数。
-  //       这个过程确保了 `a || b || c` 被解析为 `(a || b) || c`。
-  while (match_token({TokenType::OrOr})) {
-    Token op = tokens[current - 1];
-    auto binary_node = make_cst_node(CSTNodeType::BinaryExpr, make_location());
-
-    binary_node->add_child(std::move(expr));
-
-    auto op_node = make_cst_node(CSTNodeType::Operator, op);
-    binary_node->add_child(std::move(op_node));
-
-    auto right = logical_and();
-    if (right) {
-      binary_node->add_child(std::move(right));
-    }
-
-    expr = std::move(binary_node);
-  }
-
-  return expr;
-}
-
-std::unique_ptr<CSTNode> Parser::logical_and() {
-  auto expr = equality();
-
-  while (match_token({TokenType::AndAnd})) {
-    Token op = tokens[current - 1];
-    auto binary_node = make_cst_node(CSTNodeType::BinaryExpr, make_location());
-
-    binary_node->add_child(std::move(expr));
-
-    auto op_node = make_cst_node(CSTNodeType::Operator, op);
-    binary_node->add_child(std::move(op_node));
-
-    auto right = equality();
-    if (right) {
-      binary_node->add_child(std::move(right));
-    }
-
-    expr = std::move(binary_node);
-  }
-
-  return expr;
-}
-
-std::unique_ptr<CSTNode> Parser::equality() {
-  auto expr = comparison();
-
-  while (match_token({TokenType::EqualEqual, TokenType::BangEqual})) {
-    Token op = tokens[current - 1];
-    auto binary_node = make_cst_node(CSTNodeType::BinaryExpr, make_location());
-
-    binary_node->add_child(std::move(expr));
-
-    auto op_node = make_cst_node(CSTNodeType::Operator, op);
-    binary_node->add_child(std::move(op_node));
-
-    auto right = comparison();
-    if (right) {
-      binary_node->add_child(std::move(right));
-    }
-
-    expr = std::move(binary_node);
-  }
-
-  return expr;
-}
-
-std::unique_ptr<CSTNode> Parser::comparison() {
-  auto expr = term();
-
-  while (match_token({TokenType::Greater, TokenType::GreaterEqual,
-                      TokenType::Less, TokenType::LessEqual})) {
-    Token op = tokens[current - 1];
-    auto binary_node = make_cst_node(CSTNodeType::BinaryExpr, make_location());
-
-    binary_node->add_child(std::move(expr));
-
-    auto op_node = make_cst_node(CSTNodeType::Operator, op);
-    binary_node->add_child(std::move(op_node));
-
-    auto right = term();
-    if (right) {
-      binary_node->add_child(std::move(right));
-    }
-
-    expr = std::move(binary_node);
-  }
-
-  return expr;
-}
-
-std::unique_ptr<CSTNode> Parser::term() {
-  auto expr = factor();
-
-  while (match_token({TokenType::Plus, TokenType::Minus})) {
-    Token op = tokens[current - 1];
-    auto binary_node = make_cst_node(CSTNodeType::BinaryExpr, make_location());
-
-    binary_node->add_child(std::move(expr));
-
-    auto op_node = make_cst_node(CSTNodeType::Operator, op);
-    binary_node->add_child(std::move(op_node));
+std::unique_ptr<CSTNode> Parser::binary_expression(uint8_t min_precedence) {
+  auto expr = unary();
 
-    auto right = factor();
-    if (right) {
-      binary_node->add_child(std::move(right));
+  // NOTE: 这是优先级爬升的核心循环。
+  //       1. 先解析一个一元表达式作为左操作数 `expr`。
+  //       2. 只要当前 Token 是优先级不低于 `min_precedence` 的二元运算符，
+  //          就消费它，并以 `precedence + 1` 为下限解析右操作数：更高优先级
+  //          的运算符会在右侧递归中结合，同级运算符留给本层循环，
+  //          从而实现左结合。例如 `a - b - c` 被解析为 `(a - b) - c`，
+  //          `a + b * c` 被解析为 `a + (b * c)`。
+  //       3. 将左操作数、运算符和右操作数组合成新的 `BinaryExpr`，
+  //          作为下一轮循环的左操作数。
+  //       这与逐级递归下降（每个优先级一个函数）生成的树完全相同。
+  while (true) {
+    uint8_t precedence = binary_precedence(current_token().token_type);
+    if (precedence == NOT_BINARY || precedence < min_precedence) {
+      break;
     }
 
-    expr = std::move(binary_node);
-  }
-
-  return expr;
-}
-
-std::unique_ptr<CSTNode> Parser::factor() {
-  auto expr = unary();
-
-  while (match_token({TokenType::Star, TokenType::Slash, TokenType::Percent})) {
-    Token op = tokens[current - 1];
+    const Token& op = advance();
     auto binary_node = make_cst_node(CSTNodeType::BinaryExpr, make_location());
 
     binary_node->add_child(std::move(expr));
@@ -222,7 +158,7 @@ std::unique_ptr<CSTNode> Parser::factor() {
     auto op_node = make_cst_node(CSTNodeType::Operator, op);
     binary_node->add_child(std::move(op_node));
 
-    auto right = unary();
+    auto right = binary_expression(static_cast<uint8_t>(precedence + 1));
     if (right) {
       binary_node->add_child(std::move(right));
     }
@@ -235,15 +171,19 @@ std::unique_ptr<CSTNode> Parser::factor() {
 
 std::unique_ptr<CSTNode> Parser::unary() {
   if (match_token({TokenType::Bang, TokenType::Minus})) {
-    Token op = tokens[current - 1];
+    const Token& op = tokens[current - 1];
     auto unary_node = make_cst_node(CSTNodeType::UnaryExpr, make_location());
 
     auto op_node = make_cst_node(CSTNodeType::Operator, op);
     unary_node->add_child(std::move(op_node));
 
-    auto operand = unary();
-    if (operand) {
-      unary_node->add_child(std::move(operand));
+    // 连续的前缀运算符同样逐层递归，计入嵌套深度。
+    NestingGuard guard(*this);
+    if (!guard.exceeded()) {
+      auto operand = unary();
+      if (operand) {
+        unary_node->add_child(std::move(operand));
+      }
     }
 
     return unary_node;
@@ -258,7 +198,7 @@ std::unique_ptr<CSTNode> Parser::call() {
   while (true) {
     if (match_token({TokenType::LeftParen})) {
       // 函数调用
-      Token left_paren = tokens[current - 1];
+      const Token& left_paren = tokens[current - 1];
       auto call_node = make_cst_node(CSTNodeType::CallExpr, make_location());
 
       call_node->add_child(std::move(expr));
@@ -276,7 +216,7 @@ std::unique_ptr<CSTNode> Parser::call() {
           }
 
           if (match_token({TokenType::Comma})) {
-            Token comma = tokens[current - 1];
+            const Token& comma = tokens[current - 1];
             auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
             arg_list->add_child(std::move(comma_node));
           } else {
@@ -295,7 +235,7 @@ std::unique_ptr<CSTNode> Parser::call() {
       expr = std::move(call_node);
     } else if (match_token({TokenType::LeftBracket})) {
       // 索引访问
-      Token left_bracket = tokens[current - 1];
+      const Token& left_bracket = tokens[current - 1];
       auto index_node = make_cst_node(CSTNodeType::IndexExpr, make_location());
 
       index_node->add_child(std::move(expr));
@@ -318,7 +258,7 @@ std::unique_ptr<CSTNode> Parser::call() {
       expr = std::move(index_node);
     } else if (match_token({TokenType::Dot})) {
       // 成员访问
-      Token dot = tokens[current - 1];
+      const Token& dot = tokens[current - 1];
       auto member_node =
           make_cst_node(CSTNodeType::MemberExpr, make_location());
 
@@ -352,7 +292,7 @@ std::unique_ptr<CSTNode> Parser::call() {
         is_struct_literal = true;
       } else if (check(TokenType::Identifier)) {
         // 前瞻检查下一个 token 是否是冒号
-        Token next = peek(1);
+        const Token& next = peek(1);
         if (next.token_type == TokenType::Colon) {
           is_struct_literal = true;
         }
@@ -365,7 +305,7 @@ std::unique_ptr<CSTNode> Parser::call() {
       }
 
       // 确认是结构体字面量
-      Token left_brace = tokens[current - 1];
+      const Token& left_brace = tokens[current - 1];
       auto struct_lit_node =
           make_cst_node(CSTNodeType::StructLiteral, make_location());
 
@@ -375,15 +315,12 @@ std::unique_ptr<CSTNode> Parser::call() {
       struct_lit_node->add_child(std::move(lbrace_node));
 
       // 解析字段初始化列表
+      // 设置了注释表时尚未附着的独立注释
+      std::vector<Token> leading_comments;
       if (!check(TokenType::RightBrace)) {
         do {
           // 跳过注释
-          while (check(TokenType::Comment)) {
-            auto comment_token = advance();
-            auto comment_node =
-                make_cst_node(CSTNodeType::Comment, comment_token);
-            struct_lit_node->add_child(std::move(comment_node));
-          }
+          collect_comments(*struct_lit_node, leading_comments);
 
           if (check(TokenType::RightBrace))
             break;
@@ -409,6 +346,8 @@ std::unique_ptr<CSTNode> Parser::call() {
 
           auto field_name_node =
               make_cst_node(CSTNodeType::Identifier, *field_name);
+          attach_comments(field_name_node.get(), CommentPlacement::Leading,
+                          leading_comments);
           struct_lit_node->add_child(std::move(field_name_node));
 
           // 解析冒号
@@ -446,7 +385,7 @@ std::unique_ptr<CSTNode> Parser::call() {
 
           // 检查逗号
           if (match_token({TokenType::Comma})) {
-            Token comma = tokens[current - 1];
+            const Token& comma = tokens[current - 1];
             auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
             struct_lit_node->add_child(std::move(comma_node));
             // 允许尾随逗号
@@ -465,6 +404,8 @@ std::unique_ptr<CSTNode> Parser::call() {
           }
         } while (true);
       }
+      attach_comments(struct_lit_node.get(), CommentPlacement::Dangling,
+                      leading_comments);
 
       auto right_brace = consume(TokenType::RightBrace);
       if (right_brace) {
@@ -484,35 +425,35 @@ std::unique_ptr<CSTNode> Parser::call() {
 std::unique_ptr<CSTNode> Parser::primary() {
   // 布尔字面量
   if (match_token({TokenType::True, TokenType::False})) {
-    Token token = tokens[current - 1];
+    const Token& token = tokens[current - 1];
     auto node = make_cst_node(CSTNodeType::BooleanLiteral, token);
     return node;
   }
 
   // 整数字面量
   if (match_token({TokenType::Integer})) {
-    Token token = tokens[current - 1];
+    const Token& token = tokens[current - 1];
     auto node = make_cst_node(CSTNodeType::IntegerLiteral, token);
     return node;
   }
 
   // 浮点数字面量
   if (match_token({TokenType::Float})) {
-    Token token = tokens[current - 1];
+    const Token& token = tokens[current - 1];
     auto node = make_cst_node(CSTNodeType::FloatLiteral, token);
     return node;
   }
 
   // 字符串字面量
   if (match_token({TokenType::String})) {
-    Token token = tokens[current - 1];
+    const Token& token = tokens[current - 1];
     auto node = make_cst_node(CSTNodeType::StringLiteral, token);
     return node;
   }
 
   // 函数字面量: fn (params) { body }
   if (match_token({TokenType::Fn})) {
-    Token fn_token = tokens[current - 1];
+    const Token& fn_token = tokens[current - 1];
     auto func_lit_node =
         make_cst_node(CSTNodeType::FunctionLiteral, make_location());
 
@@ -543,7 +484,7 @@ std::unique_ptr<CSTNode> Parser::primary() {
 
         // 解析可选的类型注解
         if (match_token({TokenType::Colon})) {
-          Token colon = tokens[current - 1];
+          const Token& colon = tokens[current - 1];
           auto colon_node = make_cst_node(CSTNodeType::Delimiter, colon);
           param_node->add_child(std::move(colon_node));
 
@@ -557,7 +498,7 @@ std::unique_ptr<CSTNode> Parser::primary() {
         param_list->add_child(std::move(param_node));
 
         if (match_token({TokenType::Comma})) {
-          Token comma = tokens[current - 1];
+          const Token& comma = tokens[current - 1];
           auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
           param_list->add_child(std::move(comma_node));
         } else {
@@ -585,13 +526,15 @@ std::unique_ptr<CSTNode> Parser::primary() {
 
   // 标识符
   if (match_token({TokenType::Identifier})) {
-    Token token = tokens[current - 1];
+    const Token& token = tokens[current - 1];
     auto node = make_cst_node(CSTNodeType::Identifier, token);
     return node;
   }
 
   // 括号表达式或元组字面量
   if (match_token({TokenType::LeftParen})) {
+    // NOTE: 左括号要在解析完第一个表达式后才能挂到节点上，期间可能拉取
+    //       任意多个 Token，因此这里必须拷贝而不能引用缓冲区。
     Token left_paren = tokens[current - 1];
 
     // 先尝试解析第一个表达式
@@ -612,7 +555,7 @@ std::unique_ptr<CSTNode> Parser::primary() {
 
       // 解析剩余元素
       while (match_token({TokenType::Comma})) {
-        Token comma = tokens[current - 1];
+        const Token& comma = tokens[current - 1];
         auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
         tuple_node->add_child(std::move(comma_node));
 
@@ -659,7 +602,7 @@ std::unique_ptr<CSTNode> Parser::primary() {
 
   // 数组字面量
   if (match_token({TokenType::LeftBracket})) {
-    Token left_bracket = tokens[current - 1];
+    const Token& left_bracket = tokens[current - 1];
     auto array_node = make_cst_node(CSTNodeType::ArrayLiteral, make_location());
 
     auto lbracket_node = make_cst_node(CSTNodeType::Delimiter, left_bracket);
@@ -673,7 +616,7 @@ std::unique_ptr<CSTNode> Parser::primary() {
         }
 
         if (match_token({TokenType::Comma})) {
-          Token comma = tokens[current - 1];
+          const Token& comma = tokens[current - 1];
           auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
           array_node->add_child(std::move(comma_node));
 
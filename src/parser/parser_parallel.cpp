@@ -0,0 +1,195 @@
+/**
+ * @file parser_parallel.cpp
+ * @brief 按顶层声明并行解析的实现。
+ * @details
+ *   先在 Token 序列上跟踪括号深度，选出顶层声明的起点作为切分点；
+ *   各块随后在线程池上由独立的 Parser 解析，最后按顺序把子树挂到同一个
+ *   `Program` 节点下并合并错误。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/parser/parser.hpp"
+#include "czc/utils/source_manager.hpp"
+#include "czc/utils/thread_pool.hpp"
+
+#include <future>
+
+namespace czc::parser {
+
+using namespace czc::cst;
+using namespace czc::lexer;
+
+namespace {
+
+/**
+ * @brief 单个分块的解析结果。
+ */
+struct ChunkResult {
+  std::unique_ptr<CSTNode> program;
+  std::vector<ParserError> errors;
+};
+
+inline bool is_declaration_start(TokenType type) {
+  return type == TokenType::Fn || type == TokenType::Struct ||
+         type == TokenType::Type || type == TokenType::Let ||
+         type == TokenType::Var;
+}
+
+/**
+ * @brief 扫描 Token 序列，选出最多 `chunk_count - 1` 个顶层声明起点。
+ * @details
+ *   切分点必须位于括号深度 0，且前一个非注释 Token 是 `;` 或 `}`：
+ *   这排除了 `let f = fn () {...}` 这类出现在表达式中的 `fn`。
+ *   遇到多余的右括号时说明输入本身有误，此时不切分。
+ * @return 各块起始 Token 的下标，第一个元素总是 0。
+ */
+std::vector<size_t> find_declaration_boundaries(const std::vector<Token>& tokens,
+                                                size_t chunk_count) {
+  std::vector<size_t> boundaries;
+  boundaries.reserve(chunk_count);
+  boundaries.push_back(0);
+
+  size_t step = tokens.size() / chunk_count;
+  size_t next_target = step;
+  size_t depth = 0;
+  bool after_terminator = false;
+
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    TokenType type = tokens[i].token_type;
+
+    if (depth == 0 && after_terminator && i >= next_target &&
+        is_declaration_start(type) && boundaries.size() < chunk_count) {
+      boundaries.push_back(i);
+      while (next_target <= i) {
+        next_target += step;
+      }
+    }
+
+    switch (type) {
+    case TokenType::LeftBrace:
+    case TokenType::LeftParen:
+    case TokenType::LeftBracket:
+      ++depth;
+      break;
+    case TokenType::RightBrace:
+    case TokenType::RightParen:
+    case TokenType::RightBracket:
+      if (depth == 0) {
+        return {0};
+      }
+      --depth;
+      break;
+    default:
+      break;
+    }
+
+    if (type != TokenType::Comment) {
+      after_terminator =
+          type == TokenType::Semicolon || type == TokenType::RightBrace;
+    }
+  }
+
+  return boundaries;
+}
+
+} // namespace
+
+std::unique_ptr<CSTNode> Parser::parse_parallel(utils::ThreadPool& pool,
+                                                size_t min_chunk_tokens) {
+  const std::vector<Token>* all = tokens.get_source().get_materialized_tokens();
+  // NOTE: 只能在尚未开始解析时切分，且需要随机访问完整的 Token 序列。
+  if (all == nullptr || current != 0) {
+    return parse();
+  }
+
+  if (min_chunk_tokens == 0) {
+    min_chunk_tokens = 1;
+  }
+  size_t chunk_count = pool.size();
+  if (all->size() / min_chunk_tokens < chunk_count) {
+    chunk_count = all->size() / min_chunk_tokens;
+  }
+  if (chunk_count < 2) {
+    return parse();
+  }
+
+  std::vector<size_t> boundaries =
+      find_declaration_boundaries(*all, chunk_count);
+  if (boundaries.size() < 2) {
+    return parse();
+  }
+
+  std::string filename(utils::SourceManager::instance().get_filename(file_id));
+  // 以与本 Parser 相同的设置解析 `[begin, end)`。
+  auto parse_range = [this, all, &filename](size_t begin, size_t end) {
+    Parser parser(std::make_unique<VectorTokenSource>(*all, begin, end),
+                  filename);
+    parser.set_arena_enabled(arena_enabled);
+    parser.set_max_depth(max_depth);
+    parser.set_structural_hash_enabled(structural_hash_enabled);
+    ChunkResult result;
+    result.program = parser.parse();
+    result.errors = parser.get_errors();
+    return result;
+  };
+
+  // --- 并行解析各分块 ---
+  std::vector<std::future<ChunkResult>> futures;
+  futures.reserve(boundaries.size());
+  for (size_t i = 0; i < boundaries.size(); ++i) {
+    size_t begin = boundaries[i];
+    size_t end = i + 1 < boundaries.size() ? boundaries[i + 1] : all->size();
+    futures.push_back(pool.submit(
+        [&parse_range, begin, end]() { return parse_range(begin, end); }));
+  }
+
+  std::vector<ChunkResult> chunks;
+  chunks.reserve(futures.size());
+  for (auto& future : futures) {
+    chunks.push_back(future.get());
+  }
+
+  // --- 从第一个出错的块开始串行重新解析 ---
+  // NOTE: 前面的块都无错时，串行解析必然完整消费了它们并回到顶层，
+  //       因此出错块的起点仍是可靠的切分点；之后的切分点则不一定。
+  for (size_t i = 0; i + 1 < chunks.size(); ++i) {
+    if (!chunks[i].errors.empty()) {
+      chunks.resize(i);
+      chunks.push_back(parse_range(boundaries[i], all->size()));
+      break;
+    }
+  }
+
+  // --- 按顺序拼接子树并合并错误 ---
+  std::unique_ptr<CSTNode> program;
+  CSTArenaRoot* arena_root = nullptr;
+  if (arena_enabled) {
+    auto root =
+        std::make_unique<CSTArenaRoot>(CSTNodeType::Program, make_location());
+    arena_root = root.get();
+    program = std::move(root);
+  } else {
+    program = make_cst_node(CSTNodeType::Program, make_location());
+  }
+
+  for (auto& chunk : chunks) {
+    if (arena_root != nullptr) {
+      arena_root->adopt_children(static_cast<CSTArenaRoot&>(*chunk.program));
+    } else {
+      for (auto& child : chunk.program->take_children()) {
+        program->add_child(std::move(child));
+      }
+    }
+    for (auto& error : chunk.errors) {
+      error_collector.add(error);
+    }
+  }
+
+  if (structural_hash_enabled) {
+    compute_structural_hash(program.get());
+  }
+  return program;
+}
+
+} // namespace czc::parser
@@ -5,6 +5,7 @@
  * @date 2025-11-13
  */
 
+#include "czc/cst/comment_table.hpp"
 #include "czc/diagnostics/diagnostic_code.hpp"
 #include "czc/parser/parser.hpp"
 
@@ -36,7 +37,7 @@ std::unique_ptr<CSTNode> Parser::return_statement() {
   auto node = make_cst_node(CSTNodeType::ReturnStmt, make_location());
 
   // 保留 return 关键字
-  Token return_keyword = tokens[current - 1];
+  const Token& return_keyword = tokens[current - 1];
   auto return_node = make_cst_node(CSTNodeType::Delimiter, return_keyword);
   node->add_child(std::move(return_node));
 
@@ -62,7 +63,7 @@ std::unique_ptr<CSTNode> Parser::if_statement() {
   auto node = make_cst_node(CSTNodeType::IfStmt, make_location());
 
   // 保留 if 关键字
-  Token if_keyword = tokens[current - 1];
+  const Token& if_keyword = tokens[current - 1];
   auto if_node = make_cst_node(CSTNodeType::Delimiter, if_keyword);
   node->add_child(std::move(if_node));
 
@@ -80,7 +81,7 @@ std::unique_ptr<CSTNode> Parser::if_statement() {
 
   // 解析可选的 else 或 else if 分支
   if (match_token({TokenType::Else})) {
-    Token else_keyword = tokens[current - 1];
+    const Token& else_keyword = tokens[current - 1];
     auto else_node = make_cst_node(CSTNodeType::Delimiter, else_keyword);
     node->add_child(std::move(else_node));
 
@@ -106,7 +107,7 @@ std::unique_ptr<CSTNode> Parser::if_statement() {
 std::unique_ptr<CSTNode> Parser::while_statement() {
   auto node = make_cst_node(CSTNodeType::WhileStmt, make_location());
 
-  Token while_keyword = tokens[current - 1];
+  const Token& while_keyword = tokens[current - 1];
   auto while_node = make_cst_node(CSTNodeType::Delimiter, while_keyword);
   node->add_child(std::move(while_node));
 
@@ -126,7 +127,8 @@ std::unique_ptr<CSTNode> Parser::while_statement() {
 std::unique_ptr<CSTNode> Parser::block_statement() {
   auto node = make_cst_node(CSTNodeType::BlockStmt, make_location());
 
-  if (tokens[current - 1].token_type != TokenType::LeftBrace) {
+  if (current == 0 ||
+      tokens[current - 1].token_type != TokenType::LeftBrace) {
     auto left_brace = consume(TokenType::LeftBrace);
     if (left_brace) {
       auto lbrace_node = make_cst_node(CSTNodeType::Delimiter, *left_brace);
@@ -140,23 +142,25 @@ std::unique_ptr<CSTNode> Parser::block_statement() {
       node->add_child(std::move(lbrace_node));
     }
   } else {
-    Token left_brace = tokens[current - 1];
+    const Token& left_brace = tokens[current - 1];
     auto lbrace_node = make_cst_node(CSTNodeType::Delimiter, left_brace);
     node->add_child(std::move(lbrace_node));
   }
 
   auto stmt_list = make_cst_node(CSTNodeType::StatementList, make_location());
+  size_t errors_at_start = error_collector.count();
+  // 设置了注释表时尚未附着的独立注释
+  std::vector<Token> leading_comments;
   while (!check(TokenType::RightBrace) && !check(TokenType::EndOfFile)) {
     // 处理块中的注释
     if (check(TokenType::Comment)) {
-      auto comment_token = advance();
-      auto comment_node = make_cst_node(CSTNodeType::Comment, comment_token);
-      stmt_list->add_child(std::move(comment_node));
+      collect_comments(*stmt_list, leading_comments);
       continue;
     }
 
     auto stmt = declaration();
     if (stmt) {
+      attach_comments(stmt.get(), CommentPlacement::Leading, leading_comments);
       stmt_list->add_child(std::move(stmt));
     } else {
       // 错误恢复：语句解析失败，同步到下一个语句或块结束
@@ -166,7 +170,16 @@ std::unique_ptr<CSTNode> Parser::block_statement() {
         break;
       }
     }
+
+    // 限制级联错误：本代码块已累积过多错误时，剩余部分多半也无法
+    // 正确解析，直接跳到配对的右大括号，从块外继续解析。
+    if (error_collector.count() - errors_at_start >= MAX_ERRORS_PER_BLOCK) {
+      synchronize_to_block_end();
+      break;
+    }
   }
+  attach_comments(stmt_list.get(), CommentPlacement::Dangling,
+                  leading_comments);
   node->add_child(std::move(stmt_list));
 
   // 消费右大括号
@@ -194,11 +207,7 @@ std::unique_ptr<CSTNode> Parser::expression_statement() {
   }
 
   // 检查是否有行内注释
-  if (check(TokenType::Comment)) {
-    auto comment_token = advance();
-    auto comment_node = make_cst_node(CSTNodeType::Comment, comment_token);
-    node->add_child(std::move(comment_node));
-  }
+  trailing_comment(*node);
 
   return node;
 }
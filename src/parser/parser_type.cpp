@@ -29,7 +29,7 @@ std::unique_ptr<CSTNode> Parser::parse_type_union() {
 
   // 检查联合类型运算符 |
   while (match_token({TokenType::Or})) {
-    Token op = tokens[current - 1];
+    const Token& op = tokens[current - 1];
     auto union_node = make_cst_node(CSTNodeType::UnionType, make_location());
 
     union_node->add_child(std::move(left));
@@ -60,7 +60,7 @@ std::unique_ptr<CSTNode> Parser::parse_type_intersection() {
 
   // 检查交集类型运算符 &
   while (match_token({TokenType::And})) {
-    Token op = tokens[current - 1];
+    const Token& op = tokens[current - 1];
     auto intersection_node =
         make_cst_node(CSTNodeType::IntersectionType, make_location());
 
@@ -86,9 +86,14 @@ std::unique_ptr<CSTNode> Parser::parse_type_intersection() {
 }
 
 std::unique_ptr<CSTNode> Parser::parse_type_primary() {
+  NestingGuard guard(*this);
+  if (guard.exceeded()) {
+    return nullptr;
+  }
+
   // 否定类型: ~Type
   if (match_token({TokenType::Tilde})) {
-    Token tilde_token = tokens[current - 1];
+    const Token& tilde_token = tokens[current - 1];
     auto negation_node =
         make_cst_node(CSTNodeType::NegationType, make_location());
 
@@ -110,7 +115,7 @@ std::unique_ptr<CSTNode> Parser::parse_type_primary() {
 
   // 匿名结构体类型: struct { field: Type, ... }
   if (match_token({TokenType::Struct})) {
-    Token struct_keyword = tokens[current - 1];
+    const Token& struct_keyword = tokens[current - 1];
     auto anon_struct =
         make_cst_node(CSTNodeType::AnonymousStructType, make_location());
 
@@ -158,7 +163,7 @@ std::unique_ptr<CSTNode> Parser::parse_type_primary() {
         anon_struct->add_child(std::move(field_node));
 
         if (match_token({TokenType::Comma})) {
-          Token comma = tokens[current - 1];
+          const Token& comma = tokens[current - 1];
           auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
           anon_struct->add_child(std::move(comma_node));
           if (check(TokenType::RightBrace)) {
@@ -181,7 +186,7 @@ std::unique_ptr<CSTNode> Parser::parse_type_primary() {
 
   // 元组类型或函数签名: (T1, T2, ...) [-> (T3, T4, ...)]
   if (match_token({TokenType::LeftParen})) {
-    Token lparen_token = tokens[current - 1];
+    const Token& lparen_token = tokens[current - 1];
     auto lparen_node = make_cst_node(CSTNodeType::Delimiter, lparen_token);
 
     // 收集类型参数
@@ -197,7 +202,7 @@ std::unique_ptr<CSTNode> Parser::parse_type_primary() {
         type_list.push_back(std::move(type_elem));
 
         if (match_token({TokenType::Comma})) {
-          Token comma = tokens[current - 1];
+          const Token& comma = tokens[current - 1];
           auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
           type_list.push_back(std::move(comma_node));
         } else {
@@ -234,13 +239,13 @@ std::unique_ptr<CSTNode> Parser::parse_type_primary() {
       func_sig_node->add_child(std::move(rparen_node));
 
       // 消费箭头
-      Token arrow_token = advance();
+      const Token& arrow_token = advance();
       auto arrow_node = make_cst_node(CSTNodeType::Delimiter, arrow_token);
       func_sig_node->add_child(std::move(arrow_node));
 
       // 解析返回类型（可以是单个类型或元组）
       if (match_token({TokenType::LeftParen})) {
-        Token ret_lparen = tokens[current - 1];
+        const Token& ret_lparen = tokens[current - 1];
         auto ret_lparen_node =
             make_cst_node(CSTNodeType::Delimiter, ret_lparen);
         func_sig_node->add_child(std::move(ret_lparen_node));
@@ -254,7 +259,7 @@ std::unique_ptr<CSTNode> Parser::parse_type_primary() {
             func_sig_node->add_child(std::move(ret_type));
 
             if (match_token({TokenType::Comma})) {
-              Token comma = tokens[current - 1];
+              const Token& comma = tokens[current - 1];
               auto comma_node = make_cst_node(CSTNodeType::Delimiter, comma);
               func_sig_node->add_child(std::move(comma_node));
             } else {
@@ -300,7 +305,7 @@ std::unique_ptr<CSTNode> Parser::parse_type_primary() {
 
   // 基本类型：标识符（支持后缀数组类型）
   if (check(TokenType::Identifier)) {
-    Token type_token = advance();
+    const Token& type_token = advance();
     auto base_type = make_cst_node(CSTNodeType::TypeAnnotation, type_token);
 
     // 处理后缀数组类型: T[], T[5], T[][]
@@ -0,0 +1,165 @@
+/**
+ * @file stream_parser.cpp
+ * @brief `StreamParser` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/parser/stream_parser.hpp"
+
+#include "czc/lexer/token_source.hpp"
+#include "czc/utils/source_manager.hpp"
+
+#include <memory>
+#include <utility>
+
+namespace czc::parser {
+
+using namespace czc::lexer;
+
+namespace {
+
+/**
+ * @brief 以尚未提交的 Token 作为数据源，并记录是否读到了它们的末尾。
+ */
+class PendingTokenSource final : public TokenSource {
+public:
+  explicit PendingTokenSource(const std::vector<Token>& tokens) noexcept
+      : tokens(tokens) {}
+
+  Token next() override {
+    if (index < tokens.size()) {
+      return tokens[index++];
+    }
+    passed_end = true;
+    return Token::makeEOF();
+  }
+
+  [[nodiscard]] size_t size_hint() const noexcept override {
+    return tokens.size() - index + 1;
+  }
+
+  /**
+   * @brief Parser 是否已经拉取过末尾之后的 EOF，即看到了缓冲区的末尾。
+   */
+  [[nodiscard]] bool has_passed_end() const noexcept {
+    return passed_end;
+  }
+
+private:
+  const std::vector<Token>& tokens;
+  size_t index{0};
+  bool passed_end{false};
+};
+
+} // namespace
+
+StreamParser::StreamParser(DeclarationSink& sink, const std::string& filename)
+    : sink(sink), filename(filename),
+      file_id(utils::SourceManager::instance().add_file(filename)) {}
+
+size_t StreamParser::push(std::vector<Token> tokens) {
+  if (finished || tokens.empty()) {
+    return 0;
+  }
+
+  bool may_end_item = false;
+  bool reached_eof = false;
+  pending.reserve(pending.size() + tokens.size());
+  for (auto& token : tokens) {
+    switch (token.token_type) {
+    case TokenType::LeftBrace:
+    case TokenType::LeftParen:
+    case TokenType::LeftBracket:
+      ++depth;
+      break;
+    case TokenType::RightBrace:
+    case TokenType::RightParen:
+    case TokenType::RightBracket:
+      depth = depth > 0 ? depth - 1 : 0;
+      may_end_item |= depth == 0 && token.token_type == TokenType::RightBrace;
+      break;
+    case TokenType::Semicolon:
+      may_end_item |= depth == 0;
+      break;
+    case TokenType::EndOfFile:
+      reached_eof = true;
+      break;
+    default:
+      break;
+    }
+    if (reached_eof) {
+      break;
+    }
+    pending.push_back(std::move(token));
+  }
+
+  if (reached_eof) {
+    return finish();
+  }
+  if (!may_end_item && pending.size() < retry_size) {
+    return 0;
+  }
+  size_t committed = parse_pending(false);
+  retry_size = committed == 0 ? pending.size() * 2 : 0;
+  return committed;
+}
+
+size_t StreamParser::finish() {
+  if (finished) {
+    return 0;
+  }
+  finished = true;
+  return parse_pending(true);
+}
+
+size_t StreamParser::parse_pending(bool at_end) {
+  if (pending.empty() && !at_end) {
+    return 0;
+  }
+
+  if (!begun) {
+    // 与 `Parser::parse` 相同：程序的位置是首个 Token 的位置。
+    const Token& first = pending.empty() ? Token::makeEOF() : pending.front();
+    sink.begin_program(
+        utils::SourceLocation(file_id, first.line, first.column));
+    begun = true;
+  }
+
+  auto source = std::make_unique<PendingTokenSource>(pending);
+  const PendingTokenSource& window = *source;
+  Parser parser(std::move(source), filename);
+  parser.set_max_depth(max_depth);
+
+  size_t committed = 0;
+  size_t consumed = 0;
+  while (!parser.at_end() && (at_end || !window.has_passed_end())) {
+    size_t errors_before = parser.get_errors().size();
+    auto item = parser.parse_top_level_item();
+    // NOTE: 条目在解析中看到了缓冲区末尾时，后续 Token 可能改变它的结果；
+    //       丢弃它与它的错误，等更多 Token 到达后从它的起点重新解析。
+    if (!at_end && window.has_passed_end()) {
+      break;
+    }
+
+    const auto& errors = parser.get_errors();
+    for (size_t i = errors_before; i < errors.size(); ++i) {
+      error_collector.add(errors[i]);
+    }
+    if (item) {
+      sink.add_declaration(std::move(item));
+      ++committed;
+    }
+    consumed = parser.get_position();
+  }
+
+  if (at_end) {
+    pending.clear();
+  } else {
+    pending.erase(pending.begin(),
+                  pending.begin() + static_cast<std::ptrdiff_t>(consumed));
+  }
+  return committed;
+}
+
+} // namespace czc::parser
@@ -0,0 +1,79 @@
+/**
+ * @file token_buffer.cpp
+ * @brief `TokenBuffer` 的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-20
+ */
+
+#include "czc/parser/token_buffer.hpp"
+
+#include <cassert>
+
+namespace czc::parser {
+
+using namespace czc::lexer;
+
+static_assert((TokenBuffer::CAPACITY & (TokenBuffer::CAPACITY - 1)) == 0,
+              "TokenBuffer::CAPACITY must be a power of two");
+
+TokenBuffer::TokenBuffer(std::unique_ptr<TokenSource> source)
+    : source(std::move(source)), ring(CAPACITY, Token::makeEOF()) {}
+
+void TokenBuffer::fill_to(size_t index) const {
+  while (filled <= index && filled <= eof_index) {
+    Token token = source->next();
+    if (token.token_type == TokenType::EndOfFile) {
+      eof_index = filled;
+    }
+    ring[filled & (CAPACITY - 1)] = std::move(token);
+    filled++;
+  }
+}
+
+const Token& TokenBuffer::operator[](size_t index) const {
+  fill_to(index);
+
+  // NOTE: 越过 EOF 的下标统一映射到 EOF Token 本身，
+  //       相当于原先向量实现在末尾返回的 EOF 哨兵。
+  if (index > eof_index) {
+    index = eof_index;
+  }
+
+  assert(index + CAPACITY >= filled && "TokenBuffer: index outside window");
+  return ring[index & (CAPACITY - 1)];
+}
+
+void TokenBuffer::skip_to(size_t index) {
+  // NOTE: 只跳过到 `index - 1` 之前，让 Parser 访问前一个 Token
+  //       （`tokens[current - 1]`）时窗口中仍是真实的数据。
+  if (eof_index == static_cast<size_t>(-1) && index > filled + 1) {
+    filled += source->skip(index - 1 - filled);
+  }
+  fill_to(index);
+}
+
+void TokenBuffer::truncate(size_t index) {
+  if (index >= eof_index) {
+    return;
+  }
+  assert(index <= filled && index + CAPACITY >= filled &&
+         "TokenBuffer: index outside window");
+
+  Token eof = Token::makeEOF();
+  if (index < filled) {
+    const Token& replaced = ring[index & (CAPACITY - 1)];
+    eof.line = replaced.line;
+    eof.column = replaced.column;
+    eof.offset = replaced.offset;
+  }
+  ring[index & (CAPACITY - 1)] = std::move(eof);
+  eof_index = index;
+  filled = index + 1;
+}
+
+bool TokenBuffer::past_end(size_t index) const {
+  fill_to(index);
+  return index > eof_index;
+}
+
+} // namespace czc::parser
@@ -0,0 +1,487 @@
+/**
+ * @file server.cpp
+ * @brief `Server` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/server/server.hpp"
+
+#include "czc/formatter/format_cache.hpp"
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/token.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/token_preprocessor/preprocessed_token_source.hpp"
+#include "czc/utils/source_buffer.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace czc::server {
+
+using diagnostics::Diagnostic;
+using diagnostics::DiagnosticLevel;
+using diagnostics::I18nMessages;
+using utils::JsonValue;
+
+namespace {
+
+// JSON-RPC 2.0 规定的错误码。
+constexpr int PARSE_ERROR = -32700;
+constexpr int INVALID_REQUEST = -32600;
+constexpr int METHOD_NOT_FOUND = -32601;
+constexpr int INVALID_PARAMS = -32602;
+constexpr int INTERNAL_ERROR = -32603;
+// 由实现定义的服务器错误（如文件无法读取）。
+constexpr int SERVER_ERROR = -32000;
+
+/**
+ * @brief 参数取值非法，在 `Server::handle` 中转换为 `INVALID_PARAMS` 响应。
+ */
+class InvalidParams : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+JsonValue make_response(JsonValue id) {
+  JsonValue response = JsonValue::object();
+  response.set("jsonrpc", "2.0");
+  response.set("id", std::move(id));
+  return response;
+}
+
+JsonValue make_error(JsonValue id, int code, std::string message) {
+  JsonValue error = JsonValue::object();
+  error.set("code", code);
+  error.set("message", std::move(message));
+  JsonValue response = make_response(std::move(id));
+  response.set("error", std::move(error));
+  return response;
+}
+
+const std::string* string_param(const JsonValue* params,
+                                std::string_view key) {
+  const JsonValue* value = params ? params->find(key) : nullptr;
+  return value && value->is_string() ? &value->as_string() : nullptr;
+}
+
+/**
+ * @brief 取出源码中的第 `line` 行（从 1 开始），不含换行符。
+ */
+std::string line_of(std::string_view text, size_t line) {
+  size_t begin = 0;
+  for (size_t i = 1; i < line && begin != std::string_view::npos; ++i) {
+    begin = text.find('\n', begin);
+    if (begin != std::string_view::npos) {
+      ++begin;
+    }
+  }
+  if (begin == std::string_view::npos || begin > text.size()) {
+    return {};
+  }
+  size_t end = text.find('\n', begin);
+  return std::string(text.substr(begin, end == std::string_view::npos
+                                            ? std::string_view::npos
+                                            : end - begin));
+}
+
+/**
+ * @brief 把一组阶段错误转换为诊断，连同所在行的源码追加到 `out`。
+ */
+template <typename Errors>
+void collect_errors(const Errors& errors, std::string_view text,
+                    std::vector<Diagnostic>& out) {
+  for (const auto& error : errors) {
+    Diagnostic diag(DiagnosticLevel::Error, error.code, error.location,
+                    error.args);
+    diag.set_source_line(line_of(text, error.location.line));
+    out.push_back(std::move(diag));
+  }
+}
+
+} // namespace
+
+Server::Server(ServerOptions server_options)
+    : options(std::move(server_options)) {}
+
+const I18nMessages& Server::get_messages(const std::string& locale) {
+  auto& messages = locales[locale];
+  if (!messages) {
+    // NOTE: 诊断消息的 TOML 文件只在每个语言环境首次使用时解析一次。
+    messages = std::make_unique<I18nMessages>(locale);
+  }
+  return *messages;
+}
+
+const Server::FileEntry& Server::parse_cached(const std::string& path,
+                                              std::string text, bool& reused) {
+  uint64_t hash = formatter::FormatCache::hash_content(text);
+  auto it = files.find(path);
+  reused = false;
+  if (it != files.end()) {
+    recent_files.splice(recent_files.begin(), recent_files,
+                        it->second.recent_position);
+    reused = it->second.hash == hash;
+    if (reused) {
+      return it->second;
+    }
+  } else {
+    // 缓存已满时淘汰最久未使用的文件。
+    if (files.size() >= options.max_cached_files && !files.empty()) {
+      files.erase(recent_files.back());
+      recent_files.pop_back();
+    }
+    recent_files.push_front(path);
+    it = files.emplace(path, FileEntry()).first;
+    it->second.recent_position = recent_files.begin();
+  }
+
+  FileEntry& entry = it->second;
+  auto recent_position = entry.recent_position;
+  entry = FileEntry();
+  entry.recent_position = recent_position;
+  entry.hash = hash;
+  entry.source = utils::SourceBuffer(std::move(text));
+
+  auto token_source =
+      std::make_unique<token_preprocessor::PreprocessedTokenSource>(
+          entry.source, path);
+  token_source->set_interner(&interner);
+  const auto& stream = *token_source;
+  parser::Parser parser(std::move(token_source), path);
+  auto cst = parser.parse();
+
+  std::string_view content = entry.source.view();
+  collect_errors(stream.get_lexer_errors().get_errors(), content,
+                 entry.diagnostics);
+  collect_errors(stream.get_preprocessor_errors().get_errors(), content,
+                 entry.diagnostics);
+  collect_errors(parser.get_errors(), content, entry.diagnostics);
+  if (entry.diagnostics.empty()) {
+    entry.cst = std::move(cst);
+  }
+  return entry;
+}
+
+JsonValue
+Server::render_diagnostics(const std::vector<Diagnostic>& list,
+                           const I18nMessages& messages) const {
+  JsonValue result = JsonValue::array();
+  for (const auto& diag : list) {
+    const auto& location = diag.get_location();
+    JsonValue item = JsonValue::object();
+    item.set("code", diagnostics::diagnostic_code_to_string(diag.get_code()));
+    item.set("message",
+             messages.format_message(diag.get_code(), diag.get_args()));
+    item.set("line", location.line);
+    item.set("column", location.column);
+    item.set("rendered", diag.format(messages, false));
+    result.push_back(std::move(item));
+  }
+  return result;
+}
+
+JsonValue Server::tokenize(const std::string& path, std::string text,
+                           const I18nMessages& messages) {
+  token_preprocessor::PreprocessedTokenSource source(std::move(text), path);
+  source.set_interner(&interner);
+
+  JsonValue tokens = JsonValue::array();
+  while (true) {
+    lexer::Token token = source.next();
+    if (token.token_type == lexer::TokenType::EndOfFile) {
+      break;
+    }
+    JsonValue item = JsonValue::object();
+    item.set("type", lexer::token_type_to_string(token.token_type));
+    item.set("value", std::move(token.value));
+    item.set("line", token.line);
+    item.set("column", token.column);
+    tokens.push_back(std::move(item));
+  }
+
+  std::string_view content = source.get_source_tracker().get_input();
+  std::vector<Diagnostic> list;
+  collect_errors(source.get_lexer_errors().get_errors(), content, list);
+  collect_errors(source.get_preprocessor_errors().get_errors(), content, list);
+
+  JsonValue result = JsonValue::object();
+  result.set("tokens", std::move(tokens));
+  result.set("diagnostics", render_diagnostics(list, messages));
+  return result;
+}
+
+JsonValue Server::parse(const std::string& path, std::string text,
+                        const I18nMessages& messages) {
+  bool cached = false;
+  const FileEntry& entry = parse_cached(path, std::move(text), cached);
+
+  JsonValue result = JsonValue::object();
+  result.set("cached", cached);
+  result.set("diagnostics", render_diagnostics(entry.diagnostics, messages));
+  return result;
+}
+
+JsonValue Server::format(const std::string& path, std::string text,
+                         const JsonValue& params,
+                         const I18nMessages& messages) {
+  formatter::FormatOptions format_options;
+  if (const JsonValue* width = params.find("indent_width");
+      width && width->is_number() && width->as_number() >= 1 &&
+      width->as_number() <= 16) {
+    format_options.indent_width = static_cast<size_t>(width->as_number());
+  }
+  if (const JsonValue* tabs = params.find("use_tabs");
+      tabs && tabs->is_bool() && tabs->as_bool()) {
+    format_options.indent_style = formatter::IndentStyle::TABS;
+  }
+  if (const JsonValue* length = params.find("max_line_length")) {
+    // NOTE: 行列号以 32 位存储，更长的行宽没有意义；先检查再转换，
+    //       超出 `size_t` 范围或非有限的浮点数转换为整数是未定义行为。
+    double value = length->is_number() ? length->as_number() : -1;
+    if (!std::isfinite(value) || value < 0 || std::floor(value) != value ||
+        value > static_cast<double>(std::numeric_limits<uint32_t>::max())) {
+      throw InvalidParams(
+          "'max_line_length' must be a non-negative 32-bit integer");
+    }
+    format_options.max_line_length = static_cast<size_t>(value);
+  }
+
+  bool cached = false;
+  const FileEntry& entry = parse_cached(path, std::move(text), cached);
+  JsonValue result = JsonValue::object();
+  result.set("cached", cached);
+  if (!entry.cst) {
+    result.set("formatted", nullptr);
+    result.set("diagnostics", render_diagnostics(entry.diagnostics, messages));
+    return result;
+  }
+
+  formatter::Formatter formatter(format_options);
+  formatter.set_memo(&format_memo, entry.source.view());
+  std::string formatted = formatter.format(entry.cst.get());
+  std::vector<Diagnostic> list;
+  collect_errors(formatter.get_error_collector().get_errors(),
+                 entry.source.view(), list);
+  if (!list.empty()) {
+    result.set("formatted", nullptr);
+    result.set("diagnostics", render_diagnostics(list, messages));
+    return result;
+  }
+
+  result.set("changed", formatted != entry.source.view());
+  result.set("formatted", std::move(formatted));
+  result.set("diagnostics", JsonValue::array());
+  return result;
+}
+
+JsonValue Server::handle(const JsonValue& request) {
+  if (!request.is_object()) {
+    return make_error(nullptr, INVALID_REQUEST, "Request must be an object");
+  }
+  const JsonValue* id = request.find("id");
+  JsonValue response_id = id ? *id : JsonValue();
+  const JsonValue* method = request.find("method");
+  if (!method || !method->is_string()) {
+    return make_error(response_id, INVALID_REQUEST, "Missing method");
+  }
+  const JsonValue* params = request.find("params");
+  if (params && !params->is_object()) {
+    return make_error(response_id, INVALID_PARAMS,
+                      "Params must be an object");
+  }
+
+  const std::string& name = method->as_string();
+  JsonValue result;
+  try {
+    if (name == "shutdown") {
+      shutdown_requested = true;
+    } else if (name == "status") {
+      result = JsonValue::object();
+      result.set("cached_files", files.size());
+      result.set("interned_symbols", interner.size());
+      result.set("locales", locales.size());
+    } else if (name == "tokenize" || name == "parse" || name == "format") {
+      const std::string* path = string_param(params, "path");
+      if (!path) {
+        return make_error(response_id, INVALID_PARAMS, "Missing 'path'");
+      }
+      std::string text;
+      if (const std::string* inline_text = string_param(params, "text")) {
+        text = *inline_text;
+      } else {
+        std::optional<utils::SourceBuffer> source =
+            utils::SourceBuffer::open(*path);
+        if (!source) {
+          return make_error(response_id, SERVER_ERROR,
+                            "Cannot open file '" + *path + "'");
+        }
+        text = std::string(source->view());
+      }
+      const std::string* locale = string_param(params, "locale");
+      const I18nMessages& messages =
+          get_messages(locale ? *locale : options.locale);
+
+      if (name == "tokenize") {
+        result = tokenize(*path, std::move(text), messages);
+      } else if (name == "parse") {
+        result = parse(*path, std::move(text), messages);
+      } else {
+        result = format(*path, std::move(text), *params, messages);
+      }
+    } else {
+      return make_error(response_id, METHOD_NOT_FOUND,
+                        "Unknown method '" + name + "'");
+    }
+  } catch (const InvalidParams& e) {
+    return make_error(response_id, INVALID_PARAMS, e.what());
+  } catch (const std::exception& e) {
+    return make_error(response_id, INTERNAL_ERROR, e.what());
+  }
+
+  // 没有 `id` 的请求是通知，不需要响应。
+  if (!id) {
+    return JsonValue();
+  }
+  JsonValue response = make_response(response_id);
+  response.set("result", std::move(result));
+  return response;
+}
+
+std::string Server::handle_line(std::string_view line) {
+  std::optional<JsonValue> request = JsonValue::parse(line);
+  if (!request) {
+    return make_error(nullptr, PARSE_ERROR, "Invalid JSON").dump();
+  }
+  JsonValue response = handle(*request);
+  return response.is_null() ? std::string() : response.dump();
+}
+
+void Server::serve(std::istream& in, std::ostream& out) {
+  std::string line;
+  while (!shutdown_requested && std::getline(in, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
+    }
+    std::string response = handle_line(line);
+    if (!response.empty()) {
+      // NOTE: 每个响应单独刷新，客户端读到换行符即可处理，无需等待缓冲区满。
+      out << response << '\n' << std::flush;
+    }
+  }
+}
+
+#if defined(_WIN32)
+
+bool Server::serve_unix_socket(const std::string&) {
+  return false;
+}
+
+#else
+
+namespace {
+
+bool send_all(int fd, std::string_view data) {
+  while (!data.empty()) {
+#ifdef MSG_NOSIGNAL
+    ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+#else
+    ssize_t sent = ::send(fd, data.data(), data.size(), 0);
+#endif
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data.remove_prefix(static_cast<size_t>(sent));
+  }
+  return true;
+}
+
+} // namespace
+
+bool Server::serve_unix_socket(const std::string& path) {
+  sockaddr_un address{};
+  if (path.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  path.copy(address.sun_path, path.size());
+
+  int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    return false;
+  }
+  ::unlink(path.c_str());
+  if (::bind(listener, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0 ||
+      ::listen(listener, 16) != 0) {
+    ::close(listener);
+    return false;
+  }
+
+  // NOTE: 连接按顺序逐个服务，缓存无需加锁；编辑器与钩子的请求都很短，
+  //       排队的代价远小于每次重新启动进程。
+  std::string buffer;
+  char chunk[64 * 1024];
+  while (!shutdown_requested) {
+    int client = ::accept(listener, nullptr, nullptr);
+    if (client < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    buffer.clear();
+    bool open = true;
+    while (open && !shutdown_requested) {
+      ssize_t received = ::recv(client, chunk, sizeof(chunk), 0);
+      if (received < 0 && errno == EINTR) {
+        continue;
+      }
+      if (received <= 0) {
+        break;
+      }
+      buffer.append(chunk, static_cast<size_t>(received));
+
+      size_t begin = 0;
+      size_t end;
+      while (open && !shutdown_requested &&
+             (end = buffer.find('\n', begin)) != std::string::npos) {
+        std::string_view line(buffer.data() + begin, end - begin);
+        begin = end + 1;
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+          continue;
+        }
+        std::string response = handle_line(line);
+        if (!response.empty()) {
+          response.push_back('\n');
+          open = send_all(client, response);
+        }
+      }
+      buffer.erase(0, begin);
+    }
+    ::close(client);
+  }
+
+  ::close(listener);
+  ::unlink(path.c_str());
+  return true;
+}
+
+#endif
+
+} // namespace czc::server
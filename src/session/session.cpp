@@ -0,0 +1,162 @@
+/**
+ * @file session.cpp
+ * @brief `Session` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/session/session.hpp"
+
+#include "czc/ast/ast_builder.hpp"
+#include "czc/formatter/formatter.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/token_preprocessor/preprocessed_token_source.hpp"
+#include "czc/utils/source_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <optional>
+#include <utility>
+
+namespace czc::session {
+
+using diagnostics::DiagnosticEngine;
+
+/**
+ * @brief 一个工作线程依次处理各源码时复用的对象。
+ * @details 与 `czc-cli` 批量模式的做法相同：诊断引擎的记录池与已加载的
+ *          消息、格式化器的缓冲区都在源码之间保留，只在首次使用时分配。
+ */
+struct Session::Worker {
+  DiagnosticEngine diagnostics;
+  std::optional<formatter::Formatter> formatter;
+
+  explicit Worker(const std::string& locale) : diagnostics(locale) {}
+};
+
+Session::Session(SessionOptions session_options)
+    : options(std::move(session_options)), messages(options.locale) {}
+
+Session::~Session() = default;
+
+std::vector<SourceResult>
+Session::run(const std::vector<SourceInput>& sources) {
+  std::vector<SourceResult> results(sources.size());
+  size_t jobs = options.jobs != 0 ? options.jobs
+                                  : utils::ThreadPool::default_thread_count();
+  jobs = std::min(jobs, sources.size());
+
+  if (jobs <= 1) {
+    if (workers.empty()) {
+      workers.push_back(std::make_unique<Worker>(options.locale));
+    }
+    for (size_t i = 0; i < sources.size(); ++i) {
+      results[i] = process(*workers.front(), sources[i]);
+    }
+    return results;
+  }
+
+  if (!pool || pool->size() < jobs) {
+    pool = std::make_unique<utils::ThreadPool>(jobs);
+  }
+  while (workers.size() < jobs) {
+    workers.push_back(std::make_unique<Worker>(options.locale));
+  }
+
+  // NOTE: 每个任务占用一个 Worker，循环领取下一份源码，而不是每份源码一个
+  //       任务：大小悬殊的源码之间自然均衡，Worker 也不需要加锁。
+  std::atomic<size_t> next{0};
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(jobs);
+  for (size_t w = 0; w < jobs; ++w) {
+    Worker* worker = workers[w].get();
+    tasks.push_back(pool->submit([this, worker, &sources, &results, &next]() {
+      for (size_t i = next++; i < sources.size(); i = next++) {
+        results[i] = process(*worker, sources[i]);
+      }
+    }));
+  }
+  // 先等待全部任务结束，再重新抛出其中的异常：任务引用着局部变量。
+  for (auto& task : tasks) {
+    task.wait();
+  }
+  for (auto& task : tasks) {
+    task.get();
+  }
+  return results;
+}
+
+SourceResult Session::process(Worker& worker, const SourceInput& input) {
+  SourceResult result;
+  DiagnosticEngine& diagnostics = worker.diagnostics;
+  diagnostics.clear();
+  diagnostics.set_error_limit(options.max_errors != 0
+                                  ? options.max_errors
+                                  : std::numeric_limits<size_t>::max());
+
+  utils::SourceBuffer source = utils::SourceBuffer::borrow(input.text);
+  auto token_source =
+      std::make_unique<token_preprocessor::PreprocessedTokenSource>(
+          source, input.name);
+  token_source->set_interner(&interner);
+  token_source->set_error_reporter(&diagnostics);
+  // 诊断的源码行取自 Lexer 在分析过程中建立的行索引。
+  diagnostics.set_source(&token_source->get_source_tracker());
+  parser::Parser parser(std::move(token_source), input.name);
+  parser.set_error_reporter(&diagnostics);
+
+  switch (options.action) {
+  case SessionAction::Parse: {
+    parser.set_arena_enabled(true);
+    auto cst = parser.parse();
+    if (options.keep_cst && !diagnostics.has_errors()) {
+      result.cst = std::move(cst);
+    }
+    break;
+  }
+
+  case SessionAction::Format: {
+    parser.set_arena_enabled(true);
+    auto cst = parser.parse();
+    if (diagnostics.has_errors()) {
+      break;
+    }
+    if (!worker.formatter) {
+      worker.formatter.emplace(options.format_options);
+    }
+    formatter::Formatter& formatter = *worker.formatter;
+    formatter.get_error_collector().set_reporter(&diagnostics);
+    formatter.set_memo(options.share_format_memo ? &format_memo : nullptr,
+                       input.text);
+    std::string formatted = formatter.format(cst.get());
+    if (!diagnostics.has_errors()) {
+      result.changed = formatted != input.text;
+      result.formatted = std::move(formatted);
+    }
+    break;
+  }
+
+  case SessionAction::BuildAST: {
+    auto context = std::make_unique<ast::ASTContext>(interner);
+    ast::ASTBuilder builder(*context);
+    ast::Program* program = builder.build(parser);
+    if (!diagnostics.has_errors()) {
+      result.ast_context = std::move(context);
+      result.program = program;
+    }
+    break;
+  }
+  }
+
+  result.success = !diagnostics.has_errors();
+  result.diagnostics.reserve(diagnostics.size());
+  for (size_t i = 0; i < diagnostics.size(); ++i) {
+    result.diagnostics.push_back(diagnostics.get_diagnostic(i));
+  }
+  diagnostics.clear();
+  return result;
+}
+
+} // namespace czc::session
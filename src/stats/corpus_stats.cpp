@@ -0,0 +1,243 @@
+/**
+ * @file corpus_stats.cpp
+ * @brief `Histogram` 与 `CorpusStats` 的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/stats/corpus_stats.hpp"
+
+#include "czc/cst/cst_node_traits.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace czc::stats {
+
+using lexer::TokenType;
+using utils::JsonValue;
+
+// --- Histogram ---
+
+size_t Histogram::bucket_of(uint64_t value) noexcept {
+  if (value < LINEAR_BUCKETS) {
+    return static_cast<size_t>(value);
+  }
+  // 值的最高位在第 6 至 63 位，对应第 64 至 121 个桶。
+  size_t bit = 6;
+  while (bit < 63 && (value >> (bit + 1)) != 0) {
+    ++bit;
+  }
+  return LINEAR_BUCKETS + (bit - 6);
+}
+
+uint64_t Histogram::bucket_min(size_t bucket) noexcept {
+  if (bucket < LINEAR_BUCKETS) {
+    return bucket;
+  }
+  return uint64_t{1} << (bucket - LINEAR_BUCKETS + 6);
+}
+
+uint64_t Histogram::bucket_max(size_t bucket) noexcept {
+  if (bucket < LINEAR_BUCKETS) {
+    return bucket;
+  }
+  // NOTE: 最后一个桶的上界 2^64 - 1 由无符号回绕得到。
+  return (bucket_min(bucket) << 1) - 1;
+}
+
+void Histogram::add(uint64_t value, uint64_t times) noexcept {
+  if (times == 0) {
+    return;
+  }
+  buckets[bucket_of(value)] += times;
+  count += times;
+  sum += value * times;
+  max = std::max(max, value);
+}
+
+void Histogram::merge(const Histogram& other) noexcept {
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    buckets[i] += other.buckets[i];
+  }
+  count += other.count;
+  sum += other.sum;
+  max = std::max(max, other.max);
+}
+
+uint64_t Histogram::percentile(double q) const noexcept {
+  if (count == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count)));
+  rank = std::clamp<uint64_t>(rank, 1, count);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(bucket_max(i), max);
+    }
+  }
+  return max;
+}
+
+JsonValue Histogram::to_json() const {
+  JsonValue result = JsonValue::object();
+  result.set("count", count);
+  result.set("sum", sum);
+  result.set("mean", count != 0 ? static_cast<double>(sum) /
+                                      static_cast<double>(count)
+                                : 0.0);
+  result.set("max", max);
+  result.set("p50", percentile(0.5));
+  result.set("p90", percentile(0.9));
+  result.set("p99", percentile(0.99));
+
+  JsonValue list = JsonValue::array();
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    if (buckets[i] == 0) {
+      continue;
+    }
+    JsonValue bucket = JsonValue::object();
+    bucket.set("min", bucket_min(i));
+    bucket.set("max", std::min(bucket_max(i), max));
+    bucket.set("count", buckets[i]);
+    list.push_back(std::move(bucket));
+  }
+  result.set("buckets", std::move(list));
+  return result;
+}
+
+// --- CorpusStats ---
+
+void CorpusStats::add_file(size_t file_bytes,
+                           const std::vector<lexer::Token>& file_tokens,
+                           const cst::CSTNode* root, size_t file_arena_bytes) {
+  ++files;
+  source_bytes += file_bytes;
+  tokens += file_tokens.size();
+  tokens_per_file.add(file_tokens.size());
+  if (!file_tokens.empty()) {
+    // 四舍五入到整数字节，分布足以区分稀疏与密集的代码。
+    bytes_per_token.add((file_bytes + file_tokens.size() / 2) /
+                        file_tokens.size());
+  }
+
+  for (const lexer::Token& token : file_tokens) {
+    ++token_types[static_cast<size_t>(token.token_type)];
+    if (token.token_type == TokenType::Identifier) {
+      identifier_lengths.add(token.length);
+    } else if (token.token_type == TokenType::String) {
+      string_lengths.add(token.value.size());
+    }
+  }
+
+  if (root != nullptr) {
+    add_tree(root);
+    if (file_arena_bytes != 0) {
+      arena_bytes += file_arena_bytes;
+      arena_tokens += file_tokens.size();
+    }
+  }
+}
+
+void CorpusStats::add_tree(const cst::CSTNode* root) {
+  // NOTE: 显式栈遍历，深层嵌套的树不会耗尽调用栈。
+  std::vector<std::pair<const cst::CSTNode*, size_t>> stack{{root, 0}};
+  size_t max_depth = 0;
+  while (!stack.empty()) {
+    auto [node, depth] = stack.back();
+    stack.pop_back();
+    ++cst_nodes;
+    ++node_types[static_cast<size_t>(node->get_type())];
+    max_depth = std::max(max_depth, depth);
+
+    const auto& children = node->get_children();
+    children_per_node.add(children.size());
+    for (const auto& child : children) {
+      stack.emplace_back(child.get(), depth + 1);
+    }
+  }
+  max_depths.add(max_depth);
+}
+
+void CorpusStats::merge(const CorpusStats& other) {
+  files += other.files;
+  failed_files += other.failed_files;
+  source_bytes += other.source_bytes;
+  tokens += other.tokens;
+  cst_nodes += other.cst_nodes;
+  arena_bytes += other.arena_bytes;
+  arena_tokens += other.arena_tokens;
+  for (size_t i = 0; i < token_types.size(); ++i) {
+    token_types[i] += other.token_types[i];
+  }
+  for (size_t i = 0; i < node_types.size(); ++i) {
+    node_types[i] += other.node_types[i];
+  }
+  identifier_lengths.merge(other.identifier_lengths);
+  string_lengths.merge(other.string_lengths);
+  children_per_node.merge(other.children_per_node);
+  max_depths.merge(other.max_depths);
+  tokens_per_file.merge(other.tokens_per_file);
+  bytes_per_token.merge(other.bytes_per_token);
+}
+
+namespace {
+
+double ratio(uint64_t numerator, uint64_t denominator) {
+  return denominator != 0 ? static_cast<double>(numerator) /
+                                static_cast<double>(denominator)
+                          : 0.0;
+}
+
+} // namespace
+
+JsonValue CorpusStats::to_json() const {
+  JsonValue totals = JsonValue::object();
+  totals.set("files", files);
+  totals.set("failed_files", failed_files);
+  totals.set("source_bytes", source_bytes);
+  totals.set("tokens", tokens);
+  totals.set("cst_nodes", cst_nodes);
+  totals.set("arena_bytes", arena_bytes);
+
+  // 与 `CapacityEstimate` 的比例口径一致，可以直接比较。
+  JsonValue estimate = JsonValue::object();
+  estimate.set("bytes_per_token", ratio(source_bytes, tokens));
+  estimate.set("arena_bytes_per_token", ratio(arena_bytes, arena_tokens));
+  estimate.set("cst_nodes_per_token", ratio(cst_nodes, tokens));
+
+  JsonValue token_counts = JsonValue::object();
+  for (size_t i = 0; i < token_types.size(); ++i) {
+    if (token_types[i] != 0) {
+      token_counts.set(
+          std::string(lexer::token_type_name(static_cast<TokenType>(i))),
+          token_types[i]);
+    }
+  }
+  JsonValue node_counts = JsonValue::object();
+  for (size_t i = 0; i < node_types.size(); ++i) {
+    if (node_types[i] != 0) {
+      node_counts.set(std::string(cst::CST_NODE_TRAITS[i].name),
+                      node_types[i]);
+    }
+  }
+
+  JsonValue result = JsonValue::object();
+  result.set("totals", std::move(totals));
+  result.set("capacity_estimate", std::move(estimate));
+  result.set("token_types", std::move(token_counts));
+  result.set("identifier_lengths", identifier_lengths.to_json());
+  result.set("string_lengths", string_lengths.to_json());
+  result.set("cst_node_types", std::move(node_counts));
+  result.set("children_per_node", children_per_node.to_json());
+  result.set("max_depth_per_file", max_depths.to_json());
+  result.set("tokens_per_file", tokens_per_file.to_json());
+  result.set("bytes_per_token_per_file", bytes_per_token.to_json());
+  return result;
+}
+
+} // namespace czc::stats
@@ -0,0 +1,124 @@
+/**
+ * @file arena.cpp
+ * @brief `Arena` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace czc::utils {
+
+namespace {
+
+/**
+ * @brief 当前线程归还的常规块，按大小匹配后交给下一个 Arena。
+ */
+struct BlockCache {
+  std::vector<std::pair<size_t, std::unique_ptr<std::byte[]>>> blocks;
+  size_t bytes = 0;
+
+  ~BlockCache();
+};
+
+thread_local BlockCache block_cache;
+// NOTE: 线程退出时缓存先于某些 Arena（例如静态对象持有的）析构，
+//       之后归还的块直接释放。平凡类型的线程局部变量不会被析构。
+thread_local bool block_cache_destroyed = false;
+
+BlockCache::~BlockCache() {
+  block_cache_destroyed = true;
+}
+
+/**
+ * @brief 从块缓存中取出一个 `size` 字节的块，没有时返回空。
+ */
+std::unique_ptr<std::byte[]> take_cached_block(size_t size) {
+  if (block_cache_destroyed) {
+    return nullptr;
+  }
+  auto& cached = block_cache.blocks;
+  for (size_t i = cached.size(); i-- > 0;) {
+    if (cached[i].first == size) {
+      std::unique_ptr<std::byte[]> memory = std::move(cached[i].second);
+      cached.erase(cached.begin() + static_cast<std::ptrdiff_t>(i));
+      block_cache.bytes -= size;
+      return memory;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief 把一个块放进块缓存；缓存已满时直接释放。
+ */
+void cache_block(std::unique_ptr<std::byte[]> memory, size_t size) noexcept {
+  if (block_cache_destroyed ||
+      block_cache.bytes + size > Arena::MAX_CACHED_BYTES) {
+    return;
+  }
+  try {
+    block_cache.blocks.emplace_back(size, std::move(memory));
+    block_cache.bytes += size;
+  } catch (...) {
+    // 缓存本身无法增长时放弃缓存，块随 `memory` 释放。
+  }
+}
+
+} // namespace
+
+Arena::Arena(size_t initial_block_size) noexcept
+    : next_block_size(std::max<size_t>(initial_block_size, 64)) {}
+
+Arena::~Arena() {
+  reset();
+}
+
+size_t Arena::get_cached_bytes() noexcept {
+  return block_cache_destroyed ? 0 : block_cache.bytes;
+}
+
+void Arena::reset() noexcept {
+  for (Block& block : blocks) {
+    if (block.regular) {
+      cache_block(std::move(block.memory), block.size);
+    }
+  }
+  blocks.clear();
+  current = nullptr;
+  capacity = 0;
+  offset = 0;
+  bytes_used = 0;
+}
+
+void* Arena::allocate_slow(size_t size, size_t align) {
+  assert(align <= alignof(std::max_align_t) && "Arena: unsupported alignment");
+  (void)align;
+
+  // NOTE: new[] 返回的块起始地址至少按 max_align_t 对齐，新块从偏移 0
+  //       开始分配即满足对齐要求。大对象单独占一个块，不打断常规块的
+  //       增长节奏，也不浪费当前块的剩余空间。
+  bytes_used += size;
+  if (size > next_block_size) {
+    blocks.push_back({std::unique_ptr<std::byte[]>(new std::byte[size]), size,
+                      false});
+    return blocks.back().memory.get();
+  }
+
+  std::unique_ptr<std::byte[]> memory = take_cached_block(next_block_size);
+  if (!memory) {
+    memory.reset(new std::byte[next_block_size]);
+  }
+  blocks.push_back({std::move(memory), next_block_size, true});
+  current = blocks.back().memory.get();
+  capacity = next_block_size;
+  offset = size;
+  next_block_size = std::min(next_block_size * 2, MAX_BLOCK_SIZE);
+  return current;
+}
+
+} // namespace czc::utils
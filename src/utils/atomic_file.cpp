@@ -0,0 +1,155 @@
+/**
+ * @file atomic_file.cpp
+ * @brief `write_file_atomic` 的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/atomic_file.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <process.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace czc::utils {
+
+namespace {
+
+/**
+ * @brief 生成与目标文件同目录的临时文件名。
+ * @details 同一目录保证重命名不跨文件系统；进程号与计数器保证并行格式化
+ *          的多个线程、多个进程之间不会冲突。
+ */
+std::string temp_path_for(const std::string& path) {
+  static std::atomic<unsigned> counter{0};
+#if defined(_WIN32)
+  unsigned long pid = static_cast<unsigned long>(_getpid());
+#else
+  unsigned long pid = static_cast<unsigned long>(::getpid());
+#endif
+  return path + ".czc-tmp-" + std::to_string(pid) + "-" +
+         std::to_string(counter.fetch_add(1));
+}
+
+/**
+ * @brief 沿符号链接找到最终的目标文件。
+ * @details 重命名会把符号链接本身替换为普通文件，因此临时文件需要建在
+ *          链接指向的文件旁边，并重命名到该文件上。指向不存在文件的链接
+ *          同样解析到其目标，之后照常创建该文件。
+ */
+std::string resolve_target(const std::string& path) {
+  namespace fs = std::filesystem;
+  std::error_code error;
+  fs::path target(path);
+  // NOTE: 与 Linux 解析符号链接的层数上限一致，防止链接成环。
+  for (int hops = 0; hops < 40 && fs::is_symlink(target, error); ++hops) {
+    fs::path link = fs::read_symlink(target, error);
+    if (error) {
+      break;
+    }
+    target = link.is_absolute() ? link : target.parent_path() / link;
+  }
+  return target.string();
+}
+
+} // namespace
+
+bool write_file_atomic(const std::string& path, std::string_view content,
+                       bool sync) {
+  std::string target = resolve_target(path);
+  std::string temp_path = temp_path_for(target);
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(temp_path.c_str(), GENERIC_WRITE, 0, nullptr,
+                            CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  bool ok = true;
+  const char* data = content.data();
+  size_t remaining = content.size();
+  while (ok && remaining > 0) {
+    DWORD chunk = remaining > 0x40000000 ? 0x40000000
+                                         : static_cast<DWORD>(remaining);
+    DWORD written = 0;
+    ok = WriteFile(file, data, chunk, &written, nullptr) != 0;
+    data += written;
+    remaining -= written;
+  }
+  if (ok && sync) {
+    ok = FlushFileBuffers(file) != 0;
+  }
+  ok = CloseHandle(file) != 0 && ok;
+  if (ok) {
+    ok = MoveFileExA(temp_path.c_str(), target.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+  }
+#else
+  // 沿用目标文件的权限位；新文件使用默认权限（受 umask 约束）。
+  mode_t mode = 0666;
+  struct stat info;
+  bool existing = ::stat(target.c_str(), &info) == 0;
+  if (existing) {
+    mode = info.st_mode & 07777;
+  }
+
+  int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, mode);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = true;
+  const char* data = content.data();
+  size_t remaining = content.size();
+  // NOTE: 整个内容一次交给内核，只有被信号打断或部分写入时才会循环。
+  while (ok && remaining > 0) {
+    ssize_t written = ::write(fd, data, remaining);
+    if (written < 0) {
+      ok = errno == EINTR;
+      continue;
+    }
+    data += written;
+    remaining -= static_cast<size_t>(written);
+  }
+  // `open` 的权限位受 umask 影响，需要显式设置才能与原文件一致。
+  if (ok && existing) {
+    ok = ::fchmod(fd, mode) == 0;
+  }
+  if (ok && sync) {
+    ok = ::fsync(fd) == 0;
+  }
+  ok = ::close(fd) == 0 && ok;
+  if (ok) {
+    ok = ::rename(temp_path.c_str(), target.c_str()) == 0;
+  }
+  // 重命名本身记录在目录中，同样需要落盘才能在掉电后保留。
+  if (ok && sync) {
+    std::string directory =
+        std::filesystem::path(target).parent_path().string();
+    int dir_fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+      ::fsync(dir_fd);
+      ::close(dir_fd);
+    }
+  }
+#endif
+
+  if (!ok) {
+    std::remove(temp_path.c_str());
+  }
+  return ok;
+}
+
+} // namespace czc::utils
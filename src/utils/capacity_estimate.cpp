@@ -0,0 +1,82 @@
+/**
+ * @file capacity_estimate.cpp
+ * @brief `CapacityEstimate` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/capacity_estimate.hpp"
+
+#include "czc/utils/arena.hpp"
+
+#include <algorithm>
+
+namespace czc::utils {
+
+void CapacityEstimate::update(std::atomic<uint32_t>& ratio, uint64_t numerator,
+                              uint64_t denominator) noexcept {
+  // NOTE: 样本限制在每 Token 1 字节到 4 KiB 之间，排除异常输入（如整个
+  //       文件只有一个字符串）把比例带到极端。
+  constexpr uint64_t MIN_RATIO = FIXED_ONE;
+  constexpr uint64_t MAX_RATIO = 4096 * FIXED_ONE;
+  uint64_t sample =
+      std::clamp(numerator * FIXED_ONE / denominator, MIN_RATIO, MAX_RATIO);
+  uint64_t old = ratio.load(std::memory_order_relaxed);
+  ratio.store(static_cast<uint32_t>((old * 3 + sample + 2) / 4),
+              std::memory_order_relaxed);
+}
+
+size_t CapacityEstimate::estimate_tokens(size_t source_bytes) noexcept {
+  uint64_t ratio = bytes_per_token.load(std::memory_order_relaxed);
+  uint64_t estimate = static_cast<uint64_t>(source_bytes) * FIXED_ONE / ratio;
+  return static_cast<size_t>(std::min<uint64_t>(estimate + estimate / 8 + 1,
+                                                MAX_ESTIMATED_TOKENS));
+}
+
+void CapacityEstimate::observe_tokens(size_t source_bytes,
+                                      size_t token_count) noexcept {
+  if (token_count < MIN_SAMPLE_TOKENS) {
+    return;
+  }
+  update(bytes_per_token, source_bytes, token_count);
+}
+
+size_t CapacityEstimate::estimate_arena_block(size_t token_count) noexcept {
+  uint64_t ratio = arena_bytes_per_token.load(std::memory_order_relaxed);
+  uint64_t bytes = static_cast<uint64_t>(token_count) * ratio / FIXED_ONE;
+  size_t block = Arena::DEFAULT_BLOCK_SIZE;
+  while (block < bytes && block < Arena::MAX_BLOCK_SIZE) {
+    block *= 2;
+  }
+  return block;
+}
+
+void CapacityEstimate::observe_arena(size_t token_count,
+                                     size_t arena_bytes) noexcept {
+  if (token_count < MIN_SAMPLE_TOKENS) {
+    return;
+  }
+  update(arena_bytes_per_token, arena_bytes, token_count);
+}
+
+double CapacityEstimate::get_bytes_per_token() noexcept {
+  return static_cast<double>(bytes_per_token.load(std::memory_order_relaxed)) /
+         FIXED_ONE;
+}
+
+double CapacityEstimate::get_arena_bytes_per_token() noexcept {
+  return static_cast<double>(
+             arena_bytes_per_token.load(std::memory_order_relaxed)) /
+         FIXED_ONE;
+}
+
+void CapacityEstimate::reset() noexcept {
+  bytes_per_token.store(
+      static_cast<uint32_t>(DEFAULT_BYTES_PER_TOKEN * FIXED_ONE),
+      std::memory_order_relaxed);
+  arena_bytes_per_token.store(
+      static_cast<uint32_t>(DEFAULT_ARENA_BYTES_PER_TOKEN * FIXED_ONE),
+      std::memory_order_relaxed);
+}
+
+} // namespace czc::utils
@@ -7,123 +7,555 @@
 
 #include "czc/utils/file_collector.hpp"
 
+#include "czc/utils/atomic_file.hpp"
+#include "czc/utils/glob.hpp"
+#include "czc/utils/thread_pool.hpp"
+
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 
 namespace czc::utils {
 
-std::vector<std::string>
-FileCollector::collect_files(const std::vector<std::string>& patterns) {
-  std::vector<std::string> files_to_process;
+namespace {
 
-  for (const auto& arg : patterns) {
-    // 检查参数是否包含通配符
-    if (arg.find('*') != std::string::npos ||
-        arg.find('?') != std::string::npos) {
-      // --- 处理通配符模式 ---
-      std::filesystem::path pattern_path(arg);
-      std::filesystem::path parent_path = pattern_path.parent_path();
-      std::string pattern = pattern_path.filename().string();
-
-      // 如果路径中没有目录部分（例如 "*.txt"），则默认为当前目录
-      if (parent_path.empty()) {
-        parent_path = ".";
+namespace fs = std::filesystem;
+
+// 索引文件的首行，格式变化时递增版本号。
+constexpr std::string_view INDEX_HEADER = "czc-file-index 1";
+
+/**
+ * @brief 一个目录的条目列表，以及判断它是否过期所需的时间戳。
+ */
+struct DirListing {
+  // 目录的修改时间；增删或重命名条目都会改变它
+  int64_t mtime = 0;
+  // 目录中是否有 `.gitignore`，以及它的修改时间与大小
+  bool has_gitignore = false;
+  int64_t ignore_mtime = 0;
+  uint64_t ignore_size = 0;
+  // 常规文件（含指向文件的符号链接）与子目录（不含符号链接）的名字
+  std::vector<std::string> files;
+  std::vector<std::string> dirs;
+  // 是否可以写入索引：刚刚修改过的目录在同一时间刻度内可能再次变化
+  bool cacheable = true;
+};
+
+using DirIndex = std::unordered_map<std::string, DirListing>;
+
+/**
+ * @brief 一条 `.gitignore` 规则。
+ */
+struct IgnoreRule {
+  GlobPattern pattern;
+  // 以 `!` 开头，重新包含之前被排除的路径
+  bool negated = false;
+  // 以 `/` 结尾，只匹配目录
+  bool dir_only = false;
+  // 含有非结尾的 `/`，相对于 `.gitignore` 所在目录匹配；否则只匹配名字
+  bool anchored = false;
+};
+
+/**
+ * @brief 一个 `.gitignore` 文件的规则及其作用范围。
+ */
+struct IgnoreScope {
+  std::shared_ptr<const IgnoreScope> parent;
+  // 规则所在目录到遍历根目录的路径段（位于根目录之上时非空）
+  std::vector<std::string> prefix;
+  // 规则所在目录相对遍历根目录的深度（位于根目录之上时为 0）
+  size_t depth = 0;
+  std::vector<IgnoreRule> rules;
+};
+
+/**
+ * @brief 遍历中待读取的一个目录。
+ */
+struct DirTask {
+  std::string path;
+  // 相对遍历根目录的路径段
+  std::vector<std::string> relative;
+  std::shared_ptr<const IgnoreScope> ignore;
+};
+
+/**
+ * @brief 读取一个目录的结果。
+ */
+struct DirResult {
+  std::vector<std::string> files;
+  std::vector<DirTask> subdirs;
+  std::optional<DirListing> listing;
+};
+
+/**
+ * @brief 一次遍历的共享参数，遍历期间只读。
+ */
+struct Traversal {
+  std::vector<const GlobPattern*> patterns;
+  bool use_gitignore = true;
+  const DirIndex* index = nullptr;
+  fs::file_time_type started;
+};
+
+int64_t to_ticks(fs::file_time_type time) {
+  return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+std::string read_text(const fs::path& path) {
+  std::ifstream input(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(input)),
+                     std::istreambuf_iterator<char>());
+}
+
+std::vector<std::string_view> split_path(std::string_view path) {
+  std::vector<std::string_view> parts;
+  size_t begin = 0;
+  while (begin <= path.size()) {
+    size_t end = path.find('/', begin);
+    if (end == std::string_view::npos) {
+      end = path.size();
+    }
+    if (end > begin) {
+      parts.push_back(path.substr(begin, end - begin));
+    }
+    begin = end + 1;
+  }
+  return parts;
+}
+
+/**
+ * @brief 解析 `.gitignore` 的内容。
+ * @details 支持注释、`!` 取反、结尾 `/` 只匹配目录、含 `/` 的规则相对
+ *          所在目录匹配，以及 `*`、`?`、`**`。不支持字符类 `[...]` 与
+ *          转义，这类规则按字面匹配。
+ */
+std::vector<IgnoreRule> parse_gitignore(const std::string& content) {
+  std::vector<IgnoreRule> rules;
+  std::istringstream stream(content);
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    while (!line.empty() && (line.back() == ' ' || line.back() == '\t')) {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    bool negated = line[0] == '!';
+    std::string_view text(line);
+    if (negated) {
+      text.remove_prefix(1);
+    }
+    bool dir_only = !text.empty() && text.back() == '/';
+    if (dir_only) {
+      text.remove_suffix(1);
+    }
+    bool anchored = text.find('/') != std::string_view::npos;
+
+    std::vector<GlobSegment> segments;
+    for (std::string_view part : split_path(text)) {
+      segments.emplace_back(std::string(part));
+    }
+    if (segments.empty()) {
+      continue;
+    }
+    rules.push_back(
+        {GlobPattern(std::move(segments)), negated, dir_only, anchored});
+  }
+  return rules;
+}
+
+/**
+ * @brief 依次从最近的作用域向外查找最后一条匹配的规则。
+ * @param[in] relative 相对遍历根目录的路径段，最后一段是条目本身。
+ */
+bool is_ignored(const IgnoreScope* scope,
+                const std::vector<std::string_view>& relative, bool is_dir) {
+  std::vector<std::string_view> path;
+  for (; scope != nullptr; scope = scope->parent.get()) {
+    path.assign(scope->prefix.begin(), scope->prefix.end());
+    path.insert(path.end(), relative.begin() + scope->depth, relative.end());
+    std::vector<std::string_view> name{path.back()};
+    for (auto rule = scope->rules.rbegin(); rule != scope->rules.rend();
+         ++rule) {
+      if (rule->dir_only && !is_dir) {
+        continue;
+      }
+      if (rule->pattern.matches(rule->anchored ? path : name)) {
+        return !rule->negated;
       }
+    }
+  }
+  return false;
+}
 
-      // 遍历指定目录下的所有条目
-      if (std::filesystem::exists(parent_path) &&
-          std::filesystem::is_directory(parent_path)) {
-        try {
-          for (const auto& entry :
-               std::filesystem::directory_iterator(parent_path)) {
-            // 只对常规文件进行模式匹配，忽略目录等
-            if (entry.is_regular_file()) {
-              std::string filename = entry.path().filename().string();
-              if (matches_pattern(filename, pattern)) {
-                files_to_process.push_back(entry.path().string());
-              }
-            }
-          }
-        } catch (const std::filesystem::filesystem_error& e) {
-          // 目录遍历错误（权限不足、I/O错误等），跳过该目录
-          // 可以考虑记录警告日志
-          continue;
-        }
+/**
+ * @brief 收集遍历根目录之上、直到 Git 仓库顶层的 `.gitignore` 规则。
+ * @details 根目录不在 Git 仓库中时不使用其上的任何规则。
+ */
+std::shared_ptr<const IgnoreScope> ancestor_scopes(const std::string& root) {
+  std::error_code ec;
+  fs::path current = fs::weakly_canonical(fs::absolute(root, ec), ec);
+  if (ec) {
+    return nullptr;
+  }
+
+  // 根目录本身就是仓库顶层时，其中的 `.gitignore` 在遍历时读取。
+  if (fs::exists(current / ".git", ec)) {
+    return nullptr;
+  }
+
+  // 从根目录向上找到仓库顶层，记下途经的目录。
+  std::vector<fs::path> chain;
+  bool found = false;
+  for (fs::path dir = current.parent_path(); ; dir = dir.parent_path()) {
+    chain.push_back(dir);
+    if (fs::exists(dir / ".git", ec)) {
+      found = true;
+      break;
+    }
+    if (dir == dir.parent_path()) {
+      break;
+    }
+  }
+  if (!found) {
+    return nullptr;
+  }
+
+  std::shared_ptr<const IgnoreScope> scope;
+  for (auto dir = chain.rbegin(); dir != chain.rend(); ++dir) {
+    fs::path file = *dir / ".gitignore";
+    if (!fs::is_regular_file(file, ec)) {
+      continue;
+    }
+    auto next = std::make_shared<IgnoreScope>();
+    next->parent = scope;
+    for (const auto& part : current.lexically_relative(*dir)) {
+      next->prefix.push_back(part.string());
+    }
+    next->rules = parse_gitignore(read_text(file));
+    scope = std::move(next);
+  }
+  return scope;
+}
+
+/**
+ * @brief 读取目录的条目列表，索引中的记录仍然有效时直接复用。
+ * @return 目录无法读取时返回空。
+ */
+std::optional<DirListing> read_listing(const std::string& path,
+                                       const Traversal& traversal) {
+  std::error_code ec;
+  fs::file_time_type mtime = fs::last_write_time(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  fs::path ignore_file = fs::path(path) / ".gitignore";
+
+  if (traversal.index != nullptr) {
+    auto it = traversal.index->find(path);
+    if (it != traversal.index->end() && it->second.mtime == to_ticks(mtime)) {
+      // NOTE: 原地编辑 `.gitignore` 不会改变目录的修改时间，需要单独检查。
+      const DirListing& cached = it->second;
+      bool ignore_valid = true;
+      if (cached.has_gitignore) {
+        auto ignore_mtime = fs::last_write_time(ignore_file, ec);
+        ignore_valid =
+            !ec && to_ticks(ignore_mtime) == cached.ignore_mtime &&
+            fs::file_size(ignore_file, ec) == cached.ignore_size && !ec;
+      }
+      if (ignore_valid) {
+        return cached;
+      }
+    }
+  }
+
+  DirListing listing;
+  listing.mtime = to_ticks(mtime);
+  // 与本次遍历开始时间相差不到一秒的目录可能在同一时间刻度内再次变化，
+  // 这样的记录即使时间戳相同也不可信，不写入索引。
+  listing.cacheable = mtime + std::chrono::seconds(1) < traversal.started;
+
+  fs::directory_iterator it(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  for (; it != fs::directory_iterator(); it.increment(ec)) {
+    if (ec) {
+      return std::nullopt;
+    }
+    const fs::directory_entry& entry = *it;
+    std::string name = entry.path().filename().string();
+    if (name.find('\n') != std::string::npos) {
+      listing.cacheable = false;
+    }
+    // 只对常规文件进行模式匹配；不跟随指向目录的符号链接，避免循环。
+    if (entry.is_regular_file(ec)) {
+      if (name == ".gitignore") {
+        listing.has_gitignore = true;
+        listing.ignore_mtime = to_ticks(entry.last_write_time(ec));
+        listing.ignore_size = entry.file_size(ec);
       }
+      listing.files.push_back(std::move(name));
+    } else if (entry.is_directory(ec) && !entry.is_symlink(ec)) {
+      listing.dirs.push_back(std::move(name));
+    }
+  }
+  return listing;
+}
+
+/**
+ * @brief 读取一个目录，返回其中匹配的文件与需要继续遍历的子目录。
+ */
+DirResult visit_directory(const DirTask& task, const Traversal& traversal) {
+  DirResult result;
+  auto listing = read_listing(task.path, traversal);
+  if (!listing) {
+    // 目录遍历错误（权限不足、I/O错误等），跳过该目录
+    return result;
+  }
+
+  std::shared_ptr<const IgnoreScope> ignore = task.ignore;
+  if (traversal.use_gitignore && listing->has_gitignore) {
+    auto scope = std::make_shared<IgnoreScope>();
+    scope->parent = task.ignore;
+    scope->depth = task.relative.size();
+    scope->rules = parse_gitignore(read_text(fs::path(task.path) /
+                                             ".gitignore"));
+    ignore = std::move(scope);
+  }
+
+  std::vector<std::string_view> relative(task.relative.begin(),
+                                         task.relative.end());
+  relative.emplace_back();
+
+  for (const auto& name : listing->files) {
+    relative.back() = name;
+    bool matched = std::any_of(
+        traversal.patterns.begin(), traversal.patterns.end(),
+        [&](const GlobPattern* pattern) { return pattern->matches(relative); });
+    if (matched && !(traversal.use_gitignore &&
+                     is_ignored(ignore.get(), relative, false))) {
+      result.files.push_back((fs::path(task.path) / name).string());
+    }
+  }
+
+  for (const auto& name : listing->dirs) {
+    if (traversal.use_gitignore && name == ".git") {
+      continue;
+    }
+    relative.back() = name;
+    bool wanted = std::any_of(traversal.patterns.begin(),
+                              traversal.patterns.end(),
+                              [&](const GlobPattern* pattern) {
+                                return pattern->may_contain(relative);
+                              });
+    if (!wanted || (traversal.use_gitignore &&
+                    is_ignored(ignore.get(), relative, true))) {
+      continue;
+    }
+    DirTask subdir;
+    subdir.path = (fs::path(task.path) / name).string();
+    subdir.relative = task.relative;
+    subdir.relative.push_back(name);
+    subdir.ignore = ignore;
+    result.subdirs.push_back(std::move(subdir));
+  }
+
+  if (listing->cacheable) {
+    result.listing = std::move(listing);
+  }
+  return result;
+}
+
+/**
+ * @brief 读取索引文件；文件不存在或格式不符时返回空索引。
+ */
+DirIndex load_index(const std::string& path) {
+  DirIndex index;
+  std::ifstream input(path, std::ios::binary);
+  std::string line;
+  if (!input.is_open() || !std::getline(input, line) || line != INDEX_HEADER) {
+    return index;
+  }
+
+  DirListing* current = nullptr;
+  while (std::getline(input, line)) {
+    if (line.size() < 2 || line[1] != ' ') {
+      return {};
+    }
+    std::string_view rest = std::string_view(line).substr(2);
+    if (line[0] == 'd') {
+      std::istringstream fields{std::string(rest)};
+      DirListing listing;
+      fields >> listing.mtime >> listing.has_gitignore >>
+          listing.ignore_mtime >> listing.ignore_size;
+      std::string dir;
+      if (!fields || fields.get() != ' ' || !std::getline(fields, dir)) {
+        return {};
+      }
+      current = &(index[dir] = std::move(listing));
+    } else if (current != nullptr && line[0] == 'f') {
+      current->files.emplace_back(rest);
+    } else if (current != nullptr && line[0] == 's') {
+      current->dirs.emplace_back(rest);
     } else {
+      return {};
+    }
+  }
+  return index;
+}
+
+/**
+ * @brief 原子地写出索引文件，目录按路径排序以保证内容稳定。
+ */
+bool save_index(const std::string& path, const DirIndex& index) {
+  std::map<std::string_view, const DirListing*> sorted;
+  for (const auto& [dir, listing] : index) {
+    if (dir.find('\n') == std::string::npos) {
+      sorted.emplace(dir, &listing);
+    }
+  }
+
+  std::ostringstream output;
+  output << INDEX_HEADER << '\n';
+  for (const auto& [dir, listing] : sorted) {
+    output << "d " << listing->mtime << ' ' << listing->has_gitignore << ' '
+           << listing->ignore_mtime << ' ' << listing->ignore_size << ' '
+           << dir << '\n';
+    for (const auto& name : listing->files) {
+      output << "f " << name << '\n';
+    }
+    for (const auto& name : listing->dirs) {
+      output << "s " << name << '\n';
+    }
+  }
+  return write_file_atomic(path, output.str());
+}
+
+} // namespace
+
+std::vector<std::string>
+FileCollector::collect_files(const std::vector<std::string>& patterns,
+                             const CollectOptions& options) {
+  std::vector<std::string> files_to_process;
+
+  // --- 编译模式，并按根目录分组 ---
+  // NOTE: 根目录相同的模式（例如 `src/*.zero` 与 `src/**/*.test.zero`）
+  //       共享同一次遍历，每个目录只读取一次。
+  std::vector<std::unique_ptr<GlobPattern>> compiled;
+  std::map<std::string, std::vector<const GlobPattern*>> roots;
+  for (const auto& arg : patterns) {
+    if (!has_wildcards(arg)) {
       // --- 处理具体文件路径 ---
       // 如果不包含通配符，则假定它是一个具体的文件路径。
       // NOTE(BegoniaHe): 这里不检查文件是否存在。将这个责任留给调用者，
       // 这样更灵活，因为调用者可能想在文件不存在时报告更具体的错误。
       files_to_process.push_back(arg);
+      continue;
+    }
+    compiled.push_back(std::make_unique<GlobPattern>(arg));
+    // 如果路径中没有目录部分（例如 "*.txt"），则默认为当前目录
+    const std::string& root = compiled.back()->get_root();
+    roots[root.empty() ? "." : root].push_back(compiled.back().get());
+  }
+  if (roots.empty()) {
+    std::sort(files_to_process.begin(), files_to_process.end());
+    return files_to_process;
+  }
+
+  DirIndex index;
+  if (!options.index_path.empty()) {
+    index = load_index(options.index_path);
+  }
+  DirIndex updated;
+
+  std::unique_ptr<ThreadPool> pool;
+  if (options.jobs > 1) {
+    pool = std::make_unique<ThreadPool>(options.jobs);
+  }
+
+  for (auto& [root, root_patterns] : roots) {
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+      continue;
+    }
+
+    Traversal traversal;
+    traversal.patterns = std::move(root_patterns);
+    traversal.use_gitignore = options.use_gitignore;
+    traversal.index = options.index_path.empty() ? nullptr : &index;
+    traversal.started = fs::file_time_type::clock::now();
+
+    DirTask start;
+    start.path = root;
+    if (options.use_gitignore) {
+      start.ignore = ancestor_scopes(root);
+    }
+
+    // --- 逐层遍历 ---
+    // NOTE: 同一层的目录互不依赖，可以并行读取；下一层的目录在本层全部
+    //       完成后才提交，因此工作线程之间无需等待彼此，结果的顺序也与
+    //       线程调度无关。
+    std::vector<DirTask> level{std::move(start)};
+    while (!level.empty()) {
+      std::vector<DirResult> results;
+      results.reserve(level.size());
+      if (pool && level.size() > 1) {
+        std::vector<std::future<DirResult>> futures;
+        futures.reserve(level.size());
+        for (const auto& task : level) {
+          futures.push_back(pool->submit([&task, &traversal] {
+            return visit_directory(task, traversal);
+          }));
+        }
+        for (auto& future : futures) {
+          results.push_back(future.get());
+        }
+      } else {
+        for (const auto& task : level) {
+          results.push_back(visit_directory(task, traversal));
+        }
+      }
+
+      std::vector<DirTask> next;
+      for (size_t i = 0; i < results.size(); ++i) {
+        DirResult& result = results[i];
+        std::move(result.files.begin(), result.files.end(),
+                  std::back_inserter(files_to_process));
+        std::move(result.subdirs.begin(), result.subdirs.end(),
+                  std::back_inserter(next));
+        if (result.listing) {
+          updated[level[i].path] = std::move(*result.listing);
+        }
+      }
+      level = std::move(next);
     }
   }
 
+  // NOTE: 索引只记录本次遍历到的目录；写入失败不影响收集结果。
+  if (!options.index_path.empty()) {
+    save_index(options.index_path, updated);
+  }
+
   // 对结果进行排序，以确保每次运行都有一致和可预测的输出顺序
   std::sort(files_to_process.begin(), files_to_process.end());
 
   return files_to_process;
 }
 
-bool FileCollector::matches_pattern(const std::string& filename,
-                                    const std::string& pattern) {
-  // 边界检查：空模式和空文件名的处理
-  if (pattern.empty()) {
-    return filename.empty();
-  }
-  if (filename.empty()) {
-    // 空文件名只能匹配全是 '*' 的模式
-    return pattern.find_first_not_of('*') == std::string::npos;
-  }
-
-  size_t p_idx = 0;
-  size_t f_idx = 0;
-  // NOTE(BegoniaHe): 这是一个经典的通配符匹配算法，支持 '*' 和 '?'。
-  // 核心思想是使用回溯：当遇到 '*' 时，我们记录下它的位置以及
-  // 对应的文件名位置。如果后续匹配失败，我们可以回退到这个 '*'
-  // 的位置，让它多匹配一个字符，然后从新位置继续尝试。
-
-  // star_p_idx 记录最近遇到的 '*' 在模式中的位置
-  size_t star_p_idx = std::string::npos;
-  // star_f_idx 记录当遇到 '*' 时，文件名字符串的匹配位置
-  size_t star_f_idx = std::string::npos;
-
-  while (f_idx < filename.length()) {
-    // --- 字符匹配或遇到 '?' ---
-    if (p_idx < pattern.length() &&
-        (pattern[p_idx] == '?' || pattern[p_idx] == filename[f_idx])) {
-      p_idx++;
-      f_idx++;
-    }
-    // --- 遇到 '*' 通配符 ---
-    else if (p_idx < pattern.length() && pattern[p_idx] == '*') {
-      // 记录 '*' 的位置，并准备让它匹配 0 个字符
-      star_p_idx = p_idx;
-      star_f_idx = f_idx;
-      p_idx++; // 移动模式指针，跳过 '*'
-    }
-    // --- 匹配失败，尝试回溯 ---
-    else if (star_p_idx != std::string::npos) {
-      // 当前字符不匹配，但我们之前遇到过 '*'。
-      // 这时回溯到上一个 '*' 的状态。
-      p_idx = star_p_idx + 1; // 模式指针回到 '*' 的下一个字符
-      star_f_idx++;           // 让 '*' 多匹配一个字符
-      f_idx = star_f_idx;     // 文件名指针也相应移动
-    }
-    // --- 无法匹配且无法回溯 ---
-    else {
-      return false;
-    }
-  }
-
-  // --- 文件名已遍历完，检查模式剩余部分 ---
-  // 如果模式还有剩余字符，只有当它们都是 '*' 时才算匹配成功
-  while (p_idx < pattern.length() && pattern[p_idx] == '*') {
-    p_idx++;
-  }
-
-  // 最终，只有当模式也完全匹配到末尾时，才算成功
-  return p_idx == pattern.length();
-}
-
 } // namespace czc::utils
@@ -0,0 +1,190 @@
+/**
+ * @file glob.cpp
+ * @brief `GlobSegment` 与 `GlobPattern` 的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/glob.hpp"
+
+#include <utility>
+
+namespace czc::utils {
+
+bool wildcard_match(std::string_view name, std::string_view pattern) noexcept {
+  size_t p_idx = 0;
+  size_t f_idx = 0;
+  // NOTE(BegoniaHe): 这是一个经典的通配符匹配算法，支持 '*' 和 '?'。
+  // 核心思想是使用回溯：当遇到 '*' 时，我们记录下它的位置以及
+  // 对应的名字位置。如果后续匹配失败，我们可以回退到这个 '*'
+  // 的位置，让它多匹配一个字符，然后从新位置继续尝试。
+
+  // star_p_idx 记录最近遇到的 '*' 在模式中的位置
+  size_t star_p_idx = std::string_view::npos;
+  // star_f_idx 记录当遇到 '*' 时，名字的匹配位置
+  size_t star_f_idx = std::string_view::npos;
+
+  while (f_idx < name.length()) {
+    // --- 字符匹配或遇到 '?' ---
+    if (p_idx < pattern.length() &&
+        (pattern[p_idx] == '?' || pattern[p_idx] == name[f_idx])) {
+      p_idx++;
+      f_idx++;
+    }
+    // --- 遇到 '*' 通配符 ---
+    else if (p_idx < pattern.length() && pattern[p_idx] == '*') {
+      // 记录 '*' 的位置，并准备让它匹配 0 个字符
+      star_p_idx = p_idx;
+      star_f_idx = f_idx;
+      p_idx++; // 移动模式指针，跳过 '*'
+    }
+    // --- 匹配失败，尝试回溯 ---
+    else if (star_p_idx != std::string_view::npos) {
+      p_idx = star_p_idx + 1; // 模式指针回到 '*' 的下一个字符
+      star_f_idx++;           // 让 '*' 多匹配一个字符
+      f_idx = star_f_idx;     // 名字指针也相应移动
+    }
+    // --- 无法匹配且无法回溯 ---
+    else {
+      return false;
+    }
+  }
+
+  // 名字已遍历完，只有当模式剩余部分都是 '*' 时才算匹配成功
+  while (p_idx < pattern.length() && pattern[p_idx] == '*') {
+    p_idx++;
+  }
+  return p_idx == pattern.length();
+}
+
+bool has_wildcards(std::string_view text) noexcept {
+  return text.find_first_of("*?") != std::string_view::npos;
+}
+
+GlobSegment::GlobSegment(std::string segment_text)
+    : text(std::move(segment_text)) {
+  recursive = text == "**";
+  size_t first = text.find_first_of("*?");
+  literal = first == std::string::npos;
+  if (!literal) {
+    prefix_length = first;
+    suffix_length = text.size() - text.find_last_of("*?") - 1;
+  }
+}
+
+bool GlobSegment::matches(std::string_view name) const noexcept {
+  if (literal) {
+    return name == text;
+  }
+  // NOTE: 先比较字面前缀与后缀（如 `*.zero` 的扩展名），绝大多数不匹配
+  //       的名字在这里就被排除，不必进入回溯匹配。
+  if (name.size() < prefix_length + suffix_length) {
+    return false;
+  }
+  std::string_view pattern(text);
+  if (name.compare(0, prefix_length, pattern, 0, prefix_length) != 0 ||
+      name.compare(name.size() - suffix_length, suffix_length, pattern,
+                   pattern.size() - suffix_length, suffix_length) != 0) {
+    return false;
+  }
+  if (recursive) {
+    return true;
+  }
+  return wildcard_match(
+      name.substr(prefix_length,
+                  name.size() - prefix_length - suffix_length),
+      pattern.substr(prefix_length,
+                     pattern.size() - prefix_length - suffix_length));
+}
+
+GlobPattern::GlobPattern(std::string_view pattern) {
+  bool in_root = true;
+  size_t begin = 0;
+  while (begin <= pattern.size()) {
+    size_t end = pattern.find('/', begin);
+    if (end == std::string_view::npos) {
+      end = pattern.size();
+    }
+    std::string_view part = pattern.substr(begin, end - begin);
+    begin = end + 1;
+
+    // 最后一段总是留给文件名，即使它不含通配符。
+    bool last = end == pattern.size();
+    if (in_root && !last && !has_wildcards(part)) {
+      // 开头的空段表示绝对路径。
+      if (part.empty() && root.empty()) {
+        root = "/";
+      } else {
+        if (!root.empty() && root.back() != '/') {
+          root.push_back('/');
+        }
+        root.append(part);
+      }
+      continue;
+    }
+    in_root = false;
+    if (part.empty()) {
+      continue;
+    }
+    segments.emplace_back(std::string(part));
+  }
+}
+
+GlobPattern::GlobPattern(std::vector<GlobSegment> pattern_segments)
+    : segments(std::move(pattern_segments)) {}
+
+bool GlobPattern::matches(
+    const std::vector<std::string_view>& path) const noexcept {
+  return match_from(0, path, 0);
+}
+
+bool GlobPattern::may_contain(
+    const std::vector<std::string_view>& directory) const noexcept {
+  return may_contain_from(0, directory, 0);
+}
+
+bool GlobPattern::match_from(size_t segment_index,
+                             const std::vector<std::string_view>& path,
+                             size_t path_index) const noexcept {
+  while (segment_index < segments.size()) {
+    const GlobSegment& segment = segments[segment_index];
+    if (segment.is_recursive()) {
+      // `**` 依次尝试吞下零个、一个……直到全部剩余路径段。
+      for (size_t k = path_index; k <= path.size(); ++k) {
+        if (match_from(segment_index + 1, path, k)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    if (path_index == path.size() || !segment.matches(path[path_index])) {
+      return false;
+    }
+    ++segment_index;
+    ++path_index;
+  }
+  return path_index == path.size();
+}
+
+bool GlobPattern::may_contain_from(
+    size_t segment_index, const std::vector<std::string_view>& directory,
+    size_t path_index) const noexcept {
+  while (path_index < directory.size()) {
+    if (segment_index == segments.size()) {
+      return false;
+    }
+    const GlobSegment& segment = segments[segment_index];
+    if (segment.is_recursive()) {
+      return true;
+    }
+    if (!segment.matches(directory[path_index])) {
+      return false;
+    }
+    ++segment_index;
+    ++path_index;
+  }
+  // 目录之下的文件还需要至少一段来匹配。
+  return segment_index < segments.size();
+}
+
+} // namespace czc::utils
@@ -0,0 +1,457 @@
+/**
+ * @file json.cpp
+ * @brief `JsonValue` 的解析与序列化实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/json.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace czc::utils {
+
+namespace {
+
+/**
+ * @brief 递归下降的 JSON 解析器。
+ */
+class JsonParser {
+public:
+  explicit JsonParser(std::string_view text) : input(text) {}
+
+  std::optional<JsonValue> parse_document() {
+    JsonValue value;
+    if (!parse_value(value, 0)) {
+      return std::nullopt;
+    }
+    skip_whitespace();
+    if (pos != input.size()) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+private:
+  std::string_view input;
+  size_t pos = 0;
+
+  void skip_whitespace() {
+    while (pos < input.size() && (input[pos] == ' ' || input[pos] == '\t' ||
+                                  input[pos] == '\n' || input[pos] == '\r')) {
+      ++pos;
+    }
+  }
+
+  bool consume(std::string_view literal) {
+    if (input.substr(pos, literal.size()) != literal) {
+      return false;
+    }
+    pos += literal.size();
+    return true;
+  }
+
+  bool parse_value(JsonValue& value, size_t depth) {
+    if (depth > JsonValue::MAX_DEPTH) {
+      return false;
+    }
+    skip_whitespace();
+    if (pos >= input.size()) {
+      return false;
+    }
+    switch (input[pos]) {
+    case 'n':
+      value = nullptr;
+      return consume("null");
+    case 't':
+      value = true;
+      return consume("true");
+    case 'f':
+      value = false;
+      return consume("false");
+    case '"': {
+      std::string text;
+      if (!parse_string(text)) {
+        return false;
+      }
+      value = std::move(text);
+      return true;
+    }
+    case '[':
+      return parse_array(value, depth);
+    case '{':
+      return parse_object(value, depth);
+    default:
+      return parse_number(value);
+    }
+  }
+
+  bool parse_array(JsonValue& value, size_t depth) {
+    ++pos;
+    value = JsonValue::array();
+    skip_whitespace();
+    if (pos < input.size() && input[pos] == ']') {
+      ++pos;
+      return true;
+    }
+    while (true) {
+      JsonValue element;
+      if (!parse_value(element, depth + 1)) {
+        return false;
+      }
+      value.push_back(std::move(element));
+      skip_whitespace();
+      if (pos >= input.size()) {
+        return false;
+      }
+      if (input[pos++] == ']') {
+        return true;
+      }
+      if (input[pos - 1] != ',') {
+        return false;
+      }
+    }
+  }
+
+  bool parse_object(JsonValue& value, size_t depth) {
+    ++pos;
+    value = JsonValue::object();
+    skip_whitespace();
+    if (pos < input.size() && input[pos] == '}') {
+      ++pos;
+      return true;
+    }
+    while (true) {
+      skip_whitespace();
+      std::string key;
+      if (pos >= input.size() || input[pos] != '"' || !parse_string(key)) {
+        return false;
+      }
+      skip_whitespace();
+      if (pos >= input.size() || input[pos++] != ':') {
+        return false;
+      }
+      JsonValue member;
+      if (!parse_value(member, depth + 1)) {
+        return false;
+      }
+      value.set(std::move(key), std::move(member));
+      skip_whitespace();
+      if (pos >= input.size()) {
+        return false;
+      }
+      if (input[pos++] == '}') {
+        return true;
+      }
+      if (input[pos - 1] != ',') {
+        return false;
+      }
+    }
+  }
+
+  bool parse_hex4(uint32_t& code) {
+    if (pos + 4 > input.size()) {
+      return false;
+    }
+    code = 0;
+    for (size_t i = 0; i < 4; ++i) {
+      char c = input[pos++];
+      code <<= 4;
+      if (c >= '0' && c <= '9') {
+        code |= static_cast<uint32_t>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        code |= static_cast<uint32_t>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        code |= static_cast<uint32_t>(c - 'A' + 10);
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void append_utf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+      out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+      out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+      out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+      out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+  }
+
+  bool parse_string(std::string& out) {
+    ++pos; // 跳过开头的引号
+    while (pos < input.size()) {
+      char c = input[pos++];
+      if (c == '"') {
+        return true;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) {
+        return false;
+      }
+      if (c != '\\') {
+        out.push_back(c);
+        continue;
+      }
+      if (pos >= input.size()) {
+        return false;
+      }
+      switch (input[pos++]) {
+      case '"':
+        out.push_back('"');
+        break;
+      case '\\':
+        out.push_back('\\');
+        break;
+      case '/':
+        out.push_back('/');
+        break;
+      case 'b':
+        out.push_back('\b');
+        break;
+      case 'f':
+        out.push_back('\f');
+        break;
+      case 'n':
+        out.push_back('\n');
+        break;
+      case 'r':
+        out.push_back('\r');
+        break;
+      case 't':
+        out.push_back('\t');
+        break;
+      case 'u': {
+        uint32_t code = 0;
+        if (!parse_hex4(code)) {
+          return false;
+        }
+        // 代理对组合为一个补充平面的码点。
+        if (code >= 0xD800 && code <= 0xDBFF) {
+          uint32_t low = 0;
+          if (!consume("\\u") || !parse_hex4(low) || low < 0xDC00 ||
+              low > 0xDFFF) {
+            return false;
+          }
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code >= 0xDC00 && code <= 0xDFFF) {
+          return false;
+        }
+        append_utf8(out, code);
+        break;
+      }
+      default:
+        return false;
+      }
+    }
+    return false;
+  }
+
+  bool parse_number(JsonValue& value) {
+    size_t start = pos;
+    if (pos < input.size() && input[pos] == '-') {
+      ++pos;
+    }
+    auto digits = [&] {
+      size_t begin = pos;
+      while (pos < input.size() && input[pos] >= '0' && input[pos] <= '9') {
+        ++pos;
+      }
+      return pos - begin;
+    };
+    size_t int_digits = digits();
+    if (int_digits == 0 || (int_digits > 1 && input[pos - int_digits] == '0')) {
+      return false;
+    }
+    if (pos < input.size() && input[pos] == '.') {
+      ++pos;
+      if (digits() == 0) {
+        return false;
+      }
+    }
+    if (pos < input.size() && (input[pos] == 'e' || input[pos] == 'E')) {
+      ++pos;
+      if (pos < input.size() && (input[pos] == '+' || input[pos] == '-')) {
+        ++pos;
+      }
+      if (digits() == 0) {
+        return false;
+      }
+    }
+    std::string text(input.substr(start, pos - start));
+    value = std::strtod(text.c_str(), nullptr);
+    return true;
+  }
+};
+
+/**
+ * @brief 获取从 `pos` 开始的 UTF-8 多字节序列的长度。
+ * @details 拒绝多余的编码、代理项与超出 U+10FFFF 的码点；截断的序列
+ *          同样无效。
+ * @return 有效序列的字节数；无效时返回 0。
+ */
+size_t utf8_sequence_length(std::string_view text, size_t pos) noexcept {
+  auto byte = [&](size_t i) {
+    return static_cast<unsigned char>(text[pos + i]);
+  };
+  unsigned char first = byte(0);
+  size_t length = 0;
+  unsigned char low = 0x80;
+  unsigned char high = 0xBF;
+  if (first >= 0xC2 && first <= 0xDF) {
+    length = 2;
+  } else if (first >= 0xE0 && first <= 0xEF) {
+    length = 3;
+    low = first == 0xE0 ? 0xA0 : 0x80;
+    high = first == 0xED ? 0x9F : 0xBF;
+  } else if (first >= 0xF0 && first <= 0xF4) {
+    length = 4;
+    low = first == 0xF0 ? 0x90 : 0x80;
+    high = first == 0xF4 ? 0x8F : 0xBF;
+  } else {
+    return 0;
+  }
+  if (text.size() - pos < length || byte(1) < low || byte(1) > high) {
+    return 0;
+  }
+  for (size_t i = 2; i < length; ++i) {
+    if ((byte(i) & 0xC0) != 0x80) {
+      return 0;
+    }
+  }
+  return length;
+}
+
+} // namespace
+
+std::optional<JsonValue> JsonValue::parse(std::string_view input) {
+  return JsonParser(input).parse_document();
+}
+
+const JsonValue* JsonValue::find(std::string_view key) const noexcept {
+  if (kind != Kind::Object) {
+    return nullptr;
+  }
+  for (const auto& [name, value] : members) {
+    if (name == key) {
+      return &value;
+    }
+  }
+  return nullptr;
+}
+
+JsonValue& JsonValue::set(std::string key, JsonValue value) {
+  for (auto& member : members) {
+    if (member.first == key) {
+      member.second = std::move(value);
+      return *this;
+    }
+  }
+  members.emplace_back(std::move(key), std::move(value));
+  return *this;
+}
+
+void append_json_string(std::string& out, std::string_view text) {
+  static constexpr char HEX[] = "0123456789abcdef";
+  out.push_back('"');
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        out += "\\u00";
+        out.push_back(HEX[(c >> 4) & 0xF]);
+        out.push_back(HEX[c & 0xF]);
+      } else if (static_cast<unsigned char>(c) < 0x80) {
+        out.push_back(c);
+      } else if (size_t length = utf8_sequence_length(text, i); length != 0) {
+        out.append(text.substr(i, length));
+        i += length - 1;
+      } else {
+        // NOTE: 响应必须是有效的 UTF-8，源码中的无效字节逐个替换为 U+FFFD。
+        out += "\\ufffd";
+      }
+    }
+  }
+  out.push_back('"');
+}
+
+void JsonValue::dump_to(std::string& out) const {
+  switch (kind) {
+  case Kind::Null:
+    out += "null";
+    break;
+  case Kind::Bool:
+    out += boolean ? "true" : "false";
+    break;
+  case Kind::Number: {
+    // NOTE: 能精确表示的整数按整数输出，其余按最短往返精度输出；
+    //       JSON 不能表示 NaN 与无穷大，输出为 null。
+    char buffer[32];
+    if (!std::isfinite(number)) {
+      out += "null";
+    } else if (std::floor(number) == number && std::fabs(number) < 9.0e15) {
+      std::snprintf(buffer, sizeof(buffer), "%lld",
+                    static_cast<long long>(number));
+      out += buffer;
+    } else {
+      std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+      out += buffer;
+    }
+    break;
+  }
+  case Kind::String:
+    append_json_string(out, text);
+    break;
+  case Kind::Array:
+    out.push_back('[');
+    for (size_t i = 0; i < elements.size(); ++i) {
+      if (i > 0) {
+        out.push_back(',');
+      }
+      elements[i].dump_to(out);
+    }
+    out.push_back(']');
+    break;
+  case Kind::Object:
+    out.push_back('{');
+    for (size_t i = 0; i < members.size(); ++i) {
+      if (i > 0) {
+        out.push_back(',');
+      }
+      append_json_string(out, members[i].first);
+      out.push_back(':');
+      members[i].second.dump_to(out);
+    }
+    out.push_back('}');
+    break;
+  }
+}
+
+} // namespace czc::utils
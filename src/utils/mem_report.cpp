@@ -0,0 +1,173 @@
+/**
+ * @file mem_report.cpp
+ * @brief `MemReport` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/mem_report.hpp"
+
+#include "czc/utils/capacity_estimate.hpp"
+
+#include <iomanip>
+
+namespace czc::utils {
+
+namespace {
+
+double to_kib(uint64_t bytes) {
+  return static_cast<double>(bytes) / 1024.0;
+}
+
+} // namespace
+
+void MemReport::add(MemCategory category, uint64_t count, uint64_t bytes,
+                    uint64_t slack_bytes) noexcept {
+  Slot& slot = slots[static_cast<size_t>(category)];
+  slot.files.fetch_add(1, std::memory_order_relaxed);
+  slot.count.fetch_add(count, std::memory_order_relaxed);
+  slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  slot.slack_bytes.fetch_add(slack_bytes, std::memory_order_relaxed);
+  uint64_t max = slot.max_bytes.load(std::memory_order_relaxed);
+  while (bytes > max && !slot.max_bytes.compare_exchange_weak(
+                            max, bytes, std::memory_order_relaxed)) {
+  }
+}
+
+MemStats MemReport::get(MemCategory category) noexcept {
+  const Slot& slot = slots[static_cast<size_t>(category)];
+  MemStats stats;
+  stats.files = slot.files.load(std::memory_order_relaxed);
+  stats.count = slot.count.load(std::memory_order_relaxed);
+  stats.bytes = slot.bytes.load(std::memory_order_relaxed);
+  stats.slack_bytes = slot.slack_bytes.load(std::memory_order_relaxed);
+  stats.max_bytes = slot.max_bytes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void MemReport::reset() noexcept {
+  for (auto& slot : slots) {
+    slot.files.store(0, std::memory_order_relaxed);
+    slot.count.store(0, std::memory_order_relaxed);
+    slot.bytes.store(0, std::memory_order_relaxed);
+    slot.slack_bytes.store(0, std::memory_order_relaxed);
+    slot.max_bytes.store(0, std::memory_order_relaxed);
+  }
+}
+
+const char* MemReport::category_name(MemCategory category) noexcept {
+  switch (category) {
+  case MemCategory::Source:
+    return "source";
+  case MemCategory::LineIndex:
+    return "line-index";
+  case MemCategory::Tokens:
+    return "tokens";
+  case MemCategory::TokenText:
+    return "token-text";
+  case MemCategory::CSTNodes:
+    return "cst-nodes";
+  case MemCategory::CSTChildren:
+    return "cst-children";
+  case MemCategory::CSTTokenText:
+    return "cst-token-text";
+  case MemCategory::ASTNodes:
+    return "ast-nodes";
+  case MemCategory::Diagnostics:
+    return "diagnostics";
+  case MemCategory::InternedStrings:
+    return "interned-strings";
+  }
+  return "unknown";
+}
+
+void MemReport::print_table(std::ostream& os) {
+  const auto flags = os.flags();
+  const auto precision = os.precision();
+
+  os << std::left << std::setw(18) << "structure" << std::right
+     << std::setw(8) << "files" << std::setw(12) << "count" << std::setw(12)
+     << "KiB" << std::setw(12) << "slack KiB" << std::setw(14)
+     << "max KiB/file" << "\n";
+
+  MemStats total;
+  for (size_t i = 0; i < MEM_CATEGORY_COUNT; ++i) {
+    auto category = static_cast<MemCategory>(i);
+    MemStats stats = get(category);
+    if (stats.files == 0) {
+      continue;
+    }
+    os << std::left << std::setw(18) << category_name(category) << std::right
+       << std::setw(8) << stats.files << std::setw(12) << stats.count
+       << std::fixed << std::setprecision(1) << std::setw(12)
+       << to_kib(stats.bytes) << std::setw(12) << to_kib(stats.slack_bytes)
+       << std::setw(14) << to_kib(stats.max_bytes) << "\n";
+    total.bytes += stats.bytes;
+    total.slack_bytes += stats.slack_bytes;
+  }
+
+  os << std::left << std::setw(18) << "total" << std::right << std::setw(8)
+     << "" << std::setw(12) << "" << std::fixed << std::setprecision(1)
+     << std::setw(12) << to_kib(total.bytes) << std::setw(12)
+     << to_kib(total.slack_bytes) << "\n";
+
+  MemStats nodes = get(MemCategory::CSTNodes);
+  MemStats children = get(MemCategory::CSTChildren);
+  if (nodes.count > 0) {
+    // NOTE: 子节点列表的元素是 `std::unique_ptr<CSTNode>`，与指针等宽。
+    double capacity = static_cast<double>(children.bytes) /
+                      static_cast<double>(sizeof(void*));
+    os << std::setprecision(2) << "cst children per node: "
+       << static_cast<double>(children.count) /
+              static_cast<double>(nodes.count)
+       << " used, " << capacity / static_cast<double>(nodes.count)
+       << " capacity\n";
+  }
+  MemStats source = get(MemCategory::Source);
+  if (source.bytes > 0) {
+    os << std::setprecision(2) << "bytes per source byte: "
+       << static_cast<double>(total.bytes) /
+              static_cast<double>(source.bytes)
+       << "\n";
+  }
+  os << std::setprecision(2) << "capacity estimate: "
+     << CapacityEstimate::get_bytes_per_token() << " bytes/token, "
+     << CapacityEstimate::get_arena_bytes_per_token()
+     << " arena bytes/token\n";
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+JsonValue MemReport::to_json() {
+  JsonValue structures = JsonValue::object();
+  uint64_t total_bytes = 0;
+  uint64_t total_slack = 0;
+  for (size_t i = 0; i < MEM_CATEGORY_COUNT; ++i) {
+    auto category = static_cast<MemCategory>(i);
+    MemStats stats = get(category);
+    JsonValue entry = JsonValue::object();
+    entry.set("files", stats.files);
+    entry.set("count", stats.count);
+    entry.set("bytes", stats.bytes);
+    entry.set("slack_bytes", stats.slack_bytes);
+    entry.set("max_bytes_per_file", stats.max_bytes);
+    structures.set(category_name(category), std::move(entry));
+    total_bytes += stats.bytes;
+    total_slack += stats.slack_bytes;
+  }
+
+  JsonValue report = JsonValue::object();
+  report.set("structures", std::move(structures));
+  report.set("bytes", total_bytes);
+  report.set("slack_bytes", total_slack);
+
+  JsonValue estimate = JsonValue::object();
+  estimate.set("bytes_per_token", CapacityEstimate::get_bytes_per_token());
+  estimate.set("arena_bytes_per_token",
+               CapacityEstimate::get_arena_bytes_per_token());
+  report.set("capacity_estimate", std::move(estimate));
+  return report;
+}
+
+} // namespace czc::utils
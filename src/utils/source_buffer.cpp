@@ -0,0 +1,201 @@
+/**
+ * @file source_buffer.cpp
+ * @brief `SourceBuffer` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/source_buffer.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace czc::utils {
+
+namespace {
+
+/**
+ * @brief 以只读方式映射整个文件。
+ * @param[in] path 文件路径。
+ * @param[out] size 映射的字节数。
+ * @return 映射区域的起始地址；文件不是足够大的常规文件或映射失败时为空。
+ */
+void* map_file(const std::string& path, size_t& size) {
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+  LARGE_INTEGER file_size;
+  void* view = nullptr;
+  if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &file_size) &&
+      static_cast<unsigned long long>(file_size.QuadPart) >=
+          SourceBuffer::MMAP_THRESHOLD) {
+    HANDLE mapping =
+        CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+      view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      // NOTE: 视图本身持有映射对象，句柄可以立即关闭。
+      CloseHandle(mapping);
+      size = static_cast<size_t>(file_size.QuadPart);
+    }
+  }
+  CloseHandle(file);
+  return view;
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat info;
+  void* view = nullptr;
+  if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) &&
+      static_cast<size_t>(info.st_size) >= SourceBuffer::MMAP_THRESHOLD) {
+    size = static_cast<size_t>(info.st_size);
+    view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+      view = nullptr;
+    }
+  }
+  // NOTE: 映射建立后即不再需要文件描述符。
+  ::close(fd);
+  return view;
+#endif
+}
+
+void unmap_file(void* view, size_t size) {
+#if defined(_WIN32)
+  (void)size;
+  UnmapViewOfFile(view);
+#else
+  ::munmap(view, size);
+#endif
+}
+
+} // namespace
+
+SourceBuffer::SourceBuffer(std::string content)
+    : length(content.size()), storage(std::move(content)) {
+  data = storage.data();
+}
+
+SourceBuffer::~SourceBuffer() {
+  reset();
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer&& other) noexcept {
+  *this = std::move(other);
+}
+
+SourceBuffer& SourceBuffer::operator=(SourceBuffer&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  reset();
+  bool in_storage =
+      other.mapping == nullptr && other.data == other.storage.data();
+  length = other.length;
+  mapping = other.mapping;
+  data = other.data;
+  storage = std::move(other.storage);
+  // 短字符串的内容存放在对象内部，移动后地址会变化，需要重新指向。
+  if (in_storage) {
+    data = storage.data();
+  }
+
+  other.data = nullptr;
+  other.length = 0;
+  other.mapping = nullptr;
+  other.storage.clear();
+  return *this;
+}
+
+std::optional<SourceBuffer> SourceBuffer::open(const std::string& path) {
+  size_t size = 0;
+  if (void* view = map_file(path, size)) {
+    SourceBuffer buffer;
+    buffer.mapping = view;
+    buffer.data = static_cast<const char*>(view);
+    buffer.length = size;
+    return buffer;
+  }
+
+  std::ifstream input(path, std::ios::binary);
+  if (!input.is_open()) {
+    return std::nullopt;
+  }
+
+  // 大小已知的文件按大小一次读入，只分配一次。
+  input.seekg(0, std::ios::end);
+  std::streamoff end = input.tellg();
+  if (end > 0) {
+    std::string content(static_cast<size_t>(end), '\0');
+    input.seekg(0, std::ios::beg);
+    input.read(content.data(), end);
+    content.resize(static_cast<size_t>(input.gcount()));
+    return SourceBuffer(std::move(content));
+  }
+  input.clear();
+  input.seekg(0, std::ios::beg);
+  input.clear();
+  return read_stream(input);
+}
+
+SourceBuffer SourceBuffer::borrow(std::string_view text) noexcept {
+  SourceBuffer buffer;
+  buffer.data = text.data();
+  buffer.length = text.size();
+  return buffer;
+}
+
+SourceBuffer SourceBuffer::read_stream(std::istream& stream) {
+  // NOTE: 管道与标准输入没有可用的大小，直接按迭代器一次读完。
+  std::string content((std::istreambuf_iterator<char>(stream)),
+                      std::istreambuf_iterator<char>());
+  return SourceBuffer(std::move(content));
+}
+
+void SourceBuffer::prefetch() const noexcept {
+  if (mapping == nullptr) {
+    return;
+  }
+#if !defined(_WIN32)
+  // NOTE: 先提示内核整体预读，随后逐页访问时多数页面已经就绪。
+  ::madvise(mapping, length, MADV_WILLNEED);
+#endif
+  // 4 KiB 是各平台最小的页面大小，逐页各读一个字节即可触发全部缺页。
+  // NOTE: 写入 volatile 变量，防止编译器删掉结果没有用到的读取。
+  constexpr size_t PREFETCH_STRIDE = 4096;
+  volatile char sink = 0;
+  for (size_t offset = 0; offset < length; offset += PREFETCH_STRIDE) {
+    sink = data[offset];
+  }
+  static_cast<void>(sink);
+}
+
+void SourceBuffer::reset() noexcept {
+  if (mapping != nullptr) {
+    unmap_file(mapping, length);
+    mapping = nullptr;
+  }
+  storage.clear();
+  data = nullptr;
+  length = 0;
+}
+
+} // namespace czc::utils
@@ -0,0 +1,25 @@
+/**
+ * @file source_location.cpp
+ * @brief `SourceLocation` 结构体的功能实现。
+ * @details 查询文件名登记表的两个函数不放在头文件中，`source_location.hpp`
+ *          因此不依赖 `source_manager.hpp`。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/source_location.hpp"
+
+#include "czc/utils/source_manager.hpp"
+
+namespace czc::utils {
+
+SourceLocation::SourceLocation(std::string_view file, size_t ln, size_t col,
+                               size_t end_ln, size_t end_col)
+    : SourceLocation(SourceManager::instance().add_file(file), ln, col, end_ln,
+                     end_col) {}
+
+std::string_view SourceLocation::get_filename() const {
+  return SourceManager::instance().get_filename(file_id);
+}
+
+} // namespace czc::utils
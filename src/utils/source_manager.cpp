@@ -0,0 +1,56 @@
+/**
+ * @file source_manager.cpp
+ * @brief `SourceManager` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/source_manager.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+namespace czc::utils {
+
+SourceManager::SourceManager() {
+  // NOTE: 登记顺序必须与 `STDIN_FILE` / `UNKNOWN_FILE` 的取值一致。
+  (void)add_file("<stdin>");
+  (void)add_file("");
+}
+
+SourceManager& SourceManager::instance() {
+  // NOTE: 有意不析构，静态对象析构期间仍可能有位置被打印。
+  static SourceManager* manager = new SourceManager();
+  return *manager;
+}
+
+FileId SourceManager::add_file(std::string_view filename) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = index.find(filename);
+  if (it != index.end()) {
+    return it->second;
+  }
+  if (filenames.size() >= std::numeric_limits<FileId>::max()) {
+    throw std::length_error("SourceManager: too many files");
+  }
+
+  auto id = static_cast<FileId>(filenames.size());
+  filenames.emplace_back(filename);
+  index.emplace(filenames.back(), id);
+  return id;
+}
+
+std::string_view SourceManager::get_filename(FileId id) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (id >= filenames.size()) {
+    return {};
+  }
+  return filenames[id];
+}
+
+size_t SourceManager::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return filenames.size();
+}
+
+} // namespace czc::utils
@@ -7,18 +7,63 @@
 
 #include "czc/utils/source_tracker.hpp"
 
+#include "czc/utils/source_manager.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
 namespace czc::utils {
 
+namespace {
+
+// 合并遍历时逐行前进的最大行数，超过后改为二分查找。
+constexpr size_t MAX_LINEAR_LINE_STEPS = 8;
+
+} // namespace
+
+size_t count_utf8_chars(std::string_view text) noexcept {
+  constexpr uint64_t LOW_BITS = 0x0101010101010101ULL;
+  const char* data = text.data();
+  size_t size = text.size();
+  size_t continuation = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    // NOTE: 续字节的最高两位为 10。把每个字节的第 7 位与取反后的第 6 位
+    //       移到该字节的最低位相与，结果的每个字节为 0 或 1；再乘以
+    //       LOW_BITS，最高字节即为 8 个字节之和。
+    uint64_t marks = (word >> 7) & ~(word >> 6) & LOW_BITS;
+    continuation += static_cast<size_t>((marks * LOW_BITS) >> 56);
+  }
+  for (; i < size; ++i) {
+    if ((static_cast<unsigned char>(data[i]) & 0xC0) == 0x80) {
+      ++continuation;
+    }
+  }
+  return size - continuation;
+}
+
 SourceTracker::SourceTracker(const std::string& source,
                              const std::string& fname)
-    : filename(fname), position(0), line(1), column(1) {
-  // NOTE(BegoniaHe): 将输入的 std::string 复制到内部的 std::vector<char>。
-  // 使用 vector<char> 而非 string 是一个设计选择。虽然 string
-  // 在很多方面功能更强，但 vector<char> 确保了数据是连续存储的，
-  // 并且在与需要原始指针和大小的 C API 或其他底层库交互时可能更直接。
-  // 对于词法分析器这种性能敏感的组件，直接操作字符数组有时更清晰。
-  input.assign(source.begin(), source.end());
-}
+    : SourceTracker(std::string(source), fname) {}
+
+SourceTracker::SourceTracker(std::string&& source, const std::string& fname)
+    : SourceTracker(std::make_shared<const SourceBuffer>(std::move(source)),
+                    fname) {}
+
+SourceTracker::SourceTracker(std::shared_ptr<const SourceBuffer> source,
+                             const std::string& fname)
+    : filename(fname), file_id(SourceManager::instance().add_file(fname)),
+      owned(std::move(source)), input(owned->view()),
+      position(0), line(1), column(1), line_offsets{0} {}
+
+SourceTracker::SourceTracker(const SourceBuffer& source,
+                             const std::string& fname)
+    : filename(fname), file_id(SourceManager::instance().add_file(fname)),
+      input(source.view()), position(0), line(1), column(1), line_offsets{0} {}
 
 void SourceTracker::advance(char c) {
   // 每次消耗一个字符时，字节位置 `position` 总是增加
@@ -33,45 +78,99 @@ void SourceTracker::advance(char c) {
     // 如果不是换行符，只增加列号
     column++;
   }
+
+  // 顺带记录行索引。若该位置已被惰性补齐覆盖，则无需重复记录；
+  // 若 `seek` 跳过了一段未索引的区间，则交给惰性补齐处理。
+  if (position == indexed_until + 1) {
+    if (c == '\n') {
+      line_offsets.push_back(position);
+    }
+    indexed_until = position;
+  }
+}
+
+void SourceTracker::advance_bytes(size_t count) {
+  size_t end = std::min(position + count, input.size());
+  const char* data = input.data();
+
+  // NOTE: 行号增加区间内换行符的数量，列号则从最后一个换行符之后重新计数。
+  //       只要区间与已索引范围相接，每个换行符的位置同时写入行索引。
+  bool contiguous = position <= indexed_until;
+  size_t newlines = 0;
+  size_t line_start = position;
+  size_t cursor = position;
+  while (cursor < end) {
+    const void* hit = std::memchr(data + cursor, '\n', end - cursor);
+    if (hit == nullptr) {
+      break;
+    }
+    cursor = static_cast<size_t>(static_cast<const char*>(hit) - data) + 1;
+    if (contiguous && cursor > indexed_until) {
+      line_offsets.push_back(cursor);
+    }
+    line_start = cursor;
+    newlines++;
+  }
+
+  if (newlines > 0) {
+    line += newlines;
+    column = end - line_start + 1;
+  } else {
+    column += end - position;
+  }
+  position = end;
+  if (contiguous) {
+    indexed_until = std::max(indexed_until, end);
+  }
+}
+
+void SourceTracker::seek(size_t pos, size_t new_line, size_t new_column) {
+  position = std::min(pos, input.size());
+  line = new_line;
+  column = new_column;
 }
 
 SourceLocation SourceTracker::make_location(size_t start_line,
                                             size_t start_col) const {
   // 使用给定的起始位置和跟踪器当前的结束位置来创建一个 SourceLocation 对象
   // 这是从词法分析器中标记出 Token 范围的核心功能
-  return SourceLocation(filename, start_line, start_col, line, column);
+  return SourceLocation(file_id, start_line, start_col, line, column);
 }
 
-void SourceTracker::build_line_offsets() const {
-  // 如果已经构建过索引，直接返回
-  if (line_offsets_built) {
+void SourceTracker::extend_line_offsets(size_t until) const {
+  until = std::min(until, input.size());
+  if (until <= indexed_until) {
     return;
   }
 
-  line_offsets.clear();
-  line_offsets.push_back(0); // 第 1 行从索引 0 开始
-
-  // 遍历整个输入，记录每个换行符后的位置作为下一行的起始
-  for (size_t i = 0; i < input.size(); i++) {
+  // 只扫描 `advance` 尚未覆盖的部分，记录每个换行符后的位置作为下一行的起始
+  for (size_t i = indexed_until; i < until; i++) {
     if (input[i] == '\n') {
       line_offsets.push_back(i + 1);
     }
   }
 
-  line_offsets_built = true;
+  indexed_until = until;
 }
 
 std::string SourceTracker::get_source_line(size_t line_num) const {
+  return std::string(get_source_line_view(line_num));
+}
+
+std::string_view SourceTracker::get_source_line_view(size_t line_num) const {
   if (line_num == 0) {
-    return "";
+    return {};
   }
 
-  // --- 使用预构建的行索引表实现 O(1) 查找 ---
-  build_line_offsets(); // 惰性初始化
+  // --- 使用行索引表实现 O(1) 查找 ---
+  // 目标行及其结尾都必须被索引覆盖，必要时补齐（通常词法分析后已完整）。
+  if (line_num >= line_offsets.size()) {
+    extend_line_offsets(input.size());
+  }
 
   // 检查行号是否有效
   if (line_num > line_offsets.size()) {
-    return "";
+    return {};
   }
 
   // 获取该行的起始和结束位置
@@ -86,15 +185,84 @@ std::string SourceTracker::get_source_line(size_t line_num) const {
     line_end = input.size();
   }
 
-  // 边界检查：确保不会越界
-  if (line_start > input.size()) {
-    return "";
+  return std::string_view(input.data() + line_start, line_end - line_start);
+}
+
+LineColumn SourceTracker::offset_to_line_column(size_t offset) const {
+  offset = std::min(offset, input.size());
+  extend_line_offsets(offset);
+
+  // 找到最后一个起始位置不大于 offset 的行。line_offsets[0] == 0，
+  // 因此 upper_bound 的结果至少是第二个元素。
+  auto it = std::upper_bound(line_offsets.begin(), line_offsets.end(), offset);
+  size_t line_index = static_cast<size_t>(it - line_offsets.begin()) - 1;
+
+  return {line_index + 1, offset - line_offsets[line_index] + 1};
+}
+
+void SourceTracker::resolve_offsets(const std::vector<size_t>& offsets,
+                                    std::vector<ResolvedOffset>& out) const {
+  out.clear();
+  out.reserve(offsets.size());
+  if (offsets.empty()) {
+    return;
   }
-  if (line_end > input.size()) {
-    line_end = input.size();
+  extend_line_offsets(input.size());
+
+  size_t line_index = 0;
+  // 当前行中已统计过字符的前缀 [line_offsets[line_index], counted_until)
+  // 及其字符数
+  size_t counted_until = 0;
+  size_t counted_chars = 0;
+  for (size_t raw_offset : offsets) {
+    size_t offset = std::min(raw_offset, input.size());
+
+    size_t previous_line = line_index;
+    if (offset < line_offsets[line_index]) {
+      // 偏移不是升序：从头查找。
+      line_index = 0;
+    }
+    size_t steps = 0;
+    while (line_index + 1 < line_offsets.size() &&
+           line_offsets[line_index + 1] <= offset) {
+      if (++steps > MAX_LINEAR_LINE_STEPS) {
+        auto it = std::upper_bound(line_offsets.begin() + line_index + 1,
+                                   line_offsets.end(), offset);
+        line_index = static_cast<size_t>(it - line_offsets.begin()) - 1;
+        break;
+      }
+      ++line_index;
+    }
+
+    size_t line_start = line_offsets[line_index];
+    if (line_index != previous_line || offset < counted_until) {
+      counted_until = line_start;
+      counted_chars = 0;
+    }
+    counted_chars += count_utf8_chars(
+        input.substr(counted_until, offset - counted_until));
+    counted_until = offset;
+
+    size_t line_end = line_index + 1 < line_offsets.size()
+                          ? line_offsets[line_index + 1] - 1
+                          : input.size();
+    out.push_back({line_index + 1, offset - line_start + 1, counted_chars + 1,
+                   input.substr(line_start, line_end - line_start)});
   }
+}
 
-  return std::string(input.begin() + line_start, input.begin() + line_end);
+size_t SourceTracker::line_column_to_offset(size_t line_num,
+                                            size_t column_num) const {
+  extend_line_offsets(input.size());
+  if (line_num == 0 || line_num > line_offsets.size()) {
+    return input.size();
+  }
+  size_t line_start = line_offsets[line_num - 1];
+  size_t line_end = line_num < line_offsets.size()
+                        ? line_offsets[line_num] - 1
+                        : input.size();
+  size_t column_offset = column_num > 0 ? column_num - 1 : 0;
+  return std::min(line_start + column_offset, line_end);
 }
 
-} // namespace czc::utils
\ No newline at end of file
+} // namespace czc::utils
@@ -0,0 +1,94 @@
+/**
+ * @file string_interner.cpp
+ * @brief `StringInterner` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/string_interner.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace czc::utils {
+
+namespace {
+
+constexpr uint32_t SHARD_MASK = StringInterner::SHARD_COUNT - 1;
+
+// 分片内序号的上限，保证编号不会与 `Symbol::INVALID_ID` 冲突。
+constexpr uint32_t MAX_LOCAL_INDEX =
+    (Symbol::INVALID_ID >> StringInterner::SHARD_BITS) - 1;
+
+} // namespace
+
+InternedString StringInterner::intern(std::string_view text) {
+  size_t hash = std::hash<std::string_view>()(text);
+  // NOTE: 分片用哈希的高位选取，低位留给分片内的哈希表分桶。
+  auto shard_index =
+      static_cast<uint32_t>(hash >> (sizeof(size_t) * 8 - SHARD_BITS));
+  Shard& shard = shards[shard_index];
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(text);
+  if (it != shard.index.end()) {
+    return {Symbol((it->second << SHARD_BITS) | shard_index), it->first};
+  }
+
+  if (shard.strings.size() > MAX_LOCAL_INDEX) {
+    throw std::length_error("StringInterner: too many strings");
+  }
+
+  std::string_view stored;
+  if (!text.empty()) {
+    auto* memory = static_cast<char*>(shard.storage.allocate(text.size(), 1));
+    std::memcpy(memory, text.data(), text.size());
+    stored = std::string_view(memory, text.size());
+  }
+
+  auto local = static_cast<uint32_t>(shard.strings.size());
+  shard.strings.push_back(stored);
+  shard.index.emplace(stored, local);
+  return {Symbol((local << SHARD_BITS) | shard_index), stored};
+}
+
+std::string_view StringInterner::get_string(Symbol symbol) const {
+  if (!symbol.is_valid()) {
+    return {};
+  }
+  const Shard& shard = shards[symbol.get_id() & SHARD_MASK];
+  uint32_t local = symbol.get_id() >> SHARD_BITS;
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (local >= shard.strings.size()) {
+    return {};
+  }
+  return shard.strings[local];
+}
+
+size_t StringInterner::size() const {
+  size_t total = 0;
+  for (const auto& shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    total += shard.strings.size();
+  }
+  return total;
+}
+
+size_t StringInterner::get_memory_bytes() const {
+  size_t total = 0;
+  for (const auto& shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    total += shard.storage.get_bytes_used();
+    total += shard.strings.capacity() * sizeof(std::string_view);
+    // NOTE: 每个哈希表元素是一个单独分配的节点（键值对加一个后继指针），
+    //       外加每个桶一个指针。
+    total += shard.index.bucket_count() * sizeof(void*) +
+             shard.index.size() *
+                 (sizeof(std::pair<const std::string_view, uint32_t>) +
+                  sizeof(void*));
+  }
+  return total;
+}
+
+} // namespace czc::utils
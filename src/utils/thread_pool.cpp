@@ -0,0 +1,60 @@
+/**
+ * @file thread_pool.cpp
+ * @brief `ThreadPool` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/thread_pool.hpp"
+
+namespace czc::utils {
+
+ThreadPool::ThreadPool(size_t thread_count) {
+  if (thread_count == 0) {
+    thread_count = default_thread_count();
+  }
+
+  workers.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    workers.emplace_back([this]() { worker_loop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::default_thread_count() noexcept {
+  // NOTE: hardware_concurrency 在无法检测时返回 0。
+  unsigned int count = std::thread::hardware_concurrency();
+  return count == 0 ? 1 : static_cast<size_t>(count);
+}
+
+void ThreadPool::worker_loop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+      // 停止后仍需把队列中剩余的任务执行完，避免对应的 future 永远等待。
+      if (stopping && tasks.empty()) {
+        return;
+      }
+
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+    task();
+  }
+}
+
+} // namespace czc::utils
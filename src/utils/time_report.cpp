@@ -0,0 +1,258 @@
+/**
+ * @file time_report.cpp
+ * @brief `TimeReport` 类的功能实现。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/time_report.hpp"
+
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace czc::utils {
+
+namespace {
+
+const char* const METRIC_NAMES[METRIC_COUNT] = {"tokens", "cst_nodes",
+                                                "ast_nodes", "errors"};
+
+double to_milliseconds(uint64_t nanoseconds) {
+  return static_cast<double>(nanoseconds) / 1e6;
+}
+
+/**
+ * @brief 一个已结束的追踪事件。
+ */
+struct TraceEvent {
+  const char* name;
+  const char* category;
+  uint32_t thread;
+  // 相对 `TRACE_EPOCH` 的起点与持续时间（纳秒）
+  uint64_t start;
+  uint64_t duration;
+  std::string file;
+};
+
+// 追踪事件的时间零点，取进程启动（静态初始化）的时刻。
+const auto TRACE_EPOCH = std::chrono::steady_clock::now();
+
+std::mutex trace_mutex;
+std::vector<TraceEvent> trace_events;
+// 出现过事件的线程数，线程按第一次记录事件的顺序编号。
+uint32_t trace_thread_count = 0;
+
+// 当前线程在追踪中的编号，第一次记录事件时分配。
+thread_local uint32_t thread_index = UINT32_MAX;
+// 当前线程正在处理的文件名。
+thread_local std::string thread_file;
+
+uint64_t since_epoch(std::chrono::steady_clock::time_point time) {
+  if (time < TRACE_EPOCH) {
+    return 0;
+  }
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(time - TRACE_EPOCH)
+          .count());
+}
+
+// 以微秒输出，保留纳秒精度（Trace Event 的 `ts` / `dur` 以微秒为单位）。
+void append_microseconds(std::string& out, uint64_t nanoseconds) {
+  out += std::to_string(nanoseconds / 1000);
+  out += '.';
+  std::string fraction = std::to_string(nanoseconds % 1000);
+  out.append(3 - fraction.size(), '0');
+  out += fraction;
+}
+
+} // namespace
+
+void TimeReport::add_call(Phase phase, uint64_t nanoseconds,
+                          uint64_t allocation_count) noexcept {
+  PhaseSlot& slot = slots[static_cast<size_t>(phase)];
+  slot.calls.fetch_add(1, std::memory_order_relaxed);
+  slot.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+  slot.allocations.fetch_add(allocation_count, std::memory_order_relaxed);
+}
+
+void TimeReport::add(Phase phase, Metric metric, uint64_t value) noexcept {
+  slots[static_cast<size_t>(phase)]
+      .metrics[static_cast<size_t>(metric)]
+      .fetch_add(value, std::memory_order_relaxed);
+}
+
+PhaseStats TimeReport::get(Phase phase) noexcept {
+  const PhaseSlot& slot = slots[static_cast<size_t>(phase)];
+  PhaseStats stats;
+  stats.calls = slot.calls.load(std::memory_order_relaxed);
+  stats.nanoseconds = slot.nanoseconds.load(std::memory_order_relaxed);
+  stats.allocations = slot.allocations.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < METRIC_COUNT; ++i) {
+    stats.metrics[i] = slot.metrics[i].load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void TimeReport::add_trace_event(const char* name, const char* category,
+                                 std::chrono::steady_clock::time_point start,
+                                 std::chrono::steady_clock::time_point end) {
+  uint64_t begin = since_epoch(start);
+  uint64_t finish = since_epoch(end);
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  if (thread_index == UINT32_MAX) {
+    thread_index = trace_thread_count++;
+  }
+  trace_events.push_back({name, category, thread_index, begin,
+                          finish > begin ? finish - begin : 0, thread_file});
+}
+
+void TimeReport::set_thread_file(std::string_view filename) {
+  thread_file.assign(filename.data(), filename.size());
+}
+
+std::string_view TimeReport::get_thread_file() noexcept {
+  return thread_file;
+}
+
+size_t TimeReport::trace_event_count() {
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  return trace_events.size();
+}
+
+void TimeReport::write_trace(std::ostream& os) {
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (uint32_t thread = 0; thread < trace_thread_count; ++thread) {
+    out += thread == 0 ? "\n" : ",\n";
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+    out += std::to_string(thread);
+    out += ",\"args\":{\"name\":\"thread ";
+    out += std::to_string(thread);
+    out += "\"}}";
+  }
+  for (const TraceEvent& event : trace_events) {
+    out += ",\n{\"name\":";
+    append_json_string(out, event.name);
+    out += ",\"cat\":";
+    append_json_string(out, event.category);
+    out += ",\"ph\":\"X\",\"pid\":1,\"tid\":";
+    out += std::to_string(event.thread);
+    out += ",\"ts\":";
+    append_microseconds(out, event.start);
+    out += ",\"dur\":";
+    append_microseconds(out, event.duration);
+    if (!event.file.empty()) {
+      out += ",\"args\":{\"file\":";
+      append_json_string(out, event.file);
+      out += '}';
+    }
+    out += '}';
+  }
+  out += "\n]}\n";
+  os << out;
+}
+
+void TimeReport::reset() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    trace_events.clear();
+  }
+  allocations.store(0, std::memory_order_relaxed);
+  for (auto& slot : slots) {
+    slot.calls.store(0, std::memory_order_relaxed);
+    slot.nanoseconds.store(0, std::memory_order_relaxed);
+    slot.allocations.store(0, std::memory_order_relaxed);
+    for (auto& metric : slot.metrics) {
+      metric.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+const char* TimeReport::phase_name(Phase phase) noexcept {
+  switch (phase) {
+  case Phase::Lex:
+    return "lex";
+  case Phase::Preprocess:
+    return "preprocess";
+  case Phase::Parse:
+    return "parse";
+  case Phase::BuildAST:
+    return "build-ast";
+  case Phase::Format:
+    return "format";
+  }
+  return "unknown";
+}
+
+void TimeReport::print_table(std::ostream& os) {
+  const auto flags = os.flags();
+  const auto precision = os.precision();
+
+  os << std::left << std::setw(12) << "phase" << std::right << std::setw(8)
+     << "calls" << std::setw(12) << "time (ms)" << std::setw(12) << "allocs";
+  for (const char* name : METRIC_NAMES) {
+    os << std::setw(12) << name;
+  }
+  os << "\n";
+
+  PhaseStats total;
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    auto phase = static_cast<Phase>(i);
+    PhaseStats stats = get(phase);
+    if (stats.calls == 0) {
+      continue;
+    }
+    os << std::left << std::setw(12) << phase_name(phase) << std::right
+       << std::setw(8) << stats.calls << std::setw(12) << std::fixed
+       << std::setprecision(3) << to_milliseconds(stats.nanoseconds)
+       << std::setw(12) << stats.allocations;
+    for (uint64_t value : stats.metrics) {
+      os << std::setw(12) << value;
+    }
+    os << "\n";
+
+    total.calls += stats.calls;
+    total.nanoseconds += stats.nanoseconds;
+    total.allocations += stats.allocations;
+    for (size_t m = 0; m < METRIC_COUNT; ++m) {
+      total.metrics[m] += stats.metrics[m];
+    }
+  }
+
+  os << std::left << std::setw(12) << "total" << std::right << std::setw(8)
+     << total.calls << std::setw(12) << std::fixed << std::setprecision(3)
+     << to_milliseconds(total.nanoseconds) << std::setw(12)
+     << total.allocations;
+  for (uint64_t value : total.metrics) {
+    os << std::setw(12) << value;
+  }
+  os << "\n";
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+JsonValue TimeReport::to_json() {
+  JsonValue phases = JsonValue::object();
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    auto phase = static_cast<Phase>(i);
+    PhaseStats stats = get(phase);
+    JsonValue entry = JsonValue::object();
+    entry.set("calls", stats.calls);
+    entry.set("time_ms", to_milliseconds(stats.nanoseconds));
+    entry.set("allocations", stats.allocations);
+    for (size_t m = 0; m < METRIC_COUNT; ++m) {
+      entry.set(METRIC_NAMES[m], stats.metrics[m]);
+    }
+    phases.set(phase_name(phase), std::move(entry));
+  }
+
+  JsonValue report = JsonValue::object();
+  report.set("phases", std::move(phases));
+  report.set("allocations", get_allocations());
+  return report;
+}
+
+} // namespace czc::utils
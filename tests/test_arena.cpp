@@ -0,0 +1,192 @@
+/**
+ * @file test_arena.cpp
+ * @brief 块式线性分配器与 Arena 模式 CST 的测试。
+ * @details 覆盖 `Arena` 的对齐、块增长与跨实例的块复用，`ArenaAllocator`
+ *          与标准容器的配合，以及 Parser 在 Arena 模式下产生与堆模式
+ *          一致的 CST。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/utils/arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace czc;
+using namespace czc::cst;
+using namespace czc::lexer;
+using namespace czc::parser;
+using namespace czc::utils;
+
+// --- Arena 测试 ---
+
+/**
+ * @brief 测试分配结果满足对齐要求且互不重叠。
+ */
+TEST(ArenaTest, AllocationsAreAlignedAndDisjoint) {
+  Arena arena(256);
+  std::vector<std::pair<uintptr_t, size_t>> ranges;
+  for (size_t i = 1; i <= 200; ++i) {
+    size_t align = size_t{1} << (i % 5);
+    void* ptr = arena.allocate(i % 37 + 1, align);
+    auto address = reinterpret_cast<uintptr_t>(ptr);
+    EXPECT_EQ(address % align, 0u);
+    ranges.emplace_back(address, i % 37 + 1);
+  }
+
+  std::sort(ranges.begin(), ranges.end());
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    EXPECT_GE(ranges[i].first, ranges[i - 1].first + ranges[i - 1].second);
+  }
+}
+
+/**
+ * @brief 测试块按需申请、大对象单独占块，以及 reset 后回到初始状态。
+ */
+TEST(ArenaTest, GrowsByBlocksAndResets) {
+  Arena arena(128);
+  EXPECT_EQ(arena.get_block_count(), 0u);
+
+  (void)arena.allocate(64);
+  EXPECT_EQ(arena.get_block_count(), 1u);
+
+  // 超过下一个常规块大小的对象单独占一个块。
+  (void)arena.allocate(4096);
+  EXPECT_EQ(arena.get_block_count(), 2u);
+  EXPECT_EQ(arena.get_bytes_used(), 64u + 4096u);
+
+  arena.reset();
+  EXPECT_EQ(arena.get_block_count(), 0u);
+  EXPECT_EQ(arena.get_bytes_used(), 0u);
+}
+
+/**
+ * @brief 测试释放的常规块留在线程缓存中，供之后的 Arena 直接复用。
+ */
+TEST(ArenaTest, ReusesCachedBlocksAcrossArenas) {
+  void* first = nullptr;
+  size_t cached = 0;
+  {
+    Arena arena(1024);
+    first = arena.allocate(64);
+    cached = Arena::get_cached_bytes();
+  }
+  EXPECT_EQ(Arena::get_cached_bytes(), cached + 1024);
+
+  Arena arena(1024);
+  EXPECT_EQ(arena.allocate(64), first);
+  EXPECT_EQ(Arena::get_cached_bytes(), cached);
+
+  // 单独占块的大对象不进入缓存。
+  size_t before = Arena::get_cached_bytes();
+  {
+    Arena large(1024);
+    (void)large.allocate(1 << 20);
+  }
+  EXPECT_EQ(Arena::get_cached_bytes(), before);
+}
+
+/**
+ * @brief 测试 ArenaAllocator 用于 std::vector，未绑定 Arena 时退回全局堆。
+ */
+TEST(ArenaTest, AllocatorBacksStandardContainers) {
+  Arena arena;
+  std::vector<int, ArenaAllocator<int>> in_arena{ArenaAllocator<int>(&arena)};
+  std::vector<int, ArenaAllocator<int>> on_heap;
+  for (int i = 0; i < 1000; ++i) {
+    in_arena.push_back(i);
+    on_heap.push_back(i);
+  }
+  EXPECT_EQ(in_arena, on_heap);
+  EXPECT_GT(arena.get_bytes_used(), 1000 * sizeof(int));
+}
+
+// --- Arena 模式 CST 测试 ---
+
+/**
+ * @brief 递归比较两棵 CST 的结构与 Token 内容。
+ */
+static void expect_same_cst(const CSTNode* a, const CSTNode* b) {
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(a->get_type(), b->get_type());
+  EXPECT_EQ(a->get_location().line, b->get_location().line);
+  EXPECT_EQ(a->get_location().column, b->get_location().column);
+  ASSERT_EQ(a->get_token().has_value(), b->get_token().has_value());
+  if (a->get_token().has_value()) {
+    EXPECT_EQ(a->get_token()->token_type, b->get_token()->token_type);
+    EXPECT_EQ(a->get_token()->value, b->get_token()->value);
+  }
+  ASSERT_EQ(a->get_children().size(), b->get_children().size());
+  for (size_t i = 0; i < a->get_children().size(); ++i) {
+    expect_same_cst(a->get_children()[i].get(), b->get_children()[i].get());
+  }
+}
+
+/**
+ * @brief 测试 Arena 模式与堆模式产生相同的 CST，且节点确实落在 Arena 中。
+ */
+TEST(ArenaCSTTest, ArenaParseMatchesHeapParse) {
+  std::string source = R"(
+    // 注释
+    struct Point { x: Integer, y: Integer };
+    fn distance(a: Point, b: Point) -> Float {
+      let dx = a.x - b.x;
+      let dy = a.y - b.y;
+      if dx > dy { return dx * dx; } else { return dy * dy; }
+    }
+    let values: Integer[3] = [1, 2, 3];
+    let message = "a long string literal that does not fit in SSO";
+  )";
+
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  Parser heap_parser(tokens);
+  auto heap_tree = heap_parser.parse();
+
+  Parser arena_parser(tokens);
+  arena_parser.set_arena_enabled(true);
+  auto arena_tree = arena_parser.parse();
+
+  EXPECT_FALSE(arena_parser.has_errors());
+  EXPECT_EQ(heap_parser.get_errors().size(), arena_parser.get_errors().size());
+  expect_same_cst(heap_tree.get(), arena_tree.get());
+
+  auto* root = dynamic_cast<CSTArenaRoot*>(arena_tree.get());
+  ASSERT_NE(root, nullptr);
+  EXPECT_GT(root->get_arena().get_bytes_used(), 0u);
+  EXPECT_EQ(dynamic_cast<CSTArenaRoot*>(heap_tree.get()), nullptr);
+
+  // 解析结束后不应残留活动的 Arena 作用域。
+  EXPECT_EQ(CSTArenaScope::get_active_arena(), nullptr);
+}
+
+/**
+ * @brief 测试 Arena 作用域可以嵌套，并在析构时恢复外层作用域。
+ */
+TEST(ArenaCSTTest, ScopesNestAndRestore) {
+  Arena outer;
+  Arena inner;
+  {
+    CSTArenaScope outer_scope(outer);
+    EXPECT_EQ(CSTArenaScope::get_active_arena(), &outer);
+    {
+      CSTArenaScope inner_scope(inner);
+      EXPECT_EQ(CSTArenaScope::get_active_arena(), &inner);
+      auto node = make_cst_node(CSTNodeType::Identifier,
+                                SourceLocation("", 1, 1));
+      EXPECT_GT(inner.get_bytes_used(), 0u);
+    }
+    EXPECT_EQ(CSTArenaScope::get_active_arena(), &outer);
+  }
+  EXPECT_EQ(CSTArenaScope::get_active_arena(), nullptr);
+  EXPECT_EQ(outer.get_bytes_used(), 0u);
+}
@@ -7,14 +7,20 @@
  */
 
 #include "czc/ast/ast_builder.hpp"
+#include "czc/ast/ast_context.hpp"
 #include "czc/ast/ast_node.hpp"
 #include "czc/ast/ast_visitor.hpp"
+#include "czc/ast/ast_walker.hpp"
 #include "czc/cst/cst_node.hpp"
 #include "czc/lexer/lexer.hpp"
 #include "czc/parser/parser.hpp"
+#include "czc/utils/thread_pool.hpp"
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 using namespace czc;
 using namespace czc::ast;
 using namespace czc::cst;
@@ -27,6 +33,9 @@ using namespace czc::utils;
  */
 class ASTTest : public ::testing::Test {
 protected:
+  // 持有测试中创建的全部 AST 节点。
+  ASTContext context;
+
   /**
    * @brief 创建测试用的源码位置
    */
@@ -53,17 +62,17 @@ TEST_F(ASTTest, BasicNodeCreation) {
   auto loc = make_test_location();
 
   // 测试 Program 节点
-  auto program = std::make_shared<Program>(loc);
+  auto program = context.create<Program>(loc);
   EXPECT_EQ(program->get_kind(), ASTNodeKind::Program);
   EXPECT_EQ(program->get_declarations().size(), 0);
 
   // 测试 Identifier 节点
-  auto identifier = std::make_shared<Identifier>("test_var", loc);
+  auto identifier = context.create<Identifier>(context.intern("test_var"), loc);
   EXPECT_EQ(identifier->get_kind(), ASTNodeKind::Identifier);
   EXPECT_EQ(identifier->get_name(), "test_var");
 
   // 测试 IntegerLiteral 节点
-  auto int_lit = std::make_shared<IntegerLiteral>(42, loc);
+  auto int_lit = context.create<IntegerLiteral>(42, loc);
   EXPECT_EQ(int_lit->get_kind(), ASTNodeKind::IntegerLiteral);
   EXPECT_EQ(int_lit->get_value(), 42);
 }
@@ -75,10 +84,10 @@ TEST_F(ASTTest, BasicNodeCreation) {
 TEST_F(ASTTest, BinaryOpCreation) {
   auto loc = make_test_location();
 
-  auto left = std::make_shared<IntegerLiteral>(10, loc);
-  auto right = std::make_shared<IntegerLiteral>(20, loc);
+  auto left = context.create<IntegerLiteral>(10, loc);
+  auto right = context.create<IntegerLiteral>(20, loc);
   auto binary_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Add, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Add, left, right, loc);
 
   EXPECT_EQ(binary_op->get_kind(), ASTNodeKind::BinaryOp);
   EXPECT_EQ(binary_op->get_operator(), BinaryOperator::Add);
@@ -93,12 +102,12 @@ TEST_F(ASTTest, BinaryOpCreation) {
 TEST_F(ASTTest, BlockStmtCreation) {
   auto loc = make_test_location();
 
-  auto block = std::make_shared<BlockStmt>(loc);
+  auto block = context.create<BlockStmt>(loc);
   EXPECT_EQ(block->get_kind(), ASTNodeKind::BlockStmt);
   EXPECT_EQ(block->get_statements().size(), 0);
 
   // 添加语句（这里用 ExprStmt 作为占位符，实际需要实现 ExprStmt）
-  // auto stmt = std::make_shared<ExprStmt>(...);
+  // auto stmt = context.create<ExprStmt>(...);
   // block->add_statement(stmt);
   // EXPECT_EQ(block->get_statements().size(), 1);
 }
@@ -114,7 +123,7 @@ TEST_F(ASTTest, ASTBuilderBasic) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
@@ -132,7 +141,7 @@ TEST_F(ASTTest, ASTBuilderWithIntegerLiteral) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
@@ -144,7 +153,7 @@ TEST_F(ASTTest, ASTBuilderWithIntegerLiteral) {
   ASSERT_NE(decl, nullptr);
   EXPECT_EQ(decl->get_kind(), ASTNodeKind::VarDecl);
 
-  auto var_decl = std::dynamic_pointer_cast<VarDecl>(decl);
+  auto var_decl = dynamic_cast<VarDecl*>(decl);
   ASSERT_NE(var_decl, nullptr);
   EXPECT_EQ(var_decl->get_name(), "x");
 
@@ -153,11 +162,40 @@ TEST_F(ASTTest, ASTBuilderWithIntegerLiteral) {
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::IntegerLiteral);
 
-  auto int_lit = std::dynamic_pointer_cast<IntegerLiteral>(init);
+  auto int_lit = dynamic_cast<IntegerLiteral*>(init);
   ASSERT_NE(int_lit, nullptr);
   EXPECT_EQ(int_lit->get_value(), 42);
 }
 
+/**
+ * @test ASTBuilderWithDecodedLiterals
+ * @brief 测试 AST Builder 使用 Lexer 解码的进制前缀与浮点数字面量
+ */
+TEST_F(ASTTest, ASTBuilderWithDecodedLiterals) {
+  auto cst = parse("let a = 0xFF; let b = 0b101; let c = 0.25;");
+  ASSERT_NE(cst, nullptr);
+
+  ASTBuilder builder(context);
+  auto ast = builder.build(cst.get());
+  ASSERT_NE(ast, nullptr);
+  ASSERT_EQ(ast->get_declarations().size(), 3);
+
+  auto initializer = [&](size_t index) {
+    auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[index]);
+    EXPECT_NE(var_decl, nullptr);
+    return var_decl ? var_decl->get_initializer() : nullptr;
+  };
+  auto hex = dynamic_cast<IntegerLiteral*>(initializer(0));
+  ASSERT_NE(hex, nullptr);
+  EXPECT_EQ(hex->get_value(), 255);
+  auto binary = dynamic_cast<IntegerLiteral*>(initializer(1));
+  ASSERT_NE(binary, nullptr);
+  EXPECT_EQ(binary->get_value(), 5);
+  auto fraction = dynamic_cast<FloatLiteral*>(initializer(2));
+  ASSERT_NE(fraction, nullptr);
+  EXPECT_DOUBLE_EQ(fraction->get_value(), 0.25);
+}
+
 /**
  * @test ASTBuilderWithBinaryExpr
  * @brief 测试 AST Builder 解析二元表达式
@@ -168,21 +206,20 @@ TEST_F(ASTTest, ASTBuilderWithBinaryExpr) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   auto init = var_decl->get_initializer();
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::BinaryOp);
 
-  auto binary_expr = std::dynamic_pointer_cast<BinaryOpExpr>(init);
+  auto binary_expr = dynamic_cast<BinaryOpExpr*>(init);
   ASSERT_NE(binary_expr, nullptr);
   EXPECT_EQ(binary_expr->get_operator(), BinaryOperator::Add);
 
@@ -190,14 +227,14 @@ TEST_F(ASTTest, ASTBuilderWithBinaryExpr) {
   auto left = binary_expr->get_left();
   ASSERT_NE(left, nullptr);
   EXPECT_EQ(left->get_kind(), ASTNodeKind::IntegerLiteral);
-  auto left_lit = std::dynamic_pointer_cast<IntegerLiteral>(left);
+  auto left_lit = dynamic_cast<IntegerLiteral*>(left);
   EXPECT_EQ(left_lit->get_value(), 10);
 
   // 验证右操作数
   auto right = binary_expr->get_right();
   ASSERT_NE(right, nullptr);
   EXPECT_EQ(right->get_kind(), ASTNodeKind::IntegerLiteral);
-  auto right_lit = std::dynamic_pointer_cast<IntegerLiteral>(right);
+  auto right_lit = dynamic_cast<IntegerLiteral*>(right);
   EXPECT_EQ(right_lit->get_value(), 20);
 }
 
@@ -211,21 +248,20 @@ TEST_F(ASTTest, ASTBuilderWithUnaryExpr) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   auto init = var_decl->get_initializer();
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::UnaryOp);
 
-  auto unary_expr = std::dynamic_pointer_cast<UnaryOpExpr>(init);
+  auto unary_expr = dynamic_cast<UnaryOpExpr*>(init);
   ASSERT_NE(unary_expr, nullptr);
   EXPECT_EQ(unary_expr->get_operator(), UnaryOperator::Minus);
 
@@ -233,7 +269,7 @@ TEST_F(ASTTest, ASTBuilderWithUnaryExpr) {
   auto operand = unary_expr->get_operand();
   ASSERT_NE(operand, nullptr);
   EXPECT_EQ(operand->get_kind(), ASTNodeKind::IntegerLiteral);
-  auto int_lit = std::dynamic_pointer_cast<IntegerLiteral>(operand);
+  auto int_lit = dynamic_cast<IntegerLiteral*>(operand);
   EXPECT_EQ(int_lit->get_value(), 42);
 }
 
@@ -247,21 +283,20 @@ TEST_F(ASTTest, ASTBuilderWithFloatLiteral) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   auto init = var_decl->get_initializer();
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::FloatLiteral);
 
-  auto float_lit = std::dynamic_pointer_cast<FloatLiteral>(init);
+  auto float_lit = dynamic_cast<FloatLiteral*>(init);
   ASSERT_NE(float_lit, nullptr);
   EXPECT_DOUBLE_EQ(float_lit->get_value(), 3.14);
 }
@@ -276,25 +311,44 @@ TEST_F(ASTTest, ASTBuilderWithStringLiteral) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   auto init = var_decl->get_initializer();
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::StringLiteral);
 
-  auto str_lit = std::dynamic_pointer_cast<StringLiteral>(init);
+  auto str_lit = dynamic_cast<StringLiteral*>(init);
   ASSERT_NE(str_lit, nullptr);
   EXPECT_EQ(str_lit->get_value(), "Hello, World!");
 }
 
+/**
+ * @test ASTBuilderKeepsEscapedStringValue
+ * @brief 测试字符串字面量的值即 Lexer 处理转义后的结果，不再去掉引号
+ */
+TEST_F(ASTTest, ASTBuilderKeepsEscapedStringValue) {
+  auto cst = parse("let quoted = \"\\\"a\\\"\\u{4E2D}\";");
+  ASSERT_NE(cst, nullptr);
+
+  ASTBuilder builder(context);
+  auto ast = builder.build(cst.get());
+  ASSERT_NE(ast, nullptr);
+  ASSERT_EQ(ast->get_declarations().size(), 1);
+
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
+  ASSERT_NE(var_decl, nullptr);
+  auto str_lit = dynamic_cast<StringLiteral*>(var_decl->get_initializer());
+  ASSERT_NE(str_lit, nullptr);
+  EXPECT_EQ(str_lit->get_value(), "\"a\"\xE4\xB8\xAD");
+}
+
 /**
  * @test ASTBuilderWithBooleanLiteral
  * @brief 测试 AST Builder 解析布尔字面量
@@ -305,21 +359,20 @@ TEST_F(ASTTest, ASTBuilderWithBooleanLiteral) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   auto init = var_decl->get_initializer();
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::BooleanLiteral);
 
-  auto bool_lit = std::dynamic_pointer_cast<BooleanLiteral>(init);
+  auto bool_lit = dynamic_cast<BooleanLiteral*>(init);
   ASSERT_NE(bool_lit, nullptr);
   EXPECT_TRUE(bool_lit->get_value());
 }
@@ -334,14 +387,13 @@ TEST_F(ASTTest, ASTBuilderComplexExpression) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
   EXPECT_EQ(var_decl->get_name(), "calc");
 
@@ -365,7 +417,7 @@ TEST_F(ASTTest, ASTBuilderWithSimpleFunction) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
@@ -376,7 +428,7 @@ TEST_F(ASTTest, ASTBuilderWithSimpleFunction) {
   ASSERT_NE(decl, nullptr);
   EXPECT_EQ(decl->get_kind(), ASTNodeKind::FunctionDecl);
 
-  auto func_decl = std::dynamic_pointer_cast<FunctionDecl>(decl);
+  auto func_decl = dynamic_cast<FunctionDecl*>(decl);
   ASSERT_NE(func_decl, nullptr);
   EXPECT_EQ(func_decl->get_name(), "add");
 
@@ -407,14 +459,13 @@ TEST_F(ASTTest, ASTBuilderWithNoParamFunction) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto func_decl =
-      std::dynamic_pointer_cast<FunctionDecl>(ast->get_declarations()[0]);
+  auto func_decl = dynamic_cast<FunctionDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(func_decl, nullptr);
   EXPECT_EQ(func_decl->get_name(), "hello");
 
@@ -443,14 +494,13 @@ TEST_F(ASTTest, ASTBuilderWithComplexFunction) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto func_decl =
-      std::dynamic_pointer_cast<FunctionDecl>(ast->get_declarations()[0]);
+  auto func_decl = dynamic_cast<FunctionDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(func_decl, nullptr);
   EXPECT_EQ(func_decl->get_name(), "calculate");
 
@@ -471,8 +521,7 @@ TEST_F(ASTTest, ASTBuilderWithComplexFunction) {
  * @brief 测试运算符解析
  */
 TEST_F(ASTTest, OperatorParsing) {
-  ASTBuilder builder;
-  auto loc = make_test_location();
+  ASTBuilder builder(context);
 
   // 测试二元运算符解析（这是 private 方法，暂时通过侧面测试）
   // 直接测试运算符枚举
@@ -505,9 +554,9 @@ TEST_F(ASTTest, NodeKindEnum) {
 TEST_F(ASTTest, LocationPreservation) {
   SourceLocation loc("test.zero", 42, 10);
 
-  auto identifier = std::make_shared<Identifier>("test", loc);
+  auto identifier = context.create<Identifier>(context.intern("test"), loc);
 
-  EXPECT_EQ(identifier->get_location().filename, "test.zero");
+  EXPECT_EQ(identifier->get_location().get_filename(), "test.zero");
   EXPECT_EQ(identifier->get_location().line, 42);
   EXPECT_EQ(identifier->get_location().column, 10);
 }
@@ -527,7 +576,7 @@ TEST_F(ASTTest, ASTBuilderWithSimpleStruct) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
@@ -538,7 +587,7 @@ TEST_F(ASTTest, ASTBuilderWithSimpleStruct) {
   ASSERT_NE(decl, nullptr);
   EXPECT_EQ(decl->get_kind(), ASTNodeKind::StructDecl);
 
-  auto struct_decl = std::dynamic_pointer_cast<StructDecl>(decl);
+  auto struct_decl = dynamic_cast<StructDecl*>(decl);
   ASSERT_NE(struct_decl, nullptr);
   EXPECT_EQ(struct_decl->get_name(), "Point");
 
@@ -563,14 +612,13 @@ TEST_F(ASTTest, ASTBuilderWithEmptyStruct) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto struct_decl =
-      std::dynamic_pointer_cast<StructDecl>(ast->get_declarations()[0]);
+  auto struct_decl = dynamic_cast<StructDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(struct_decl, nullptr);
   EXPECT_EQ(struct_decl->get_name(), "Empty");
 
@@ -595,14 +643,13 @@ TEST_F(ASTTest, ASTBuilderWithComplexStruct) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto struct_decl =
-      std::dynamic_pointer_cast<StructDecl>(ast->get_declarations()[0]);
+  auto struct_decl = dynamic_cast<StructDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(struct_decl, nullptr);
   EXPECT_EQ(struct_decl->get_name(), "Person");
 
@@ -634,14 +681,13 @@ TEST_F(ASTTest, ASTBuilderWithNestedTypes) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto func_decl =
-      std::dynamic_pointer_cast<FunctionDecl>(ast->get_declarations()[0]);
+  auto func_decl = dynamic_cast<FunctionDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(func_decl, nullptr);
   EXPECT_EQ(func_decl->get_name(), "process");
 
@@ -672,27 +718,24 @@ TEST_F(ASTTest, ASTBuilderWithMultipleDeclarations) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 3);
 
   // 验证第一个是变量声明
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
   EXPECT_EQ(var_decl->get_name(), "x");
 
   // 验证第二个是结构体声明
-  auto struct_decl =
-      std::dynamic_pointer_cast<StructDecl>(ast->get_declarations()[1]);
+  auto struct_decl = dynamic_cast<StructDecl*>(ast->get_declarations()[1]);
   ASSERT_NE(struct_decl, nullptr);
   EXPECT_EQ(struct_decl->get_name(), "Point");
 
   // 验证第三个是函数声明
-  auto func_decl =
-      std::dynamic_pointer_cast<FunctionDecl>(ast->get_declarations()[2]);
+  auto func_decl = dynamic_cast<FunctionDecl*>(ast->get_declarations()[2]);
   ASSERT_NE(func_decl, nullptr);
   EXPECT_EQ(func_decl->get_name(), "add");
 }
@@ -707,14 +750,13 @@ TEST_F(ASTTest, ASTBuilderWithNestedBinaryExpressions) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   // 验证有表达式树
@@ -737,14 +779,13 @@ TEST_F(ASTTest, ASTBuilderWithFunctionNoReturn) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto func_decl =
-      std::dynamic_pointer_cast<FunctionDecl>(ast->get_declarations()[0]);
+  auto func_decl = dynamic_cast<FunctionDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(func_decl, nullptr);
   EXPECT_EQ(func_decl->get_name(), "print_hello");
 
@@ -770,14 +811,13 @@ TEST_F(ASTTest, ASTBuilderWithStructTrailingComma) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto struct_decl =
-      std::dynamic_pointer_cast<StructDecl>(ast->get_declarations()[0]);
+  auto struct_decl = dynamic_cast<StructDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(struct_decl, nullptr);
   EXPECT_EQ(struct_decl->get_name(), "Data");
 
@@ -795,14 +835,13 @@ TEST_F(ASTTest, ASTBuilderWithParenExpr) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   // 验证初始化表达式是二元表达式
@@ -810,7 +849,7 @@ TEST_F(ASTTest, ASTBuilderWithParenExpr) {
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::BinaryOp);
 
-  auto binary = std::dynamic_pointer_cast<BinaryOpExpr>(init);
+  auto binary = dynamic_cast<BinaryOpExpr*>(init);
   ASSERT_NE(binary, nullptr);
   EXPECT_EQ(binary->get_operator(), BinaryOperator::Add);
 }
@@ -825,14 +864,13 @@ TEST_F(ASTTest, ASTBuilderWithCallExpr) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   // 验证初始化表达式是函数调用
@@ -840,7 +878,7 @@ TEST_F(ASTTest, ASTBuilderWithCallExpr) {
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::CallExpr);
 
-  auto call = std::dynamic_pointer_cast<CallExpr>(init);
+  auto call = dynamic_cast<CallExpr*>(init);
   ASSERT_NE(call, nullptr);
 
   // 验证被调用的函数是标识符
@@ -848,7 +886,7 @@ TEST_F(ASTTest, ASTBuilderWithCallExpr) {
   ASSERT_NE(callee, nullptr);
   EXPECT_EQ(callee->get_kind(), ASTNodeKind::Identifier);
 
-  auto func_name = std::dynamic_pointer_cast<Identifier>(callee);
+  auto func_name = dynamic_cast<Identifier*>(callee);
   EXPECT_EQ(func_name->get_name(), "add");
 
   // 验证参数数量
@@ -866,21 +904,20 @@ TEST_F(ASTTest, ASTBuilderWithNoArgCallExpr) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   auto init = var_decl->get_initializer();
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::CallExpr);
 
-  auto call = std::dynamic_pointer_cast<CallExpr>(init);
+  auto call = dynamic_cast<CallExpr*>(init);
   ASSERT_NE(call, nullptr);
 
   // 无参数
@@ -897,14 +934,13 @@ TEST_F(ASTTest, ASTBuilderWithIndexExpr) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   // 验证初始化表达式是索引访问
@@ -912,7 +948,7 @@ TEST_F(ASTTest, ASTBuilderWithIndexExpr) {
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::IndexExpr);
 
-  auto index_expr = std::dynamic_pointer_cast<IndexExpr>(init);
+  auto index_expr = dynamic_cast<IndexExpr*>(init);
   ASSERT_NE(index_expr, nullptr);
 
   // 验证对象是标识符
@@ -936,14 +972,13 @@ TEST_F(ASTTest, ASTBuilderWithMemberExpr) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   // 简单验证初始化表达式存在
@@ -962,14 +997,13 @@ TEST_F(ASTTest, ASTBuilderWithChainedMemberExpr) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   // 简单验证初始化表达式存在
@@ -988,14 +1022,13 @@ TEST_F(ASTTest, ASTBuilderWithComplexExpressionChain) {
   auto cst = parse(source);
   ASSERT_NE(cst, nullptr);
 
-  ASTBuilder builder;
+  ASTBuilder builder(context);
   auto ast = builder.build(cst.get());
 
   ASSERT_NE(ast, nullptr);
   ASSERT_EQ(ast->get_declarations().size(), 1);
 
-  auto var_decl =
-      std::dynamic_pointer_cast<VarDecl>(ast->get_declarations()[0]);
+  auto var_decl = dynamic_cast<VarDecl*>(ast->get_declarations()[0]);
   ASSERT_NE(var_decl, nullptr);
 
   // 最外层是成员访问 .value
@@ -1003,7 +1036,7 @@ TEST_F(ASTTest, ASTBuilderWithComplexExpressionChain) {
   ASSERT_NE(init, nullptr);
   EXPECT_EQ(init->get_kind(), ASTNodeKind::MemberExpr);
 
-  auto member = std::dynamic_pointer_cast<MemberExpr>(init);
+  auto member = dynamic_cast<MemberExpr*>(init);
   ASSERT_NE(member, nullptr);
   EXPECT_EQ(member->get_member(), "value");
 
@@ -1013,10 +1046,308 @@ TEST_F(ASTTest, ASTBuilderWithComplexExpressionChain) {
   EXPECT_EQ(index_expr->get_kind(), ASTNodeKind::IndexExpr);
 
   // 最内层是函数调用 get_array()
-  auto index = std::dynamic_pointer_cast<IndexExpr>(index_expr);
+  auto index = dynamic_cast<IndexExpr*>(index_expr);
   ASSERT_NE(index, nullptr);
 
   auto call = index->get_object();
   ASSERT_NE(call, nullptr);
   EXPECT_EQ(call->get_kind(), ASTNodeKind::CallExpr);
 }
+
+/**
+ * @test ContextOwnsNodesOfEveryBuild
+ * @brief 测试同一个 ASTContext 可以持有多次构建的结果
+ */
+TEST_F(ASTTest, ContextOwnsNodesOfEveryBuild) {
+  auto first_cst = parse("let x = 1 + 2;");
+  auto second_cst = parse("fn f() { return 3; }");
+  ASSERT_NE(first_cst, nullptr);
+  ASSERT_NE(second_cst, nullptr);
+
+  ASTBuilder builder(context);
+  auto first = builder.build(first_cst.get());
+  size_t after_first = context.get_node_count();
+  auto second = builder.build(second_cst.get());
+
+  EXPECT_GT(after_first, 0u);
+  EXPECT_GT(context.get_node_count(), after_first);
+  EXPECT_GT(context.get_arena().get_bytes_used(), 0u);
+
+  // 第二次构建不影响第一棵树
+  auto var_decl = dynamic_cast<VarDecl*>(first->get_declarations()[0]);
+  ASSERT_NE(var_decl, nullptr);
+  auto binary = dynamic_cast<BinaryOpExpr*>(var_decl->get_initializer());
+  ASSERT_NE(binary, nullptr);
+  EXPECT_EQ(binary->get_operator(), BinaryOperator::Add);
+
+  auto func_decl = dynamic_cast<FunctionDecl*>(second->get_declarations()[0]);
+  ASSERT_NE(func_decl, nullptr);
+  ASSERT_NE(func_decl->get_body(), nullptr);
+  EXPECT_EQ(func_decl->get_body()->get_statements().size(), 1);
+}
+
+/**
+ * @test ContextPoolsNodesByType
+ * @brief 测试同一类型的节点连续存放，并可以按创建顺序逐个扫描
+ */
+TEST_F(ASTTest, ContextPoolsNodesByType) {
+  auto cst = parse("let x = 1 + 2 * 3;\n"
+                   "let y = x - 4;\n");
+  ASSERT_NE(cst, nullptr);
+
+  ASTBuilder builder(context);
+  ASSERT_NE(builder.build(cst.get()), nullptr);
+
+  EXPECT_EQ(context.get_node_count<BinaryOpExpr>(), 3u);
+  EXPECT_EQ(context.get_node_count<IntegerLiteral>(), 4u);
+  EXPECT_EQ(context.get_node_count<StringLiteral>(), 0u);
+
+  std::vector<const BinaryOpExpr*> binaries;
+  context.for_each_node<BinaryOpExpr>(
+      [&binaries](const BinaryOpExpr& node) { binaries.push_back(&node); });
+  ASSERT_EQ(binaries.size(), 3u);
+  for (size_t i = 1; i < binaries.size(); ++i) {
+    EXPECT_EQ(reinterpret_cast<const char*>(binaries[i]) -
+                  reinterpret_cast<const char*>(binaries[i - 1]),
+              static_cast<std::ptrdiff_t>(sizeof(BinaryOpExpr)));
+  }
+  // 子表达式先于外层表达式构建
+  EXPECT_EQ(binaries[0]->get_operator(), BinaryOperator::Mul);
+  EXPECT_EQ(binaries[1]->get_operator(), BinaryOperator::Add);
+  EXPECT_EQ(binaries[2]->get_operator(), BinaryOperator::Sub);
+
+  int64_t sum = 0;
+  context.for_each_node<IntegerLiteral>(
+      [&sum](IntegerLiteral& node) { sum += node.get_value(); });
+  EXPECT_EQ(sum, 10);
+}
+
+/**
+ * @test ParallelBuildMatchesSerial
+ * @brief 测试并行构建的声明顺序与节点数与串行构建一致
+ */
+TEST_F(ASTTest, ParallelBuildMatchesSerial) {
+  std::string source;
+  for (int i = 0; i < 9; ++i) {
+    std::string n = std::to_string(i);
+    source += "let v" + n + " = " + n + " + 1;\n";
+    source += "fn f" + n + "(a) { return a; }\n";
+  }
+  auto cst = parse(source);
+  ASSERT_NE(cst, nullptr);
+
+  ASTBuilder serial_builder(context);
+  Program* serial = serial_builder.build(cst.get());
+  ASSERT_NE(serial, nullptr);
+
+  ASTContext parallel_context(context.get_interner());
+  ASTBuilder parallel_builder(parallel_context);
+  utils::ThreadPool pool(2);
+  Program* parallel = parallel_builder.build_parallel(cst.get(), pool, 1);
+  ASSERT_NE(parallel, nullptr);
+
+  const auto& expected = serial->get_declarations();
+  const auto& actual = parallel->get_declarations();
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(actual[i]->get_kind(), expected[i]->get_kind());
+    EXPECT_EQ(actual[i]->get_location().line,
+              expected[i]->get_location().line);
+  }
+  auto* first = dynamic_cast<VarDecl*>(actual[0]);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->get_name(), "v0");
+
+  // 各块上下文中的节点由最终的上下文接管，计数与扫描都包括它们。
+  EXPECT_EQ(parallel_context.get_node_count(), context.get_node_count());
+  EXPECT_EQ(parallel_context.get_node_count<BinaryOpExpr>(), 9u);
+  int64_t sum = 0;
+  parallel_context.for_each_node<IntegerLiteral>(
+      [&sum](const IntegerLiteral& node) { sum += node.get_value(); });
+  EXPECT_EQ(sum, 36 + 9);
+}
+
+/**
+ * @test DirectBuildMatchesCSTBuild
+ * @brief 测试直接从 Parser 构建的 AST 与先构建完整 CST 再转换的结果一致
+ */
+TEST_F(ASTTest, DirectBuildMatchesCSTBuild) {
+  std::string source = "// header\n"
+                       "let x = 1 + 2 * 3;\n"
+                       "struct Point { x: Integer, y: Integer }\n"
+                       "fn add(a, b) { let c = a + b; return c; }\n"
+                       "let = ;\n"
+                       "var y = add(x, 4)[0].value;\n";
+
+  auto cst = parse(source);
+  ASSERT_NE(cst, nullptr);
+  ASTContext cst_context;
+  ASTBuilder cst_builder(cst_context);
+  auto expected = cst_builder.build(cst.get());
+
+  Lexer lexer(source, "test.zero");
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  ASTBuilder builder(context);
+  auto actual = builder.build(parser);
+
+  ASSERT_NE(actual, nullptr);
+  EXPECT_TRUE(parser.has_errors());
+  EXPECT_EQ(context.get_node_count(), cst_context.get_node_count());
+  EXPECT_EQ(actual->get_location().line, expected->get_location().line);
+  ASSERT_EQ(actual->get_declarations().size(),
+            expected->get_declarations().size());
+
+  for (size_t i = 0; i < expected->get_declarations().size(); ++i) {
+    auto want = expected->get_declarations()[i];
+    auto got = actual->get_declarations()[i];
+    ASSERT_EQ(got->get_kind(), want->get_kind()) << "declaration " << i;
+    EXPECT_EQ(got->get_location().line, want->get_location().line);
+    EXPECT_EQ(got->get_location().column, want->get_location().column);
+
+    if (auto want_var = dynamic_cast<VarDecl*>(want)) {
+      auto got_var = static_cast<VarDecl*>(got);
+      EXPECT_EQ(got_var->get_name(), want_var->get_name());
+      ASSERT_EQ(got_var->get_initializer() == nullptr,
+                want_var->get_initializer() == nullptr);
+      if (want_var->get_initializer()) {
+        EXPECT_EQ(got_var->get_initializer()->get_kind(),
+                  want_var->get_initializer()->get_kind());
+      }
+    } else if (auto want_fn = dynamic_cast<FunctionDecl*>(want)) {
+      auto got_fn = static_cast<FunctionDecl*>(got);
+      EXPECT_EQ(got_fn->get_name(), want_fn->get_name());
+      EXPECT_EQ(got_fn->get_parameters().size(),
+                want_fn->get_parameters().size());
+      ASSERT_NE(got_fn->get_body(), nullptr);
+      EXPECT_EQ(got_fn->get_body()->get_statements().size(),
+                want_fn->get_body()->get_statements().size());
+    } else if (auto want_struct = dynamic_cast<StructDecl*>(want)) {
+      auto got_struct = static_cast<StructDecl*>(got);
+      EXPECT_EQ(got_struct->get_name(), want_struct->get_name());
+      EXPECT_EQ(got_struct->get_fields().size(),
+                want_struct->get_fields().size());
+    }
+  }
+}
+
+/**
+ * @brief 记录先序/后序回调的遍历器（测试用）
+ */
+class TraceWalker : public ASTWalker<TraceWalker> {
+public:
+  std::vector<std::string> trace;
+  bool skip_functions = false;
+
+  bool enter_function_decl(FunctionDecl* node) {
+    trace.push_back("enter fn " + std::string(node->get_name()));
+    return !skip_functions;
+  }
+  void leave_function_decl(FunctionDecl* node) {
+    trace.push_back("leave fn " + std::string(node->get_name()));
+  }
+  bool enter_binary_op(BinaryOpExpr*) {
+    trace.push_back("enter binary");
+    return true;
+  }
+  void leave_binary_op(BinaryOpExpr*) {
+    trace.push_back("leave binary");
+  }
+  bool enter_identifier(Identifier* node) {
+    trace.push_back(std::string(node->get_name()));
+    return true;
+  }
+};
+
+/**
+ * @brief 统计各类节点的虚函数访问者（测试用）
+ */
+class CountingVisitor : public ASTBaseVisitor {
+public:
+  int programs = 0;
+  int functions = 0;
+  int parameters = 0;
+  int identifiers = 0;
+  int calls = 0;
+
+  void visit_program(Program*) override {
+    ++programs;
+  }
+  void visit_function_decl(FunctionDecl*) override {
+    ++functions;
+  }
+  void visit_parameter(Parameter*) override {
+    ++parameters;
+  }
+  void visit_identifier(Identifier*) override {
+    ++identifiers;
+  }
+  void visit_call_expr(CallExpr*) override {
+    ++calls;
+  }
+};
+
+/**
+ * @test WalkerVisitsInPreAndPostOrder
+ * @brief 测试 ASTWalker 的先序/后序回调顺序
+ */
+TEST_F(ASTTest, WalkerVisitsInPreAndPostOrder) {
+  auto cst = parse("fn add(a, b) { return a + b; }");
+  ASSERT_NE(cst, nullptr);
+  ASTBuilder builder(context);
+  auto program = builder.build(cst.get());
+  ASSERT_NE(program, nullptr);
+
+  TraceWalker walker;
+  walker.walk(program);
+
+  std::vector<std::string> expected = {"enter fn add", "enter binary", "a",
+                                       "b", "leave binary", "leave fn add"};
+  EXPECT_EQ(walker.trace, expected);
+}
+
+/**
+ * @test WalkerSkipsChildrenWhenEnterReturnsFalse
+ * @brief 测试先序回调返回 false 时跳过子节点，但仍调用后序回调
+ */
+TEST_F(ASTTest, WalkerSkipsChildrenWhenEnterReturnsFalse) {
+  auto cst = parse("fn add(a, b) { return a + b; }");
+  ASSERT_NE(cst, nullptr);
+  ASTBuilder builder(context);
+  auto program = builder.build(cst.get());
+
+  TraceWalker walker;
+  walker.skip_functions = true;
+  walker.walk(program);
+
+  std::vector<std::string> expected = {"enter fn add", "leave fn add"};
+  EXPECT_EQ(walker.trace, expected);
+}
+
+/**
+ * @test VirtualVisitorAdapter
+ * @brief 测试 accept 的单节点分派与 walk 对虚函数访问者的整树遍历
+ */
+TEST_F(ASTTest, VirtualVisitorAdapter) {
+  auto cst = parse("fn add(a, b) { return a + b; }\n"
+                   "let x = add(1, y);");
+  ASSERT_NE(cst, nullptr);
+  ASTBuilder builder(context);
+  auto program = builder.build(cst.get());
+  ASSERT_NE(program, nullptr);
+
+  CountingVisitor single;
+  accept(program, single);
+  accept(nullptr, single);
+  EXPECT_EQ(single.programs, 1);
+  EXPECT_EQ(single.functions, 0);
+
+  CountingVisitor counter;
+  walk(program, counter);
+  EXPECT_EQ(counter.programs, 1);
+  EXPECT_EQ(counter.functions, 1);
+  EXPECT_EQ(counter.parameters, 2);
+  EXPECT_EQ(counter.calls, 1);
+  // a, b（函数体）以及 add、y（调用）。
+  EXPECT_EQ(counter.identifiers, 4);
+}
@@ -6,6 +6,7 @@
  * @date 2025-11-13
  */
 
+#include "czc/ast/ast_context.hpp"
 #include "czc/ast/ast_node.hpp"
 #include "czc/utils/source_location.hpp"
 
@@ -17,6 +18,9 @@ using namespace czc::utils;
 
 class ASTCoverageTest : public ::testing::Test {
 protected:
+  // Owns every AST node created by a test.
+  ASTContext context;
+
   SourceLocation make_test_location() {
     return SourceLocation("test.zero", 1, 1);
   }
@@ -28,11 +32,11 @@ protected:
  */
 TEST_F(ASTCoverageTest, FloatLiteralNode) {
   auto loc = make_test_location();
-  auto float_lit = std::make_shared<FloatLiteral>(3.14159, loc);
+  auto float_lit = context.create<FloatLiteral>(3.14159, loc);
 
   EXPECT_EQ(float_lit->get_kind(), ASTNodeKind::FloatLiteral);
   EXPECT_DOUBLE_EQ(float_lit->get_value(), 3.14159);
-  EXPECT_EQ(float_lit->get_location().filename, "test.zero");
+  EXPECT_EQ(float_lit->get_location().get_filename(), "test.zero");
 }
 
 /**
@@ -41,11 +45,12 @@ TEST_F(ASTCoverageTest, FloatLiteralNode) {
  */
 TEST_F(ASTCoverageTest, StringLiteralNode) {
   auto loc = make_test_location();
-  auto str_lit = std::make_shared<StringLiteral>("Hello, World!", loc);
+  auto str_lit = context.create<StringLiteral>(context.intern("Hello, World!"),
+                                               loc);
 
   EXPECT_EQ(str_lit->get_kind(), ASTNodeKind::StringLiteral);
   EXPECT_EQ(str_lit->get_value(), "Hello, World!");
-  EXPECT_EQ(str_lit->get_location().filename, "test.zero");
+  EXPECT_EQ(str_lit->get_location().get_filename(), "test.zero");
 }
 
 /**
@@ -55,11 +60,11 @@ TEST_F(ASTCoverageTest, StringLiteralNode) {
 TEST_F(ASTCoverageTest, BooleanLiteralNode) {
   auto loc = make_test_location();
 
-  auto bool_true = std::make_shared<BooleanLiteral>(true, loc);
+  auto bool_true = context.create<BooleanLiteral>(true, loc);
   EXPECT_EQ(bool_true->get_kind(), ASTNodeKind::BooleanLiteral);
   EXPECT_TRUE(bool_true->get_value());
 
-  auto bool_false = std::make_shared<BooleanLiteral>(false, loc);
+  auto bool_false = context.create<BooleanLiteral>(false, loc);
   EXPECT_EQ(bool_false->get_kind(), ASTNodeKind::BooleanLiteral);
   EXPECT_FALSE(bool_false->get_value());
 }
@@ -70,24 +75,24 @@ TEST_F(ASTCoverageTest, BooleanLiteralNode) {
  */
 TEST_F(ASTCoverageTest, UnaryOpExprNode) {
   auto loc = make_test_location();
-  auto operand = std::make_shared<IntegerLiteral>(42, loc);
+  auto operand = context.create<IntegerLiteral>(42, loc);
 
   // Test Minus operator
   auto unary_minus =
-      std::make_shared<UnaryOpExpr>(UnaryOperator::Minus, operand, loc);
+      context.create<UnaryOpExpr>(UnaryOperator::Minus, operand, loc);
   EXPECT_EQ(unary_minus->get_kind(), ASTNodeKind::UnaryOp);
   EXPECT_EQ(unary_minus->get_operator(), UnaryOperator::Minus);
   EXPECT_EQ(unary_minus->get_operand(), operand);
 
   // Test Plus operator
   auto unary_plus =
-      std::make_shared<UnaryOpExpr>(UnaryOperator::Plus, operand, loc);
+      context.create<UnaryOpExpr>(UnaryOperator::Plus, operand, loc);
   EXPECT_EQ(unary_plus->get_operator(), UnaryOperator::Plus);
 
   // Test Not operator
-  auto bool_operand = std::make_shared<BooleanLiteral>(true, loc);
+  auto bool_operand = context.create<BooleanLiteral>(true, loc);
   auto unary_not =
-      std::make_shared<UnaryOpExpr>(UnaryOperator::Not, bool_operand, loc);
+      context.create<UnaryOpExpr>(UnaryOperator::Not, bool_operand, loc);
   EXPECT_EQ(unary_not->get_operator(), UnaryOperator::Not);
   EXPECT_EQ(unary_not->get_operand(), bool_operand);
 }
@@ -98,8 +103,8 @@ TEST_F(ASTCoverageTest, UnaryOpExprNode) {
  */
 TEST_F(ASTCoverageTest, ParenExprNode) {
   auto loc = make_test_location();
-  auto inner_expr = std::make_shared<IntegerLiteral>(100, loc);
-  auto paren_expr = std::make_shared<ParenExpr>(inner_expr, loc);
+  auto inner_expr = context.create<IntegerLiteral>(100, loc);
+  auto paren_expr = context.create<ParenExpr>(inner_expr, loc);
 
   EXPECT_EQ(paren_expr->get_kind(), ASTNodeKind::ParenExpr);
   EXPECT_EQ(paren_expr->get_expression(), inner_expr);
@@ -111,13 +116,13 @@ TEST_F(ASTCoverageTest, ParenExprNode) {
  */
 TEST_F(ASTCoverageTest, CallExprNode) {
   auto loc = make_test_location();
-  auto callee = std::make_shared<Identifier>("my_function", loc);
+  auto callee = context.create<Identifier>(context.intern("my_function"), loc);
 
-  std::vector<std::shared_ptr<Expression>> args;
-  args.push_back(std::make_shared<IntegerLiteral>(10, loc));
-  args.push_back(std::make_shared<StringLiteral>("test", loc));
+  std::vector<Expression*> args;
+  args.push_back(context.create<IntegerLiteral>(10, loc));
+  args.push_back(context.create<StringLiteral>(context.intern("test"), loc));
 
-  auto call_expr = std::make_shared<CallExpr>(callee, args, loc);
+  auto call_expr = context.create<CallExpr>(callee, args, loc);
 
   EXPECT_EQ(call_expr->get_kind(), ASTNodeKind::CallExpr);
   EXPECT_EQ(call_expr->get_callee(), callee);
@@ -132,10 +137,10 @@ TEST_F(ASTCoverageTest, CallExprNode) {
  */
 TEST_F(ASTCoverageTest, IndexExprNode) {
   auto loc = make_test_location();
-  auto object = std::make_shared<Identifier>("my_array", loc);
-  auto index = std::make_shared<IntegerLiteral>(5, loc);
+  auto object = context.create<Identifier>(context.intern("my_array"), loc);
+  auto index = context.create<IntegerLiteral>(5, loc);
 
-  auto index_expr = std::make_shared<IndexExpr>(object, index, loc);
+  auto index_expr = context.create<IndexExpr>(object, index, loc);
 
   EXPECT_EQ(index_expr->get_kind(), ASTNodeKind::IndexExpr);
   EXPECT_EQ(index_expr->get_object(), object);
@@ -148,9 +153,10 @@ TEST_F(ASTCoverageTest, IndexExprNode) {
  */
 TEST_F(ASTCoverageTest, MemberExprNode) {
   auto loc = make_test_location();
-  auto object = std::make_shared<Identifier>("my_struct", loc);
+  auto object = context.create<Identifier>(context.intern("my_struct"), loc);
 
-  auto member_expr = std::make_shared<MemberExpr>(object, "field_name", loc);
+  auto member_expr =
+      context.create<MemberExpr>(object, context.intern("field_name"), loc);
 
   EXPECT_EQ(member_expr->get_kind(), ASTNodeKind::MemberExpr);
   EXPECT_EQ(member_expr->get_object(), object);
@@ -163,9 +169,9 @@ TEST_F(ASTCoverageTest, MemberExprNode) {
  */
 TEST_F(ASTCoverageTest, ExprStmtNode) {
   auto loc = make_test_location();
-  auto expr = std::make_shared<IntegerLiteral>(42, loc);
+  auto expr = context.create<IntegerLiteral>(42, loc);
 
-  auto expr_stmt = std::make_shared<ExprStmt>(expr, loc);
+  auto expr_stmt = context.create<ExprStmt>(expr, loc);
 
   EXPECT_EQ(expr_stmt->get_kind(), ASTNodeKind::ExprStmt);
   EXPECT_EQ(expr_stmt->get_expression(), expr);
@@ -177,9 +183,9 @@ TEST_F(ASTCoverageTest, ExprStmtNode) {
  */
 TEST_F(ASTCoverageTest, ReturnStmtNode) {
   auto loc = make_test_location();
-  auto value = std::make_shared<IntegerLiteral>(123, loc);
+  auto value = context.create<IntegerLiteral>(123, loc);
 
-  auto return_stmt = std::make_shared<ReturnStmt>(value, loc);
+  auto return_stmt = context.create<ReturnStmt>(value, loc);
 
   EXPECT_EQ(return_stmt->get_kind(), ASTNodeKind::ReturnStmt);
   EXPECT_EQ(return_stmt->get_value(), value);
@@ -191,12 +197,12 @@ TEST_F(ASTCoverageTest, ReturnStmtNode) {
  */
 TEST_F(ASTCoverageTest, IfStmtNode) {
   auto loc = make_test_location();
-  auto condition = std::make_shared<BooleanLiteral>(true, loc);
-  auto then_branch = std::make_shared<BlockStmt>(loc);
-  auto else_branch = std::make_shared<BlockStmt>(loc);
+  auto condition = context.create<BooleanLiteral>(true, loc);
+  auto then_branch = context.create<BlockStmt>(loc);
+  auto else_branch = context.create<BlockStmt>(loc);
 
   auto if_stmt =
-      std::make_shared<IfStmt>(condition, then_branch, else_branch, loc);
+      context.create<IfStmt>(condition, then_branch, else_branch, loc);
 
   EXPECT_EQ(if_stmt->get_kind(), ASTNodeKind::IfStmt);
   EXPECT_EQ(if_stmt->get_condition(), condition);
@@ -212,7 +218,8 @@ TEST_F(ASTCoverageTest, ParameterNode) {
   auto loc = make_test_location();
 
   // For simplicity, using nullptr for type (optional)
-  auto param = std::make_shared<Parameter>("param_name", nullptr, loc);
+  auto param = context.create<Parameter>(context.intern("param_name"), nullptr,
+                                         loc);
 
   EXPECT_EQ(param->get_name(), "param_name");
   EXPECT_EQ(param->get_type(), nullptr);
@@ -225,16 +232,19 @@ TEST_F(ASTCoverageTest, ParameterNode) {
 TEST_F(ASTCoverageTest, FunctionDeclNode) {
   auto loc = make_test_location();
 
-  std::vector<std::shared_ptr<Parameter>> params;
-  params.push_back(std::make_shared<Parameter>("x", nullptr, loc));
-  params.push_back(std::make_shared<Parameter>("y", nullptr, loc));
+  std::vector<Parameter*> params;
+  params.push_back(context.create<Parameter>(context.intern("x"), nullptr,
+                                             loc));
+  params.push_back(context.create<Parameter>(context.intern("y"), nullptr,
+                                             loc));
 
-  auto body = std::make_shared<BlockStmt>(loc);
-  body->add_statement(std::make_shared<ReturnStmt>(
-      std::make_shared<IntegerLiteral>(0, loc), loc));
+  auto body = context.create<BlockStmt>(loc);
+  body->add_statement(context.create<ReturnStmt>(
+      context.create<IntegerLiteral>(0, loc), loc));
 
   auto func_decl =
-      std::make_shared<FunctionDecl>("my_function", params, nullptr, body, loc);
+      context.create<FunctionDecl>(context.intern("my_function"), params,
+                                   nullptr, body, loc);
 
   EXPECT_EQ(func_decl->get_kind(), ASTNodeKind::FunctionDecl);
   EXPECT_EQ(func_decl->get_name(), "my_function");
@@ -252,7 +262,8 @@ TEST_F(ASTCoverageTest, FunctionDeclNode) {
 TEST_F(ASTCoverageTest, StructFieldNode) {
   auto loc = make_test_location();
 
-  auto field = std::make_shared<StructField>("field_name", nullptr, loc);
+  auto field = context.create<StructField>(context.intern("field_name"),
+                                           nullptr, loc);
 
   EXPECT_EQ(field->get_kind(), ASTNodeKind::StructField);
   EXPECT_EQ(field->get_name(), "field_name");
@@ -266,12 +277,16 @@ TEST_F(ASTCoverageTest, StructFieldNode) {
 TEST_F(ASTCoverageTest, StructDeclNode) {
   auto loc = make_test_location();
 
-  std::vector<std::shared_ptr<StructField>> fields;
-  fields.push_back(std::make_shared<StructField>("x", nullptr, loc));
-  fields.push_back(std::make_shared<StructField>("y", nullptr, loc));
-  fields.push_back(std::make_shared<StructField>("name", nullptr, loc));
+  std::vector<StructField*> fields;
+  fields.push_back(context.create<StructField>(context.intern("x"), nullptr,
+                                               loc));
+  fields.push_back(context.create<StructField>(context.intern("y"), nullptr,
+                                               loc));
+  fields.push_back(context.create<StructField>(context.intern("name"), nullptr,
+                                               loc));
 
-  auto struct_decl = std::make_shared<StructDecl>("Point", fields, loc);
+  auto struct_decl = context.create<StructDecl>(context.intern("Point"), fields,
+                                                loc);
 
   EXPECT_EQ(struct_decl->get_kind(), ASTNodeKind::StructDecl);
   EXPECT_EQ(struct_decl->get_name(), "Point");
@@ -287,10 +302,10 @@ TEST_F(ASTCoverageTest, StructDeclNode) {
  */
 TEST_F(ASTCoverageTest, VarDeclNode) {
   auto loc = make_test_location();
-  auto initializer = std::make_shared<IntegerLiteral>(999, loc);
+  auto initializer = context.create<IntegerLiteral>(999, loc);
 
-  auto var_decl =
-      std::make_shared<VarDecl>("my_var", nullptr, initializer, loc);
+  auto var_decl = context.create<VarDecl>(context.intern("my_var"), nullptr,
+                                          initializer, loc);
 
   EXPECT_EQ(var_decl->get_kind(), ASTNodeKind::VarDecl);
   EXPECT_EQ(var_decl->get_name(), "my_var");
@@ -304,26 +319,29 @@ TEST_F(ASTCoverageTest, VarDeclNode) {
  */
 TEST_F(ASTCoverageTest, ProgramNode) {
   auto loc = make_test_location();
-  auto program = std::make_shared<Program>(loc);
+  auto program = context.create<Program>(loc);
 
   EXPECT_EQ(program->get_kind(), ASTNodeKind::Program);
   EXPECT_EQ(program->get_declarations().size(), 0);
 
   // Add variable declaration
-  auto var_decl = std::make_shared<VarDecl>(
-      "x", nullptr, std::make_shared<IntegerLiteral>(10, loc), loc);
+  auto var_decl = context.create<VarDecl>(
+      context.intern("x"), nullptr, context.create<IntegerLiteral>(10, loc),
+      loc);
   program->add_declaration(var_decl);
 
   // Add function declaration
-  std::vector<std::shared_ptr<Parameter>> params;
-  auto body = std::make_shared<BlockStmt>(loc);
+  std::vector<Parameter*> params;
+  auto body = context.create<BlockStmt>(loc);
   auto func_decl =
-      std::make_shared<FunctionDecl>("test_fn", params, nullptr, body, loc);
+      context.create<FunctionDecl>(context.intern("test_fn"), params, nullptr,
+                                   body, loc);
   program->add_declaration(func_decl);
 
   // Add struct declaration
-  std::vector<std::shared_ptr<StructField>> fields;
-  auto struct_decl = std::make_shared<StructDecl>("TestStruct", fields, loc);
+  std::vector<StructField*> fields;
+  auto struct_decl = context.create<StructDecl>(context.intern("TestStruct"),
+                                                fields, loc);
   program->add_declaration(struct_decl);
 
   EXPECT_EQ(program->get_declarations().size(), 3);
@@ -335,19 +353,19 @@ TEST_F(ASTCoverageTest, ProgramNode) {
  */
 TEST_F(ASTCoverageTest, BlockStmtNode) {
   auto loc = make_test_location();
-  auto block = std::make_shared<BlockStmt>(loc);
+  auto block = context.create<BlockStmt>(loc);
 
   EXPECT_EQ(block->get_kind(), ASTNodeKind::BlockStmt);
   EXPECT_EQ(block->get_statements().size(), 0);
 
   // Add expression statement
-  auto expr_stmt = std::make_shared<ExprStmt>(
-      std::make_shared<IntegerLiteral>(42, loc), loc);
+  auto expr_stmt = context.create<ExprStmt>(
+      context.create<IntegerLiteral>(42, loc), loc);
   block->add_statement(expr_stmt);
 
   // Add return statement
-  auto return_stmt = std::make_shared<ReturnStmt>(
-      std::make_shared<BooleanLiteral>(true, loc), loc);
+  auto return_stmt = context.create<ReturnStmt>(
+      context.create<BooleanLiteral>(true, loc), loc);
   block->add_statement(return_stmt);
 
   EXPECT_EQ(block->get_statements().size(), 2);
@@ -361,7 +379,7 @@ TEST_F(ASTCoverageTest, TypeNodeInheritance) {
   auto loc = make_test_location();
 
   // Type is abstract, but we can test through Expression which sets/gets type
-  auto expr = std::make_shared<IntegerLiteral>(42, loc);
+  auto expr = context.create<IntegerLiteral>(42, loc);
 
   EXPECT_EQ(expr->get_type(), nullptr);
 
@@ -375,64 +393,64 @@ TEST_F(ASTCoverageTest, TypeNodeInheritance) {
  */
 TEST_F(ASTCoverageTest, AllBinaryOperators) {
   auto loc = make_test_location();
-  auto left = std::make_shared<IntegerLiteral>(10, loc);
-  auto right = std::make_shared<IntegerLiteral>(20, loc);
+  auto left = context.create<IntegerLiteral>(10, loc);
+  auto right = context.create<IntegerLiteral>(20, loc);
 
   // Arithmetic operators
   auto add_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Add, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Add, left, right, loc);
   EXPECT_EQ(add_op->get_operator(), BinaryOperator::Add);
 
   auto sub_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Sub, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Sub, left, right, loc);
   EXPECT_EQ(sub_op->get_operator(), BinaryOperator::Sub);
 
   auto mul_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Mul, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Mul, left, right, loc);
   EXPECT_EQ(mul_op->get_operator(), BinaryOperator::Mul);
 
   auto div_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Div, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Div, left, right, loc);
   EXPECT_EQ(div_op->get_operator(), BinaryOperator::Div);
 
   auto mod_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Mod, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Mod, left, right, loc);
   EXPECT_EQ(mod_op->get_operator(), BinaryOperator::Mod);
 
   // Comparison operators
   auto eq_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Eq, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Eq, left, right, loc);
   EXPECT_EQ(eq_op->get_operator(), BinaryOperator::Eq);
 
   auto ne_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Ne, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Ne, left, right, loc);
   EXPECT_EQ(ne_op->get_operator(), BinaryOperator::Ne);
 
   auto lt_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Lt, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Lt, left, right, loc);
   EXPECT_EQ(lt_op->get_operator(), BinaryOperator::Lt);
 
   auto le_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Le, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Le, left, right, loc);
   EXPECT_EQ(le_op->get_operator(), BinaryOperator::Le);
 
   auto gt_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Gt, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Gt, left, right, loc);
   EXPECT_EQ(gt_op->get_operator(), BinaryOperator::Gt);
 
   auto ge_op =
-      std::make_shared<BinaryOpExpr>(BinaryOperator::Ge, left, right, loc);
+      context.create<BinaryOpExpr>(BinaryOperator::Ge, left, right, loc);
   EXPECT_EQ(ge_op->get_operator(), BinaryOperator::Ge);
 
   // Logical operators
-  auto bool_left = std::make_shared<BooleanLiteral>(true, loc);
-  auto bool_right = std::make_shared<BooleanLiteral>(false, loc);
+  auto bool_left = context.create<BooleanLiteral>(true, loc);
+  auto bool_right = context.create<BooleanLiteral>(false, loc);
 
-  auto and_op = std::make_shared<BinaryOpExpr>(BinaryOperator::And, bool_left,
+  auto and_op = context.create<BinaryOpExpr>(BinaryOperator::And, bool_left,
                                                bool_right, loc);
   EXPECT_EQ(and_op->get_operator(), BinaryOperator::And);
 
-  auto or_op = std::make_shared<BinaryOpExpr>(BinaryOperator::Or, bool_left,
+  auto or_op = context.create<BinaryOpExpr>(BinaryOperator::Or, bool_left,
                                               bool_right, loc);
   EXPECT_EQ(or_op->get_operator(), BinaryOperator::Or);
 }
@@ -445,29 +463,29 @@ TEST_F(ASTCoverageTest, BaseClassPolymorphism) {
   auto loc = make_test_location();
 
   // Test Expression inheritance
-  std::shared_ptr<Expression> expr1 = std::make_shared<IntegerLiteral>(10, loc);
-  std::shared_ptr<Expression> expr2 = std::make_shared<FloatLiteral>(3.14, loc);
-  std::shared_ptr<Expression> expr3 = std::make_shared<Identifier>("var", loc);
+  Expression* expr1 = context.create<IntegerLiteral>(10, loc);
+  Expression* expr2 = context.create<FloatLiteral>(3.14, loc);
+  Expression* expr3 = context.create<Identifier>(context.intern("var"), loc);
 
   EXPECT_EQ(expr1->get_kind(), ASTNodeKind::IntegerLiteral);
   EXPECT_EQ(expr2->get_kind(), ASTNodeKind::FloatLiteral);
   EXPECT_EQ(expr3->get_kind(), ASTNodeKind::Identifier);
 
   // Test Statement inheritance
-  std::shared_ptr<Statement> stmt1 = std::make_shared<ExprStmt>(expr1, loc);
-  std::shared_ptr<Statement> stmt2 = std::make_shared<ReturnStmt>(expr2, loc);
-  std::shared_ptr<Statement> stmt3 = std::make_shared<BlockStmt>(loc);
+  Statement* stmt1 = context.create<ExprStmt>(expr1, loc);
+  Statement* stmt2 = context.create<ReturnStmt>(expr2, loc);
+  Statement* stmt3 = context.create<BlockStmt>(loc);
 
   EXPECT_EQ(stmt1->get_kind(), ASTNodeKind::ExprStmt);
   EXPECT_EQ(stmt2->get_kind(), ASTNodeKind::ReturnStmt);
   EXPECT_EQ(stmt3->get_kind(), ASTNodeKind::BlockStmt);
 
   // Test Declaration inheritance
-  std::shared_ptr<Declaration> decl1 =
-      std::make_shared<VarDecl>("x", nullptr, nullptr, loc);
-  std::vector<std::shared_ptr<StructField>> fields;
-  std::shared_ptr<Declaration> decl2 =
-      std::make_shared<StructDecl>("S", fields, loc);
+  Declaration* decl1 = context.create<VarDecl>(context.intern("x"), nullptr,
+                                               nullptr, loc);
+  std::vector<StructField*> fields;
+  Declaration* decl2 = context.create<StructDecl>(context.intern("S"), fields,
+                                                  loc);
 
   EXPECT_EQ(decl1->get_kind(), ASTNodeKind::VarDecl);
   EXPECT_EQ(decl2->get_kind(), ASTNodeKind::StructDecl);
@@ -0,0 +1,126 @@
+/**
+ * @file test_atomic_file.cpp
+ * @brief 原子文件写入测试套件（使用 Google Test 框架）。
+ * @details 测试 `write_file_atomic` 创建与替换文件、沿用原文件权限、
+ *          不残留临时文件、经符号链接写入目标文件，以及失败时保持目标
+ *          文件不变。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/atomic_file.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace czc::utils;
+namespace fs = std::filesystem;
+
+/**
+ * @brief 原子写入测试夹具，提供一个独立的临时目录。
+ */
+class AtomicFileTest : public ::testing::Test {
+protected:
+  fs::path directory;
+
+  void SetUp() override {
+    directory = fs::temp_directory_path() /
+                ("czc_atomic_file_" +
+                 std::string(::testing::UnitTest::GetInstance()
+                                 ->current_test_info()
+                                 ->name()));
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+  }
+
+  void TearDown() override {
+    fs::remove_all(directory);
+  }
+
+  static std::string read_file(const fs::path& path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(input)),
+                       std::istreambuf_iterator<char>());
+  }
+
+  size_t count_entries() const {
+    return static_cast<size_t>(
+        std::distance(fs::directory_iterator(directory), {}));
+  }
+};
+
+/**
+ * @brief 测试创建新文件与替换已有文件，目录中不残留临时文件。
+ */
+TEST_F(AtomicFileTest, CreatesAndReplacesFile) {
+  std::string path = (directory / "main.zero").string();
+
+  ASSERT_TRUE(write_file_atomic(path, "let x = 1;\n"));
+  EXPECT_EQ(read_file(path), "let x = 1;\n");
+
+  ASSERT_TRUE(write_file_atomic(path, "let y = 2;\n", true));
+  EXPECT_EQ(read_file(path), "let y = 2;\n");
+
+  ASSERT_TRUE(write_file_atomic(path, ""));
+  EXPECT_EQ(read_file(path), "");
+  EXPECT_EQ(count_entries(), 1u);
+}
+
+#ifndef _WIN32
+/**
+ * @brief 测试替换后的文件沿用原文件的权限位。
+ */
+TEST_F(AtomicFileTest, PreservesPermissions) {
+  fs::path path = directory / "script.zero";
+  ASSERT_TRUE(write_file_atomic(path.string(), "old\n"));
+  fs::permissions(path, fs::perms::owner_read | fs::perms::owner_write |
+                            fs::perms::owner_exec | fs::perms::group_read);
+
+  ASSERT_TRUE(write_file_atomic(path.string(), "new\n"));
+  EXPECT_EQ(fs::status(path).permissions() & fs::perms::mask,
+            fs::perms::owner_read | fs::perms::owner_write |
+                fs::perms::owner_exec | fs::perms::group_read);
+}
+
+/**
+ * @brief 测试写入符号链接时改写链接指向的文件，链接本身保持不变。
+ */
+TEST_F(AtomicFileTest, WritesThroughSymlink) {
+  fs::create_directories(directory / "real");
+  fs::path target = directory / "real" / "main.zero";
+  fs::path link = directory / "link.zero";
+  ASSERT_TRUE(write_file_atomic(target.string(), "old\n"));
+  fs::create_symlink(fs::path("real") / "main.zero", link);
+  fs::create_symlink(link.filename(), directory / "chain.zero");
+
+  ASSERT_TRUE(write_file_atomic(link.string(), "new\n"));
+  EXPECT_TRUE(fs::is_symlink(link));
+  EXPECT_EQ(read_file(target), "new\n");
+
+  fs::path chain = directory / "chain.zero";
+  ASSERT_TRUE(write_file_atomic(chain.string(), "chain\n"));
+  EXPECT_TRUE(fs::is_symlink(chain));
+  EXPECT_EQ(read_file(target), "chain\n");
+  // 临时文件建在目标旁边，两个目录中都不残留。
+  EXPECT_EQ(count_entries(), 3u);
+  EXPECT_EQ(std::distance(fs::directory_iterator(directory / "real"), {}), 1);
+}
+#endif
+
+/**
+ * @brief 测试无法写入时返回 false，目标文件与目录保持不变。
+ */
+TEST_F(AtomicFileTest, FailureLeavesTargetUntouched) {
+  std::string missing = (directory / "missing" / "main.zero").string();
+  EXPECT_FALSE(write_file_atomic(missing, "content"));
+
+  // 目标是目录时重命名失败，临时文件应被删除。
+  fs::create_directories(directory / "target");
+  EXPECT_FALSE(write_file_atomic((directory / "target").string(), "content"));
+  EXPECT_TRUE(fs::is_directory(directory / "target"));
+  EXPECT_EQ(count_entries(), 1u);
+}
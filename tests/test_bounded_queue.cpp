@@ -0,0 +1,81 @@
+/**
+ * @file test_bounded_queue.cpp
+ * @brief 有界队列 `BoundedQueue` 的测试。
+ * @details 覆盖先进先出的顺序、关闭后取完剩余元素，以及多个生产者与
+ *          消费者经由容量很小的队列交接全部元素。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/bounded_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace czc::utils;
+
+/**
+ * @brief 测试元素按放入的顺序取出，关闭后取完剩余元素再返回空。
+ */
+TEST(BoundedQueueTest, DrainsInOrderAfterClose) {
+  BoundedQueue<std::unique_ptr<int>> queue(4);
+  EXPECT_EQ(queue.get_capacity(), 4u);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(queue.push(std::make_unique<int>(i)));
+  }
+  queue.close();
+  EXPECT_FALSE(queue.push(std::make_unique<int>(3)));
+
+  for (int i = 0; i < 3; i++) {
+    auto value = queue.pop();
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(**value, i);
+  }
+  EXPECT_FALSE(queue.pop().has_value());
+  EXPECT_EQ(BoundedQueue<int>(0).get_capacity(), 1u);
+}
+
+/**
+ * @brief 测试多个生产者与消费者经由容量为 2 的队列交接全部元素。
+ */
+TEST(BoundedQueueTest, HandsOffBetweenThreads) {
+  constexpr int PRODUCERS = 3;
+  constexpr int CONSUMERS = 3;
+  constexpr int ITEMS = 2000;
+  BoundedQueue<int> queue(2);
+  std::atomic<long long> sum{0};
+  std::atomic<int> count{0};
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < CONSUMERS; c++) {
+    consumers.emplace_back([&]() {
+      while (auto value = queue.pop()) {
+        sum += *value;
+        count++;
+      }
+    });
+  }
+  std::vector<std::thread> producers;
+  for (int p = 0; p < PRODUCERS; p++) {
+    producers.emplace_back([&, p]() {
+      for (int i = 0; i < ITEMS; i++) {
+        queue.push(p * ITEMS + i);
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  queue.close();
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  constexpr long long TOTAL = PRODUCERS * ITEMS;
+  EXPECT_EQ(count.load(), TOTAL);
+  EXPECT_EQ(sum.load(), TOTAL * (TOTAL - 1) / 2);
+}
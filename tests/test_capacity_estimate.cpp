@@ -0,0 +1,86 @@
+/**
+ * @file test_capacity_estimate.cpp
+ * @brief 容量预估 `CapacityEstimate` 的测试。
+ * @details 覆盖按比例估算 Token 数与 Arena 首块大小、以实际结果修正比例、
+ *          忽略过小的样本，以及 Lexer 按估计一次预留 Token 序列。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/lexer/lexer.hpp"
+#include "czc/utils/arena.hpp"
+#include "czc/utils/capacity_estimate.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace czc;
+using namespace czc::utils;
+
+/**
+ * @brief 测试估计值随比例与输入长度变化并有上限，Arena 首块取 2 的幂倍
+ *        并有上限。
+ */
+TEST(CapacityEstimateTest, EstimatesFromRatios) {
+  CapacityEstimate::reset();
+  EXPECT_DOUBLE_EQ(CapacityEstimate::get_bytes_per_token(),
+                   CapacityEstimate::DEFAULT_BYTES_PER_TOKEN);
+  // 4000 / 4 = 1000，另加 1/8 的余量。
+  EXPECT_EQ(CapacityEstimate::estimate_tokens(4000), 1126u);
+  EXPECT_EQ(CapacityEstimate::estimate_tokens(0), 1u);
+  // 大输入的估计被限制在上限以内。
+  EXPECT_EQ(CapacityEstimate::estimate_tokens(size_t{1} << 32),
+            CapacityEstimate::MAX_ESTIMATED_TOKENS);
+
+  EXPECT_EQ(CapacityEstimate::estimate_arena_block(0),
+            Arena::DEFAULT_BLOCK_SIZE);
+  size_t tokens = 3 * Arena::DEFAULT_BLOCK_SIZE /
+                  static_cast<size_t>(
+                      CapacityEstimate::DEFAULT_ARENA_BYTES_PER_TOKEN);
+  EXPECT_EQ(CapacityEstimate::estimate_arena_block(tokens),
+            4 * Arena::DEFAULT_BLOCK_SIZE);
+  EXPECT_EQ(CapacityEstimate::estimate_arena_block(size_t(1) << 30),
+            Arena::MAX_BLOCK_SIZE);
+}
+
+/**
+ * @brief 测试比例向实际结果收敛，过小的样本不参与修正。
+ */
+TEST(CapacityEstimateTest, AdaptsToObservedInputs) {
+  CapacityEstimate::reset();
+  CapacityEstimate::observe_tokens(800, 100);
+  EXPECT_DOUBLE_EQ(CapacityEstimate::get_bytes_per_token(),
+                   CapacityEstimate::DEFAULT_BYTES_PER_TOKEN);
+
+  for (int i = 0; i < 32; i++) {
+    CapacityEstimate::observe_tokens(8000, 1000);
+    CapacityEstimate::observe_arena(1000, 100000);
+  }
+  EXPECT_NEAR(CapacityEstimate::get_bytes_per_token(), 8.0, 0.01);
+  EXPECT_NEAR(CapacityEstimate::get_arena_bytes_per_token(), 100.0, 0.1);
+  EXPECT_NEAR(static_cast<double>(CapacityEstimate::estimate_tokens(80000)),
+              11250.0, 10.0);
+
+  CapacityEstimate::reset();
+  EXPECT_DOUBLE_EQ(CapacityEstimate::get_arena_bytes_per_token(),
+                   CapacityEstimate::DEFAULT_ARENA_BYTES_PER_TOKEN);
+}
+
+/**
+ * @brief 测试 Lexer 按估计预留，典型输入的 Token 序列不再扩容。
+ */
+TEST(CapacityEstimateTest, LexerReservesFromInputLength) {
+  CapacityEstimate::reset();
+  std::string source;
+  for (int i = 0; i < 500; i++) {
+    source += "let descriptive_name_" + std::to_string(i) +
+              " = compute(first);\n";
+  }
+  size_t estimate = CapacityEstimate::estimate_tokens(source.size());
+  auto tokens = lexer::Lexer(source).tokenize();
+  ASSERT_LE(tokens.size(), estimate);
+  EXPECT_EQ(tokens.capacity(), estimate);
+  EXPECT_NE(CapacityEstimate::get_bytes_per_token(),
+            CapacityEstimate::DEFAULT_BYTES_PER_TOKEN);
+}
@@ -78,3 +78,84 @@ TEST_F(CommentsTest, CommentFormatting) {
 
   EXPECT_NE(formatted.find("//"), std::string::npos);
 }
+
+// --- Comment Table Tests ---
+
+namespace {
+
+const std::string COMMENTED_SOURCE = "// header\n"
+                                     "let x = 10; // trailing\n"
+                                     "fn f() {\n"
+                                     "  // leading\n"
+                                     "  let y = x;\n"
+                                     "  f(); // call\n"
+                                     "  // dangling\n"
+                                     "}\n"
+                                     "struct P {\n"
+                                     "  // field\n"
+                                     "  a: Integer,\n"
+                                     "  // last\n"
+                                     "};\n"
+                                     "let p = P {\n"
+                                     "  a: 1,\n"
+                                     "  // init\n"
+                                     "  b: 2,\n"
+                                     "};\n"
+                                     "fn end() {}\n"
+                                     "// footer\n";
+
+} // namespace
+
+TEST_F(CommentsTest, CommentTableKeepsCommentsOutOfTree) {
+  Lexer lexer(COMMENTED_SOURCE);
+  auto tokens = lexer.tokenize();
+
+  CommentTable table;
+  Parser parser(tokens);
+  parser.set_comment_table(&table);
+  auto cst = parser.parse();
+
+  ASSERT_NE(cst, nullptr);
+  EXPECT_FALSE(parser.has_errors());
+  EXPECT_EQ(count_nodes(cst.get(), CSTNodeType::Comment), 0u);
+  EXPECT_EQ(table.size(), 9u);
+
+  const auto& items = cst->get_children();
+  ASSERT_EQ(items.size(), 5u);
+  auto header = table.leading(items[0].get());
+  ASSERT_EQ(header.size(), 1u);
+  EXPECT_EQ(header.begin()->value, "// header");
+  ASSERT_EQ(table.trailing(items[0].get()).size(), 1u);
+  EXPECT_EQ(table.trailing(items[0].get()).begin()->value, "// trailing");
+  ASSERT_EQ(table.dangling(nullptr).size(), 1u);
+  EXPECT_EQ(table.dangling(nullptr).begin()->value, "// footer");
+  ASSERT_EQ(table.dangling(items[2].get()).size(), 1u);
+  EXPECT_EQ(table.dangling(items[2].get()).begin()->value, "// last");
+  EXPECT_TRUE(table.leading(items[1].get()).empty());
+}
+
+TEST_F(CommentsTest, FormatterReadsCommentTable) {
+  const std::string sources[] = {
+      COMMENTED_SOURCE,
+      "let a = 1;\n// one\n// two\nlet b = 2;\n",
+      "fn g() {\n  // only\n}\n",
+      "// only a comment\n",
+  };
+  for (const auto& source : sources) {
+    Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+
+    Parser with_nodes(tokens);
+    auto expected_tree = with_nodes.parse();
+    Formatter formatter;
+    std::string expected = formatter.format(expected_tree.get());
+
+    CommentTable table;
+    Parser with_table(tokens);
+    with_table.set_comment_table(&table);
+    auto tree = with_table.parse();
+    formatter.set_comment_table(&table);
+    EXPECT_EQ(formatter.format(tree.get()), expected) << source;
+    EXPECT_TRUE(formatter.format_range(tree.get(), source, 0, 1).empty());
+  }
+}
@@ -0,0 +1,113 @@
+/**
+ * @file test_constant_folder.cpp
+ * @brief 常量折叠（`ConstantFolder`）的测试。
+ * @details 覆盖算术、比较与逻辑运算的折叠，括号的去除，嵌在调用参数中的
+ *          部分折叠，以及整数溢出改用浮点数、浮点溢出不折叠的规则。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/ast/ast_builder.hpp"
+#include "czc/ast/ast_context.hpp"
+#include "czc/ast/constant_folder.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace czc;
+using namespace czc::ast;
+
+class ConstantFolderTest : public ::testing::Test {
+protected:
+  ASTContext context;
+  ConstantFolder folder{context};
+
+  /**
+   * @brief 构建并折叠 `source`，返回第一个声明的初始化表达式。
+   */
+  Expression* fold_initializer(const std::string& source) {
+    lexer::Lexer lexer(source, "test.zero");
+    auto tokens = lexer.tokenize();
+    parser::Parser parser(tokens);
+    auto cst = parser.parse();
+    ASTBuilder builder(context);
+    Program* program = builder.build(cst.get());
+    folder.run(program);
+    auto* decl = dynamic_cast<VarDecl*>(program->get_declarations().at(0));
+    return decl != nullptr ? decl->get_initializer() : nullptr;
+  }
+};
+
+/**
+ * @brief 测试整数与浮点数算术、括号与一元运算的折叠。
+ */
+TEST_F(ConstantFolderTest, FoldsArithmetic) {
+  auto* value = fold_initializer("let x = (1 + 2) * -3 - 8 / 4;");
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(value->get_kind(), ASTNodeKind::IntegerLiteral);
+  EXPECT_EQ(static_cast<IntegerLiteral*>(value)->get_value(), -11);
+
+  value = fold_initializer("let y = 1.5 * (2 + 0.5);");
+  ASSERT_EQ(value->get_kind(), ASTNodeKind::FloatLiteral);
+  EXPECT_DOUBLE_EQ(static_cast<FloatLiteral*>(value)->get_value(), 3.75);
+
+  EXPECT_EQ(folder.get_stats().folded_expressions, 7u);
+  EXPECT_EQ(folder.get_stats().collapsed_parens, 2u);
+}
+
+/**
+ * @brief 测试比较与逻辑运算折叠为布尔字面量。
+ */
+TEST_F(ConstantFolderTest, FoldsComparisonsAndLogic) {
+  auto* value = fold_initializer("let b = 1 < 2 && !(3.0 == 3);");
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(value->get_kind(), ASTNodeKind::BooleanLiteral);
+  EXPECT_FALSE(static_cast<BooleanLiteral*>(value)->get_value());
+}
+
+/**
+ * @brief 测试只折叠常量部分，非常量的子表达式与调用保留。
+ */
+TEST_F(ConstantFolderTest, FoldsConstantSubexpressionsOnly) {
+  auto* value = fold_initializer("let y = f(x + (2 * 4), (7));");
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(value->get_kind(), ASTNodeKind::CallExpr);
+  const auto& args = static_cast<CallExpr*>(value)->get_arguments();
+  ASSERT_EQ(args.size(), 2u);
+
+  ASSERT_EQ(args[0]->get_kind(), ASTNodeKind::BinaryOp);
+  auto* sum = static_cast<BinaryOpExpr*>(args[0]);
+  EXPECT_EQ(sum->get_left()->get_kind(), ASTNodeKind::Identifier);
+  ASSERT_EQ(sum->get_right()->get_kind(), ASTNodeKind::IntegerLiteral);
+  EXPECT_EQ(static_cast<IntegerLiteral*>(sum->get_right())->get_value(), 8);
+  EXPECT_EQ(args[1]->get_kind(), ASTNodeKind::IntegerLiteral);
+
+  // 语义未定的整数除法与取模保持原样。
+  value = fold_initializer("let z = 7 / 2 + -7 % 2;");
+  ASSERT_EQ(value->get_kind(), ASTNodeKind::BinaryOp);
+  auto* binary = static_cast<BinaryOpExpr*>(value);
+  EXPECT_EQ(binary->get_left()->get_kind(), ASTNodeKind::BinaryOp);
+  EXPECT_EQ(binary->get_right()->get_kind(), ASTNodeKind::BinaryOp);
+}
+
+/**
+ * @brief 测试整数溢出时改用浮点数，浮点溢出与除以零时不折叠。
+ */
+TEST_F(ConstantFolderTest, AppliesNumericOverflowRules) {
+  auto* value = fold_initializer("let big = 9223372036854775807 + 1;");
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(value->get_kind(), ASTNodeKind::FloatLiteral);
+  EXPECT_DOUBLE_EQ(static_cast<FloatLiteral*>(value)->get_value(),
+                   9223372036854775808.0);
+  EXPECT_EQ(folder.get_stats().promoted_to_float, 1u);
+
+  std::string huge = "1" + std::string(200, '0') + ".0";
+  value = fold_initializer("let inf = " + huge + " * " + huge + ";");
+  EXPECT_EQ(value->get_kind(), ASTNodeKind::BinaryOp);
+  value = fold_initializer("let nan = 1.0 / 0;");
+  EXPECT_EQ(value->get_kind(), ASTNodeKind::BinaryOp);
+  EXPECT_EQ(folder.get_stats().overflowed, 2u);
+}
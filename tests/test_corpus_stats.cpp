@@ -0,0 +1,125 @@
+/**
+ * @file test_corpus_stats.cpp
+ * @brief 语料统计 `CorpusStats` 的测试。
+ * @details 覆盖分布的分桶与分位数、按文件累计的 Token 与 CST 统计，
+ *          以及分别统计后合并的结果与依次统计相同。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/stats/corpus_stats.hpp"
+
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace czc;
+using namespace czc::stats;
+
+namespace {
+
+/**
+ * @brief 词法分析并解析 `text`，累计到 `stats` 中。
+ */
+void add_source(CorpusStats& stats, const std::string& text) {
+  lexer::Lexer lexer(text);
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens);
+  auto cst = parser.parse();
+  ASSERT_FALSE(parser.has_errors()) << text;
+  stats.add_file(text.size(), tokens, cst.get());
+}
+
+} // namespace
+
+TEST(HistogramTest, BucketsSmallValuesExactlyAndLargeValuesByPowerOfTwo) {
+  Histogram histogram;
+  for (uint64_t value = 1; value <= 10; ++value) {
+    histogram.add(value);
+  }
+  histogram.add(100, 2);
+  histogram.add(uint64_t{1} << 40);
+
+  EXPECT_EQ(histogram.get_count(), 13u);
+  EXPECT_EQ(histogram.get_sum(), 55u + 200u + (uint64_t{1} << 40));
+  EXPECT_EQ(histogram.get_max(), uint64_t{1} << 40);
+  EXPECT_EQ(histogram.percentile(0.5), 7u);
+  // 100 落在 [64, 127] 的桶中，分位数取桶的上界。
+  EXPECT_EQ(histogram.percentile(0.9), 127u);
+  EXPECT_EQ(histogram.percentile(1.0), uint64_t{1} << 40);
+
+  auto json = histogram.to_json();
+  const auto* buckets = json.find("buckets");
+  ASSERT_NE(buckets, nullptr);
+  ASSERT_EQ(buckets->as_array().size(), 12u);
+  const auto& spread = buckets->as_array()[10];
+  EXPECT_EQ(spread.find("min")->as_number(), 64);
+  EXPECT_EQ(spread.find("max")->as_number(), 127);
+  EXPECT_EQ(spread.find("count")->as_number(), 2);
+  EXPECT_EQ(Histogram().percentile(0.5), 0u);
+}
+
+TEST(CorpusStatsTest, CountsTokensAndTreeShape) {
+  CorpusStats stats;
+  add_source(stats, "let name = \"a\\tb\";\nfn f(x) { return x; }\n");
+
+  EXPECT_EQ(stats.get_files(), 1u);
+  EXPECT_EQ(stats.get_token_count(lexer::TokenType::Let), 1u);
+  EXPECT_EQ(stats.get_token_count(lexer::TokenType::Identifier), 4u);
+  EXPECT_EQ(stats.get_token_count(lexer::TokenType::EndOfFile), 1u);
+  // 标识符 name、f、x、x
+  EXPECT_EQ(stats.get_identifier_lengths().get_sum(), 7u);
+  EXPECT_EQ(stats.get_identifier_lengths().get_max(), 4u);
+  // 字符串长度按转义处理后的内容计算
+  EXPECT_EQ(stats.get_string_lengths().get_count(), 1u);
+  EXPECT_EQ(stats.get_string_lengths().get_max(), 3u);
+
+  EXPECT_EQ(stats.get_node_count(cst::CSTNodeType::Program), 1u);
+  EXPECT_EQ(stats.get_node_count(cst::CSTNodeType::FnDeclaration), 1u);
+  EXPECT_EQ(stats.get_children_per_node().get_count(), stats.get_cst_nodes());
+  // 每个非根节点恰好是某个节点的子节点
+  EXPECT_EQ(stats.get_children_per_node().get_sum(),
+            stats.get_cst_nodes() - 1);
+  EXPECT_EQ(stats.get_max_depths().get_count(), 1u);
+  EXPECT_GE(stats.get_max_depths().get_max(), 3u);
+
+  auto json = stats.to_json();
+  ASSERT_NE(json.find("token_types"), nullptr);
+  EXPECT_EQ(json.find("token_types")->find("Let")->as_number(), 1);
+  EXPECT_EQ(json.find("token_types")->find("Float"), nullptr);
+  EXPECT_EQ(json.find("cst_node_types")->find("Program")->as_number(), 1);
+  EXPECT_GT(json.find("capacity_estimate")
+                ->find("bytes_per_token")
+                ->as_number(),
+            0);
+}
+
+TEST(CorpusStatsTest, MergedStatsMatchSequentialStats) {
+  std::vector<std::string> texts = {
+      "let a = 1;\n",
+      "fn f(a, b) { if (a) { return b; } return a + b * 2; }\n",
+      "struct Point { x: Int, y: Int }\nlet s = \"text\";\n",
+  };
+
+  CorpusStats sequential;
+  for (const auto& text : texts) {
+    add_source(sequential, text);
+  }
+  CorpusStats first;
+  CorpusStats second;
+  add_source(first, texts[0]);
+  add_source(second, texts[1]);
+  add_source(second, texts[2]);
+  second.add_failed_file();
+  first.merge(second);
+
+  EXPECT_EQ(first.get_files(), 3u);
+  EXPECT_EQ(first.get_failed_files(), 1u);
+  // 除失败文件数外，合并结果与依次统计一致。
+  sequential.add_failed_file();
+  EXPECT_EQ(first.to_json().dump(), sequential.to_json().dump());
+}
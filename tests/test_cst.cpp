@@ -10,6 +10,9 @@
  */
 
 #include "czc/cst/cst_node.hpp"
+#include "czc/cst/cst_node_traits.hpp"
+#include "czc/cst/flat_cst.hpp"
+#include "czc/cst/green_tree.hpp"
 #include "czc/lexer/lexer.hpp"
 #include "czc/lexer/token.hpp"
 #include "czc/parser/parser.hpp"
@@ -148,7 +151,7 @@ TEST_F(CSTNodeTest, LocationInfo) {
   auto node = std::make_unique<CSTNode>(CSTNodeType::BinaryExpr, loc);
   const auto& node_loc = node->get_location();
 
-  EXPECT_EQ(node_loc.filename, "test.zero");
+  EXPECT_EQ(node_loc.get_filename(), "test.zero");
   EXPECT_EQ(node_loc.line, 5);
   EXPECT_EQ(node_loc.column, 10);
 }
@@ -440,7 +443,7 @@ TEST_F(CSTNodeTest, MakeCSTNodeWithLocation) {
 
   ASSERT_NE(node, nullptr);
   EXPECT_EQ(node->get_type(), CSTNodeType::VarDeclaration);
-  EXPECT_EQ(node->get_location().filename, "helper_test.zero");
+  EXPECT_EQ(node->get_location().get_filename(), "helper_test.zero");
   EXPECT_EQ(node->get_location().line, 10);
   EXPECT_EQ(node->get_location().column, 20);
   EXPECT_TRUE(node->get_children().empty());
@@ -720,3 +723,258 @@ TEST_F(CSTNodeTest, HelperFunctionNodeTypeToString) {
   std::string fn_str = cst_node_type_to_string(CSTNodeType::FnDeclaration);
   EXPECT_FALSE(fn_str.empty());
 }
+
+// --- 扁平 CST 测试 ---
+
+/**
+ * @brief 递归比较指针树与扁平 CST 中对应的子树。
+ */
+static void expect_flat_matches_tree(const CSTNode* node, FlatCSTNodeRef flat) {
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(flat.get_type(), node->get_type());
+  EXPECT_EQ(flat.get_line(), node->get_location().line);
+  EXPECT_EQ(flat.get_column(), node->get_location().column);
+
+  ASSERT_EQ(flat.get_token() != nullptr, node->get_token().has_value());
+  if (node->get_token().has_value()) {
+    EXPECT_EQ(flat.get_token()->token_type, node->get_token()->token_type);
+    EXPECT_EQ(flat.get_token()->value, node->get_token()->value);
+  }
+
+  ASSERT_EQ(flat.get_child_count(), node->get_children().size());
+  size_t i = 0;
+  for (FlatCSTNodeRef child : flat.get_children()) {
+    expect_flat_matches_tree(node->get_children()[i].get(), child);
+    EXPECT_EQ(child, flat.get_child(i));
+    ++i;
+  }
+  EXPECT_EQ(i, node->get_children().size());
+}
+
+/**
+ * @test FlatCSTMatchesTree
+ * @brief 测试从指针树转换得到的扁平 CST
+ * @details
+ *   验证目标：
+ *   1. 每个节点的类型、位置、Token 与子节点顺序与原树一致
+ *   2. 节点按先序存储：第一个子节点紧跟父节点，子树占据连续区间
+ */
+TEST_F(CSTNodeTest, FlatCSTMatchesTree) {
+  Lexer lexer(R"(
+    // leading comment
+    struct Point { x: Integer, y: Integer };
+    fn add(a: Integer, b: Integer) -> Integer {
+      let sum = a + b * (a - b);
+      if sum > 0 { return sum; } else { return -sum; }
+    }
+    let values: Integer[3] = [1, 2, 3];
+  )");
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens, "test.zero");
+  auto tree = parser.parse();
+  ASSERT_NE(tree, nullptr);
+
+  FlatCST flat = FlatCST::from_tree(tree.get());
+  ASSERT_FALSE(flat.empty());
+  EXPECT_EQ(flat.get_filename(), tree->get_location().get_filename());
+  expect_flat_matches_tree(tree.get(), flat.get_root());
+
+  const auto& nodes = flat.get_nodes();
+  EXPECT_EQ(nodes[0].subtree_end, nodes.size());
+  for (uint32_t i = 0; i < nodes.size(); ++i) {
+    const FlatCSTNode& node = nodes[i];
+    if (node.child_count > 0) {
+      EXPECT_EQ(node.first_child, i + 1);
+    } else {
+      EXPECT_EQ(node.first_child, FlatCST::NO_NODE);
+      EXPECT_EQ(node.subtree_end, i + 1);
+    }
+    // 兄弟节点紧接在前一个兄弟的子树之后。
+    if (node.next_sibling != FlatCST::NO_NODE) {
+      EXPECT_EQ(node.next_sibling, node.subtree_end);
+    }
+  }
+}
+
+/**
+ * @test FlatCSTFromEmptyTree
+ * @brief 测试空指针与单节点树的转换
+ */
+TEST_F(CSTNodeTest, FlatCSTFromEmptyTree) {
+  EXPECT_TRUE(FlatCST::from_tree(nullptr).empty());
+
+  auto leaf = make_cst_node(CSTNodeType::Identifier,
+                            Token(TokenType::Identifier, "x", 2, 3));
+  FlatCST flat = FlatCST::from_tree(leaf.get());
+  ASSERT_EQ(flat.size(), 1u);
+  EXPECT_TRUE(flat.get_root().get_children().empty());
+  ASSERT_NE(flat.get_root().get_token(), nullptr);
+  EXPECT_EQ(flat.get_root().get_token()->value, "x");
+  EXPECT_EQ(flat.get_root().get_line(), 2u);
+}
+
+// --- 绿树与红树测试 ---
+
+/**
+ * @brief 按先序比较指针树中的 Token 与红树按需算出的 Token。
+ */
+static void expect_red_matches_tree(const CSTNode* node, const RedNode& red) {
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(red.get_type(), node->get_type());
+
+  auto token = red.get_token();
+  ASSERT_EQ(token.has_value(), node->get_token().has_value());
+  if (token.has_value()) {
+    const Token& expected = *node->get_token();
+    EXPECT_EQ(token->token_type, expected.token_type);
+    EXPECT_EQ(token->value, expected.value);
+    EXPECT_EQ(token->offset, expected.offset) << expected.value;
+    EXPECT_EQ(token->line, expected.line) << expected.value;
+    EXPECT_EQ(token->column, expected.column) << expected.value;
+  }
+
+  auto children = red.get_children();
+  ASSERT_EQ(children.size(), node->get_children().size());
+  for (size_t i = 0; i < children.size(); ++i) {
+    expect_red_matches_tree(node->get_children()[i].get(), children[i]);
+  }
+}
+
+static const char* const GREEN_SOURCE = R"(// leading comment
+struct Point { x: Integer, y: Integer };
+fn add(a: Integer, b: Integer) -> Integer {
+  let sum = a + b * (a - b);
+  if sum > 0 { return sum; } else { return -sum; }
+}
+let message = "multi
+line";
+let values: Integer[3] = [1, 2, 3];
+)";
+
+/**
+ * @test GreenTreeRoundTripsTextAndPositions
+ * @brief 测试绿树还原源码，红树算出的 Token 位置与原树一致
+ */
+TEST_F(CSTNodeTest, GreenTreeRoundTripsTextAndPositions) {
+  std::string source = GREEN_SOURCE;
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens, "test.zero");
+  auto tree = parser.parse();
+  ASSERT_NE(tree, nullptr);
+
+  GreenCache cache;
+  const GreenNode* green = cache.from_tree(tree.get(), source);
+  ASSERT_NE(green, nullptr);
+  // 末尾的换行在最后一个 Token 之后，不属于任何节点。
+  EXPECT_EQ(green->to_text(), source.substr(0, source.size() - 1));
+  EXPECT_EQ(green->get_extent(),
+            TextExtent::measure(source.substr(0, source.size() - 1)));
+
+  RedNode root(green);
+  expect_red_matches_tree(tree.get(), root);
+  EXPECT_EQ(root.get_end().offset, source.size() - 1);
+
+  EXPECT_EQ(cache.from_tree(nullptr, source), nullptr);
+}
+
+/**
+ * @test GreenTreeSharesSubtreesAcrossEdits
+ * @brief 测试编辑前后未改变的子树共享同一个绿节点
+ * @details
+ *   验证目标：
+ *   1. 在文件开头插入声明后，其后的顶层条目都复用原有节点
+ *   2. 复用的节点在新位置上算出的 Token 位置与重新解析的结果一致
+ *   3. 内容相同的文件得到同一棵树
+ */
+TEST_F(CSTNodeTest, GreenTreeSharesSubtreesAcrossEdits) {
+  std::string before = GREEN_SOURCE;
+  std::string after = "let inserted = 1;\n" + before;
+
+  GreenCache cache;
+  auto build = [&cache](const std::string& source,
+                        std::unique_ptr<CSTNode>& tree) {
+    Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+    parser::Parser parser(tokens, "test.zero");
+    tree = parser.parse();
+    return cache.from_tree(tree.get(), source);
+  };
+
+  std::unique_ptr<CSTNode> old_tree;
+  std::unique_ptr<CSTNode> new_tree;
+  const GreenNode* old_green = build(before, old_tree);
+  size_t distinct = cache.size();
+  const GreenNode* new_green = build(after, new_tree);
+
+  // 开头的注释成为插入的声明的尾随注释，其余顶层条目的文本不变，
+  // 整棵子树被复用。
+  const auto& old_items = old_green->get_children();
+  const auto& new_items = new_green->get_children();
+  ASSERT_EQ(new_items.size(), old_items.size());
+  EXPECT_NE(new_items[0], old_items[0]);
+  for (size_t i = 1; i < old_items.size(); ++i) {
+    EXPECT_EQ(new_items[i], old_items[i]) << "item #" << i;
+  }
+  // 新增的只有插入的声明与根节点。
+  EXPECT_LT(cache.size() - distinct, 12u);
+
+  expect_red_matches_tree(new_tree.get(), RedNode(new_green));
+
+  std::unique_ptr<CSTNode> copy_tree;
+  EXPECT_EQ(build(before, copy_tree), old_green);
+}
+
+/**
+ * @test GreenTreeFindsTokenAtOffset
+ * @brief 测试按字节偏移量定位 Token
+ */
+TEST_F(CSTNodeTest, GreenTreeFindsTokenAtOffset) {
+  std::string source = "let total = first + second;";
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens);
+  auto tree = parser.parse();
+
+  GreenCache cache;
+  RedNode root(cache.from_tree(tree.get(), source));
+
+  auto found = root.find_token_at(source.find("second") + 2);
+  ASSERT_TRUE(found.has_value());
+  ASSERT_TRUE(found->get_token().has_value());
+  EXPECT_EQ(found->get_token()->value, "second");
+  EXPECT_EQ(found->get_token()->column, source.find("second") + 1);
+
+  // 空白属于下一个 Token 的前导文本，不属于任何 Token 的原文。
+  EXPECT_FALSE(root.find_token_at(source.find(" = ")).has_value());
+  EXPECT_FALSE(root.find_token_at(source.size()).has_value());
+}
+
+/**
+ * @test NodeTraitsClassifyTypes
+ * @brief 测试节点属性表的名称与分类，以及 Token 类型名称表
+ */
+TEST_F(CSTNodeTest, NodeTraitsClassifyTypes) {
+  EXPECT_EQ(get_node_traits(CSTNodeType::FnDeclaration).name, "FnDeclaration");
+  EXPECT_EQ(cst_node_type_to_string(CSTNodeType::Comment), "Comment");
+  EXPECT_EQ(cst_node_type_to_string(
+                static_cast<CSTNodeType>(CST_NODE_TYPE_COUNT)),
+            "Unknown");
+
+  EXPECT_TRUE(is_declaration(CSTNodeType::TypeAliasDeclaration));
+  EXPECT_TRUE(is_statement(CSTNodeType::WhileStmt));
+  EXPECT_TRUE(is_expression(CSTNodeType::Identifier));
+  EXPECT_TRUE(is_expression(CSTNodeType::StructLiteral));
+  EXPECT_FALSE(is_expression(CSTNodeType::ArgumentList));
+  EXPECT_TRUE(is_type(CSTNodeType::FunctionSignatureType));
+  EXPECT_FALSE(is_type(CSTNodeType::Parameter));
+  EXPECT_TRUE(is_literal(CSTNodeType::BooleanLiteral));
+  EXPECT_FALSE(is_literal(CSTNodeType::ArrayLiteral));
+  EXPECT_EQ(get_node_category(CSTNodeType::Delimiter), CSTNodeCategory::Token);
+  static_assert(is_type(CSTNodeType::UnionType));
+
+  EXPECT_EQ(token_type_name(TokenType::Arrow), "Arrow");
+  EXPECT_EQ(token_type_to_string(TokenType::EndOfFile), "EOF");
+  EXPECT_EQ(token_type_name(static_cast<TokenType>(TOKEN_TYPE_COUNT)),
+            "Unknown");
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_cst_cache.cpp
+ * @brief Token 序列与 CST 二进制缓存格式（`cst_cache`）的测试。
+ * @details 覆盖 CST 与 Token 序列的往返、源码或版本不符与数据损坏时的
+ *          拒绝，以及缓存目录的保存与载入。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/cst/cst_cache.hpp"
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/utils/source_manager.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace czc;
+using namespace czc::cst;
+
+namespace {
+
+constexpr utils::FileId STDIN_FILE = utils::SourceManager::STDIN_FILE;
+
+const std::string SOURCE = "// 注释\n"
+                           "fn greet(name: string) -> string {\n"
+                           "    let s = \"hi \\\"\" + name;\n"
+                           "    return r\"raw\\n\" + s;\n"
+                           "}\n"
+                           "let x = 0x1F + 1.5e3;\n";
+
+std::unique_ptr<CSTNode> parse(const std::string& source) {
+  lexer::Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens);
+  return parser.parse();
+}
+
+/**
+ * @brief 递归比较两棵 CST 的类型、位置与 Token。
+ */
+void expect_same_tree(const CSTNode* expected, const CSTNode* actual) {
+  ASSERT_EQ(expected->get_type(), actual->get_type());
+  EXPECT_EQ(expected->get_location().line, actual->get_location().line);
+  EXPECT_EQ(expected->get_location().end_column,
+            actual->get_location().end_column);
+  ASSERT_EQ(expected->get_token().has_value(),
+            actual->get_token().has_value());
+  if (expected->get_token()) {
+    const auto& a = *expected->get_token();
+    const auto& b = *actual->get_token();
+    EXPECT_EQ(a.token_type, b.token_type);
+    EXPECT_EQ(a.value, b.value);
+    EXPECT_EQ(a.raw_literal, b.raw_literal);
+    EXPECT_EQ(a.is_raw_string, b.is_raw_string);
+    EXPECT_EQ(a.offset, b.offset);
+    EXPECT_EQ(a.length, b.length);
+  }
+  ASSERT_EQ(expected->get_children().size(), actual->get_children().size());
+  for (size_t i = 0; i < expected->get_children().size(); ++i) {
+    expect_same_tree(expected->get_children()[i].get(),
+                     actual->get_children()[i].get());
+  }
+}
+
+} // namespace
+
+/**
+ * @brief 测试 CST 往返后结构相同，格式化结果也相同。
+ */
+TEST(CSTCacheTest, RoundTripsTree) {
+  auto cst = parse(SOURCE);
+  std::string data = serialize_cst(cst.get(), SOURCE, "1.0");
+  auto loaded = deserialize_cst(data, SOURCE, "1.0", STDIN_FILE);
+  ASSERT_NE(loaded, nullptr);
+  expect_same_tree(cst.get(), loaded.get());
+
+  formatter::Formatter formatter;
+  EXPECT_EQ(formatter.format(cst.get()), formatter.format(loaded.get()));
+  // 大部分 Token 文本直接引用源码，数据应小于源码的若干倍
+  EXPECT_LT(data.size(), SOURCE.size() * 8);
+}
+
+/**
+ * @brief 测试源码、版本或种类不符的数据被拒绝。
+ */
+TEST(CSTCacheTest, RejectsMismatchedHeader) {
+  auto cst = parse(SOURCE);
+  std::string data = serialize_cst(cst.get(), SOURCE, "1.0");
+
+  EXPECT_EQ(deserialize_cst(data, SOURCE + " ", "1.0", STDIN_FILE),
+            nullptr);
+  EXPECT_EQ(deserialize_cst(data, SOURCE, "1.1", STDIN_FILE), nullptr);
+  EXPECT_FALSE(deserialize_tokens(data, SOURCE, "1.0").has_value());
+}
+
+/**
+ * @brief 测试截断或被改写的数据只会解码失败，不会被当作有效的数据。
+ */
+TEST(CSTCacheTest, RejectsCorruptData) {
+  auto cst = parse(SOURCE);
+  std::string data = serialize_cst(cst.get(), SOURCE, "1.0");
+
+  for (size_t length = 0; length < data.size(); ++length) {
+    EXPECT_EQ(deserialize_cst(std::string_view(data).substr(0, length), SOURCE,
+                              "1.0", STDIN_FILE),
+              nullptr);
+  }
+  std::string corrupt = data;
+  corrupt.back() = static_cast<char>(0xFF);
+  EXPECT_EQ(deserialize_cst(corrupt, SOURCE, "1.0", STDIN_FILE),
+            nullptr);
+
+  // 任意一位被翻转的数据都被拒绝，即使它恰好仍能解码。
+  lexer::Lexer lexer(SOURCE);
+  std::string tokens = serialize_tokens(lexer.tokenize(), SOURCE, "1.0");
+  for (size_t bit = 0; bit < data.size() * 8; ++bit) {
+    std::string flipped = data;
+    flipped[bit / 8] = static_cast<char>(flipped[bit / 8] ^ (1 << (bit % 8)));
+    EXPECT_EQ(deserialize_cst(flipped, SOURCE, "1.0", STDIN_FILE), nullptr)
+        << "bit " << bit;
+  }
+  for (size_t bit = 0; bit < tokens.size() * 8; ++bit) {
+    std::string flipped = tokens;
+    flipped[bit / 8] = static_cast<char>(flipped[bit / 8] ^ (1 << (bit % 8)));
+    EXPECT_FALSE(deserialize_tokens(flipped, SOURCE, "1.0").has_value())
+        << "bit " << bit;
+  }
+}
+
+/**
+ * @brief 测试 Token 序列往返后逐个相同。
+ */
+TEST(CSTCacheTest, RoundTripsTokens) {
+  lexer::Lexer lexer(SOURCE);
+  auto tokens = lexer.tokenize();
+  std::string data = serialize_tokens(tokens, SOURCE, "1.0");
+  auto loaded = deserialize_tokens(data, SOURCE, "1.0");
+  ASSERT_TRUE(loaded.has_value());
+  ASSERT_EQ(loaded->size(), tokens.size());
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    EXPECT_EQ((*loaded)[i].token_type, tokens[i].token_type);
+    EXPECT_EQ((*loaded)[i].value, tokens[i].value);
+    EXPECT_EQ((*loaded)[i].line, tokens[i].line);
+    EXPECT_EQ((*loaded)[i].column, tokens[i].column);
+  }
+}
+
+/**
+ * @brief 测试缓存目录按内容保存与载入，内容改变后不再命中。
+ */
+TEST(CSTCacheTest, StoresAndLoadsEntries) {
+  auto directory =
+      std::filesystem::temp_directory_path() / "czc_cst_cache_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  CSTCache cache(directory.string(), "1.0");
+  EXPECT_EQ(cache.load(SOURCE, STDIN_FILE), nullptr);
+
+  auto cst = parse(SOURCE);
+  ASSERT_TRUE(cache.store(SOURCE, cst.get()));
+  EXPECT_TRUE(std::filesystem::exists(cache.entry_path(SOURCE)));
+  auto loaded = cache.load(SOURCE, STDIN_FILE);
+  ASSERT_NE(loaded, nullptr);
+  expect_same_tree(cst.get(), loaded.get());
+
+  EXPECT_EQ(cache.load(SOURCE + "\n", STDIN_FILE), nullptr);
+  EXPECT_EQ(CSTCache(directory.string(), "2.0").load(SOURCE, STDIN_FILE),
+            nullptr);
+
+  std::filesystem::remove_all(directory);
+}
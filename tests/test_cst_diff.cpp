@@ -0,0 +1,128 @@
+/**
+ * @file test_cst_diff.cpp
+ * @brief CST 结构哈希（`compute_structural_hash`）与 `cst_diff` 的测试。
+ * @details 覆盖哈希与位置无关、修改后缓存失效、Parser 在解析时计算哈希，
+ *          以及增删改各种差异的报告。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/cst/cst_diff.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace czc;
+using namespace czc::cst;
+
+namespace {
+
+std::unique_ptr<CSTNode> parse(const std::string& source,
+                               bool hash_while_parsing = false) {
+  lexer::Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens);
+  parser.set_structural_hash_enabled(hash_while_parsing);
+  return parser.parse();
+}
+
+const std::string SOURCE = "fn add(a, b) {\n"
+                           "  return a + b;\n"
+                           "}\n"
+                           "let x = add(1, 2);\n"
+                           "let y = \"text\";\n";
+
+} // namespace
+
+/**
+ * @brief 测试结构与文本相同的树哈希相同，与位置无关，且对文本敏感。
+ */
+TEST(CSTDiffTest, StructuralHashIgnoresPositions) {
+  auto a = parse(SOURCE);
+  auto b = parse("\n\n   " + SOURCE);
+  auto c = parse(SOURCE + "let z = 3;\n");
+
+  uint64_t hash = compute_structural_hash(a.get());
+  EXPECT_NE(hash, 0u);
+  EXPECT_EQ(hash, compute_structural_hash(b.get()));
+  EXPECT_NE(hash, compute_structural_hash(c.get()));
+  EXPECT_NE(hash, compute_structural_hash(parse(SOURCE + "// c\n").get()));
+  EXPECT_NE(compute_structural_hash(parse("let x = 1;").get()),
+            compute_structural_hash(parse("let x = 2;").get()));
+  EXPECT_EQ(compute_structural_hash(nullptr), 0u);
+}
+
+/**
+ * @brief 测试 Parser 在解析时计算的哈希与事后计算的相同，修改会清除缓存。
+ */
+TEST(CSTDiffTest, ParserComputesHashesWhileParsing) {
+  auto hashed = parse(SOURCE, true);
+  EXPECT_NE(hashed->get_structural_hash(), 0u);
+  for (const auto& child : hashed->get_children()) {
+    EXPECT_NE(child->get_structural_hash(), 0u);
+  }
+
+  auto plain = parse(SOURCE);
+  EXPECT_EQ(plain->get_structural_hash(), 0u);
+  EXPECT_EQ(compute_structural_hash(plain.get()),
+            hashed->get_structural_hash());
+
+  hashed->add_child(
+      make_cst_node(CSTNodeType::Comment, lexer::Token::makeEOF()));
+  EXPECT_EQ(hashed->get_structural_hash(), 0u);
+  EXPECT_NE(compute_structural_hash(hashed.get()),
+            plain->get_structural_hash());
+}
+
+/**
+ * @brief 测试相同的树没有差异，修改的 Token 报告为最深处的一对节点。
+ */
+TEST(CSTDiffTest, ReportsModifiedTokens) {
+  auto a = parse(SOURCE);
+  EXPECT_TRUE(cst_diff(a.get(), parse(SOURCE).get()).empty());
+
+  std::string edited = SOURCE;
+  edited.replace(edited.find("a + b"), 5, "a - b");
+  auto b = parse(edited);
+  auto changes = cst_diff(a.get(), b.get());
+  ASSERT_EQ(changes.size(), 1u);
+  EXPECT_EQ(changes[0].kind, CSTChangeKind::Modified);
+  ASSERT_TRUE(changes[0].old_node->get_token().has_value());
+  EXPECT_EQ(changes[0].old_node->get_token()->value, "+");
+  EXPECT_EQ(changes[0].new_node->get_token()->value, "-");
+}
+
+/**
+ * @brief 测试插入与删除顶层声明时其余声明按哈希对齐，不报告差异。
+ */
+TEST(CSTDiffTest, AlignsInsertedAndRemovedDeclarations) {
+  auto a = parse(SOURCE);
+  auto b = parse("let first = 0;\n" + SOURCE + "struct P { x: Integer };\n");
+
+  auto changes = cst_diff(a.get(), b.get());
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0].kind, CSTChangeKind::Inserted);
+  EXPECT_EQ(changes[0].new_node->get_type(), CSTNodeType::VarDeclaration);
+  EXPECT_EQ(changes[1].kind, CSTChangeKind::Inserted);
+  EXPECT_EQ(changes[1].new_node->get_type(), CSTNodeType::StructDeclaration);
+
+  changes = cst_diff(b.get(), a.get());
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0].kind, CSTChangeKind::Removed);
+  EXPECT_EQ(changes[1].kind, CSTChangeKind::Removed);
+  EXPECT_EQ(changes[1].new_node, nullptr);
+
+  // 类型不同的一对声明报告为删除加插入。
+  auto c = parse("fn add(a, b) {\n  return a + b;\n}\n"
+                 "struct Q { y: Integer };\n"
+                 "let y = \"text\";\n");
+  changes = cst_diff(a.get(), c.get());
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0].kind, CSTChangeKind::Removed);
+  EXPECT_EQ(changes[0].old_node->get_type(), CSTNodeType::VarDeclaration);
+  EXPECT_EQ(changes[1].kind, CSTChangeKind::Inserted);
+  EXPECT_EQ(changes[1].new_node->get_type(), CSTNodeType::StructDeclaration);
+}
@@ -0,0 +1,556 @@
+/**
+ * @file test_diagnostics.cpp
+ * @brief 诊断引擎测试套件（使用 Google Test 框架）。
+ * @details 测试 `DiagnosticEngine` 以紧凑记录保存诊断、在打印时才提取
+ *          源码行、超出保存上限后只计数不保存，以及 `clear` 后的
+ *          复用；`I18nMessages` 预先拆分占位符后的格式化结果、编译进库
+ *          的语言环境与懒加载，诊断代码与字符串之间的转换，各阶段的
+ *          错误收集器共享同一个引擎时的行为，以及多个线程经由
+ *          `DiagnosticSink` 报告后合并的顺序与串行报告一致；达到错误
+ *          上限后引擎丢弃之后的错误，共享它的各阶段提前停止。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/diagnostics/diagnostic.hpp"
+#include "czc/diagnostics/diagnostic_sink.hpp"
+#include "czc/diagnostics/embedded_locales.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/token_preprocessor/preprocessed_token_source.hpp"
+#include "czc/utils/module_error_collector.hpp"
+#include "czc/utils/source_tracker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace czc::diagnostics;
+using namespace czc::utils;
+
+TEST(DiagnosticEngineTest, ReportsErrorListsWithoutSourceLines) {
+  czc::lexer::Lexer lexer("let a = 0x;\nlet b = 0b;\n", "test.zero");
+  (void)lexer.tokenize();
+  ASSERT_EQ(lexer.get_errors().get_errors().size(), 2u);
+
+  DiagnosticEngine engine;
+  engine.report_errors(lexer.get_errors().get_errors());
+  EXPECT_TRUE(engine.has_errors());
+  EXPECT_EQ(engine.get_error_count(), 2u);
+  ASSERT_EQ(engine.size(), 2u);
+
+  // 未关联源码跟踪器时不显示源码行。
+  Diagnostic first = engine.get_diagnostic(0);
+  EXPECT_EQ(first.get_code(), DiagnosticCode::L0001_MissingHexDigits);
+  EXPECT_EQ(first.get_location().get_filename(), "test.zero");
+  EXPECT_EQ(first.get_location().line, 1u);
+  EXPECT_TRUE(first.get_source_line().empty());
+
+  // 关联之后，源码行在还原时才从跟踪器中提取。
+  engine.set_source(&lexer.get_source_tracker());
+  Diagnostic second = engine.get_diagnostic(1);
+  EXPECT_EQ(second.get_code(), DiagnosticCode::L0002_MissingBinaryDigits);
+  EXPECT_EQ(second.get_location().line, 2u);
+  EXPECT_EQ(second.get_source_line(), "let b = 0b;");
+}
+
+TEST(DiagnosticEngineTest, KeepsArgumentsAndExplicitSourceLines) {
+  SourceTracker tracker("fn main() {}\n", "test.zero");
+  DiagnosticEngine engine;
+  engine.set_source(&tracker);
+
+  auto diag = std::make_shared<Diagnostic>(
+      DiagnosticLevel::Warning, DiagnosticCode::L0010_InvalidCharacter,
+      SourceLocation("other.zero", 3, 5, 3, 6),
+      std::vector<std::string>{"$"});
+  diag->set_source_line("let $ = 1;");
+  engine.report(diag);
+  engine.report(DiagnosticLevel::Error, DiagnosticCode::P0001_UnexpectedToken,
+                SourceLocation("test.zero", 1, 4, 1, 8), {"main", "ident"});
+
+  EXPECT_EQ(engine.get_error_count(), 1u);
+  EXPECT_EQ(engine.get_warning_count(), 1u);
+  ASSERT_EQ(engine.size(), 2u);
+
+  Diagnostic warning = engine.get_diagnostic(0);
+  EXPECT_EQ(warning.get_level(), DiagnosticLevel::Warning);
+  EXPECT_EQ(warning.get_location().get_filename(), "other.zero");
+  EXPECT_EQ(warning.get_location().end_column, 6u);
+  EXPECT_EQ(warning.get_args(), std::vector<std::string>{"$"});
+  EXPECT_EQ(warning.get_source_line(), "let $ = 1;");
+
+  Diagnostic error = engine.get_diagnostic(1);
+  EXPECT_EQ(error.get_args(), (std::vector<std::string>{"main", "ident"}));
+  EXPECT_EQ(error.get_source_line(), "fn main() {}");
+
+  std::ostringstream out;
+  engine.print_all(out, false);
+  EXPECT_NE(out.str().find("let $ = 1;"), std::string::npos);
+  EXPECT_NE(out.str().find("fn main() {}"), std::string::npos);
+  EXPECT_NE(out.str().find("aborting due to 1 previous error"),
+            std::string::npos);
+}
+
+/**
+ * @brief 测试打印时按字符对齐高亮标记：行内在诊断之前有多字节字符时，
+ *        标记仍落在出错的字符下方。
+ */
+TEST(DiagnosticEngineTest, AlignsCaretsByCharacters) {
+  // "名字" 各占 3 字节：`$` 的字节列号为 14，字符列号为 10。
+  SourceTracker tracker("let 名字 = $;\nlet $$ = 1;\n", "test.zero");
+  DiagnosticEngine engine;
+  engine.set_source(&tracker);
+  engine.report(DiagnosticLevel::Error, DiagnosticCode::L0010_InvalidCharacter,
+                SourceLocation("test.zero", 2, 5, 2, 7), {"$$"});
+  engine.report(DiagnosticLevel::Error, DiagnosticCode::L0010_InvalidCharacter,
+                SourceLocation("test.zero", 1, 14, 1, 15), {"$"});
+
+  std::ostringstream out;
+  engine.print_all(out, false);
+  std::string text = out.str();
+  EXPECT_NE(text.find("| let 名字 = $;\n    |" + std::string(10, ' ') + "^\n"),
+            std::string::npos)
+      << text;
+  EXPECT_NE(text.find("| let $$ = 1;\n    |" + std::string(5, ' ') + "^^\n"),
+            std::string::npos)
+      << text;
+  // 打印顺序仍是报告顺序。
+  EXPECT_LT(text.find("let $$"), text.find("let 名字"));
+}
+
+/**
+ * @brief 测试 clear 后引擎回到初始状态，可以继续用于下一个文件。
+ */
+TEST(DiagnosticEngineTest, ClearResetsForReuse) {
+  SourceTracker first("let a = 0x;\n", "a.zero");
+  DiagnosticEngine engine;
+  engine.set_source(&first);
+  engine.report(DiagnosticLevel::Error, DiagnosticCode::L0001_MissingHexDigits,
+                SourceLocation("a.zero", 1, 9, 1, 11), {"0x"});
+  ASSERT_TRUE(engine.has_errors());
+
+  engine.clear();
+  EXPECT_FALSE(engine.has_errors());
+  EXPECT_EQ(engine.get_warning_count(), 0u);
+  EXPECT_EQ(engine.size(), 0u);
+  EXPECT_EQ(engine.get_error_count("L"), 0u);
+
+  SourceTracker second("fn main() {}\n", "b.zero");
+  engine.set_source(&second);
+  engine.report(DiagnosticLevel::Error, DiagnosticCode::P0001_UnexpectedToken,
+                SourceLocation("b.zero", 1, 4, 1, 8), {"main", "ident"});
+  EXPECT_EQ(engine.get_error_count(), 1u);
+  ASSERT_EQ(engine.size(), 1u);
+  Diagnostic error = engine.get_diagnostic(0);
+  EXPECT_EQ(error.get_args(), (std::vector<std::string>{"main", "ident"}));
+  EXPECT_EQ(error.get_source_line(), "fn main() {}");
+}
+
+TEST(DiagnosticEngineTest, CountsBeyondRetentionLimit) {
+  DiagnosticEngine engine;
+  engine.set_max_retained(3);
+  for (size_t i = 1; i <= 1000; ++i) {
+    engine.report(DiagnosticLevel::Error,
+                  DiagnosticCode::L0010_InvalidCharacter,
+                  SourceLocation("test.zero", i, 1), {"@"});
+  }
+
+  EXPECT_EQ(engine.get_error_count(), 1000u);
+  ASSERT_EQ(engine.size(), 3u);
+  EXPECT_EQ(engine.get_diagnostic(2).get_location().line, 3u);
+
+  std::ostringstream out;
+  engine.print_all(out, false);
+  EXPECT_NE(out.str().find("aborting due to 1000 previous errors"),
+            std::string::npos);
+}
+
+TEST(DiagnosticEngineTest, DropsErrorsBeyondErrorLimit) {
+  DiagnosticEngine engine;
+  engine.set_error_limit(2);
+  for (size_t i = 1; i <= 5; ++i) {
+    engine.report(DiagnosticLevel::Error,
+                  DiagnosticCode::L0010_InvalidCharacter,
+                  SourceLocation("test.zero", i, 1), {"@"});
+    EXPECT_EQ(engine.error_limit_reached(), i >= 2) << i;
+  }
+  engine.report(DiagnosticLevel::Warning,
+                DiagnosticCode::L0010_InvalidCharacter,
+                SourceLocation("test.zero", 6, 1), {"@"});
+
+  EXPECT_EQ(engine.get_error_count(), 2u);
+  EXPECT_EQ(engine.get_warning_count(), 1u);
+  ASSERT_EQ(engine.size(), 3u);
+  EXPECT_EQ(engine.get_diagnostic(1).get_location().line, 2u);
+
+  // 上限在 `clear` 之后仍然有效。
+  engine.clear();
+  EXPECT_FALSE(engine.error_limit_reached());
+  engine.report(DiagnosticLevel::Error, DiagnosticCode::L0010_InvalidCharacter,
+                SourceLocation("test.zero", 1, 1), {"@"});
+  engine.report(DiagnosticLevel::Error, DiagnosticCode::L0010_InvalidCharacter,
+                SourceLocation("test.zero", 2, 1), {"@"});
+  EXPECT_TRUE(engine.error_limit_reached());
+}
+
+TEST(DiagnosticCodeTest, ConvertsToAndFromStrings) {
+  EXPECT_EQ(diagnostic_code_to_string(DiagnosticCode::L0001_MissingHexDigits),
+            "L0001");
+  EXPECT_EQ(diagnostic_code_to_string(DiagnosticCode::P0014_NestingTooDeep),
+            "P0014");
+  EXPECT_EQ(
+      diagnostic_code_to_string(DiagnosticCode::S0013_ExpectedStructFieldInit),
+      "S0013");
+
+  EXPECT_EQ(diagnostic_code_from_string("T0002"),
+            DiagnosticCode::T0002_ScientificFloatOverflow);
+  EXPECT_EQ(diagnostic_code_from_string("S0012"),
+            DiagnosticCode::S0012_DuplicateFieldName);
+  EXPECT_FALSE(diagnostic_code_from_string("L0000").has_value());
+  EXPECT_FALSE(diagnostic_code_from_string("X0001").has_value());
+  EXPECT_FALSE(diagnostic_code_from_string("L001").has_value());
+  EXPECT_FALSE(diagnostic_code_from_string("L00a1").has_value());
+}
+
+/**
+ * @brief 在临时目录中写入一个测试用的语言环境，并通过 `ZERO_LOCALE_PATH`
+ *        让 `I18nMessages` 加载它。
+ */
+class I18nMessagesTest : public ::testing::Test {
+protected:
+  std::filesystem::path root;
+
+  void SetUp() override {
+    root = std::filesystem::temp_directory_path() / "czc_i18n_test";
+    std::filesystem::create_directories(root / "xx_TEST");
+    std::ofstream file(root / "xx_TEST" / "diagnostics.toml");
+    file << "[L0001]\n"
+            "message = \"{0} and {1}, again {0}\"\n"
+            "help = \"use {{...}}\"\n"
+            "source = \"lexer\"\n"
+            "\n"
+            "[L0010]\n"
+            "message = \"braces {x} {01} {} {2}\"\n"
+            "\n"
+            "[P0001]\n"
+            "message = \"plain text\"\n"
+            "\n"
+            "[not_a_code]\n"
+            "message = \"ignored\"\n";
+    file.close();
+#if defined(_WIN32)
+    _putenv_s("ZERO_LOCALE_PATH", root.string().c_str());
+#else
+    setenv("ZERO_LOCALE_PATH", root.string().c_str(), 1);
+#endif
+  }
+
+  void TearDown() override {
+#if defined(_WIN32)
+    _putenv_s("ZERO_LOCALE_PATH", "");
+#else
+    unsetenv("ZERO_LOCALE_PATH");
+#endif
+    std::filesystem::remove_all(root);
+  }
+};
+
+TEST_F(I18nMessagesTest, FormatsPrecompiledTemplates) {
+  I18nMessages messages("xx_TEST");
+
+  EXPECT_EQ(messages.format_message(DiagnosticCode::L0001_MissingHexDigits,
+                                    {"a", "b"}),
+            "a and b, again a");
+  // 参数中的占位符不会再被替换，缺少的参数保留原样。
+  EXPECT_EQ(messages.format_message(DiagnosticCode::L0001_MissingHexDigits,
+                                    {"{1}"}),
+            "{1} and {1}, again {1}");
+  EXPECT_EQ(messages.format_message(DiagnosticCode::L0010_InvalidCharacter,
+                                    {"a", "b", "c"}),
+            "braces {x} {01} {} c");
+  EXPECT_EQ(messages.format_message(DiagnosticCode::P0001_UnexpectedToken, {}),
+            "plain text");
+
+  const MessageTemplate& tmpl =
+      messages.get_message(DiagnosticCode::L0001_MissingHexDigits);
+  EXPECT_EQ(tmpl.help, "use {{...}}");
+  EXPECT_EQ(tmpl.source, "lexer");
+
+  std::string out = "> ";
+  messages.append_message(out, DiagnosticCode::L0001_MissingHexDigits,
+                          {"x", "y"});
+  EXPECT_EQ(out, "> x and y, again x");
+}
+
+TEST_F(I18nMessagesTest, FallsBackForMissingCodes) {
+  I18nMessages messages("xx_TEST");
+  EXPECT_EQ(
+      messages.format_message(DiagnosticCode::S0001_ExpectedStructName, {}),
+      "unknown error");
+  EXPECT_EQ(messages.get_message(DiagnosticCode::T0002_ScientificFloatOverflow)
+                .source,
+            "system");
+}
+
+TEST(EmbeddedLocaleTest, LoadsWithoutLocaleFiles) {
+  const EmbeddedLocale* embedded = find_embedded_locale("en_US");
+  if (embedded == nullptr) {
+    GTEST_SKIP() << "built without CZC_EMBED_LOCALES";
+  }
+  ASSERT_GT(embedded->message_count, 0u);
+  EXPECT_EQ(find_embedded_locale("xx_NONE"), nullptr);
+
+  // 在没有 locales 目录的工作目录中构造，消息只能来自编译进库的目录。
+  auto previous = std::filesystem::current_path();
+  auto empty = std::filesystem::temp_directory_path() / "czc_embedded_locale";
+  std::filesystem::create_directories(empty / "a" / "b");
+  std::filesystem::current_path(empty / "a" / "b");
+
+  I18nMessages english("en_US");
+  I18nMessages chinese("zh_CN");
+  I18nMessages fallback("xx_NONE");
+  std::string hex = english.format_message(
+      DiagnosticCode::L0001_MissingHexDigits, {});
+  std::string hex_zh = chinese.format_message(
+      DiagnosticCode::L0001_MissingHexDigits, {});
+  std::string hex_fallback = fallback.format_message(
+      DiagnosticCode::L0001_MissingHexDigits, {});
+  std::string suffix = english.format_message(
+      DiagnosticCode::L0005_InvalidTrailingChar, {"abc"});
+
+  // 切换语言环境后重新加载。
+  english.set_locale("zh_CN");
+  std::string switched = english.format_message(
+      DiagnosticCode::L0001_MissingHexDigits, {});
+
+  std::filesystem::current_path(previous);
+  std::filesystem::remove_all(empty);
+
+  EXPECT_EQ(hex, "hexadecimal literal has no digits");
+  EXPECT_EQ(hex_fallback, hex);
+  EXPECT_NE(hex_zh, hex);
+  EXPECT_NE(hex_zh, "unknown error");
+  EXPECT_EQ(switched, hex_zh);
+  EXPECT_EQ(suffix, "invalid suffix 'abc' on numeric literal");
+}
+
+TEST(SharedDiagnosticsTest, CollectorForwardsToReporter) {
+  DiagnosticEngine engine;
+  ModuleErrorCollector collector;
+  collector.add(DiagnosticCode::L0010_InvalidCharacter,
+                SourceLocation("a.zero", 1, 2), {"@"});
+  collector.set_reporter(&engine);
+  collector.add(DiagnosticCode::L0010_InvalidCharacter,
+                SourceLocation("a.zero", 3, 4), {"#"});
+  collector.add(ModuleError(DiagnosticCode::L0007_UnterminatedString,
+                            SourceLocation("a.zero", 5, 6)));
+
+  // 关联之前的错误仍在本地，之后的只写入报告器。
+  EXPECT_EQ(collector.count(), 3u);
+  ASSERT_EQ(collector.get_errors().size(), 1u);
+  ASSERT_EQ(engine.size(), 2u);
+  EXPECT_EQ(engine.get_diagnostic(0).get_args(),
+            std::vector<std::string>{"#"});
+  EXPECT_EQ(engine.get_diagnostic(1).get_code(),
+            DiagnosticCode::L0007_UnterminatedString);
+
+  collector.clear();
+  EXPECT_FALSE(collector.has_errors());
+  EXPECT_EQ(engine.get_error_count(), 2u);
+}
+
+TEST(SharedDiagnosticsTest, StagesWriteIntoOneEngine) {
+  DiagnosticEngine engine;
+  auto source = std::make_unique<
+      czc::token_preprocessor::PreprocessedTokenSource>(
+      "let a = 0x;\nlet = 1;\n", "test.zero");
+  source->set_error_reporter(&engine);
+  const auto& stream = *source;
+  engine.set_source(&stream.get_source_tracker());
+  czc::parser::Parser parser(std::move(source), "test.zero");
+  parser.set_error_reporter(&engine);
+  auto cst = parser.parse();
+
+  EXPECT_TRUE(stream.get_lexer_errors().has_errors());
+  EXPECT_TRUE(stream.get_lexer_errors().get_errors().empty());
+  EXPECT_TRUE(parser.has_errors());
+  EXPECT_TRUE(parser.get_errors().empty());
+
+  size_t lexer_errors = engine.get_error_count("L");
+  size_t parser_errors = engine.get_error_count("PS");
+  EXPECT_EQ(lexer_errors, stream.get_lexer_errors().count());
+  EXPECT_GT(parser_errors, 0u);
+  EXPECT_EQ(engine.get_error_count(), lexer_errors + parser_errors);
+
+  std::ostringstream out;
+  engine.print_all(out, false, "L");
+  EXPECT_NE(out.str().find("[L0001]"), std::string::npos);
+  EXPECT_EQ(out.str().find("[P0"), std::string::npos);
+  EXPECT_NE(out.str().find("let a = 0x;"), std::string::npos);
+  std::string summary = "aborting due to " + std::to_string(lexer_errors) +
+                        " previous error";
+  EXPECT_NE(out.str().find(summary), std::string::npos);
+}
+
+TEST(SharedDiagnosticsTest, StagesStopAtSharedErrorLimit) {
+  std::string text;
+  for (int i = 0; i < 1000; ++i) {
+    text += "let = 1;\n";
+  }
+  // 语法错误使引擎达到上限：Parser 在当前位置结束，其余源码不再分析。
+  DiagnosticEngine engine;
+  engine.set_error_limit(3);
+  auto source = std::make_unique<
+      czc::token_preprocessor::PreprocessedTokenSource>(text, "test.zero");
+  source->set_error_reporter(&engine);
+  const auto& stream = *source;
+  czc::parser::Parser parser(std::move(source), "test.zero");
+  parser.set_error_reporter(&engine);
+  auto cst = parser.parse();
+
+  ASSERT_NE(cst, nullptr);
+  EXPECT_EQ(engine.get_error_count(), 3u);
+  EXPECT_EQ(engine.get_diagnostic(2).get_location().line, 3u);
+  EXPECT_LT(stream.get_source_tracker().get_position(), text.size() / 10);
+
+  // 词法错误使引擎达到上限：Parser 在下一个顶层声明前停止。
+  std::string lexer_errors = "let a = 0x;\n" + text;
+  engine.clear();
+  engine.set_error_limit(1);
+  auto second = std::make_unique<
+      czc::token_preprocessor::PreprocessedTokenSource>(lexer_errors,
+                                                        "test.zero");
+  second->set_error_reporter(&engine);
+  const auto& second_stream = *second;
+  czc::parser::Parser second_parser(std::move(second), "test.zero");
+  second_parser.set_error_reporter(&engine);
+  auto second_cst = second_parser.parse();
+
+  ASSERT_EQ(engine.get_error_count(), 1u);
+  EXPECT_EQ(engine.get_diagnostic(0).get_code(),
+            DiagnosticCode::L0001_MissingHexDigits);
+  ASSERT_NE(second_cst, nullptr);
+  EXPECT_FALSE(second_parser.has_errors());
+  EXPECT_LT(second_stream.get_source_tracker().get_position(), 50u);
+}
+
+/**
+ * @brief 只实现 `report(std::shared_ptr<Diagnostic>)` 的报告器，
+ *        用于验证紧凑接口的默认实现。
+ */
+class RecordingReporter : public IDiagnosticReporter {
+public:
+  std::vector<std::shared_ptr<Diagnostic>> received;
+
+  using IDiagnosticReporter::report;
+  void report(std::shared_ptr<Diagnostic> diag) override {
+    received.push_back(std::move(diag));
+  }
+  bool has_errors() const override {
+    return !received.empty();
+  }
+};
+
+TEST(SharedDiagnosticsTest, DefaultCompactReportBuildsDiagnostic) {
+  RecordingReporter reporter;
+  ModuleErrorCollector collector;
+  collector.set_reporter(&reporter);
+  collector.add(DiagnosticCode::P0003_ExpectedSemicolon,
+                SourceLocation("b.zero", 7, 8), {";"});
+
+  ASSERT_EQ(reporter.received.size(), 1u);
+  EXPECT_EQ(reporter.received[0]->get_level(), DiagnosticLevel::Error);
+  EXPECT_EQ(reporter.received[0]->get_location().line, 7u);
+  EXPECT_EQ(reporter.received[0]->get_args(), std::vector<std::string>{";"});
+}
+
+namespace {
+
+/**
+ * @brief 解析一段源码，全部阶段的诊断都报告给 `reporter`。
+ */
+void parse_into(IDiagnosticReporter& reporter, const std::string& source,
+                const std::string& filename) {
+  auto tokens = std::make_unique<
+      czc::token_preprocessor::PreprocessedTokenSource>(source, filename);
+  tokens->set_error_reporter(&reporter);
+  czc::parser::Parser parser(std::move(tokens), filename);
+  parser.set_error_reporter(&reporter);
+  (void)parser.parse();
+}
+
+} // namespace
+
+/**
+ * @brief 测试多个线程经由同一个接收器报告，合并后的输出与串行报告一致。
+ */
+TEST(DiagnosticSinkTest, MergedOrderMatchesSerialRun) {
+  constexpr size_t FILES = 8;
+  std::vector<std::string> names;
+  std::vector<std::string> sources;
+  for (size_t i = 0; i < FILES; ++i) {
+    names.push_back("sink_" + std::to_string(i) + ".zero");
+    sources.push_back("let a = 0x;\nfn f( {\nlet = " + std::to_string(i) +
+                      ";\n");
+  }
+
+  // 串行执行时各文件按顺序登记，之后的并行执行沿用相同的编号。
+  DiagnosticEngine serial;
+  for (size_t i = 0; i < FILES; ++i) {
+    parse_into(serial, sources[i], names[i]);
+  }
+
+  DiagnosticSink sink;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      // 倒序处理，使报告的先后与文件顺序无关。
+      for (size_t i = FILES; i-- > 0;) {
+        if (i % 4 == t) {
+          parse_into(sink, sources[i], names[i]);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(sink.has_errors());
+  EXPECT_EQ(sink.get_error_count(), serial.get_error_count());
+  EXPECT_EQ(sink.size(), serial.size());
+
+  DiagnosticEngine merged;
+  sink.merge_into(merged);
+  EXPECT_EQ(sink.size(), 0u);
+  std::ostringstream expected;
+  std::ostringstream actual;
+  serial.print_all(expected, false);
+  merged.print_all(actual, false);
+  EXPECT_EQ(actual.str(), expected.str());
+}
+
+/**
+ * @brief 测试以诊断对象报告时保留显式给出的源码行。
+ */
+TEST(DiagnosticSinkTest, KeepsDiagnosticObjects) {
+  DiagnosticSink sink;
+  auto diag = std::make_shared<Diagnostic>(
+      DiagnosticLevel::Warning, DiagnosticCode::P0003_ExpectedSemicolon,
+      SourceLocation("sink_object.zero", 2, 1), std::vector<std::string>{";"});
+  diag->set_source_line("let x = 1");
+  sink.report(diag);
+  EXPECT_FALSE(sink.has_errors());
+
+  DiagnosticEngine engine;
+  sink.merge_into(engine);
+  ASSERT_EQ(engine.size(), 1u);
+  EXPECT_EQ(engine.get_warning_count(), 1u);
+  EXPECT_EQ(engine.get_diagnostic(0).get_source_line(), "let x = 1");
+}
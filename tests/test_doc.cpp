@@ -0,0 +1,109 @@
+/**
+ * @file test_doc.cpp
+ * @brief 文档中间表示与排版器测试套件。
+ * @details 测试组的平铺与断行判断、嵌套缩进、if_break 以及行尾预留宽度。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/doc.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace czc::formatter;
+
+/**
+ * @brief 文档测试夹具。
+ */
+class DocTest : public ::testing::Test {
+protected:
+  Document doc;
+
+  /**
+   * @brief 构建 `name(arg1, arg2, ...)` 形式的可断行调用。
+   */
+  DocId call(const std::string& name, std::initializer_list<DocId> args) {
+    std::vector<DocId> parts = {doc.softline()};
+    bool first = true;
+    for (DocId arg : args) {
+      if (!first) {
+        parts.push_back(doc.text(","));
+        parts.push_back(doc.line());
+      }
+      parts.push_back(arg);
+      first = false;
+    }
+    return doc.concat(
+        {doc.text(name + "("),
+         doc.group(doc.concat({doc.nest(doc.concat(parts)), doc.softline()})),
+         doc.text(")")});
+  }
+
+  std::string print(DocId root, size_t width, size_t tail = 0) {
+    DocLayout layout;
+    layout.max_width = width;
+    layout.indent_text = "  ";
+    layout.indent_columns = 2;
+    layout.reserved_tail = tail;
+    std::string out;
+    print_document(doc, root, layout, out);
+    return out;
+  }
+};
+
+/**
+ * @brief 测试能放进行宽的组保持平铺。
+ */
+TEST_F(DocTest, GroupStaysFlatWhenItFits) {
+  DocId root = call("f", {doc.text("a"), doc.text("b")});
+  EXPECT_EQ(print(root, 80), "f(a, b)");
+}
+
+/**
+ * @brief 测试放不下的组在其 line 处断行并缩进一级。
+ */
+TEST_F(DocTest, GroupBreaksWhenTooWide) {
+  DocId root = call("f", {doc.text("alpha"), doc.text("beta")});
+  EXPECT_EQ(print(root, 10), "f(\n  alpha,\n  beta\n)");
+}
+
+/**
+ * @brief 测试外层组断行后，内层组仍可独立平铺。
+ */
+TEST_F(DocTest, InnerGroupDecidesIndependently) {
+  DocId inner = call("g", {doc.text("x"), doc.text("y")});
+  DocId root = call("f", {inner, doc.text("long_argument_name")});
+  EXPECT_EQ(print(root, 20), "f(\n  g(x, y),\n  long_argument_name\n)");
+}
+
+/**
+ * @brief 测试行尾预留宽度会迫使刚好放下的组断行。
+ */
+TEST_F(DocTest, ReservedTailCountsTowardsWidth) {
+  DocId root = call("f", {doc.text("a"), doc.text("b")});
+  EXPECT_EQ(print(root, 7), "f(a, b)");
+  EXPECT_EQ(print(root, 7, 1), "f(\n  a,\n  b\n)");
+}
+
+/**
+ * @brief 测试 if_break 按所在组的状态选择内容。
+ */
+TEST_F(DocTest, IfBreakFollowsEnclosingGroup) {
+  DocId root = doc.group(doc.concat(
+      {doc.text("["), doc.nest(doc.concat({doc.softline(), doc.text("item")})),
+       doc.if_break(doc.text(","), doc.concat({})), doc.softline(),
+       doc.text("]")}));
+  EXPECT_EQ(print(root, 80), "[item]");
+  EXPECT_EQ(print(root, 4), "[\n  item,\n]");
+}
+
+/**
+ * @brief 测试显示宽度按 UTF-8 码点计算。
+ */
+TEST_F(DocTest, DisplayWidthCountsCodePoints) {
+  EXPECT_EQ(display_width("abc"), 3u);
+  EXPECT_EQ(display_width("\xE4\xBD\xA0\xE5\xA5\xBD"), 2u);
+  EXPECT_EQ(display_width(""), 0u);
+}
@@ -6,6 +6,7 @@
  */
 
 #include "czc/lexer/lexer.hpp"
+#include "czc/parser/bracket_table.hpp"
 #include "czc/parser/parser.hpp"
 
 #include <gtest/gtest.h>
@@ -197,3 +198,146 @@ TEST_F(ErrorRecoveryTest, ConsecutiveErrors) {
   EXPECT_TRUE(parser.has_errors());
   ASSERT_NE(tree, nullptr);
 }
+
+// --- Nesting Depth Limit Tests ---
+
+/**
+ * @brief Parses `source` and returns how many P0014 errors were reported.
+ */
+static size_t count_nesting_errors(const std::string& source, size_t max_depth,
+                                   size_t* total_errors = nullptr) {
+  Lexer lexer(source);
+  Parser parser(lexer.tokenize());
+  parser.set_max_depth(max_depth);
+  auto tree = parser.parse();
+  EXPECT_NE(tree, nullptr);
+
+  size_t count = 0;
+  for (const auto& error : parser.get_errors()) {
+    if (error.code == czc::diagnostics::DiagnosticCode::P0014_NestingTooDeep) {
+      ++count;
+    }
+  }
+  if (total_errors != nullptr) {
+    *total_errors = parser.get_errors().size();
+  }
+  return count;
+}
+
+TEST_F(ErrorRecoveryTest, NestingWithinLimitParses) {
+  // 一条语句本身占两层（声明 + 表达式），每层括号再占一层。
+  std::string source = "let x = " + std::string(30, '(') + "1" +
+                       std::string(30, ')') + ";";
+  size_t total = 0;
+  EXPECT_EQ(count_nesting_errors(source, 32, &total), 0u);
+  EXPECT_EQ(total, 0u);
+  EXPECT_EQ(count_nesting_errors(source, 31), 1u);
+}
+
+TEST_F(ErrorRecoveryTest, DeepNestingReportsSingleDiagnostic) {
+  const size_t levels = 200000;
+  std::vector<std::string> sources = {
+      "let x = " + std::string(levels, '(') + "1" + std::string(levels, ')') +
+          ";",
+      "let x = " + std::string(levels, '[') + "1" + std::string(levels, ']') +
+          ";",
+      "fn f() " + std::string(levels, '{') + std::string(levels, '}'),
+      "let x = " + std::string(levels, '-') + "1;",
+      "let x: " + std::string(levels, '(') + "T" + std::string(levels, ')') +
+          " = 1;",
+  };
+
+  for (const auto& source : sources) {
+    size_t total = 0;
+    EXPECT_EQ(count_nesting_errors(source, Parser::DEFAULT_MAX_DEPTH, &total),
+              1u);
+    // 放弃解析后不应再产生级联错误。
+    EXPECT_EQ(total, 1u);
+  }
+}
+
+TEST_F(ErrorRecoveryTest, LongOperatorChainIsNotNesting) {
+  // 左结合的运算链在循环中展开，不计入嵌套深度；
+  // 析构这样一棵左深的树也不应耗尽调用栈。
+  std::string source = "let x = 1";
+  for (int i = 0; i < 200000; ++i) {
+    source += " + 1";
+  }
+  source += ";";
+  size_t total = 0;
+  EXPECT_EQ(count_nesting_errors(source, 8, &total), 0u);
+  EXPECT_EQ(total, 0u);
+}
+
+TEST_F(ErrorRecoveryTest, StrayTopLevelBrace) {
+  // 顶层多余的 `}` 应报告错误并被跳过，之后的声明照常解析。
+  std::string source = "let a = 1;\n}\nlet b = 2;\n";
+
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  Parser parser(tokens);
+  auto tree = parser.parse();
+
+  EXPECT_TRUE(parser.has_errors());
+  ASSERT_NE(tree, nullptr);
+  const auto& children = tree->get_children();
+  ASSERT_FALSE(children.empty());
+  EXPECT_EQ(children.back()->get_type(), CSTNodeType::VarDeclaration);
+}
+
+// --- Cascading Error Cap Tests ---
+
+TEST_F(ErrorRecoveryTest, BracketTableMatchesEachKindSeparately) {
+  Lexer lexer("{ ( [ } ) { } ]");
+  auto tokens = lexer.tokenize();
+  BracketTable table(tokens);
+
+  // 三种括号各自配对，交错不会影响大括号。
+  EXPECT_EQ(table.get_match(0), 3u);
+  EXPECT_EQ(table.get_match(3), 0u);
+  EXPECT_EQ(table.get_match(1), 4u);
+  EXPECT_EQ(table.get_match(2), 7u);
+  EXPECT_EQ(table.get_match(5), 6u);
+
+  EXPECT_EQ(table.get_enclosing_brace(0), BracketTable::NONE);
+  EXPECT_EQ(table.get_enclosing_brace(2), 0u);
+  // `}` 归属它所闭合的代码块。
+  EXPECT_EQ(table.get_enclosing_brace(3), 0u);
+  EXPECT_EQ(table.get_enclosing_brace(4), BracketTable::NONE);
+  EXPECT_EQ(table.get_enclosing_brace(6), 5u);
+  EXPECT_EQ(table.get_match(tokens.size() - 1), BracketTable::NONE);
+}
+
+TEST_F(ErrorRecoveryTest, CascadingErrorsAreCappedPerBlock) {
+  std::string source = "fn broken() {\n";
+  for (int i = 0; i < 500; ++i) {
+    source += "  let = 1;\n  x + ;\n";
+  }
+  source += "}\nfn ok() { return 1; }\n";
+
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  // 物化的 Token 序列借助配对表跳转；流式数据源逐个扫描，结果应一致。
+  Parser fast(tokens);
+  auto fast_tree = fast.parse();
+  Parser slow(std::make_unique<LexerTokenSource>(source));
+  auto slow_tree = slow.parse();
+
+  ASSERT_TRUE(fast.has_errors());
+  EXPECT_LE(fast.get_errors().size(), Parser::MAX_ERRORS_PER_BLOCK + 2);
+  ASSERT_EQ(fast.get_errors().size(), slow.get_errors().size());
+  for (size_t i = 0; i < fast.get_errors().size(); ++i) {
+    EXPECT_EQ(fast.get_errors()[i].code, slow.get_errors()[i].code);
+    EXPECT_EQ(fast.get_errors()[i].location.line,
+              slow.get_errors()[i].location.line);
+  }
+
+  // 跳过损坏的代码块后，后续声明照常解析。
+  for (const auto* tree : {fast_tree.get(), slow_tree.get()}) {
+    const auto& children = tree->get_children();
+    ASSERT_EQ(children.size(), 2u);
+    EXPECT_EQ(children[1]->get_type(), CSTNodeType::FnDeclaration);
+  }
+}
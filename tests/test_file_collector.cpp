@@ -0,0 +1,203 @@
+/**
+ * @file test_file_collector.cpp
+ * @brief 文件收集器测试套件（使用 Google Test 框架）。
+ * @details 测试预编译的通配符匹配器、递归模式、`.gitignore` 排除、
+ *          并行遍历，以及目录索引的复用与失效。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/file_collector.hpp"
+#include "czc/utils/glob.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace czc::utils;
+namespace fs = std::filesystem;
+
+/**
+ * @brief 测试模式的根目录划分与逐段匹配。
+ */
+TEST(GlobPatternTest, CompilesRootAndSegments) {
+  GlobPattern pattern("src/lib/**/*.zero");
+  EXPECT_EQ(pattern.get_root(), "src/lib");
+  ASSERT_EQ(pattern.get_segments().size(), 2u);
+  EXPECT_TRUE(pattern.get_segments()[0].is_recursive());
+
+  EXPECT_TRUE(pattern.matches({"a.zero"}));
+  EXPECT_TRUE(pattern.matches({"x", "y", "a.zero"}));
+  EXPECT_FALSE(pattern.matches({"x", "a.txt"}));
+  EXPECT_TRUE(pattern.may_contain({"x", "y"}));
+
+  GlobPattern nested("/abs/*/main.?ero");
+  EXPECT_EQ(nested.get_root(), "/abs");
+  EXPECT_TRUE(nested.matches({"app", "main.zero"}));
+  EXPECT_FALSE(nested.matches({"main.zero"}));
+  EXPECT_TRUE(nested.may_contain({"app"}));
+  EXPECT_FALSE(nested.may_contain({"app", "deeper"}));
+
+  GlobSegment segment("test_*.zero");
+  EXPECT_TRUE(segment.matches("test_lexer.zero"));
+  EXPECT_TRUE(segment.matches("test_.zero"));
+  EXPECT_FALSE(segment.matches("test.zero"));
+  EXPECT_FALSE(segment.matches("test_lexer.zerox"));
+  EXPECT_TRUE(wildcard_match("abcabd", "*ab?"));
+}
+
+/**
+ * @brief 文件收集器测试夹具，提供一个独立的临时目录。
+ */
+class FileCollectorTest : public ::testing::Test {
+protected:
+  fs::path root;
+
+  void SetUp() override {
+    root = fs::temp_directory_path() /
+           ("czc_file_collector_" +
+            std::string(::testing::UnitTest::GetInstance()
+                            ->current_test_info()
+                            ->name()));
+    fs::remove_all(root);
+    fs::create_directories(root);
+  }
+
+  void TearDown() override {
+    fs::remove_all(root);
+  }
+
+  void touch(const std::string& relative, const std::string& content = "") {
+    fs::path path = root / relative;
+    fs::create_directories(path.parent_path());
+    std::ofstream output(path, std::ios::binary);
+    output << content;
+  }
+
+  std::string at(const std::string& relative) const {
+    return (root / relative).string();
+  }
+
+  std::vector<std::string> collect(const std::string& pattern,
+                                   const CollectOptions& options = {}) {
+    return FileCollector::collect_files({root.string() + "/" + pattern},
+                                        options);
+  }
+
+  // 把目录的修改时间设到过去，使其列表可以写入索引。
+  void age(const std::string& relative) {
+    fs::last_write_time(root / relative, fs::file_time_type::clock::now() -
+                                             std::chrono::hours(1));
+  }
+};
+
+/**
+ * @brief 测试单层模式只匹配该目录下的文件，具体路径原样保留。
+ */
+TEST_F(FileCollectorTest, ExpandsSingleDirectoryPattern) {
+  touch("b.zero");
+  touch("a.zero");
+  touch("notes.txt");
+  touch("sub/c.zero");
+
+  std::vector<std::string> expected{at("a.zero"), at("b.zero")};
+  EXPECT_EQ(collect("*.zero"), expected);
+
+  auto files = FileCollector::collect_files({"missing.zero", at("?.zero")});
+  std::vector<std::string> with_literal{at("a.zero"), at("b.zero"),
+                                        "missing.zero"};
+  EXPECT_EQ(files, with_literal);
+}
+
+/**
+ * @brief 测试 `**` 递归匹配与目录段中的通配符，并行遍历结果与串行一致。
+ */
+TEST_F(FileCollectorTest, ExpandsRecursivePatterns) {
+  touch("main.zero");
+  touch("src/a.zero");
+  touch("src/deep/er/b.zero");
+  touch("src/deep/er/b.txt");
+  touch("lib/c.zero");
+
+  std::vector<std::string> all{at("lib/c.zero"), at("main.zero"),
+                               at("src/a.zero"), at("src/deep/er/b.zero")};
+  EXPECT_EQ(collect("**/*.zero"), all);
+
+  std::vector<std::string> one_level{at("lib/c.zero"), at("src/a.zero")};
+  EXPECT_EQ(collect("*/*.zero"), one_level);
+
+  CollectOptions parallel;
+  parallel.jobs = 4;
+  EXPECT_EQ(collect("**/*.zero", parallel), all);
+}
+
+/**
+ * @brief 测试 `.gitignore` 的排除、取反、目录规则与 `--no-ignore`。
+ */
+TEST_F(FileCollectorTest, HonoursGitignore) {
+  fs::create_directories(root / ".git");
+  touch(".git/hooks.zero");
+  touch(".gitignore", "# generated\nbuild/\n*.gen.zero\n!keep.gen.zero\n");
+  touch("a.zero");
+  touch("a.gen.zero");
+  touch("keep.gen.zero");
+  touch("build/out.zero");
+  touch("src/.gitignore", "/local.zero\n");
+  touch("src/local.zero");
+  touch("src/nested/local.zero");
+
+  std::vector<std::string> expected{at("a.zero"), at("keep.gen.zero"),
+                                    at("src/nested/local.zero")};
+  EXPECT_EQ(collect("**/*.zero"), expected);
+
+  // 从子目录开始遍历时，仓库顶层的规则同样生效。
+  std::vector<std::string> from_src{at("src/nested/local.zero")};
+  EXPECT_EQ(FileCollector::collect_files({at("src") + "/**/*.zero"}),
+            from_src);
+  touch("src/x.gen.zero");
+  EXPECT_EQ(FileCollector::collect_files({at("src") + "/**/*.zero"}),
+            from_src);
+
+  CollectOptions no_ignore;
+  no_ignore.use_gitignore = false;
+  EXPECT_EQ(collect("**/*.zero", no_ignore).size(), 8u);
+}
+
+/**
+ * @brief 测试目录索引：时间戳未变的目录直接复用记录，变化后重新读取，
+ *        损坏的索引被忽略。
+ */
+TEST_F(FileCollectorTest, ReusesDirectoryIndex) {
+  touch("tree/a.zero");
+  touch("tree/sub/b.zero");
+  age("tree/sub");
+  age("tree");
+
+  CollectOptions options;
+  options.index_path = at("index");
+  std::vector<std::string> expected{at("tree/a.zero"), at("tree/sub/b.zero")};
+  EXPECT_EQ(collect("tree/**/*.zero", options), expected);
+  ASSERT_TRUE(fs::exists(options.index_path));
+
+  // 修改时间被还原的目录视为未变化，仍使用索引中的列表。
+  auto stamp = fs::last_write_time(root / "tree/sub");
+  touch("tree/sub/c.zero");
+  fs::last_write_time(root / "tree/sub", stamp);
+  EXPECT_EQ(collect("tree/**/*.zero", options), expected);
+
+  // 修改时间变化后重新读取。
+  age("tree/sub");
+  std::vector<std::string> refreshed{at("tree/a.zero"), at("tree/sub/b.zero"),
+                                     at("tree/sub/c.zero")};
+  EXPECT_EQ(collect("tree/**/*.zero", options), refreshed);
+
+  {
+    std::ofstream corrupt(options.index_path, std::ios::binary);
+    corrupt << "czc-file-index 1\nnot a record\n";
+  }
+  EXPECT_EQ(collect("tree/**/*.zero", options), refreshed);
+}
@@ -0,0 +1,232 @@
+/**
+ * @file test_format_cache.cpp
+ * @brief 格式化缓存测试套件（使用 Google Test 框架）。
+ * @details 测试 `FormatCache` 的查询、保存与载入，以及格式化选项或版本
+ *          变化时缓存作废；测试 `FormatMemo` 在文件之间复用顶层声明的
+ *          格式化结果。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/format_cache.hpp"
+#include "czc/formatter/format_memo.hpp"
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using namespace czc::formatter;
+
+/**
+ * @brief 格式化缓存测试夹具，提供一个临时的缓存文件路径。
+ */
+class FormatCacheTest : public ::testing::Test {
+protected:
+  std::string path;
+
+  void SetUp() override {
+    path = (std::filesystem::temp_directory_path() /
+            ("czc_format_cache_" +
+             std::string(::testing::UnitTest::GetInstance()
+                             ->current_test_info()
+                             ->name())))
+               .string();
+    std::remove(path.c_str());
+  }
+
+  void TearDown() override {
+    std::remove(path.c_str());
+  }
+};
+
+/**
+ * @brief 测试插入后的查询，以及保存再载入后内容保持一致。
+ */
+TEST_F(FormatCacheTest, SaveAndLoadRoundTrip) {
+  FormatOptions options;
+  FormatCache cache(options, "0.1.0");
+  EXPECT_FALSE(cache.load(path));
+  EXPECT_FALSE(cache.contains("let x = 1;\n"));
+
+  cache.insert("let x = 1;\n");
+  cache.insert("let y = 2;\n");
+  EXPECT_TRUE(cache.contains("let x = 1;\n"));
+  EXPECT_FALSE(cache.contains("let x=1;\n"));
+  ASSERT_TRUE(cache.save(path));
+
+  FormatCache loaded(options, "0.1.0");
+  ASSERT_TRUE(loaded.load(path));
+  EXPECT_EQ(loaded.size(), 2u);
+  EXPECT_TRUE(loaded.contains("let x = 1;\n"));
+  EXPECT_TRUE(loaded.contains("let y = 2;\n"));
+}
+
+/**
+ * @brief 测试格式化选项或版本号不同时不载入旧缓存。
+ */
+TEST_F(FormatCacheTest, FingerprintMismatchInvalidates) {
+  FormatOptions options;
+  FormatCache cache(options, "0.1.0");
+  cache.insert("let x = 1;\n");
+  ASSERT_TRUE(cache.save(path));
+
+  FormatCache other_version(options, "0.2.0");
+  EXPECT_FALSE(other_version.load(path));
+  EXPECT_EQ(other_version.size(), 0u);
+
+  FormatOptions tabs = options;
+  tabs.indent_style = IndentStyle::TABS;
+  FormatCache other_options(tabs, "0.1.0");
+  EXPECT_FALSE(other_options.load(path));
+  EXPECT_FALSE(other_options.contains("let x = 1;\n"));
+}
+
+/**
+ * @brief 测试损坏的缓存文件被整体丢弃。
+ */
+TEST_F(FormatCacheTest, CorruptFileIsIgnored) {
+  FormatOptions options;
+  FormatCache cache(options, "0.1.0");
+  cache.insert("let x = 1;\n");
+  ASSERT_TRUE(cache.save(path));
+  {
+    std::ofstream append(path, std::ios::app);
+    append << "not-a-hash\n";
+  }
+
+  FormatCache loaded(options, "0.1.0");
+  EXPECT_FALSE(loaded.load(path));
+  EXPECT_EQ(loaded.size(), 0u);
+}
+
+/**
+ * @brief 测试只有哈希相同、长度不同的条目不算命中。
+ */
+TEST_F(FormatCacheTest, LengthMismatchIsNotAHit) {
+  FormatOptions options;
+  std::string content = "let x = 1;\n";
+  FormatCache cache(options, "0.1.0");
+  cache.insert(content);
+  ASSERT_TRUE(cache.save(path));
+
+  std::string header;
+  std::string hash;
+  std::string length;
+  {
+    std::ifstream input(path);
+    std::getline(input, header);
+    input >> hash >> length;
+  }
+  EXPECT_EQ(length, std::to_string(content.size()));
+  {
+    // 模拟另一段哈希碰撞但长度不同的内容留下的条目
+    std::ofstream output(path, std::ios::trunc);
+    output << header << '\n' << hash << ' ' << content.size() + 1 << '\n';
+  }
+
+  FormatCache loaded(options, "0.1.0");
+  ASSERT_TRUE(loaded.load(path));
+  EXPECT_EQ(loaded.size(), 1u);
+  EXPECT_FALSE(loaded.contains(content));
+}
+
+namespace {
+
+std::unique_ptr<czc::cst::CSTNode> parse(const std::string& source) {
+  czc::lexer::Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  czc::parser::Parser parser(tokens);
+  return parser.parse();
+}
+
+const std::string SHARED_DECLARATIONS =
+    "struct   Point{x:Integer,y:Integer};\n"
+    "fn norm(p:Point)->Integer{return p.x*p.x+p.y*p.y;}\n";
+
+} // namespace
+
+/**
+ * @brief 测试第二个文件中重复的声明直接取自缓存，结果与不用缓存时相同。
+ */
+TEST(FormatMemoTest, ReusesDeclarationsAcrossFiles) {
+  std::string first = "let a = 1;\n" + SHARED_DECLARATIONS;
+  std::string second = "// other file\nlet b=2;\n\n" + SHARED_DECLARATIONS;
+  auto first_tree = parse(first);
+  auto second_tree = parse(second);
+
+  FormatMemo memo;
+  Formatter formatter;
+  formatter.set_memo(&memo, first);
+  std::string first_formatted = formatter.format(first_tree.get());
+  EXPECT_EQ(memo.size(), 3u);
+  EXPECT_EQ(memo.get_hit_count(), 0u);
+
+  formatter.set_memo(&memo, second);
+  std::string second_formatted = formatter.format(second_tree.get());
+  EXPECT_EQ(memo.get_hit_count(), 2u);
+  EXPECT_EQ(memo.size(), 4u);
+
+  Formatter plain;
+  EXPECT_EQ(first_formatted, plain.format(first_tree.get()));
+  EXPECT_EQ(second_formatted, plain.format(second_tree.get()));
+  EXPECT_TRUE(plain.is_formatted(second_tree.get(), second_formatted));
+  EXPECT_TRUE(formatter.is_formatted(second_tree.get(), second_formatted));
+}
+
+/**
+ * @brief 测试键只取决于原文、选项与缩进级别。
+ */
+TEST(FormatMemoTest, KeyDependsOnTextOptionsAndIndent) {
+  FormatOptions options;
+  std::string text = "struct Point{x:Integer,y:Integer};";
+  FormatMemoKey key = FormatMemo::make_key(text, options, 0);
+  EXPECT_EQ(FormatMemo::make_key(std::string(text), options, 0), key);
+  EXPECT_FALSE(FormatMemo::make_key(text, options, 1) == key);
+  EXPECT_FALSE(
+      FormatMemo::make_key("struct Point{x:Integer,z:Integer};", options, 0) ==
+      key);
+
+  FormatOptions tabs = options;
+  tabs.indent_style = IndentStyle::TABS;
+  EXPECT_FALSE(FormatMemo::make_key(text, tabs, 0) == key);
+}
+
+/**
+ * @brief 测试首尾是虚拟 Token 的声明不进入缓存，但照常格式化。
+ */
+TEST(FormatMemoTest, SkipsDeclarationsEndingInSyntheticTokens) {
+  std::string source = "let a = 1\nlet b = 2;\n";
+  auto tree = parse(source);
+
+  FormatMemo memo;
+  Formatter formatter;
+  formatter.set_memo(&memo, source);
+  std::string formatted = formatter.format(tree.get());
+  EXPECT_EQ(formatted, Formatter().format(tree.get()));
+  EXPECT_EQ(memo.size(), 1u);
+}
+
+/**
+ * @brief 测试结果总量达到上限后不再记录新的结果。
+ */
+TEST(FormatMemoTest, StopsRecordingAtLimit) {
+  FormatMemo memo(8);
+  memo.insert({1, 1}, "12345");
+  memo.insert({2, 2}, "6789");
+  memo.insert({1, 1}, "ignored");
+  EXPECT_EQ(memo.size(), 1u);
+  EXPECT_EQ(memo.get_bytes(), 5u);
+
+  std::string out = ">";
+  EXPECT_TRUE(memo.lookup({1, 1}, out));
+  EXPECT_EQ(out, ">12345");
+  EXPECT_FALSE(memo.lookup({2, 2}, out));
+  EXPECT_EQ(memo.get_miss_count(), 1u);
+}
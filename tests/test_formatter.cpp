@@ -13,6 +13,10 @@
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+#include <string>
+#include <vector>
+
 using namespace czc::formatter;
 using namespace czc::lexer;
 using namespace czc::parser;
@@ -562,3 +566,313 @@ TEST_F(FormatterTest, BooleanLiteralFormatting) {
   EXPECT_FALSE(formatted.empty());
   EXPECT_NE(formatted.find("true"), std::string::npos);
 }
+
+// --- 输出端测试 ---
+
+/**
+ * @brief 记录每次写入的输出端（测试用）。
+ */
+class RecordingSink : public OutputSink {
+public:
+  std::vector<std::string> chunks;
+
+  void write(std::string_view text) override {
+    chunks.emplace_back(text);
+  }
+};
+
+/**
+ * @brief 测试写入输出端的结果与 format 的返回值一致。
+ * @details 覆盖字符串输出端与流输出端，以及带 else if 和注释的输入。
+ */
+TEST_F(FormatterTest, FormatToSinkMatchesFormat) {
+  const char* source = "// header\n"
+                       "fn f(x) { if (x > 0) { return 1; } else if (x < 0) "
+                       "{ return 2; } else { return 3; } }\n"
+                       "let y = f(1); // trailing\n";
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  Parser parser(tokens);
+  auto root = parser.parse();
+
+  Formatter formatter;
+  std::string expected = formatter.format(root.get());
+  ASSERT_FALSE(expected.empty());
+  EXPECT_NE(expected.find("else if (x < 0) {"), std::string::npos);
+
+  std::string collected;
+  StringSink string_sink(collected);
+  formatter.format_to(root.get(), string_sink);
+  EXPECT_EQ(collected, expected);
+
+  std::ostringstream stream;
+  StreamSink stream_sink(stream);
+  formatter.format_to(root.get(), stream_sink);
+  EXPECT_EQ(stream.str(), expected);
+
+  RecordingSink empty_sink;
+  formatter.format_to(nullptr, empty_sink);
+  EXPECT_TRUE(empty_sink.chunks.empty());
+}
+
+/**
+ * @brief 测试大文件在顶层声明之间分段写入输出端。
+ */
+TEST_F(FormatterTest, FormatToSinkFlushesBetweenDeclarations) {
+  std::string source;
+  for (int i = 0; i < 4000; ++i) {
+    source += "fn f" + std::to_string(i) + "(a, b) { return a + b; }\n";
+  }
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  Parser parser(tokens);
+  auto root = parser.parse();
+
+  Formatter formatter;
+  std::string expected = formatter.format(root.get());
+  ASSERT_GT(expected.size(), Formatter::SINK_FLUSH_THRESHOLD);
+
+  RecordingSink sink;
+  formatter.format_to(root.get(), sink);
+  ASSERT_GT(sink.chunks.size(), 1u);
+
+  std::string joined;
+  for (const auto& chunk : sink.chunks) {
+    // 每段都在顶层声明的边界处结束。
+    EXPECT_EQ(chunk.back(), '\n');
+    joined += chunk;
+  }
+  EXPECT_EQ(joined, expected);
+}
+
+/**
+ * @brief 测试超过预备深度的缩进。
+ * @details 缩进缓存预先准备 16 级，更深的嵌套需要正确扩容。
+ */
+TEST_F(FormatterTest, DeepNestingIndentation) {
+  const int depth = 40;
+  std::string source = "fn f(x) { ";
+  for (int i = 0; i < depth; ++i) {
+    source += "if (x) { ";
+  }
+  source += "return x; ";
+  for (int i = 0; i < depth; ++i) {
+    source += "} ";
+  }
+  source += "}";
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  Parser parser(tokens);
+  auto root = parser.parse();
+
+  Formatter spaces(
+      FormatOptions(IndentStyle::SPACES, 2, 80, true, true, false));
+  std::string formatted = spaces.format(root.get());
+  std::string innermost = std::string((depth + 1) * 2, ' ') + "return x;\n";
+  EXPECT_NE(formatted.find("\n" + innermost), std::string::npos);
+
+  Formatter tabs(FormatOptions(IndentStyle::TABS, 4, 80, true, true, false));
+  formatted = tabs.format(root.get());
+  innermost = std::string(depth + 1, '\t') + "return x;\n";
+  EXPECT_NE(formatted.find("\n" + innermost), std::string::npos);
+}
+
+// --- 自动换行测试 ---
+
+/**
+ * @brief 格式化一段源码（测试用）。
+ */
+static std::string format_source(const std::string& source,
+                                 const FormatOptions& options) {
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto root = parser.parse();
+  Formatter formatter(options);
+  return formatter.format(root.get());
+}
+
+/**
+ * @brief 测试超长的调用在参数处断行，短的内层调用保持平铺。
+ */
+TEST_F(FormatterTest, WrapsLongCallArguments) {
+  std::string source = "let total = compute(first_argument, second_argument, "
+                       "inner(a, b), fourth_argument_name);";
+  std::string formatted = format_source(source, FormatOptions());
+  EXPECT_EQ(formatted, "let total = compute(\n"
+                       "    first_argument,\n"
+                       "    second_argument,\n"
+                       "    inner(a, b),\n"
+                       "    fourth_argument_name\n"
+                       ");\n");
+}
+
+/**
+ * @brief 测试超长的数组字面量与二元运算链在函数体内换行。
+ */
+TEST_F(FormatterTest, WrapsLongArrayAndBinaryChain) {
+  std::string source =
+      "fn f() { let values = [1000000, 2000000, 3000000, 4000000, 5000000, "
+      "6000000, 7000000];\n"
+      "return alpha_value + beta_value * gamma_value + delta_value - "
+      "epsilon_value_long; }";
+  std::string formatted = format_source(source, FormatOptions());
+  EXPECT_NE(formatted.find("    let values = [\n        1000000,\n"),
+            std::string::npos);
+  EXPECT_NE(formatted.find("        7000000\n    ];\n"), std::string::npos);
+  EXPECT_NE(formatted.find("    return alpha_value +\n"
+                           "        beta_value * gamma_value +\n"
+                           "        delta_value -\n"
+                           "        epsilon_value_long;\n"),
+            std::string::npos);
+
+  for (size_t begin = 0; begin < formatted.size();) {
+    size_t end = formatted.find('\n', begin);
+    EXPECT_LE(end - begin, 80u);
+    begin = end + 1;
+  }
+}
+
+/**
+ * @brief 测试 max_line_length 为 0 时不自动换行。
+ */
+TEST_F(FormatterTest, ZeroMaxLineLengthDisablesWrapping) {
+  std::string source = "let total = compute(first_argument, second_argument, "
+                       "third_argument, fourth_argument_name);";
+  FormatOptions options(IndentStyle::SPACES, 4, 0, true, true, false);
+  std::string formatted = format_source(source, options);
+  EXPECT_EQ(formatted, source + "\n");
+}
+
+// 解析 `source` 并对 [start, end] 区间做区间格式化。
+static std::vector<TextEdit> format_source_range(const std::string& source,
+                                                 size_t start, size_t end) {
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto root = parser.parse();
+  Formatter formatter;
+  return formatter.format_range(root.get(), source, start, end);
+}
+
+// 从后往前把替换应用到源码上。
+static std::string apply_edits(std::string source,
+                               const std::vector<TextEdit>& edits) {
+  for (auto it = edits.rbegin(); it != edits.rend(); ++it) {
+    source.replace(it->start_offset, it->end_offset - it->start_offset,
+                   it->new_text);
+  }
+  return source;
+}
+
+/**
+ * @brief 测试区间格式化只替换与区间重叠的顶层声明所在的行。
+ */
+TEST_F(FormatterTest, FormatRangeTouchesOnlyOverlappingDeclaration) {
+  std::string source = "let a=1;\nlet   b  =  2;\nlet c=3;\n";
+  size_t offset = source.find('b');
+  auto edits = format_source_range(source, offset, offset);
+  ASSERT_EQ(edits.size(), 1u);
+  EXPECT_EQ(edits[0].start_offset, source.find("let   b"));
+  EXPECT_EQ(edits[0].end_offset, source.find("let c"));
+  EXPECT_EQ(edits[0].new_text, "let b = 2;\n");
+  EXPECT_EQ(apply_edits(source, edits), "let a=1;\nlet b = 2;\nlet c=3;\n");
+}
+
+/**
+ * @brief 测试区间落在函数体内时只格式化其中的语句，并保留函数的缩进层级。
+ */
+TEST_F(FormatterTest, FormatRangeDescendsIntoBlocks) {
+  std::string source = "fn f() {\n"
+                       "  let x=1;\n"
+                       "  if (x>0) {\n"
+                       "  return   x*2;\n"
+                       "  }\n"
+                       "}\n"
+                       "let   untouched=0;\n";
+  size_t offset = source.find("x*2");
+  auto edits = format_source_range(source, offset, offset + 3);
+  ASSERT_EQ(edits.size(), 1u);
+  EXPECT_EQ(edits[0].new_text, "        return x * 2;\n");
+  EXPECT_EQ(apply_edits(source, edits), "fn f() {\n"
+                                        "  let x=1;\n"
+                                        "  if (x>0) {\n"
+                                        "        return x * 2;\n"
+                                        "  }\n"
+                                        "}\n"
+                                        "let   untouched=0;\n");
+}
+
+/**
+ * @brief 测试区间为空白或已格式化时不产生替换，覆盖全文时与 format 一致。
+ */
+TEST_F(FormatterTest, FormatRangeEdgeCases) {
+  std::string formatted = "let a = 1;\nlet b = 2;\n";
+  EXPECT_TRUE(format_source_range(formatted, 0, formatted.size()).empty());
+
+  std::string source = "  let a=1; // note\n\n\nfn g(){return 1;}";
+  size_t gap = source.find("\n\n") + 1;
+  EXPECT_TRUE(format_source_range(source, gap, gap).empty());
+
+  auto edits = format_source_range(source, 0, source.size());
+  EXPECT_EQ(apply_edits(source, edits),
+            format_source(source, FormatOptions()));
+}
+
+/**
+ * @brief 测试 is_formatted 对已格式化、未格式化与截断的源码的判断。
+ */
+TEST_F(FormatterTest, IsFormattedComparesWithSource) {
+  std::string formatted = "fn f(a, b) {\n    return a + b;\n}\nlet x = 1;\n";
+  std::string unformatted = "fn f(a,b){return a+b;}\nlet x=1;\n";
+
+  for (const std::string* source : {&formatted, &unformatted}) {
+    Lexer lexer(*source);
+    auto tokens = lexer.tokenize();
+    Parser parser(tokens);
+    auto root = parser.parse();
+    Formatter formatter;
+    EXPECT_EQ(formatter.is_formatted(root.get(), *source),
+              source == &formatted);
+    // 检查之后格式化器照常可用。
+    EXPECT_EQ(formatter.format(root.get()), formatted);
+  }
+
+  CompareSink prefix(formatted);
+  prefix.write(std::string_view(formatted).substr(0, 10));
+  EXPECT_FALSE(prefix.is_finished());
+  EXPECT_FALSE(prefix.matches());
+}
+
+/**
+ * @brief 输出端在第一次写入后即表示结束（测试用）。
+ */
+class FinishAfterFirstWriteSink : public RecordingSink {
+public:
+  bool is_finished() const override {
+    return !chunks.empty();
+  }
+};
+
+/**
+ * @brief 测试输出端结束后格式化器不再继续格式化后面的声明。
+ */
+TEST_F(FormatterTest, FormatToStopsWhenSinkIsFinished) {
+  std::string source;
+  for (int i = 0; i < 4000; ++i) {
+    source += "fn f" + std::to_string(i) + "(a, b) { return a + b; }\n";
+  }
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto root = parser.parse();
+
+  Formatter formatter;
+  FinishAfterFirstWriteSink sink;
+  formatter.format_to(root.get(), sink);
+  ASSERT_EQ(sink.chunks.size(), 1u);
+  EXPECT_LT(sink.chunks[0].size(), formatter.format(root.get()).size());
+}
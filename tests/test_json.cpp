@@ -0,0 +1,82 @@
+/**
+ * @file test_json.cpp
+ * @brief JSON 值类型测试套件（使用 Google Test 框架）。
+ * @details 测试 `JsonValue` 的解析、序列化、转义与非法输入的拒绝。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/utils/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace czc::utils;
+
+/**
+ * @brief 测试解析后再序列化得到等价的紧凑文本，对象保持成员顺序。
+ */
+TEST(JsonTest, ParseAndDumpRoundTrip) {
+  auto value = JsonValue::parse(
+      R"( {"b": [1, 2.5, -3e2, true, false, null], "a": {"x": "y"}} )");
+  ASSERT_TRUE(value.has_value());
+  ASSERT_TRUE(value->is_object());
+  EXPECT_EQ(value->dump(),
+            R"({"b":[1,2.5,-300,true,false,null],"a":{"x":"y"}})");
+
+  const JsonValue* b = value->find("b");
+  ASSERT_NE(b, nullptr);
+  ASSERT_EQ(b->as_array().size(), 6u);
+  EXPECT_DOUBLE_EQ(b->as_array()[1].as_number(), 2.5);
+  EXPECT_EQ(value->find("missing"), nullptr);
+
+  JsonValue built = JsonValue::object();
+  built.set("n", 42).set("s", "text").set("n", 7);
+  EXPECT_EQ(built.dump(), R"({"n":7,"s":"text"})");
+}
+
+/**
+ * @brief 测试字符串转义，包括控制字符与 `\u` 代理对。
+ */
+TEST(JsonTest, StringEscapes) {
+  auto value = JsonValue::parse(R"("a\"b\\c\n\t\u00e9\ud83d\ude00\/")");
+  ASSERT_TRUE(value.has_value());
+  EXPECT_EQ(value->as_string(), "a\"b\\c\n\t\xC3\xA9\xF0\x9F\x98\x80/");
+
+  JsonValue text(std::string("line\n\x01\"quoted\""));
+  EXPECT_EQ(text.dump(), R"("line\n\u0001\"quoted\"")");
+}
+
+/**
+ * @brief 测试有效的多字节字符原样输出，无效的 UTF-8 字节替换为 `\ufffd`。
+ */
+TEST(JsonTest, DumpReplacesInvalidUtf8) {
+  JsonValue valid(std::string("\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80"));
+  EXPECT_EQ(valid.dump(), "\"\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80\"");
+
+  // 依次为：非法字节、截断的序列、多余的编码、代理项、超出 U+10FFFF。
+  JsonValue invalid(std::string("a\xFF\xFE" "b\xE4\xB8" "c\xC0\xAF"
+                                "d\xED\xA0\x80" "e\xF4\x90\x80\x80"));
+  const std::string r = "\\ufffd";
+  EXPECT_EQ(invalid.dump(), "\"a" + r + r + "b" + r + r + "c" + r + r + "d" +
+                                r + r + r + "e" + r + r + r + r + "\"");
+  auto parsed = JsonValue::parse(invalid.dump());
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(parsed->as_string().substr(0, 8), "a\xEF\xBF\xBD\xEF\xBF\xBD" "b");
+}
+
+/**
+ * @brief 测试非法输入被拒绝。
+ */
+TEST(JsonTest, RejectsInvalidInput) {
+  for (const char* input :
+       {"", "{", "[1,]", "{\"a\" 1}", "01", "1.", "tru", "\"\\x\"", "[1] 2",
+        "\"\\ud800\"", "\"raw\nnewline\""}) {
+    EXPECT_FALSE(JsonValue::parse(input).has_value()) << input;
+  }
+
+  std::string deep(JsonValue::MAX_DEPTH + 2, '[');
+  deep.append(JsonValue::MAX_DEPTH + 2, ']');
+  EXPECT_FALSE(JsonValue::parse(deep).has_value());
+}
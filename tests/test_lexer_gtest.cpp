@@ -8,7 +8,13 @@
  */
 
 #include "czc/lexer/lexer.hpp"
+#include "czc/lexer/scan_kernels.hpp"
+#include "czc/lexer/stream_lexer.hpp"
+#include "czc/utils/thread_pool.hpp"
 
+#include <cctype>
+#include <limits>
+#include <string_view>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -353,6 +359,28 @@ TEST_F(LexerTest, InvalidEscapeSequence) {
   EXPECT_TRUE(errors.has_errors());
 }
 
+/**
+ * @brief 测试达到错误上限后词法分析立即结束。
+ * @details 第二个错误之后的下一个 Token 即为 EOF，其余输入不再扫描。
+ */
+TEST_F(LexerTest, StopsAtErrorLimit) {
+  std::string source;
+  for (int i = 0; i < 100; ++i) {
+    source += "let a = 0x;\n";
+  }
+  Lexer lexer(source);
+  lexer.set_error_limit(2);
+  auto tokens = lexer.tokenize();
+
+  EXPECT_EQ(lexer.get_errors().count(), 2u);
+  EXPECT_TRUE(lexer.get_errors().limit_reached());
+  ASSERT_FALSE(tokens.empty());
+  EXPECT_EQ(tokens.back().token_type, TokenType::EndOfFile);
+  // 两行共 10 个 Token：第二个 `0x` 之后立即是 EOF。
+  EXPECT_EQ(tokens.size(), 10u);
+  EXPECT_LT(lexer.get_source_tracker().get_position(), source.size() / 10);
+}
+
 // --- 新增测试：边界情况和复合场景 ---
 
 /**
@@ -723,6 +751,21 @@ TEST_F(LexerTest, KeywordVsIdentifierBoundary) {
   EXPECT_EQ(tokens[2].value, "lettuce");
 }
 
+/**
+ * @brief 测试关键字查找会拒绝长度或首字符相同的非关键字。
+ * @details 覆盖同长度同首字符的关键字对（if/in、else/enum、type/true）。
+ */
+TEST_F(LexerTest, KeywordLookupRejectsNearMisses) {
+  EXPECT_EQ(get_keyword("in"), TokenType::In);
+  EXPECT_EQ(get_keyword("enum"), TokenType::Enum);
+  EXPECT_EQ(get_keyword("true"), TokenType::True);
+
+  for (const char* word : {"i", "id", "fx", "lett", "elss", "emum", "tyre",
+                           "trie", "While", "struc", "returns", "_if"}) {
+    EXPECT_FALSE(get_keyword(word).has_value()) << word;
+  }
+}
+
 /**
  * @brief 测试无效的十六进制Unicode转义。
  * @details 验证词法分析器能够检测到\u后面没有足够十六进制数字的错误。
@@ -960,6 +1003,29 @@ TEST_F(LexerTest, AllSingleCharOperatorsCombined) {
   // 验证每个操作符都被正确识别
 }
 
+/**
+ * @brief 测试全部双字符操作符。
+ * @details 验证运算符表能为每个首字符匹配出正确的双字符形式，
+ *          且不能组合的后继字符会退回单字符形式。
+ */
+TEST_F(LexerTest, AllTwoCharOperators) {
+  auto tokens = tokenize("+= -= -> *= /= %= == != <= >= && || .. -< |&");
+
+  std::vector<TokenType> expected = {
+      TokenType::PlusEqual,    TokenType::MinusEqual, TokenType::Arrow,
+      TokenType::StarEqual,    TokenType::SlashEqual, TokenType::PercentEqual,
+      TokenType::EqualEqual,   TokenType::BangEqual,  TokenType::LessEqual,
+      TokenType::GreaterEqual, TokenType::AndAnd,     TokenType::OrOr,
+      TokenType::DotDot,       TokenType::Minus,      TokenType::Less,
+      TokenType::Or,           TokenType::And,        TokenType::EndOfFile};
+  ASSERT_EQ(tokens.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(tokens[i].token_type, expected[i]) << "index " << i;
+  }
+  EXPECT_EQ(tokens[2].value, "->");
+  EXPECT_EQ(tokens[13].value, "-");
+}
+
 /**
  * @brief 测试复杂的嵌套表达式。
  * @details 验证词法分析器处理复杂嵌套的能力。
@@ -978,3 +1044,477 @@ TEST_F(LexerTest, DeeplyNestedExpression) {
   }
   EXPECT_EQ(paren_count, 0);
 }
+
+// --- 零拷贝 Token 区间测试 ---
+
+/**
+ * @brief 测试 Token 记录的源码区间。
+ * @details 验证 offset/length 能够精确切出 Token 的源码文本，注释不包含换行符。
+ */
+TEST_F(LexerTest, TokenOffsetsCoverSourceText) {
+  std::string source = "let x = \"a\\n\"; // hi\nfoo";
+  auto tokens = tokenize(source);
+
+  ASSERT_EQ(tokens.size(), 8);
+  EXPECT_EQ(source.substr(tokens[0].offset, tokens[0].length), "let");
+  EXPECT_EQ(source.substr(tokens[3].offset, tokens[3].length), "\"a\\n\"");
+  EXPECT_EQ(source.substr(tokens[5].offset, tokens[5].length), "// hi");
+  EXPECT_EQ(source.substr(tokens[6].offset, tokens[6].length), "foo");
+  EXPECT_EQ(tokens[7].token_type, TokenType::EndOfFile);
+  EXPECT_EQ(tokens[7].length, 0);
+}
+
+/**
+ * @brief 测试零拷贝模式与普通模式的结果一致。
+ * @details 通过 `TokenSpanList::to_tokens` 还原的 Token 序列应与 `tokenize` 完全相同。
+ */
+TEST_F(LexerTest, TokenSpansMatchOwnedTokens) {
+  std::string source = "fn 函数(a: Integer) -> Float {\n"
+                       "  let s = \"x\\ty\" + r\"raw\\n\" + \"plain\";\n"
+                       "  return 1.5e3 + 0xFF; // done\n"
+                       "}\n";
+  auto owned = tokenize(source);
+
+  Lexer lexer(source);
+  auto spans = lexer.tokenize_spans();
+  auto restored = spans.to_tokens();
+
+  ASSERT_EQ(restored.size(), owned.size());
+  for (size_t i = 0; i < owned.size(); ++i) {
+    EXPECT_EQ(restored[i].token_type, owned[i].token_type) << "index " << i;
+    EXPECT_EQ(restored[i].value, owned[i].value) << "index " << i;
+    EXPECT_EQ(restored[i].raw_literal, owned[i].raw_literal) << "index " << i;
+    EXPECT_EQ(restored[i].is_raw_string, owned[i].is_raw_string);
+    EXPECT_EQ(restored[i].line, owned[i].line);
+    EXPECT_EQ(restored[i].column, owned[i].column);
+    EXPECT_EQ(restored[i].offset, owned[i].offset);
+    EXPECT_EQ(restored[i].length, owned[i].length);
+
+    auto position = spans.line_column(i);
+    EXPECT_EQ(position.line, owned[i].line) << "index " << i;
+    EXPECT_EQ(position.column, owned[i].column) << "index " << i;
+  }
+}
+
+/**
+ * @brief 测试零拷贝模式只为加工值不同的 Token 分配字符串。
+ * @details 只有含转义序列的字符串需要保存加工值，其余 Token 直接引用源码。
+ */
+TEST_F(LexerTest, TokenSpansOnlyCookDifferingValues) {
+  Lexer lexer("let long_identifier_name = \"plain\" + \"esc\\n\" + r\"raw\";");
+  auto spans = lexer.tokenize_spans();
+
+  EXPECT_EQ(spans.cooked_count(), 1);
+  EXPECT_EQ(spans.text(1), "long_identifier_name");
+  EXPECT_EQ(spans.value(3), "plain");
+  EXPECT_EQ(spans.raw_literal(3), "\"plain\"");
+  EXPECT_EQ(spans.value(5), "esc\n");
+  EXPECT_EQ(spans.value(7), "raw");
+  EXPECT_TRUE(spans[7].is_raw_string());
+}
+
+/**
+ * @brief 测试零拷贝模式下不含转义的字符串值直接引用源码，其余字符串的
+ *        加工值与逐 Token 模式一致。
+ */
+TEST_F(LexerTest, TokenSpanStringsReferenceSource) {
+  std::string source = "\"plain 中文\" r\"C:\\dir\" \"\\x41\\u0042\\u{1F600}\" "
+                       "\"tab\\t\" \"bad\\q\" \"\" \"open";
+  auto spans = Lexer(source).tokenize_spans();
+  auto owned = Lexer(source).tokenize();
+
+  ASSERT_EQ(spans.size(), owned.size());
+  EXPECT_EQ(spans.cooked_count(), 3);
+  for (size_t index : {0u, 1u, 5u}) {
+    std::string_view value = spans.value(index);
+    EXPECT_EQ(value.data(),
+              spans.source().data() + spans[index].offset +
+                  (spans[index].is_raw_string() ? 2 : 1))
+        << "index " << index;
+  }
+  EXPECT_EQ(spans.value(1), "C:\\dir");
+  EXPECT_EQ(spans.value(2), "AB\xF0\x9F\x98\x80");
+  for (size_t i = 0; i < owned.size(); ++i) {
+    EXPECT_EQ(spans.value(i), owned[i].value) << "index " << i;
+    EXPECT_EQ(spans.raw_literal(i), owned[i].raw_literal) << "index " << i;
+  }
+}
+
+// --- 批量扫描内核测试 ---
+
+/**
+ * @brief 测试扫描内核在跨越数据块边界时的结果。
+ * @details 逐个起始位置与逐字节的朴素扫描比较，覆盖 SIMD 块内、块间与尾部。
+ */
+TEST_F(LexerTest, ScanKernelsMatchBytewiseScan) {
+  std::string input = std::string(37, ' ') + "\t\r\n\v\f" +
+                      "abc_XYZ09abcdefghijklmnopqrstuvwxyz" + "\xE5\x87\xBD" +
+                      "tail_ident" + "@" + "// comment text\nnext" +
+                      std::string(40, 'q') + "\\" + std::string(33, 'r') +
+                      "\"";
+  const char* data = input.data();
+  size_t size = input.size();
+
+  for (size_t pos = 0; pos <= size; ++pos) {
+    size_t ws = pos;
+    while (ws < size && std::isspace(static_cast<unsigned char>(data[ws]))) {
+      ws++;
+    }
+    EXPECT_EQ(scan::skip_whitespace(data, pos, size), ws) << "pos " << pos;
+
+    size_t id = pos;
+    while (id < size && (std::isalnum(static_cast<unsigned char>(data[id])) ||
+                         data[id] == '_')) {
+      id++;
+    }
+    EXPECT_EQ(scan::scan_identifier(data, pos, size), id) << "pos " << pos;
+
+    size_t nl = input.find('\n', pos);
+    EXPECT_EQ(scan::find_line_end(data, pos, size),
+              nl == std::string::npos ? size : nl)
+        << "pos " << pos;
+
+    size_t ascii = pos;
+    while (ascii < size && static_cast<unsigned char>(data[ascii]) < 0x80) {
+      ascii++;
+    }
+    EXPECT_EQ(scan::skip_ascii(data, pos, size), ascii) << "pos " << pos;
+
+    size_t delimiter = input.find_first_of("\"\\", pos);
+    EXPECT_EQ(scan::find_string_delimiter(data, pos, size),
+              delimiter == std::string::npos ? size : delimiter)
+        << "pos " << pos;
+  }
+}
+
+/**
+ * @brief 测试批量跳过空白、长标识符和注释后行列号依然正确。
+ */
+TEST_F(LexerTest, BulkScanningKeepsLineAndColumn) {
+  std::string long_name(40, 'a');
+  std::string source = "   \n\n        \t" + long_name + " x // " +
+                       std::string(30, 'c') + "\n\n   y";
+  auto tokens = tokenize(source);
+
+  ASSERT_EQ(tokens.size(), 5);
+  EXPECT_EQ(tokens[0].value, long_name);
+  EXPECT_EQ(tokens[0].line, 3);
+  EXPECT_EQ(tokens[0].column, 10);
+  EXPECT_EQ(tokens[1].value, "x");
+  EXPECT_EQ(tokens[1].line, 3);
+  EXPECT_EQ(tokens[1].column, 51);
+  EXPECT_EQ(tokens[2].token_type, TokenType::Comment);
+  EXPECT_EQ(tokens[2].column, 53);
+  EXPECT_EQ(tokens[3].value, "y");
+  EXPECT_EQ(tokens[3].line, 5);
+  EXPECT_EQ(tokens[3].column, 4);
+}
+
+// --- 并行分块词法分析测试 ---
+
+/**
+ * @brief 比较并行与串行分析的 Token 和错误。
+ * @param[in] error_limit 两者共同的错误上限，默认不限制。
+ */
+static void expect_parallel_matches_serial(
+    const std::string& source, size_t min_chunk_bytes,
+    size_t error_limit = std::numeric_limits<size_t>::max()) {
+  Lexer serial(source, "chunked.zero");
+  serial.set_error_limit(error_limit);
+  auto expected = serial.tokenize();
+
+  czc::utils::ThreadPool pool(4);
+  Lexer parallel(source, "chunked.zero");
+  parallel.set_error_limit(error_limit);
+  auto actual = parallel.tokenize_parallel(pool, min_chunk_bytes);
+  EXPECT_EQ(parallel.get_source_tracker().get_position(),
+            serial.get_source_tracker().get_position());
+
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(actual[i].token_type, expected[i].token_type) << "index " << i;
+    EXPECT_EQ(actual[i].value, expected[i].value) << "index " << i;
+    EXPECT_EQ(actual[i].raw_literal, expected[i].raw_literal) << "index " << i;
+    EXPECT_EQ(actual[i].line, expected[i].line) << "index " << i;
+    EXPECT_EQ(actual[i].column, expected[i].column) << "index " << i;
+    EXPECT_EQ(actual[i].offset, expected[i].offset) << "index " << i;
+    EXPECT_EQ(actual[i].length, expected[i].length) << "index " << i;
+  }
+
+  const auto& expected_errors = serial.get_errors().get_errors();
+  const auto& actual_errors = parallel.get_errors().get_errors();
+  ASSERT_EQ(actual_errors.size(), expected_errors.size());
+  for (size_t i = 0; i < expected_errors.size(); ++i) {
+    EXPECT_EQ(actual_errors[i].code, expected_errors[i].code);
+    EXPECT_EQ(actual_errors[i].location.line,
+              expected_errors[i].location.line);
+    EXPECT_EQ(actual_errors[i].location.column,
+              expected_errors[i].location.column);
+  }
+}
+
+/**
+ * @brief 测试并行分析的结果与串行分析完全一致。
+ * @details 使用很小的分块，使切分点落在多行字符串、原始字符串、注释与
+ *          错误附近，验证切分点选择与位置修正。
+ */
+TEST_F(LexerTest, ParallelTokenizeMatchesSerial) {
+  std::string source;
+  for (int i = 0; i < 40; ++i) {
+    source += "let value_" + std::to_string(i) + " = " + std::to_string(i) +
+              " + 1.5e3; // 注释 \"引号\n";
+    source += "let s = \"多行\n字符串 \\\" 转义\n结尾\";\n";
+    source += "let r = r\"raw \\ \n still raw\";\n";
+    if (i % 7 == 0) {
+      source += "let bad = @ \"\xE4\";\n";
+    }
+  }
+
+  for (size_t chunk : {16u, 64u, 257u, 4096u}) {
+    SCOPED_TRACE("min_chunk_bytes " + std::to_string(chunk));
+    expect_parallel_matches_serial(source, chunk);
+  }
+}
+
+/**
+ * @brief 测试设置了错误上限时，并行分析与串行分析在同一个错误处停止。
+ */
+TEST_F(LexerTest, ParallelTokenizeStopsAtErrorLimit) {
+  std::string source;
+  for (int i = 0; i < 40; ++i) {
+    source += "let value_" + std::to_string(i) + " = " + std::to_string(i) +
+              "; // 注释\n";
+    if (i % 5 == 0) {
+      source += "let bad = @ \"\\q\";\n";
+    }
+  }
+
+  for (size_t limit : {1u, 2u, 3u, 7u, 100u}) {
+    for (size_t chunk : {16u, 64u, 257u}) {
+      SCOPED_TRACE("limit " + std::to_string(limit) + ", min_chunk_bytes " +
+                   std::to_string(chunk));
+      expect_parallel_matches_serial(source, chunk, limit);
+    }
+  }
+}
+
+/**
+ * @brief 测试切分点落在未闭合字符串内部时退回串行分析。
+ */
+TEST_F(LexerTest, ParallelTokenizeFallsBackOnUnsafeBoundary) {
+  // NOTE: `1r"` 中的 `r` 紧跟数字，预扫描会把随后的内容视为普通字符串，
+  //       而 Lexer 视其为原始字符串，因此 `\"` 之后的换行符会被误判为安全。
+  std::string source;
+  for (int i = 0; i < 20; ++i) {
+    source += "let a = 1r\"x\\\"\n";
+    source += "let b = 2;\n\"\n";
+  }
+  expect_parallel_matches_serial(source, 8);
+}
+
+// --- 流式词法分析测试 ---
+
+/**
+ * @brief 把 `source` 按 `piece` 字节一段喂给 StreamLexer，比较结果与串行
+ *        分析的 Token 和错误。
+ */
+static void expect_stream_matches_serial(const std::string& source,
+                                         size_t piece) {
+  Lexer serial(source, "stream.zero");
+  auto expected = serial.tokenize();
+
+  StreamLexer stream("stream.zero");
+  std::vector<Token> actual;
+  for (size_t i = 0; i < source.size(); i += piece) {
+    stream.feed(std::string_view(source).substr(i, piece));
+    auto tokens = stream.take_tokens();
+    actual.insert(actual.end(), tokens.begin(), tokens.end());
+  }
+  stream.finish();
+  EXPECT_TRUE(stream.is_finished());
+  EXPECT_EQ(stream.get_pending_bytes(), 0u);
+  auto rest = stream.take_tokens();
+  actual.insert(actual.end(), rest.begin(), rest.end());
+
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(actual[i].token_type, expected[i].token_type) << "index " << i;
+    EXPECT_EQ(actual[i].value, expected[i].value) << "index " << i;
+    EXPECT_EQ(actual[i].line, expected[i].line) << "index " << i;
+    EXPECT_EQ(actual[i].column, expected[i].column) << "index " << i;
+    EXPECT_EQ(actual[i].offset, expected[i].offset) << "index " << i;
+    EXPECT_EQ(actual[i].length, expected[i].length) << "index " << i;
+  }
+
+  const auto& expected_errors = serial.get_errors().get_errors();
+  const auto& actual_errors = stream.get_errors().get_errors();
+  ASSERT_EQ(actual_errors.size(), expected_errors.size());
+  for (size_t i = 0; i < expected_errors.size(); ++i) {
+    EXPECT_EQ(actual_errors[i].code, expected_errors[i].code);
+    EXPECT_EQ(actual_errors[i].location.line,
+              expected_errors[i].location.line);
+    EXPECT_EQ(actual_errors[i].location.column,
+              expected_errors[i].location.column);
+  }
+}
+
+/**
+ * @brief 测试无论输入如何分段，流式分析的结果都与串行分析完全一致。
+ * @details 分段会落在多字节字符、转义序列、多行字符串与注释的内部。
+ */
+TEST_F(LexerTest, StreamLexerMatchesSerialForAnySplit) {
+  std::string source;
+  for (int i = 0; i < 6; ++i) {
+    source += "let value_" + std::to_string(i) + " = 0x1F + 2.5 >= 3;\n";
+    source += "  // 注释 \"引号\n";
+    source += "let s = \"多行\n字符串 \\u{4E2D} \\\" 转义\";\n";
+    source += "let r = r\"raw \\ \n still raw\";\n";
+    source += "let bad = @ \"\xE4\";\n";
+  }
+  source += "let open = \"never closed";
+
+  for (size_t piece : {1u, 2u, 3u, 7u, 64u, 100000u}) {
+    SCOPED_TRACE("piece " + std::to_string(piece));
+    expect_stream_matches_serial(source, piece);
+  }
+}
+
+/**
+ * @brief 测试每段输入到达后立即提交已确定的 Token，只保留未完成的部分。
+ */
+TEST_F(LexerTest, StreamLexerCommitsSettledTokens) {
+  StreamLexer stream;
+  EXPECT_EQ(stream.feed("let answ"), 1u);
+  auto tokens = stream.take_tokens();
+  ASSERT_EQ(tokens.size(), 1u);
+  EXPECT_EQ(tokens[0].token_type, TokenType::Let);
+  EXPECT_EQ(stream.get_pending_bytes(), 4u);
+
+  EXPECT_EQ(stream.feed("er = 42;\n"), 3u);
+  tokens = stream.take_tokens();
+  ASSERT_EQ(tokens.size(), 3u);
+  EXPECT_EQ(tokens[0].value, "answer");
+  EXPECT_EQ(tokens[0].offset, 4u);
+  EXPECT_EQ(tokens[2].value, "42");
+
+  EXPECT_EQ(stream.finish(), 2u);
+  tokens = stream.take_tokens();
+  ASSERT_EQ(tokens.size(), 2u);
+  EXPECT_EQ(tokens[0].token_type, TokenType::Semicolon);
+  EXPECT_EQ(tokens[1].token_type, TokenType::EndOfFile);
+  EXPECT_EQ(stream.feed("ignored"), 0u);
+}
+
+// --- 增量词法分析测试 ---
+
+/**
+ * @brief 对 `source` 应用编辑后，比较增量分析与全量分析的 Token 序列。
+ * @return 增量分析替换的 Token 窗口。
+ */
+static RelexRange expect_relex_matches_full(const std::string& source,
+                                            const SourceEdit& edit) {
+  std::string edited = source;
+  edited.replace(edit.offset, edit.length, edit.text);
+
+  auto tokens = Lexer(source).tokenize();
+  Lexer incremental(edited);
+  RelexRange range = incremental.relex(tokens, edit);
+  auto expected = Lexer(edited).tokenize();
+
+  EXPECT_EQ(tokens.size(), expected.size());
+  for (size_t i = 0; i < std::min(tokens.size(), expected.size()); ++i) {
+    EXPECT_EQ(tokens[i].token_type, expected[i].token_type) << "index " << i;
+    EXPECT_EQ(tokens[i].value, expected[i].value) << "index " << i;
+    EXPECT_EQ(tokens[i].raw_literal, expected[i].raw_literal) << "index " << i;
+    EXPECT_EQ(tokens[i].line, expected[i].line) << "index " << i;
+    EXPECT_EQ(tokens[i].column, expected[i].column) << "index " << i;
+    EXPECT_EQ(tokens[i].offset, expected[i].offset) << "index " << i;
+    EXPECT_EQ(tokens[i].length, expected[i].length) << "index " << i;
+  }
+  return range;
+}
+
+/**
+ * @brief 测试在每个位置插入或删除字符后，增量分析与全量分析一致。
+ * @details 插入的字符覆盖会打开字符串、注释、原始字符串以及改变数字与
+ *          双字符运算符边界的情况。
+ */
+TEST_F(LexerTest, RelexMatchesFullTokenize) {
+  std::string source = "fn f(a) {\n"
+                       "  let s = \"x\\ty\" + r\"raw\";\n"
+                       "  let n = 1.5e3 + a.. 2; // tail\n"
+                       "  return a >= 函数;\n"
+                       "}\n";
+
+  for (size_t offset = 0; offset <= source.size(); ++offset) {
+    for (const char* text : {"\"", "/", "\n", "x", "1", ".", "=", "r", "é"}) {
+      SCOPED_TRACE("insert '" + std::string(text) + "' at " +
+                   std::to_string(offset));
+      expect_relex_matches_full(source, {offset, 0, text});
+    }
+    if (offset < source.size()) {
+      SCOPED_TRACE("delete at " + std::to_string(offset));
+      expect_relex_matches_full(source, {offset, 1, ""});
+      expect_relex_matches_full(source, {offset, 1, "ab"});
+    }
+  }
+}
+
+/**
+ * @brief 测试单字符编辑只重新分析编辑附近的少量 Token。
+ */
+TEST_F(LexerTest, RelexKeepsWindowSmall) {
+  std::string source;
+  for (int i = 0; i < 200; ++i) {
+    source += "let value_" + std::to_string(i) + " = " + std::to_string(i) +
+              ";\n";
+  }
+  size_t offset = source.find("value_100") + 5;
+
+  RelexRange range = expect_relex_matches_full(source, {offset, 0, "\n"});
+  EXPECT_EQ(range.first, 100u * 5 + 1);
+  EXPECT_LE(range.removed, 3u);
+  EXPECT_LE(range.inserted, 4u);
+}
+
+/**
+ * @brief 测试编辑区间超出旧源码时退回全量分析。
+ */
+TEST_F(LexerTest, RelexFallsBackOnInvalidEdit) {
+  std::string source = "let a = 1;";
+  auto tokens = Lexer(source).tokenize();
+
+  Lexer incremental("let a = 1;");
+  RelexRange range = incremental.relex(tokens, {8, 10, ""});
+  EXPECT_EQ(range.first, 0u);
+  EXPECT_EQ(range.inserted, tokens.size());
+  EXPECT_EQ(tokens[3].value, "1");
+}
+
+/**
+ * @brief 测试数字字面量的值在词法分析时解码并随 Token 保存。
+ */
+TEST_F(LexerTest, DecodesNumericValues) {
+  std::string source = "12345678901 0xFF 0b101 3.25 99999999999999999999";
+  auto tokens = tokenize(source);
+  ASSERT_EQ(tokens.size(), 6u);
+  ASSERT_TRUE(tokens[0].has_numeric_value);
+  EXPECT_EQ(tokens[0].integer_value, 12345678901);
+  ASSERT_TRUE(tokens[1].has_numeric_value);
+  EXPECT_EQ(tokens[1].integer_value, 255);
+  EXPECT_EQ(tokens[2].integer_value, 5);
+  ASSERT_TRUE(tokens[3].has_numeric_value);
+  EXPECT_DOUBLE_EQ(tokens[3].float_value, 3.25);
+  // 超出范围的整数仍是整数 Token，只是不带解码值。
+  EXPECT_EQ(tokens[4].token_type, TokenType::Integer);
+  EXPECT_FALSE(tokens[4].has_numeric_value);
+  EXPECT_FALSE(tokens[5].has_numeric_value);
+
+  // 零拷贝模式还原的 Token 同样带有解码值。
+  auto restored = Lexer(source).tokenize_spans().to_tokens();
+  ASSERT_EQ(restored.size(), tokens.size());
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    EXPECT_EQ(restored[i].has_numeric_value, tokens[i].has_numeric_value);
+    EXPECT_EQ(restored[i].integer_value, tokens[i].integer_value);
+  }
+}
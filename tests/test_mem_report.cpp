@@ -0,0 +1,131 @@
+/**
+ * @file test_mem_report.cpp
+ * @brief 内存占用报告（`MemReport`）与各结构内存估算的测试。
+ * @details 覆盖汇总、单文件最大值与输出，以及 CST、Token、AST 与驻留表的
+ *          内存估算。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/ast/ast_builder.hpp"
+#include "czc/ast/ast_context.hpp"
+#include "czc/cst/cst_node.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/utils/mem_report.hpp"
+#include "czc/utils/string_interner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace czc;
+using namespace czc::utils;
+
+namespace {
+
+/**
+ * @brief 每个测试前后清空汇总。
+ */
+class MemReportTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    MemReport::reset();
+  }
+
+  void TearDown() override {
+    MemReport::reset();
+  }
+};
+
+} // namespace
+
+/**
+ * @brief 测试多次累加的合计与单文件最大值。
+ */
+TEST_F(MemReportTest, AccumulatesTotalsAndMaximum) {
+  MemReport::add(MemCategory::CSTChildren, 10, 160, 32);
+  MemReport::add(MemCategory::CSTChildren, 4, 480, 0);
+
+  MemStats stats = MemReport::get(MemCategory::CSTChildren);
+  EXPECT_EQ(stats.files, 2u);
+  EXPECT_EQ(stats.count, 14u);
+  EXPECT_EQ(stats.bytes, 640u);
+  EXPECT_EQ(stats.slack_bytes, 32u);
+  EXPECT_EQ(stats.max_bytes, 480u);
+  EXPECT_EQ(MemReport::get(MemCategory::Tokens).files, 0u);
+}
+
+/**
+ * @brief 测试表格只列出记录过的结构，JSON 列出全部结构。
+ */
+TEST_F(MemReportTest, PrintsTableAndJson) {
+  MemReport::add(MemCategory::Source, 1, 1000);
+  MemReport::add(MemCategory::CSTNodes, 5, 2000);
+
+  std::ostringstream table;
+  MemReport::print_table(table);
+  EXPECT_NE(table.str().find("cst-nodes"), std::string::npos);
+  EXPECT_EQ(table.str().find("diagnostics"), std::string::npos);
+  EXPECT_NE(table.str().find("bytes per source byte: 3.00"),
+            std::string::npos);
+
+  auto json = MemReport::to_json();
+  const JsonValue* structures = json.find("structures");
+  ASSERT_NE(structures, nullptr);
+  ASSERT_NE(structures->find("diagnostics"), nullptr);
+  EXPECT_EQ(structures->find("cst-nodes")->find("count")->as_number(), 5.0);
+  EXPECT_EQ(json.find("bytes")->as_number(), 3000.0);
+}
+
+/**
+ * @brief 测试 CST 的内存估算覆盖每个节点及其子节点列表。
+ */
+TEST(CSTMemoryTest, MeasuresEveryNode) {
+  lexer::Lexer lexer("fn add(a, b) {\n    return a + b;\n}\n");
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens);
+  auto cst = parser.parse();
+
+  auto stats = cst::measure_memory(cst.get());
+  EXPECT_GT(stats.node_count, 10u);
+  EXPECT_EQ(stats.node_bytes, stats.node_count * sizeof(cst::CSTNode));
+  // 除根节点外每个节点都恰好是一个子节点
+  EXPECT_EQ(stats.children_size, stats.node_count - 1);
+  EXPECT_GE(stats.children_capacity, stats.children_size);
+
+  EXPECT_EQ(cst::measure_memory(nullptr).node_count, 0u);
+}
+
+/**
+ * @brief 测试 Token 文本只在超出 SSO 容量时计入堆内存。
+ */
+TEST(CSTMemoryTest, CountsTokenTextBeyondSso) {
+  lexer::Token short_token(lexer::TokenType::Identifier, "x");
+  EXPECT_EQ(lexer::get_heap_bytes(short_token), 0u);
+
+  lexer::Token long_token(lexer::TokenType::Identifier, std::string(200, 'a'));
+  EXPECT_GT(lexer::get_heap_bytes(long_token), 200u);
+}
+
+/**
+ * @brief 测试 AST 与驻留表的内存估算随内容增长。
+ */
+TEST(CSTMemoryTest, MeasuresAstAndInterner) {
+  lexer::Lexer lexer("let x = 1;\nlet y = x + 2;\n");
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens);
+  auto cst = parser.parse();
+
+  ast::ASTContext context;
+  size_t empty_bytes = context.get_memory_bytes();
+  ast::ASTBuilder builder(context);
+  (void)builder.build(cst.get());
+  EXPECT_GT(context.get_memory_bytes(), empty_bytes);
+
+  StringInterner interner;
+  size_t before = interner.get_memory_bytes();
+  (void)interner.intern("a_fairly_long_identifier_name");
+  EXPECT_GT(interner.get_memory_bytes(), before);
+}
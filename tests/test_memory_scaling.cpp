@@ -0,0 +1,162 @@
+/**
+ * @file test_memory_scaling.cpp
+ * @brief 各阶段内存随输入线性增长的守护测试。
+ * @details 本文件替换了全局 `operator new` / `operator delete`，记录堆上
+ *          存活字节数的峰值；分别对 1 倍与 8 倍大小的输入运行解析与格式化，
+ *          要求峰值的增长不超过输入增长的 1.5 倍，从而在 `CSTNode` 等结构
+ *          出现超线性内存增长时失败。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace czc;
+
+namespace {
+
+std::atomic<size_t> live_bytes{0};
+std::atomic<size_t> peak_bytes{0};
+
+// NOTE: 每个块前放置其大小，释放时据此扣减存活字节数。
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+// 允许的峰值增长倍数相对输入增长倍数的上限。
+constexpr double MAX_GROWTH_FACTOR = 1.5;
+
+// 输入的放大倍数。
+constexpr size_t SCALE = 8;
+
+const char* const PROGRAM =
+    "// 计算两个数的和\n"
+    "fn add(a: Integer, b: Integer) -> Integer {\n"
+    "    let total = a + b * 2;\n"
+    "    if total > 10 {\n"
+    "        return total - 1;\n"
+    "    } else {\n"
+    "        return call(total, [1, 2, 3]);\n"
+    "    }\n"
+    "}\n"
+    "struct Point {\n"
+    "    x: Float,\n"
+    "    y: Float,\n"
+    "}\n"
+    "let message = \"hello\";\n";
+
+std::string repeat_program(size_t copies) {
+  std::string source;
+  for (size_t i = 0; i < copies; ++i) {
+    source += PROGRAM;
+  }
+  return source;
+}
+
+// 运行 `stage` 并返回其间相对起点的堆峰值字节数。
+template <typename Fn> size_t measure_peak(Fn&& stage) {
+  size_t before = live_bytes.load(std::memory_order_relaxed);
+  peak_bytes.store(before, std::memory_order_relaxed);
+  stage();
+  return peak_bytes.load(std::memory_order_relaxed) - before;
+}
+
+std::vector<lexer::Token> lex(const std::string& source) {
+  lexer::Lexer lexer(source, "scaling.zero");
+  auto tokens = lexer.tokenize();
+  token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "scaling.zero", source);
+  return tokens;
+}
+
+size_t parse_peak(size_t copies) {
+  std::string source = repeat_program(copies);
+  auto tokens = lex(source);
+  return measure_peak([&]() {
+    parser::Parser parser(tokens, "scaling.zero");
+    auto cst = parser.parse();
+    EXPECT_FALSE(parser.has_errors());
+  });
+}
+
+size_t format_peak(size_t copies) {
+  std::string source = repeat_program(copies);
+  auto tokens = lex(source);
+  parser::Parser parser(tokens, "scaling.zero");
+  auto cst = parser.parse();
+  return measure_peak([&]() {
+    formatter::Formatter formatter;
+    std::string formatted = formatter.format(cst.get());
+    EXPECT_FALSE(formatted.empty());
+  });
+}
+
+} // namespace
+
+#if defined(__GNUC__)
+#define CZC_TEST_NOINLINE __attribute__((noinline))
+#else
+#define CZC_TEST_NOINLINE
+#endif
+
+CZC_TEST_NOINLINE void* operator new(std::size_t size) {
+  auto* block = static_cast<unsigned char*>(std::malloc(size + HEADER_SIZE));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<std::size_t*>(block) = size;
+  size_t live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  size_t peak = peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !peak_bytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+  return block + HEADER_SIZE;
+}
+
+CZC_TEST_NOINLINE void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto* block = static_cast<unsigned char*>(ptr) - HEADER_SIZE;
+  live_bytes.fetch_sub(*reinterpret_cast<std::size_t*>(block),
+                       std::memory_order_relaxed);
+  std::free(block);
+}
+
+CZC_TEST_NOINLINE void operator delete(void* ptr, std::size_t) noexcept {
+  operator delete(ptr);
+}
+
+/**
+ * @brief 测试解析（CST 构建）的堆峰值随输入线性增长。
+ */
+TEST(MemoryScalingTest, ParsePeakGrowsLinearly) {
+  size_t small = parse_peak(64);
+  size_t large = parse_peak(64 * SCALE);
+  ASSERT_GT(small, 0u);
+  EXPECT_LE(static_cast<double>(large),
+            static_cast<double>(small) * SCALE * MAX_GROWTH_FACTOR)
+      << "small=" << small << " large=" << large;
+}
+
+/**
+ * @brief 测试格式化的堆峰值随输入线性增长。
+ */
+TEST(MemoryScalingTest, FormatPeakGrowsLinearly) {
+  size_t small = format_peak(64);
+  size_t large = format_peak(64 * SCALE);
+  ASSERT_GT(small, 0u);
+  EXPECT_LE(static_cast<double>(large),
+            static_cast<double>(small) * SCALE * MAX_GROWTH_FACTOR)
+      << "small=" << small << " large=" << large;
+}
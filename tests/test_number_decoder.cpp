@@ -0,0 +1,97 @@
+/**
+ * @file test_number_decoder.cpp
+ * @brief 数字字面量值解码（`decode_integer`、`decode_float`）的测试。
+ * @details 覆盖按 8 位一组转换的各种长度、`int64_t` 的边界、进制前缀、
+ *          整数值的科学计数法，以及浮点数的解码与非法输入。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/lexer/number_decoder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace czc::lexer;
+
+namespace {
+
+int64_t integer(std::string_view literal) {
+  int64_t value = -1;
+  EXPECT_TRUE(decode_integer(literal, value)) << literal;
+  return value;
+}
+
+} // namespace
+
+/**
+ * @brief 测试十进制整数的各种长度与 `int64_t` 的上限。
+ */
+TEST(NumberDecoderTest, DecodesDecimalIntegers) {
+  EXPECT_EQ(integer("0"), 0);
+  EXPECT_EQ(integer("7"), 7);
+  EXPECT_EQ(integer("12345678"), 12345678);
+  EXPECT_EQ(integer("123456789"), 123456789);
+  EXPECT_EQ(integer("0000000000000042"), 42);
+  EXPECT_EQ(integer("1234567890123456"), 1234567890123456);
+  EXPECT_EQ(integer("9223372036854775807"), INT64_MAX);
+
+  // 与 `std::stoll` 逐位比较各种长度。
+  std::string digits;
+  for (int i = 1; i <= 18; i++) {
+    digits += static_cast<char>('0' + (i * 7) % 10);
+    EXPECT_EQ(integer(digits), std::stoll(digits)) << digits;
+  }
+
+  int64_t value = 0;
+  EXPECT_FALSE(decode_integer("9223372036854775808", value));
+  EXPECT_FALSE(decode_integer("99999999999999999999", value));
+  EXPECT_FALSE(decode_integer("", value));
+  EXPECT_FALSE(decode_integer("12345678x", value));
+  EXPECT_FALSE(decode_integer("1234:678", value));
+}
+
+/**
+ * @brief 测试进制前缀与整数值的科学计数法。
+ */
+TEST(NumberDecoderTest, DecodesPrefixesAndScientificIntegers) {
+  EXPECT_EQ(integer("0xFF"), 255);
+  EXPECT_EQ(integer("0XdeadBEEF"), 0xDEADBEEF);
+  EXPECT_EQ(integer("0b1011"), 11);
+  EXPECT_EQ(integer("0o777"), 511);
+  EXPECT_EQ(integer("0x7FFFFFFFFFFFFFFF"), INT64_MAX);
+
+  int64_t value = 0;
+  EXPECT_FALSE(decode_integer("0x", value));
+  EXPECT_FALSE(decode_integer("0b102", value));
+  EXPECT_FALSE(decode_integer("0x8000000000000000", value));
+
+  EXPECT_EQ(integer("1e3"), 1000);
+  EXPECT_EQ(integer("1.5e3"), 1500);
+  EXPECT_EQ(integer("1.20e1"), 12);
+  EXPECT_EQ(integer("1200e-2"), 12);
+  EXPECT_EQ(integer("0e999"), 0);
+  EXPECT_EQ(integer("9.223372036854775807e18"), INT64_MAX);
+  EXPECT_FALSE(decode_integer("1.25e1", value));
+  EXPECT_FALSE(decode_integer("1e19", value));
+}
+
+/**
+ * @brief 测试浮点数的解码与非法输入。
+ */
+TEST(NumberDecoderTest, DecodesFloats) {
+  double value = 0;
+  ASSERT_TRUE(decode_float("3.14", value));
+  EXPECT_DOUBLE_EQ(value, 3.14);
+  ASSERT_TRUE(decode_float("0.1", value));
+  EXPECT_EQ(value, 0.1);
+  ASSERT_TRUE(decode_float("1.5e-3", value));
+  EXPECT_DOUBLE_EQ(value, 0.0015);
+  ASSERT_TRUE(decode_float("12345678901234567890.5", value));
+  EXPECT_DOUBLE_EQ(value, 12345678901234567890.5);
+
+  EXPECT_FALSE(decode_float("", value));
+  EXPECT_FALSE(decode_float("1.5x", value));
+  EXPECT_FALSE(decode_float("1e400", value));
+}
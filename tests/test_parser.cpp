@@ -8,7 +8,15 @@
  */
 
 #include "czc/lexer/lexer.hpp"
+#include "czc/lexer/stream_lexer.hpp"
+#include "czc/lexer/token_source.hpp"
+#include "czc/parser/incremental_parser.hpp"
+#include "czc/parser/lazy_parser.hpp"
 #include "czc/parser/parser.hpp"
+#include "czc/parser/stream_parser.hpp"
+#include "czc/token_preprocessor/preprocessed_token_source.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+#include "czc/utils/thread_pool.hpp"
 
 #include "test_helpers.hpp"
 #include <gtest/gtest.h>
@@ -89,6 +97,87 @@ TEST_F(ParserTest, BinaryExpression) {
   EXPECT_FALSE(parser.has_errors());
 }
 
+/**
+ * @brief 以 S 表达式形式描述 CST 的结构，空子节点记为 `null`。
+ */
+static std::string cst_shape(const CSTNode* node) {
+  if (node == nullptr) {
+    return "null";
+  }
+  std::string shape = "(" + cst_node_type_to_string(node->get_type());
+  if (node->get_token().has_value()) {
+    shape += " '" + node->get_token()->value + "'";
+  }
+  for (const auto& child : node->get_children()) {
+    shape += " " + cst_shape(child.get());
+  }
+  return shape + ")";
+}
+
+static std::string parse_shape(const std::string& source) {
+  Lexer lexer(source);
+  Parser parser(lexer.tokenize());
+  return cst_shape(parser.parse().get());
+}
+
+/**
+ * @brief 测试所有二元运算符的优先级与左结合性。
+ * @details 期望的树形与逐级递归下降实现生成的 CST 完全相同。
+ */
+TEST_F(ParserTest, BinaryPrecedenceAndAssociativity) {
+  EXPECT_EQ(parse_shape("a || b && c == d < e + f * g - h % i;"),
+            "(Program (ExprStmt (BinaryExpr (Identifier 'a') (Operator '||') "
+            "(BinaryExpr (Identifier 'b') (Operator '&&') (BinaryExpr "
+            "(Identifier 'c') (Operator '==') (BinaryExpr (Identifier 'd') "
+            "(Operator '<') (BinaryExpr (BinaryExpr (Identifier 'e') (Operator "
+            "'+') (BinaryExpr (Identifier 'f') (Operator '*') (Identifier "
+            "'g'))) (Operator '-') (BinaryExpr (Identifier 'h') (Operator '%') "
+            "(Identifier 'i'))))))) (Delimiter ';')))");
+  EXPECT_EQ(parse_shape("a - b - c / d / e;"),
+            "(Program (ExprStmt (BinaryExpr (BinaryExpr (Identifier 'a') "
+            "(Operator '-') (Identifier 'b')) (Operator '-') (BinaryExpr "
+            "(BinaryExpr (Identifier 'c') (Operator '/') (Identifier 'd')) "
+            "(Operator '/') (Identifier 'e'))) (Delimiter ';')))");
+  EXPECT_EQ(parse_shape("x = y = -!z * 3 >= 4 == true;"),
+            "(Program (ExprStmt (AssignExpr (Identifier 'x') (Operator '=') "
+            "(AssignExpr (Identifier 'y') (Operator '=') (BinaryExpr "
+            "(BinaryExpr (BinaryExpr (UnaryExpr (Operator '-') (UnaryExpr "
+            "(Operator '!') (Identifier 'z'))) (Operator '*') (IntegerLiteral "
+            "'3')) (Operator '>=') (IntegerLiteral '4')) (Operator '==') "
+            "(BooleanLiteral 'true')))) (Delimiter ';')))");
+}
+
+/**
+ * @brief 测试缺失操作数时的 CST 形状与旧实现一致。
+ */
+TEST_F(ParserTest, BinaryExpressionWithMissingOperand) {
+  EXPECT_EQ(parse_shape("a + * b;"),
+            "(Program (ExprStmt (BinaryExpr (Identifier 'a') (Operator '+') "
+            "(BinaryExpr null (Operator '*') (Identifier 'b'))) (Delimiter "
+            "';')))");
+  EXPECT_EQ(parse_shape("a * + b;"),
+            "(Program (ExprStmt (BinaryExpr (BinaryExpr (Identifier 'a') "
+            "(Operator '*')) (Operator '+') (Identifier 'b')) "
+            "(Delimiter ';')))");
+}
+
+/**
+ * @brief 测试很长的同级运算链不会随长度加深调用栈。
+ */
+TEST_F(ParserTest, LongArithmeticChain) {
+  std::string source = "let total = 0";
+  for (int i = 0; i < 20000; ++i) {
+    source += i % 2 == 0 ? " + x" : " * 2";
+  }
+  source += ";";
+
+  Lexer lexer(source);
+  Parser parser(lexer.tokenize());
+  auto cst = parser.parse();
+  ASSERT_NE(cst, nullptr);
+  EXPECT_FALSE(parser.has_errors());
+}
+
 // --- 条件语句测试 ---
 
 /**
@@ -251,3 +340,523 @@ TEST_F(ParserTest, MemberAccessWithIndex) {
   EXPECT_EQ(cst->get_type(), CSTNodeType::Program);
   EXPECT_FALSE(parser.has_errors());
 }
+
+// --- 拉取式 Token 数据源测试 ---
+
+/**
+ * @brief 递归比较两棵 CST 的结构与 Token 内容。
+ */
+static void expect_same_cst(const CSTNode* a, const CSTNode* b) {
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(a->get_type(), b->get_type());
+  ASSERT_EQ(a->get_token().has_value(), b->get_token().has_value());
+  if (a->get_token().has_value()) {
+    EXPECT_EQ(a->get_token()->token_type, b->get_token()->token_type);
+    EXPECT_EQ(a->get_token()->value, b->get_token()->value);
+    EXPECT_EQ(a->get_token()->is_synthetic, b->get_token()->is_synthetic);
+  }
+  ASSERT_EQ(a->get_children().size(), b->get_children().size());
+  for (size_t i = 0; i < a->get_children().size(); ++i) {
+    expect_same_cst(a->get_children()[i].get(), b->get_children()[i].get());
+  }
+}
+
+/**
+ * @brief 按先序遍历收集 CST 中关联了源码 Token 的节点的字节偏移。
+ */
+static void collect_token_offsets(const CSTNode* node,
+                                  std::vector<size_t>& offsets) {
+  ASSERT_NE(node, nullptr);
+  const auto& token = node->get_token();
+  if (token.has_value() && !token->is_synthetic) {
+    offsets.push_back(token->offset);
+  }
+  for (const auto& child : node->get_children()) {
+    collect_token_offsets(child.get(), offsets);
+  }
+}
+
+/**
+ * @brief 测试深层嵌套时 CST 节点仍关联正确的 Token。
+ * @details 每层括号之间都有超过前瞻窗口容量的 Token。
+ */
+TEST_F(ParserTest, NestedExpressionsKeepTheirOwnTokens) {
+  std::string source =
+      "let value = (first_operand + (second_operand * (third_operand - "
+      "fourth_operand, fifth_operand), sixth_operand), seventh_operand);\n"
+      "fn f(p: ((Integer, Float), String)) -> (Integer, Float)[] {\n"
+      "  return call_target(argument_one, [element_a, element_b], "
+      "Point { x: 1, y: 2 }.x);\n"
+      "}\n";
+
+  Lexer lexer(source);
+  Parser parser(lexer.tokenize());
+  auto cst = parser.parse();
+
+  EXPECT_FALSE(parser.has_errors());
+
+  // NOTE: CST 按源码顺序保留 Token，先序遍历得到的偏移应单调不减。
+  //       若某处在解析子表达式后仍使用早先取得的缓冲区引用，节点上的
+  //       Token 就会变成缓冲区中后来的 Token，破坏这一顺序。
+  std::vector<size_t> offsets;
+  collect_token_offsets(cst.get(), offsets);
+  ASSERT_FALSE(offsets.empty());
+  for (size_t i = 1; i < offsets.size(); ++i) {
+    EXPECT_LE(offsets[i - 1], offsets[i]) << "token #" << i;
+  }
+}
+
+/**
+ * @brief 测试流式解析与基于向量的解析结果一致。
+ * @details 词法分析与科学计数法预处理在解析过程中内联执行，生成的 CST 应完全相同。
+ */
+TEST_F(ParserTest, StreamingSourceMatchesVectorParse) {
+  std::string source = "// header\n"
+                       "struct Point { x: Float, y: Float };\n"
+                       "fn main() -> Integer {\n"
+                       "  let p = Point { x: 1.5e3, y: 2e2 };\n"
+                       "  if p.x > 1 { return 1; } else if p.y { return 2; }\n"
+                       "  while (i < 10) { arr[i] = fn (a) { return a; }; }\n"
+                       "  return (1, 2)[0];\n"
+                       "}\n";
+
+  Lexer lexer(source);
+  auto raw_tokens = lexer.tokenize();
+  czc::token_preprocessor::TokenPreprocessor preprocessor;
+  auto tokens = preprocessor.process(raw_tokens, "test.zero", source);
+  Parser vector_parser(tokens, "test.zero");
+  auto expected = vector_parser.parse();
+
+  Parser stream_parser(
+      std::make_unique<czc::token_preprocessor::PreprocessedTokenSource>(
+          source, "test.zero"),
+      "test.zero");
+  auto actual = stream_parser.parse();
+
+  EXPECT_FALSE(vector_parser.has_errors());
+  EXPECT_FALSE(stream_parser.has_errors());
+  expect_same_cst(expected.get(), actual.get());
+}
+
+/**
+ * @brief 测试流式解析在错误恢复路径下与向量解析一致。
+ */
+TEST_F(ParserTest, StreamingSourceMatchesVectorParseWithErrors) {
+  std::string source = "let a = ;\nfn f( { let b = 1 }\nlet c = [1, 2;\n";
+
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser vector_parser(std::move(tokens));
+  auto expected = vector_parser.parse();
+
+  Parser stream_parser(std::make_unique<LexerTokenSource>(source));
+  auto actual = stream_parser.parse();
+
+  EXPECT_EQ(vector_parser.get_errors().size(),
+            stream_parser.get_errors().size());
+  expect_same_cst(expected.get(), actual.get());
+}
+
+/**
+ * @brief 测试 Parser 通过 `SpanTokenSource` 直接消费紧凑 Token 的结果。
+ * @details 行列号由行索引推算，生成的 CST 与错误位置应与向量解析完全相同。
+ */
+TEST_F(ParserTest, SpanSourceMatchesVectorParse) {
+  std::string source = "fn 函数(a: Integer) -> Integer {\n"
+                       "  let s = \"multi\nline\" + r\"raw\";\n"
+                       "  return a +;\n"
+                       "}\n";
+
+  Lexer lexer(source);
+  Parser vector_parser(lexer.tokenize());
+  auto expected = vector_parser.parse();
+
+  Lexer span_lexer(source);
+  Parser span_parser(
+      std::make_unique<SpanTokenSource>(span_lexer.tokenize_spans()));
+  auto actual = span_parser.parse();
+
+  const auto& expected_errors = vector_parser.get_errors();
+  const auto& actual_errors = span_parser.get_errors();
+  ASSERT_EQ(expected_errors.size(), actual_errors.size());
+  for (size_t i = 0; i < expected_errors.size(); ++i) {
+    EXPECT_EQ(expected_errors[i].location.line,
+              actual_errors[i].location.line);
+    EXPECT_EQ(expected_errors[i].location.column,
+              actual_errors[i].location.column);
+  }
+  expect_same_cst(expected.get(), actual.get());
+}
+
+// --- 并行解析测试 ---
+
+/**
+ * @brief 分别以串行和并行方式解析，比较 CST 与错误列表。
+ */
+static void expect_parallel_matches_serial(const std::string& source,
+                                           bool use_arena = false) {
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  Parser serial(tokens, "test.zero");
+  serial.set_arena_enabled(use_arena);
+  auto expected = serial.parse();
+
+  czc::utils::ThreadPool pool(4);
+  Parser parallel(tokens, "test.zero");
+  parallel.set_arena_enabled(use_arena);
+  auto actual = parallel.parse_parallel(pool, 16);
+
+  expect_same_cst(expected.get(), actual.get());
+  const auto& expected_errors = serial.get_errors();
+  const auto& actual_errors = parallel.get_errors();
+  ASSERT_EQ(expected_errors.size(), actual_errors.size());
+  for (size_t i = 0; i < expected_errors.size(); ++i) {
+    EXPECT_EQ(expected_errors[i].code, actual_errors[i].code);
+    EXPECT_EQ(expected_errors[i].location.line,
+              actual_errors[i].location.line);
+    EXPECT_EQ(expected_errors[i].location.column,
+              actual_errors[i].location.column);
+  }
+}
+
+/**
+ * @brief 生成包含各类顶层声明的源码；`broken` 指定插入语法错误的声明序号。
+ */
+static std::string generate_declarations(size_t count, size_t broken = -1) {
+  std::string source;
+  for (size_t i = 0; i < count; ++i) {
+    std::string n = std::to_string(i);
+    switch (i % 5) {
+    case 0:
+      source += "// declaration " + n + "\nfn f" + n +
+                "(a: Integer) -> Integer {\n  let b = (a + " + n +
+                ") * 2;\n  return b;\n}\n";
+      break;
+    case 1:
+      source += "struct S" + n + " { x: Integer, y: Integer };\n";
+      break;
+    case 2:
+      source += "type T" + n + " = Integer | String;\n";
+      break;
+    case 3:
+      source += "let g" + n + " = fn (x: Integer) { return x; };\n";
+      break;
+    default:
+      source += "var v" + n + " = [1, 2, " + n + "];\n";
+      break;
+    }
+    if (i == broken) {
+      source += "let oops = (1 + ;\n";
+    }
+  }
+  return source;
+}
+
+/**
+ * @brief 测试并行解析与串行解析产生相同的 CST。
+ */
+TEST_F(ParserTest, ParallelParseMatchesSerial) {
+  expect_parallel_matches_serial(generate_declarations(200));
+  expect_parallel_matches_serial(generate_declarations(200), true);
+}
+
+/**
+ * @brief 测试带语法错误时并行解析的 CST 与错误顺序仍与串行一致。
+ */
+TEST_F(ParserTest, ParallelParseWithErrorsMatchesSerial) {
+  for (size_t broken : {0, 37, 120, 199}) {
+    expect_parallel_matches_serial(generate_declarations(200, broken));
+    expect_parallel_matches_serial(generate_declarations(200, broken), true);
+  }
+  // 括号不配对时不切分，整体串行解析。
+  expect_parallel_matches_serial(generate_declarations(100) + "}\n" +
+                                 generate_declarations(100));
+  expect_parallel_matches_serial("fn f() {\n" + generate_declarations(200));
+}
+
+// --- 流式解析测试 ---
+
+/**
+ * @brief 把顶层声明挂到一个 `Program` 节点下的接收器。
+ */
+class CollectingSink : public czc::parser::DeclarationSink {
+public:
+  std::unique_ptr<CSTNode> program;
+  size_t begin_calls = 0;
+
+  void begin_program(const czc::utils::SourceLocation& location) override {
+    ++begin_calls;
+    program = make_cst_node(CSTNodeType::Program, location);
+  }
+
+  void add_declaration(std::unique_ptr<CSTNode> node) override {
+    program->add_child(std::move(node));
+  }
+};
+
+/**
+ * @brief 把 `source` 的 Token 按 `batch` 个一批推给 StreamParser，比较结果
+ *        与串行解析的 CST 和错误。
+ */
+static void expect_stream_matches_serial(const std::string& source,
+                                         size_t batch) {
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+  Parser serial(tokens, "test.zero");
+  auto expected = serial.parse();
+
+  CollectingSink sink;
+  StreamParser stream(sink, "test.zero");
+  for (size_t i = 0; i < tokens.size(); i += batch) {
+    size_t end = i + batch < tokens.size() ? i + batch : tokens.size();
+    stream.push(std::vector<Token>(
+        tokens.begin() + static_cast<std::ptrdiff_t>(i),
+        tokens.begin() + static_cast<std::ptrdiff_t>(end)));
+  }
+  stream.finish();
+  EXPECT_TRUE(stream.is_finished());
+  EXPECT_EQ(sink.begin_calls, 1u);
+  EXPECT_EQ(stream.get_pending_tokens(), 0u);
+
+  expect_same_cst(expected.get(), sink.program.get());
+  EXPECT_EQ(expected->get_location().line, sink.program->get_location().line);
+  const auto& expected_errors = serial.get_errors();
+  const auto& actual_errors = stream.get_errors();
+  ASSERT_EQ(expected_errors.size(), actual_errors.size());
+  for (size_t i = 0; i < expected_errors.size(); ++i) {
+    EXPECT_EQ(expected_errors[i].code, actual_errors[i].code);
+    EXPECT_EQ(expected_errors[i].location.line,
+              actual_errors[i].location.line);
+    EXPECT_EQ(expected_errors[i].location.column,
+              actual_errors[i].location.column);
+  }
+}
+
+/**
+ * @brief 测试无论 Token 如何分批，流式解析的 CST 与错误都与串行一致。
+ */
+TEST_F(ParserTest, StreamParserMatchesSerialForAnyBatching) {
+  for (size_t batch : {1u, 2u, 5u, 64u, 100000u}) {
+    SCOPED_TRACE("batch " + std::to_string(batch));
+    expect_stream_matches_serial(generate_declarations(40), batch);
+    expect_stream_matches_serial(generate_declarations(40, 17), batch);
+    expect_stream_matches_serial("fn f() {\n" + generate_declarations(20),
+                                 batch);
+  }
+  expect_stream_matches_serial("", 1);
+}
+
+/**
+ * @brief 测试声明一结束就交给接收器，不等待后续输入。
+ */
+TEST_F(ParserTest, StreamParserDeliversSettledDeclarations) {
+  StreamLexer lexer;
+  CollectingSink sink;
+  StreamParser parser(sink);
+
+  lexer.feed("let a = 1;\nfn f(x) {\n  return x;\n");
+  EXPECT_EQ(parser.push(lexer.take_tokens()), 1u);
+  ASSERT_NE(sink.program, nullptr);
+  ASSERT_EQ(sink.program->get_children().size(), 1u);
+  EXPECT_EQ(sink.program->get_children()[0]->get_type(),
+            CSTNodeType::VarDeclaration);
+
+  lexer.feed("}\nlet b = 2;\n");
+  EXPECT_EQ(parser.push(lexer.take_tokens()), 1u);
+  ASSERT_EQ(sink.program->get_children().size(), 2u);
+  EXPECT_EQ(sink.program->get_children()[1]->get_type(),
+            CSTNodeType::FnDeclaration);
+
+  lexer.finish();
+  EXPECT_EQ(parser.push(lexer.take_tokens()), 1u);
+  EXPECT_TRUE(parser.is_finished());
+  EXPECT_EQ(sink.program->get_children().size(), 3u);
+  EXPECT_FALSE(parser.has_errors());
+}
+
+// --- 增量解析测试 ---
+
+/**
+ * @brief 比较两棵 CST 的结构以及每个节点与 Token 的位置。
+ * @details 带语法错误的树中可能有空的子节点，两侧须在同一处为空。
+ */
+static void expect_same_positions(const CSTNode* a, const CSTNode* b) {
+  if (a == nullptr || b == nullptr) {
+    EXPECT_EQ(a == nullptr, b == nullptr);
+    return;
+  }
+  ASSERT_EQ(a->get_type(), b->get_type());
+  const auto& la = a->get_location();
+  const auto& lb = b->get_location();
+  EXPECT_EQ(la.line, lb.line);
+  EXPECT_EQ(la.column, lb.column);
+  EXPECT_EQ(la.end_line, lb.end_line);
+  EXPECT_EQ(la.end_column, lb.end_column);
+  ASSERT_EQ(a->get_token().has_value(), b->get_token().has_value());
+  if (a->get_token().has_value()) {
+    EXPECT_EQ(a->get_token()->token_type, b->get_token()->token_type);
+    EXPECT_EQ(a->get_token()->value, b->get_token()->value);
+    EXPECT_EQ(a->get_token()->is_synthetic, b->get_token()->is_synthetic);
+    EXPECT_EQ(a->get_token()->line, b->get_token()->line);
+    EXPECT_EQ(a->get_token()->column, b->get_token()->column);
+    EXPECT_EQ(a->get_token()->offset, b->get_token()->offset);
+  }
+  ASSERT_EQ(a->get_children().size(), b->get_children().size());
+  for (size_t i = 0; i < a->get_children().size(); ++i) {
+    expect_same_positions(a->get_children()[i].get(),
+                          b->get_children()[i].get());
+  }
+}
+
+/**
+ * @brief 对 `source` 应用编辑后，比较增量解析与全量解析的 CST 与错误。
+ * @return 增量解析的工作量。
+ */
+static ReparseStats expect_reparse_matches_full(const std::string& source,
+                                                const SourceEdit& edit) {
+  std::string edited = source;
+  edited.replace(edit.offset, edit.length, edit.text);
+
+  auto tokens = Lexer(source).tokenize();
+  IncrementalParser incremental("test.zero");
+  incremental.parse(tokens);
+  RelexRange range = Lexer(edited).relex(tokens, edit);
+  const CSTNode* actual = incremental.reparse(tokens, range);
+
+  Parser full(Lexer(edited).tokenize(), "test.zero");
+  auto expected = full.parse();
+  expect_same_positions(expected.get(), actual);
+
+  const auto& expected_errors = full.get_errors();
+  const auto& actual_errors = incremental.get_errors();
+  EXPECT_EQ(expected_errors.size(), actual_errors.size());
+  for (size_t i = 0;
+       i < std::min(expected_errors.size(), actual_errors.size()); ++i) {
+    EXPECT_EQ(expected_errors[i].code, actual_errors[i].code);
+    EXPECT_EQ(expected_errors[i].location.line,
+              actual_errors[i].location.line);
+    EXPECT_EQ(expected_errors[i].location.column,
+              actual_errors[i].location.column);
+  }
+  return incremental.get_last_stats();
+}
+
+/**
+ * @brief 测试在每个位置插入或删除字符后，增量解析与全量解析一致。
+ * @details 插入的字符会打开注释与字符串、拆开或合并声明、制造语法错误。
+ */
+TEST_F(ParserTest, ReparseMatchesFullParse) {
+  std::string source = "// lead\n"
+                       "fn f(a) {\n"
+                       "  let s = \"x\" + a; return s;\n"
+                       "}\n"
+                       "let b = [1, 2]; struct P { x: Integer };\n"
+                       "type T = Integer | String;\n";
+
+  for (size_t offset = 0; offset <= source.size(); ++offset) {
+    for (const char* text : {"\"", "/", "\n", "}", "{", ";", "x", "fn "}) {
+      SCOPED_TRACE("insert '" + std::string(text) + "' at " +
+                   std::to_string(offset));
+      expect_reparse_matches_full(source, {offset, 0, text});
+    }
+    if (offset < source.size()) {
+      SCOPED_TRACE("delete at " + std::to_string(offset));
+      expect_reparse_matches_full(source, {offset, 1, ""});
+    }
+  }
+}
+
+/**
+ * @brief 测试编辑位于一个延伸到 EOF 的未结束条目之前时，落在 EOF 上的
+ *        虚拟 Token 与错误保持 0:0，不随沿用的后缀平移。
+ */
+TEST_F(ParserTest, ReparseMatchesFullParseBeforeUnterminatedTrailingItem) {
+  std::string source = "\nvar (let x = 1;x\n[type T = Integer;->return ";
+  expect_reparse_matches_full(source, {0, 3, ""});
+
+  std::string trailing = "let a = 1;\n\nlet b = 2;\nfn g(x) { return x";
+  for (size_t offset = 0; offset < trailing.find("fn g"); ++offset) {
+    SCOPED_TRACE("edit at " + std::to_string(offset));
+    expect_reparse_matches_full(trailing, {offset, 1, ""});
+    expect_reparse_matches_full(trailing, {offset, 0, "\n"});
+  }
+}
+
+/**
+ * @brief 测试编辑一个声明只重新解析该声明，其余声明原样沿用。
+ */
+TEST_F(ParserTest, ReparseReusesUntouchedDeclarations) {
+  std::string source = generate_declarations(200, 150);
+  size_t offset = source.find("f100(") + 2;
+
+  ReparseStats stats = expect_reparse_matches_full(source, {offset, 0, "9"});
+  EXPECT_LE(stats.reparsed_items, 2u);
+  EXPECT_GT(stats.reused_items, 200u);
+
+  // 插入换行符后，沿用的后缀平移到新的行号。
+  stats = expect_reparse_matches_full(source, {offset, 0, "\n\n"});
+  EXPECT_LE(stats.reparsed_items, 2u);
+}
+
+/**
+ * @brief 测试推迟的函数体在展开后与全量解析完全一致，签名部分在展开前
+ *        就已一致。
+ */
+TEST_F(ParserTest, LazyBodiesMatchFullParse) {
+  std::string source = "struct P { x: Integer };\n"
+                       "fn f(a: Integer) -> Integer {\n"
+                       "  if a > 0 { let p = P { x: a }; return p.x; }\n"
+                       "  let g = fn (b) { return b; };\n"
+                       "  return g(a);\n"
+                       "}\n"
+                       "fn e() {} // trailing\n"
+                       "let v = f(1);\n";
+  auto tokens = Lexer(source).tokenize();
+  Parser full(tokens, "test.zero");
+  auto expected = full.parse();
+
+  LazyParser lazy(tokens, "test.zero");
+  const CSTNode* tree = lazy.parse();
+  EXPECT_EQ(lazy.get_deferred_count(), 2u);
+  const CSTNode* f = tree->get_children()[1].get();
+  ASSERT_EQ(f->get_type(), CSTNodeType::FnDeclaration);
+  EXPECT_TRUE(lazy.is_deferred(f));
+  const CSTNode* placeholder = f->get_children().back().get();
+  ASSERT_EQ(placeholder->get_type(), CSTNodeType::BlockStmt);
+  EXPECT_TRUE(placeholder->get_children()[1]->get_children().empty());
+
+  const CSTNode* body = lazy.get_body(f);
+  ASSERT_NE(body, nullptr);
+  EXPECT_FALSE(lazy.is_deferred(f));
+  EXPECT_EQ(lazy.get_body(f), body);
+  EXPECT_EQ(body->get_children()[1]->get_children().size(), 3u);
+
+  lazy.expand_all();
+  EXPECT_EQ(lazy.get_deferred_count(), 0u);
+  EXPECT_FALSE(lazy.has_errors());
+  expect_same_positions(expected.get(), lazy.get_tree());
+}
+
+/**
+ * @brief 测试函数体内的错误在展开时才报告，未配对的函数体照常解析。
+ */
+TEST_F(ParserTest, LazyBodiesReportErrorsOnExpansion) {
+  std::string source = "fn f() { let = 1; }\nfn g() { let x = 1;\n";
+  auto tokens = Lexer(source).tokenize();
+  Parser full(tokens, "test.zero");
+  auto expected = full.parse();
+  ASSERT_TRUE(full.has_errors());
+
+  LazyParser lazy(tokens, "test.zero");
+  const CSTNode* tree = lazy.parse();
+  // `g` 的 `{` 没有配对，照常解析并报告错误。
+  EXPECT_EQ(lazy.get_deferred_count(), 1u);
+  size_t outline_errors = lazy.get_errors().size();
+  EXPECT_LT(outline_errors, full.get_errors().size());
+
+  lazy.get_body(tree->get_children()[0].get());
+  EXPECT_EQ(lazy.get_errors().size(), full.get_errors().size());
+  expect_same_positions(expected.get(), lazy.get_tree());
+}
@@ -0,0 +1,191 @@
+/**
+ * @file test_server.cpp
+ * @brief 常驻进程服务器测试套件（使用 Google Test 框架）。
+ * @details 测试 JSON-RPC 请求的分发、格式化与解析结果、CST 缓存的复用、
+ *          失效与淘汰、错误响应以及标准输入输出上的服务循环。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/server/server.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace czc::server;
+using namespace czc::utils;
+
+namespace {
+
+JsonValue request(int id, const std::string& method, JsonValue params) {
+  JsonValue value = JsonValue::object();
+  value.set("jsonrpc", "2.0");
+  value.set("id", id);
+  value.set("method", method);
+  value.set("params", std::move(params));
+  return value;
+}
+
+JsonValue file_params(const std::string& path, const std::string& text) {
+  JsonValue params = JsonValue::object();
+  params.set("path", path);
+  params.set("text", text);
+  return params;
+}
+
+} // namespace
+
+/**
+ * @brief 测试格式化请求返回格式化结果，内容不变时复用缓存的 CST。
+ */
+TEST(ServerTest, FormatsAndReusesCachedTree) {
+  Server server;
+  JsonValue first =
+      server.handle(request(1, "format", file_params("a.zero", "let x=1;")));
+  const JsonValue* result = first.find("result");
+  ASSERT_NE(result, nullptr) << first.dump();
+  EXPECT_EQ(result->find("formatted")->as_string(), "let x = 1;\n");
+  EXPECT_TRUE(result->find("changed")->as_bool());
+  EXPECT_FALSE(result->find("cached")->as_bool());
+
+  JsonValue options = file_params("a.zero", "let x=1;");
+  options.set("indent_width", 2);
+  JsonValue second = server.handle(request(2, "format", options));
+  EXPECT_TRUE(second.find("result")->find("cached")->as_bool());
+  EXPECT_EQ(server.get_cached_file_count(), 1u);
+
+  JsonValue edited = server.handle(
+      request(3, "format", file_params("a.zero", "let x = 1;\n")));
+  EXPECT_FALSE(edited.find("result")->find("cached")->as_bool());
+  EXPECT_FALSE(edited.find("result")->find("changed")->as_bool());
+}
+
+/**
+ * @brief 测试语法错误以诊断返回，格式化结果为 null。
+ */
+TEST(ServerTest, ReportsDiagnostics) {
+  Server server;
+  JsonValue response =
+      server.handle(request(1, "format", file_params("bad.zero", "let = ;")));
+  const JsonValue* result = response.find("result");
+  ASSERT_NE(result, nullptr);
+  EXPECT_TRUE(result->find("formatted")->is_null());
+  const auto& diagnostics = result->find("diagnostics")->as_array();
+  ASSERT_FALSE(diagnostics.empty());
+  EXPECT_EQ(diagnostics[0].find("code")->as_string(), "P0001");
+  EXPECT_EQ(diagnostics[0].find("line")->as_number(), 1);
+
+  JsonValue tokens = server.handle(
+      request(2, "tokenize", file_params("t.zero", "let x = 1;")));
+  EXPECT_EQ(tokens.find("result")->find("tokens")->as_array().size(), 5u);
+}
+
+/**
+ * @brief 测试非法请求、未知方法、缺少参数与通知的处理。
+ */
+TEST(ServerTest, RejectsInvalidRequests) {
+  Server server;
+  auto error_code = [&](const std::string& line) {
+    auto response = JsonValue::parse(server.handle_line(line));
+    return response->find("error")->find("code")->as_number();
+  };
+  EXPECT_EQ(error_code("not json"), -32700);
+  EXPECT_EQ(error_code("[]"), -32600);
+  EXPECT_EQ(error_code(R"({"id":1,"method":"nope"})"), -32601);
+  EXPECT_EQ(error_code(R"({"id":1,"method":"parse","params":{}})"), -32602);
+  EXPECT_EQ(
+      error_code(R"({"id":1,"method":"parse","params":{"path":"/no/such"}})"),
+      -32000);
+
+  // 通知没有响应。
+  EXPECT_EQ(server.handle_line(R"({"method":"status"})"), "");
+}
+
+/**
+ * @brief 测试 `max_line_length` 不是 32 位非负整数时返回参数错误。
+ */
+TEST(ServerTest, RejectsInvalidMaxLineLength) {
+  Server server;
+  auto error_code = [&](const std::string& length) {
+    auto response = JsonValue::parse(server.handle_line(
+        R"({"id":1,"method":"format","params":{"path":"a.zero",)"
+        R"("text":"let x=1;","max_line_length":)" +
+        length + "}}"));
+    const JsonValue* error = response->find("error");
+    return error ? error->find("code")->as_number() : 0;
+  };
+  for (const char* length : {"1e300", "-1", "2.5", "4294967296", "\"80\""}) {
+    EXPECT_EQ(error_code(length), -32602) << length;
+  }
+  EXPECT_EQ(error_code("0"), 0);
+  EXPECT_EQ(error_code("120"), 0);
+}
+
+/**
+ * @brief 测试缓存已满时淘汰最久未使用的文件，而不是任意一个。
+ */
+TEST(ServerTest, EvictsLeastRecentlyUsedFile) {
+  ServerOptions options;
+  options.max_cached_files = 2;
+  Server server(options);
+  auto parse_cached = [&](const std::string& path) {
+    JsonValue response =
+        server.handle(request(1, "parse", file_params(path, "let x = 1;\n")));
+    return response.find("result")->find("cached")->as_bool();
+  };
+  EXPECT_FALSE(parse_cached("a.zero"));
+  EXPECT_FALSE(parse_cached("b.zero"));
+  // 再次使用 a，b 成为最久未使用的文件。
+  EXPECT_TRUE(parse_cached("a.zero"));
+  EXPECT_FALSE(parse_cached("c.zero"));
+  EXPECT_EQ(server.get_cached_file_count(), 2u);
+  EXPECT_TRUE(parse_cached("a.zero"));
+  EXPECT_TRUE(parse_cached("c.zero"));
+  EXPECT_FALSE(parse_cached("b.zero"));
+}
+
+/**
+ * @brief 测试服务器响应中的无效 UTF-8 源码字节被替换，响应仍可解析。
+ */
+TEST(ServerTest, ResponsesAreValidUtf8) {
+  Server server;
+  std::string line =
+      server
+          .handle(request(1, "parse",
+                          file_params("bad.zero", "let x = \xFF\xFE;\n")))
+          .dump();
+  for (char c : line) {
+    EXPECT_LT(static_cast<unsigned char>(c), 0x80) << line;
+  }
+  auto response = JsonValue::parse(line);
+  ASSERT_TRUE(response.has_value());
+  const JsonValue* result = response->find("result");
+  ASSERT_NE(result, nullptr);
+  EXPECT_FALSE(result->find("diagnostics")->as_array().empty());
+}
+
+/**
+ * @brief 测试标准输入输出上的服务循环在 `shutdown` 后停止读取。
+ */
+TEST(ServerTest, ServesLinesUntilShutdown) {
+  std::istringstream input(R"({"id":1,"method":"status"}
+
+{"id":2,"method":"shutdown"}
+{"id":3,"method":"status"}
+)");
+  std::ostringstream output;
+  Server server;
+  server.serve(input, output);
+  EXPECT_TRUE(server.is_shutdown_requested());
+
+  std::istringstream lines(output.str());
+  std::string line;
+  size_t count = 0;
+  while (std::getline(lines, line)) {
+    ASSERT_TRUE(JsonValue::parse(line).has_value()) << line;
+    ++count;
+  }
+  EXPECT_EQ(count, 2u);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file test_session.cpp
+ * @brief 批量处理接口 `Session` 的测试。
+ * @details 覆盖格式化、语法检查与构建 AST 三种处理方式，结果与输入一一
+ *          对应、出错的源码单独报告，并行处理与串行处理的结果一致，以及
+ *          每份源码的错误上限。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/session/session.hpp"
+
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace czc;
+using namespace czc::session;
+
+namespace {
+
+std::vector<std::string> make_sources(size_t count) {
+  std::vector<std::string> texts;
+  for (size_t i = 0; i < count; ++i) {
+    std::string n = std::to_string(i);
+    texts.push_back("fn f" + n + "(a,b){return a+b*" + n + ";}\nlet v" + n +
+                    "=f" + n + "(1,2);\n");
+  }
+  return texts;
+}
+
+std::vector<SourceInput> as_inputs(const std::vector<std::string>& texts) {
+  std::vector<SourceInput> inputs;
+  for (size_t i = 0; i < texts.size(); ++i) {
+    inputs.push_back({"source" + std::to_string(i) + ".zero", texts[i]});
+  }
+  return inputs;
+}
+
+std::string format_alone(const std::string& text) {
+  lexer::Lexer lexer(text);
+  auto tokens = lexer.tokenize();
+  parser::Parser parser(tokens);
+  auto cst = parser.parse();
+  formatter::Formatter formatter;
+  return formatter.format(cst.get());
+}
+
+} // namespace
+
+/**
+ * @brief 测试格式化结果与单独格式化相同，出错的源码只影响自己。
+ */
+TEST(SessionTest, FormatsEachSourceInOrder) {
+  std::vector<std::string> texts = make_sources(3);
+  texts.insert(texts.begin() + 1, "let = ;\n");
+
+  SessionOptions options;
+  options.jobs = 1;
+  Session session(options);
+  auto results = session.run(as_inputs(texts));
+  ASSERT_EQ(results.size(), texts.size());
+
+  EXPECT_FALSE(results[1].success);
+  ASSERT_FALSE(results[1].diagnostics.empty());
+  EXPECT_EQ(results[1].diagnostics[0].get_location().line, 1u);
+  EXPECT_FALSE(
+      results[1].diagnostics[0].format(session.get_messages(), false).empty());
+  EXPECT_TRUE(results[1].formatted.empty());
+
+  for (size_t i : {0, 2, 3}) {
+    EXPECT_TRUE(results[i].success) << i;
+    EXPECT_TRUE(results[i].diagnostics.empty()) << i;
+    EXPECT_TRUE(results[i].changed) << i;
+    EXPECT_EQ(results[i].formatted, format_alone(texts[i])) << i;
+  }
+
+  // 同一会话可以再次使用，已格式化的源码不再变化。
+  std::vector<std::string> again{results[0].formatted};
+  auto second = session.run(as_inputs(again));
+  ASSERT_EQ(second.size(), 1u);
+  EXPECT_TRUE(second[0].success);
+  EXPECT_FALSE(second[0].changed);
+}
+
+/**
+ * @brief 测试并行处理的结果与串行处理相同。
+ */
+TEST(SessionTest, ParallelRunMatchesSerialRun) {
+  std::vector<std::string> texts = make_sources(24);
+  texts[7] = "fn broken( {\n";
+
+  SessionOptions serial_options;
+  serial_options.jobs = 1;
+  Session serial(serial_options);
+  auto expected = serial.run(as_inputs(texts));
+
+  SessionOptions parallel_options;
+  parallel_options.jobs = 4;
+  Session parallel(parallel_options);
+  auto actual = parallel.run(as_inputs(texts));
+
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < texts.size(); ++i) {
+    EXPECT_EQ(actual[i].success, expected[i].success) << i;
+    EXPECT_EQ(actual[i].formatted, expected[i].formatted) << i;
+    ASSERT_EQ(actual[i].diagnostics.size(), expected[i].diagnostics.size());
+    for (size_t j = 0; j < actual[i].diagnostics.size(); ++j) {
+      EXPECT_EQ(actual[i].diagnostics[j].get_code(),
+                expected[i].diagnostics[j].get_code());
+    }
+  }
+  EXPECT_FALSE(actual[7].success);
+}
+
+/**
+ * @brief 测试每份源码在达到错误上限后停止，上限不影响其他源码。
+ */
+TEST(SessionTest, StopsEachSourceAtErrorLimit) {
+  std::string broken;
+  for (int i = 0; i < 50; ++i) {
+    broken += "let = ;\n";
+  }
+  std::vector<std::string> texts = make_sources(2);
+  texts.insert(texts.begin(), broken);
+  texts.push_back(broken);
+
+  SessionOptions options;
+  options.action = SessionAction::Parse;
+  options.jobs = 1;
+  options.max_errors = 2;
+  Session session(options);
+  auto results = session.run(as_inputs(texts));
+  ASSERT_EQ(results.size(), 4u);
+  for (size_t i : {0, 3}) {
+    EXPECT_FALSE(results[i].success) << i;
+    EXPECT_EQ(results[i].diagnostics.size(), 2u) << i;
+  }
+  EXPECT_TRUE(results[1].success);
+  EXPECT_TRUE(results[2].success);
+}
+
+/**
+ * @brief 测试语法检查可以返回 CST，构建 AST 时结果共享会话的驻留表。
+ */
+TEST(SessionTest, ParsesAndBuildsAST) {
+  std::vector<std::string> texts = make_sources(2);
+
+  SessionOptions parse_options;
+  parse_options.action = SessionAction::Parse;
+  parse_options.keep_cst = true;
+  Session parse_session(parse_options);
+  auto parsed = parse_session.run(as_inputs(texts));
+  ASSERT_EQ(parsed.size(), 2u);
+  ASSERT_NE(parsed[0].cst, nullptr);
+  EXPECT_EQ(parsed[0].cst->get_type(), cst::CSTNodeType::Program);
+  EXPECT_TRUE(parsed[1].formatted.empty());
+
+  SessionOptions ast_options;
+  ast_options.action = SessionAction::BuildAST;
+  ast_options.jobs = 2;
+  Session ast_session(ast_options);
+  auto built = ast_session.run(as_inputs(texts));
+  ASSERT_EQ(built.size(), 2u);
+  for (const auto& result : built) {
+    EXPECT_TRUE(result.success);
+    ASSERT_NE(result.program, nullptr);
+    EXPECT_EQ(result.program->get_declarations().size(), 2u);
+    EXPECT_EQ(result.cst, nullptr);
+  }
+  EXPECT_GT(ast_session.get_interner().size(), 0u);
+}
@@ -0,0 +1,159 @@
+/**
+ * @file test_source_buffer.cpp
+ * @brief 源码缓冲区测试套件（使用 Google Test 框架）。
+ * @details 测试 `SourceBuffer` 对小文件、大文件（内存映射）、输入流与
+ *          不存在的文件的处理，以及以其构造的 `Lexer` 与按字符串构造的
+ *          结果一致；借用与共享缓冲区时不复制源码。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/lexer/lexer.hpp"
+#include "czc/utils/source_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace czc::lexer;
+using namespace czc::utils;
+
+/**
+ * @brief 源码缓冲区测试夹具，提供一个临时文件路径。
+ */
+class SourceBufferTest : public ::testing::Test {
+protected:
+  std::string path;
+
+  void SetUp() override {
+    path = (std::filesystem::temp_directory_path() /
+            ("czc_source_buffer_" +
+             std::string(::testing::UnitTest::GetInstance()
+                             ->current_test_info()
+                             ->name()) +
+             ".zero"))
+               .string();
+  }
+
+  void TearDown() override {
+    std::remove(path.c_str());
+  }
+
+  void write_file(const std::string& content) {
+    std::ofstream output(path, std::ios::binary);
+    output << content;
+  }
+};
+
+/**
+ * @brief 测试小文件直接读入，内容与文件一致；空文件得到空缓冲区。
+ */
+TEST_F(SourceBufferTest, ReadsSmallFile) {
+  write_file("let x = 1;\n");
+  auto buffer = SourceBuffer::open(path);
+  ASSERT_TRUE(buffer.has_value());
+  EXPECT_FALSE(buffer->is_mapped());
+  EXPECT_EQ(buffer->view(), "let x = 1;\n");
+
+  write_file("");
+  auto empty = SourceBuffer::open(path);
+  ASSERT_TRUE(empty.has_value());
+  EXPECT_EQ(empty->size(), 0u);
+}
+
+/**
+ * @brief 测试大文件以内存映射读取，预读与移动后内容保持有效。
+ */
+TEST_F(SourceBufferTest, MapsLargeFile) {
+  std::string content;
+  while (content.size() < SourceBuffer::MMAP_THRESHOLD * 2) {
+    content += "let value = 1234567890;\n";
+  }
+  write_file(content);
+
+  auto buffer = SourceBuffer::open(path);
+  ASSERT_TRUE(buffer.has_value());
+  EXPECT_TRUE(buffer->is_mapped());
+  buffer->prefetch();
+  EXPECT_EQ(buffer->view(), content);
+
+  SourceBuffer moved = std::move(*buffer);
+  EXPECT_EQ(moved.view(), content);
+  EXPECT_EQ(buffer->size(), 0u);
+}
+
+/**
+ * @brief 测试不存在的文件返回空，输入流一次读完，短字符串移动后仍正确。
+ */
+TEST_F(SourceBufferTest, MissingFileAndStreams) {
+  EXPECT_FALSE(SourceBuffer::open(path + ".missing").has_value());
+
+  std::istringstream stream("fn main() {}\n");
+  SourceBuffer from_stream = SourceBuffer::read_stream(stream);
+  EXPECT_EQ(from_stream.view(), "fn main() {}\n");
+
+  // 短字符串存放在对象内部，移动后必须重新指向新对象。
+  SourceBuffer small(std::string("ab"));
+  SourceBuffer target;
+  target = std::move(small);
+  EXPECT_EQ(target.view(), "ab");
+}
+
+/**
+ * @brief 测试借用缓冲区的 Lexer 与按字符串构造的 Lexer 产生相同的 Token。
+ */
+TEST_F(SourceBufferTest, LexerBorrowsBuffer) {
+  std::string content;
+  for (int i = 0; i < 4000; ++i) {
+    content += "fn f" + std::to_string(i) + "(a) { return a * 2.5e3; }\n";
+  }
+  write_file(content);
+  auto buffer = SourceBuffer::open(path);
+  ASSERT_TRUE(buffer.has_value());
+
+  Lexer borrowed(*buffer, path);
+  EXPECT_EQ(borrowed.get_source_tracker().get_input().data(),
+            buffer->view().data());
+  auto borrowed_tokens = borrowed.tokenize();
+
+  Lexer copied(content, path);
+  auto copied_tokens = copied.tokenize();
+
+  ASSERT_EQ(borrowed_tokens.size(), copied_tokens.size());
+  for (size_t i = 0; i < copied_tokens.size(); ++i) {
+    EXPECT_EQ(borrowed_tokens[i].token_type, copied_tokens[i].token_type);
+    EXPECT_EQ(borrowed_tokens[i].value, copied_tokens[i].value);
+    EXPECT_EQ(borrowed_tokens[i].offset, copied_tokens[i].offset);
+  }
+}
+
+/**
+ * @brief 测试借用的缓冲区与共享缓冲区的 Lexer 都不复制源码，
+ *        且 `tokenize_spans` 的结果与 Lexer 共享同一份缓冲区。
+ */
+TEST_F(SourceBufferTest, BorrowAndShareWithoutCopy) {
+  std::string text = "let s = \"a\\nb\";\n";
+  SourceBuffer borrowed = SourceBuffer::borrow(text);
+  EXPECT_EQ(borrowed.view().data(), text.data());
+  SourceBuffer moved = std::move(borrowed);
+  EXPECT_EQ(moved.view().data(), text.data());
+
+  auto shared = std::make_shared<const SourceBuffer>(std::string(text));
+  Lexer lexer(shared, "shared.zero");
+  EXPECT_EQ(lexer.get_source_tracker().get_shared_input(), shared);
+  TokenSpanList spans = lexer.tokenize_spans();
+  EXPECT_EQ(spans.source().data(), shared->view().data());
+  EXPECT_EQ(spans.value(3), "a\nb");
+
+  // 移入的字符串直接成为跟踪器的缓冲区。
+  std::string owned = text;
+  const char* owned_data = owned.data();
+  Lexer moved_lexer(std::move(owned), "moved.zero");
+  EXPECT_EQ(moved_lexer.get_source_tracker().get_input().data(), owned_data);
+  EXPECT_EQ(moved_lexer.tokenize_spans().source(), text);
+}
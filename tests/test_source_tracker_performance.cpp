@@ -7,6 +7,7 @@
 
 #include "czc/utils/source_tracker.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <sstream>
 
@@ -98,3 +99,117 @@ TEST_F(SourceTrackerPerformanceTest, OutOfRange) {
   std::string out_of_range = tracker.get_source_line(999);
   EXPECT_TRUE(out_of_range.empty());
 }
+
+TEST_F(SourceTrackerPerformanceTest, AdvanceBytesMatchesAdvance) {
+  std::string source = "ab\nc\n\ndef  \nxyz";
+
+  for (size_t split = 0; split <= source.size(); split++) {
+    SourceTracker bulk(source, "test.zero");
+    SourceTracker stepwise(source, "test.zero");
+
+    bulk.advance_bytes(split);
+    for (size_t i = 0; i < split; i++) {
+      stepwise.advance(source[i]);
+    }
+
+    EXPECT_EQ(bulk.get_position(), stepwise.get_position()) << "split " << split;
+    EXPECT_EQ(bulk.get_line(), stepwise.get_line()) << "split " << split;
+    EXPECT_EQ(bulk.get_column(), stepwise.get_column()) << "split " << split;
+  }
+
+  // 超出末尾的部分会被截断。
+  SourceTracker tracker(source, "test.zero");
+  tracker.advance_bytes(source.size() + 10);
+  EXPECT_EQ(tracker.get_position(), source.size());
+  EXPECT_EQ(tracker.get_line(), 5);
+  EXPECT_EQ(tracker.get_column(), 4);
+}
+
+TEST_F(SourceTrackerPerformanceTest, LineIndexBuiltWhileAdvancing) {
+  std::string source = "first\nsecond line\n\nlast";
+  SourceTracker tracker(source, "test.zero");
+
+  // 一部分逐字符前进，一部分批量前进，然后查询已覆盖与未覆盖的行。
+  for (size_t i = 0; i < 8; i++) {
+    tracker.advance(source[i]);
+  }
+  tracker.advance_bytes(5);
+
+  EXPECT_EQ(tracker.get_source_line_view(1), "first");
+  EXPECT_EQ(tracker.get_source_line_view(2), "second line");
+  EXPECT_EQ(tracker.get_source_line_view(3), "");
+  EXPECT_EQ(tracker.get_source_line_view(4), "last");
+  EXPECT_TRUE(tracker.get_source_line_view(5).empty());
+  EXPECT_EQ(tracker.get_line_count(), 4);
+
+  // 惰性补齐之后继续前进，不会重复记录行起始位置。
+  tracker.advance_bytes(source.size());
+  EXPECT_EQ(tracker.get_line_count(), 4);
+  EXPECT_EQ(tracker.get_source_line(4), "last");
+}
+
+TEST_F(SourceTrackerPerformanceTest, OffsetToLineColumn) {
+  std::string source = "ab\nc\n\ndef";
+  SourceTracker tracker(source, "test.zero");
+  SourceTracker stepwise(source, "test.zero");
+
+  for (size_t offset = 0; offset <= source.size(); offset++) {
+    auto lc = tracker.offset_to_line_column(offset);
+    EXPECT_EQ(lc.line, stepwise.get_line()) << "offset " << offset;
+    EXPECT_EQ(lc.column, stepwise.get_column()) << "offset " << offset;
+    if (offset < source.size()) {
+      stepwise.advance(source[offset]);
+    }
+  }
+
+  auto past_end = tracker.offset_to_line_column(source.size() + 5);
+  EXPECT_EQ(past_end.line, 4);
+  EXPECT_EQ(past_end.column, 4);
+}
+
+TEST_F(SourceTrackerPerformanceTest, CountUtf8Chars) {
+  EXPECT_EQ(count_utf8_chars(""), 0u);
+  EXPECT_EQ(count_utf8_chars("plain ascii text"), 16u);
+  // 每个汉字 3 字节，emoji 4 字节，跨越 8 字节块的边界。
+  EXPECT_EQ(count_utf8_chars("变量名称和值"), 6u);
+  EXPECT_EQ(count_utf8_chars("a😀b变c"), 5u);
+  EXPECT_EQ(count_utf8_chars(std::string(100, 'x') + "é"), 101u);
+}
+
+TEST_F(SourceTrackerPerformanceTest, ResolveOffsetsMatchesSingleLookups) {
+  std::string source = generate_large_source(200) + "let 名字 = \"值\";\nend";
+  SourceTracker tracker(source, "test.zero");
+
+  std::vector<size_t> offsets;
+  for (size_t offset = 0; offset <= source.size() + 3; offset += 7) {
+    offsets.push_back(offset);
+  }
+  // 同一位置重复出现，以及一次跨越很多行的跳跃。
+  offsets.insert(offsets.begin() + 3, offsets[3]);
+  std::vector<ResolvedOffset> resolved;
+  tracker.resolve_offsets(offsets, resolved);
+  ASSERT_EQ(resolved.size(), offsets.size());
+
+  for (size_t i = 0; i < offsets.size(); i++) {
+    auto lc = tracker.offset_to_line_column(offsets[i]);
+    EXPECT_EQ(resolved[i].line, lc.line) << "offset " << offsets[i];
+    EXPECT_EQ(resolved[i].column, lc.column) << "offset " << offsets[i];
+    EXPECT_EQ(resolved[i].line_text, tracker.get_source_line_view(lc.line));
+    size_t line_start = tracker.line_column_to_offset(lc.line, 1);
+    size_t offset = std::min(offsets[i], source.size());
+    EXPECT_EQ(resolved[i].char_column,
+              count_utf8_chars(std::string_view(source).substr(
+                  line_start, offset - line_start)) +
+                  1);
+    EXPECT_EQ(tracker.line_column_to_offset(lc.line, lc.column), offset);
+  }
+
+  // 非升序的偏移同样得到正确结果。
+  std::vector<size_t> shuffled = {source.size() - 2, 5, source.size() - 10};
+  tracker.resolve_offsets(shuffled, resolved);
+  for (size_t i = 0; i < shuffled.size(); i++) {
+    auto lc = tracker.offset_to_line_column(shuffled[i]);
+    EXPECT_EQ(resolved[i].line, lc.line);
+    EXPECT_EQ(resolved[i].column, lc.column);
+  }
+}
@@ -0,0 +1,230 @@
+/**
+ * @file test_string_interner.cpp
+ * @brief 字符串驻留表的测试。
+ * @details 覆盖 `StringInterner` 的去重与查找、多线程共享，Lexer 与
+ *          `ASTBuilder` 通过共享的驻留表传递标识符句柄，以及文件名登记表
+ *          `SourceManager` 与紧凑的 `SourceLocation`。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/ast/ast_builder.hpp"
+#include "czc/ast/ast_context.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/utils/source_location.hpp"
+#include "czc/utils/source_manager.hpp"
+#include "czc/utils/string_interner.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace czc;
+using namespace czc::ast;
+using namespace czc::lexer;
+using namespace czc::parser;
+using namespace czc::utils;
+
+/**
+ * @brief 测试相同内容得到相同句柄，不同内容得到不同句柄。
+ */
+TEST(StringInternerTest, DeduplicatesByContent) {
+  StringInterner interner;
+  std::string first = "counter";
+  std::string second = "counter";
+
+  auto a = interner.intern(first);
+  auto b = interner.intern(second);
+  auto c = interner.intern("count");
+
+  EXPECT_TRUE(a.get_symbol().is_valid());
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(a.get_view().data(), b.get_view().data());
+  EXPECT_NE(a.get_view().data(), first.data());
+  EXPECT_EQ(interner.size(), 2u);
+}
+
+/**
+ * @brief 测试按句柄取回文本，包括空串与无效句柄。
+ */
+TEST(StringInternerTest, LooksUpTextBySymbol) {
+  StringInterner interner;
+  auto empty = interner.intern("");
+  auto name = interner.intern("名字");
+
+  EXPECT_TRUE(empty.get_symbol().is_valid());
+  EXPECT_EQ(interner.get_string(empty.get_symbol()), "");
+  EXPECT_EQ(interner.get_string(name.get_symbol()), "名字");
+  EXPECT_EQ(interner.get_string(Symbol()), "");
+  EXPECT_EQ(interner.get_string(Symbol(12345u << 4)), "");
+}
+
+/**
+ * @brief 测试多个线程同时驻留同一组字符串时得到一致的句柄。
+ */
+TEST(StringInternerTest, ConcurrentInternsAgree) {
+  StringInterner interner;
+  constexpr size_t NAME_COUNT = 2000;
+  constexpr size_t THREAD_COUNT = 4;
+
+  std::vector<std::vector<Symbol>> results(THREAD_COUNT);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < THREAD_COUNT; ++t) {
+    threads.emplace_back([&interner, &results, t]() {
+      for (size_t i = 0; i < NAME_COUNT; ++i) {
+        // 各线程以不同顺序访问，制造竞争
+        size_t index = (i * (t + 1) * 7919) % NAME_COUNT;
+        results[t].push_back(
+            interner.intern("name_" + std::to_string(index)).get_symbol());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(interner.size(), NAME_COUNT);
+  for (size_t i = 0; i < NAME_COUNT; ++i) {
+    std::string expected = "name_" + std::to_string(i);
+    Symbol symbol = interner.intern(expected).get_symbol();
+    EXPECT_EQ(interner.get_string(symbol), expected);
+  }
+  for (size_t t = 1; t < THREAD_COUNT; ++t) {
+    for (size_t i = 0; i < NAME_COUNT; ++i) {
+      size_t index = (i * (t + 1) * 7919) % NAME_COUNT;
+      EXPECT_EQ(interner.get_string(results[t][i]),
+                "name_" + std::to_string(index));
+    }
+  }
+}
+
+/**
+ * @brief 测试 Lexer 只为标识符填写句柄，且相同名字句柄相同。
+ */
+TEST(StringInternerTest, LexerTagsIdentifiers) {
+  StringInterner interner;
+  Lexer lexer("let value = value + other;", "test.zero");
+  lexer.set_interner(&interner);
+  auto tokens = lexer.tokenize();
+
+  std::vector<Symbol> identifiers;
+  for (const auto& token : tokens) {
+    if (token.token_type == TokenType::Identifier) {
+      ASSERT_TRUE(token.symbol.is_valid());
+      EXPECT_EQ(interner.get_string(token.symbol), token.value);
+      identifiers.push_back(token.symbol);
+    } else {
+      EXPECT_FALSE(token.symbol.is_valid());
+    }
+  }
+  ASSERT_EQ(identifiers.size(), 3u);
+  EXPECT_EQ(identifiers[0], identifiers[1]);
+  EXPECT_NE(identifiers[0], identifiers[2]);
+}
+
+/**
+ * @brief 测试共享驻留表时 AST 中的名字按句柄比较。
+ */
+TEST(StringInternerTest, ASTNamesShareSymbols) {
+  StringInterner interner;
+  std::string source = "fn id(x) { return x; }\nlet y = id(y);\n";
+  Lexer lexer(source, "test.zero");
+  lexer.set_interner(&interner);
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens);
+  auto cst = parser.parse();
+
+  ASTContext context(interner);
+  ASTBuilder builder(context);
+  auto program = builder.build(cst.get());
+  ASSERT_EQ(program->get_declarations().size(), 2u);
+
+  auto fn = dynamic_cast<FunctionDecl*>(program->get_declarations()[0]);
+  auto var = dynamic_cast<VarDecl*>(program->get_declarations()[1]);
+  ASSERT_NE(fn, nullptr);
+  ASSERT_NE(var, nullptr);
+
+  auto call = dynamic_cast<CallExpr*>(var->get_initializer());
+  ASSERT_NE(call, nullptr);
+  auto callee = dynamic_cast<Identifier*>(call->get_callee());
+  auto argument = dynamic_cast<Identifier*>(call->get_arguments()[0]);
+  ASSERT_NE(callee, nullptr);
+  ASSERT_NE(argument, nullptr);
+
+  EXPECT_EQ(callee->get_name_symbol(), fn->get_name_symbol());
+  EXPECT_EQ(argument->get_name_symbol(), var->get_name_symbol());
+  EXPECT_NE(callee->get_name_symbol(), argument->get_name_symbol());
+  EXPECT_EQ(fn->get_name(), "id");
+}
+
+/**
+ * @brief 测试文件名登记后编号稳定，位置可以查回文件名。
+ */
+TEST(SourceManagerTest, FileIdsRoundTrip) {
+  auto& manager = SourceManager::instance();
+  EXPECT_EQ(manager.get_filename(SourceManager::STDIN_FILE), "<stdin>");
+  EXPECT_EQ(manager.get_filename(SourceManager::UNKNOWN_FILE), "");
+  EXPECT_EQ(manager.add_file("<stdin>"), SourceManager::STDIN_FILE);
+
+  std::string path = "some/rather/long/directory/name/source_manager.zero";
+  FileId id = manager.add_file(path);
+  EXPECT_EQ(manager.add_file(path), id);
+  EXPECT_NE(manager.add_file("other.zero"), id);
+  EXPECT_EQ(manager.get_filename(id), path);
+  EXPECT_EQ(manager.get_filename(static_cast<FileId>(manager.size())), "");
+
+  SourceLocation by_name(path, 3, 4, 3, 9);
+  SourceLocation by_id(id, 3, 4, 3, 9);
+  EXPECT_EQ(by_name.file_id, id);
+  EXPECT_EQ(by_id.get_filename(), path);
+  EXPECT_EQ(by_id.end_column, 9u);
+  EXPECT_EQ(SourceLocation().get_filename(), "<stdin>");
+  EXPECT_EQ(SourceLocation(id, 7, 2).end_line, 7u);
+}
+
+/**
+ * @brief 测试多个线程同时登记同一组文件名得到一致的编号。
+ */
+TEST(SourceManagerTest, ConcurrentRegistrationAgrees) {
+  constexpr int THREAD_COUNT = 4;
+  constexpr int FILE_COUNT = 200;
+  std::vector<std::vector<FileId>> results(THREAD_COUNT);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREAD_COUNT; ++t) {
+    threads.emplace_back([&results, t]() {
+      for (int i = 0; i < FILE_COUNT; ++i) {
+        results[t].push_back(SourceManager::instance().add_file(
+            "concurrent_" + std::to_string(i) + ".zero"));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 1; t < THREAD_COUNT; ++t) {
+    EXPECT_EQ(results[t], results[0]);
+  }
+  EXPECT_EQ(SourceManager::instance().get_filename(results[0][5]),
+            "concurrent_5.zero");
+}
+
+/**
+ * @brief 测试解析器产生的位置携带输入的文件编号，且位置保持紧凑。
+ */
+TEST(SourceManagerTest, ParserLocationsCarryFileId) {
+  static_assert(sizeof(SourceLocation) == 5 * sizeof(uint32_t),
+                "SourceLocation should stay compact");
+  std::string source = "let x = 1;\n";
+  Lexer lexer(source, "located.zero");
+  auto tokens = lexer.tokenize();
+  Parser parser(tokens, "located.zero");
+  auto cst = parser.parse();
+  ASSERT_NE(cst, nullptr);
+  EXPECT_EQ(cst->get_location().file_id,
+            SourceManager::instance().add_file("located.zero"));
+  EXPECT_EQ(cst->get_location().get_filename(), "located.zero");
+}
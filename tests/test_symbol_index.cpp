@@ -0,0 +1,191 @@
+/**
+ * @file test_symbol_index.cpp
+ * @brief 符号提取（`extract_symbols`）与符号索引（`SymbolIndex`）的测试。
+ * @details 覆盖顶层声明、参数与字段的提取，不完整声明的容错，以及索引的
+ *          保存、载入、按修改时间的增量更新与损坏数据的拒绝。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/index/symbol_index.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/utils/thread_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace czc;
+using namespace czc::index;
+
+namespace {
+
+std::vector<Symbol> extract(const std::string& source) {
+  auto tokens = lexer::Lexer(source).tokenize();
+  return extract_symbols(tokens, source);
+}
+
+/**
+ * @brief 写入文件并把修改时间设为 `age` 之前，使其时间戳可信。
+ */
+void write_file(const std::filesystem::path& path, const std::string& content,
+                std::chrono::minutes age) {
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+  std::filesystem::last_write_time(
+      path, std::filesystem::file_time_type::clock::now() - age);
+}
+
+} // namespace
+
+/**
+ * @brief 测试提取顶层声明、参数与字段，跳过函数体与非顶层的声明。
+ */
+TEST(SymbolIndexTest, ExtractsTopLevelDeclarations) {
+  auto symbols = extract("// 点\n"
+                         "struct Point { x: Integer, y: (Integer, Float) };\n"
+                         "fn area(p: Point, // 参数\n"
+                         "        scale) -> Integer | Float {\n"
+                         "  fn inner() {}\n"
+                         "  let s = struct { a: Integer };\n"
+                         "  return p.x;\n"
+                         "}\n"
+                         "let f = fn (a) { return a; };\n"
+                         "type Shape = Point | struct { r: Float };\n");
+
+  ASSERT_EQ(symbols.size(), 7u);
+  EXPECT_EQ(symbols[0].kind, SymbolKind::Struct);
+  EXPECT_EQ(symbols[0].name, "Point");
+  EXPECT_EQ(symbols[0].line, 2u);
+  EXPECT_EQ(symbols[0].column, 8u);
+  EXPECT_EQ(symbols[0].parent, Symbol::NO_PARENT);
+
+  EXPECT_EQ(symbols[1].kind, SymbolKind::Field);
+  EXPECT_EQ(symbols[1].name, "x");
+  EXPECT_EQ(symbols[1].detail, "Integer");
+  EXPECT_EQ(symbols[1].parent, 0u);
+  EXPECT_EQ(symbols[2].name, "y");
+  EXPECT_EQ(symbols[2].detail, "(Integer, Float)");
+
+  EXPECT_EQ(symbols[3].kind, SymbolKind::Function);
+  EXPECT_EQ(symbols[3].name, "area");
+  EXPECT_EQ(symbols[3].detail, "(p: Point, scale) -> Integer | Float");
+  EXPECT_EQ(symbols[4].kind, SymbolKind::Parameter);
+  EXPECT_EQ(symbols[4].name, "p");
+  EXPECT_EQ(symbols[4].detail, "Point");
+  EXPECT_EQ(symbols[4].parent, 3u);
+  EXPECT_EQ(symbols[5].name, "scale");
+  EXPECT_EQ(symbols[5].detail, "");
+
+  EXPECT_EQ(symbols[6].kind, SymbolKind::TypeAlias);
+  EXPECT_EQ(symbols[6].name, "Shape");
+  EXPECT_EQ(symbols[6].detail, "Point | struct { r: Float }");
+}
+
+/**
+ * @brief 测试不完整的声明能提取多少就提取多少，不影响其后的声明。
+ */
+TEST(SymbolIndexTest, ToleratesIncompleteDeclarations) {
+  auto symbols = extract("fn broken(a: Integer\n"
+                         "struct S { x: }\n"
+                         "type T;\n");
+  ASSERT_GE(symbols.size(), 2u);
+  EXPECT_EQ(symbols[0].name, "broken");
+  EXPECT_EQ(symbols[1].name, "a");
+
+  symbols = extract("fn f() -> struct { a: Integer } { return 1; }\n"
+                    "type T;\n"
+                    "struct S { x: }\n"
+                    "fn g(");
+  ASSERT_EQ(symbols.size(), 5u);
+  EXPECT_EQ(symbols[0].detail, "() -> struct { a: Integer }");
+  EXPECT_EQ(symbols[1].name, "T");
+  EXPECT_EQ(symbols[1].detail, "");
+  EXPECT_EQ(symbols[2].name, "S");
+  EXPECT_EQ(symbols[3].name, "x");
+  EXPECT_EQ(symbols[4].name, "g");
+}
+
+/**
+ * @brief 测试索引的保存与载入，以及只重新扫描改变了的文件。
+ */
+TEST(SymbolIndexTest, UpdatesIncrementallyFromModificationTimes) {
+  auto directory =
+      std::filesystem::temp_directory_path() / "czc_symbol_index_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  std::string a = (directory / "a.zero").string();
+  std::string b = (directory / "b.zero").string();
+  std::string index_path = (directory / "index").string();
+  write_file(a, "fn main() { helper(); }\n", std::chrono::minutes(60));
+  write_file(b, "fn helper(x: Integer) {}\n", std::chrono::minutes(60));
+
+  utils::ThreadPool pool(2);
+  SymbolIndex index("1.0");
+  IndexUpdateStats stats = index.update({a, b}, &pool);
+  EXPECT_EQ(stats.scanned_files, 2u);
+  EXPECT_EQ(index.symbol_count(), 3u);
+  ASSERT_TRUE(index.save(index_path));
+
+  SymbolIndex loaded("1.0");
+  ASSERT_TRUE(loaded.load(index_path));
+  auto matches = loaded.find("x");
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(*matches[0].file, b);
+  ASSERT_NE(matches[0].parent, nullptr);
+  EXPECT_EQ(matches[0].parent->name, "helper");
+  EXPECT_TRUE(loaded.find("missing").empty());
+
+  stats = loaded.update({a, b});
+  EXPECT_EQ(stats.reused_files, 2u);
+  EXPECT_EQ(stats.scanned_files, 0u);
+
+  write_file(b, "fn helper2() {}\n", std::chrono::minutes(30));
+  stats = loaded.update({a, b});
+  EXPECT_EQ(stats.reused_files, 1u);
+  EXPECT_EQ(stats.scanned_files, 1u);
+  EXPECT_EQ(stats.removed_files, 0u);
+  EXPECT_TRUE(loaded.find("helper").empty());
+  EXPECT_EQ(loaded.find("helper2").size(), 1u);
+
+  stats = loaded.update({a, (directory / "missing.zero").string()});
+  EXPECT_EQ(stats.removed_files, 1u);
+  EXPECT_EQ(stats.failed_files, 1u);
+  EXPECT_EQ(loaded.get_files().size(), 1u);
+
+  // 版本不同的索引视为空。
+  EXPECT_FALSE(SymbolIndex("2.0").load(index_path));
+  std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief 测试截断或损坏的索引文件被拒绝。
+ */
+TEST(SymbolIndexTest, RejectsCorruptIndexFiles) {
+  auto directory =
+      std::filesystem::temp_directory_path() / "czc_symbol_index_corrupt";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  std::string source = (directory / "a.zero").string();
+  std::string index_path = (directory / "index").string();
+  write_file(source, "struct P { x: Integer };\n", std::chrono::minutes(60));
+
+  SymbolIndex index("1.0");
+  index.update({source});
+  ASSERT_TRUE(index.save(index_path));
+
+  std::ifstream input(index_path, std::ios::binary);
+  std::string data((std::istreambuf_iterator<char>(input)),
+                   std::istreambuf_iterator<char>());
+  input.close();
+  for (size_t size = 0; size < data.size(); ++size) {
+    std::ofstream(index_path, std::ios::binary | std::ios::trunc)
+        << data.substr(0, size);
+    SymbolIndex truncated("1.0");
+    EXPECT_FALSE(truncated.load(index_path)) << "size " << size;
+    EXPECT_TRUE(truncated.get_files().empty());
+  }
+  std::filesystem::remove_all(directory);
+}
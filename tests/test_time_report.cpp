@@ -0,0 +1,164 @@
+/**
+ * @file test_time_report.cpp
+ * @brief 按阶段计时与计数（`TimeReport`）的测试。
+ * @details 覆盖统计关闭时不记录任何内容，打开后各阶段的调用次数、
+ *          Token / CST / AST 节点与错误计数，表格与 JSON 输出，以及
+ *          Chrome Trace 事件的记录与输出。
+ * @author BegoniaHe
+ * @date 2025-11-21
+ */
+
+#include "czc/ast/ast_builder.hpp"
+#include "czc/ast/ast_context.hpp"
+#include "czc/formatter/formatter.hpp"
+#include "czc/lexer/lexer.hpp"
+#include "czc/parser/parser.hpp"
+#include "czc/token_preprocessor/token_preprocessor.hpp"
+#include "czc/utils/time_report.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace czc;
+using namespace czc::utils;
+
+namespace {
+
+// 依次运行全部五个阶段。
+void run_pipeline(const std::string& source) {
+  lexer::Lexer lexer(source, "report.zero");
+  auto tokens = lexer.tokenize();
+  token_preprocessor::TokenPreprocessor preprocessor;
+  preprocessor.process_in_place(tokens, "report.zero", source);
+  parser::Parser parser(tokens, "report.zero");
+  auto cst = parser.parse();
+  ast::ASTContext context;
+  ast::ASTBuilder builder(context);
+  (void)builder.build(cst.get());
+  formatter::Formatter formatter;
+  (void)formatter.format(cst.get());
+}
+
+/**
+ * @brief 每个测试前后清空汇总并关闭统计。
+ */
+class TimeReportTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+#if !CZC_ENABLE_TIME_REPORT
+    GTEST_SKIP() << "built with CZC_TIME_REPORT=OFF";
+#endif
+    TimeReport::set_enabled(false);
+    TimeReport::set_tracing(false);
+    TimeReport::reset();
+  }
+
+  void TearDown() override {
+    TimeReport::set_enabled(false);
+    TimeReport::set_tracing(false);
+    TimeReport::reset();
+  }
+};
+
+} // namespace
+
+/**
+ * @brief 测试统计关闭时各阶段都没有记录。
+ */
+TEST_F(TimeReportTest, DisabledRecordsNothing) {
+  run_pipeline("let x = 1;\n");
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    EXPECT_EQ(TimeReport::get(static_cast<Phase>(i)).calls, 0u);
+  }
+}
+
+/**
+ * @brief 测试打开统计后每个阶段都被计时，计数与实际结果一致。
+ */
+TEST_F(TimeReportTest, RecordsEveryPhase) {
+  TimeReport::set_enabled(true);
+  run_pipeline("fn add(a, b) {\n    return a + b;\n}\nlet x = add(1, 2);\n");
+
+  for (size_t i = 0; i < PHASE_COUNT; ++i) {
+    EXPECT_EQ(TimeReport::get(static_cast<Phase>(i)).calls, 1u)
+        << TimeReport::phase_name(static_cast<Phase>(i));
+  }
+  auto lex = TimeReport::get(Phase::Lex);
+  EXPECT_GT(lex.metrics[static_cast<size_t>(Metric::Tokens)], 10u);
+  EXPECT_EQ(TimeReport::get(Phase::Preprocess)
+                .metrics[static_cast<size_t>(Metric::Tokens)],
+            lex.metrics[static_cast<size_t>(Metric::Tokens)]);
+  EXPECT_GT(TimeReport::get(Phase::Parse)
+                .metrics[static_cast<size_t>(Metric::CSTNodes)],
+            0u);
+  EXPECT_GT(TimeReport::get(Phase::BuildAST)
+                .metrics[static_cast<size_t>(Metric::ASTNodes)],
+            0u);
+  EXPECT_EQ(TimeReport::get(Phase::Parse)
+                .metrics[static_cast<size_t>(Metric::Errors)],
+            0u);
+}
+
+/**
+ * @brief 测试解析错误计入 Parse 阶段的错误数。
+ */
+TEST_F(TimeReportTest, CountsErrors) {
+  TimeReport::set_enabled(true);
+  run_pipeline("let = ;\n");
+  EXPECT_GT(TimeReport::get(Phase::Parse)
+                .metrics[static_cast<size_t>(Metric::Errors)],
+            0u);
+}
+
+/**
+ * @brief 测试表格只列出执行过的阶段，JSON 列出全部阶段。
+ */
+TEST_F(TimeReportTest, PrintsTableAndJson) {
+  TimeReport::set_enabled(true);
+  lexer::Lexer lexer("let x = 1;\n");
+  (void)lexer.tokenize();
+
+  std::ostringstream table;
+  TimeReport::print_table(table);
+  EXPECT_NE(table.str().find("lex"), std::string::npos);
+  EXPECT_EQ(table.str().find("format"), std::string::npos);
+  EXPECT_NE(table.str().find("total"), std::string::npos);
+
+  auto json = TimeReport::to_json();
+  const JsonValue* phases = json.find("phases");
+  ASSERT_NE(phases, nullptr);
+  ASSERT_NE(phases->find("lex"), nullptr);
+  ASSERT_NE(phases->find("format"), nullptr);
+  EXPECT_EQ(phases->find("lex")->find("calls")->as_number(), 1.0);
+}
+
+/**
+ * @brief 测试追踪为每个阶段记录带文件名的事件，并输出合法的 Trace JSON。
+ */
+TEST_F(TimeReportTest, WritesTraceEvents) {
+  TimeReport::set_tracing(true);
+  {
+    ScopedTraceSpan span("file", "file", "traced.zero");
+    run_pipeline("let x = 1;\n");
+  }
+  // 五个阶段加上文件本身
+  EXPECT_EQ(TimeReport::trace_event_count(), PHASE_COUNT + 1);
+  EXPECT_TRUE(TimeReport::get_thread_file().empty());
+  // 只打开追踪时不累加统计
+  EXPECT_EQ(TimeReport::get(Phase::Lex).calls, 0u);
+
+  std::ostringstream out;
+  TimeReport::write_trace(out);
+  auto trace = JsonValue::parse(out.str());
+  ASSERT_TRUE(trace.has_value());
+  const JsonValue* events = trace->find("traceEvents");
+  ASSERT_NE(events, nullptr);
+  // 一个线程名元数据事件加上全部完整事件
+  ASSERT_EQ(events->as_array().size(), PHASE_COUNT + 2);
+  const JsonValue& lex = events->as_array()[1];
+  EXPECT_EQ(lex.find("name")->as_string(), "lex");
+  EXPECT_EQ(lex.find("ph")->as_string(), "X");
+  EXPECT_EQ(lex.find("args")->find("file")->as_string(), "traced.zero");
+}
@@ -181,7 +181,7 @@ TEST_F(TokenPreprocessorTest, ExplicitPositiveExponent) {
 /**
  * @brief 测试完整 Token 流的处理。
  * @details 验证预处理器能够正确处理包含多个科学记数法字面量的 Token 流，
- *          并根据分析结果修改 Token 类型（Integer 或 Float）。
+ *          并根据分析结果修改 Token 类型（Integer 或 Float）、解码其值。
  */
 TEST_F(TokenPreprocessorTest, TokenStreamProcessing) {
   std::string code = "let a = 1e10; let b = 3.14e-5; let c = 1.5e2;";
@@ -197,16 +197,22 @@ TEST_F(TokenPreprocessorTest, TokenStreamProcessing) {
 
   for (const auto& token : processed) {
     if (token.value == "1e10") {
-      // 1e10 应被推断为整数
+      // 1e10 应被推断为整数，并随之解码
       EXPECT_EQ(token.token_type, TokenType::Integer);
+      ASSERT_TRUE(token.has_numeric_value);
+      EXPECT_EQ(token.integer_value, 10000000000);
       found_1e10 = true;
     } else if (token.value == "3.14e-5") {
       // 3.14e-5 应被推断为浮点数
       EXPECT_EQ(token.token_type, TokenType::Float);
+      ASSERT_TRUE(token.has_numeric_value);
+      EXPECT_DOUBLE_EQ(token.float_value, 3.14e-5);
       found_314e5 = true;
     } else if (token.value == "1.5e2") {
       // 1.5e2 = 150，应被推断为整数
       EXPECT_EQ(token.token_type, TokenType::Integer);
+      ASSERT_TRUE(token.has_numeric_value);
+      EXPECT_EQ(token.integer_value, 150);
       found_15e2 = true;
     }
   }
@@ -217,6 +223,45 @@ TEST_F(TokenPreprocessorTest, TokenStreamProcessing) {
   EXPECT_TRUE(found_15e2);
 }
 
+/**
+ * @brief 测试就地处理与复制处理的结果一致。
+ * @details 就地处理只改写科学记数法 Token 的类型，其余 Token 原样保留。
+ */
+TEST_F(TokenPreprocessorTest, InPlaceProcessingMatchesCopy) {
+  std::string code = "let a = 1e10; let b = 3.14e-5; let c = 1e999; x(1, y);";
+  Lexer lexer(code);
+  auto tokens = lexer.tokenize();
+
+  TokenPreprocessor copying;
+  auto expected = copying.process(tokens, "<test>", code);
+
+  TokenPreprocessor in_place;
+  auto actual = tokens;
+  in_place.process_in_place(actual, "<test>", code);
+
+  TokenPreprocessor moving;
+  auto moved = moving.process(std::vector<Token>(tokens), "<test>", code);
+
+  ASSERT_EQ(actual.size(), expected.size());
+  ASSERT_EQ(moved.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(actual[i].token_type, expected[i].token_type);
+    EXPECT_EQ(actual[i].value, expected[i].value);
+    EXPECT_EQ(actual[i].line, expected[i].line);
+    EXPECT_EQ(actual[i].column, expected[i].column);
+    EXPECT_EQ(moved[i].token_type, expected[i].token_type);
+  }
+
+  // 错误报告与复制处理相同（1e999 溢出）。
+  ASSERT_EQ(in_place.get_errors().get_errors().size(),
+            copying.get_errors().get_errors().size());
+  ASSERT_EQ(moving.get_errors().get_errors().size(),
+            copying.get_errors().get_errors().size());
+  EXPECT_TRUE(in_place.get_errors().has_errors());
+  EXPECT_EQ(in_place.get_errors().get_errors()[0].code,
+            copying.get_errors().get_errors()[0].code);
+}
+
 // --- 实际数值验证测试 ---
 
 /**
@@ -551,4 +596,95 @@ TEST_F(TokenPreprocessorTest, MantissaExtraction) {
   ASSERT_TRUE(info.has_value());
   EXPECT_EQ(info->mantissa, "12.34");
   EXPECT_EQ(info->exponent, 5);
-}
\ No newline at end of file
+}
+/**
+ * @brief 测试不分配内存的类型推断与完整分析一致。
+ * @details 包括格式错误、指数越界以及整数/浮点数溢出的情况。
+ */
+TEST_F(TokenPreprocessorTest, InferMatchesAnalyze) {
+  const char* literals[] = {
+      "1e10",    "9e18",       "1e19",     "1e309",     "0.0e500",
+      "1.500e3", "5.e2",       ".5e2",     "1e-10",     "00012.3400e3",
+      "1e+5",    "1.5eabc",    "1e",       "e10",       "123.456",
+      "1e99999999999999999999", "1e-9223372036854775808"};
+
+  for (const char* literal : literals) {
+    TPErrorCollector analyze_errors;
+    TPErrorCollector infer_errors;
+    std::string filename = "<test>";
+    std::string source;
+    Token token(TokenType::ScientificExponent, literal, 1, 1);
+    AnalysisContext analyze_context(filename, source, &analyze_errors);
+    AnalysisContext infer_context(filename, source, &infer_errors);
+
+    auto info =
+        ScientificNotationAnalyzer::analyze(literal, &token, analyze_context);
+    auto type =
+        ScientificNotationAnalyzer::infer(literal, &token, infer_context);
+
+    ASSERT_EQ(info.has_value(), type.has_value()) << literal;
+    if (info.has_value()) {
+      EXPECT_EQ(info->inferred_type, *type) << literal;
+    }
+    ASSERT_EQ(analyze_errors.get_errors().size(),
+              infer_errors.get_errors().size())
+        << literal;
+    for (size_t i = 0; i < infer_errors.get_errors().size(); ++i) {
+      EXPECT_EQ(analyze_errors.get_errors()[i].code,
+                infer_errors.get_errors()[i].code);
+      EXPECT_EQ(analyze_errors.get_errors()[i].args,
+                infer_errors.get_errors()[i].args);
+    }
+  }
+}
+
+/**
+ * @brief 测试词法分析与预处理一趟完成时的结果与分两趟处理一致。
+ * @details 包括 Token 类型、预处理错误的代码与位置，以及零拷贝模式。
+ */
+TEST_F(TokenPreprocessorTest, FusedLexingMatchesSeparatePass) {
+  std::string code = "let a = 1e10;\nlet b = [3.14e-5, 1e19, 1e999];\n"
+                     "let c = 1.5e2 + 2.0E+3;\n";
+
+  Lexer separate_lexer(code, "<test>");
+  auto raw_tokens = separate_lexer.tokenize();
+  TokenPreprocessor separate;
+  auto expected = separate.process(raw_tokens, "<test>", code);
+
+  TokenPreprocessor fused;
+  std::string filename = "<test>";
+  ScientificTokenClassifier classifier(fused, filename, code);
+  Lexer fused_lexer(code, filename);
+  fused_lexer.set_scientific_classifier(&classifier);
+  auto actual = fused_lexer.tokenize();
+
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(actual[i].token_type, expected[i].token_type) << i;
+    EXPECT_EQ(actual[i].value, expected[i].value);
+  }
+
+  const auto& expected_errors = separate.get_errors().get_errors();
+  const auto& actual_errors = fused.get_errors().get_errors();
+  ASSERT_EQ(actual_errors.size(), expected_errors.size());
+  ASSERT_EQ(actual_errors.size(), 2u);
+  for (size_t i = 0; i < expected_errors.size(); ++i) {
+    EXPECT_EQ(actual_errors[i].code, expected_errors[i].code);
+    EXPECT_EQ(actual_errors[i].location.line, expected_errors[i].location.line);
+    EXPECT_EQ(actual_errors[i].location.column,
+              expected_errors[i].location.column);
+    EXPECT_EQ(actual_errors[i].args, expected_errors[i].args);
+  }
+
+  // 零拷贝模式下同样直接得到最终类型。
+  TokenPreprocessor fused_spans;
+  ScientificTokenClassifier span_classifier(fused_spans, filename, code);
+  Lexer span_lexer(code, filename);
+  span_lexer.set_scientific_classifier(&span_classifier);
+  auto spans = span_lexer.tokenize_spans().to_tokens();
+  ASSERT_EQ(spans.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(spans[i].token_type, expected[i].token_type) << i;
+  }
+  EXPECT_EQ(fused_spans.get_errors().get_errors().size(), 2u);
+}
@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 
 using namespace czc::lexer;
+using czc::diagnostics::DiagnosticCode;
 
 // --- Test Fixtures ---
 
@@ -194,3 +195,54 @@ TEST_F(Utf8EdgeCasesTest, MixedEncodingScenarios) {
 
   EXPECT_FALSE(lexer.get_errors().has_errors());
 }
+
+// --- Bulk Validation Tests ---
+
+TEST_F(Utf8EdgeCasesTest, BulkValidateReportsFirstInvalidOffset) {
+  // 超过一个 SIMD 数据块的 ASCII 前缀，后接 CJK 字符与一个截断的序列。
+  std::string text = std::string(40, 'a') + "函数变量" + "\xE4\xB8" + "tail";
+  const char* data = text.data();
+
+  EXPECT_EQ(Utf8Handler::validate(data, 0, 40), 40u);
+  EXPECT_EQ(Utf8Handler::validate(data, 0, 52), 52u);
+  EXPECT_EQ(Utf8Handler::validate(data, 0, text.size()), 52u);
+  // 区间末尾截断的多字节字符同样视为无效。
+  EXPECT_EQ(Utf8Handler::validate(data, 0, 41 + 1), 40u);
+
+  EXPECT_EQ(Utf8Handler::skip_multibyte(data, 40, text.size()), 52u);
+  EXPECT_EQ(Utf8Handler::skip_multibyte(data, 0, text.size()), 0u);
+}
+
+TEST_F(Utf8EdgeCasesTest, InvalidUtf8InLongStringKeepsPosition) {
+  // 无效字节前有多行 CJK 文本，错误位置应精确指向该字节。
+  std::string source = "let s = \"第一行文本\n第二行\xFF尾部\";";
+
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  const auto& errors = lexer.get_errors().get_errors();
+  ASSERT_EQ(errors.size(), 1u);
+  EXPECT_EQ(errors[0].code, DiagnosticCode::L0011_InvalidUtf8Sequence);
+  EXPECT_EQ(errors[0].location.line, 2u);
+  // 列号按字节计数："第二行" 占 9 个字节。
+  EXPECT_EQ(errors[0].location.column, 10u);
+
+  ASSERT_GE(tokens.size(), 4u);
+  EXPECT_EQ(tokens[3].token_type, TokenType::String);
+  EXPECT_EQ(tokens[3].value, "第一行文本\n第二行尾部");
+}
+
+TEST_F(Utf8EdgeCasesTest, LongCjkIdentifierAndRawString) {
+  std::string name = "计算结果_总和_" + std::string(20, 'x') + "变量";
+  std::string source = "let " + name + " = r\"原始\\n字符串\";";
+
+  Lexer lexer(source);
+  auto tokens = lexer.tokenize();
+
+  EXPECT_FALSE(lexer.get_errors().has_errors());
+  ASSERT_GE(tokens.size(), 5u);
+  EXPECT_EQ(tokens[1].token_type, TokenType::Identifier);
+  EXPECT_EQ(tokens[1].value, name);
+  EXPECT_EQ(tokens[3].value, "原始\\n字符串");
+  EXPECT_TRUE(tokens[3].is_raw_string);
+}